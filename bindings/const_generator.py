@@ -23,6 +23,9 @@ template = {
             'unicorn.h': 'unicorn',
             'comment_open': '#',
             'comment_close': '',
+            'meta_header': "\n# Register metadata for the batch APIs: regid -> (size in bytes, class)\n# class: 0 = general, 1 = float/vector, 2 = control/system\nUC_%s_REG_META = {\n",
+            'meta_line': '    UC_%(name)s: (%(size)d, %(cls)d),\n',
+            'meta_footer': '}\n',
         },
     'go': {
             'header': "package unicorn\n// For Unicorn Engine. AUTO-GENERATED FILE, DO NOT EDIT [%s_const.go]\nconst (\n",
@@ -39,6 +42,9 @@ template = {
             'unicorn.h': 'unicorn',
             'comment_open': '//',
             'comment_close': '',
+            'meta_header': "\n// Register metadata for the batch APIs: regid -> RegMeta{size in bytes, class}\n// class: 0 = general, 1 = float/vector, 2 = control/system\nvar %sRegMeta = map[int]RegMeta{\n",
+            'meta_line': '\t%(name)s: {%(size)d, %(cls)d},\n',
+            'meta_footer': '}\n',
         },
     'java': {
             'header': "// For Unicorn Engine. AUTO-GENERATED FILE, DO NOT EDIT\n\npackage unicorn;\n\npublic interface %sConst {\n",
@@ -55,6 +61,9 @@ template = {
             'unicorn.h': 'Unicorn',
             'comment_open': '//',
             'comment_close': '',
+            'meta_header': "\n// Register metadata for the batch APIs, flattened {regid, size in bytes, class} triples.\n// class: 0 = general, 1 = float/vector, 2 = control/system\n   public static final int[] UC_%s_REG_META = {\n",
+            'meta_line': '      UC_%(name)s, %(size)d, %(cls)d,\n',
+            'meta_footer': '   };\n',
         },
     'dotnet': {
             'header': "// For Unicorn Engine. AUTO-GENERATED FILE, DO NOT EDIT\n\nnamespace UnicornManaged.Const\n\nopen System\n\n[<AutoOpen>]\nmodule %s =\n",
@@ -71,12 +80,94 @@ template = {
             'unicorn.h': 'Common',
             'comment_open': '    //',
             'comment_close': '',
+            'meta_header': "\n    // Register metadata for the batch APIs: (regid, size in bytes, class)\n    // class: 0 = general, 1 = float/vector, 2 = control/system\n    let UC_%s_REG_META = [|\n",
+            'meta_line': '        (UC_%(name)s, %(size)d, %(cls)d)\n',
+            'meta_footer': '    |]\n',
         },
 }
 
 # markup for comments to be added to autogen files
 MARKUP = '//>'
 
+# Register metadata emitted below the constants of each arch file, so
+# bindings can pre-size buffers for the batch register APIs without
+# per-call reflection. For every UC_<arch>_REG_* value we emit:
+#   size  - widest uc_reg_read() output for that register, in bytes,
+#           across all modes of the arch (e.g. 8 for MIPS GPRs)
+#   class - 0 = general, 1 = float/vector, 2 = control/system
+# Patterns are matched against the name without the UC_<arch>_REG_
+# prefix; first match wins, unmatched names use 'default'.
+reg_meta = {
+    'arm.h': {
+        'default': (4, 0),
+        'patterns': [
+            (r'S\d+$', (4, 1)),
+            (r'D\d+$', (8, 1)),
+            (r'Q\d+$', (16, 1)),
+            (r'(APSR|APSR_NZCV|CPSR|SPSR|ITSTATE|FPEXC|FPINST2?|FPSCR(_NZCV)?|FPSID|MVFR[0-2])$', (4, 2)),
+        ],
+    },
+    'arm64.h': {
+        'default': (8, 0),
+        'patterns': [
+            (r'(W\d+|WSP|WZR)$', (4, 0)),
+            (r'B\d+$', (1, 1)),
+            (r'H\d+$', (2, 1)),
+            (r'S\d+$', (4, 1)),
+            (r'D\d+$', (8, 1)),
+            (r'(Q\d+|V\d+)$', (16, 1)),
+            (r'NZCV$', (4, 2)),
+        ],
+    },
+    'mips.h': {
+        'default': (8, 0),
+        'patterns': [
+            (r'F\d+$', (8, 1)),
+            (r'W\d+$', (16, 1)),
+            (r'(CC\d|FCC\d|DSP\w*|MPL\d|P\d)$', (4, 2)),
+        ],
+    },
+    'x86.h': {
+        'default': (8, 0),
+        'patterns': [
+            (r'([A-D][HL]|SPL|BPL|SIL|DIL|R\d+B)$', (1, 0)),
+            (r'(AX|BX|CX|DX|BP|SP|SI|DI|IP|R\d+W)$', (2, 0)),
+            (r'(CS|DS|ES|FS|GS|SS)$', (2, 2)),
+            (r'(EAX|EBX|ECX|EDX|EBP|ESP|ESI|EDI|EIP|EIZ|EFLAGS|R\d+D)$', (4, 0)),
+            (r'(CR\d+|DR\d+)$', (8, 2)),
+            (r'(GDTR|IDTR|LDTR|TR)$', (24, 2)),   # sizeof(uc_x86_mmr)
+            (r'FPSW$', (2, 2)),
+            (r'(FP\d|ST\d)$', (10, 1)),
+            (r'(MM\d|K\d)$', (8, 1)),
+            (r'XMM\d+$', (16, 1)),
+            (r'YMM\d+$', (32, 1)),
+            (r'ZMM\d+$', (64, 1)),
+            (r'XSTATE$', (768, 1)),               # sizeof(uc_x86_xstate)
+        ],
+    },
+    'sparc.h': {
+        'default': (8, 0),
+        'patterns': [
+            (r'F([12]?\d|3[01])$', (4, 1)),       # F0..F31: singles
+            (r'F\d+$', (8, 1)),                   # F32..F62: doubles
+            (r'(ICC|XCC|FCC\d)$', (4, 2)),
+            (r'Y$', (8, 2)),
+        ],
+    },
+    'm68k.h': {
+        'default': (4, 0),
+        'patterns': [
+            (r'SR$', (4, 2)),
+        ],
+    },
+}
+
+def lookup_meta(meta, name):
+    for pattern, info in meta['patterns']:
+        if re.match(pattern, name):
+            return info
+    return meta['default']
+
 def gen(lang):
     global include, INCL_DIR
     templ = template[lang]
@@ -89,7 +180,10 @@ def gen(lang):
         lines = open(os.path.join(INCL_DIR, target)).readlines()
 
         previous = {}
+        regs = []
+        reg_ids = set()
         count = 0
+        in_comment = False
         for line in lines:
             line = line.strip()
 
@@ -98,7 +192,23 @@ def gen(lang):
                             line.replace(MARKUP, ''), templ['comment_close'])).encode("utf-8"))
                 continue
 
-            if line == '' or line.startswith('//'):
+            # skip /* */ block comments, which may mention constants
+            if in_comment:
+                if '*/' not in line:
+                    continue
+                line = line.split('*/', 1)[1].strip()
+                in_comment = False
+            if '/*' in line:
+                before, _, rest = line.partition('/*')
+                if '*/' in rest:
+                    line = (before + rest.split('*/', 1)[1]).strip()
+                else:
+                    line = before.strip()
+                    in_comment = True
+
+            # drop trailing // comments, e.g. on annotated #defines
+            line = line.split('//')[0].strip()
+            if line == '':
                 continue
 
             tmp = line.strip().split(',')
@@ -148,7 +258,34 @@ def gen(lang):
                     outfile.write((templ['line_format'] % (lhs_strip, rhs)).encode("utf-8"))
                     previous[lhs] = str(rhs)
 
-        outfile.write((templ['footer']).encode("utf-8"))
+                    # collect registers for the metadata table; aliases
+                    # (e.g. UC_ARM_REG_SP = UC_ARM_REG_R13) keep the first name
+                    match = re.match(r'^%s_REG_(\w+)$' % prefix.upper(), lhs_strip)
+                    if match and match.group(1) not in ('INVALID', 'ENDING') \
+                            and int(rhs) not in reg_ids:
+                        reg_ids.add(int(rhs))
+                        regs.append((lhs_strip, match.group(1)))
+
+        meta_out = ''
+        if target in reg_meta and len(regs) > 0:
+            if lang == 'go':
+                # go constants carry no UC_ prefix; map name is CamelCase
+                table = prefix[0].upper() + prefix[1:]
+            else:
+                table = prefix.upper()
+            meta_out = templ['meta_header'] % table
+            for lhs_strip, suffix in regs:
+                size, cls = lookup_meta(reg_meta[target], suffix)
+                meta_out += templ['meta_line'] % {'name': lhs_strip, 'size': size, 'cls': cls}
+            meta_out += templ['meta_footer']
+
+        if lang == 'go':
+            # the metadata map must follow the closing of the const block
+            outfile.write((templ['footer']).encode("utf-8"))
+            outfile.write(meta_out.encode("utf-8"))
+        else:
+            outfile.write(meta_out.encode("utf-8"))
+            outfile.write((templ['footer']).encode("utf-8"))
         outfile.close()
 
 def main():
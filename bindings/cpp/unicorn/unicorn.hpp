@@ -0,0 +1,301 @@
+/*
+   Header-only C++17 wrapper for the Unicorn Emulator Engine.
+
+   Design rules:
+   - every call compiles down to the corresponding libunicorn call; the
+     wrapper itself never allocates
+   - unicorn::engine owns the uc_engine* (unique ownership, movable)
+   - unicorn::hook unregisters itself on destruction (scoped hooks)
+   - hook callbacks are any C++ callable; the callable is passed by
+     reference and must outlive the hook object - no std::function, no
+     heap trampoline, just one template thunk per callable type
+   - memory transfers take caller-owned buffers (pointer + size, or
+     std::span where <span> is available) so no accidental copies happen
+     on the mem_read path; view() exposes the uc_mem_ptr zero-copy path
+
+   Errors are reported by throwing unicorn::error (derived from
+   std::exception, carries the uc_err code).
+*/
+#ifndef UNICORN_HPP
+#define UNICORN_HPP
+
+#include <unicorn/unicorn.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+namespace unicorn {
+
+class error : public std::exception {
+public:
+    explicit error(uc_err code) noexcept : code_(code) {}
+
+    uc_err code() const noexcept { return code_; }
+
+    const char *what() const noexcept override {
+        return uc_strerror(code_);
+    }
+
+private:
+    uc_err code_;
+};
+
+inline void check(uc_err err) {
+    if (err != UC_ERR_OK)
+        throw error(err);
+}
+
+// Scoped hook registration: unregisters in the destructor. Movable,
+// non-copyable; obtained from the engine::hook_*() members.
+class hook {
+public:
+    hook() noexcept = default;
+
+    hook(hook &&other) noexcept
+        : uc_(other.uc_), hh_(other.hh_) {
+        other.uc_ = nullptr;
+    }
+
+    hook &operator=(hook &&other) noexcept {
+        if (this != &other) {
+            reset();
+            uc_ = other.uc_;
+            hh_ = other.hh_;
+            other.uc_ = nullptr;
+        }
+        return *this;
+    }
+
+    hook(const hook &) = delete;
+    hook &operator=(const hook &) = delete;
+
+    ~hook() { reset(); }
+
+    // unregister now instead of at end of scope
+    void reset() noexcept {
+        if (uc_ != nullptr) {
+            uc_hook_del(uc_, hh_);
+            uc_ = nullptr;
+        }
+    }
+
+    uc_hook native_handle() const noexcept { return hh_; }
+
+private:
+    friend class engine;
+
+    hook(uc_engine *uc, uc_hook hh) noexcept : uc_(uc), hh_(hh) {}
+
+    uc_engine *uc_ = nullptr;
+    uc_hook hh_ = 0;
+};
+
+// A contiguous window of guest memory obtained from uc_mem_ptr(): host
+// pointer plus the bytes available from there. Writes through it bypass
+// write protection and code invalidation, and it is only valid until the
+// backing mapping is unmapped or the engine is destroyed.
+struct mem_view {
+    void *data;
+    std::size_t size;
+};
+
+class engine {
+public:
+    engine(uc_arch arch, uc_mode mode) {
+        check(uc_open(arch, mode, &uc_));
+    }
+
+    engine(engine &&other) noexcept : uc_(other.uc_) {
+        other.uc_ = nullptr;
+    }
+
+    engine &operator=(engine &&other) noexcept {
+        if (this != &other) {
+            if (uc_ != nullptr)
+                uc_close(uc_);
+            uc_ = other.uc_;
+            other.uc_ = nullptr;
+        }
+        return *this;
+    }
+
+    engine(const engine &) = delete;
+    engine &operator=(const engine &) = delete;
+
+    ~engine() {
+        if (uc_ != nullptr)
+            uc_close(uc_);
+    }
+
+    // the raw handle, for C APIs the wrapper does not cover
+    uc_engine *native_handle() const noexcept { return uc_; }
+
+    // ----- execution ------------------------------------------------
+
+    void start(std::uint64_t begin, std::uint64_t until,
+               std::uint64_t timeout = 0, std::size_t count = 0) {
+        check(uc_emu_start(uc_, begin, until, timeout, count));
+    }
+
+    void stop() {
+        check(uc_emu_stop(uc_));
+    }
+
+    // ----- registers ------------------------------------------------
+
+    // typed register read; T fixes the width at compile time, so e.g.
+    // reg_read<std::uint32_t>(UC_X86_REG_EAX) reads exactly 4 bytes
+    template <typename T = std::uint64_t>
+    T reg_read(int regid) const {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "register values must be trivially copyable");
+        T value{};
+        check(uc_reg_read(uc_, regid, &value));
+        return value;
+    }
+
+    template <typename T>
+    void reg_write(int regid, const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "register values must be trivially copyable");
+        check(uc_reg_write(uc_, regid, &value));
+    }
+
+    // ----- memory ---------------------------------------------------
+
+    void mem_map(std::uint64_t address, std::size_t size,
+                 std::uint32_t perms = UC_PROT_ALL) {
+        check(uc_mem_map(uc_, address, size, perms));
+    }
+
+    void mem_unmap(std::uint64_t address, std::size_t size) {
+        check(uc_mem_unmap(uc_, address, size));
+    }
+
+    void mem_protect(std::uint64_t address, std::size_t size,
+                     std::uint32_t perms) {
+        check(uc_mem_protect(uc_, address, size, perms));
+    }
+
+    // transfers into/out of caller-owned storage; no hidden copies
+    void mem_read(std::uint64_t address, void *dst, std::size_t size) const {
+        check(uc_mem_read(uc_, address, dst, size));
+    }
+
+    void mem_write(std::uint64_t address, const void *src, std::size_t size) {
+        check(uc_mem_write(uc_, address, src, size));
+    }
+
+#if defined(__cpp_lib_span)
+    void mem_read(std::uint64_t address, std::span<std::byte> dst) const {
+        mem_read(address, dst.data(), dst.size());
+    }
+
+    void mem_write(std::uint64_t address, std::span<const std::byte> src) {
+        mem_write(address, src.data(), src.size());
+    }
+#endif
+
+    // zero-copy window over the host pages backing @address (uc_mem_ptr)
+    mem_view view(std::uint64_t address) const {
+        void *ptr = nullptr;
+        std::size_t avail = 0;
+        check(uc_mem_ptr(uc_, address, &ptr, &avail));
+        return mem_view{ptr, avail};
+    }
+
+    // ----- hooks ----------------------------------------------------
+
+    // Callbacks are passed by reference and must outlive the returned
+    // hook object. The thunk is a function template instantiated per
+    // callable type: registering a hook allocates nothing.
+
+    // fn(address, size)
+    template <typename F>
+    hook hook_code(F &fn, std::uint64_t begin = 1, std::uint64_t end = 0) {
+        return add(UC_HOOK_CODE, reinterpret_cast<void *>(&code_thunk<F>),
+                   &fn, begin, end);
+    }
+
+    // fn(address, size)
+    template <typename F>
+    hook hook_block(F &fn, std::uint64_t begin = 1, std::uint64_t end = 0) {
+        return add(UC_HOOK_BLOCK, reinterpret_cast<void *>(&code_thunk<F>),
+                   &fn, begin, end);
+    }
+
+    // fn(type, address, size, value)
+    template <typename F>
+    hook hook_mem(F &fn, int type,
+                  std::uint64_t begin = 1, std::uint64_t end = 0) {
+        return add(type, reinterpret_cast<void *>(&mem_thunk<F>),
+                   &fn, begin, end);
+    }
+
+    // fn(type, address, size, value) -> bool (true: access handled)
+    template <typename F>
+    hook hook_mem_event(F &fn, int type,
+                        std::uint64_t begin = 1, std::uint64_t end = 0) {
+        return add(type, reinterpret_cast<void *>(&event_thunk<F>),
+                   &fn, begin, end);
+    }
+
+    // fn(intno)
+    template <typename F>
+    hook hook_intr(F &fn, std::uint64_t begin = 1, std::uint64_t end = 0) {
+        return add(UC_HOOK_INTR, reinterpret_cast<void *>(&intr_thunk<F>),
+                   &fn, begin, end);
+    }
+
+private:
+    hook add(int type, void *callback, void *user_data,
+             std::uint64_t begin, std::uint64_t end) {
+        uc_hook hh = 0;
+        check(uc_hook_add(uc_, &hh, type, callback, user_data, begin, end));
+        return hook(uc_, hh);
+    }
+
+    template <typename F>
+    static void code_thunk(uc_engine *, std::uint64_t address,
+                           std::uint32_t size, void *user_data) {
+        (*static_cast<F *>(user_data))(address, size);
+    }
+
+    template <typename F>
+    static void mem_thunk(uc_engine *, uc_mem_type type,
+                          std::uint64_t address, int size,
+                          std::int64_t value, void *user_data) {
+        (*static_cast<F *>(user_data))(type, address, size, value);
+    }
+
+    template <typename F>
+    static bool event_thunk(uc_engine *, uc_mem_type type,
+                            std::uint64_t address, int size,
+                            std::int64_t value, void *user_data) {
+        return (*static_cast<F *>(user_data))(type, address, size, value);
+    }
+
+    template <typename F>
+    static void intr_thunk(uc_engine *, std::uint32_t intno,
+                           void *user_data) {
+        (*static_cast<F *>(user_data))(intno);
+    }
+
+    uc_engine *uc_ = nullptr;
+};
+
+} // namespace unicorn
+
+#endif // UNICORN_HPP
@@ -14,6 +14,9 @@ type IBinding =
         abstract RegWrite : UIntPtr * Int32 * Byte array -> Int32
         abstract MemRead : UIntPtr * UInt64 * Byte array * UIntPtr -> Int32
         abstract MemWrite : UIntPtr * UInt64 * Byte array * UIntPtr -> Int32
+        abstract MemReadPtr : UIntPtr * UInt64 * IntPtr * UIntPtr -> Int32
+        abstract MemWritePtr : UIntPtr * UInt64 * IntPtr * UIntPtr -> Int32
+        abstract MemPtr : UIntPtr * UInt64 * IntPtr array * UIntPtr array -> Int32
         abstract EmuStart : UIntPtr * UInt64 * UInt64 * UInt64 * UInt64 -> Int32
         abstract EmuStop : UIntPtr -> Int32        
         abstract HookDel : UIntPtr * UIntPtr -> Int32
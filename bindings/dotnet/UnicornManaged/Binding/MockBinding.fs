@@ -13,6 +13,9 @@ module internal MockBinding =
     let mutable mem_protect = fun(eng, address, size, perms) -> 0
     let mutable mem_write = fun(eng, adress, value, size) -> 0
     let mutable mem_read = fun(eng, adress, value, size) -> 0
+    let mutable mem_write_ptr = fun(eng, adress, value, size) -> 0
+    let mutable mem_read_ptr = fun(eng, adress, value, size) -> 0
+    let mutable mem_ptr = fun(eng, adress, ptr, avail) -> 0
     let mutable reg_write = fun(eng, regId, value) -> 0
     let mutable reg_read = fun(eng, regId, value) -> 0
     let mutable emu_start = fun(eng, beginAddr, untilAddr, timeout, count) -> 0
@@ -33,6 +36,9 @@ module internal MockBinding =
             member thi.MemMap(eng, adress, size, perm) = mem_map(eng, adress, size, perm)
             member thi.MemWrite(eng, adress, value, size) = mem_write(eng, adress, value, size)
             member thi.MemRead(eng, adress, value, size) = mem_read(eng, adress, value, size)
+            member thi.MemWritePtr(eng, adress, value, size) = mem_write_ptr(eng, adress, value, size)
+            member thi.MemReadPtr(eng, adress, value, size) = mem_read_ptr(eng, adress, value, size)
+            member thi.MemPtr(eng, adress, ptr, avail) = mem_ptr(eng, adress, ptr, avail)
             member thi.RegWrite(eng, regId, value) = reg_write(eng, regId, value)
             member thi.RegRead(eng, regId, value) = reg_read(eng, regId, value)
             member thi.EmuStart(eng, beginAddr, untilAddr, timeout, count) = emu_start(eng, beginAddr, untilAddr, timeout, count)
@@ -35,6 +35,17 @@ module NativeBinding =
         [<DllImport("unicorn", CallingConvention = CallingConvention.Cdecl)>]
         extern Int32 uc_mem_read(UIntPtr eng, UInt64 address, Byte[] value, UIntPtr size)
 
+        // raw-pointer aliases: the caller passes an already pinned or native
+        // buffer, so no array marshalling happens per call
+        [<DllImport("unicorn", CallingConvention = CallingConvention.Cdecl, EntryPoint = "uc_mem_write")>]
+        extern Int32 uc_mem_write_ptr(UIntPtr eng, UInt64 address, IntPtr value, UIntPtr size)
+
+        [<DllImport("unicorn", CallingConvention = CallingConvention.Cdecl, EntryPoint = "uc_mem_read")>]
+        extern Int32 uc_mem_read_ptr(UIntPtr eng, UInt64 address, IntPtr value, UIntPtr size)
+
+        [<DllImport("unicorn", CallingConvention = CallingConvention.Cdecl)>]
+        extern Int32 uc_mem_ptr(UIntPtr eng, UInt64 address, IntPtr[] ptr, UIntPtr[] avail)
+
         [<DllImport("unicorn", CallingConvention = CallingConvention.Cdecl)>]
         extern Int32 uc_reg_write(UIntPtr eng, Int32 regId, Byte[] value)
 
@@ -76,6 +87,9 @@ module NativeBinding =
             member thi.MemMap(eng, adress, size, perm) = uc_mem_map(eng, adress, size, perm)
             member thi.MemWrite(eng, adress, value, size) = uc_mem_write(eng, adress, value, size)
             member thi.MemRead(eng, adress, value, size) = uc_mem_read(eng, adress, value, size)
+            member thi.MemWritePtr(eng, adress, value, size) = uc_mem_write_ptr(eng, adress, value, size)
+            member thi.MemReadPtr(eng, adress, value, size) = uc_mem_read_ptr(eng, adress, value, size)
+            member thi.MemPtr(eng, adress, ptr, avail) = uc_mem_ptr(eng, adress, ptr, avail)
             member thi.RegWrite(eng, regId, value) = uc_reg_write(eng, regId, value)
             member thi.RegRead(eng, regId, value) = uc_reg_read(eng, regId, value)
             member thi.EmuStart(eng, beginAddr, untilAddr, timeout, count) = uc_emu_start(eng, beginAddr, untilAddr, timeout, count)
@@ -131,3 +131,118 @@ module Arm =
     let UC_ARM_REG_FP = 77
     let UC_ARM_REG_IP = 78
 
+    // Register metadata for the batch APIs: (regid, size in bytes, class)
+    // class: 0 = general, 1 = float/vector, 2 = control/system
+    let UC_ARM_REG_META = [|
+        (UC_ARM_REG_APSR, 4, 2)
+        (UC_ARM_REG_APSR_NZCV, 4, 2)
+        (UC_ARM_REG_CPSR, 4, 2)
+        (UC_ARM_REG_FPEXC, 4, 2)
+        (UC_ARM_REG_FPINST, 4, 2)
+        (UC_ARM_REG_FPSCR, 4, 2)
+        (UC_ARM_REG_FPSCR_NZCV, 4, 2)
+        (UC_ARM_REG_FPSID, 4, 2)
+        (UC_ARM_REG_ITSTATE, 4, 2)
+        (UC_ARM_REG_LR, 4, 0)
+        (UC_ARM_REG_PC, 4, 0)
+        (UC_ARM_REG_SP, 4, 0)
+        (UC_ARM_REG_SPSR, 4, 2)
+        (UC_ARM_REG_D0, 8, 1)
+        (UC_ARM_REG_D1, 8, 1)
+        (UC_ARM_REG_D2, 8, 1)
+        (UC_ARM_REG_D3, 8, 1)
+        (UC_ARM_REG_D4, 8, 1)
+        (UC_ARM_REG_D5, 8, 1)
+        (UC_ARM_REG_D6, 8, 1)
+        (UC_ARM_REG_D7, 8, 1)
+        (UC_ARM_REG_D8, 8, 1)
+        (UC_ARM_REG_D9, 8, 1)
+        (UC_ARM_REG_D10, 8, 1)
+        (UC_ARM_REG_D11, 8, 1)
+        (UC_ARM_REG_D12, 8, 1)
+        (UC_ARM_REG_D13, 8, 1)
+        (UC_ARM_REG_D14, 8, 1)
+        (UC_ARM_REG_D15, 8, 1)
+        (UC_ARM_REG_D16, 8, 1)
+        (UC_ARM_REG_D17, 8, 1)
+        (UC_ARM_REG_D18, 8, 1)
+        (UC_ARM_REG_D19, 8, 1)
+        (UC_ARM_REG_D20, 8, 1)
+        (UC_ARM_REG_D21, 8, 1)
+        (UC_ARM_REG_D22, 8, 1)
+        (UC_ARM_REG_D23, 8, 1)
+        (UC_ARM_REG_D24, 8, 1)
+        (UC_ARM_REG_D25, 8, 1)
+        (UC_ARM_REG_D26, 8, 1)
+        (UC_ARM_REG_D27, 8, 1)
+        (UC_ARM_REG_D28, 8, 1)
+        (UC_ARM_REG_D29, 8, 1)
+        (UC_ARM_REG_D30, 8, 1)
+        (UC_ARM_REG_D31, 8, 1)
+        (UC_ARM_REG_FPINST2, 4, 2)
+        (UC_ARM_REG_MVFR0, 4, 2)
+        (UC_ARM_REG_MVFR1, 4, 2)
+        (UC_ARM_REG_MVFR2, 4, 2)
+        (UC_ARM_REG_Q0, 16, 1)
+        (UC_ARM_REG_Q1, 16, 1)
+        (UC_ARM_REG_Q2, 16, 1)
+        (UC_ARM_REG_Q3, 16, 1)
+        (UC_ARM_REG_Q4, 16, 1)
+        (UC_ARM_REG_Q5, 16, 1)
+        (UC_ARM_REG_Q6, 16, 1)
+        (UC_ARM_REG_Q7, 16, 1)
+        (UC_ARM_REG_Q8, 16, 1)
+        (UC_ARM_REG_Q9, 16, 1)
+        (UC_ARM_REG_Q10, 16, 1)
+        (UC_ARM_REG_Q11, 16, 1)
+        (UC_ARM_REG_Q12, 16, 1)
+        (UC_ARM_REG_Q13, 16, 1)
+        (UC_ARM_REG_Q14, 16, 1)
+        (UC_ARM_REG_Q15, 16, 1)
+        (UC_ARM_REG_R0, 4, 0)
+        (UC_ARM_REG_R1, 4, 0)
+        (UC_ARM_REG_R2, 4, 0)
+        (UC_ARM_REG_R3, 4, 0)
+        (UC_ARM_REG_R4, 4, 0)
+        (UC_ARM_REG_R5, 4, 0)
+        (UC_ARM_REG_R6, 4, 0)
+        (UC_ARM_REG_R7, 4, 0)
+        (UC_ARM_REG_R8, 4, 0)
+        (UC_ARM_REG_R9, 4, 0)
+        (UC_ARM_REG_R10, 4, 0)
+        (UC_ARM_REG_R11, 4, 0)
+        (UC_ARM_REG_R12, 4, 0)
+        (UC_ARM_REG_S0, 4, 1)
+        (UC_ARM_REG_S1, 4, 1)
+        (UC_ARM_REG_S2, 4, 1)
+        (UC_ARM_REG_S3, 4, 1)
+        (UC_ARM_REG_S4, 4, 1)
+        (UC_ARM_REG_S5, 4, 1)
+        (UC_ARM_REG_S6, 4, 1)
+        (UC_ARM_REG_S7, 4, 1)
+        (UC_ARM_REG_S8, 4, 1)
+        (UC_ARM_REG_S9, 4, 1)
+        (UC_ARM_REG_S10, 4, 1)
+        (UC_ARM_REG_S11, 4, 1)
+        (UC_ARM_REG_S12, 4, 1)
+        (UC_ARM_REG_S13, 4, 1)
+        (UC_ARM_REG_S14, 4, 1)
+        (UC_ARM_REG_S15, 4, 1)
+        (UC_ARM_REG_S16, 4, 1)
+        (UC_ARM_REG_S17, 4, 1)
+        (UC_ARM_REG_S18, 4, 1)
+        (UC_ARM_REG_S19, 4, 1)
+        (UC_ARM_REG_S20, 4, 1)
+        (UC_ARM_REG_S21, 4, 1)
+        (UC_ARM_REG_S22, 4, 1)
+        (UC_ARM_REG_S23, 4, 1)
+        (UC_ARM_REG_S24, 4, 1)
+        (UC_ARM_REG_S25, 4, 1)
+        (UC_ARM_REG_S26, 4, 1)
+        (UC_ARM_REG_S27, 4, 1)
+        (UC_ARM_REG_S28, 4, 1)
+        (UC_ARM_REG_S29, 4, 1)
+        (UC_ARM_REG_S30, 4, 1)
+        (UC_ARM_REG_S31, 4, 1)
+    |]
+
@@ -22,6 +22,8 @@ module Common =
 
     let UC_MODE_LITTLE_ENDIAN = 0
     let UC_MODE_BIG_ENDIAN = 1073741824
+    let UC_MODE_BARE = 536870912
+    let UC_MODE_SMALL = 268435456
 
     let UC_MODE_ARM = 0
     let UC_MODE_THUMB = 16
@@ -85,6 +87,7 @@ module Common =
     let UC_HOOK_MEM_READ = 1024
     let UC_HOOK_MEM_WRITE = 2048
     let UC_HOOK_MEM_FETCH = 4096
+    let UC_HOOK_ASYNC = 1073741824
     let UC_HOOK_MEM_UNMAPPED = 112
     let UC_HOOK_MEM_PROT = 896
     let UC_HOOK_MEM_READ_INVALID = 144
@@ -94,10 +97,40 @@ module Common =
     let UC_HOOK_MEM_VALID = 7168
     let UC_QUERY_MODE = 1
     let UC_QUERY_PAGE_SIZE = 2
+    let UC_QUERY_TLB_SIZE = 3
+    let UC_QUERY_TCG_BUFFER_SIZE = 4
+    let UC_QUERY_JMP_CACHE_SIZE = 5
+    let UC_QUERY_TB_COUNT = 6
+    let UC_QUERY_TB_BUFFER_USED = 7
+    let UC_QUERY_TB_FLUSH_COUNT = 8
+    let UC_QUERY_TB_INVALIDATE_COUNT = 9
+    let UC_QUERY_TB_EVICT_COUNT = 10
+    let UC_QUERY_TB_LOOKUP_COUNT = 11
+    let UC_QUERY_TB_SLOW_LOOKUP_COUNT = 12
+    let UC_QUERY_EXEC_BLOCK_COUNT = 13
+    let UC_QUERY_EXEC_INSN_COUNT = 14
+    let UC_QUERY_TLB_FILL_COUNT = 15
+    let UC_QUERY_HOOK_EVENT_COUNT = 16
+    let UC_QUERY_MEM_API_BYTES = 17
+    let UC_QUERY_EMU_START_COUNT = 18
+    let UC_QUERY_JIT_TIME_NS = 19
+    let UC_QUERY_MEM_CODE_BUFFER = 20
+    let UC_QUERY_MEM_TB_METADATA = 21
+    let UC_QUERY_MEM_PAGE_TABLES = 22
+    let UC_QUERY_MEM_TLB = 23
+    let UC_QUERY_MEM_GUEST_RAM = 24
+    let UC_QUERY_MEM_DIRTY_BITMAPS = 25
+    let UC_QUERY_MEM_HOOKS = 26
+    let UC_ARCH_STATE_VERSION = 1
+    let UC_TRANSLATE_READAHEAD_MAX = 64
+    let UC_TRACE_COMPRESSED = 1
+    let UC_TRACE_FRAME_MAGIC = 1179927381
 
     let UC_PROT_NONE = 0
     let UC_PROT_READ = 1
     let UC_PROT_WRITE = 2
     let UC_PROT_EXEC = 4
     let UC_PROT_ALL = 7
+    let UC_MEM_HUGEPAGE = 256
+    let UC_MEM_MERGEABLE = 512
 
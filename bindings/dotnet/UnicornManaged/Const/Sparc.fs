@@ -102,3 +102,96 @@ module Sparc =
     let UC_SPARC_REG_O6 = 84
     let UC_SPARC_REG_I6 = 67
 
+    // Register metadata for the batch APIs: (regid, size in bytes, class)
+    // class: 0 = general, 1 = float/vector, 2 = control/system
+    let UC_SPARC_REG_META = [|
+        (UC_SPARC_REG_F0, 4, 1)
+        (UC_SPARC_REG_F1, 4, 1)
+        (UC_SPARC_REG_F2, 4, 1)
+        (UC_SPARC_REG_F3, 4, 1)
+        (UC_SPARC_REG_F4, 4, 1)
+        (UC_SPARC_REG_F5, 4, 1)
+        (UC_SPARC_REG_F6, 4, 1)
+        (UC_SPARC_REG_F7, 4, 1)
+        (UC_SPARC_REG_F8, 4, 1)
+        (UC_SPARC_REG_F9, 4, 1)
+        (UC_SPARC_REG_F10, 4, 1)
+        (UC_SPARC_REG_F11, 4, 1)
+        (UC_SPARC_REG_F12, 4, 1)
+        (UC_SPARC_REG_F13, 4, 1)
+        (UC_SPARC_REG_F14, 4, 1)
+        (UC_SPARC_REG_F15, 4, 1)
+        (UC_SPARC_REG_F16, 4, 1)
+        (UC_SPARC_REG_F17, 4, 1)
+        (UC_SPARC_REG_F18, 4, 1)
+        (UC_SPARC_REG_F19, 4, 1)
+        (UC_SPARC_REG_F20, 4, 1)
+        (UC_SPARC_REG_F21, 4, 1)
+        (UC_SPARC_REG_F22, 4, 1)
+        (UC_SPARC_REG_F23, 4, 1)
+        (UC_SPARC_REG_F24, 4, 1)
+        (UC_SPARC_REG_F25, 4, 1)
+        (UC_SPARC_REG_F26, 4, 1)
+        (UC_SPARC_REG_F27, 4, 1)
+        (UC_SPARC_REG_F28, 4, 1)
+        (UC_SPARC_REG_F29, 4, 1)
+        (UC_SPARC_REG_F30, 4, 1)
+        (UC_SPARC_REG_F31, 4, 1)
+        (UC_SPARC_REG_F32, 8, 1)
+        (UC_SPARC_REG_F34, 8, 1)
+        (UC_SPARC_REG_F36, 8, 1)
+        (UC_SPARC_REG_F38, 8, 1)
+        (UC_SPARC_REG_F40, 8, 1)
+        (UC_SPARC_REG_F42, 8, 1)
+        (UC_SPARC_REG_F44, 8, 1)
+        (UC_SPARC_REG_F46, 8, 1)
+        (UC_SPARC_REG_F48, 8, 1)
+        (UC_SPARC_REG_F50, 8, 1)
+        (UC_SPARC_REG_F52, 8, 1)
+        (UC_SPARC_REG_F54, 8, 1)
+        (UC_SPARC_REG_F56, 8, 1)
+        (UC_SPARC_REG_F58, 8, 1)
+        (UC_SPARC_REG_F60, 8, 1)
+        (UC_SPARC_REG_F62, 8, 1)
+        (UC_SPARC_REG_FCC0, 4, 2)
+        (UC_SPARC_REG_FCC1, 4, 2)
+        (UC_SPARC_REG_FCC2, 4, 2)
+        (UC_SPARC_REG_FCC3, 4, 2)
+        (UC_SPARC_REG_G0, 8, 0)
+        (UC_SPARC_REG_G1, 8, 0)
+        (UC_SPARC_REG_G2, 8, 0)
+        (UC_SPARC_REG_G3, 8, 0)
+        (UC_SPARC_REG_G4, 8, 0)
+        (UC_SPARC_REG_G5, 8, 0)
+        (UC_SPARC_REG_G6, 8, 0)
+        (UC_SPARC_REG_G7, 8, 0)
+        (UC_SPARC_REG_I0, 8, 0)
+        (UC_SPARC_REG_I1, 8, 0)
+        (UC_SPARC_REG_I2, 8, 0)
+        (UC_SPARC_REG_I3, 8, 0)
+        (UC_SPARC_REG_I4, 8, 0)
+        (UC_SPARC_REG_I5, 8, 0)
+        (UC_SPARC_REG_FP, 8, 0)
+        (UC_SPARC_REG_I7, 8, 0)
+        (UC_SPARC_REG_ICC, 4, 2)
+        (UC_SPARC_REG_L0, 8, 0)
+        (UC_SPARC_REG_L1, 8, 0)
+        (UC_SPARC_REG_L2, 8, 0)
+        (UC_SPARC_REG_L3, 8, 0)
+        (UC_SPARC_REG_L4, 8, 0)
+        (UC_SPARC_REG_L5, 8, 0)
+        (UC_SPARC_REG_L6, 8, 0)
+        (UC_SPARC_REG_L7, 8, 0)
+        (UC_SPARC_REG_O0, 8, 0)
+        (UC_SPARC_REG_O1, 8, 0)
+        (UC_SPARC_REG_O2, 8, 0)
+        (UC_SPARC_REG_O3, 8, 0)
+        (UC_SPARC_REG_O4, 8, 0)
+        (UC_SPARC_REG_O5, 8, 0)
+        (UC_SPARC_REG_SP, 8, 0)
+        (UC_SPARC_REG_O7, 8, 0)
+        (UC_SPARC_REG_Y, 8, 2)
+        (UC_SPARC_REG_XCC, 4, 2)
+        (UC_SPARC_REG_PC, 8, 0)
+    |]
+
@@ -107,9 +107,32 @@ and Unicorn(arch: Int32, mode: Int32, binding: IBinding) =
         | Some e -> raise e | None -> ()
 
     member this.MemRead(address: Int64, memValue: Byte array) =
-        match binding.MemRead(_eng.[0], uint64 address, memValue, new UIntPtr(uint32 memValue.Length)) |> this.CheckResult with 
+        match binding.MemRead(_eng.[0], uint64 address, memValue, new UIntPtr(uint32 memValue.Length)) |> this.CheckResult with
         | Some e -> raise e | None -> ()
 
+    // raw-pointer overloads: the caller passes an already pinned buffer
+    // (e.g. from a pinned GCHandle or native allocation) and no per-call
+    // array marshalling happens
+    member this.MemWrite(address: Int64, value: IntPtr, size: Int32) =
+        match binding.MemWritePtr(_eng.[0], uint64 address, value, new UIntPtr(uint32 size)) |> this.CheckResult with
+        | Some e -> raise e | None -> ()
+
+    member this.MemRead(address: Int64, memValue: IntPtr, size: Int32) =
+        match binding.MemReadPtr(_eng.[0], uint64 address, memValue, new UIntPtr(uint32 size)) |> this.CheckResult with
+        | Some e -> raise e | None -> ()
+
+    // zero-copy access: a pointer straight into the host pages backing the
+    // mapping that contains the address, plus the contiguous bytes
+    // available from there. Writes through it bypass write protection and
+    // code invalidation, and the pointer is only valid until the mapping
+    // is unmapped (see uc_mem_ptr)
+    member this.MemPtr(address: Int64) =
+        let ptr = Array.zeroCreate<IntPtr> 1
+        let avail = Array.zeroCreate<UIntPtr> 1
+        match binding.MemPtr(_eng.[0], uint64 address, ptr, avail) |> this.CheckResult with
+        | Some e -> raise e
+        | None -> (ptr.[0], int64 (avail.[0].ToUInt64()))
+
     member this.RegWrite(regId: Int32, value: Byte array) =
         match binding.RegWrite(_eng.[0], regId, value) |> this.CheckResult with 
         | Some e -> raise e | None -> ()
@@ -195,4 +195,144 @@ const (
 	MIPS_REG_LO1 = 46
 	MIPS_REG_LO2 = 47
 	MIPS_REG_LO3 = 48
-)
\ No newline at end of file
+)
+// Register metadata for the batch APIs: regid -> RegMeta{size in bytes, class}
+// class: 0 = general, 1 = float/vector, 2 = control/system
+var MipsRegMeta = map[int]RegMeta{
+	MIPS_REG_PC: {8, 0},
+	MIPS_REG_0: {8, 0},
+	MIPS_REG_1: {8, 0},
+	MIPS_REG_2: {8, 0},
+	MIPS_REG_3: {8, 0},
+	MIPS_REG_4: {8, 0},
+	MIPS_REG_5: {8, 0},
+	MIPS_REG_6: {8, 0},
+	MIPS_REG_7: {8, 0},
+	MIPS_REG_8: {8, 0},
+	MIPS_REG_9: {8, 0},
+	MIPS_REG_10: {8, 0},
+	MIPS_REG_11: {8, 0},
+	MIPS_REG_12: {8, 0},
+	MIPS_REG_13: {8, 0},
+	MIPS_REG_14: {8, 0},
+	MIPS_REG_15: {8, 0},
+	MIPS_REG_16: {8, 0},
+	MIPS_REG_17: {8, 0},
+	MIPS_REG_18: {8, 0},
+	MIPS_REG_19: {8, 0},
+	MIPS_REG_20: {8, 0},
+	MIPS_REG_21: {8, 0},
+	MIPS_REG_22: {8, 0},
+	MIPS_REG_23: {8, 0},
+	MIPS_REG_24: {8, 0},
+	MIPS_REG_25: {8, 0},
+	MIPS_REG_26: {8, 0},
+	MIPS_REG_27: {8, 0},
+	MIPS_REG_28: {8, 0},
+	MIPS_REG_29: {8, 0},
+	MIPS_REG_30: {8, 0},
+	MIPS_REG_31: {8, 0},
+	MIPS_REG_DSPCCOND: {4, 2},
+	MIPS_REG_DSPCARRY: {4, 2},
+	MIPS_REG_DSPEFI: {4, 2},
+	MIPS_REG_DSPOUTFLAG: {4, 2},
+	MIPS_REG_DSPOUTFLAG16_19: {4, 2},
+	MIPS_REG_DSPOUTFLAG20: {4, 2},
+	MIPS_REG_DSPOUTFLAG21: {4, 2},
+	MIPS_REG_DSPOUTFLAG22: {4, 2},
+	MIPS_REG_DSPOUTFLAG23: {4, 2},
+	MIPS_REG_DSPPOS: {4, 2},
+	MIPS_REG_DSPSCOUNT: {4, 2},
+	MIPS_REG_AC0: {8, 0},
+	MIPS_REG_AC1: {8, 0},
+	MIPS_REG_AC2: {8, 0},
+	MIPS_REG_AC3: {8, 0},
+	MIPS_REG_CC0: {4, 2},
+	MIPS_REG_CC1: {4, 2},
+	MIPS_REG_CC2: {4, 2},
+	MIPS_REG_CC3: {4, 2},
+	MIPS_REG_CC4: {4, 2},
+	MIPS_REG_CC5: {4, 2},
+	MIPS_REG_CC6: {4, 2},
+	MIPS_REG_CC7: {4, 2},
+	MIPS_REG_F0: {8, 1},
+	MIPS_REG_F1: {8, 1},
+	MIPS_REG_F2: {8, 1},
+	MIPS_REG_F3: {8, 1},
+	MIPS_REG_F4: {8, 1},
+	MIPS_REG_F5: {8, 1},
+	MIPS_REG_F6: {8, 1},
+	MIPS_REG_F7: {8, 1},
+	MIPS_REG_F8: {8, 1},
+	MIPS_REG_F9: {8, 1},
+	MIPS_REG_F10: {8, 1},
+	MIPS_REG_F11: {8, 1},
+	MIPS_REG_F12: {8, 1},
+	MIPS_REG_F13: {8, 1},
+	MIPS_REG_F14: {8, 1},
+	MIPS_REG_F15: {8, 1},
+	MIPS_REG_F16: {8, 1},
+	MIPS_REG_F17: {8, 1},
+	MIPS_REG_F18: {8, 1},
+	MIPS_REG_F19: {8, 1},
+	MIPS_REG_F20: {8, 1},
+	MIPS_REG_F21: {8, 1},
+	MIPS_REG_F22: {8, 1},
+	MIPS_REG_F23: {8, 1},
+	MIPS_REG_F24: {8, 1},
+	MIPS_REG_F25: {8, 1},
+	MIPS_REG_F26: {8, 1},
+	MIPS_REG_F27: {8, 1},
+	MIPS_REG_F28: {8, 1},
+	MIPS_REG_F29: {8, 1},
+	MIPS_REG_F30: {8, 1},
+	MIPS_REG_F31: {8, 1},
+	MIPS_REG_FCC0: {4, 2},
+	MIPS_REG_FCC1: {4, 2},
+	MIPS_REG_FCC2: {4, 2},
+	MIPS_REG_FCC3: {4, 2},
+	MIPS_REG_FCC4: {4, 2},
+	MIPS_REG_FCC5: {4, 2},
+	MIPS_REG_FCC6: {4, 2},
+	MIPS_REG_FCC7: {4, 2},
+	MIPS_REG_W0: {16, 1},
+	MIPS_REG_W1: {16, 1},
+	MIPS_REG_W2: {16, 1},
+	MIPS_REG_W3: {16, 1},
+	MIPS_REG_W4: {16, 1},
+	MIPS_REG_W5: {16, 1},
+	MIPS_REG_W6: {16, 1},
+	MIPS_REG_W7: {16, 1},
+	MIPS_REG_W8: {16, 1},
+	MIPS_REG_W9: {16, 1},
+	MIPS_REG_W10: {16, 1},
+	MIPS_REG_W11: {16, 1},
+	MIPS_REG_W12: {16, 1},
+	MIPS_REG_W13: {16, 1},
+	MIPS_REG_W14: {16, 1},
+	MIPS_REG_W15: {16, 1},
+	MIPS_REG_W16: {16, 1},
+	MIPS_REG_W17: {16, 1},
+	MIPS_REG_W18: {16, 1},
+	MIPS_REG_W19: {16, 1},
+	MIPS_REG_W20: {16, 1},
+	MIPS_REG_W21: {16, 1},
+	MIPS_REG_W22: {16, 1},
+	MIPS_REG_W23: {16, 1},
+	MIPS_REG_W24: {16, 1},
+	MIPS_REG_W25: {16, 1},
+	MIPS_REG_W26: {16, 1},
+	MIPS_REG_W27: {16, 1},
+	MIPS_REG_W28: {16, 1},
+	MIPS_REG_W29: {16, 1},
+	MIPS_REG_W30: {16, 1},
+	MIPS_REG_W31: {16, 1},
+	MIPS_REG_HI: {8, 0},
+	MIPS_REG_LO: {8, 0},
+	MIPS_REG_P0: {4, 2},
+	MIPS_REG_P1: {4, 2},
+	MIPS_REG_P2: {4, 2},
+	MIPS_REG_MPL0: {4, 2},
+	MIPS_REG_MPL1: {4, 2},
+	MIPS_REG_MPL2: {4, 2},
+}
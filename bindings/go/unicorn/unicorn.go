@@ -9,6 +9,32 @@ import (
 /*
 #cgo LDFLAGS: -lunicorn
 #include <unicorn/unicorn.h>
+#include <stdlib.h>
+
+// Build the void* frames of the batch register calls on the C side: the Go
+// side only passes flat uint64 buffers, since the cgo pointer rules forbid
+// passing Go memory that itself contains Go pointers.
+static uc_err uc_reg_read_batch64(uc_engine *uc, int *regs, uint64_t *vals, int count) {
+	void **ptrs = malloc(sizeof(void *) * count);
+	uc_err err;
+	int i;
+	for (i = 0; i < count; i++)
+		ptrs[i] = &vals[i];
+	err = uc_reg_read_batch(uc, regs, ptrs, count);
+	free(ptrs);
+	return err;
+}
+
+static uc_err uc_reg_write_batch64(uc_engine *uc, int *regs, uint64_t *vals, int count) {
+	void **ptrs = malloc(sizeof(void *) * count);
+	uc_err err;
+	int i;
+	for (i = 0; i < count; i++)
+		ptrs[i] = &vals[i];
+	err = uc_reg_write_batch(uc, regs, ptrs, count);
+	free(ptrs);
+	return err;
+}
 */
 import "C"
 
@@ -41,7 +67,9 @@ type Unicorn interface {
 	MemReadInto(dst []byte, addr uint64) error
 	MemWrite(addr uint64, data []byte) error
 	RegRead(reg int) (uint64, error)
+	RegReadBatch(regs []int) ([]uint64, error)
 	RegWrite(reg int, value uint64) error
+	RegWriteBatch(regs []int, vals []uint64) error
 	RegReadMmr(reg int) (*X86Mmr, error)
 	RegWriteMmr(reg int, value *X86Mmr) error
 	Start(begin, until uint64) error
@@ -49,13 +77,36 @@ type Unicorn interface {
 	Stop() error
 	HookAdd(htype int, cb interface{}, begin, end uint64, extra ...int) (Hook, error)
 	HookDel(hook Hook) error
+	TraceEnable(htype int, capacity int) error
+	TraceDisable() error
+	TraceCount() (uint64, error)
+	TraceDrain() ([]TraceRecord, error)
 	Query(queryType int) (uint64, error)
 	Close() error
 }
 
+// TraceRecord mirrors uc_trace_record from <unicorn/unicorn.h>.
+type TraceRecord struct {
+	Address uint64
+	Type    uint32
+	Size    uint32
+}
+
+// RegMeta describes one register for the batch APIs: the widest size
+// RegRead fills in bytes, and a coarse class (0 = general,
+// 1 = float/vector, 2 = control/system). The per-arch tables
+// (X86RegMeta, ArmRegMeta, ...) are generated into the *_const.go files.
+type RegMeta struct {
+	Size  int
+	Class int
+}
+
 type uc struct {
-	handle *C.uc_engine
-	final  sync.Once
+	handle       *C.uc_engine
+	final        sync.Once
+	traceBuf     unsafe.Pointer
+	traceCap     uint64
+	traceDrained uint64
 }
 
 type UcOptions struct {
@@ -83,6 +134,10 @@ func (u *uc) Close() (err error) {
 			err = errReturn(C.uc_close(u.handle))
 			u.handle = nil
 		}
+		if u.traceBuf != nil {
+			C.free(u.traceBuf)
+			u.traceBuf = nil
+		}
 	})
 	return err
 }
@@ -112,6 +167,38 @@ func (u *uc) RegRead(reg int) (uint64, error) {
 	return uint64(val), errReturn(ucerr)
 }
 
+// RegReadBatch reads a whole register frame in one cgo crossing.
+func (u *uc) RegReadBatch(regs []int) ([]uint64, error) {
+	if len(regs) == 0 {
+		return nil, nil
+	}
+	cregs := make([]C.int, len(regs))
+	for i, r := range regs {
+		cregs[i] = C.int(r)
+	}
+	vals := make([]uint64, len(regs))
+	ucerr := C.uc_reg_read_batch64(u.handle, &cregs[0], (*C.uint64_t)(unsafe.Pointer(&vals[0])), C.int(len(regs)))
+	return vals, errReturn(ucerr)
+}
+
+// RegWriteBatch writes a whole register frame in one cgo crossing.
+func (u *uc) RegWriteBatch(regs []int, vals []uint64) error {
+	if len(regs) == 0 {
+		return nil
+	}
+	if len(vals) != len(regs) {
+		return UcError(ERR_ARG)
+	}
+	cregs := make([]C.int, len(regs))
+	for i, r := range regs {
+		cregs[i] = C.int(r)
+	}
+	cvals := make([]uint64, len(vals))
+	copy(cvals, vals)
+	ucerr := C.uc_reg_write_batch64(u.handle, &cregs[0], (*C.uint64_t)(unsafe.Pointer(&cvals[0])), C.int(len(regs)))
+	return errReturn(ucerr)
+}
+
 func (u *uc) MemRegions() ([]*MemRegion, error) {
 	var regions *C.struct_uc_mem_region
 	var count C.uint32_t
@@ -175,3 +262,71 @@ func (u *uc) Query(queryType int) (uint64, error) {
 	ucerr := C.uc_query(u.handle, C.uc_query_type(queryType), &ret)
 	return uint64(ret), errReturn(ucerr)
 }
+
+// TraceEnable switches events of htype (HOOK_CODE, HOOK_BLOCK,
+// HOOK_MEM_READ, HOOK_MEM_WRITE) into binary trace mode: the engine
+// appends fixed-size records to an internal ring of the given capacity
+// instead of bouncing through a Go callback per event. Drain the ring in
+// batches with TraceDrain. capacity <= 0 picks a default.
+func (u *uc) TraceEnable(htype int, capacity int) error {
+	if capacity <= 0 {
+		capacity = 0x10000
+	}
+	// the ring lives in C memory so no Go memory is pinned while enabled
+	buf := C.calloc(C.size_t(capacity), C.size_t(unsafe.Sizeof(TraceRecord{})))
+	ucerr := C.uc_trace_enable(u.handle, C.int(htype), (*C.uc_trace_record)(buf), C.size_t(capacity))
+	if ucerr != ERR_OK {
+		C.free(buf)
+		return UcError(ucerr)
+	}
+	u.traceBuf = buf
+	u.traceCap = uint64(capacity)
+	u.traceDrained = 0
+	return nil
+}
+
+// TraceDisable ends binary trace mode; events go back to hook callbacks.
+func (u *uc) TraceDisable() error {
+	ucerr := C.uc_trace_disable(u.handle)
+	if u.traceBuf != nil {
+		C.free(u.traceBuf)
+		u.traceBuf = nil
+	}
+	return errReturn(ucerr)
+}
+
+// TraceCount reports the total number of records produced since TraceEnable.
+func (u *uc) TraceCount() (uint64, error) {
+	var count C.size_t
+	ucerr := C.uc_trace_count(u.handle, &count)
+	return uint64(count), errReturn(ucerr)
+}
+
+// TraceDrain copies the records produced since the previous drain out of
+// the ring in at most two copies. Records that wrapped around the ring
+// between drains are lost; size the ring (or drain from a block hook)
+// accordingly.
+func (u *uc) TraceDrain() ([]TraceRecord, error) {
+	count, err := u.TraceCount()
+	if err != nil {
+		return nil, err
+	}
+	start := u.traceDrained
+	if count-start > u.traceCap {
+		start = count - u.traceCap // the oldest records were overwritten
+	}
+	n := count - start
+	out := make([]TraceRecord, n)
+	if n > 0 {
+		ring := (*[1 << 28]TraceRecord)(u.traceBuf)[:u.traceCap]
+		i := start % u.traceCap
+		head := u.traceCap - i
+		if head > n {
+			head = n
+		}
+		copy(out, ring[i:i+head])
+		copy(out[head:], ring[:n-head])
+	}
+	u.traceDrained = count
+	return out, nil
+}
@@ -17,6 +17,8 @@ const (
 
 	MODE_LITTLE_ENDIAN = 0
 	MODE_BIG_ENDIAN = 1073741824
+	MODE_BARE = 536870912
+	MODE_SMALL = 268435456
 
 	MODE_ARM = 0
 	MODE_THUMB = 16
@@ -80,6 +82,7 @@ const (
 	HOOK_MEM_READ = 1024
 	HOOK_MEM_WRITE = 2048
 	HOOK_MEM_FETCH = 4096
+	HOOK_ASYNC = 1073741824
 	HOOK_MEM_UNMAPPED = 112
 	HOOK_MEM_PROT = 896
 	HOOK_MEM_READ_INVALID = 144
@@ -89,10 +92,40 @@ const (
 	HOOK_MEM_VALID = 7168
 	QUERY_MODE = 1
 	QUERY_PAGE_SIZE = 2
+	QUERY_TLB_SIZE = 3
+	QUERY_TCG_BUFFER_SIZE = 4
+	QUERY_JMP_CACHE_SIZE = 5
+	QUERY_TB_COUNT = 6
+	QUERY_TB_BUFFER_USED = 7
+	QUERY_TB_FLUSH_COUNT = 8
+	QUERY_TB_INVALIDATE_COUNT = 9
+	QUERY_TB_EVICT_COUNT = 10
+	QUERY_TB_LOOKUP_COUNT = 11
+	QUERY_TB_SLOW_LOOKUP_COUNT = 12
+	QUERY_EXEC_BLOCK_COUNT = 13
+	QUERY_EXEC_INSN_COUNT = 14
+	QUERY_TLB_FILL_COUNT = 15
+	QUERY_HOOK_EVENT_COUNT = 16
+	QUERY_MEM_API_BYTES = 17
+	QUERY_EMU_START_COUNT = 18
+	QUERY_JIT_TIME_NS = 19
+	QUERY_MEM_CODE_BUFFER = 20
+	QUERY_MEM_TB_METADATA = 21
+	QUERY_MEM_PAGE_TABLES = 22
+	QUERY_MEM_TLB = 23
+	QUERY_MEM_GUEST_RAM = 24
+	QUERY_MEM_DIRTY_BITMAPS = 25
+	QUERY_MEM_HOOKS = 26
+	ARCH_STATE_VERSION = 1
+	TRANSLATE_READAHEAD_MAX = 64
+	TRACE_COMPRESSED = 1
+	TRACE_FRAME_MAGIC = 1179927381
 
 	PROT_NONE = 0
 	PROT_READ = 1
 	PROT_WRITE = 2
 	PROT_EXEC = 4
 	PROT_ALL = 7
+	MEM_HUGEPAGE = 256
+	MEM_MERGEABLE = 512
 )
\ No newline at end of file
@@ -158,3 +158,65 @@ func TestX86Mmr(t *testing.T) {
 		t.Fatalf("mmr read failed: %#v", mmr)
 	}
 }
+
+func TestX86RegBatch(t *testing.T) {
+	code := "\x41\x4a" // inc ecx; dec edx
+	mu, err := MakeUc(MODE_32, code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := mu.Start(ADDRESS, ADDRESS+uint64(len(code))); err != nil {
+		t.Fatal(err)
+	}
+	regs := []int{X86_REG_ECX, X86_REG_EDX}
+	vals, err := mu.RegReadBatch(regs)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if vals[0] != 0x1235 || vals[1] != 0x788f {
+		t.Fatalf("Bad batch register values: %#v", vals)
+	}
+	if err := mu.RegWriteBatch(regs, []uint64{1, 2}); err != nil {
+		t.Fatal(err)
+	}
+	ecx, _ := mu.RegRead(X86_REG_ECX)
+	edx, _ := mu.RegRead(X86_REG_EDX)
+	if ecx != 1 || edx != 2 {
+		t.Fatal("Bad register values after batch write.")
+	}
+}
+
+func TestX86TraceDrain(t *testing.T) {
+	code := "\x41\x4a\x90" // inc ecx; dec edx; nop
+	mu, err := MakeUc(MODE_32, code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := mu.TraceEnable(HOOK_CODE, 16); err != nil {
+		t.Fatal(err)
+	}
+	if err := mu.Start(ADDRESS, ADDRESS+uint64(len(code))); err != nil {
+		t.Fatal(err)
+	}
+	recs, err := mu.TraceDrain()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(recs) != 3 {
+		t.Fatalf("expected 3 trace records, got %d", len(recs))
+	}
+	if recs[0].Address != ADDRESS || recs[2].Address != ADDRESS+2 {
+		t.Fatalf("bad trace addresses: %#v", recs)
+	}
+	// a second drain with no new events returns nothing
+	recs, err = mu.TraceDrain()
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(recs) != 0 {
+		t.Fatalf("expected empty drain, got %d records", len(recs))
+	}
+	if err := mu.TraceDisable(); err != nil {
+		t.Fatal(err)
+	}
+}
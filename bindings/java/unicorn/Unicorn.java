@@ -461,7 +461,26 @@ public class Unicorn implements UnicornConst, ArmConst, Arm64Const, M68kConst, S
       }
    }
 
-/** 
+/**
+ * Read several registers in one native call.
+ *
+ * Reading a whole register frame this way costs a single JNI crossing
+ * instead of one per register, and no boxing of the values.
+ *
+ * @param regids  Register IDs to retrieve.
+ * @return Array of register values, index-matched to @regids.
+ */
+   public native long[] reg_read_batch(int[] regids) throws UnicornException;
+
+/**
+ * Write several registers in one native call.
+ *
+ * @param regids  Register IDs to modify.
+ * @param values  New register values, index-matched to @regids.
+ */
+   public native void reg_write_batch(int[] regids, long[] values) throws UnicornException;
+
+/**
  * Write to memory.
  *
  * @param  address  Start addres of the memory region to be written.
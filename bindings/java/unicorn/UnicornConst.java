@@ -19,6 +19,8 @@ public interface UnicornConst {
 
    public static final int UC_MODE_LITTLE_ENDIAN = 0;
    public static final int UC_MODE_BIG_ENDIAN = 1073741824;
+   public static final int UC_MODE_BARE = 536870912;
+   public static final int UC_MODE_SMALL = 268435456;
 
    public static final int UC_MODE_ARM = 0;
    public static final int UC_MODE_THUMB = 16;
@@ -82,6 +84,7 @@ public interface UnicornConst {
    public static final int UC_HOOK_MEM_READ = 1024;
    public static final int UC_HOOK_MEM_WRITE = 2048;
    public static final int UC_HOOK_MEM_FETCH = 4096;
+   public static final int UC_HOOK_ASYNC = 1073741824;
    public static final int UC_HOOK_MEM_UNMAPPED = 112;
    public static final int UC_HOOK_MEM_PROT = 896;
    public static final int UC_HOOK_MEM_READ_INVALID = 144;
@@ -91,11 +94,41 @@ public interface UnicornConst {
    public static final int UC_HOOK_MEM_VALID = 7168;
    public static final int UC_QUERY_MODE = 1;
    public static final int UC_QUERY_PAGE_SIZE = 2;
+   public static final int UC_QUERY_TLB_SIZE = 3;
+   public static final int UC_QUERY_TCG_BUFFER_SIZE = 4;
+   public static final int UC_QUERY_JMP_CACHE_SIZE = 5;
+   public static final int UC_QUERY_TB_COUNT = 6;
+   public static final int UC_QUERY_TB_BUFFER_USED = 7;
+   public static final int UC_QUERY_TB_FLUSH_COUNT = 8;
+   public static final int UC_QUERY_TB_INVALIDATE_COUNT = 9;
+   public static final int UC_QUERY_TB_EVICT_COUNT = 10;
+   public static final int UC_QUERY_TB_LOOKUP_COUNT = 11;
+   public static final int UC_QUERY_TB_SLOW_LOOKUP_COUNT = 12;
+   public static final int UC_QUERY_EXEC_BLOCK_COUNT = 13;
+   public static final int UC_QUERY_EXEC_INSN_COUNT = 14;
+   public static final int UC_QUERY_TLB_FILL_COUNT = 15;
+   public static final int UC_QUERY_HOOK_EVENT_COUNT = 16;
+   public static final int UC_QUERY_MEM_API_BYTES = 17;
+   public static final int UC_QUERY_EMU_START_COUNT = 18;
+   public static final int UC_QUERY_JIT_TIME_NS = 19;
+   public static final int UC_QUERY_MEM_CODE_BUFFER = 20;
+   public static final int UC_QUERY_MEM_TB_METADATA = 21;
+   public static final int UC_QUERY_MEM_PAGE_TABLES = 22;
+   public static final int UC_QUERY_MEM_TLB = 23;
+   public static final int UC_QUERY_MEM_GUEST_RAM = 24;
+   public static final int UC_QUERY_MEM_DIRTY_BITMAPS = 25;
+   public static final int UC_QUERY_MEM_HOOKS = 26;
+   public static final int UC_ARCH_STATE_VERSION = 1;
+   public static final int UC_TRANSLATE_READAHEAD_MAX = 64;
+   public static final int UC_TRACE_COMPRESSED = 1;
+   public static final int UC_TRACE_FRAME_MAGIC = 1179927381;
 
    public static final int UC_PROT_NONE = 0;
    public static final int UC_PROT_READ = 1;
    public static final int UC_PROT_WRITE = 2;
    public static final int UC_PROT_EXEC = 4;
    public static final int UC_PROT_ALL = 7;
+   public static final int UC_MEM_HUGEPAGE = 256;
+   public static final int UC_MEM_MERGEABLE = 512;
 
 }
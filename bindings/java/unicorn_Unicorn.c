@@ -42,8 +42,19 @@ static jmethodID invokeSyscallCallbacks = 0;
 
 static JavaVM* cachedJVM;
 
+//cache the unicorn.Unicorn class as a global ref; the callbacks used to
+//FindClass it on every single event
+static jclass clazzUnicorn = 0;
+
 JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *jvm, void *reserved) {
+   JNIEnv *env;
    cachedJVM = jvm;
+   if ((*jvm)->GetEnv(jvm, (void **)&env, JNI_VERSION_1_6) == JNI_OK) {
+      jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");
+      if (clz != NULL) {
+         clazzUnicorn = (*env)->NewGlobalRef(env, clz);
+      }
+   }
    return JNI_VERSION_1_6;
 }
 
@@ -54,7 +65,7 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *jvm, void *reserved) {
 static void cb_hookcode(uc_engine *eng, uint64_t address, uint32_t size, void *user_data) {
    JNIEnv *env;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return;
    }
@@ -69,7 +80,7 @@ static void cb_hookcode(uc_engine *eng, uint64_t address, uint32_t size, void *u
 static void cb_hookblock(uc_engine *eng, uint64_t address, uint32_t size, void *user_data) {
    JNIEnv *env;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return;
    }
@@ -83,7 +94,7 @@ static void cb_hookblock(uc_engine *eng, uint64_t address, uint32_t size, void *
 static void cb_hookintr(uc_engine *eng, uint32_t intno, void *user_data) {
    JNIEnv *env;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");   
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return;
    }
@@ -99,7 +110,7 @@ static uint32_t cb_insn_in(uc_engine *eng, uint32_t port, int size, void *user_d
    JNIEnv *env;
    uint32_t res = 0;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");   
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return 0;
    }
@@ -115,7 +126,7 @@ static uint32_t cb_insn_in(uc_engine *eng, uint32_t port, int size, void *user_d
 static void cb_insn_out(uc_engine *eng, uint32_t port, int size, uint32_t value, void *user_data) {
    JNIEnv *env;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");   
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return;
    }
@@ -127,7 +138,7 @@ static void cb_insn_out(uc_engine *eng, uint32_t port, int size, uint32_t value,
 static void cb_insn_syscall(uc_engine *eng, void *user_data) {
    JNIEnv *env;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");   
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return;
    }
@@ -145,7 +156,7 @@ static void cb_hookmem(uc_engine *eng, uc_mem_type type,
         uint64_t address, int size, int64_t value, void *user_data) {
    JNIEnv *env;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");   
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return;
    }
@@ -171,7 +182,7 @@ static bool cb_eventmem(uc_engine *eng, uc_mem_type type,
                         uint64_t address, int size, int64_t value, void *user_data) {
    JNIEnv *env;
    (*cachedJVM)->AttachCurrentThread(cachedJVM, (void **)&env, NULL);
-   jclass clz = (*env)->FindClass(env, "unicorn/Unicorn");   
+   jclass clz = clazzUnicorn;
    if ((*env)->ExceptionCheck(env)) {
       return false;
    }
@@ -436,6 +447,72 @@ JNIEXPORT jbyteArray JNICALL Java_unicorn_Unicorn_reg_1read
    return regval;
 }
 
+/*
+ * Class:     unicorn_Unicorn
+ * Method:    reg_read_batch
+ * Signature: ([I)[J
+ */
+JNIEXPORT jlongArray JNICALL Java_unicorn_Unicorn_reg_1read_1batch
+  (JNIEnv *env, jobject self, jintArray regids) {
+   uc_engine *eng = getEngine(env, self);
+   jsize count = (*env)->GetArrayLength(env, regids);
+   jlongArray result = (*env)->NewLongArray(env, count);
+   int *regs = (int *)malloc(sizeof(int) * count);
+   uint64_t *vals = (uint64_t *)calloc(count, sizeof(uint64_t));
+   void **ptrs = (void **)malloc(sizeof(void *) * count);
+   jint *ids = (*env)->GetIntArrayElements(env, regids, NULL);
+   jsize i;
+   for (i = 0; i < count; i++) {
+      regs[i] = (int)ids[i];
+      ptrs[i] = &vals[i];
+   }
+   (*env)->ReleaseIntArrayElements(env, regids, ids, JNI_ABORT);
+   uc_err err = uc_reg_read_batch(eng, regs, ptrs, (int)count);
+   if (err != UC_ERR_OK) {
+      throwException(env, err);
+   }
+   else {
+      (*env)->SetLongArrayRegion(env, result, 0, count, (jlong *)vals);
+   }
+   free(ptrs);
+   free(vals);
+   free(regs);
+   return result;
+}
+
+/*
+ * Class:     unicorn_Unicorn
+ * Method:    reg_write_batch
+ * Signature: ([I[J)V
+ */
+JNIEXPORT void JNICALL Java_unicorn_Unicorn_reg_1write_1batch
+  (JNIEnv *env, jobject self, jintArray regids, jlongArray values) {
+   uc_engine *eng = getEngine(env, self);
+   jsize count = (*env)->GetArrayLength(env, regids);
+   if ((*env)->GetArrayLength(env, values) != count) {
+      throwException(env, UC_ERR_ARG);
+      return;
+   }
+   int *regs = (int *)malloc(sizeof(int) * count);
+   uint64_t *vals = (uint64_t *)malloc(sizeof(uint64_t) * count);
+   void **ptrs = (void **)malloc(sizeof(void *) * count);
+   jint *ids = (*env)->GetIntArrayElements(env, regids, NULL);
+   jsize i;
+   for (i = 0; i < count; i++) {
+      regs[i] = (int)ids[i];
+      ptrs[i] = &vals[i];
+   }
+   (*env)->ReleaseIntArrayElements(env, regids, ids, JNI_ABORT);
+   (*env)->GetLongArrayRegion(env, values, 0, count, (jlong *)vals);
+   uc_err err = uc_reg_write_batch(eng, regs, ptrs, (int)count);
+   if (err != UC_ERR_OK) {
+      throwException(env, err);
+   }
+   free(ptrs);
+   free(vals);
+   free(regs);
+}
+
 /*
  * Class:     unicorn_Unicorn
  * Method:    mem_write
@@ -445,15 +522,16 @@ JNIEXPORT void JNICALL Java_unicorn_Unicorn_mem_1write
   (JNIEnv *env , jobject self, jlong address, jbyteArray bytes) {
 
    uc_engine *eng = getEngine(env, self);
-   jbyte *array = (*env)->GetByteArrayElements(env, bytes, NULL);
    jsize size = (*env)->GetArrayLength(env, bytes);
+   //critical access pins the array instead of copying it on most JVMs;
+   //no other JNI call may happen before the release
+   jbyte *array = (*env)->GetPrimitiveArrayCritical(env, bytes, NULL);
    uc_err err = uc_mem_write(eng, (uint64_t)address, array, (size_t)size);
+   (*env)->ReleasePrimitiveArrayCritical(env, bytes, array, JNI_ABORT);
 
    if (err != UC_ERR_OK) {
       throwException(env, err);
    }
-
-   (*env)->ReleaseByteArrayElements(env, bytes, array, JNI_ABORT);
 }
 
 /*
@@ -466,12 +544,14 @@ JNIEXPORT jbyteArray JNICALL Java_unicorn_Unicorn_mem_1read
    uc_engine *eng = getEngine(env, self);
 
    jbyteArray bytes = (*env)->NewByteArray(env, (jsize)size);
-   jbyte *array = (*env)->GetByteArrayElements(env, bytes, NULL);
+   //critical access pins the array instead of copying it on most JVMs;
+   //no other JNI call may happen before the release
+   jbyte *array = (*env)->GetPrimitiveArrayCritical(env, bytes, NULL);
    uc_err err = uc_mem_read(eng, (uint64_t)address, array, (size_t)size);
+   (*env)->ReleasePrimitiveArrayCritical(env, bytes, array, 0);
    if (err != UC_ERR_OK) {
       throwException(env, err);
    }
-   (*env)->ReleaseByteArrayElements(env, bytes, array, 0);
    return bytes;
 }
 
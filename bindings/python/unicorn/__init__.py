@@ -1,4 +1,26 @@
 # Unicorn Python bindings, by Nguyen Anh Quynnh <aquynh@gmail.com>
+import os
+import platform
+
 from . import arm_const, arm64_const, mips_const, sparc_const, m68k_const, x86_const
 from .unicorn_const import *
-from .unicorn import Uc, uc_version, uc_arch_supported, version_bind, debug, UcError, __version__
+
+# backend selection: UNICORN_BACKEND forces "ctypes" or "cffi"; with no
+# override the compiled cffi backend (see unicorn_cffi_build.py) is
+# preferred whenever it has been built - it is strictly faster,
+# dramatically so on PyPy - and the ctypes backend is the fallback
+_backend = os.environ.get("UNICORN_BACKEND")
+if _backend not in (None, "ctypes", "cffi"):
+    raise ImportError("unsupported UNICORN_BACKEND: %r" % _backend)
+
+if _backend != "ctypes":
+    try:
+        from .unicorn_cffi import Uc, uc_version, uc_arch_supported, version_bind, debug, UcError, __version__
+        _backend = "cffi"
+    except ImportError:
+        if _backend == "cffi":
+            raise
+
+if _backend != "cffi":
+    from .unicorn import Uc, uc_version, uc_arch_supported, version_bind, debug, UcError, __version__
+    _backend = "ctypes"
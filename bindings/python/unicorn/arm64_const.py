@@ -272,3 +272,268 @@ UC_ARM64_REG_IP1 = 215
 UC_ARM64_REG_IP0 = 216
 UC_ARM64_REG_FP = 1
 UC_ARM64_REG_LR = 2
+
+# Register metadata for the batch APIs: regid -> (size in bytes, class)
+# class: 0 = general, 1 = float/vector, 2 = control/system
+UC_ARM64_REG_META = {
+    UC_ARM64_REG_X29: (8, 0),
+    UC_ARM64_REG_X30: (8, 0),
+    UC_ARM64_REG_NZCV: (4, 2),
+    UC_ARM64_REG_SP: (8, 0),
+    UC_ARM64_REG_WSP: (4, 0),
+    UC_ARM64_REG_WZR: (4, 0),
+    UC_ARM64_REG_XZR: (8, 0),
+    UC_ARM64_REG_B0: (1, 1),
+    UC_ARM64_REG_B1: (1, 1),
+    UC_ARM64_REG_B2: (1, 1),
+    UC_ARM64_REG_B3: (1, 1),
+    UC_ARM64_REG_B4: (1, 1),
+    UC_ARM64_REG_B5: (1, 1),
+    UC_ARM64_REG_B6: (1, 1),
+    UC_ARM64_REG_B7: (1, 1),
+    UC_ARM64_REG_B8: (1, 1),
+    UC_ARM64_REG_B9: (1, 1),
+    UC_ARM64_REG_B10: (1, 1),
+    UC_ARM64_REG_B11: (1, 1),
+    UC_ARM64_REG_B12: (1, 1),
+    UC_ARM64_REG_B13: (1, 1),
+    UC_ARM64_REG_B14: (1, 1),
+    UC_ARM64_REG_B15: (1, 1),
+    UC_ARM64_REG_B16: (1, 1),
+    UC_ARM64_REG_B17: (1, 1),
+    UC_ARM64_REG_B18: (1, 1),
+    UC_ARM64_REG_B19: (1, 1),
+    UC_ARM64_REG_B20: (1, 1),
+    UC_ARM64_REG_B21: (1, 1),
+    UC_ARM64_REG_B22: (1, 1),
+    UC_ARM64_REG_B23: (1, 1),
+    UC_ARM64_REG_B24: (1, 1),
+    UC_ARM64_REG_B25: (1, 1),
+    UC_ARM64_REG_B26: (1, 1),
+    UC_ARM64_REG_B27: (1, 1),
+    UC_ARM64_REG_B28: (1, 1),
+    UC_ARM64_REG_B29: (1, 1),
+    UC_ARM64_REG_B30: (1, 1),
+    UC_ARM64_REG_B31: (1, 1),
+    UC_ARM64_REG_D0: (8, 1),
+    UC_ARM64_REG_D1: (8, 1),
+    UC_ARM64_REG_D2: (8, 1),
+    UC_ARM64_REG_D3: (8, 1),
+    UC_ARM64_REG_D4: (8, 1),
+    UC_ARM64_REG_D5: (8, 1),
+    UC_ARM64_REG_D6: (8, 1),
+    UC_ARM64_REG_D7: (8, 1),
+    UC_ARM64_REG_D8: (8, 1),
+    UC_ARM64_REG_D9: (8, 1),
+    UC_ARM64_REG_D10: (8, 1),
+    UC_ARM64_REG_D11: (8, 1),
+    UC_ARM64_REG_D12: (8, 1),
+    UC_ARM64_REG_D13: (8, 1),
+    UC_ARM64_REG_D14: (8, 1),
+    UC_ARM64_REG_D15: (8, 1),
+    UC_ARM64_REG_D16: (8, 1),
+    UC_ARM64_REG_D17: (8, 1),
+    UC_ARM64_REG_D18: (8, 1),
+    UC_ARM64_REG_D19: (8, 1),
+    UC_ARM64_REG_D20: (8, 1),
+    UC_ARM64_REG_D21: (8, 1),
+    UC_ARM64_REG_D22: (8, 1),
+    UC_ARM64_REG_D23: (8, 1),
+    UC_ARM64_REG_D24: (8, 1),
+    UC_ARM64_REG_D25: (8, 1),
+    UC_ARM64_REG_D26: (8, 1),
+    UC_ARM64_REG_D27: (8, 1),
+    UC_ARM64_REG_D28: (8, 1),
+    UC_ARM64_REG_D29: (8, 1),
+    UC_ARM64_REG_D30: (8, 1),
+    UC_ARM64_REG_D31: (8, 1),
+    UC_ARM64_REG_H0: (2, 1),
+    UC_ARM64_REG_H1: (2, 1),
+    UC_ARM64_REG_H2: (2, 1),
+    UC_ARM64_REG_H3: (2, 1),
+    UC_ARM64_REG_H4: (2, 1),
+    UC_ARM64_REG_H5: (2, 1),
+    UC_ARM64_REG_H6: (2, 1),
+    UC_ARM64_REG_H7: (2, 1),
+    UC_ARM64_REG_H8: (2, 1),
+    UC_ARM64_REG_H9: (2, 1),
+    UC_ARM64_REG_H10: (2, 1),
+    UC_ARM64_REG_H11: (2, 1),
+    UC_ARM64_REG_H12: (2, 1),
+    UC_ARM64_REG_H13: (2, 1),
+    UC_ARM64_REG_H14: (2, 1),
+    UC_ARM64_REG_H15: (2, 1),
+    UC_ARM64_REG_H16: (2, 1),
+    UC_ARM64_REG_H17: (2, 1),
+    UC_ARM64_REG_H18: (2, 1),
+    UC_ARM64_REG_H19: (2, 1),
+    UC_ARM64_REG_H20: (2, 1),
+    UC_ARM64_REG_H21: (2, 1),
+    UC_ARM64_REG_H22: (2, 1),
+    UC_ARM64_REG_H23: (2, 1),
+    UC_ARM64_REG_H24: (2, 1),
+    UC_ARM64_REG_H25: (2, 1),
+    UC_ARM64_REG_H26: (2, 1),
+    UC_ARM64_REG_H27: (2, 1),
+    UC_ARM64_REG_H28: (2, 1),
+    UC_ARM64_REG_H29: (2, 1),
+    UC_ARM64_REG_H30: (2, 1),
+    UC_ARM64_REG_H31: (2, 1),
+    UC_ARM64_REG_Q0: (16, 1),
+    UC_ARM64_REG_Q1: (16, 1),
+    UC_ARM64_REG_Q2: (16, 1),
+    UC_ARM64_REG_Q3: (16, 1),
+    UC_ARM64_REG_Q4: (16, 1),
+    UC_ARM64_REG_Q5: (16, 1),
+    UC_ARM64_REG_Q6: (16, 1),
+    UC_ARM64_REG_Q7: (16, 1),
+    UC_ARM64_REG_Q8: (16, 1),
+    UC_ARM64_REG_Q9: (16, 1),
+    UC_ARM64_REG_Q10: (16, 1),
+    UC_ARM64_REG_Q11: (16, 1),
+    UC_ARM64_REG_Q12: (16, 1),
+    UC_ARM64_REG_Q13: (16, 1),
+    UC_ARM64_REG_Q14: (16, 1),
+    UC_ARM64_REG_Q15: (16, 1),
+    UC_ARM64_REG_Q16: (16, 1),
+    UC_ARM64_REG_Q17: (16, 1),
+    UC_ARM64_REG_Q18: (16, 1),
+    UC_ARM64_REG_Q19: (16, 1),
+    UC_ARM64_REG_Q20: (16, 1),
+    UC_ARM64_REG_Q21: (16, 1),
+    UC_ARM64_REG_Q22: (16, 1),
+    UC_ARM64_REG_Q23: (16, 1),
+    UC_ARM64_REG_Q24: (16, 1),
+    UC_ARM64_REG_Q25: (16, 1),
+    UC_ARM64_REG_Q26: (16, 1),
+    UC_ARM64_REG_Q27: (16, 1),
+    UC_ARM64_REG_Q28: (16, 1),
+    UC_ARM64_REG_Q29: (16, 1),
+    UC_ARM64_REG_Q30: (16, 1),
+    UC_ARM64_REG_Q31: (16, 1),
+    UC_ARM64_REG_S0: (4, 1),
+    UC_ARM64_REG_S1: (4, 1),
+    UC_ARM64_REG_S2: (4, 1),
+    UC_ARM64_REG_S3: (4, 1),
+    UC_ARM64_REG_S4: (4, 1),
+    UC_ARM64_REG_S5: (4, 1),
+    UC_ARM64_REG_S6: (4, 1),
+    UC_ARM64_REG_S7: (4, 1),
+    UC_ARM64_REG_S8: (4, 1),
+    UC_ARM64_REG_S9: (4, 1),
+    UC_ARM64_REG_S10: (4, 1),
+    UC_ARM64_REG_S11: (4, 1),
+    UC_ARM64_REG_S12: (4, 1),
+    UC_ARM64_REG_S13: (4, 1),
+    UC_ARM64_REG_S14: (4, 1),
+    UC_ARM64_REG_S15: (4, 1),
+    UC_ARM64_REG_S16: (4, 1),
+    UC_ARM64_REG_S17: (4, 1),
+    UC_ARM64_REG_S18: (4, 1),
+    UC_ARM64_REG_S19: (4, 1),
+    UC_ARM64_REG_S20: (4, 1),
+    UC_ARM64_REG_S21: (4, 1),
+    UC_ARM64_REG_S22: (4, 1),
+    UC_ARM64_REG_S23: (4, 1),
+    UC_ARM64_REG_S24: (4, 1),
+    UC_ARM64_REG_S25: (4, 1),
+    UC_ARM64_REG_S26: (4, 1),
+    UC_ARM64_REG_S27: (4, 1),
+    UC_ARM64_REG_S28: (4, 1),
+    UC_ARM64_REG_S29: (4, 1),
+    UC_ARM64_REG_S30: (4, 1),
+    UC_ARM64_REG_S31: (4, 1),
+    UC_ARM64_REG_W0: (4, 0),
+    UC_ARM64_REG_W1: (4, 0),
+    UC_ARM64_REG_W2: (4, 0),
+    UC_ARM64_REG_W3: (4, 0),
+    UC_ARM64_REG_W4: (4, 0),
+    UC_ARM64_REG_W5: (4, 0),
+    UC_ARM64_REG_W6: (4, 0),
+    UC_ARM64_REG_W7: (4, 0),
+    UC_ARM64_REG_W8: (4, 0),
+    UC_ARM64_REG_W9: (4, 0),
+    UC_ARM64_REG_W10: (4, 0),
+    UC_ARM64_REG_W11: (4, 0),
+    UC_ARM64_REG_W12: (4, 0),
+    UC_ARM64_REG_W13: (4, 0),
+    UC_ARM64_REG_W14: (4, 0),
+    UC_ARM64_REG_W15: (4, 0),
+    UC_ARM64_REG_W16: (4, 0),
+    UC_ARM64_REG_W17: (4, 0),
+    UC_ARM64_REG_W18: (4, 0),
+    UC_ARM64_REG_W19: (4, 0),
+    UC_ARM64_REG_W20: (4, 0),
+    UC_ARM64_REG_W21: (4, 0),
+    UC_ARM64_REG_W22: (4, 0),
+    UC_ARM64_REG_W23: (4, 0),
+    UC_ARM64_REG_W24: (4, 0),
+    UC_ARM64_REG_W25: (4, 0),
+    UC_ARM64_REG_W26: (4, 0),
+    UC_ARM64_REG_W27: (4, 0),
+    UC_ARM64_REG_W28: (4, 0),
+    UC_ARM64_REG_W29: (4, 0),
+    UC_ARM64_REG_W30: (4, 0),
+    UC_ARM64_REG_X0: (8, 0),
+    UC_ARM64_REG_X1: (8, 0),
+    UC_ARM64_REG_X2: (8, 0),
+    UC_ARM64_REG_X3: (8, 0),
+    UC_ARM64_REG_X4: (8, 0),
+    UC_ARM64_REG_X5: (8, 0),
+    UC_ARM64_REG_X6: (8, 0),
+    UC_ARM64_REG_X7: (8, 0),
+    UC_ARM64_REG_X8: (8, 0),
+    UC_ARM64_REG_X9: (8, 0),
+    UC_ARM64_REG_X10: (8, 0),
+    UC_ARM64_REG_X11: (8, 0),
+    UC_ARM64_REG_X12: (8, 0),
+    UC_ARM64_REG_X13: (8, 0),
+    UC_ARM64_REG_X14: (8, 0),
+    UC_ARM64_REG_X15: (8, 0),
+    UC_ARM64_REG_X16: (8, 0),
+    UC_ARM64_REG_X17: (8, 0),
+    UC_ARM64_REG_X18: (8, 0),
+    UC_ARM64_REG_X19: (8, 0),
+    UC_ARM64_REG_X20: (8, 0),
+    UC_ARM64_REG_X21: (8, 0),
+    UC_ARM64_REG_X22: (8, 0),
+    UC_ARM64_REG_X23: (8, 0),
+    UC_ARM64_REG_X24: (8, 0),
+    UC_ARM64_REG_X25: (8, 0),
+    UC_ARM64_REG_X26: (8, 0),
+    UC_ARM64_REG_X27: (8, 0),
+    UC_ARM64_REG_X28: (8, 0),
+    UC_ARM64_REG_V0: (16, 1),
+    UC_ARM64_REG_V1: (16, 1),
+    UC_ARM64_REG_V2: (16, 1),
+    UC_ARM64_REG_V3: (16, 1),
+    UC_ARM64_REG_V4: (16, 1),
+    UC_ARM64_REG_V5: (16, 1),
+    UC_ARM64_REG_V6: (16, 1),
+    UC_ARM64_REG_V7: (16, 1),
+    UC_ARM64_REG_V8: (16, 1),
+    UC_ARM64_REG_V9: (16, 1),
+    UC_ARM64_REG_V10: (16, 1),
+    UC_ARM64_REG_V11: (16, 1),
+    UC_ARM64_REG_V12: (16, 1),
+    UC_ARM64_REG_V13: (16, 1),
+    UC_ARM64_REG_V14: (16, 1),
+    UC_ARM64_REG_V15: (16, 1),
+    UC_ARM64_REG_V16: (16, 1),
+    UC_ARM64_REG_V17: (16, 1),
+    UC_ARM64_REG_V18: (16, 1),
+    UC_ARM64_REG_V19: (16, 1),
+    UC_ARM64_REG_V20: (16, 1),
+    UC_ARM64_REG_V21: (16, 1),
+    UC_ARM64_REG_V22: (16, 1),
+    UC_ARM64_REG_V23: (16, 1),
+    UC_ARM64_REG_V24: (16, 1),
+    UC_ARM64_REG_V25: (16, 1),
+    UC_ARM64_REG_V26: (16, 1),
+    UC_ARM64_REG_V27: (16, 1),
+    UC_ARM64_REG_V28: (16, 1),
+    UC_ARM64_REG_V29: (16, 1),
+    UC_ARM64_REG_V30: (16, 1),
+    UC_ARM64_REG_V31: (16, 1),
+    UC_ARM64_REG_PC: (8, 0),
+}
@@ -22,3 +22,26 @@ UC_M68K_REG_D7 = 16
 UC_M68K_REG_SR = 17
 UC_M68K_REG_PC = 18
 UC_M68K_REG_ENDING = 19
+
+# Register metadata for the batch APIs: regid -> (size in bytes, class)
+# class: 0 = general, 1 = float/vector, 2 = control/system
+UC_M68K_REG_META = {
+    UC_M68K_REG_A0: (4, 0),
+    UC_M68K_REG_A1: (4, 0),
+    UC_M68K_REG_A2: (4, 0),
+    UC_M68K_REG_A3: (4, 0),
+    UC_M68K_REG_A4: (4, 0),
+    UC_M68K_REG_A5: (4, 0),
+    UC_M68K_REG_A6: (4, 0),
+    UC_M68K_REG_A7: (4, 0),
+    UC_M68K_REG_D0: (4, 0),
+    UC_M68K_REG_D1: (4, 0),
+    UC_M68K_REG_D2: (4, 0),
+    UC_M68K_REG_D3: (4, 0),
+    UC_M68K_REG_D4: (4, 0),
+    UC_M68K_REG_D5: (4, 0),
+    UC_M68K_REG_D6: (4, 0),
+    UC_M68K_REG_D7: (4, 0),
+    UC_M68K_REG_SR: (4, 2),
+    UC_M68K_REG_PC: (4, 0),
+}
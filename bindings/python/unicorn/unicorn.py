@@ -8,6 +8,12 @@ from .unicorn_const import *
 
 import ctypes, ctypes.util, sys
 from platform import system
+
+# numpy is only needed for trace_drain(); everything else works without it
+try:
+    import numpy as _np
+except ImportError:
+    _np = None
 from os.path import split, join, dirname, exists
 import distutils.sysconfig
 
@@ -100,6 +106,8 @@ _setup_prototype(_uc, "uc_strerror", ctypes.c_char_p, ucerr)
 _setup_prototype(_uc, "uc_errno", ucerr, uc_engine)
 _setup_prototype(_uc, "uc_reg_read", ucerr, uc_engine, ctypes.c_int, ctypes.c_void_p)
 _setup_prototype(_uc, "uc_reg_write", ucerr, uc_engine, ctypes.c_int, ctypes.c_void_p)
+_setup_prototype(_uc, "uc_reg_read_batch", ucerr, uc_engine, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_void_p), ctypes.c_int)
+_setup_prototype(_uc, "uc_reg_write_batch", ucerr, uc_engine, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_void_p), ctypes.c_int)
 _setup_prototype(_uc, "uc_mem_read", ucerr, uc_engine, ctypes.c_uint64, ctypes.POINTER(ctypes.c_char), ctypes.c_size_t)
 _setup_prototype(_uc, "uc_mem_write", ucerr, uc_engine, ctypes.c_uint64, ctypes.POINTER(ctypes.c_char), ctypes.c_size_t)
 _setup_prototype(_uc, "uc_emu_start", ucerr, uc_engine, ctypes.c_uint64, ctypes.c_uint64, ctypes.c_uint64, ctypes.c_size_t)
@@ -110,6 +118,23 @@ _setup_prototype(_uc, "uc_mem_map_ptr", ucerr, uc_engine, ctypes.c_uint64, ctype
 _setup_prototype(_uc, "uc_mem_unmap", ucerr, uc_engine, ctypes.c_uint64, ctypes.c_size_t)
 _setup_prototype(_uc, "uc_mem_protect", ucerr, uc_engine, ctypes.c_uint64, ctypes.c_size_t, ctypes.c_uint32)
 _setup_prototype(_uc, "uc_query", ucerr, uc_engine, ctypes.c_uint32, ctypes.POINTER(ctypes.c_size_t))
+_setup_prototype(_uc, "uc_mem_ptr", ucerr, uc_engine, ctypes.c_uint64, ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_size_t))
+
+
+# mirrors uc_trace_record from <unicorn/unicorn.h>
+class UcTraceRecord(ctypes.Structure):
+    _fields_ = [
+        ("address", ctypes.c_uint64),
+        ("type", ctypes.c_uint32),
+        ("size", ctypes.c_uint32),
+    ]
+
+# numpy view of the same layout, for trace_drain()
+UC_TRACE_DTYPE = [("address", "u8"), ("type", "u4"), ("size", "u4")]
+
+_setup_prototype(_uc, "uc_trace_enable", ucerr, uc_engine, ctypes.c_int, ctypes.POINTER(UcTraceRecord), ctypes.c_size_t)
+_setup_prototype(_uc, "uc_trace_disable", ucerr, uc_engine)
+_setup_prototype(_uc, "uc_trace_count", ucerr, uc_engine, ctypes.POINTER(ctypes.c_size_t))
 
 # uc_hook_add is special due to variable number of arguments
 _uc.uc_hook_add = getattr(_uc, "uc_hook_add")
@@ -171,8 +196,8 @@ class Uc(object):
         if status != UC_ERR_OK:
             self._uch = None
             raise UcError(status)
-        # internal mapping table to save callback & userdata
-        self._callbacks = {}
+        # keep the ctypes trampolines alive for the gc; each one closes
+        # over its user callback and user_data
         self._ctype_cbs = {}
         self._callback_count = 0
 
@@ -222,6 +247,36 @@ class Uc(object):
             raise UcError(status)
 
 
+    # read several registers in one library call; takes an iterable of
+    # register ids and returns {reg_id: value}. A whole register frame
+    # costs one ctypes dispatch instead of one per register.
+    def reg_read_batch(self, reg_ids):
+        reg_ids = list(reg_ids)
+        count = len(reg_ids)
+        regs = (ctypes.c_int * count)(*reg_ids)
+        vals = (ctypes.c_int64 * count)()
+        ptrs = (ctypes.c_void_p * count)()
+        for i in range(count):
+            ptrs[i] = ctypes.addressof(vals) + i * ctypes.sizeof(ctypes.c_int64)
+        status = _uc.uc_reg_read_batch(self._uch, regs, ptrs, count)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        return dict(zip(reg_ids, vals))
+
+
+    # write a {reg_id: value} dict of registers in one library call
+    def reg_write_batch(self, reg_vals):
+        count = len(reg_vals)
+        regs = (ctypes.c_int * count)(*reg_vals.keys())
+        vals = (ctypes.c_int64 * count)(*reg_vals.values())
+        ptrs = (ctypes.c_void_p * count)()
+        for i in range(count):
+            ptrs[i] = ctypes.addressof(vals) + i * ctypes.sizeof(ctypes.c_int64)
+        status = _uc.uc_reg_write_batch(self._uch, regs, ptrs, count)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
     # read data from memory
     def mem_read(self, address, size):
         data = ctypes.create_string_buffer(size)
@@ -231,6 +286,27 @@ class Uc(object):
         return bytearray(data)
 
 
+    # zero-copy view of guest memory: a writable memoryview over the host
+    # pages backing the mapping that contains address, so large regions can
+    # be sliced without the two copies mem_read() makes. size=0 returns the
+    # rest of the contiguous mapping. Writes through the view bypass write
+    # protection and code invalidation (see uc_mem_ptr), and the view is
+    # only valid until the mapping is unmapped or the engine is closed.
+    def mem_view(self, address, size=0):
+        ptr = ctypes.c_void_p()
+        avail = ctypes.c_size_t()
+        status = _uc.uc_mem_ptr(self._uch, address, ctypes.byref(ptr), ctypes.byref(avail))
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        if size == 0:
+            size = avail.value
+        elif size > avail.value:
+            # the requested span runs off the contiguous mapping
+            raise UcError(UC_ERR_ARG)
+        buf = (ctypes.c_ubyte * size).from_address(ptr.value)
+        return memoryview(buf)
+
+
     # write to memory
     def mem_write(self, address, data):
         status = _uc.uc_mem_write(self._uch, address, data, len(data))
@@ -274,90 +350,152 @@ class Uc(object):
         return result.value
 
 
-    def _hookcode_cb(self, handle, address, size, user_data):
-        # call user's callback with self object
-        (cb, data) = self._callbacks[user_data]
-        cb(self, address, size, data)
-
-
-    def _hook_mem_invalid_cb(self, handle, access, address, size, value, user_data):
-        # call user's callback with self object
-        (cb, data) = self._callbacks[user_data]
-        return cb(self, access, address, size, value, data)
-
-
-    def _hook_mem_access_cb(self, handle, access, address, size, value, user_data):
-        # call user's callback with self object
-        (cb, data) = self._callbacks[user_data]
-        cb(self, access, address, size, value, data)
-
-
-    def _hook_intr_cb(self, handle, intno, user_data):
-        # call user's callback with self object
-        (cb, data) = self._callbacks[user_data]
-        cb(self, intno, data)
-
-
-    def _hook_insn_in_cb(self, handle, port, size, user_data):
-        # call user's callback with self object
-        (cb, data) = self._callbacks[user_data]
-        return cb(self, port, size, data)
+    # enable binary trace mode: events of htype (UC_HOOK_CODE, UC_HOOK_BLOCK,
+    # UC_HOOK_MEM_READ, UC_HOOK_MEM_WRITE) are appended to an internal ring
+    # of capacity records instead of firing per-event Python callbacks
+    def trace_enable(self, htype, capacity=0x10000):
+        buf = (UcTraceRecord * capacity)()
+        status = _uc.uc_trace_enable(self._uch, htype, buf, capacity)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        self._trace_buf = buf
+        self._trace_capacity = capacity
+        self._trace_drained = 0
 
 
-    def _hook_insn_out_cb(self, handle, port, size, value, user_data):
-        # call user's callback with self object
-        (cb, data) = self._callbacks[user_data]
-        cb(self, port, size, value, data)
+    # disable binary trace mode; events go back to hook callbacks
+    def trace_disable(self):
+        status = _uc.uc_trace_disable(self._uch)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        self._trace_buf = None
 
 
-    def _hook_insn_syscall_cb(self, handle, user_data):
-        # call user's callback with self object
-        (cb, data) = self._callbacks[user_data]
-        cb(self, data)
+    # total number of trace records produced since trace_enable()
+    def trace_count(self):
+        count = ctypes.c_size_t(0)
+        status = _uc.uc_trace_count(self._uch, ctypes.byref(count))
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        return count.value
+
+
+    # drain the trace ring into a fresh numpy structured array (dtype
+    # UC_TRACE_DTYPE) covering the records produced since the last drain.
+    # The copy-out is one or two numpy slice assignments, not a Python
+    # loop, so draining runs at memory bandwidth. Records that wrapped
+    # around the ring between drains are lost; size the ring (or drain,
+    # e.g. from a block hook) accordingly.
+    def trace_drain(self):
+        if _np is None:
+            raise ImportError("trace_drain() requires numpy")
+        count = self.trace_count()
+        cap = self._trace_capacity
+        start = self._trace_drained
+        if count - start > cap:
+            start = count - cap     # the oldest records were overwritten
+        n = count - start
+        out = _np.empty(n, dtype=UC_TRACE_DTYPE)
+        if n > 0:
+            ring = _np.frombuffer(self._trace_buf, dtype=UC_TRACE_DTYPE)
+            i = start % cap
+            head = min(n, cap - i)
+            out[:head] = ring[i:i + head]
+            out[head:] = ring[:n - head]
+        self._trace_drained = count
+        return out
+
+
+    # The trampolines below close over the user callback, user_data and
+    # this object directly, so dispatching an event does no dictionary
+    # lookup and no user_data unboxing - the only per-event work left
+    # besides ctypes argument conversion is the user's own callback.
+    def _wrap_code_cb(self, callback, user_data):
+        uc = self
+        def _cb(handle, address, size, _):
+            callback(uc, address, size, user_data)
+        return UC_HOOK_CODE_CB(_cb)
+
+
+    def _wrap_mem_invalid_cb(self, callback, user_data):
+        uc = self
+        def _cb(handle, access, address, size, value, _):
+            return callback(uc, access, address, size, value, user_data)
+        return UC_HOOK_MEM_INVALID_CB(_cb)
+
+
+    def _wrap_mem_access_cb(self, callback, user_data):
+        uc = self
+        def _cb(handle, access, address, size, value, _):
+            callback(uc, access, address, size, value, user_data)
+        return UC_HOOK_MEM_ACCESS_CB(_cb)
+
+
+    def _wrap_intr_cb(self, callback, user_data):
+        uc = self
+        def _cb(handle, intno, _):
+            callback(uc, intno, user_data)
+        return UC_HOOK_INTR_CB(_cb)
+
+
+    def _wrap_insn_in_cb(self, callback, user_data):
+        uc = self
+        def _cb(handle, port, size, _):
+            return callback(uc, port, size, user_data)
+        return UC_HOOK_INSN_IN_CB(_cb)
+
+
+    def _wrap_insn_out_cb(self, callback, user_data):
+        uc = self
+        def _cb(handle, port, size, value, _):
+            callback(uc, port, size, value, user_data)
+        return UC_HOOK_INSN_OUT_CB(_cb)
+
+
+    def _wrap_insn_syscall_cb(self, callback, user_data):
+        uc = self
+        def _cb(handle, _):
+            callback(uc, user_data)
+        return UC_HOOK_INSN_SYSCALL_CB(_cb)
 
 
     # add a hook
     def hook_add(self, htype, callback, user_data=None, begin=1, end=0, arg1=0):
         _h2 = uc_hook_h()
-
-        # save callback & user_data
-        self._callback_count += 1
-        self._callbacks[self._callback_count] = (callback, user_data)
         cb = None
 
         if htype == UC_HOOK_INSN:
             insn = ctypes.c_int(arg1)
             if arg1 == x86_const.UC_X86_INS_IN:  # IN instruction
-                cb = ctypes.cast(UC_HOOK_INSN_IN_CB(self._hook_insn_in_cb), UC_HOOK_INSN_IN_CB)
+                cb = self._wrap_insn_in_cb(callback, user_data)
             if arg1 == x86_const.UC_X86_INS_OUT: # OUT instruction
-                cb = ctypes.cast(UC_HOOK_INSN_OUT_CB(self._hook_insn_out_cb), UC_HOOK_INSN_OUT_CB)
+                cb = self._wrap_insn_out_cb(callback, user_data)
             if arg1 in (x86_const.UC_X86_INS_SYSCALL, x86_const.UC_X86_INS_SYSENTER): # SYSCALL/SYSENTER instruction
-                cb = ctypes.cast(UC_HOOK_INSN_SYSCALL_CB(self._hook_insn_syscall_cb), UC_HOOK_INSN_SYSCALL_CB)
+                cb = self._wrap_insn_syscall_cb(callback, user_data)
             status = _uc.uc_hook_add(self._uch, ctypes.byref(_h2), htype, \
-                    cb, ctypes.cast(self._callback_count, ctypes.c_void_p), ctypes.c_uint64(begin), ctypes.c_uint64(end), insn)
+                    cb, None, ctypes.c_uint64(begin), ctypes.c_uint64(end), insn)
         elif htype == UC_HOOK_INTR:
-            cb = ctypes.cast(UC_HOOK_INTR_CB(self._hook_intr_cb), UC_HOOK_INTR_CB)
+            cb = self._wrap_intr_cb(callback, user_data)
             status = _uc.uc_hook_add(self._uch, ctypes.byref(_h2), htype, \
-                    cb, ctypes.cast(self._callback_count, ctypes.c_void_p), ctypes.c_uint64(begin), ctypes.c_uint64(end))
+                    cb, None, ctypes.c_uint64(begin), ctypes.c_uint64(end))
         else:
             if htype in (UC_HOOK_BLOCK, UC_HOOK_CODE):
-                # set callback with wrapper, so it can be called
-                # with this object as param
-                cb = ctypes.cast(UC_HOOK_CODE_CB(self._hookcode_cb), UC_HOOK_CODE_CB)
+                cb = self._wrap_code_cb(callback, user_data)
                 status = _uc.uc_hook_add(self._uch, ctypes.byref(_h2), htype, cb, \
-                    ctypes.cast(self._callback_count, ctypes.c_void_p), ctypes.c_uint64(begin), ctypes.c_uint64(end))
+                    None, ctypes.c_uint64(begin), ctypes.c_uint64(end))
             elif htype & UC_HOOK_MEM_READ_UNMAPPED or htype & UC_HOOK_MEM_WRITE_UNMAPPED or \
                 htype & UC_HOOK_MEM_FETCH_UNMAPPED or htype & UC_HOOK_MEM_READ_PROT or \
                 htype & UC_HOOK_MEM_WRITE_PROT or htype & UC_HOOK_MEM_FETCH_PROT:
-                cb = ctypes.cast(UC_HOOK_MEM_INVALID_CB(self._hook_mem_invalid_cb), UC_HOOK_MEM_INVALID_CB)
+                cb = self._wrap_mem_invalid_cb(callback, user_data)
                 status = _uc.uc_hook_add(self._uch, ctypes.byref(_h2), htype, \
-                    cb, ctypes.cast(self._callback_count, ctypes.c_void_p), ctypes.c_uint64(begin), ctypes.c_uint64(end))
+                    cb, None, ctypes.c_uint64(begin), ctypes.c_uint64(end))
             else:
-                cb = ctypes.cast(UC_HOOK_MEM_ACCESS_CB(self._hook_mem_access_cb), UC_HOOK_MEM_ACCESS_CB)
+                cb = self._wrap_mem_access_cb(callback, user_data)
                 status = _uc.uc_hook_add(self._uch, ctypes.byref(_h2), htype, \
-                    cb, ctypes.cast(self._callback_count, ctypes.c_void_p), ctypes.c_uint64(begin), ctypes.c_uint64(end))
+                    cb, None, ctypes.c_uint64(begin), ctypes.c_uint64(end))
 
         # save the ctype function so gc will leave it alone.
+        self._callback_count += 1
         self._ctype_cbs[self._callback_count] = cb
 
         if status != UC_ERR_OK:
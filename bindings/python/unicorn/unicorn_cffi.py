@@ -0,0 +1,378 @@
+# Unicorn Python bindings - cffi API-mode backend.
+#
+# Same surface as the ctypes backend in unicorn.py, but calls go through a
+# compiled cffi module and hook callbacks enter Python through compiled
+# trampolines (extern "Python") instead of ctypes closure thunks. This is
+# dramatically cheaper on PyPy and noticeably cheaper on CPython for
+# hook-heavy workloads. Build the compiled module with
+# unicorn_cffi_build.py; importing this file fails cleanly without it and
+# __init__.py falls back to the ctypes backend.
+import sys
+_python2 = sys.version_info[0] < 3
+if _python2:
+    range = xrange
+
+from . import x86_const
+from .unicorn_const import *
+
+from ._unicorn_cffi import ffi, lib as _uc
+
+# numpy is only needed for trace_drain(); everything else works without it
+try:
+    import numpy as _np
+except ImportError:
+    _np = None
+
+__version__ = "%s.%s" % (UC_API_MAJOR, UC_API_MINOR)
+
+# numpy view of uc_trace_record, for trace_drain()
+UC_TRACE_DTYPE = [("address", "u8"), ("type", "u4"), ("size", "u4")]
+
+# The user_data pointer passed to uc_hook_add() is an ffi handle to the
+# (engine, callback, user_data) triple, so the compiled trampolines
+# resolve it with a single C-level ffi.from_handle() - no dictionary
+# lookup per event. The handle cdata is kept alive on the engine.
+
+
+@ffi.def_extern()
+def _py_hook_code_cb(handle, address, size, user_data):
+    (uc, cb, data) = ffi.from_handle(user_data)
+    cb(uc, address, size, data)
+
+
+@ffi.def_extern()
+def _py_hook_mem_invalid_cb(handle, access, address, size, value, user_data):
+    (uc, cb, data) = ffi.from_handle(user_data)
+    return cb(uc, access, address, size, value, data)
+
+
+@ffi.def_extern()
+def _py_hook_mem_access_cb(handle, access, address, size, value, user_data):
+    (uc, cb, data) = ffi.from_handle(user_data)
+    cb(uc, access, address, size, value, data)
+
+
+@ffi.def_extern()
+def _py_hook_intr_cb(handle, intno, user_data):
+    (uc, cb, data) = ffi.from_handle(user_data)
+    cb(uc, intno, data)
+
+
+@ffi.def_extern()
+def _py_hook_insn_in_cb(handle, port, size, user_data):
+    (uc, cb, data) = ffi.from_handle(user_data)
+    return cb(uc, port, size, data)
+
+
+@ffi.def_extern()
+def _py_hook_insn_out_cb(handle, port, size, value, user_data):
+    (uc, cb, data) = ffi.from_handle(user_data)
+    cb(uc, port, size, value, data)
+
+
+@ffi.def_extern()
+def _py_hook_insn_syscall_cb(handle, user_data):
+    (uc, cb, data) = ffi.from_handle(user_data)
+    cb(uc, data)
+
+
+# access to error code via @errno of UcError
+class UcError(Exception):
+    def __init__(self, errno):
+        self.errno = errno
+
+    def __str__(self):
+        return ffi.string(_uc.uc_strerror(self.errno)).decode("ascii")
+
+
+# return the core's version
+def uc_version():
+    major = ffi.new("unsigned int *")
+    minor = ffi.new("unsigned int *")
+    combined = _uc.uc_version(major, minor)
+    return (major[0], minor[0], combined)
+
+
+# return the binding's version
+def version_bind():
+    return (UC_API_MAJOR, UC_API_MINOR, (UC_API_MAJOR << 8) + UC_API_MINOR)
+
+
+# check to see if this engine supports a particular arch
+def uc_arch_supported(query):
+    return _uc.uc_arch_supported(query)
+
+
+class Uc(object):
+    def __init__(self, arch, mode):
+        # verify version compatibility with the core before doing anything
+        (major, minor, _combined) = uc_version()
+        if major != UC_API_MAJOR or minor != UC_API_MINOR:
+            self._uch = None
+            # our binding version is different from the core's API version
+            raise UcError(UC_ERR_VERSION)
+
+        self._arch, self._mode = arch, mode
+        uch = ffi.new("uc_engine **")
+        status = _uc.uc_open(arch, mode, uch)
+        if status != UC_ERR_OK:
+            self._uch = None
+            raise UcError(status)
+        self._uch = uch[0]
+        # ffi handles passed as user_data to uc_hook_add(); the gc must
+        # not collect them while the hooks are registered
+        self._hook_handles = []
+
+
+    # destructor to be called automatically when object is destroyed.
+    def __del__(self):
+        if self._uch:
+            try:
+                status = _uc.uc_close(self._uch)
+                self._uch = None
+                del self._hook_handles[:]
+                if status != UC_ERR_OK:
+                    raise UcError(status)
+            except: # _uc might be pulled from under our feet
+                pass
+
+
+    # emulate from @begin, and stop when reaching address @until
+    def emu_start(self, begin, until, timeout=0, count=0):
+        status = _uc.uc_emu_start(self._uch, begin, until, timeout, count)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # stop emulation
+    def emu_stop(self):
+        status = _uc.uc_emu_stop(self._uch)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # return the value of a register
+    def reg_read(self, reg_id):
+        # read to 64bit number to be safe
+        reg = ffi.new("int64_t *")
+        status = _uc.uc_reg_read(self._uch, reg_id, reg)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        return reg[0]
+
+
+    # write to a register
+    def reg_write(self, reg_id, value):
+        # convert to 64bit number to be safe
+        reg = ffi.new("int64_t *", value)
+        status = _uc.uc_reg_write(self._uch, reg_id, reg)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # read several registers in one library call; takes an iterable of
+    # register ids and returns {reg_id: value}
+    def reg_read_batch(self, reg_ids):
+        reg_ids = list(reg_ids)
+        count = len(reg_ids)
+        regs = ffi.new("int[]", reg_ids)
+        vals = ffi.new("int64_t[]", count)
+        ptrs = ffi.new("void *[]", [ffi.addressof(vals, i) for i in range(count)])
+        status = _uc.uc_reg_read_batch(self._uch, regs, ptrs, count)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        return dict(zip(reg_ids, vals))
+
+
+    # write a {reg_id: value} dict of registers in one library call
+    def reg_write_batch(self, reg_vals):
+        count = len(reg_vals)
+        regs = ffi.new("int[]", list(reg_vals.keys()))
+        vals = ffi.new("int64_t[]", list(reg_vals.values()))
+        ptrs = ffi.new("void *[]", [ffi.addressof(vals, i) for i in range(count)])
+        status = _uc.uc_reg_write_batch(self._uch, regs, ptrs, count)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # read data from memory
+    def mem_read(self, address, size):
+        data = ffi.new("char[]", size)
+        status = _uc.uc_mem_read(self._uch, address, data, size)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        return bytearray(ffi.buffer(data, size))
+
+
+    # zero-copy view of guest memory, see mem_view() in the ctypes backend
+    # for the caveats (writes bypass protection, view dies with the mapping)
+    def mem_view(self, address, size=0):
+        ptr = ffi.new("void **")
+        avail = ffi.new("size_t *")
+        status = _uc.uc_mem_ptr(self._uch, address, ptr, avail)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        if size == 0:
+            size = avail[0]
+        elif size > avail[0]:
+            # the requested span runs off the contiguous mapping
+            raise UcError(UC_ERR_ARG)
+        return memoryview(ffi.buffer(ptr[0], size))
+
+
+    # write to memory
+    def mem_write(self, address, data):
+        status = _uc.uc_mem_write(self._uch, address, bytes(data), len(data))
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # map a range of memory
+    def mem_map(self, address, size, perms=UC_PROT_ALL):
+        status = _uc.uc_mem_map(self._uch, address, size, perms)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # map a range of memory from a raw host memory address
+    def mem_map_ptr(self, address, size, perms, ptr):
+        status = _uc.uc_mem_map_ptr(self._uch, address, size, perms,
+                ffi.cast("void *", ptr))
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # unmap a range of memory
+    def mem_unmap(self, address, size):
+        status = _uc.uc_mem_unmap(self._uch, address, size)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # protect a range of memory
+    def mem_protect(self, address, size, perms=UC_PROT_ALL):
+        status = _uc.uc_mem_protect(self._uch, address, size, perms)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+    # return CPU mode at runtime
+    def query(self, query_mode):
+        result = ffi.new("size_t *")
+        status = _uc.uc_query(self._uch, query_mode, result)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        return result[0]
+
+
+    # enable binary trace mode, see trace_enable() in the ctypes backend
+    def trace_enable(self, htype, capacity=0x10000):
+        buf = ffi.new("uc_trace_record[]", capacity)
+        status = _uc.uc_trace_enable(self._uch, htype, buf, capacity)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        self._trace_buf = buf
+        self._trace_capacity = capacity
+        self._trace_drained = 0
+
+
+    # disable binary trace mode; events go back to hook callbacks
+    def trace_disable(self):
+        status = _uc.uc_trace_disable(self._uch)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        self._trace_buf = None
+
+
+    # total number of trace records produced since trace_enable()
+    def trace_count(self):
+        count = ffi.new("size_t *")
+        status = _uc.uc_trace_count(self._uch, count)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+        return count[0]
+
+
+    # drain the trace ring into a numpy structured array, see the ctypes
+    # backend for semantics (records since last drain; wrapped ones lost)
+    def trace_drain(self):
+        if _np is None:
+            raise ImportError("trace_drain() requires numpy")
+        count = self.trace_count()
+        cap = self._trace_capacity
+        start = self._trace_drained
+        if count - start > cap:
+            start = count - cap     # the oldest records were overwritten
+        n = count - start
+        out = _np.empty(n, dtype=UC_TRACE_DTYPE)
+        if n > 0:
+            ring = _np.frombuffer(ffi.buffer(self._trace_buf), dtype=UC_TRACE_DTYPE)
+            i = start % cap
+            head = min(n, cap - i)
+            out[:head] = ring[i:i + head]
+            out[head:] = ring[:n - head]
+        self._trace_drained = count
+        return out
+
+
+    # add a hook
+    def hook_add(self, htype, callback, user_data=None, begin=1, end=0, arg1=0):
+        _h2 = ffi.new("uc_hook *")
+
+        # the trampolines recover this triple via ffi.from_handle()
+        hdl = ffi.new_handle((self, callback, user_data))
+        self._hook_handles.append(hdl)
+
+        if htype == UC_HOOK_INSN:
+            if arg1 == x86_const.UC_X86_INS_IN:  # IN instruction
+                cb = _uc._py_hook_insn_in_cb
+            elif arg1 == x86_const.UC_X86_INS_OUT: # OUT instruction
+                cb = _uc._py_hook_insn_out_cb
+            else: # SYSCALL/SYSENTER instruction
+                cb = _uc._py_hook_insn_syscall_cb
+            status = _uc.uc_hook_add(self._uch, _h2, htype,
+                    ffi.cast("void *", cb), hdl, begin, end,
+                    ffi.cast("int", arg1))
+        else:
+            if htype == UC_HOOK_INTR:
+                cb = _uc._py_hook_intr_cb
+            elif htype in (UC_HOOK_BLOCK, UC_HOOK_CODE):
+                cb = _uc._py_hook_code_cb
+            elif htype & (UC_HOOK_MEM_READ_UNMAPPED | UC_HOOK_MEM_WRITE_UNMAPPED |
+                    UC_HOOK_MEM_FETCH_UNMAPPED | UC_HOOK_MEM_READ_PROT |
+                    UC_HOOK_MEM_WRITE_PROT | UC_HOOK_MEM_FETCH_PROT):
+                cb = _uc._py_hook_mem_invalid_cb
+            else:
+                cb = _uc._py_hook_mem_access_cb
+            status = _uc.uc_hook_add(self._uch, _h2, htype,
+                    ffi.cast("void *", cb), hdl, begin, end)
+
+        if status != UC_ERR_OK:
+            self._hook_handles.remove(hdl)
+            raise UcError(status)
+
+        return _h2[0]
+
+
+    # delete a hook
+    def hook_del(self, h):
+        status = _uc.uc_hook_del(self._uch, h)
+        if status != UC_ERR_OK:
+            raise UcError(status)
+
+
+# print out debugging info
+def debug():
+    archs = { "arm": UC_ARCH_ARM, "arm64": UC_ARCH_ARM64, \
+        "mips": UC_ARCH_MIPS, "sparc": UC_ARCH_SPARC, \
+        "m68k": UC_ARCH_M68K, "x86": UC_ARCH_X86 }
+
+    all_archs = ""
+    keys = archs.keys()
+    for k in sorted(keys):
+        if uc_arch_supported(archs[k]):
+            all_archs += "-%s" % k
+
+    (major, minor, _combined) = uc_version()
+
+    return "python-cffi-%s-c%u.%u-b%u.%u" % (all_archs, major, minor, UC_API_MAJOR, UC_API_MINOR)
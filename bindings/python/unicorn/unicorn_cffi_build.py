@@ -0,0 +1,69 @@
+# cffi API-mode builder for the optional compiled Python backend.
+#
+# Running this script compiles unicorn/_unicorn_cffi (it needs cffi, a C
+# compiler, the unicorn headers and library):
+#
+#   python unicorn_cffi_build.py
+#
+# unicorn_cffi.py loads the compiled module, and __init__.py prefers it on
+# PyPy or when UNICORN_BACKEND=cffi is set. Without it the package falls
+# back to the pure ctypes backend transparently.
+from cffi import FFI
+
+ffibuilder = FFI()
+
+# only the subset of <unicorn/unicorn.h> the binding actually calls;
+# uc_err return values are declared as plain int
+ffibuilder.cdef("""
+typedef struct uc_struct uc_engine;
+typedef size_t uc_hook;
+
+unsigned int uc_version(unsigned int *major, unsigned int *minor);
+bool uc_arch_supported(int arch);
+int uc_open(int arch, int mode, uc_engine **uc);
+int uc_close(uc_engine *uc);
+const char *uc_strerror(int code);
+int uc_errno(uc_engine *uc);
+int uc_reg_read(uc_engine *uc, int regid, void *value);
+int uc_reg_write(uc_engine *uc, int regid, const void *value);
+int uc_reg_read_batch(uc_engine *uc, int *regs, void **vals, int count);
+int uc_reg_write_batch(uc_engine *uc, int *regs, void *const *vals, int count);
+int uc_mem_read(uc_engine *uc, uint64_t address, void *bytes, size_t size);
+int uc_mem_write(uc_engine *uc, uint64_t address, const void *bytes, size_t size);
+int uc_mem_map(uc_engine *uc, uint64_t address, size_t size, uint32_t perms);
+int uc_mem_map_ptr(uc_engine *uc, uint64_t address, size_t size, uint32_t perms, void *ptr);
+int uc_mem_unmap(uc_engine *uc, uint64_t address, size_t size);
+int uc_mem_protect(uc_engine *uc, uint64_t address, size_t size, uint32_t perms);
+int uc_mem_ptr(uc_engine *uc, uint64_t address, void **ptr, size_t *avail);
+int uc_query(uc_engine *uc, uint32_t type, size_t *result);
+int uc_emu_start(uc_engine *uc, uint64_t begin, uint64_t until, uint64_t timeout, size_t count);
+int uc_emu_stop(uc_engine *uc);
+int uc_hook_add(uc_engine *uc, uc_hook *hh, int type, void *callback, void *user_data, uint64_t begin, uint64_t end, ...);
+int uc_hook_del(uc_engine *uc, uc_hook hh);
+
+typedef struct uc_trace_record {
+    uint64_t address;
+    uint32_t type;
+    uint32_t size;
+} uc_trace_record;
+int uc_trace_enable(uc_engine *uc, int type, uc_trace_record *records, size_t capacity);
+int uc_trace_disable(uc_engine *uc);
+int uc_trace_count(uc_engine *uc, size_t *count);
+
+/* compiled trampolines: guest events enter Python through these instead
+   of ctypes closure thunks, which is the whole point of this backend */
+extern "Python" void _py_hook_code_cb(uc_engine *, uint64_t, uint32_t, void *);
+extern "Python" bool _py_hook_mem_invalid_cb(uc_engine *, int, uint64_t, int, int64_t, void *);
+extern "Python" void _py_hook_mem_access_cb(uc_engine *, int, uint64_t, int, int64_t, void *);
+extern "Python" void _py_hook_intr_cb(uc_engine *, uint32_t, void *);
+extern "Python" uint32_t _py_hook_insn_in_cb(uc_engine *, uint32_t, int, void *);
+extern "Python" void _py_hook_insn_out_cb(uc_engine *, uint32_t, int, uint32_t, void *);
+extern "Python" void _py_hook_insn_syscall_cb(uc_engine *, void *);
+""")
+
+ffibuilder.set_source("unicorn._unicorn_cffi", """
+#include <unicorn/unicorn.h>
+""", libraries=["unicorn"])
+
+if __name__ == "__main__":
+    ffibuilder.compile(verbose=True)
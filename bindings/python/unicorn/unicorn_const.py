@@ -15,6 +15,8 @@ UC_ARCH_MAX = 8
 
 UC_MODE_LITTLE_ENDIAN = 0
 UC_MODE_BIG_ENDIAN = 1073741824
+UC_MODE_BARE = 536870912
+UC_MODE_SMALL = 268435456
 
 UC_MODE_ARM = 0
 UC_MODE_THUMB = 16
@@ -78,6 +80,7 @@ UC_HOOK_MEM_FETCH_PROT = 512
 UC_HOOK_MEM_READ = 1024
 UC_HOOK_MEM_WRITE = 2048
 UC_HOOK_MEM_FETCH = 4096
+UC_HOOK_ASYNC = 1073741824
 UC_HOOK_MEM_UNMAPPED = 112
 UC_HOOK_MEM_PROT = 896
 UC_HOOK_MEM_READ_INVALID = 144
@@ -87,9 +90,39 @@ UC_HOOK_MEM_INVALID = 1008
 UC_HOOK_MEM_VALID = 7168
 UC_QUERY_MODE = 1
 UC_QUERY_PAGE_SIZE = 2
+UC_QUERY_TLB_SIZE = 3
+UC_QUERY_TCG_BUFFER_SIZE = 4
+UC_QUERY_JMP_CACHE_SIZE = 5
+UC_QUERY_TB_COUNT = 6
+UC_QUERY_TB_BUFFER_USED = 7
+UC_QUERY_TB_FLUSH_COUNT = 8
+UC_QUERY_TB_INVALIDATE_COUNT = 9
+UC_QUERY_TB_EVICT_COUNT = 10
+UC_QUERY_TB_LOOKUP_COUNT = 11
+UC_QUERY_TB_SLOW_LOOKUP_COUNT = 12
+UC_QUERY_EXEC_BLOCK_COUNT = 13
+UC_QUERY_EXEC_INSN_COUNT = 14
+UC_QUERY_TLB_FILL_COUNT = 15
+UC_QUERY_HOOK_EVENT_COUNT = 16
+UC_QUERY_MEM_API_BYTES = 17
+UC_QUERY_EMU_START_COUNT = 18
+UC_QUERY_JIT_TIME_NS = 19
+UC_QUERY_MEM_CODE_BUFFER = 20
+UC_QUERY_MEM_TB_METADATA = 21
+UC_QUERY_MEM_PAGE_TABLES = 22
+UC_QUERY_MEM_TLB = 23
+UC_QUERY_MEM_GUEST_RAM = 24
+UC_QUERY_MEM_DIRTY_BITMAPS = 25
+UC_QUERY_MEM_HOOKS = 26
+UC_ARCH_STATE_VERSION = 1
+UC_TRANSLATE_READAHEAD_MAX = 64
+UC_TRACE_COMPRESSED = 1
+UC_TRACE_FRAME_MAGIC = 1179927381
 
 UC_PROT_NONE = 0
 UC_PROT_READ = 1
 UC_PROT_WRITE = 2
 UC_PROT_EXEC = 4
 UC_PROT_ALL = 7
+UC_MEM_HUGEPAGE = 256
+UC_MEM_MERGEABLE = 512
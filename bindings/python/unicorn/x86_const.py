@@ -248,7 +248,8 @@ UC_X86_REG_IDTR = 242
 UC_X86_REG_GDTR = 243
 UC_X86_REG_LDTR = 244
 UC_X86_REG_TR = 245
-UC_X86_REG_ENDING = 246
+UC_X86_REG_XSTATE = 246
+UC_X86_REG_ENDING = 247
 
 # X86 instructions
 
@@ -1591,3 +1592,254 @@ UC_X86_INS_XTEST = 1335
 UC_X86_INS_FDISI8087_NOP = 1336
 UC_X86_INS_FENI8087_NOP = 1337
 UC_X86_INS_ENDING = 1338
+
+# Register metadata for the batch APIs: regid -> (size in bytes, class)
+# class: 0 = general, 1 = float/vector, 2 = control/system
+UC_X86_REG_META = {
+    UC_X86_REG_AH: (1, 0),
+    UC_X86_REG_AL: (1, 0),
+    UC_X86_REG_AX: (2, 0),
+    UC_X86_REG_BH: (1, 0),
+    UC_X86_REG_BL: (1, 0),
+    UC_X86_REG_BP: (2, 0),
+    UC_X86_REG_BPL: (1, 0),
+    UC_X86_REG_BX: (2, 0),
+    UC_X86_REG_CH: (1, 0),
+    UC_X86_REG_CL: (1, 0),
+    UC_X86_REG_CS: (2, 2),
+    UC_X86_REG_CX: (2, 0),
+    UC_X86_REG_DH: (1, 0),
+    UC_X86_REG_DI: (2, 0),
+    UC_X86_REG_DIL: (1, 0),
+    UC_X86_REG_DL: (1, 0),
+    UC_X86_REG_DS: (2, 2),
+    UC_X86_REG_DX: (2, 0),
+    UC_X86_REG_EAX: (4, 0),
+    UC_X86_REG_EBP: (4, 0),
+    UC_X86_REG_EBX: (4, 0),
+    UC_X86_REG_ECX: (4, 0),
+    UC_X86_REG_EDI: (4, 0),
+    UC_X86_REG_EDX: (4, 0),
+    UC_X86_REG_EFLAGS: (4, 0),
+    UC_X86_REG_EIP: (4, 0),
+    UC_X86_REG_EIZ: (4, 0),
+    UC_X86_REG_ES: (2, 2),
+    UC_X86_REG_ESI: (4, 0),
+    UC_X86_REG_ESP: (4, 0),
+    UC_X86_REG_FPSW: (2, 2),
+    UC_X86_REG_FS: (2, 2),
+    UC_X86_REG_GS: (2, 2),
+    UC_X86_REG_IP: (2, 0),
+    UC_X86_REG_RAX: (8, 0),
+    UC_X86_REG_RBP: (8, 0),
+    UC_X86_REG_RBX: (8, 0),
+    UC_X86_REG_RCX: (8, 0),
+    UC_X86_REG_RDI: (8, 0),
+    UC_X86_REG_RDX: (8, 0),
+    UC_X86_REG_RIP: (8, 0),
+    UC_X86_REG_RIZ: (8, 0),
+    UC_X86_REG_RSI: (8, 0),
+    UC_X86_REG_RSP: (8, 0),
+    UC_X86_REG_SI: (2, 0),
+    UC_X86_REG_SIL: (1, 0),
+    UC_X86_REG_SP: (2, 0),
+    UC_X86_REG_SPL: (1, 0),
+    UC_X86_REG_SS: (2, 2),
+    UC_X86_REG_CR0: (8, 2),
+    UC_X86_REG_CR1: (8, 2),
+    UC_X86_REG_CR2: (8, 2),
+    UC_X86_REG_CR3: (8, 2),
+    UC_X86_REG_CR4: (8, 2),
+    UC_X86_REG_CR5: (8, 2),
+    UC_X86_REG_CR6: (8, 2),
+    UC_X86_REG_CR7: (8, 2),
+    UC_X86_REG_CR8: (8, 2),
+    UC_X86_REG_CR9: (8, 2),
+    UC_X86_REG_CR10: (8, 2),
+    UC_X86_REG_CR11: (8, 2),
+    UC_X86_REG_CR12: (8, 2),
+    UC_X86_REG_CR13: (8, 2),
+    UC_X86_REG_CR14: (8, 2),
+    UC_X86_REG_CR15: (8, 2),
+    UC_X86_REG_DR0: (8, 2),
+    UC_X86_REG_DR1: (8, 2),
+    UC_X86_REG_DR2: (8, 2),
+    UC_X86_REG_DR3: (8, 2),
+    UC_X86_REG_DR4: (8, 2),
+    UC_X86_REG_DR5: (8, 2),
+    UC_X86_REG_DR6: (8, 2),
+    UC_X86_REG_DR7: (8, 2),
+    UC_X86_REG_DR8: (8, 2),
+    UC_X86_REG_DR9: (8, 2),
+    UC_X86_REG_DR10: (8, 2),
+    UC_X86_REG_DR11: (8, 2),
+    UC_X86_REG_DR12: (8, 2),
+    UC_X86_REG_DR13: (8, 2),
+    UC_X86_REG_DR14: (8, 2),
+    UC_X86_REG_DR15: (8, 2),
+    UC_X86_REG_FP0: (10, 1),
+    UC_X86_REG_FP1: (10, 1),
+    UC_X86_REG_FP2: (10, 1),
+    UC_X86_REG_FP3: (10, 1),
+    UC_X86_REG_FP4: (10, 1),
+    UC_X86_REG_FP5: (10, 1),
+    UC_X86_REG_FP6: (10, 1),
+    UC_X86_REG_FP7: (10, 1),
+    UC_X86_REG_K0: (8, 1),
+    UC_X86_REG_K1: (8, 1),
+    UC_X86_REG_K2: (8, 1),
+    UC_X86_REG_K3: (8, 1),
+    UC_X86_REG_K4: (8, 1),
+    UC_X86_REG_K5: (8, 1),
+    UC_X86_REG_K6: (8, 1),
+    UC_X86_REG_K7: (8, 1),
+    UC_X86_REG_MM0: (8, 1),
+    UC_X86_REG_MM1: (8, 1),
+    UC_X86_REG_MM2: (8, 1),
+    UC_X86_REG_MM3: (8, 1),
+    UC_X86_REG_MM4: (8, 1),
+    UC_X86_REG_MM5: (8, 1),
+    UC_X86_REG_MM6: (8, 1),
+    UC_X86_REG_MM7: (8, 1),
+    UC_X86_REG_R8: (8, 0),
+    UC_X86_REG_R9: (8, 0),
+    UC_X86_REG_R10: (8, 0),
+    UC_X86_REG_R11: (8, 0),
+    UC_X86_REG_R12: (8, 0),
+    UC_X86_REG_R13: (8, 0),
+    UC_X86_REG_R14: (8, 0),
+    UC_X86_REG_R15: (8, 0),
+    UC_X86_REG_ST0: (10, 1),
+    UC_X86_REG_ST1: (10, 1),
+    UC_X86_REG_ST2: (10, 1),
+    UC_X86_REG_ST3: (10, 1),
+    UC_X86_REG_ST4: (10, 1),
+    UC_X86_REG_ST5: (10, 1),
+    UC_X86_REG_ST6: (10, 1),
+    UC_X86_REG_ST7: (10, 1),
+    UC_X86_REG_XMM0: (16, 1),
+    UC_X86_REG_XMM1: (16, 1),
+    UC_X86_REG_XMM2: (16, 1),
+    UC_X86_REG_XMM3: (16, 1),
+    UC_X86_REG_XMM4: (16, 1),
+    UC_X86_REG_XMM5: (16, 1),
+    UC_X86_REG_XMM6: (16, 1),
+    UC_X86_REG_XMM7: (16, 1),
+    UC_X86_REG_XMM8: (16, 1),
+    UC_X86_REG_XMM9: (16, 1),
+    UC_X86_REG_XMM10: (16, 1),
+    UC_X86_REG_XMM11: (16, 1),
+    UC_X86_REG_XMM12: (16, 1),
+    UC_X86_REG_XMM13: (16, 1),
+    UC_X86_REG_XMM14: (16, 1),
+    UC_X86_REG_XMM15: (16, 1),
+    UC_X86_REG_XMM16: (16, 1),
+    UC_X86_REG_XMM17: (16, 1),
+    UC_X86_REG_XMM18: (16, 1),
+    UC_X86_REG_XMM19: (16, 1),
+    UC_X86_REG_XMM20: (16, 1),
+    UC_X86_REG_XMM21: (16, 1),
+    UC_X86_REG_XMM22: (16, 1),
+    UC_X86_REG_XMM23: (16, 1),
+    UC_X86_REG_XMM24: (16, 1),
+    UC_X86_REG_XMM25: (16, 1),
+    UC_X86_REG_XMM26: (16, 1),
+    UC_X86_REG_XMM27: (16, 1),
+    UC_X86_REG_XMM28: (16, 1),
+    UC_X86_REG_XMM29: (16, 1),
+    UC_X86_REG_XMM30: (16, 1),
+    UC_X86_REG_XMM31: (16, 1),
+    UC_X86_REG_YMM0: (32, 1),
+    UC_X86_REG_YMM1: (32, 1),
+    UC_X86_REG_YMM2: (32, 1),
+    UC_X86_REG_YMM3: (32, 1),
+    UC_X86_REG_YMM4: (32, 1),
+    UC_X86_REG_YMM5: (32, 1),
+    UC_X86_REG_YMM6: (32, 1),
+    UC_X86_REG_YMM7: (32, 1),
+    UC_X86_REG_YMM8: (32, 1),
+    UC_X86_REG_YMM9: (32, 1),
+    UC_X86_REG_YMM10: (32, 1),
+    UC_X86_REG_YMM11: (32, 1),
+    UC_X86_REG_YMM12: (32, 1),
+    UC_X86_REG_YMM13: (32, 1),
+    UC_X86_REG_YMM14: (32, 1),
+    UC_X86_REG_YMM15: (32, 1),
+    UC_X86_REG_YMM16: (32, 1),
+    UC_X86_REG_YMM17: (32, 1),
+    UC_X86_REG_YMM18: (32, 1),
+    UC_X86_REG_YMM19: (32, 1),
+    UC_X86_REG_YMM20: (32, 1),
+    UC_X86_REG_YMM21: (32, 1),
+    UC_X86_REG_YMM22: (32, 1),
+    UC_X86_REG_YMM23: (32, 1),
+    UC_X86_REG_YMM24: (32, 1),
+    UC_X86_REG_YMM25: (32, 1),
+    UC_X86_REG_YMM26: (32, 1),
+    UC_X86_REG_YMM27: (32, 1),
+    UC_X86_REG_YMM28: (32, 1),
+    UC_X86_REG_YMM29: (32, 1),
+    UC_X86_REG_YMM30: (32, 1),
+    UC_X86_REG_YMM31: (32, 1),
+    UC_X86_REG_ZMM0: (64, 1),
+    UC_X86_REG_ZMM1: (64, 1),
+    UC_X86_REG_ZMM2: (64, 1),
+    UC_X86_REG_ZMM3: (64, 1),
+    UC_X86_REG_ZMM4: (64, 1),
+    UC_X86_REG_ZMM5: (64, 1),
+    UC_X86_REG_ZMM6: (64, 1),
+    UC_X86_REG_ZMM7: (64, 1),
+    UC_X86_REG_ZMM8: (64, 1),
+    UC_X86_REG_ZMM9: (64, 1),
+    UC_X86_REG_ZMM10: (64, 1),
+    UC_X86_REG_ZMM11: (64, 1),
+    UC_X86_REG_ZMM12: (64, 1),
+    UC_X86_REG_ZMM13: (64, 1),
+    UC_X86_REG_ZMM14: (64, 1),
+    UC_X86_REG_ZMM15: (64, 1),
+    UC_X86_REG_ZMM16: (64, 1),
+    UC_X86_REG_ZMM17: (64, 1),
+    UC_X86_REG_ZMM18: (64, 1),
+    UC_X86_REG_ZMM19: (64, 1),
+    UC_X86_REG_ZMM20: (64, 1),
+    UC_X86_REG_ZMM21: (64, 1),
+    UC_X86_REG_ZMM22: (64, 1),
+    UC_X86_REG_ZMM23: (64, 1),
+    UC_X86_REG_ZMM24: (64, 1),
+    UC_X86_REG_ZMM25: (64, 1),
+    UC_X86_REG_ZMM26: (64, 1),
+    UC_X86_REG_ZMM27: (64, 1),
+    UC_X86_REG_ZMM28: (64, 1),
+    UC_X86_REG_ZMM29: (64, 1),
+    UC_X86_REG_ZMM30: (64, 1),
+    UC_X86_REG_ZMM31: (64, 1),
+    UC_X86_REG_R8B: (1, 0),
+    UC_X86_REG_R9B: (1, 0),
+    UC_X86_REG_R10B: (1, 0),
+    UC_X86_REG_R11B: (1, 0),
+    UC_X86_REG_R12B: (1, 0),
+    UC_X86_REG_R13B: (1, 0),
+    UC_X86_REG_R14B: (1, 0),
+    UC_X86_REG_R15B: (1, 0),
+    UC_X86_REG_R8D: (4, 0),
+    UC_X86_REG_R9D: (4, 0),
+    UC_X86_REG_R10D: (4, 0),
+    UC_X86_REG_R11D: (4, 0),
+    UC_X86_REG_R12D: (4, 0),
+    UC_X86_REG_R13D: (4, 0),
+    UC_X86_REG_R14D: (4, 0),
+    UC_X86_REG_R15D: (4, 0),
+    UC_X86_REG_R8W: (2, 0),
+    UC_X86_REG_R9W: (2, 0),
+    UC_X86_REG_R10W: (2, 0),
+    UC_X86_REG_R11W: (2, 0),
+    UC_X86_REG_R12W: (2, 0),
+    UC_X86_REG_R13W: (2, 0),
+    UC_X86_REG_R14W: (2, 0),
+    UC_X86_REG_R15W: (2, 0),
+    UC_X86_REG_IDTR: (24, 2),
+    UC_X86_REG_GDTR: (24, 2),
+    UC_X86_REG_LDTR: (24, 2),
+    UC_X86_REG_TR: (24, 2),
+    UC_X86_REG_XSTATE: (768, 1),
+}
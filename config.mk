@@ -16,6 +16,35 @@ UNICORN_DEBUG ?= yes
 UNICORN_ARCHS ?= x86 m68k arm aarch64 mips sparc
 
 
+################################################################################
+# Change 'UNICORN_NO_SMM_SVM = yes' to compile out the x86 System Management
+# Mode and Secure Virtual Machine (AMD-V) helpers. User-level emulation never
+# reaches either; dropping them shrinks the library and the translator's
+# working set for memory-constrained deployments.
+
+UNICORN_NO_SMM_SVM ?= no
+
+
+################################################################################
+# Change 'UNICORN_NO_LOG = yes' to compile out the qemu logging calls
+# (qemu_log, qemu_log_mask and friends). Even when disabled at runtime each
+# call site costs a load+test+branch in the translators and executor and
+# keeps its format string in the binary; release builds that never enable
+# qemu logging can drop all of it.
+
+UNICORN_NO_LOG ?= no
+
+
+################################################################################
+# Change 'UNICORN_PLUGINS = yes' to build every enabled arch as its own
+# shared object (libunicorn-<target>.so) that is dlopen()ed on the first
+# uc_open() of that arch. The core library stays small and single-arch
+# consumers never map the other translators. Linux/BSD only; the static
+# library is unaffected and keeps all archs linked in.
+
+UNICORN_PLUGINS ?= no
+
+
 ################################################################################
 # Change 'UNICORN_STATIC = yes' to 'UNICORN_STATIC = no' to avoid building
 # a static library.
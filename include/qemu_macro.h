@@ -7,7 +7,10 @@
 #define CPU_FOREACH(cpu) QTAILQ_FOREACH(cpu, &uc->cpus, node)
 #define CPU_FOREACH_SAFE(cpu, next_cpu) \
     QTAILQ_FOREACH_SAFE(cpu, &cpu->uc->cpus, node, next_cpu)
-#define first_cpu QTAILQ_FIRST(&uc->cpus)
+// the vCPU addressed by the register, context and arch-state APIs: the one
+// picked by uc_vcpu_select() when set, the queue head otherwise.  Scheduling
+// code must iterate the queue itself instead of starting here.
+#define first_cpu (uc->cpu_sel ? uc->cpu_sel : QTAILQ_FIRST(&uc->cpus))
 
 #endif
 
@@ -9,19 +9,23 @@
 
 #include "qemu.h"
 #include "unicorn/unicorn.h"
-#include "list.h"
 
 // These are masks of supported modes for each cpu/arch.
 // They should be updated when changes are made to the uc_mode enum typedef.
-#define UC_MODE_ARM_MASK    (UC_MODE_ARM|UC_MODE_THUMB|UC_MODE_LITTLE_ENDIAN)
-#define UC_MODE_MIPS_MASK   (UC_MODE_MIPS32|UC_MODE_MIPS64|UC_MODE_LITTLE_ENDIAN|UC_MODE_BIG_ENDIAN)
-#define UC_MODE_X86_MASK    (UC_MODE_16|UC_MODE_32|UC_MODE_64|UC_MODE_LITTLE_ENDIAN)
-#define UC_MODE_PPC_MASK    (UC_MODE_PPC64|UC_MODE_BIG_ENDIAN)
-#define UC_MODE_SPARC_MASK  (UC_MODE_SPARC32|UC_MODE_SPARC64|UC_MODE_BIG_ENDIAN)
-#define UC_MODE_M68K_MASK   (UC_MODE_BIG_ENDIAN)
+// UC_MODE_SMALL only trims per-instance caches and is valid everywhere.
+#define UC_MODE_ARM_MASK    (UC_MODE_ARM|UC_MODE_THUMB|UC_MODE_LITTLE_ENDIAN|UC_MODE_SMALL)
+#define UC_MODE_MIPS_MASK   (UC_MODE_MIPS32|UC_MODE_MIPS64|UC_MODE_LITTLE_ENDIAN|UC_MODE_BIG_ENDIAN|UC_MODE_SMALL)
+#define UC_MODE_X86_MASK    (UC_MODE_16|UC_MODE_32|UC_MODE_64|UC_MODE_LITTLE_ENDIAN|UC_MODE_BARE|UC_MODE_SMALL)
+#define UC_MODE_PPC_MASK    (UC_MODE_PPC64|UC_MODE_BIG_ENDIAN|UC_MODE_SMALL)
+#define UC_MODE_SPARC_MASK  (UC_MODE_SPARC32|UC_MODE_SPARC64|UC_MODE_BIG_ENDIAN|UC_MODE_SMALL)
+#define UC_MODE_M68K_MASK   (UC_MODE_BIG_ENDIAN|UC_MODE_SMALL)
 
 #define ARR_SIZE(a) (sizeof(a)/sizeof(a[0]))
 
+// most runs a nested uc_emu_start() call from a hook callback may
+// suspend at once - see the nesting path in uc_emu_start()
+#define UC_NEST_MAX 8
+
 #define READ_QWORD(x) ((uint64)x)
 #define READ_DWORD(x) (x & 0xffffffff)
 #define READ_WORD(x) (x & 0xffff)
@@ -35,16 +39,11 @@
 
 QTAILQ_HEAD(CPUTailQ, CPUState);
 
-typedef struct ModuleEntry {
-    void (*init)(void);
-    QTAILQ_ENTRY(ModuleEntry) node;
-    module_init_type type;
-} ModuleEntry;
-
-typedef QTAILQ_HEAD(, ModuleEntry) ModuleTypeList;
-
 typedef uc_err (*query_t)(struct uc_struct *uc, uc_query_type type, size_t *result);
 
+// fill the direct CPU state view handed out by uc_arch_state_ptr()
+typedef void (*arch_state_t)(struct uc_struct *uc, uc_arch_state *state);
+
 // return 0 on success, -1 on failure
 typedef int (*reg_read_t)(struct uc_struct *uc, unsigned int regid, void *value);
 typedef int (*reg_write_t)(struct uc_struct *uc, unsigned int regid, const void *value);
@@ -60,6 +59,9 @@ typedef void (*uc_args_void_t)(void*);
 typedef void (*uc_args_uc_t)(struct uc_struct*);
 typedef int (*uc_args_int_uc_t)(struct uc_struct*);
 
+// create one more vCPU of the machine's model; 0 on success - for uc_vcpu_create()
+typedef int (*vcpu_add_t)(struct uc_struct*);
+
 typedef bool (*uc_args_tcg_enable_t)(struct uc_struct*);
 
 typedef void (*uc_minit_t)(struct uc_struct*, ram_addr_t);
@@ -68,29 +70,163 @@ typedef void (*uc_args_uc_long_t)(struct uc_struct*, unsigned long);
 
 typedef void (*uc_args_uc_u64_t)(struct uc_struct *, uint64_t addr);
 
+typedef void (*uc_args_uc_range_t)(struct uc_struct *, uint64_t start, uint64_t end);
+
 typedef MemoryRegion* (*uc_args_uc_ram_size_t)(struct uc_struct*,  ram_addr_t begin, size_t size, uint32_t perms);
 
 typedef MemoryRegion* (*uc_args_uc_ram_size_ptr_t)(struct uc_struct*,  ram_addr_t begin, size_t size, uint32_t perms, void *ptr);
 
+// wire user callbacks into the native IO dispatch path - for uc_mmio_map()
+typedef MemoryRegion* (*uc_args_uc_ram_size_io_t)(struct uc_struct*, ram_addr_t begin, size_t size, uc_cb_mmio_read_t read_cb, uc_cb_mmio_write_t write_cb, void *user_data_read, void *user_data_write);
+
 typedef void (*uc_mem_unmap_t)(struct uc_struct*, MemoryRegion *mr);
 
+typedef void (*uc_mem_decommit_t)(struct uc_struct*, MemoryRegion *mr, uint64_t addr, size_t size);
+
+// collect the written-page bits of a region slice into a caller bitmap,
+// one bit per target page starting at first_bit - for uc_mem_dirty()
+typedef void (*uc_mem_dirty_query_t)(struct uc_struct*, MemoryRegion *mr, uint64_t addr, size_t size, uint8_t *bitmap, uint64_t first_bit);
+
+typedef void (*uc_mem_dirty_reset_t)(struct uc_struct*, MemoryRegion *mr, uint64_t addr, size_t size);
+
+// change the effective TLB size; false when entries is not a power of two
+// in [1, CPU_TLB_SIZE] - for uc_tlb_resize()
+typedef bool (*uc_tlb_resize_t)(struct uc_struct*, uint32_t entries);
+
+// resize the per-pc cache of block pointers consulted before the phys
+// hash walk; false unless entries is a suitable power of two - for
+// uc_jmp_cache_resize()
+typedef bool (*uc_jmp_cache_resize_t)(struct uc_struct*, uint32_t entries);
+
+// replace the translation cache with one of the given size; false when the
+// size is out of range - for uc_tcg_buffer_resize()
+typedef bool (*uc_tcg_buffer_resize_t)(struct uc_struct*, size_t size);
+
+// serialize or restore the translated-code cache; false when the file
+// cannot be used - for uc_tb_cache_save()/uc_tb_cache_load()
+typedef bool (*uc_tb_cache_t)(struct uc_struct*, const char *path);
+
+// translate a code range ahead of execution, returning the number of
+// blocks cached for it - for uc_translate()
+typedef size_t (*uc_tb_prewarm_t)(struct uc_struct*, uint64_t addr, size_t size);
+
+// instruction boundaries of a live translated block; nonzero when no
+// translation starts at addr - for uc_tb_meta()
+typedef int (*uc_tb_meta_get_t)(struct uc_struct*, uint64_t addr,
+        uc_tb_insn *insns, uint32_t *count);
+
+// snapshot of the translation cache counters, filled by tb_stats() in
+// qemu/translate-all.c and read out through uc_query(UC_QUERY_TB_*)
+struct uc_tb_stats {
+    size_t nb_tbs;           // translated blocks currently live
+    size_t buffer_used;      // bytes of the code buffer holding them
+    size_t flush_count;      // whole-cache flushes so far
+    size_t invalidate_count; // single blocks invalidated so far
+    size_t evict_count;      // segment evictions on cache exhaustion
+};
+typedef void (*uc_tb_stats_t)(struct uc_struct*, struct uc_tb_stats *stats);
+
+// live memory footprint of the qemu side of one engine instance, filled
+// by mem_stats() in qemu/translate-all.c and read out through
+// uc_query(UC_QUERY_MEM_*); hook bookkeeping is owned by uc.c and
+// accounted there directly
+struct uc_mem_stats {
+    size_t code_buffer;   // translation cache allocation
+    size_t tb_metadata;   // TranslationBlock array and phys hash table
+    size_t page_tables;   // l1_map levels, PageDescs and code bitmaps
+    size_t tlb;           // softmmu TLB tables of every vCPU
+    size_t guest_ram;     // host memory backing mapped guest RAM blocks
+    size_t dirty_bitmaps; // dirty-memory tracking bitmaps
+};
+typedef void (*uc_mem_stats_t)(struct uc_struct*, struct uc_mem_stats *stats);
+
+// return the backing fd of the RAM block behind mr (converting it to a
+// shareable mapping first if needed), or -1 on failure - for uc_clone()
+typedef int (*uc_ram_shareable_t)(struct uc_struct*, MemoryRegion *mr);
+
+// hand ownership of the mmap'ed host memory behind mr to the engine - for uc_clone()
+typedef void (*uc_ram_set_owned_t)(struct uc_struct*, MemoryRegion *mr);
+
+// return 0 on success, -1 on failure
+typedef int (*uc_snapshot_ram_t)(struct uc_struct*, struct uc_snapshot*);
+
+typedef void (*uc_snapshot_ram_free_t)(struct uc_struct*, struct uc_snapshot*);
+
+struct uc_ckpt_delta;
+
+// capture/apply/free the dirty-page delta between two checkpoints of the
+// ring kept by uc_checkpoint_enable(); return 0 on success, -1 on failure
+typedef int (*uc_ckpt_delta_t)(struct uc_struct*, struct uc_ckpt_delta*);
+typedef int (*uc_ckpt_apply_t)(struct uc_struct*, struct uc_snapshot*, struct uc_ckpt_delta*);
+typedef void (*uc_ckpt_delta_free_t)(struct uc_struct*, struct uc_ckpt_delta*);
+
 typedef void (*uc_readonly_mem_t)(MemoryRegion *mr, bool readonly);
 
 // which interrupt should make emulation stop?
 typedef bool (*uc_args_int_t)(int intno);
 
-// some architecture redirect virtual memory to physical memory like Mips
-typedef uint64_t (*uc_mem_redirect_t)(uint64_t address);
-
 struct hook {
     int type;            // UC_HOOK_*
     int insn;            // instruction for HOOK_INSN
     int refs;            // reference count to free hook stored in multiple lists
+    bool deleted;        // marked by uc_hook_del(), reclaimed by hook_sweep()
+    bool async;          // queue events (UC_HOOK_ASYNC) instead of calling back
     uint64_t begin, end; // only trigger if PC or memory access is in this address (depends on hook type)
+    // native pre-filters, see uc_hook_set_filter(); zero means "accept all"
+    uint32_t size_mask;  // bitmask of accepted access sizes (bit n: n+1 bytes)
+    uint64_t value_mask; // only fire when (value & value_mask) == value_match
+    uint64_t value_match;
     void *callback;      // a uc_cb_* type
     void *user_data;
 };
 
+// one queued event of an asynchronous hook (UC_HOOK_ASYNC); the callback
+// and user_data are copied so delivery survives uc_hook_del()
+struct uc_async_event {
+    void *callback;
+    void *user_data;
+    int type;           // single UC_HOOK_* type that fired
+    int size;
+    uint64_t address;
+    int64_t value;      // written value (UC_HOOK_MEM_WRITE only)
+};
+
+// queue one event for the asynchronous dispatch thread (uc.c); must only
+// be called from the emulation thread, for hooks with hook->async set
+void uc_async_publish(struct uc_struct *uc, struct hook *hook, int type,
+        uint64_t address, int size, int64_t value);
+
+// one recorded nondeterministic input, see uc_record_enable(): a state
+// mutation a hook callback made through the API, or a callback stop,
+// anchored to the nth execution of the code-hook dispatch site it
+// happened under
+struct uc_rr_event {
+    uint64_t site;      // pc of the code-hook dispatch this belongs to
+    uint64_t hit;       // nth execution of site since recording started
+    uint8_t kind;       // UC_RR_REG / UC_RR_MEM / UC_RR_STOP
+    int32_t reg;        // UC_RR_REG: register id
+    uint64_t addr;      // UC_RR_MEM: guest address
+    uint32_t len;       // payload bytes
+    uint8_t *data;      // payload, owned by the log
+};
+
+#define UC_RR_REG  0    // uc_reg_write() from a callback
+#define UC_RR_MEM  1    // uc_mem_write() from a callback
+#define UC_RR_STOP 2    // uc_emu_stop() from a callback (or the timer)
+
+// size of the scratch buffer recorded register values go through; large
+// enough for the biggest register blob any arch moves in one uc_reg_write()
+// (the x86 XSTATE area). The read-back pads short registers with zeroes
+// and the log stores the value with trailing zeroes stripped.
+#define UC_RR_REG_BUF 1024
+
+// per-pc execution counter slot; open-addressed tables in uc.c count how
+// often each dispatch site ran, on both the record and the replay side
+struct uc_rr_slot {
+    uint64_t pc;
+    uint64_t hits;      // 0 means the slot is empty
+};
+
 // hook list offsets
 // mirrors the order of uc_hook_type from include/unicorn/unicorn.h
 enum uc_hook_idx {
@@ -111,48 +247,167 @@ enum uc_hook_idx {
     UC_HOOK_MAX,
 };
 
-// for loop macro to loop over hook lists
-#define HOOK_FOREACH(uc, hh, idx)                         \
-    struct list_item *cur;                                \
-    for (                                                 \
-        cur = (uc)->hook[idx##_IDX].head;                 \
-        cur != NULL && ((hh) = (struct hook *)cur->data)  \
-            /* stop excuting callbacks on stop request */ \
-            && !uc->stop_request;                         \
-        cur = cur->next)
+// flat per-type hook table: a contiguous array of hook pointers walked on
+// the hot paths, plus the envelope of all hook ranges in the table so the
+// common "no hook covers this address" case is a single comparison
+struct hook_list {
+    struct hook **items;    // contiguous, in registration order
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t begin, end;    // envelope of all [begin, end] hook ranges
+};
+
+// data watchpoint registered by uc_watch_add(). Watchpoints reuse the
+// TLB_UCHOOK page poisoning (qemu/cputlb.c): only TLB entries for pages
+// overlapping a watched range take the instrumented slow path, and the
+// precise [begin, end] overlap check happens there, so accesses to
+// unwatched pages keep the inline fast path
+struct uc_watch {
+    uint64_t begin, end;    // watched range, inclusive
+    int type;               // UC_HOOK_MEM_READ and/or UC_HOOK_MEM_WRITE
+    void *callback;         // uc_cb_hookmem_t
+    void *user_data;
+    bool used;              // slots freed by uc_watch_del() are reused
+};
+
+// for loop macro to loop over hook lists; entries marked deleted by
+// uc_hook_del() are skipped so tables can be mutated while hooks fire
+#define HOOK_FOREACH(uc, hh, idx)                                \
+    uint32_t _hook_i;                                            \
+    for (                                                        \
+        _hook_i = 0;                                             \
+        _hook_i < (uc)->hook[idx##_IDX].count                    \
+            && ((hh) = (uc)->hook[idx##_IDX].items[_hook_i])     \
+            /* stop excuting callbacks on stop request */        \
+            && !uc->stop_request;                                \
+        _hook_i++)                                               \
+        if ((hh)->deleted)                                       \
+            continue;                                            \
+        else
+
+// same, but over the per-instruction-ID tables of UC_HOOK_INSN hooks,
+// so firing one hooked instruction class never walks hooks of another
+#define HOOK_FOREACH_INSN(uc, hh, insn)                          \
+    uint32_t _hook_i;                                            \
+    for (                                                        \
+        _hook_i = 0;                                             \
+        (uint32_t)(insn) < (uc)->insn_hooks_size                 \
+            && _hook_i < (uc)->insn_hooks[insn].count            \
+            && ((hh) = (uc)->insn_hooks[insn].items[_hook_i])    \
+            && !uc->stop_request;                                \
+        _hook_i++)                                               \
+        if ((hh)->deleted)                                       \
+            continue;                                            \
+        else
 
 // if statement to check hook bounds
 #define HOOK_BOUND_CHECK(hh, addr)                  \
     ((((addr) >= (hh)->begin && (addr) <= (hh)->end) \
          || (hh)->begin > (hh)->end))
 
-#define HOOK_EXISTS(uc, idx) ((uc)->hook[idx##_IDX].head != NULL)
-#define HOOK_EXISTS_BOUNDED(uc, idx, addr) _hook_exists_bounded((uc)->hook[idx##_IDX].head, addr)
+// native pre-filters (uc_hook_set_filter()), evaluated before a callback
+// is invoked; a zero mask accepts everything
+#define HOOK_FILTER_SIZE(hh, size)                  \
+    ((hh)->size_mask == 0                           \
+        || ((size) > 0 && (size) <= 32              \
+            && ((hh)->size_mask & (1u << ((size) - 1)))))
+#define HOOK_FILTER_VALUE(hh, val)                  \
+    ((hh)->value_mask == 0                          \
+        || (((uint64_t)(val) & (hh)->value_mask) == (hh)->value_match))
+
+// true when binary trace mode (uc_trace_enable()) captures this hook type;
+// traced types must emit instrumentation regardless of registered hooks
+#define HOOK_TRACED(uc, idx) \
+    ((uc)->trace_records != NULL && ((uc)->trace_type & (idx)))
+
+#define HOOK_EXISTS(uc, idx) \
+    ((uc)->hook[idx##_IDX].count != 0 || HOOK_TRACED(uc, idx))
+#define HOOK_EXISTS_BOUNDED(uc, idx, addr) \
+    (_hook_exists_bounded(&(uc)->hook[idx##_IDX], addr) || HOOK_TRACED(uc, idx))
+#define HOOK_EXISTS_RANGE(uc, idx, start, last) \
+    (_hook_exists_range(&(uc)->hook[idx##_IDX], start, last) || HOOK_TRACED(uc, idx))
+
+static inline bool _hook_exists_bounded(struct hook_list *l, uint64_t addr)
+{
+    uint32_t i;
+
+    // fast rejection: nothing in this table covers addr
+    if (l->count == 0 || addr < l->begin || addr > l->end)
+        return false;
+
+    for (i = 0; i < l->count; i++) {
+        if (!l->items[i]->deleted && HOOK_BOUND_CHECK(l->items[i], addr))
+            return true;
+    }
+    return false;
+}
+
+// exactly one active hook in this table covering addr, or NULL: with two
+// or more matches the caller must keep the generic table walk to preserve
+// registration order
+static inline struct hook *_hook_single_bounded(struct hook_list *l, uint64_t addr)
+{
+    struct hook *match = NULL;
+    uint32_t i;
+
+    for (i = 0; i < l->count; i++) {
+        if (l->items[i]->deleted || !HOOK_BOUND_CHECK(l->items[i], addr))
+            continue;
+        if (match != NULL)
+            return NULL;
+        match = l->items[i];
+    }
+    return match;
+}
 
-static inline bool _hook_exists_bounded(struct list_item *cur, uint64_t addr)
+// translation-time resolution for UC_HOOK_INSN: when exactly one active
+// hook covers @addr for instruction ID @insn, the translator may emit a
+// direct call to its callback (with user_data baked in as a constant)
+// instead of the generic table-walking helper. TBs generated this way are
+// dropped when the insn hook table changes, see uc_hook_add()/uc_hook_del()
+#define HOOK_INSN_SINGLE(uc, insn, addr)                         \
+    ((uint32_t)(insn) < (uc)->insn_hooks_size                    \
+        ? _hook_single_bounded(&(uc)->insn_hooks[insn], addr)    \
+        : NULL)
+
+// does any hook in this table intersect [start, last]?
+static inline bool _hook_exists_range(struct hook_list *l, uint64_t start, uint64_t last)
 {
-    while (cur != NULL) {
-        if (HOOK_BOUND_CHECK((struct hook *)cur->data, addr))
+    uint32_t i;
+
+    // fast rejection: nothing in this table overlaps the range
+    if (l->count == 0 || last < l->begin || start > l->end)
+        return false;
+
+    for (i = 0; i < l->count; i++) {
+        struct hook *hook = l->items[i];
+        if (hook->deleted)
+            continue;
+        // catch-all hook, or [begin, end] overlaps [start, last]
+        if (hook->begin > hook->end
+                || (hook->begin <= last && hook->end >= start))
             return true;
-        cur = cur->next;
     }
     return false;
 }
 
-//relloc increment, KEEP THIS A POWER OF 2!
+// initial capacity of the mapped_blocks array; it doubles when full
 #define MEM_BLOCK_INCR 32
 
+// largest uc_mem_xlat() table that will be materialized, in entries; the
+// table is a straight array spanning lowest to highest mapped page, so a
+// very sparse layout could otherwise demand an absurd allocation
+#define MEM_XLAT_MAX_PAGES (1u << 24)
+
 struct uc_struct {
     uc_arch arch;
     uc_mode mode;
-    QemuMutex qemu_global_mutex; // qemu/cpus.c
-    QemuCond qemu_cpu_cond; // qemu/cpus.c
     QemuThread *tcg_cpu_thread; // qemu/cpus.c
-    QemuCond *tcg_halt_cond; // qemu/cpus.c
     struct CPUTailQ cpus;   // qemu/cpu-exec.c
     uc_err errnum;  // qemu/cpu-exec.c
     AddressSpace as;
     query_t query;
+    arch_state_t arch_state;    // NULL when the arch has no direct state view
     reg_read_t reg_read;
     reg_write_t reg_write;
     reg_reset_t reg_reset;
@@ -169,9 +424,56 @@ struct uc_struct {
     uc_args_uc_long_t tcg_exec_init;
     uc_args_uc_ram_size_t memory_map;
     uc_args_uc_ram_size_ptr_t memory_map_ptr;
+    uc_args_uc_ram_size_io_t memory_map_io;
     uc_mem_unmap_t memory_unmap;
+    uc_mem_decommit_t memory_decommit;
+    uc_mem_dirty_query_t memory_dirty_query;
+    uc_mem_dirty_reset_t memory_dirty_reset;
+    uc_snapshot_ram_t memory_snapshot, memory_restore;
+    uc_snapshot_ram_free_t memory_snapshot_free;
+    uc_ckpt_delta_t memory_ckpt_delta;
+    uc_ckpt_apply_t memory_ckpt_apply;
+    uc_ckpt_delta_free_t memory_ckpt_delta_free;
+    uc_ram_shareable_t ram_make_shareable;
+    uc_ram_set_owned_t ram_set_owned;
     uc_readonly_mem_t readonly_mem;
-    uc_mem_redirect_t mem_redirect;
+    uc_args_uc_t tlb_flush;     // drop cached TLB_UCHOOK flags when memory hooks change
+    uc_args_uc_range_t tlb_flush_range; // evict only TLB entries in an address range
+    uc_tlb_resize_t tlb_resize;
+    uc_jmp_cache_resize_t jmp_cache_resize;
+    uc_tcg_buffer_resize_t tcg_buffer_resize;
+    uc_tb_cache_t tb_cache_save;
+    uc_tb_cache_t tb_cache_load;
+    uc_tb_prewarm_t tb_prewarm;
+    uc_tb_meta_get_t tb_meta_get; // instruction boundaries for uc_tb_meta()
+    // speculative blocks to translate after each translation miss, see
+    // uc_translate_readahead() and tb_readahead() (0: disabled)
+    uint32_t tb_readahead;
+    uc_tb_stats_t tb_stats; // translation cache counters for uc_query()
+    uc_mem_stats_t mem_stats; // live memory footprint for uc_query()
+    // block lookups done and how many of them missed the fast per-pc
+    // cache, counted in tb_find_fast()/tb_find_slow() (qemu/cpu-exec.c);
+    // their ratio tells whether the jump cache and chaining are working
+    uint64_t tb_lookup_count;
+    uint64_t tb_slow_lookup_count;
+    // performance counters surfaced by uc_query(); all maintained on paths
+    // that already leave the generated code, so keeping them costs nothing
+    // measurable (see the UC_QUERY_* doc in unicorn.h for their meaning)
+    uint64_t exec_block_count;  // block dispatches from the exec loop
+    uint64_t exec_insn_count;   // instructions in the dispatched blocks
+    uint64_t tlb_fill_count;    // softmmu TLB fills (tlb_set_page)
+    uint64_t hook_event_count;  // hook callbacks/trace events fired
+    uint64_t mem_api_bytes;     // bytes moved by uc_mem_read/uc_mem_write
+    uint64_t emu_start_count;   // uc_emu_start() calls
+    uint64_t jit_time_ns;       // cumulative time inside tb_gen_code()
+    uc_args_uc_range_t tb_invalidate_range; // drop TBs translated from an address range
+    // drop TBs whose guest pc range intersects [begin, end] (inclusive);
+    // keyed on virtual pcs like the translators' hook checks, see
+    // uc_hook_add()/uc_hook_del()
+    uc_args_uc_range_t tb_invalidate_pc_range;
+    uc_args_uc_t page_tree_reclaim; // free empty l1_map subtrees after unmaps
+    // batch mapping changes into one flatview rebuild (memory.c transactions)
+    uc_args_uc_t memory_batch_begin, memory_batch_commit;
     // list of cpu
     void* cpu;
 
@@ -196,31 +498,69 @@ struct uc_struct {
     unsigned memory_region_transaction_depth;
     bool memory_region_update_pending;
     bool ioeventfd_update_pending;
+    // when the only topology change since the last commit was adding this
+    // one region, the FlatView is patched in place instead of re-rendered
+    MemoryRegion *flat_add_pending;
+    bool flat_full_pending;
     QemuMutex flat_view_mutex;
     QTAILQ_HEAD(memory_listeners, MemoryListener) memory_listeners;
     QTAILQ_HEAD(, AddressSpace) address_spaces;
     // qom/object.c
     GHashTable *type_table;
+    // type_table points at the process-global graph published by an earlier
+    // instance of this arch variant; shared graphs are immutable and are
+    // never destroyed in uc_close() (see type_table_attach())
+    bool type_table_shared;
     Type type_interface;
     Object *root;
     bool enumerating_types;
-    // util/module.c
-    ModuleTypeList init_type_list[MODULE_INIT_MAX];
     // hw/intc/apic_common.c
-    DeviceState *vapic;
     int apic_no;
     bool mmio_registered;
-    bool apic_report_tpr_access;
+    // Fixed-function interrupt controller for X86: hook callbacks latch at
+    // most one pending vector here; -1 when nothing is pending.  Replaces
+    // the APIC/PIC device walk on the CPU_INTERRUPT_HARD acceptance path
+    // (target-i386/seg_helper.c, x86_cpu_exec_interrupt()).
+    int32_t x86_hard_vector;
     CPUState *current_cpu;
 
-    // linked lists containing hooks per type
-    struct list hook[UC_HOOK_MAX];
-
-    // hook to count number of instructions for uc_emu_start()
-    uc_hook count_hook;
-
-    size_t emu_counter; // current counter of uc_emu_start()
-    size_t emu_count; // save counter of uc_emu_start()
+    // flat tables containing hooks per type
+    struct hook_list hook[UC_HOOK_MAX];
+    // UC_HOOK_INSN hooks also indexed by instruction ID for direct
+    // dispatch; grown on demand by uc_hook_add()
+    struct hook_list *insn_hooks;
+    uint32_t insn_hooks_size;
+    bool hook_dirty;    // deleted hooks pending compaction by hook_sweep()
+
+    // data watchpoints (uc_watch_add()); watch_count counts slots, not
+    // active entries - freed slots stay allocated and are reused
+    struct uc_watch *watch;
+    uint32_t watch_count;
+
+    // custom allocator for the engine-frontend allocations (hooks, hook
+    // tables, mapping index, ...), see uc_set_allocator(); NULL = libc
+    void *(*mem_alloc)(void *opaque, size_t size);
+    void (*mem_release)(void *opaque, void *ptr);
+    void *mem_opaque;
+    // outstanding allocations made through the allocator; it can only be
+    // (re)configured while this is zero
+    size_t alloc_count;
+
+    size_t emu_count; // instruction count budget of uc_emu_start() (0: unlimited)
+
+    // multi-vCPU support, see uc_vcpu_create(): all vCPUs run round-robin
+    // on the emulating thread, one quantum-sized slice per turn
+    vcpu_add_t vcpu_add;    // create one more vCPU of the machine's model
+    struct CPUState *cpu_sel;   // vCPU addressed by the register and context
+                                // APIs; NULL = queue head (see first_cpu)
+    int vcpu_count;         // vCPUs created so far
+    uint32_t vcpu_quantum;  // instructions per scheduling slice
+    size_t emu_count_left;  // budget remaining across all slices of a run
+    bool vcpu_yield;        // slice expired: leave the TB cache intact and
+                            // hand the thread to the next vCPU
+    bool tb_pruned;         // a hook change already dropped the affected TBs
+                            // surgically; skip the full flush on the next
+                            // quit-and-continue out of cpu_exec()
 
     uint64_t block_addr;    // save the last block address we hooked
 
@@ -228,24 +568,353 @@ struct uc_struct {
     bool stop_request;  // request to immediately stop emulation - for uc_emu_stop()
     bool quit_request;  // request to quit the current TB, but continue to emulate - for uc_mem_protect()
     bool emulation_done;  // emulation is done by uc_emu_start()
-    QemuThread timer;   // timer for emulation timeout
-    uint64_t timeout;   // timeout for uc_emu_start()
+    int64_t deadline;   // stop emulation when get_clock() passes this (0 = no
+                        // timeout); enforced by the timer thread, see timer_worker()
+    // uc_emu_start() timeout is a retired-instruction budget instead of
+    // microseconds, see uc_icount_timeout()
+    bool timeout_icount;
 
     uint64_t invalid_addr;  // invalid address to be accessed
     int invalid_error;  // invalid memory code: 1 = READ, 2 = WRITE, 3 = CODE
 
     uint64_t addr_end;  // address where emulation stops (@end param of uc_emu_start())
 
+    // bounded reentrancy: uc_emu_start() called from a hook callback
+    // suspends the outer run on the C stack (see the nesting path in
+    // uc_emu_start()).  nest_ra keeps, per suspended run, the host return
+    // address into the generated code it will resume into, so that
+    // tb_seg_rotate() leaves those segments out of the eviction rotation.
+    int nest_depth;
+    uintptr_t nest_ra[UC_NEST_MAX];
+    // return address into generated code, captured when a helper starts
+    // dispatching hooks (helper_uc_tracecode(), softmmu_template.h); this
+    // is what nest_ra[] is seeded from
+    uintptr_t hook_ra;
+
     int thumb;  // thumb mode for ARM
     // full TCG cache leads to middle-block break in the last translation?
     bool block_full;
     MemoryRegion **mapped_blocks;
     uint32_t mapped_block_count;
-    uint32_t mapped_block_cache_index;
-    void *qemu_thread_data; // to support cross compile to Windows (qemu-thread-win32.c)
+    uint32_t mapped_block_capacity;
+    // bumped on every mapping topology change (mem_map()/memory_unmap());
+    // consumers detect staleness by comparing against it
+    uint32_t mem_generation;
+    // cached guest-page -> host-pointer table handed out by uc_mem_xlat();
+    // rebuilt lazily when mem_generation moved on
+    void **xlat_pages;
+    uint64_t xlat_base;
+    uint64_t xlat_count;
+    uint32_t xlat_generation;
+    bool xlat_valid;
     uint32_t target_page_size;
     uint32_t target_page_align;
+    // effective softmmu TLB size for this instance: a power of two up to
+    // the compile-time CPU_TLB_SIZE, set via uc_tlb_resize(). Fewer
+    // entries make every tlb_flush() cheaper for small working sets.
+    uint32_t tlb_entries;
+    // log2 of the effective jump cache size, set via uc_jmp_cache_resize():
+    // guests with a large hot code footprint want a bigger cache, small
+    // guests a cheaper flush
+    uint32_t jmp_cache_bits;
+    // effective translation-cache size in bytes, kept here for uc_query()
+    size_t tcg_buffer_size;
     uint64_t next_pc;   // save next PC for some special cases
+    size_t cpu_context_size;    // size of CPU context that uc_context_save() snapshots
+
+    // binary trace mode, see uc_trace_enable()
+    uc_trace_record *trace_records; // user-owned ring buffer (NULL: disabled)
+    size_t trace_capacity;          // number of entries in trace_records
+    size_t trace_head;              // total records produced; writes wrap at capacity
+    uint32_t trace_type;            // mask of traced UC_HOOK_* types
+
+    // streaming trace mode, see uc_trace_stream(): the same producers fill
+    // trace_records, but the ring is engine-owned and drained losslessly
+    // to a file descriptor by trace_writer() in uc.c
+    bool trace_stream;          // producers wait for space instead of wrapping
+    bool trace_stream_running;  // cleared by teardown to stop the writer
+    bool trace_compress;        // wrap batches in compressed uc_trace_frame
+                                // frames, see uc_trace_compress()
+    int trace_fd;               // descriptor the writer appends to
+    size_t trace_tail;          // next record the writer will drain
+    QemuThread trace_thread;
+    QemuSemaphore trace_avail;  // the writer naps on this between batches
+    QemuSemaphore trace_space;  // posted by the writer after draining a full
+                                // ring; wakes a waiting producer
+
+    // bounded queue feeding the asynchronous hook dispatch thread
+    // (UC_HOOK_ASYNC); filled by the emulation thread, drained by
+    // async_worker() in uc.c
+    struct uc_async_event *async_queue; // NULL: no async hook ever added
+    uint32_t async_capacity;
+    uint32_t async_head;    // next slot to fill, wraps at capacity
+    uint32_t async_tail;    // next slot to deliver
+    bool async_running;     // cleared by uc_close() to stop the thread
+    QemuThread async_thread;
+    QemuMutex async_mutex;
+    QemuCond async_avail;   // signalled when an event is queued
+    QemuCond async_space;   // signalled when a slot is freed
+
+    // recording of nondeterministic inputs, see uc_record_enable():
+    // mutations hook callbacks make through the API, anchored to
+    // (dispatch pc, execution number) positions counted in
+    // helper_uc_tracecode()
+    bool rr_recording;
+    bool rr_lost;               // a mutation arrived before any code-hook
+                                // dispatch; the log cannot anchor it
+    bool rr_have_site;          // at least one dispatch happened
+    uint64_t rr_site;           // pc of the latest code-hook dispatch
+    uint64_t rr_site_hit;       // its execution number
+    struct uc_rr_event *rr_events;
+    uint32_t rr_count, rr_capacity;
+    struct uc_rr_slot *rr_hits; // per-pc execution counts while recording
+    uint32_t rr_hits_size, rr_hits_used;
+
+    // replay of a recorded log, see uc_replay_load(): internal code hooks
+    // on the event sites re-apply the events at the recorded positions
+    struct uc_rr_event *rp_events;
+    uint32_t rp_count, rp_next;
+    uc_hook *rp_hooks;          // one internal hook per distinct site
+    uint32_t rp_hook_count;
+    struct uc_rr_slot *rp_hits; // per-site execution counts while replaying
+    uint32_t rp_hits_size, rp_hits_used;
+
+    // bounded checkpoint ring, see uc_checkpoint_enable(): an internal
+    // block hook takes an incremental checkpoint every ckpt_interval
+    // executed blocks; uc_rewind() walks back up to ckpt_count slots
+    struct uc_checkpoint *ckpt_ring;    // NULL: disabled
+    uint32_t ckpt_depth;        // ring capacity
+    uint32_t ckpt_head;         // next slot to fill, 0 .. ckpt_depth-1
+    uint32_t ckpt_count;        // valid slots, <= ckpt_depth
+    uint64_t ckpt_interval;     // blocks between checkpoints
+    uint64_t ckpt_blocks;       // blocks since the last checkpoint
+    uc_hook ckpt_hook;
+
+    // deadline timer thread: armed once per timeout run by uc_emu_start()
+    // and sleeps until the deadline in a single timed wait (no polling).
+    // Enforcing the timeout off-thread lets timeout runs keep direct TB
+    // chaining; see timer_worker() in uc.c
+    bool timer_started;         // thread created on the first timeout run
+    bool timer_exit;            // set by uc_close() before the final arm post
+    QemuThread timer_thread;
+    QemuSemaphore timer_arm;    // posted when a run with a deadline starts
+    QemuSemaphore timer_cancel; // posted when the run ends; a timed-out wait
+                                // on it means the deadline was hit
+    QemuSemaphore timer_idle;   // posted by the thread once it is disarmed
+
+    // background emulation thread for uc_emu_start_async(): emulation
+    // always executes on whichever thread enters the vCPU loop, so
+    // asynchronous runs get a per-engine worker, started on the first
+    // async run and parked between runs; see emu_worker() in uc.c
+    bool emu_worker_started;    // thread created on the first async run
+    bool emu_worker_exit;       // set by uc_close() before the final go post
+    QemuThread emu_worker_thread;
+    QemuSemaphore emu_worker_go;   // posted once per async run
+    QemuSemaphore emu_worker_idle; // posted by the worker after each run
+    volatile bool emu_async_active; // an async run is in flight
+    uc_err emu_async_err;       // result of the last async run
+    uint64_t emu_async_begin;   // parameters handed to the worker
+    uint64_t emu_async_until;
+    uint64_t emu_async_timeout;
+    size_t emu_async_count;
+    uc_cb_emu_done_t emu_async_done;    // completion callback (may be NULL)
+    void *emu_async_done_data;
+
+    // edge coverage mode, see uc_coverage_enable()
+    uint8_t *cov_bitmap;    // user-owned bitmap (NULL: disabled)
+    uint32_t cov_mask;      // bitmap size - 1 (size is a power of two)
+    uint32_t cov_prev_loc;  // previous block location hash, updated inline
+
+    // per-TB execution profiling, see uc_profile_enable()
+    bool tb_profile;                    // emit execution counters in TB prologues
+    struct tb_profile_entry *profile_table; // counts of flushed TBs (open addressing)
+    uint32_t profile_used;
+    uint32_t profile_size;              // power of two
+    uc_args_uc_t profile_flush;         // tb_profile_flush(), fold live TBs into the table
+
+    // guest-PC sampling profiler (uc_sample_enable()); the histogram is
+    // preallocated so uc_sample_record() on the dispatch hot path never
+    // allocates
+    struct pc_sample_entry *sample_table;   // NULL: sampling disabled
+    uint32_t sample_size;       // buckets, power of two
+    uint32_t sample_used;
+    uint32_t sample_interval;   // record every Nth dispatched block
+    uint32_t sample_countdown;  // blocks until the next sample
+    uint64_t sample_dropped;    // samples lost to a full histogram
+
+    // hot-block superblock formation, see uc_superblock_enable()
+    uint32_t sb_threshold;  // executions before a TB is retranslated (0: disabled)
+    bool sb_generating;     // inside tb_superblock(): follow jumps, emit no trigger
+
+    uint32_t tb_max_insns;  // cap on guest instructions per TB (0: qemu default)
+
+    FILE *perfmap;          // /tmp/perf-<pid>.map, one entry per translation
+};
+
+// one accumulated entry of the per-TB execution profile; a slot with
+// exec_count == 0 is empty
+struct tb_profile_entry {
+    uint64_t pc;
+    uint32_t icount;        // instructions in the block
+    uint32_t exec_count;
+};
+
+// one bucket of the guest-PC sample histogram (uc_sample_enable()); a
+// slot with count == 0 is empty
+struct pc_sample_entry {
+    uint64_t pc;
+    uint64_t count;
+};
+
+// land one guest-PC sample in the preallocated histogram; open addressing
+// with linear probing. Called from the block dispatch loop in
+// qemu/cpu-exec.c, so it must neither allocate nor take locks.
+static inline void uc_sample_record(struct uc_struct *uc, uint64_t pc)
+{
+    uint32_t mask = uc->sample_size - 1;
+    uint32_t i = (uint32_t)((pc >> 1) * 2654435761u) & mask;
+    uint32_t probes;
+
+    for (probes = 0; probes <= mask; probes++) {
+        struct pc_sample_entry *e = &uc->sample_table[i];
+
+        if (e->count == 0) {
+            // cap the fill at 3/4 so probe chains stay short; samples on
+            // addresses beyond that are dropped (and counted as such),
+            // existing buckets keep counting
+            if (uc->sample_used >= uc->sample_size - uc->sample_size / 4) {
+                break;
+            }
+            e->pc = pc;
+            e->count = 1;
+            uc->sample_used++;
+            return;
+        }
+        if (e->pc == pc) {
+            e->count++;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    uc->sample_dropped++;
+}
+
+// emit the inline edge coverage update for a block starting at @pc; the
+// location hash is a translate-time constant, so the generated code is just
+// the bitmap increment (see gen_uc_coverage() in tcg-op.h)
+#define UC_GEN_COVERAGE(tcg_ctx, uc, pc) do { \
+    if ((uc)->cov_bitmap != NULL) { \
+        uint32_t _cur = (uint32_t)(((pc) >> 4) ^ ((pc) << 8)) & (uc)->cov_mask; \
+        gen_uc_coverage(tcg_ctx, (uc)->cov_bitmap, &(uc)->cov_prev_loc, _cur); \
+    } \
+} while (0)
+
+// true when any active watchpoint of @type overlaps [start, last]; used
+// by tlb_set_page() to decide whether a page needs TLB_UCHOOK
+static inline bool uc_watch_exists_range(struct uc_struct *uc, int type,
+        uint64_t start, uint64_t last)
+{
+    uint32_t i;
+
+    for (i = 0; i < uc->watch_count; i++) {
+        struct uc_watch *w = &uc->watch[i];
+        if (w->used && (w->type & type)
+                && w->begin <= last && start <= w->end)
+            return true;
+    }
+
+    return false;
+}
+
+// fire the watchpoints hit by an access of @size bytes at @addr; unlike
+// hook dispatch this checks the whole accessed span, so an access that
+// merely straddles into a watched range still triggers
+static inline void uc_watch_dispatch(struct uc_struct *uc, int type,
+        uc_mem_type mtype, uint64_t addr, int size, int64_t value)
+{
+    uint32_t i;
+
+    for (i = 0; i < uc->watch_count; i++) {
+        struct uc_watch *w = &uc->watch[i];
+        if (!w->used || !(w->type & type)
+                || addr + size - 1 < w->begin || addr > w->end)
+            continue;
+        uc->hook_event_count++;
+        ((uc_cb_hookmem_t)w->callback)(uc, mtype, addr, size, value,
+                w->user_data);
+    }
+}
+
+// append one event to the binary trace ring buffer; the caller must have
+// checked HOOK_TRACED() for the event type first
+static inline void uc_trace_append(struct uc_struct *uc, uint32_t type,
+        uint64_t address, uint32_t size)
+{
+    uc_trace_record *rec;
+
+    if (uc->trace_stream) {
+        // streaming is lossless: on the (rare) full ring, stall emulation
+        // until the writer thread catches up
+        while (uc->trace_head - uc->trace_tail >= uc->trace_capacity) {
+            qemu_sem_timedwait(&uc->trace_space, 1);
+        }
+    }
+
+    rec = &uc->trace_records[uc->trace_head % uc->trace_capacity];
+    rec->address = address;
+    rec->type = type;
+    rec->size = size;
+    if (uc->trace_stream) {
+        // the writer thread must see the record before the advanced head
+        smp_wmb();
+    }
+    uc->trace_head++;
+}
+
+// One saved RAM block of a uc_snapshot().
+struct snapshot_block {
+    ram_addr_t offset;  // offset of the block in the ram_list address space
+    size_t length;
+    uint8_t *data;      // copy of the block contents at snapshot time
+};
+
+// Full VM snapshot taken by uc_snapshot(): CPU state plus the contents of
+// all RAM blocks. uc_restore() copies back only the pages that were dirtied
+// since the snapshot was taken (tracked via DIRTY_MEMORY_MIGRATION).
+struct uc_snapshot {
+    uc_context *context;            // saved CPU state
+    struct snapshot_block *blocks;  // saved RAM contents
+    uint32_t block_count;
+};
+
+// Pages dirtied between two checkpoints of the ring kept by
+// uc_checkpoint_enable(): one bitmap per RAM block, captured from the
+// DIRTY_MEMORY_MIGRATION client just before the newer checkpoint resets it.
+struct ckpt_delta_block {
+    ram_addr_t offset;      // offset of the block in the ram_list address space
+    size_t length;
+    unsigned long *bits;    // one bit per target page, LSB first
+};
+
+struct uc_ckpt_delta {
+    struct ckpt_delta_block *blocks;
+    uint32_t block_count;
+};
+
+// One slot of the checkpoint ring: the full snapshot plus the pages
+// dirtied since the previous slot. uc_rewind() uses the delta to step
+// past this checkpoint towards an older one.
+struct uc_checkpoint {
+    struct uc_snapshot *snap;
+    struct uc_ckpt_delta *delta;
+};
+
+// Opaque storage for a saved copy of CPUArchState, see uc_context_save().
+// Only the leading cpu_context_size bytes of the CPU state are snapshotted;
+// the TLB tables and other fields behind CPU_COMMON are left alone.
+struct uc_context {
+    size_t size;
+    char data[0];
 };
 
 #include "qemu_macro.h"
@@ -253,4 +922,14 @@ struct uc_struct {
 // check if this address is mapped in (via uc_mem_map())
 MemoryRegion *memory_mapping(struct uc_struct* uc, uint64_t address);
 
+// effective permissions at @addr: the per-page table installed by
+// uc_mem_protect() overrides the region-wide perms when present
+static inline uint32_t memory_perms(MemoryRegion *mr, uint64_t addr)
+{
+    if (mr->page_perms == NULL)
+        return mr->perms;
+
+    return mr->page_perms[(addr - mr->addr) / mr->uc->target_page_size];
+}
+
 #endif
@@ -0,0 +1,50 @@
+// Unicorn Engine
+// Static (USDT/SystemTap) tracepoints on engine hot paths.
+//
+// When <sys/sdt.h> is available the macros below emit dtrace-style
+// probes under the "unicorn" provider: a single nop in the instruction
+// stream plus an ELF note, so they cost nothing until a tracer such as
+// bpftrace or perf attaches to them, e.g.
+//
+//     bpftrace -e 'usdt:./libunicorn.so:unicorn:tb_flush { @[ustack] = count(); }'
+//
+// Probes (arguments):
+//     emu_start(begin, until)     emu_stop()
+//     tb_gen_entry(pc)            tb_gen_exit(pc, size)
+//     tb_flush(code_bytes)        tlb_flush(flush_global)
+//     tb_find_slow(pc)
+//     hook_dispatch(type, address, size)
+//     mem_map(address, size, perms)
+//     mem_unmap(address, size)
+//     mem_protect(address, size, perms)
+//
+// Without <sys/sdt.h> everything compiles to nothing.
+
+#ifndef UC_PROBE_H
+#define UC_PROBE_H
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define UC_HAVE_SDT 1
+#endif
+#endif
+
+#ifdef UC_HAVE_SDT
+
+#include <sys/sdt.h>
+
+#define UC_PROBE0(name)             DTRACE_PROBE(unicorn, name)
+#define UC_PROBE1(name, a)          DTRACE_PROBE1(unicorn, name, a)
+#define UC_PROBE2(name, a, b)       DTRACE_PROBE2(unicorn, name, a, b)
+#define UC_PROBE3(name, a, b, c)    DTRACE_PROBE3(unicorn, name, a, b, c)
+
+#else
+
+#define UC_PROBE0(name)             do { } while (0)
+#define UC_PROBE1(name, a)          do { } while (0)
+#define UC_PROBE2(name, a, b)       do { } while (0)
+#define UC_PROBE3(name, a, b, c)    do { } while (0)
+
+#endif
+
+#endif
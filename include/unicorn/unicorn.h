@@ -24,6 +24,10 @@ typedef struct uc_struct uc_engine;
 
 typedef size_t uc_hook;
 
+typedef struct uc_context uc_context;
+
+struct uc_snapshot;
+
 #include "m68k.h"
 #include "x86.h"
 #include "arm.h"
@@ -88,6 +92,14 @@ typedef enum uc_arch {
 typedef enum uc_mode {
     UC_MODE_LITTLE_ENDIAN = 0,    // little-endian mode (default mode)
     UC_MODE_BIG_ENDIAN = 1 << 30, // big-endian mode
+    UC_MODE_BARE = 1 << 29,       // bare-machine profile: CPU + memory + TCG only,
+                                  // no device/interrupt-controller emulation
+                                  // (currently x86 only: skips the APIC)
+    UC_MODE_SMALL = 1 << 28,      // small-footprint profile for running thousands of
+                                  // concurrent instances: 512KB translation cache
+                                  // (instead of 32MB) plus small TLB and jump cache;
+                                  // right for snippet-sized emulations, wrong for
+                                  // guests with a big hot code footprint
     // arm / arm64
     UC_MODE_ARM = 0,              // ARM mode
     UC_MODE_THUMB = 1 << 4,       // THUMB mode (including Thumb-2)
@@ -204,6 +216,14 @@ typedef enum uc_hook_type {
     UC_HOOK_MEM_READ = 1 << 10,   // Hook memory read events.
     UC_HOOK_MEM_WRITE = 1 << 11,  // Hook memory write events.
     UC_HOOK_MEM_FETCH = 1 << 12,  // Hook memory fetch for execution events
+    // Modifier flag: queue events for delivery on a dispatch thread instead
+    // of calling back synchronously from the emulation thread, so slow (e.g.
+    // logging) callbacks do not stall emulation. Can only be combined with
+    // UC_HOOK_CODE, UC_HOOK_BLOCK, UC_HOOK_MEM_READ & UC_HOOK_MEM_WRITE.
+    // Asynchronous callbacks must not modify emulation state, and may still
+    // be invoked shortly after uc_hook_del() returns; uc_emu_start() only
+    // returns once all events of the run are delivered.
+    UC_HOOK_ASYNC = 1 << 30,
 } uc_hook_type;
 
 // hook type for all events of unmapped memory access
@@ -248,6 +268,117 @@ typedef void (*uc_cb_hookmem_t)(uc_engine *uc, uc_mem_type type,
 typedef bool (*uc_cb_eventmem_t)(uc_engine *uc, uc_mem_type type,
         uint64_t address, int size, int64_t value, void *user_data);
 
+/*
+  Callback function for reading from an MMIO region mapped by uc_mmio_map()
+
+  @offset: offset of the access relative to the start of the region
+  @size: size of data being read, in bytes
+  @user_data: user data passed to uc_mmio_map()
+
+  @return: the value read from the emulated device register.
+*/
+typedef uint64_t (*uc_cb_mmio_read_t)(uc_engine *uc, uint64_t offset,
+        unsigned size, void *user_data);
+
+/*
+  Callback function for writing to an MMIO region mapped by uc_mmio_map()
+
+  @offset: offset of the access relative to the start of the region
+  @size: size of data being written, in bytes
+  @value: value of data being written to the emulated device register
+  @user_data: user data passed to uc_mmio_map()
+*/
+typedef void (*uc_cb_mmio_write_t)(uc_engine *uc, uint64_t offset,
+        unsigned size, uint64_t value, void *user_data);
+
+/*
+  Callback for allocating memory on behalf of the engine, registered with
+  uc_set_allocator()
+
+  @opaque: user data passed to uc_set_allocator()
+  @size: number of bytes to allocate
+
+  @return pointer to the allocation, or NULL when out of memory
+*/
+typedef void *(*uc_cb_alloc_t)(void *opaque, size_t size);
+
+/*
+  Callback for releasing memory obtained from a uc_cb_alloc_t callback
+
+  @opaque: user data passed to uc_set_allocator()
+  @ptr: pointer previously returned by the alloc callback; never NULL
+*/
+typedef void (*uc_cb_release_t)(void *opaque, void *ptr);
+
+/*
+  Callback placing the next input into the guest before an iteration of
+  uc_fuzz_loop(), typically with uc_mem_write() (or through pointers from
+  uc_mem_xlat()) plus uc_reg_write()
+
+  @uc: engine running the loop
+  @iteration: iteration about to run, counted from 0
+  @user_data: user data passed to uc_fuzz_loop()
+
+  @return true to run this iteration, false to end the loop (e.g. the
+    input source is exhausted)
+*/
+typedef bool (*uc_cb_place_input_t)(uc_engine *uc, uint64_t iteration,
+        void *user_data);
+
+// Opaque handle to an engine pool (see uc_pool_create())
+typedef struct uc_pool uc_pool;
+
+/*
+  Callback preparing a pool worker for one job, called on the worker
+  thread before the run: write the job's input and registers here,
+  typically with uc_mem_write() plus uc_reg_write(). Whatever it changes
+  is rolled back after the job.
+
+  @uc: the worker engine about to run the job
+  @job_data: the job_data field of the submitted uc_pool_job
+
+  @return true to run the job, false to fail it (its result is delivered
+    with UC_ERR_ARG and nothing is executed)
+*/
+typedef bool (*uc_cb_pool_setup_t)(uc_engine *uc, void *job_data);
+
+/*
+  Callback delivering the outcome of one pool job, called on the worker
+  thread after the run but before the worker is rolled back, so outputs
+  can still be read from the worker engine (uc_mem_read(), uc_reg_read()).
+
+  @uc: the worker engine that ran the job
+  @err: result of the run, as uc_emu_start() would have returned it
+  @job_data: the job_data field of the submitted uc_pool_job
+*/
+typedef void (*uc_cb_pool_done_t)(uc_engine *uc, uc_err err, void *job_data);
+
+/*
+  One unit of work for uc_pool_submit(). The entry, until, timeout and
+  count fields mean exactly what they mean for uc_emu_start(); the input
+  itself is placed by the setup callback on the worker that picks the
+  job up.
+*/
+typedef struct uc_pool_job {
+    uint64_t entry;             // address where the run starts
+    uint64_t until;             // address where the run stops
+    uint64_t timeout;           // duration to run, in microseconds; 0 means no limit
+    size_t count;               // number of instructions to run; 0 means no limit
+    uc_cb_pool_setup_t setup;   // places the input; may be NULL
+    uc_cb_pool_done_t done;     // reads the outputs; may be NULL
+    void *job_data;             // handed to both callbacks and returned
+                                // in the job's uc_pool_result
+} uc_pool_job;
+
+/*
+  Completed job, as returned by uc_pool_collect()
+*/
+typedef struct uc_pool_result {
+    void *job_data; // the job_data field of the submitted uc_pool_job
+    uc_err err;     // result of the run; UC_ERR_MAP when the job changed
+                    // the memory mapping layout of its worker
+} uc_pool_result;
+
 /*
   Memory region mapped by uc_mem_map() and uc_mem_map_ptr()
   Retrieve the list of memory regions with uc_mem_regions()
@@ -263,6 +394,67 @@ typedef enum uc_query_type {
     // Dynamically query current hardware mode.
     UC_QUERY_MODE = 1,
     UC_QUERY_PAGE_SIZE,
+    // Number of entries in the softmmu TLB (see uc_tlb_resize()).
+    UC_QUERY_TLB_SIZE,
+    // Size in bytes of the translation cache (see uc_tcg_buffer_resize()).
+    UC_QUERY_TCG_BUFFER_SIZE,
+    // Number of entries in the jump cache (see uc_jmp_cache_resize()).
+    UC_QUERY_JMP_CACHE_SIZE,
+
+    // Translation cache statistics, for tuning the cache size and flush
+    // behaviour against a real workload rather than blind.
+    UC_QUERY_TB_COUNT,            // translated blocks currently cached
+    UC_QUERY_TB_BUFFER_USED,      // bytes of the translation cache in use
+    UC_QUERY_TB_FLUSH_COUNT,      // whole-cache flushes so far
+    UC_QUERY_TB_INVALIDATE_COUNT, // single blocks invalidated so far
+    UC_QUERY_TB_EVICT_COUNT,      // segment evictions on cache exhaustion
+    // Block lookups done and how many of them missed the fast per-pc
+    // cache; 1 - MISS/LOOKUP is the fast-path hit rate. A high miss share
+    // means blocks keep being re-looked-up the slow way (or retranslated:
+    // compare with UC_QUERY_TB_COUNT and the flush/evict counters).
+    UC_QUERY_TB_LOOKUP_COUNT,
+    UC_QUERY_TB_SLOW_LOOKUP_COUNT,
+
+    // Per-engine performance counters, accumulated since uc_open(). They
+    // are maintained on paths that already leave the generated code, so
+    // reading them does not require intrusive hooks that perturb what is
+    // being measured. They are monotonic and safe to poll with uc_query()
+    // from another thread while emulation runs - a watchdog comparing two
+    // reads of UC_QUERY_EXEC_BLOCK_COUNT gets "is this engine making
+    // progress and how fast" for free. Only the emulating thread writes
+    // them; a concurrent read can at worst see a value that is a moment
+    // stale (or, on 32-bit hosts, torn across a carry), never corrupt one.
+    // Blocks dispatched by the execution loop, and the instructions those
+    // blocks contain. Blocks that chain to each other inside the
+    // translation cache count as one dispatch, so these are lower bounds;
+    // they are exact when per-instruction hooks or single-stepping force
+    // every block back through the loop.
+    UC_QUERY_EXEC_BLOCK_COUNT,
+    UC_QUERY_EXEC_INSN_COUNT,
+    // Softmmu TLB fills, i.e. guest memory accesses that missed the TLB
+    // and took the page-walk slow path.
+    UC_QUERY_TLB_FILL_COUNT,
+    // Hook callbacks invoked (or queued, for asynchronous hooks) plus
+    // trace records appended by uc_trace_enable().
+    UC_QUERY_HOOK_EVENT_COUNT,
+    // Bytes copied by uc_mem_read() and uc_mem_write() together.
+    UC_QUERY_MEM_API_BYTES,
+    // Number of uc_emu_start() calls.
+    UC_QUERY_EMU_START_COUNT,
+    // Cumulative nanoseconds spent translating guest code to host code.
+    UC_QUERY_JIT_TIME_NS,
+
+    // Live memory footprint of this engine instance, in bytes, split by
+    // owner. All of it is returned by uc_close(); these let a host
+    // packing many engine instances see where each instance's overhead
+    // sits without diffing process RSS across runs.
+    UC_QUERY_MEM_CODE_BUFFER,   // translation cache allocation
+    UC_QUERY_MEM_TB_METADATA,   // block descriptors and lookup hash table
+    UC_QUERY_MEM_PAGE_TABLES,   // page descriptor tree and code bitmaps
+    UC_QUERY_MEM_TLB,           // softmmu TLB tables
+    UC_QUERY_MEM_GUEST_RAM,     // host memory backing mapped guest memory
+    UC_QUERY_MEM_DIRTY_BITMAPS, // dirty-memory tracking bitmaps
+    UC_QUERY_MEM_HOOKS,         // hook registrations and async event queue
 } uc_query_type;
 
 /*
@@ -300,6 +492,16 @@ bool uc_arch_supported(uc_arch arch);
 /*
  Create new instance of unicorn engine.
 
+ Thread-safety: distinct engine instances share no mutable state, so any
+ number of engines may be created and run concurrently, one per thread,
+ without locking. The only data shared between instances are immutable
+ process-wide caches (the QOM type graph of each architecture variant and
+ host constants such as the page size), which are built by the first open
+ and only read afterwards. A single engine instance is NOT thread-safe:
+ calls into the same handle must be serialized by the caller (except
+ uc_emu_stop(), which may interrupt a running emulation from another
+ thread).
+
  @arch: architecture type (UC_ARCH_*)
  @mode: hardware mode. This is combined of UC_MODE_*
  @uc: pointer to uc_engine, which will be updated at return time
@@ -325,6 +527,55 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **uc);
 UNICORN_EXPORT
 uc_err uc_close(uc_engine *uc);
 
+/*
+ Route the engine's own allocations through caller-supplied callbacks.
+
+ The allocations that scale with API usage - hook records, the hook
+ dispatch tables, the asynchronous hook queue, the sorted mapping index
+ and snapshot descriptors - are obtained through @alloc and returned
+ through @release. An application running many engine instances can hand
+ each one a private arena, keeping instances from interleaving on the
+ process heap; with an arena that is released wholesale after uc_close(),
+ the release callback can be a no-op. Memory allocated by the QEMU core
+ (translation buffers, guest RAM, CPU state) does not go through the
+ callbacks.
+
+ Must be called before the first hook, mapping or snapshot is created,
+ while the engine still holds none of these allocations; afterwards the
+ allocator can no longer be changed and UC_ERR_ARG is returned.
+
+ @uc: handle returned by uc_open()
+ @alloc: callback invoked to allocate memory
+ @release: callback invoked to free an allocation again
+ @opaque: user data passed on to both callbacks
+
+ @return UC_ERR_OK on success, or UC_ERR_ARG when a callback is missing or
+   the engine has outstanding allocations.
+*/
+UNICORN_EXPORT
+uc_err uc_set_allocator(uc_engine *uc, uc_cb_alloc_t alloc,
+        uc_cb_release_t release, void *opaque);
+
+/*
+ Reset UC instance to the state of a freshly opened handle, without the
+ cost of uc_close()/uc_open().
+
+ This clears all registers, unmaps all guest memory (dropping the
+ translations generated from it) and removes all hooks, but keeps the
+ machine, the JIT context and the translated-code buffer alive, so the
+ handle can be recycled cheaply, e.g. once per test case or fuzz input.
+ Engine tuning set through APIs like uc_tlb_resize() or
+ uc_superblock_enable() is deliberately kept.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when called while emulation is
+   running, or other value on failure (refer to uc_err enum for detailed
+   error).
+*/
+UNICORN_EXPORT
+uc_err uc_reset(uc_engine *uc);
+
 /*
  Query internal status of engine.
 
@@ -338,6 +589,219 @@ uc_err uc_close(uc_engine *uc);
 UNICORN_EXPORT
 uc_err uc_query(uc_engine *uc, uc_query_type type, size_t *result);
 
+// Layout version of uc_arch_state; bumped whenever a field is added,
+// removed or reinterpreted.  uc_arch_state_ptr() stores the version it
+// filled the struct against into the version field.
+#define UC_ARCH_STATE_VERSION 1
+
+// Direct view of the hot emulated CPU state, filled by uc_arch_state_ptr().
+// All pointers reference memory owned by the engine.
+typedef struct uc_arch_state {
+    uint32_t version;     // UC_ARCH_STATE_VERSION used to fill this struct
+    uint32_t reg_count;   // number of entries in regs
+    uint32_t reg_bytes;   // width in bytes of one regs entry and of pc
+    uint32_t flags_bytes; // width in bytes of flags
+    void *regs;           // general purpose register file, index 0 upward
+                          // in the architecture's natural numbering
+    void *pc;             // program counter
+    void *flags;          // architectural flags word (see uc_arch_state_ptr)
+} uc_arch_state;
+
+/*
+ Get direct pointers into the emulated CPU state.
+
+ The filled-in pointers reference the general purpose register file, the
+ program counter and the architectural flags word of the emulated CPU.
+ They remain valid until uc_close() and may be accessed with plain loads
+ and stores while emulation is stopped or from inside a hook callback,
+ avoiding one API crossing per register compared to uc_reg_read().
+ Tools that inspect registers after every block should call this once
+ and keep the struct.
+
+ Note on flags: condition codes that the JIT tracks lazily (the x86
+ CC_OP/CC_SRC state, the ARM NZCV bits) are only folded into the flags
+ word when the flags register is read through uc_reg_read(); all other
+ bits are current.  Registers outside the GPR file (segment, vector,
+ coprocessor) also remain uc_reg_read() territory.
+
+ Supported for UC_ARCH_X86, UC_ARCH_ARM and UC_ARCH_ARM64.
+
+ @uc: handle returned by uc_open()
+ @state: points to a uc_arch_state the function fills; check the version
+   field against UC_ARCH_STATE_VERSION before relying on the layout
+
+ @return UC_ERR_OK on success, or UC_ERR_ARCH when the architecture does
+   not provide a direct state view.
+*/
+UNICORN_EXPORT
+uc_err uc_arch_state_ptr(uc_engine *uc, uc_arch_state *state);
+
+/*
+ Resize the emulated TLB of this instance.
+ The default size suits typical workloads; guests streaming through large
+ data sets profit from more entries, while tiny short-lived instances can
+ shrink the TLB to make every internal TLB flush cheaper. The current size
+ can be read back with uc_query(UC_QUERY_TLB_SIZE).
+
+ NOTE: resizing drops all cached translations, so call this once right
+ after uc_open(), before the first uc_emu_start().
+
+ @uc: handle returned by uc_open()
+ @entries: number of TLB entries. This must be a power of two no larger
+    than the compile-time maximum (the uc_query(UC_QUERY_TLB_SIZE) value
+    of a fresh engine), or this will return with UC_ERR_ARG error.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_tlb_resize(uc_engine *uc, uint32_t entries);
+
+/*
+ Resize the jump cache of this instance.
+ The jump cache maps a guest pc straight to its translated block; only on
+ a miss does the engine fall back to walking a hash chain. The default of
+ 4096 entries thrashes on guests with a large hot code footprint (think a
+ JS engine), which then pay the chain walk on most block transitions - for
+ such guests a 4x or 16x larger cache is pure win. Small guests can leave
+ it alone. The current size can be read back with
+ uc_query(UC_QUERY_JMP_CACHE_SIZE), and the slow-path share with
+ uc_query(UC_QUERY_TB_SLOW_LOOKUP_COUNT) / UC_QUERY_TB_LOOKUP_COUNT.
+
+ Resizing clears the cache but drops no translations, so it is cheap and
+ can be done at any time.
+
+ @uc: handle returned by uc_open()
+ @entries: number of cache entries, a power of two between 16 and 65536,
+    or this will return with UC_ERR_ARG error.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_jmp_cache_resize(uc_engine *uc, uint32_t entries);
+
+/*
+ Resize the translation cache of this instance.
+ The cache holds the code generated from guest instructions; when it runs
+ full, the translations least recently generated are evicted and rebuilt
+ on demand. Large guests profit from a bigger cache (fewer evictions),
+ while swarms of tiny instances can shrink it well below the default to
+ save host memory. The number of translated blocks the engine will cache scales with
+ the size. The current size can be read back with
+ uc_query(UC_QUERY_TCG_BUFFER_SIZE).
+
+ NOTE: resizing drops all cached translations, so call this once right
+ after uc_open(), before the first uc_emu_start().
+
+ @uc: handle returned by uc_open()
+ @size: new cache size in bytes. Values outside the supported range (1MB
+    up to an architecture-dependent maximum) return UC_ERR_ARG.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_tcg_buffer_resize(uc_engine *uc, size_t size);
+
+/*
+ Save the translated-code cache of this instance to a file.
+ Together with uc_tb_cache_load() this avoids re-translating the same guest
+ code in every process when many identical short-lived processes emulate
+ one guest image: warm up a first engine, save its cache, and load it in
+ the others.
+
+ The generated code embeds absolute host addresses, so a saved cache is
+ only loadable by a process whose memory layout matches the saving one
+ byte for byte: the same executable (no relinking, same base address), the
+ same translation cache size, and allocations falling at the same
+ addresses (typically true for identical processes started the same way).
+ uc_tb_cache_load() verifies all of this, plus a per-block hash of the
+ guest code bytes, and fails cleanly when anything differs - the engine
+ then simply translates as usual.
+
+ @uc: handle returned by uc_open()
+ @path: file to write; overwritten if it exists.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_tb_cache_save(uc_engine *uc, const char *path);
+
+/*
+ Load a translated-code cache saved by uc_tb_cache_save().
+ Call it on a fresh engine, after mapping the same guest image at the same
+ addresses and before the first uc_emu_start(). Blocks whose guest bytes
+ no longer match are skipped; a file recorded by an incompatible process
+ is rejected as a whole. Either way the engine stays fully functional and
+ translates whatever was not restored.
+
+ @uc: handle returned by uc_open()
+ @path: file written by uc_tb_cache_save()
+
+ @return UC_ERR_OK on success, UC_ERR_RESOURCE when the file cannot be
+   read or does not fit this process (treat as a cache miss and continue).
+*/
+UNICORN_EXPORT
+uc_err uc_tb_cache_load(uc_engine *uc, const char *path);
+
+/*
+ Translate a range of guest code ahead of execution.
+ Emulation normally JITs each block the first time it runs, so the first
+ pass over cold code pays the translation cost at execution time. Calling
+ this on known entry points and hot functions before uc_emu_start() moves
+ that cost to a moment of your choosing, e.g. process startup. Blocks
+ already translated are skipped, so repeated calls are cheap.
+
+ Translation uses the current CPU mode and flags; blocks are reused by a
+ later uc_emu_start() only while that state still matches. Pair it with
+ uc_tb_cache_save() to capture a warm cache without executing anything.
+
+ The range is walked block by block from @address. Walking stops early at
+ an invalid instruction or when the code runs out of mapped executable
+ memory; the untranslated rest simply faults (or translates) at execution
+ time as usual, with the memory hooks in place.
+
+ @uc: handle returned by uc_open()
+ @address: address of the first instruction to translate
+ @size: size of the code range in bytes; the last block may extend beyond
+    the range, as blocks are translated whole.
+
+ @return UC_ERR_OK when at least one block is cached for the range (or
+   @size is 0), UC_ERR_FETCH_UNMAPPED when nothing could be translated.
+*/
+UNICORN_EXPORT
+uc_err uc_translate(uc_engine *uc, uint64_t address, size_t size);
+
+// Upper bound for the uc_translate_readahead() block count.
+#define UC_TRANSLATE_READAHEAD_MAX 64
+
+/*
+ Enable speculative translation read-ahead.
+ With read-ahead enabled, whenever execution reaches untranslated code,
+ the engine translates up to @blocks consecutive blocks beyond the one it
+ needed, instead of returning to the translator once per block. A first
+ pass over cold code then stays in generated code longer, which cuts the
+ per-block translation round trips that dominate short runs; uc_translate()
+ covers the same ground when the hot addresses are known up front, while
+ read-ahead needs no prior knowledge of the code layout.
+
+ The guesses follow the static fall-through successor, so code behind an
+ unconditional branch may be translated without ever running; a wrong
+ guess costs one unused translation cache slot and nothing else. Read-ahead
+ never evicts existing translations. It is disabled by default; pass 0 to
+ disable it again.
+
+ @uc: handle returned by uc_open()
+ @blocks: number of blocks to translate ahead per miss,
+    0 to UC_TRANSLATE_READAHEAD_MAX.
+
+ @return UC_ERR_OK on success, or UC_ERR_ARG when @blocks is out of range.
+*/
+UNICORN_EXPORT
+uc_err uc_translate_readahead(uc_engine *uc, uint32_t blocks);
+
 /*
  Report the last error number when some API function fail.
  Like glibc's errno, uc_errno might not retain its old value once accessed.
@@ -386,6 +850,34 @@ uc_err uc_reg_write(uc_engine *uc, int regid, const void *value);
 UNICORN_EXPORT
 uc_err uc_reg_read(uc_engine *uc, int regid, void *value);
 
+/*
+ Read multiple register values in one call.
+
+ @uc: handle returned by uc_open()
+ @regs:  array of register IDs to retrieve
+ @vals:  array of pointers to values, filled in register by register
+ @count: length of both arrays
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_reg_read_batch(uc_engine *uc, int *regs, void **vals, int count);
+
+/*
+ Write multiple register values in one call.
+
+ @uc: handle returned by uc_open()
+ @regs:  array of register IDs to modify
+ @vals:  array of pointers to the values to set, register by register
+ @count: length of both arrays
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_reg_write_batch(uc_engine *uc, int *regs, void *const *vals, int count);
+
 /*
  Write to a range of bytes in memory.
 
@@ -418,9 +910,118 @@ uc_err uc_mem_write(uc_engine *uc, uint64_t address, const void *bytes, size_t s
 UNICORN_EXPORT
 uc_err uc_mem_read(uc_engine *uc, uint64_t address, void *bytes, size_t size);
 
+// Describes one (address, buffer, size) tuple for the scatter-gather memory
+// API below. @bytes is the source for uc_mem_write_v() and the destination
+// for uc_mem_read_v().
+typedef struct uc_mem_vec {
+    uint64_t address;
+    void *bytes;
+    size_t size;
+} uc_mem_vec;
+
+/*
+ Write many ranges of bytes to memory in one call (scatter-gather variant
+ of uc_mem_write()). The ranges are written in array order; if one of them
+ fails, earlier ranges remain written and later ones are not touched.
+
+ @uc: handle returned by uc_open()
+ @vecs: array of (address, buffer, size) tuples to write.
+ @count: number of entries in @vecs.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_write_v(uc_engine *uc, const uc_mem_vec *vecs, size_t count);
+
+/*
+ Read many ranges of bytes from memory in one call (scatter-gather variant
+ of uc_mem_read()). The ranges are read in array order; if one of them
+ fails, the contents of the remaining buffers are undefined.
+
+ @uc: handle returned by uc_open()
+ @vecs: array of (address, buffer, size) tuples to read.
+ @count: number of entries in @vecs.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_read_v(uc_engine *uc, uc_mem_vec *vecs, size_t count);
+
+/*
+ Get a host pointer into the RAM backing a mapped guest address, for
+ zero-copy access to guest memory.
+ The pointer stays valid until the containing region is unmapped or split
+ (by uc_mem_unmap() or uc_mem_protect()); writes through it are seen by the
+ guest directly, but bypass write protection and code invalidation, so do
+ not patch guest code this way.
+
+ @uc: handle returned by uc_open()
+ @address: guest address the pointer should point at
+ @ptr: filled with the host pointer corresponding to @address
+ @avail: if not NULL, filled with the number of contiguous bytes available
+   behind @ptr (up to the end of the containing region)
+
+ @return UC_ERR_OK on success, UC_ERR_READ_UNMAPPED if @address is not mapped,
+   or UC_ERR_ARG if the region is not backed by RAM.
+*/
+UNICORN_EXPORT
+uc_err uc_mem_ptr(uc_engine *uc, uint64_t address, void **ptr, size_t *avail);
+
+// Guest-to-host page translation table, filled in by uc_mem_xlat()
+typedef struct uc_xlat_table {
+    uint64_t base;       // guest address translated by entry 0 (page aligned)
+    uint64_t page_size;  // bytes covered per entry
+    uint64_t page_count; // number of entries behind @pages
+    uint32_t generation; // mapping topology generation the table reflects
+    void **pages;        // host pointer backing each guest page; NULL when
+                         // the page is unmapped or MMIO
+} uc_xlat_table;
+
+/*
+ Export the guest-to-host address translation as a flat, read-only page
+ table, for callers that touch guest memory far too often for uc_mem_read()
+ or even uc_mem_ptr() to keep up (e.g. a coverage-guided fuzzer scanning
+ state between iterations). A lookup is then
+
+    host = table.pages[(addr - table.base) / table.page_size]
+         + (addr % table.page_size)
+
+ after checking the index is below @page_count and the entry is not NULL.
+
+ The table is owned by the engine and cached: repeated calls are cheap while
+ the memory topology is unchanged. Any uc_mem_map()/uc_mem_unmap() (or a
+ region split by uc_mem_protect()) invalidates it - @generation changes and
+ the previously returned @pages array must no longer be used; call this
+ again for a fresh table. Host pointers have the same caveats as
+ uc_mem_ptr(): writes bypass write protection and code invalidation.
+
+ @uc: handle returned by uc_open()
+ @table: filled with the current table
+
+ @return UC_ERR_OK on success, or UC_ERR_NOMEM when the span from the lowest
+   to the highest mapped page is too sparse/large to materialize as a flat
+   array (refer to uc_err enum for other failures).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_xlat(uc_engine *uc, uc_xlat_table *table);
+
 /*
  Emulate machine code in a specific duration of time.
 
+ This may also be called from inside a hook callback to run a sub-emulation
+ (e.g. calling a guest function to resolve an import stub): the run the
+ callback belongs to is suspended for the duration of the nested run and
+ resumes where it left off once this returns, with its @until address,
+ remaining instruction budget and timeout intact. CPU registers and guest
+ memory are shared live state - whatever the sub-emulation changes and does
+ not restore (via uc_context_save()/uc_context_restore()) is visible to the
+ suspended run. uc_emu_stop() stops the innermost run only. Nested runs are
+ rejected with UC_ERR_ARG when a wall-clock @timeout is given (use
+ uc_icount_timeout() timeouts or @count instead) or when extra vCPUs were
+ created with uc_vcpu_create(), and with UC_ERR_RESOURCE beyond 8 levels.
+
  @uc: handle returned by uc_open()
  @begin: address where emulation starts
  @until: address where emulation stops (i.e when this address is hit)
@@ -435,10 +1036,68 @@ uc_err uc_mem_read(uc_engine *uc, uint64_t address, void *bytes, size_t size);
 UNICORN_EXPORT
 uc_err uc_emu_start(uc_engine *uc, uint64_t begin, uint64_t until, uint64_t timeout, size_t count);
 
+/*
+ Callback function called when an asynchronous run finishes.
+ Runs on the engine's background emulation thread, right before
+ uc_emu_wait() is released.
+
+ @uc: handle returned by uc_open()
+ @err: the result the matching uc_emu_start() call would have returned
+ @user_data: user data passed to uc_emu_start_async()
+*/
+typedef void (*uc_cb_emu_done_t)(uc_engine *uc, uc_err err, void *user_data);
+
+/*
+ Start emulation without blocking the calling thread.
+ Semantics of @begin/@until/@timeout/@count are those of uc_emu_start();
+ the run itself executes on a per-engine background thread, started on
+ the first asynchronous run and reused afterwards, and @done (if not
+ NULL) is invoked on that thread when the run finishes. This lets one
+ control thread drive many engines concurrently, stopping them with
+ uc_emu_stop() and collecting results from the completion callbacks or
+ via uc_emu_wait().
+
+ Only one run per engine may be active at a time: starting an
+ asynchronous run while another run (synchronous or not) is in flight
+ fails with UC_ERR_ARG. The engine is not locked - while the run is
+ active, touching its registers or memory from other threads races with
+ the guest just as it would during uc_emu_start().
+
+ @uc: handle returned by uc_open()
+ @begin: address where emulation starts
+ @until: address where emulation stops (i.e when this address is hit)
+ @timeout: duration to emulate the code (in microseconds), 0 for none
+ @count: the number of instructions to be emulated, 0 for all
+ @done: completion callback, or NULL
+ @user_data: user data passed to @done
+
+ @return UC_ERR_OK when the run was started, or other value on failure
+   (refer to uc_err enum for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_emu_start_async(uc_engine *uc, uint64_t begin, uint64_t until,
+        uint64_t timeout, size_t count, uc_cb_emu_done_t done,
+        void *user_data);
+
+/*
+ Wait for the asynchronous run in flight, if any, and return its result.
+ Returns after the run's completion callback has finished. With no run
+ in flight this returns the result of the last asynchronous run
+ immediately (UC_ERR_OK when there never was one).
+
+ @uc: handle returned by uc_open()
+
+ @return the uc_err the matching uc_emu_start() call would have returned.
+*/
+UNICORN_EXPORT
+uc_err uc_emu_wait(uc_engine *uc);
+
 /*
  Stop emulation (which was started by uc_emu_start() API.
  This is typically called from callback functions registered via tracing APIs.
  NOTE: for now, this will stop the execution only after the current block.
+ When runs are nested (uc_emu_start() called from a hook callback), this
+ stops the innermost run only.
 
  @uc: handle returned by uc_open()
 
@@ -448,6 +1107,81 @@ uc_err uc_emu_start(uc_engine *uc, uint64_t begin, uint64_t until, uint64_t time
 UNICORN_EXPORT
 uc_err uc_emu_stop(uc_engine *uc);
 
+/*
+ Resume emulation where the last run stopped.
+
+ Unlike calling uc_emu_start() again, this performs none of the per-run
+ setup: the PC is left untouched (it holds the address where the last run
+ stopped), @until from the last uc_emu_start() call stays in effect, and
+ whatever was left of its instruction count budget and timeout carries
+ over. Intended for callers that stop and resume emulation at high
+ frequency, e.g. to service syscalls outside the engine.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when there is no earlier
+   uc_emu_start() run to continue from, or other value on failure (refer
+   to uc_err enum for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_emu_continue(uc_engine *uc);
+
+/*
+ Create one more virtual CPU of the machine's model.
+
+ An engine starts with a single vCPU (id 0). Every vCPU created here takes
+ part in subsequent uc_emu_start() runs: the vCPUs are scheduled round-robin
+ on the emulating thread, each running a slice of uc_vcpu_quantum()
+ instructions per turn, until the run stops as usual (@until reached by any
+ vCPU, budget or timeout exhausted, uc_emu_stop(), or every vCPU halted).
+ The deterministic interleaving makes multi-threaded guest snippets and the
+ races between them reproducible across runs.
+
+ All vCPUs share the guest memory view; registers, PC and per-CPU state are
+ private to each vCPU and are addressed through uc_vcpu_select(). Must not
+ be called while emulation is running.
+
+ @uc: handle returned by uc_open()
+ @vcpu_id: if non-NULL, receives the id of the new vCPU
+
+ @return UC_ERR_OK on success, UC_ERR_ARCH when the arch cannot create
+   further vCPUs, or other value on failure (refer to uc_err enum for
+   detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_vcpu_create(uc_engine *uc, int *vcpu_id);
+
+/*
+ Select the vCPU addressed by the per-CPU APIs.
+
+ After this call uc_reg_read()/uc_reg_write(), uc_context_save()/
+ uc_context_restore(), uc_arch_state_ptr() and the @begin address of
+ uc_emu_start() operate on the chosen vCPU. The selection persists until
+ changed; id 0 (the initial vCPU) is selected by default.
+
+ @uc: handle returned by uc_open()
+ @vcpu_id: id returned by uc_vcpu_create(), or 0 for the initial vCPU
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when no such vCPU exists.
+*/
+UNICORN_EXPORT
+uc_err uc_vcpu_select(uc_engine *uc, int vcpu_id);
+
+/*
+ Set the round-robin scheduling quantum for multi-vCPU runs.
+
+ Smaller quanta interleave the vCPUs more finely (better for shaking out
+ races) at the cost of more scheduling overhead; larger quanta run faster.
+ Has no effect while only one vCPU exists. Default: 4096 instructions.
+
+ @uc: handle returned by uc_open()
+ @insns: instructions each vCPU may retire per turn, 1 to 65535
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when @insns is out of range.
+*/
+UNICORN_EXPORT
+uc_err uc_vcpu_quantum(uc_engine *uc, uint32_t insns);
+
 /*
  Register callback for a hook event.
  The callback will be run when the hook event is hit.
@@ -487,54 +1221,680 @@ uc_err uc_hook_add(uc_engine *uc, uc_hook *hh, int type, void *callback,
 UNICORN_EXPORT
 uc_err uc_hook_del(uc_engine *uc, uc_hook hh);
 
-typedef enum uc_prot {
-   UC_PROT_NONE = 0,
-   UC_PROT_READ = 1,
-   UC_PROT_WRITE = 2,
-   UC_PROT_EXEC = 4,
-   UC_PROT_ALL = 7,
-} uc_prot;
+// Event filter for a registered hook, evaluated natively before the
+// callback is invoked. Zeroed fields accept everything, so callers only
+// fill in the predicates they need.
+typedef struct uc_hook_filter {
+    uint64_t begin;      // only fire for addresses >= @begin
+    uint64_t end;        // ... and <= @end. @begin > @end: all addresses
+    uint32_t size_mask;  // bitmask of accepted access/instruction sizes in
+                         // bytes (bit n set: size n+1 accepted); 0: any size
+    uint64_t value_mask; // UC_HOOK_MEM_WRITE only: only fire when
+    uint64_t value;      // (written value & @value_mask) == @value; 0: any
+} uc_hook_filter;
 
 /*
- Map memory in for emulation.
- This API adds a memory region that can be used by emulation.
+ Set (or clear) the native event filter of a hook.
+ Events rejected by the filter never reach the callback, which avoids the
+ call overhead (e.g. FFI cost of binding languages) for uninteresting events.
 
  @uc: handle returned by uc_open()
- @address: starting address of the new memory region to be mapped in.
-    This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
- @size: size of the new memory region to be mapped in.
-    This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
- @perms: Permissions for the newly mapped region.
-    This must be some combination of UC_PROT_READ | UC_PROT_WRITE | UC_PROT_EXEC,
-    or this will return with UC_ERR_ARG error.
+ @hh: handle returned by uc_hook_add()
+ @filter: filter to install, or NULL to clear the size & value predicates
+    (the address range set by uc_hook_add() is kept)
 
  @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
    for detailed error).
 */
 UNICORN_EXPORT
-uc_err uc_mem_map(uc_engine *uc, uint64_t address, size_t size, uint32_t perms);
+uc_err uc_hook_set_filter(uc_engine *uc, uc_hook hh, const uc_hook_filter *filter);
 
 /*
- Map existing host memory in for emulation.
+ Add a data watchpoint on a range of guest memory.
+
+ A watchpoint fires @callback whenever guest code reads and/or writes any
+ byte in [@address, @address + @len), including accesses that only partially
+ overlap the range. Unlike a UC_HOOK_MEM_READ/UC_HOOK_MEM_WRITE hook, which
+ sends every load/store in the emulated program through an instrumented slow
+ path, a watchpoint only deoptimizes accesses to the pages it covers: the
+ engine poisons the TLB entries of those pages, and all other memory keeps
+ the fast path. Prefer watchpoints when monitoring a small range inside a
+ program that does a lot of unrelated memory traffic.
+
+ @uc: handle returned by uc_open()
+ @wh: watchpoint handle, to be passed to uc_watch_del()
+ @type: UC_HOOK_MEM_READ, UC_HOOK_MEM_WRITE, or both OR-ed together
+ @callback: callback to be invoked on a watched access; for reads the value
+    argument is 0 (the data has not been loaded yet)
+ @user_data: user-defined data, passed to @callback
+ @address: start address of the watched range
+ @len: length of the watched range in bytes (cannot be 0)
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_watch_add(uc_engine *uc, uc_hook *wh, int type,
+        uc_cb_hookmem_t callback, void *user_data, uint64_t address,
+        size_t len);
+
+/*
+ Remove a data watchpoint.
+ The affected pages return to the fast path (unless still covered by other
+ watchpoints or memory hooks). After this, @wh is invalid.
+
+ @uc: handle returned by uc_open()
+ @wh: handle returned by uc_watch_add()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_watch_del(uc_engine *uc, uc_hook wh);
+
+// Fixed-size binary trace record, written by the engine when trace mode
+// is enabled with uc_trace_enable().
+typedef struct uc_trace_record {
+    uint64_t address;   // address of the instruction, block or data access
+    uint32_t type;      // UC_HOOK_* type that produced this record
+    uint32_t size;      // instruction/access size in bytes (0 if unknown)
+} uc_trace_record;
+
+/*
+ Enable binary trace mode for some hook types.
+ Instead of invoking a callback per event, events of the given types are
+ appended as fixed-size uc_trace_record entries to @records, wrapping
+ around after @capacity entries. Callbacks registered with uc_hook_add()
+ for these types are not invoked while trace mode is enabled.
+ Use uc_trace_count() to learn how many records have been produced.
+
+ @uc: handle returned by uc_open()
+ @type: hook types to trace. Any combination of UC_HOOK_CODE,
+    UC_HOOK_BLOCK, UC_HOOK_MEM_READ and UC_HOOK_MEM_WRITE.
+ @records: user-allocated ring buffer of @capacity records.
+    This must stay valid until uc_trace_disable() is called.
+ @capacity: number of entries in @records.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_trace_enable(uc_engine *uc, int type, uc_trace_record *records,
+        size_t capacity);
+
+/*
+ Disable binary trace mode.
+ Events go back to the callbacks registered with uc_hook_add().
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_trace_disable(uc_engine *uc);
+
+/*
+ Report the total number of trace records produced since uc_trace_enable().
+ This counts all events, including those that wrapped around the ring
+ buffer: the next record will be written at index (count % capacity), and
+ when count exceeds capacity the oldest records have been overwritten.
+
+ @uc: handle returned by uc_open()
+ @count: pointer to a size_t receiving the record count.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_trace_count(uc_engine *uc, size_t *count);
+
+// Header written by uc_trace_stream() at the start of the output, followed
+// by a stream of uc_trace_stream_record entries. All fields are in host
+// endianness.
+typedef struct uc_trace_file_header {
+    char magic[4];          // "UCTR"
+    uint32_t version;       // format version, currently 1
+    uint32_t record_size;   // sizeof(uc_trace_stream_record)
+    uint32_t arch;          // uc_arch of the producing engine
+    uint32_t mode;          // uc_mode of the producing engine
+    uint32_t flags;         // UC_TRACE_COMPRESSED etc.
+    uint32_t reserved[2];   // zero; pads the header to 32 bytes
+} uc_trace_file_header;
+
+// uc_trace_file_header flags
+#define UC_TRACE_COMPRESSED 1   // records are wrapped in uc_trace_frame
+                                // frames, see uc_trace_compress()
+
+// One streamed trace event. @seq counts every record ever produced from 0
+// up, so a reader can both order records and detect truncated output.
+typedef struct uc_trace_stream_record {
+    uint64_t seq;       // record sequence number
+    uint64_t address;   // address of the instruction, block or data access
+    uint32_t type;      // UC_HOOK_* type that produced this record
+    uint32_t size;      // instruction/access size in bytes (0 if unknown)
+} uc_trace_stream_record;
+
+/*
+ Enable streaming binary trace mode: like uc_trace_enable(), but instead of
+ wrapping a user-owned ring, events are drained to @fd by a dedicated
+ writer thread, so full traces of very long runs are practical without a
+ callback (or any per-event API crossing) on the emulation thread. The
+ output is a uc_trace_file_header followed by densely packed
+ uc_trace_stream_record entries in sequence order.
+
+ Streaming is lossless: when the internal buffer fills because @fd cannot
+ keep up, emulation stalls until the writer drains it. The descriptor is
+ only ever written to (sequentially appended), is not closed by the
+ engine, and must stay open until uc_trace_disable() returns; a file or
+ pipe both work.
+
+ uc_trace_disable() ends streaming mode: it flushes everything produced so
+ far to @fd, stops the writer thread, and releases the internal buffer.
+ uc_trace_count() reports the records produced, as in ring mode.
+
+ @uc: handle returned by uc_open()
+ @type: hook types to trace. Any combination of UC_HOOK_CODE,
+    UC_HOOK_BLOCK, UC_HOOK_MEM_READ and UC_HOOK_MEM_WRITE.
+ @fd: open, writable file descriptor the trace is appended to
+ @capacity: entries in the internal buffer; 0 picks a default. Larger
+    buffers ride out longer bursts before emulation has to stall.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_trace_stream(uc_engine *uc, int type, int fd, size_t capacity);
+
+// Frame header of a compressed trace stream (UC_TRACE_COMPRESSED): each
+// batch of records is compressed independently and prefixed with this, so
+// a reader can skip frames without decompressing and locate a sequence
+// number by binary search over @first_seq.
+typedef struct uc_trace_frame {
+    uint32_t magic;             // UC_TRACE_FRAME_MAGIC
+    uint32_t raw_size;          // payload size once decompressed, in bytes
+    uint32_t compressed_size;   // payload bytes following this header; when
+                                // equal to raw_size the payload is stored
+                                // uncompressed
+    uint32_t record_count;      // records in this frame
+    uint64_t first_seq;         // sequence number of the first record
+} uc_trace_frame;
+
+#define UC_TRACE_FRAME_MAGIC 0x46544355     // "UCTF", little endian
+
+/*
+ Compress subsequent streaming traces (uc_trace_stream()). Instruction
+ traces are hugely redundant - loops repeat the same record patterns - so
+ at high trace volumes the disk, not the emulation, becomes the
+ bottleneck; block-level compression in the writer thread takes the
+ written volume down by more than an order of magnitude on loopy code.
+
+ When enabled, the stream after uc_trace_file_header (which then carries
+ UC_TRACE_COMPRESSED in its flags) is a series of uc_trace_frame frames.
+ Each frame's payload is an independent LZ-compressed block of packed
+ uc_trace_stream_record entries; decompress it with
+ uc_trace_decompress(). Incompressible frames are stored raw, flagged by
+ compressed_size == raw_size.
+
+ @uc: handle returned by uc_open()
+ @enable: compress subsequent streams. Must not be changed while a
+    stream is active.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_trace_compress(uc_engine *uc, bool enable);
+
+/*
+ Decompress the payload of one uc_trace_frame produced by a compressed
+ trace stream. @dst_len must be the frame's raw_size; anything else (or a
+ corrupt payload) fails with UC_ERR_ARG. For frames stored raw
+ (compressed_size == raw_size) just read the payload directly instead.
+
+ @src: compressed payload (compressed_size bytes)
+ @src_len: compressed payload size in bytes
+ @dst: buffer receiving the decompressed records
+ @dst_len: expected decompressed size in bytes (the frame's raw_size)
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_trace_decompress(const void *src, size_t src_len, void *dst,
+        size_t dst_len);
+
+// One guest instruction of a translated block, reported by uc_tb_meta().
+typedef struct uc_tb_insn {
+    uint64_t address;  // guest address of the instruction
+    uint32_t size;     // instruction length in bytes
+    uint8_t bytes[16]; // the instruction's bytes (the first @size entries)
+} uc_tb_insn;
+
+/*
+ Retrieve the instruction boundaries of the translated block starting at
+ @address. The metadata is recovered from the translator's own decode of
+ the block and cached on the translation, so trace consumers (e.g. a
+ UC_HOOK_CODE disassembling tracer) do not have to re-fetch guest memory
+ and re-decode instructions the JIT already decoded.
+
+ The metadata lives exactly as long as the translation: query it while
+ the block is live, typically from a UC_HOOK_BLOCK or UC_HOOK_CODE
+ callback. Stopping emulation flushes the translation cache and the
+ metadata with it. Instruction sizes are derived from consecutive
+ boundaries, so for superblocks (uc_superblock_enable()) the size of an
+ instruction followed by a folded jump is not meaningful.
+
+ @uc: handle returned by uc_open()
+ @insns: user-allocated array of @count entries to fill in, or NULL to
+    only query the instruction count of the block.
+ @count: on input, the capacity of @insns; on output, the number of
+    entries filled in (with @insns NULL: the block's instruction count).
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when no live translation
+   starts at @address (refer to uc_err enum for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_tb_meta(uc_engine *uc, uint64_t address, uc_tb_insn *insns,
+        uint32_t *count);
+
+/*
+ Enable edge coverage mode.
+ The engine updates @bitmap inline in the generated code at every basic
+ block boundary with the classic AFL edge hash:
+    bitmap[cur_location ^ prev_location]++
+ where cur_location is derived from the block address. This runs at near
+ full JIT speed; no callback is involved.
+
+ @uc: handle returned by uc_open()
+ @bitmap: user-allocated coverage bitmap, zeroed by the caller.
+    This must stay valid until uc_coverage_disable() is called.
+ @size: size of @bitmap in bytes. Must be a power of two (e.g. 64KB).
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_coverage_enable(uc_engine *uc, uint8_t *bitmap, size_t size);
+
+/*
+ Disable edge coverage mode.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_coverage_disable(uc_engine *uc);
+
+// Per-block execution statistics reported by uc_profile_top().
+typedef struct uc_block_stats {
+    uint64_t address;     // guest address of the basic block
+    uint32_t insn_count;  // number of instructions in the block
+    uint32_t exec_count;  // number of times the block was executed
+} uc_block_stats;
+
+/*
+ Enable per-block execution profiling.
+ While enabled, every translated block counts its executions with a
+ counter update emitted inline in the generated code; no callback is
+ involved. Query the result with uc_profile_top().
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_profile_enable(uc_engine *uc);
+
+/*
+ Disable per-block execution profiling and free the collected profile.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_profile_disable(uc_engine *uc);
+
+/*
+ Retrieve the hottest basic blocks recorded since uc_profile_enable(),
+ sorted by descending execution count.
+
+ @uc: handle returned by uc_open()
+ @stats: user-allocated array of @count entries to fill in.
+ @count: on input, the capacity of @stats; on output, the number of
+    entries filled in.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_profile_top(uc_engine *uc, uc_block_stats *stats, uint32_t *count);
+
+// One bucket of the guest-PC sample histogram reported by uc_sample_top().
+typedef struct uc_sample_entry {
+    uint64_t address; // guest address of the sampled basic block
+    uint64_t count;   // samples attributed to it
+} uc_sample_entry;
+
+/*
+ Enable statistical guest-PC sampling.
+ Every @interval dispatched basic blocks, the current guest PC is
+ recorded into a preallocated histogram - no callback runs and no
+ translations are dropped, so the overhead is a counter decrement per
+ dispatch and sampling can be switched on against a live workload.
+ This is the tool for "which guest function is slow": a UC_HOOK_CODE
+ based profile slows the guest by an order of magnitude and distorts
+ what it measures, a sample profile does not.
+
+ Blocks that chain to each other inside the translation cache do not
+ pass through the dispatch loop and are attributed to the block that
+ entered the chain; for exact per-block counts use uc_profile_enable()
+ instead, at its higher cost.
+
+ @uc: handle returned by uc_open()
+ @interval: record one sample every this many dispatched blocks
+    (1 samples every dispatch); cannot be 0.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_sample_enable(uc_engine *uc, uint32_t interval);
+
+/*
+ Disable guest-PC sampling and free the collected histogram.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_sample_disable(uc_engine *uc);
+
+/*
+ Retrieve the hottest sampled guest addresses since uc_sample_enable(),
+ sorted by descending sample count - ready to feed a flamegraph or a
+ symbolizer.
+
+ @uc: handle returned by uc_open()
+ @entries: user-allocated array of @count entries to fill in.
+ @count: on input, the capacity of @entries; on output, the number of
+    entries filled in.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_sample_top(uc_engine *uc, uc_sample_entry *entries, uint32_t *count);
+
+/*
+ Enable superblock formation for hot code.
+ A basic block that reaches @threshold executions is retranslated into a
+ larger block that follows unconditional direct jumps instead of ending,
+ widening the window of the code optimizer. Execution results are
+ unchanged; this is purely a speed/translation-cache-space trade-off.
+ Superblocks are not formed while a UC_HOOK_BLOCK hook is registered, as
+ they would merge block boundaries the hook must observe.
+
+ @uc: handle returned by uc_open()
+ @threshold: number of executions before a block is retranslated
+    (0: disable superblock formation).
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_superblock_enable(uc_engine *uc, uint32_t threshold);
+
+/*
+ Limit the number of guest instructions translated into one block.
+ Smaller blocks reduce the amount of code discarded when a block exits
+ early (dense instrumentation, frequent uc_emu_stop()), while the default
+ lets hookless bulk runs translate blocks as large as the target allows.
+ The limit applies to blocks translated after the call; translations made
+ under a previous limit are dropped at the end of the current emulation.
+
+ @uc: handle returned by uc_open()
+ @insns: maximum guest instructions per translated block
+    (0: restore the qemu default).
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_tb_insn_limit(uc_engine *uc, uint32_t insns);
+
+/*
+ Measure emulation timeouts in retired guest instructions instead of
+ wall-clock time.
+
+ When enabled, the @timeout argument of uc_emu_start() is interpreted as
+ a guest instruction budget rather than microseconds, enforced by the
+ same inline counter as the @count argument (the smaller of the two wins
+ when both are given). Unlike a wall-clock deadline, an instruction
+ budget makes a "timed out" run stop at the same guest instruction on
+ every host, regardless of machine load - useful when results must be
+ reproducible, e.g. for crash deduplication in fuzzing. Takes effect on
+ the next uc_emu_start() call.
+
+ @uc: handle returned by uc_open()
+ @enable: true to interpret timeouts as instruction budgets,
+    false to restore wall-clock timeouts.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_icount_timeout(uc_engine *uc, bool enable);
+
+/*
+ Export translated-code symbols for the host `perf` tool.
+ Writes /tmp/perf-<pid>.map in the format perf expects for JIT code: one
+ line per translation, labeled tb-0x<guest_pc>. Running `perf record` on
+ the embedding process then attributes host samples in the translation
+ cache to guest addresses, turning perf into a guest hot-spot profiler.
+ Translations made before the call are not exported; enable before
+ uc_emu_start() for complete coverage.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_perfmap_enable(uc_engine *uc);
+
+/*
+ Stop exporting translated-code symbols and close the map file.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_perfmap_disable(uc_engine *uc);
+
+typedef enum uc_prot {
+   UC_PROT_NONE = 0,
+   UC_PROT_READ = 1,
+   UC_PROT_WRITE = 2,
+   UC_PROT_EXEC = 4,
+   UC_PROT_ALL = 7,
+} uc_prot;
+
+// Mapping hints accepted by uc_mem_map() in addition to uc_prot permissions.
+// These are not permissions: they only influence how the host memory backing
+// the region is allocated, and are not reported back by uc_mem_regions().
+typedef enum uc_mem_flag {
+   // Prefer huge page backing for the region, to cut host TLB misses when
+   // emulated code streams through large guest images. Best effort: hosts
+   // without huge page support fall back to normal pages silently.
+   UC_MEM_HUGEPAGE = 1 << 8,
+   // Mark the region's backing pages as candidates for kernel same-page
+   // merging (KSM), so hosts running many engines with near-identical
+   // guest images deduplicate the clean pages across processes. Merged
+   // pages break on write, so this is safe for any uc_mem_map() region;
+   // it trades some kernel scanning cost for fleet-wide memory savings.
+   // Best effort: hosts without KSM leave the pages untouched.
+   UC_MEM_MERGEABLE = 1 << 9,
+} uc_mem_flag;
+
+/*
+ Map memory in for emulation.
  This API adds a memory region that can be used by emulation.
 
  @uc: handle returned by uc_open()
- @address: starting address of the new memory region to be mapped in.
+ @address: starting address of the new memory region to be mapped in.
+    This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
+ @size: size of the new memory region to be mapped in.
+    This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
+ @perms: Permissions for the newly mapped region.
+    This must be some combination of UC_PROT_READ | UC_PROT_WRITE | UC_PROT_EXEC,
+    optionally combined with uc_mem_flag hints, or this will return with
+    UC_ERR_ARG error.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_map(uc_engine *uc, uint64_t address, size_t size, uint32_t perms);
+
+/*
+ Map existing host memory in for emulation.
+ This API adds a memory region that can be used by emulation.
+
+ @uc: handle returned by uc_open()
+ @address: starting address of the new memory region to be mapped in.
+    This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
+ @size: size of the new memory region to be mapped in.
+    This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
+ @perms: Permissions for the newly mapped region.
+    This must be some combination of UC_PROT_READ | UC_PROT_WRITE | UC_PROT_EXEC,
+    or this will return with UC_ERR_ARG error.
+ @ptr: pointer to host memory backing the newly mapped memory. This host memory is
+    expected to be an equal or larger size than provided, and be mapped with at
+    least PROT_READ | PROT_WRITE. If it is not, the resulting behavior is undefined.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_map_ptr(uc_engine *uc, uint64_t address, size_t size, uint32_t perms, void *ptr);
+
+/*
+ Map a file in for emulation.
+ This API mmaps part of a file directly as the backing of a new memory
+ region. Pages are faulted in lazily from the page cache and shared with
+ other engine instances mapping the same file; guest writes are private
+ copy-on-write and never reach the file.
+
+ @uc: handle returned by uc_open()
+ @address: starting address of the new memory region to be mapped in.
+    This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
+ @path: path of the file to map.
+ @offset: offset into the file where the mapping starts.
+    This offset must be aligned to 4KB, or this will return with UC_ERR_ARG error.
+ @size: size of the new memory region to be mapped in.
+    This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
+    Accessing pages beyond the end of the file is undefined behavior.
+ @perms: Permissions for the newly mapped region.
+    This must be some combination of UC_PROT_READ | UC_PROT_WRITE | UC_PROT_EXEC,
+    or this will return with UC_ERR_ARG error.
+
+ NOTE: not supported on Windows.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error). UC_ERR_RESOURCE means the file could not be opened.
+*/
+UNICORN_EXPORT
+uc_err uc_mem_map_file(uc_engine *uc, uint64_t address, const char *path,
+        uint64_t offset, size_t size, uint32_t perms);
+
+/*
+ Save the whole engine state - every mapped memory region plus the CPU
+ context - as one image file that uc_restore_file() maps back in.
+ The guest RAM payloads are laid out aligned in the file, so restoring
+ mmaps them directly instead of parsing and copying: a prepared image
+ can be distributed to many workers and each one attaches to it in a
+ single mmap per region, faulting pages in lazily from the page cache.
+
+ Cannot be called during emulation.
+
+ @uc: handle returned by uc_open()
+ @path: path of the image file to create (overwritten if it exists).
+
+ NOTE: not supported on Windows.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error). UC_ERR_RESOURCE means the file could not be written.
+*/
+UNICORN_EXPORT
+uc_err uc_save_file(uc_engine *uc, const char *path);
+
+/*
+ Restore an engine from an image file written by uc_save_file().
+ Every region recorded in the image is mapped with its saved permissions,
+ backed directly by the file: pages are faulted in lazily from the page
+ cache and shared between all engine instances restoring from the same
+ image; guest writes are private copy-on-write and never reach the file.
+ The CPU context is restored last, same boundary as uc_context_restore().
+
+ The engine must be of the same arch/mode the image was saved with and
+ must not already have mappings overlapping the image's regions; on any
+ failure the regions mapped so far are unmapped again. The image must
+ come from the same build - like uc_context_save(), the CPU context blob
+ is not portable across versions or hosts. Cannot be called during
+ emulation.
+
+ @uc: handle returned by uc_open()
+ @path: path of the image file to restore from.
+
+ NOTE: not supported on Windows.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error). UC_ERR_RESOURCE means the file could not be read.
+*/
+UNICORN_EXPORT
+uc_err uc_restore_file(uc_engine *uc, const char *path);
+
+/*
+ Map an MMIO region with user callbacks for emulation.
+ This API adds a memory region whose reads and writes are served by the
+ given callbacks through the native IO dispatch path, instead of by RAM.
+ Use this to emulate device registers without paying hook-list dispatch
+ on every access.
+
+ @uc: handle returned by uc_open()
+ @address: starting address of the new MMIO region to be mapped in.
     This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
- @size: size of the new memory region to be mapped in.
+ @size: size of the new MMIO region to be mapped in.
     This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
- @perms: Permissions for the newly mapped region.
-    This must be some combination of UC_PROT_READ | UC_PROT_WRITE | UC_PROT_EXEC,
-    or this will return with UC_ERR_ARG error.
- @ptr: pointer to host memory backing the newly mapped memory. This host memory is
-    expected to be an equal or larger size than provided, and be mapped with at
-    least PROT_READ | PROT_WRITE. If it is not, the resulting behavior is undefined.
+ @read_cb: callback invoked for every read from the region. NULL leaves
+    the region without read permission, so reads fault like any other
+    non-readable page.
+ @user_data_read: user data passed to @read_cb.
+ @write_cb: callback invoked for every write to the region. NULL leaves
+    the region without write permission.
+ @user_data_write: user data passed to @write_cb.
+
+ NOTE: code cannot be executed from an MMIO region, and the region cannot
+ be split by a partial uc_mem_unmap() or have its permissions changed by
+ uc_mem_protect(). Unmapping the whole region at once works as usual.
 
  @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
    for detailed error).
 */
 UNICORN_EXPORT
-uc_err uc_mem_map_ptr(uc_engine *uc, uint64_t address, size_t size, uint32_t perms, void *ptr);
+uc_err uc_mmio_map(uc_engine *uc, uint64_t address, size_t size,
+        uc_cb_mmio_read_t read_cb, void *user_data_read,
+        uc_cb_mmio_write_t write_cb, void *user_data_write);
 
 /*
  Unmap a region of emulation memory.
@@ -552,6 +1912,99 @@ uc_err uc_mem_map_ptr(uc_engine *uc, uint64_t address, size_t size, uint32_t per
 UNICORN_EXPORT
 uc_err uc_mem_unmap(uc_engine *uc, uint64_t address, size_t size);
 
+/*
+ Return the host memory backing a range of guest memory to the OS.
+ The mapping itself stays in place with unchanged permissions, but the
+ contents of the range are discarded: anonymous regions read back as zero,
+ file-backed regions (uc_mem_map_file()) re-read the file. Use this to keep
+ the resident size of long-lived workers bounded by what the guest actually
+ touches between jobs.
+
+ @uc: handle returned by uc_open()
+ @address: starting address of the memory range to decommit.
+    This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
+ @size: size of the memory range to decommit.
+    This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_decommit(uc_engine *uc, uint64_t address, size_t size);
+
+/*
+ Report which pages of a range of guest memory have been written to.
+ One bit per 4KB page is set in @bitmap, least significant bit first: bit 0
+ of bitmap[0] is the first page of the range, bit 0 of bitmap[1] the ninth,
+ and so on. A page counts as written from the moment it is mapped until
+ uc_mem_dirty_reset() clears it, so call uc_mem_dirty_reset() once after
+ setting up the initial guest state to track only the writes made by
+ emulation. This is much cheaper than hashing or comparing all of guest
+ memory to find what a run modified.
+
+ @uc: handle returned by uc_open()
+ @address: starting address of the memory range to query.
+    This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
+ @size: size of the memory range to query.
+    This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
+ @bitmap: pointer to a buffer of at least (@size / 4KB + 7) / 8 bytes.
+    The buffer is zeroed first, then the bits of written pages are set.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_dirty(uc_engine *uc, uint64_t address, size_t size, uint8_t *bitmap);
+
+/*
+ Clear the written-page state reported by uc_mem_dirty() for a range of
+ guest memory. Pages in the range read as clean again until the next guest
+ write touches them.
+
+ @uc: handle returned by uc_open()
+ @address: starting address of the memory range to reset.
+    This address must be aligned to 4KB, or this will return with UC_ERR_ARG error.
+ @size: size of the memory range to reset.
+    This size must be multiple of 4KB, or this will return with UC_ERR_ARG error.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_dirty_reset(uc_engine *uc, uint64_t address, size_t size);
+
+/*
+ Start a batch of memory mapping changes.
+ Every uc_mem_map()/uc_mem_map_ptr()/uc_mem_unmap()/uc_mem_protect() call
+ normally rebuilds the flattened view of the guest address space, which is
+ O(number of regions). Wrapping a series of mapping calls in
+ uc_mem_batch_begin()/uc_mem_batch_commit() defers the rebuild so it happens
+ once at commit, not once per call. Batches nest; the rebuild happens when
+ the outermost batch commits.
+
+ NOTE: between begin and commit only mapping-layout calls should be made;
+ memory accesses and emulation must wait until the batch is committed.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_batch_begin(uc_engine *uc);
+
+/*
+ Commit a batch of memory mapping changes started by uc_mem_batch_begin(),
+ rebuilding the flattened address space view once for all of them.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or UC_ERR_ARG when no batch is open (refer to
+   uc_err enum for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_batch_commit(uc_engine *uc);
+
 /*
  Set memory permissions for emulation memory.
  This API changes permissions on an existing memory region.
@@ -588,6 +2041,451 @@ uc_err uc_mem_protect(uc_engine *uc, uint64_t address, size_t size, uint32_t per
 UNICORN_EXPORT
 uc_err uc_mem_regions(uc_engine *uc, uc_mem_region **regions, uint32_t *count);
 
+/*
+ Allocation-free variant of uc_mem_regions(): copy the mapped regions into
+ a caller-owned array. Useful for callers that poll the memory map of many
+ engines and do not want an allocation per call.
+
+ @uc: handle returned by uc_open()
+ @regions: caller-owned array with room for @capacity uc_mem_region structs
+ @capacity: number of entries @regions can hold
+ @count: receives the total number of mapped regions. When this is larger
+   than @capacity only the first @capacity entries were copied; call again
+   with a bigger buffer to get them all.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_regions_fill(uc_engine *uc, uc_mem_region *regions,
+        uint32_t capacity, uint32_t *count);
+
+/*
+ Allocate a region that can be used with uc_context_save() to perform
+ quick save/rollback of the CPU context, which includes registers and some
+ internal metadata. Contexts may not be shared across engine instances with
+ differing arches or modes.
+
+ @uc: handle returned by uc_open()
+ @context: pointer to a uc_context*. This will be updated with the pointer to
+   the new context on successful return of this function. Later, this allocated
+   memory must be freed with uc_context_free().
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_context_alloc(uc_engine *uc, uc_context **context);
+
+/*
+ Return the size needed to store the cpu context. Can be used to allocate a buffer
+ to contain the cpu context and directly call uc_context_save.
+
+ @uc: handle returned by uc_open()
+
+ @return the size for needed to store the cpu context as a size_t.
+*/
+UNICORN_EXPORT
+size_t uc_context_size(uc_engine *uc);
+
+/*
+ Save a copy of the internal CPU context.
+ This API should be used to efficiently make or update a saved copy of the
+ internal CPU state.
+
+ @uc: handle returned by uc_open()
+ @context: handle returned by uc_context_alloc()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_context_save(uc_engine *uc, uc_context *context);
+
+/*
+ Restore the current CPU context from a saved copy.
+ This API should be used to roll the CPU context back to a previous
+ state saved by uc_context_save().
+
+ @uc: handle returned by uc_open()
+ @context: handle returned by uc_context_alloc() that was previously passed
+   to uc_context_save()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_context_restore(uc_engine *uc, uc_context *context);
+
+/*
+ Free a CPU context allocated by uc_context_alloc().
+ After this, @context is invalid, and nolonger usable.
+
+ @context: handle returned by uc_context_alloc()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_context_free(uc_context *context);
+
+/*
+ Create a new engine that is a copy-on-write clone of an existing one.
+ The child starts with the parent's CPU state and sees the parent's memory
+ contents, but pages are only copied when the child writes to them, so
+ spawning a worker from a prepared image is nearly free and workers share
+ the host memory of all pages they never touch.
+ NOTE 1: the parent must not execute or modify its memory while clones of it
+   are alive, or the changes may leak into pages the children have not
+   written to yet (the usual fork-server discipline).
+ NOTE 2: regions mapped with uc_mem_map_ptr() cannot be shared and cause
+   this to fail. Not supported on Windows.
+
+ @uc: parent handle returned by uc_open()
+ @result: pointer to uc_engine, updated with the child handle at return time.
+   The child must be released with uc_close() like any other engine.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_clone(uc_engine *uc, uc_engine **result);
+
+/*
+ Share one memory region of another engine into this one, copy-on-write.
+ The region of @src containing @address is mapped into @uc at the same guest
+ address with the given permissions. Clean pages are shared with @src
+ through the host page cache; they are only copied when this instance
+ writes to them, so regions mapped without UC_PROT_WRITE (code, rodata)
+ stay fully shared no matter how many instances attach them.
+ NOTE 1: the source must not modify the region while it is shared, or the
+   changes may leak into pages the attached instances have not written yet
+   (same discipline as uc_clone()).
+ NOTE 2: regions mapped with uc_mem_map_ptr() cannot be shared and cause
+   this to fail. Not supported on Windows.
+
+ @uc: handle the region gets mapped into, returned by uc_open()
+ @src: handle owning the region to share
+ @address: any address inside the source region to share; the whole region
+   is attached.
+ @perms: Permissions for the region in @uc.
+    This must be some combination of UC_PROT_READ | UC_PROT_WRITE | UC_PROT_EXEC,
+    or this will return with UC_ERR_ARG error.
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_mem_share(uc_engine *uc, uc_engine *src, uint64_t address, uint32_t perms);
+
+/*
+ Take a full snapshot of the VM: CPU state plus the contents of all mapped
+ memory. Restoring is incremental: uc_restore() copies back only the pages
+ that were written to since the snapshot (or the last restore), so rolling
+ back between short emulation runs is cheap even for large guests.
+
+ @uc: handle returned by uc_open()
+ @snapshot: pointer to a (struct uc_snapshot *). This will be updated with the
+   pointer to the new snapshot on successful return of this function. Later,
+   this allocated memory must be freed with uc_snapshot_free().
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_snapshot(uc_engine *uc, struct uc_snapshot **snapshot);
+
+/*
+ Roll CPU state & memory back to a snapshot taken by uc_snapshot().
+ Only pages dirtied since the snapshot (or since the previous restore) are
+ copied back. The same snapshot can be restored any number of times.
+ NOTE: the memory mapping layout must not have been changed (by uc_mem_map(),
+ uc_mem_unmap() etc) since the snapshot was taken, or this returns UC_ERR_MAP.
+
+ @uc: handle returned by uc_open()
+ @snapshot: handle returned by uc_snapshot()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_restore(uc_engine *uc, struct uc_snapshot *snapshot);
+
+/*
+ Free a snapshot taken by uc_snapshot().
+ After this, @snapshot is invalid, and nolonger usable.
+
+ @uc: handle returned by uc_open()
+ @snapshot: handle returned by uc_snapshot()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_snapshot_free(uc_engine *uc, struct uc_snapshot *snapshot);
+
+/*
+ Keep a bounded ring of incremental checkpoints while emulating.
+
+ An internal block hook takes a checkpoint every @interval executed
+ blocks (plus one immediately, as the anchor), keeping the most recent
+ @depth of them. uc_rewind() then rolls CPU and memory back a chosen
+ number of checkpoints, so analysis can revisit a recent point without
+ re-running from the start.
+
+ Rewind cost is proportional to the pages actually dirtied, not to RAM
+ size: each checkpoint records which pages changed since its predecessor
+ (via the same dirty-page tracking uc_restore() uses), and stepping back
+ copies only those. The checkpoints themselves store RAM the way
+ uc_snapshot() does, with all-zero pages left unallocated.
+
+ The ring owns the dirty-page bitmap between checkpoints: calling
+ uc_snapshot() or uc_restore() directly while the ring is enabled
+ re-arms that bitmap and corrupts the deltas, so do not mix the two.
+
+ @uc: handle returned by uc_open()
+ @interval: blocks executed between checkpoints; must be > 0
+ @depth: number of checkpoints kept, older ones are evicted; must be > 0
+
+ @return UC_ERR_OK on success, UC_ERR_ARG if the ring is already enabled
+   or this is called from a hook while emulation is running (refer to
+   uc_err enum for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_checkpoint_enable(uc_engine *uc, uint64_t interval, uint32_t depth);
+
+/*
+ Roll CPU and memory back @steps checkpoints: 1 returns to the most
+ recent checkpoint, 2 to the one before it, and so on. The undone
+ checkpoints are dropped from the ring; the target checkpoint stays, so
+ rewinding further - or emulating forward again, which resumes taking
+ checkpoints - works from there. Must not be called from a hook while
+ emulation is running.
+
+ @uc: handle returned by uc_open()
+ @steps: how many checkpoints to go back; at most the number currently
+   in the ring (the anchor plus one per @interval blocks executed,
+   capped at @depth)
+
+ @return UC_ERR_OK on success, UC_ERR_ARG if the ring is not enabled or
+   @steps is out of range, UC_ERR_MAP if the memory mapping layout
+   changed since the target checkpoint was taken (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_rewind(uc_engine *uc, uint32_t steps);
+
+/*
+ Stop taking checkpoints and free the ring.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, UC_ERR_ARG if the ring is not enabled
+   (refer to uc_err enum for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_checkpoint_disable(uc_engine *uc);
+
+/*
+ Run a persistent-mode fuzzing loop entirely inside the library: take one
+ snapshot, then repeat place-input -> emulate from @entry until an exit
+ address -> incremental dirty-page rollback, without crossing the API
+ boundary per iteration. This is the pattern otherwise hand-rolled from
+ uc_snapshot()/uc_emu_start()/uc_restore() with far more API traffic.
+
+ The @place_input callback runs before every iteration with the snapshot
+ state in place; whatever it writes (and whatever the run dirties) is
+ rolled back before the next iteration. When a run fails - invalid memory
+ access, unmapped fetch, etc. - the loop stops WITHOUT rolling back, so
+ the faulting CPU and memory state is left in place for triage, and the
+ run's error is returned. The callback must not change the memory mapping
+ layout; that ends the loop with UC_ERR_MAP.
+
+ @uc: handle returned by uc_open()
+ @entry: address every iteration starts from
+ @exits: addresses where an iteration ends normally (watched via internal
+   code hooks, so they must be instruction boundaries)
+ @exit_count: number of entries in @exits
+ @iterations: number of iterations to run; 0 runs until @place_input
+   returns false
+ @place_input: callback placing the next input, see uc_cb_place_input_t
+ @user_data: passed on to @place_input
+
+ @return UC_ERR_OK when the loop ran to completion, or the error of the
+   iteration that ended it (refer to uc_err enum for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_fuzz_loop(uc_engine *uc, uint64_t entry, const uint64_t *exits,
+        size_t exit_count, uint64_t iterations,
+        uc_cb_place_input_t place_input, void *user_data);
+
+/*
+ Create a pool of worker engines running jobs in parallel.
+ Every worker is a copy-on-write clone of @model (see uc_clone()) on its
+ own thread, so prepare the model once - map the guest image, set up the
+ baseline register state, pre-translate hot code with uc_tb_gen() - and
+ each worker starts from that state. After every job the worker rolls
+ back to it with an incremental dirty-page restore, so short jobs stay
+ short. Jobs are pulled from one shared queue, which balances the load
+ across workers however unevenly the job runtimes are distributed.
+ NOTE 1: the model must stay alive and untouched while the pool exists
+   (the usual uc_clone() discipline).
+ NOTE 2: like uc_clone(), this does not work on regions mapped with
+   uc_mem_map_ptr(), and is not supported on Windows.
+
+ @model: prepared engine the workers are cloned from
+ @nworkers: number of worker engines, at least 1
+ @result: updated with the new pool on successful return. The pool must
+   be released with uc_pool_free().
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_pool_create(uc_engine *model, uint32_t nworkers, uc_pool **result);
+
+/*
+ Queue one job on a pool. The job is copied, runs on the next free
+ worker, and its completion is reported by uc_pool_collect(); submission
+ and execution overlap freely. When the queue is full this call blocks
+ until a worker picks a job up.
+
+ May be called from any thread, but the job's callbacks run on the
+ worker's thread: they may use the worker engine handed to them, but
+ must not touch the model or other workers.
+
+ @pool: pool returned by uc_pool_create()
+ @job: description of the run, see uc_pool_job; copied before return
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_pool_submit(uc_pool *pool, const uc_pool_job *job);
+
+/*
+ Wait for one submitted job to complete and return its result. Results
+ are delivered in completion order, which is not submission order.
+
+ @pool: pool returned by uc_pool_create()
+ @result: filled with the completed job's job_data and error
+
+ @return UC_ERR_OK when a result was collected, UC_ERR_ARG when every
+   submitted job has already been collected (so a drain loop terminates
+   deterministically).
+*/
+UNICORN_EXPORT
+uc_err uc_pool_collect(uc_pool *pool, uc_pool_result *result);
+
+/*
+ Shut a pool down and release it: waits for jobs already running to
+ finish, discards jobs still queued, joins the worker threads and closes
+ the worker engines. Results not collected before this call are lost, so
+ drain the pool with uc_pool_collect() first when they matter. The model
+ engine is left untouched and usable again.
+
+ @pool: pool returned by uc_pool_create()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_pool_free(uc_pool *pool);
+
+/*
+ Start recording the nondeterministic inputs of the following runs, so
+ they can be re-executed bit-exactly later without the hooks installed
+ (see uc_replay_load()). What is recorded: every uc_reg_write() and
+ uc_mem_write() made while emulation is running - i.e. the state
+ mutations hook callbacks perform - and every mid-run stop, whether from
+ a callback's uc_emu_stop() or from a timeout expiry. Each event is
+ anchored to its position in the instruction stream, counted as the nth
+ execution of the instruction whose code hook was being dispatched.
+
+ Requirements for a usable log:
+  - a UC_HOOK_CODE hook must cover every instruction whose callbacks
+    mutate state (mutations from other hook kinds are attributed to the
+    most recent code-hook dispatch); a log with an unanchorable event is
+    refused by uc_record_save().
+  - the run itself must be deterministic apart from the recorded inputs:
+    same initial CPU/memory state (capture it with uc_context_save() or
+    uc_snapshot()) and, for timeout runs, uc_icount_timeout() enabled so
+    the budget is counted in instructions, not wall time.
+  - writes through uc_mem_xlat() pointers bypass the API and are not
+    seen; use uc_mem_write() in callbacks that must be recordable.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when called while emulation is
+   running.
+*/
+UNICORN_EXPORT
+uc_err uc_record_enable(uc_engine *uc);
+
+/*
+ Write the events recorded since uc_record_enable() to a file, to be
+ consumed by uc_replay_load(). Recording continues; call
+ uc_record_disable() to stop it.
+
+ @uc: handle returned by uc_open()
+ @path: file to write; overwritten if it exists.
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when recording is off or an
+   event could not be anchored (see uc_record_enable()), UC_ERR_RESOURCE
+   when the file cannot be written.
+*/
+UNICORN_EXPORT
+uc_err uc_record_save(uc_engine *uc, const char *path);
+
+/*
+ Stop recording and discard the unsaved log.
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK on success, or other value on failure (refer to uc_err enum
+   for detailed error).
+*/
+UNICORN_EXPORT
+uc_err uc_record_disable(uc_engine *uc);
+
+/*
+ Arm a replay of a log written by uc_record_save(). Restore the initial
+ state the recording started from, load the log, and run the same
+ uc_emu_start() call - the recorded mutations are re-applied at their
+ recorded positions and a recorded stop ends the run at the same
+ instruction, all without the original hooks installed.
+
+ The cost is confined to the event sites: one internal code hook is
+ placed per distinct site, so only translated blocks containing those
+ addresses carry instrumentation and everything else runs at plain,
+ hookless JIT speed. When the last event has been applied even those
+ hooks are removed. A stop recorded from a timeout replays as an exact
+ stop at the same instruction, so the replay does not need (or want)
+ the original timeout.
+
+ @uc: handle returned by uc_open()
+ @path: file written by uc_record_save()
+
+ @return UC_ERR_OK on success, UC_ERR_ARG when called while emulation is
+   running, UC_ERR_RESOURCE when the file cannot be read or was recorded
+   by a different arch/mode.
+*/
+UNICORN_EXPORT
+uc_err uc_replay_load(uc_engine *uc, const char *path);
+
+/*
+ End a replay: removes any internal hooks still armed and frees the
+ loaded log. Call it after the replayed run (or to abort a replay).
+
+ @uc: handle returned by uc_open()
+
+ @return UC_ERR_OK when the whole log was applied, UC_ERR_ARG when
+   events were left over - the replayed run diverged from the recorded
+   one (different initial state) or was cut short.
+*/
+UNICORN_EXPORT
+uc_err uc_replay_stop(uc_engine *uc);
+
 #ifdef __cplusplus
 }
 #endif
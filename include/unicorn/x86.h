@@ -17,6 +17,26 @@ typedef struct uc_x86_mmr {
     uint32_t flags;     /* not used by GDTR and IDTR */
 } uc_x86_mmr;
 
+// Bulk FPU/SSE/AVX state for UC_X86_REG_XSTATE, laid out like the XSAVE
+// area: the legacy 512-byte FXSAVE image followed by the AVX high halves.
+// Reading or writing it moves the whole floating point and vector state in
+// one call instead of one call per register.
+typedef struct uc_x86_xstate {
+    uint16_t fcw;           // x87 control word
+    uint16_t fsw;           // x87 status word, top-of-stack in bits 11-13
+    uint8_t ftw;            // abridged tag word, bit per valid register
+    uint8_t reserved1;
+    uint16_t fop;           // last x87 opcode
+    uint64_t fip;           // last instruction pointer (not tracked)
+    uint64_t fdp;           // last data pointer (not tracked)
+    uint32_t mxcsr;
+    uint32_t mxcsr_mask;
+    uint8_t st[8][16];      // ST(0)..ST(7), 80-bit value in the low 10 bytes
+    uint8_t xmm[16][16];    // XMM0..XMM15
+    uint8_t reserved2[96];  // pads the legacy area to 512 bytes
+    uint8_t ymmh[16][16];   // high 128 bits of YMM0..YMM15
+} uc_x86_xstate;
+
 // Callback function for tracing SYSCALL/SYSENTER (for uc_hook_intr())
 // @user_data: user data passed to tracing APIs.
 typedef void (*uc_cb_insn_syscall_t)(struct uc_struct *uc, void *user_data);
@@ -74,6 +94,7 @@ typedef enum uc_x86_reg {
 	UC_X86_REG_R14D, UC_X86_REG_R15D, UC_X86_REG_R8W, UC_X86_REG_R9W, UC_X86_REG_R10W,
 	UC_X86_REG_R11W, UC_X86_REG_R12W, UC_X86_REG_R13W, UC_X86_REG_R14W, UC_X86_REG_R15W,
 	UC_X86_REG_IDTR, UC_X86_REG_GDTR, UC_X86_REG_LDTR, UC_X86_REG_TR,
+	UC_X86_REG_XSTATE,	// whole FPU/SSE/AVX state as one uc_x86_xstate blob
 
 	UC_X86_REG_ENDING		// <-- mark the end of the list of registers
 } uc_x86_reg;
@@ -10,13 +10,38 @@
 #define tb_invalidate_phys_page_fast tb_invalidate_phys_page_fast_aarch64
 #define phys_mem_clean phys_mem_clean_aarch64
 #define tb_cleanup tb_cleanup_aarch64
+#define page_tree_reclaim page_tree_reclaim_aarch64
+#define tb_profile_flush tb_profile_flush_aarch64
 #define memory_map memory_map_aarch64
+#define memory_snapshot_ram memory_snapshot_ram_aarch64
+#define memory_restore_ram memory_restore_ram_aarch64
+#define memory_snapshot_free_ram memory_snapshot_free_ram_aarch64
+#define memory_ckpt_delta memory_ckpt_delta_aarch64
+#define memory_ckpt_apply memory_ckpt_apply_aarch64
+#define memory_ckpt_delta_free memory_ckpt_delta_free_aarch64
+#define qemu_ram_make_shareable qemu_ram_make_shareable_aarch64
+#define qemu_ram_set_owned qemu_ram_set_owned_aarch64
 #define memory_map_ptr memory_map_ptr_aarch64
+#define memory_map_io memory_map_io_aarch64
 #define memory_unmap memory_unmap_aarch64
+#define memory_decommit memory_decommit_aarch64
+#define memory_dirty_query memory_dirty_query_aarch64
+#define memory_dirty_reset memory_dirty_reset_aarch64
 #define memory_free memory_free_aarch64
 #define helper_raise_exception helper_raise_exception_aarch64
 #define tcg_enabled tcg_enabled_aarch64
 #define tcg_exec_init tcg_exec_init_aarch64
+#define tcg_buffer_resize tcg_buffer_resize_aarch64
+#define tb_cache_save tb_cache_save_aarch64
+#define tb_cache_load tb_cache_load_aarch64
+#define tb_prewarm tb_prewarm_aarch64
+#define tb_meta_get tb_meta_get_aarch64
+#define tb_readahead tb_readahead_aarch64
+#define tb_stats tb_stats_aarch64
+#define mem_stats mem_stats_aarch64
+#define tb_crosspage_link tb_crosspage_link_aarch64
+#define tb_crosspage_unchain tb_crosspage_unchain_aarch64
+#define tb_superblock tb_superblock_aarch64
 #define memory_register_types memory_register_types_aarch64
 #define cpu_exec_init_all cpu_exec_init_all_aarch64
 #define vm_start vm_start_aarch64
@@ -37,9 +62,6 @@
 #define aarch64_banked_spsr_index aarch64_banked_spsr_index_aarch64
 #define aarch64_restore_sp aarch64_restore_sp_aarch64
 #define aarch64_save_sp aarch64_save_sp_aarch64
-#define accel_find accel_find_aarch64
-#define accel_init_machine accel_init_machine_aarch64
-#define accel_type accel_type_aarch64
 #define access_with_adjusted_size access_with_adjusted_size_aarch64
 #define add128 add128_aarch64
 #define add16_sat add16_sat_aarch64
@@ -81,16 +103,9 @@
 #define addrrange_make addrrange_make_aarch64
 #define addrrange_shift addrrange_shift_aarch64
 #define adjust_endianness adjust_endianness_aarch64
-#define AES_cbc_encrypt AES_cbc_encrypt_aarch64
-#define AES_decrypt AES_decrypt_aarch64
-#define AES_encrypt AES_encrypt_aarch64
 #define AES_imc AES_imc_aarch64
-#define AES_set_decrypt_key AES_set_decrypt_key_aarch64
-#define AES_set_encrypt_key AES_set_encrypt_key_aarch64
 #define all_helpers all_helpers_aarch64
 #define alloc_code_gen_buffer alloc_code_gen_buffer_aarch64
-#define alloc_entry alloc_entry_aarch64
-#define always_true always_true_aarch64
 #define arm1026_initfn arm1026_initfn_aarch64
 #define arm1136_initfn arm1136_initfn_aarch64
 #define arm1136_r2_initfn arm1136_r2_initfn_aarch64
@@ -148,6 +163,7 @@
 #define tlb_fill tlb_fill_aarch64
 #define tlb_flush tlb_flush_aarch64
 #define tlb_flush_page tlb_flush_page_aarch64
+#define tlb_flush_range tlb_flush_range_aarch64
 #define tlb_set_page tlb_set_page_aarch64
 #define arm_translate_init arm_translate_init_aarch64
 #define arm_v7m_class_init arm_v7m_class_init_aarch64
@@ -156,21 +172,15 @@
 #define ats_write ats_write_aarch64
 #define bad_mode_switch bad_mode_switch_aarch64
 #define bank_number bank_number_aarch64
-#define bitmap_find_next_zero_area bitmap_find_next_zero_area_aarch64
 #define bitmap_zero_extend bitmap_zero_extend_aarch64
 #define bp_wp_matches bp_wp_matches_aarch64
 #define breakpoint_invalidate breakpoint_invalidate_aarch64
 #define build_page_bitmap build_page_bitmap_aarch64
-#define bus_add_child bus_add_child_aarch64
-#define bus_class_init bus_class_init_aarch64
-#define bus_info bus_info_aarch64
-#define bus_unparent bus_unparent_aarch64
 #define cache_block_ops_cp_reginfo cache_block_ops_cp_reginfo_aarch64
 #define cache_dirty_status_cp_reginfo cache_dirty_status_cp_reginfo_aarch64
 #define cache_test_clean_cp_reginfo cache_test_clean_cp_reginfo_aarch64
 #define call_recip_estimate call_recip_estimate_aarch64
 #define can_merge can_merge_aarch64
-#define capacity_increase capacity_increase_aarch64
 #define ccsidr_read ccsidr_read_aarch64
 #define check_ap check_ap_aarch64
 #define check_breakpoints check_breakpoints_aarch64
@@ -186,12 +196,7 @@
 #define commonNaNToFloat32 commonNaNToFloat32_aarch64
 #define commonNaNToFloat64 commonNaNToFloat64_aarch64
 #define commonNaNToFloatx80 commonNaNToFloatx80_aarch64
-#define compute_abs_deadline compute_abs_deadline_aarch64
 #define cond_name cond_name_aarch64
-#define configure_accelerator configure_accelerator_aarch64
-#define container_get container_get_aarch64
-#define container_info container_info_aarch64
-#define container_register_types container_register_types_aarch64
 #define contextidr_write contextidr_write_aarch64
 #define core_log_global_start core_log_global_start_aarch64
 #define core_log_global_stop core_log_global_stop_aarch64
@@ -228,23 +233,9 @@
 #define cpu_breakpoint_remove_by_ref cpu_breakpoint_remove_by_ref_aarch64
 #define cpu_can_do_io cpu_can_do_io_aarch64
 #define cpu_can_run cpu_can_run_aarch64
-#define cpu_class_init cpu_class_init_aarch64
-#define cpu_common_class_by_name cpu_common_class_by_name_aarch64
-#define cpu_common_exec_interrupt cpu_common_exec_interrupt_aarch64
-#define cpu_common_get_arch_id cpu_common_get_arch_id_aarch64
-#define cpu_common_get_memory_mapping cpu_common_get_memory_mapping_aarch64
-#define cpu_common_get_paging_enabled cpu_common_get_paging_enabled_aarch64
-#define cpu_common_has_work cpu_common_has_work_aarch64
-#define cpu_common_initfn cpu_common_initfn_aarch64
-#define cpu_common_noop cpu_common_noop_aarch64
-#define cpu_common_parse_features cpu_common_parse_features_aarch64
-#define cpu_common_realizefn cpu_common_realizefn_aarch64
-#define cpu_common_reset cpu_common_reset_aarch64
-#define cpu_dump_statistics cpu_dump_statistics_aarch64
 #define cpu_exec_init cpu_exec_init_aarch64
 #define cpu_flush_icache_range cpu_flush_icache_range_aarch64
 #define cpu_gen_init cpu_gen_init_aarch64
-#define cpu_get_clock cpu_get_clock_aarch64
 #define cpu_get_real_ticks cpu_get_real_ticks_aarch64
 #define cpu_get_tb_cpu_state cpu_get_tb_cpu_state_aarch64
 #define cpu_handle_debug_exception cpu_handle_debug_exception_aarch64
@@ -281,7 +272,6 @@
 #define cpu_physical_memory_write_rom cpu_physical_memory_write_rom_aarch64
 #define cpu_physical_memory_write_rom_internal cpu_physical_memory_write_rom_internal_aarch64
 #define cpu_register cpu_register_aarch64
-#define cpu_register_types cpu_register_types_aarch64
 #define cpu_restore_state cpu_restore_state_aarch64
 #define cpu_restore_state_from_tb cpu_restore_state_from_tb_aarch64
 #define cpu_single_step cpu_single_step_aarch64
@@ -290,14 +280,12 @@
 #define cpu_to_be64 cpu_to_be64_aarch64
 #define cpu_to_le32 cpu_to_le32_aarch64
 #define cpu_to_le64 cpu_to_le64_aarch64
-#define cpu_type_info cpu_type_info_aarch64
 #define cpu_unassigned_access cpu_unassigned_access_aarch64
 #define cpu_watchpoint_address_matches cpu_watchpoint_address_matches_aarch64
 #define cpu_watchpoint_insert cpu_watchpoint_insert_aarch64
 #define cpu_watchpoint_remove cpu_watchpoint_remove_aarch64
 #define cpu_watchpoint_remove_all cpu_watchpoint_remove_all_aarch64
 #define cpu_watchpoint_remove_by_ref cpu_watchpoint_remove_by_ref_aarch64
-#define crc32c_table crc32c_table_aarch64
 #define create_new_memory_mapping create_new_memory_mapping_aarch64
 #define csselr_write csselr_write_aarch64
 #define cto32 cto32_aarch64
@@ -320,15 +308,6 @@
 #define deposit32 deposit32_aarch64
 #define deposit64 deposit64_aarch64
 #define deregister_tm_clones deregister_tm_clones_aarch64
-#define device_class_base_init device_class_base_init_aarch64
-#define device_class_init device_class_init_aarch64
-#define device_finalize device_finalize_aarch64
-#define device_get_realized device_get_realized_aarch64
-#define device_initfn device_initfn_aarch64
-#define device_post_init device_post_init_aarch64
-#define device_reset device_reset_aarch64
-#define device_set_realized device_set_realized_aarch64
-#define device_type_info device_type_info_aarch64
 #define disas_arm_insn disas_arm_insn_aarch64
 #define disas_coproc_insn disas_coproc_insn_aarch64
 #define disas_dsp_insn disas_dsp_insn_aarch64
@@ -356,19 +335,12 @@
 #define do_usat do_usat_aarch64
 #define do_v7m_exception_exit do_v7m_exception_exit_aarch64
 #define dummy_c15_cp_reginfo dummy_c15_cp_reginfo_aarch64
-#define dummy_func dummy_func_aarch64
 #define dummy_section dummy_section_aarch64
 #define _DYNAMIC _DYNAMIC_aarch64
 #define _edata _edata_aarch64
 #define _end _end_aarch64
-#define end_list end_list_aarch64
 #define eq128 eq128_aarch64
 #define ErrorClass_lookup ErrorClass_lookup_aarch64
-#define error_copy error_copy_aarch64
-#define error_exit error_exit_aarch64
-#define error_get_class error_get_class_aarch64
-#define error_get_pretty error_get_pretty_aarch64
-#define error_setg_file_open error_setg_file_open_aarch64
 #define estimateDiv128To64 estimateDiv128To64_aarch64
 #define estimateSqrt32 estimateSqrt32_aarch64
 #define excnames excnames_aarch64
@@ -393,13 +365,10 @@
 #define extractFloatx80Exp extractFloatx80Exp_aarch64
 #define extractFloatx80Frac extractFloatx80Frac_aarch64
 #define extractFloatx80Sign extractFloatx80Sign_aarch64
-#define fcntl_setfl fcntl_setfl_aarch64
 #define fcse_write fcse_write_aarch64
 #define find_better_copy find_better_copy_aarch64
-#define find_default_machine find_default_machine_aarch64
 #define find_desc_by_name find_desc_by_name_aarch64
 #define find_first_bit find_first_bit_aarch64
-#define find_last_bit find_last_bit_aarch64
 #define find_paging_enabled_cpu find_paging_enabled_cpu_aarch64
 #define find_ram_block find_ram_block_aarch64
 #define find_ram_offset find_ram_offset_aarch64
@@ -603,13 +572,9 @@
 #define floatx80_unordered floatx80_unordered_aarch64
 #define floatx80_unordered_quiet floatx80_unordered_quiet_aarch64
 #define flush_icache_range flush_icache_range_aarch64
-#define format_string format_string_aarch64
 #define fp_decode_rm fp_decode_rm_aarch64
 #define frame_dummy frame_dummy_aarch64
-#define free_range free_range_aarch64
 #define fstat64 fstat64_aarch64
-#define futex_wait futex_wait_aarch64
-#define futex_wake futex_wake_aarch64
 #define gen_aa32_ld16s gen_aa32_ld16s_aarch64
 #define gen_aa32_ld16u gen_aa32_ld16u_aarch64
 #define gen_aa32_ld32u gen_aa32_ld32u_aarch64
@@ -1314,8 +1279,6 @@
 #define get_level1_table_address get_level1_table_address_aarch64
 #define get_mem_index get_mem_index_aarch64
 #define get_next_param_value get_next_param_value_aarch64
-#define get_opt_name get_opt_name_aarch64
-#define get_opt_value get_opt_value_aarch64
 #define get_page_addr_code get_page_addr_code_aarch64
 #define get_param_value get_param_value_aarch64
 #define get_phys_addr get_phys_addr_aarch64
@@ -1348,7 +1311,6 @@
 #define handle_vminmaxnm handle_vminmaxnm_aarch64
 #define handle_vrint handle_vrint_aarch64
 #define handle_vsel handle_vsel_aarch64
-#define has_help_option has_help_option_aarch64
 #define have_bmi1 have_bmi1_aarch64
 #define have_bmi2 have_bmi2_aarch64
 #define hcr_write hcr_write_aarch64
@@ -1904,7 +1866,6 @@
 #define _init _init_aarch64
 #define init_cpreg_list init_cpreg_list_aarch64
 #define init_lists init_lists_aarch64
-#define input_type_enum input_type_enum_aarch64
 #define int128_2_64 int128_2_64_aarch64
 #define int128_add int128_add_aarch64
 #define int128_addto int128_addto_aarch64
@@ -1949,7 +1910,6 @@
 #define io_writeq io_writeq_aarch64
 #define io_writew io_writew_aarch64
 #define is_a64 is_a64_aarch64
-#define is_help_option is_help_option_aarch64
 #define is_power_of_2 is_power_of_2_aarch64
 #define isr_read isr_read_aarch64
 #define is_valid_option_list is_valid_option_list_aarch64
@@ -1959,19 +1919,6 @@
 #define iwmmxt_store_reg iwmmxt_store_reg_aarch64
 #define __jit_debug_descriptor __jit_debug_descriptor_aarch64
 #define __jit_debug_register_code __jit_debug_register_code_aarch64
-#define json_lexer json_lexer_aarch64
-#define json_lexer_destroy json_lexer_destroy_aarch64
-#define json_lexer_feed json_lexer_feed_aarch64
-#define json_lexer_feed_char json_lexer_feed_char_aarch64
-#define json_lexer_flush json_lexer_flush_aarch64
-#define json_lexer_init json_lexer_init_aarch64
-#define json_message_parser_destroy json_message_parser_destroy_aarch64
-#define json_message_parser_feed json_message_parser_feed_aarch64
-#define json_message_parser_flush json_message_parser_flush_aarch64
-#define json_message_parser_init json_message_parser_init_aarch64
-#define json_message_process_token json_message_process_token_aarch64
-#define json_parser_parse json_parser_parse_aarch64
-#define json_parser_parse_err json_parser_parse_err_aarch64
 #define kvm_to_cpreg_id kvm_to_cpreg_id_aarch64
 #define last_ram_offset last_ram_offset_aarch64
 #define ldl_be_p ldl_be_p_aarch64
@@ -2007,11 +1954,6 @@
 #define log_cpu_state log_cpu_state_aarch64
 #define lpae_cp_reginfo lpae_cp_reginfo_aarch64
 #define lt128 lt128_aarch64
-#define machine_class_init machine_class_init_aarch64
-#define machine_finalize machine_finalize_aarch64
-#define machine_info machine_info_aarch64
-#define machine_initfn machine_initfn_aarch64
-#define machine_register_types machine_register_types_aarch64
 #define machvirt_init machvirt_init_aarch64
 #define machvirt_machine_init machvirt_machine_init_aarch64
 #define maj maj_aarch64
@@ -2111,10 +2053,7 @@
 #define memory_region_write_accessor memory_region_write_accessor_aarch64
 #define memory_region_wrong_endianness memory_region_wrong_endianness_aarch64
 #define memory_try_enable_merging memory_try_enable_merging_aarch64
-#define mktimegm mktimegm_aarch64
-#define module_call_init module_call_init_aarch64
 #define module_load module_load_aarch64
-#define mod_utf8_codepoint mod_utf8_codepoint_aarch64
 #define mpidr_cp_reginfo mpidr_cp_reginfo_aarch64
 #define mpidr_read mpidr_read_aarch64
 #define msr_mask msr_mask_aarch64
@@ -2135,7 +2074,6 @@
 #define neon_store_reg64 neon_store_reg64_aarch64
 #define neon_store_scratch neon_store_scratch_aarch64
 #define new_ldst_label new_ldst_label_aarch64
-#define next_list next_list_aarch64
 #define normalizeFloat128Subnormal normalizeFloat128Subnormal_aarch64
 #define normalizeFloat16Subnormal normalizeFloat16Subnormal_aarch64
 #define normalizeFloat32Subnormal normalizeFloat32Subnormal_aarch64
@@ -2148,61 +2086,6 @@
 #define not_v6_cp_reginfo not_v6_cp_reginfo_aarch64
 #define not_v7_cp_reginfo not_v7_cp_reginfo_aarch64
 #define not_v8_cp_reginfo not_v8_cp_reginfo_aarch64
-#define object_child_foreach object_child_foreach_aarch64
-#define object_class_foreach object_class_foreach_aarch64
-#define object_class_foreach_tramp object_class_foreach_tramp_aarch64
-#define object_class_get_list object_class_get_list_aarch64
-#define object_class_get_list_tramp object_class_get_list_tramp_aarch64
-#define object_class_get_parent object_class_get_parent_aarch64
-#define object_deinit object_deinit_aarch64
-#define object_dynamic_cast object_dynamic_cast_aarch64
-#define object_finalize object_finalize_aarch64
-#define object_finalize_child_property object_finalize_child_property_aarch64
-#define object_get_child_property object_get_child_property_aarch64
-#define object_get_link_property object_get_link_property_aarch64
-#define object_get_root object_get_root_aarch64
-#define object_initialize_with_type object_initialize_with_type_aarch64
-#define object_init_with_type object_init_with_type_aarch64
-#define object_instance_init object_instance_init_aarch64
-#define object_new_with_type object_new_with_type_aarch64
-#define object_post_init_with_type object_post_init_with_type_aarch64
-#define object_property_add_alias object_property_add_alias_aarch64
-#define object_property_add_link object_property_add_link_aarch64
-#define object_property_add_uint16_ptr object_property_add_uint16_ptr_aarch64
-#define object_property_add_uint32_ptr object_property_add_uint32_ptr_aarch64
-#define object_property_add_uint64_ptr object_property_add_uint64_ptr_aarch64
-#define object_property_add_uint8_ptr object_property_add_uint8_ptr_aarch64
-#define object_property_allow_set_link object_property_allow_set_link_aarch64
-#define object_property_del object_property_del_aarch64
-#define object_property_del_all object_property_del_all_aarch64
-#define object_property_del_child object_property_del_child_aarch64
-#define object_property_find object_property_find_aarch64
-#define object_property_get object_property_get_aarch64
-#define object_property_get_bool object_property_get_bool_aarch64
-#define object_property_get_enum object_property_get_enum_aarch64
-#define object_property_get_int object_property_get_int_aarch64
-#define object_property_get_link object_property_get_link_aarch64
-#define object_property_get_qobject object_property_get_qobject_aarch64
-#define object_property_get_str object_property_get_str_aarch64
-#define object_property_get_type object_property_get_type_aarch64
-#define object_property_get_uint16List object_property_get_uint16List_aarch64
-#define object_property_is_child object_property_is_child_aarch64
-#define object_property_print object_property_print_aarch64
-#define object_property_set object_property_set_aarch64
-#define object_property_set_description object_property_set_description_aarch64
-#define object_property_set_link object_property_set_link_aarch64
-#define object_property_set_qobject object_property_set_qobject_aarch64
-#define object_release_link_property object_release_link_property_aarch64
-#define object_resolve_abs_path object_resolve_abs_path_aarch64
-#define object_resolve_child_property object_resolve_child_property_aarch64
-#define object_resolve_link object_resolve_link_aarch64
-#define object_resolve_link_property object_resolve_link_property_aarch64
-#define object_resolve_partial_path object_resolve_partial_path_aarch64
-#define object_resolve_path object_resolve_path_aarch64
-#define object_resolve_path_component object_resolve_path_component_aarch64
-#define object_resolve_path_type object_resolve_path_type_aarch64
-#define object_set_link_property object_set_link_property_aarch64
-#define object_unparent object_unparent_aarch64
 #define omap_cachemaint_write omap_cachemaint_write_aarch64
 #define omap_cp_reginfo omap_cp_reginfo_aarch64
 #define omap_threadid_write omap_threadid_write_aarch64
@@ -2216,7 +2099,6 @@
 #define opts_do_parse opts_do_parse_aarch64
 #define opt_set opt_set_aarch64
 #define opts_parse opts_parse_aarch64
-#define output_type_enum output_type_enum_aarch64
 #define packFloat128 packFloat128_aarch64
 #define packFloat16 packFloat16_aarch64
 #define packFloat32 packFloat32_aarch64
@@ -2236,10 +2118,6 @@
 #define parse_keyword parse_keyword_aarch64
 #define parse_literal parse_literal_aarch64
 #define parse_object parse_object_aarch64
-#define parse_optional parse_optional_aarch64
-#define parse_option_bool parse_option_bool_aarch64
-#define parse_option_number parse_option_number_aarch64
-#define parse_option_size parse_option_size_aarch64
 #define parse_pair parse_pair_aarch64
 #define parser_context_free parser_context_free_aarch64
 #define parser_context_new parser_context_new_aarch64
@@ -2247,14 +2125,6 @@
 #define parser_context_pop_token parser_context_pop_token_aarch64
 #define parser_context_restore parser_context_restore_aarch64
 #define parser_context_save parser_context_save_aarch64
-#define parse_str parse_str_aarch64
-#define parse_type_bool parse_type_bool_aarch64
-#define parse_type_int parse_type_int_aarch64
-#define parse_type_number parse_type_number_aarch64
-#define parse_type_size parse_type_size_aarch64
-#define parse_type_str parse_type_str_aarch64
-#define parse_uint parse_uint_aarch64
-#define parse_uint_full parse_uint_full_aarch64
 #define parse_value parse_value_aarch64
 #define par_write par_write_aarch64
 #define patch_reloc patch_reloc_aarch64
@@ -2292,32 +2162,12 @@
 #define pmsav5_insn_ap_write pmsav5_insn_ap_write_aarch64
 #define pmuserenr_write pmuserenr_write_aarch64
 #define pmxevtyper_write pmxevtyper_write_aarch64
-#define pow2floor pow2floor_aarch64
-#define print_type_bool print_type_bool_aarch64
-#define print_type_int print_type_int_aarch64
-#define print_type_number print_type_number_aarch64
-#define print_type_size print_type_size_aarch64
-#define print_type_str print_type_str_aarch64
 #define propagateFloat128NaN propagateFloat128NaN_aarch64
 #define propagateFloat32MulAddNaN propagateFloat32MulAddNaN_aarch64
 #define propagateFloat32NaN propagateFloat32NaN_aarch64
 #define propagateFloat64MulAddNaN propagateFloat64MulAddNaN_aarch64
 #define propagateFloat64NaN propagateFloat64NaN_aarch64
 #define propagateFloatx80NaN propagateFloatx80NaN_aarch64
-#define property_get_alias property_get_alias_aarch64
-#define property_get_bool property_get_bool_aarch64
-#define property_get_str property_get_str_aarch64
-#define property_get_uint16_ptr property_get_uint16_ptr_aarch64
-#define property_get_uint32_ptr property_get_uint32_ptr_aarch64
-#define property_get_uint64_ptr property_get_uint64_ptr_aarch64
-#define property_get_uint8_ptr property_get_uint8_ptr_aarch64
-#define property_release_alias property_release_alias_aarch64
-#define property_release_bool property_release_bool_aarch64
-#define property_release_str property_release_str_aarch64
-#define property_resolve_alias property_resolve_alias_aarch64
-#define property_set_alias property_set_alias_aarch64
-#define property_set_bool property_set_bool_aarch64
-#define property_set_str property_set_str_aarch64
 #define pstate_read pstate_read_aarch64
 #define pstate_write pstate_write_aarch64
 #define pxa250_initfn pxa250_initfn_aarch64
@@ -2331,25 +2181,6 @@
 #define pxa270b1_initfn pxa270b1_initfn_aarch64
 #define pxa270c0_initfn pxa270c0_initfn_aarch64
 #define pxa270c5_initfn pxa270c5_initfn_aarch64
-#define qapi_dealloc_end_implicit_struct qapi_dealloc_end_implicit_struct_aarch64
-#define qapi_dealloc_end_list qapi_dealloc_end_list_aarch64
-#define qapi_dealloc_end_struct qapi_dealloc_end_struct_aarch64
-#define qapi_dealloc_get_visitor qapi_dealloc_get_visitor_aarch64
-#define qapi_dealloc_next_list qapi_dealloc_next_list_aarch64
-#define qapi_dealloc_pop qapi_dealloc_pop_aarch64
-#define qapi_dealloc_push qapi_dealloc_push_aarch64
-#define qapi_dealloc_start_implicit_struct qapi_dealloc_start_implicit_struct_aarch64
-#define qapi_dealloc_start_list qapi_dealloc_start_list_aarch64
-#define qapi_dealloc_start_struct qapi_dealloc_start_struct_aarch64
-#define qapi_dealloc_start_union qapi_dealloc_start_union_aarch64
-#define qapi_dealloc_type_bool qapi_dealloc_type_bool_aarch64
-#define qapi_dealloc_type_enum qapi_dealloc_type_enum_aarch64
-#define qapi_dealloc_type_int qapi_dealloc_type_int_aarch64
-#define qapi_dealloc_type_number qapi_dealloc_type_number_aarch64
-#define qapi_dealloc_type_size qapi_dealloc_type_size_aarch64
-#define qapi_dealloc_type_str qapi_dealloc_type_str_aarch64
-#define qapi_dealloc_visitor_cleanup qapi_dealloc_visitor_cleanup_aarch64
-#define qapi_dealloc_visitor_new qapi_dealloc_visitor_new_aarch64
 #define qapi_free_boolList qapi_free_boolList_aarch64
 #define qapi_free_ErrorClassList qapi_free_ErrorClassList_aarch64
 #define qapi_free_int16List qapi_free_int16List_aarch64
@@ -2366,76 +2197,18 @@
 #define qapi_free_X86CPUFeatureWordInfo qapi_free_X86CPUFeatureWordInfo_aarch64
 #define qapi_free_X86CPUFeatureWordInfoList qapi_free_X86CPUFeatureWordInfoList_aarch64
 #define qapi_free_X86CPURegister32List qapi_free_X86CPURegister32List_aarch64
-#define qbool_destroy_obj qbool_destroy_obj_aarch64
-#define qbool_from_int qbool_from_int_aarch64
-#define qbool_get_int qbool_get_int_aarch64
-#define qbool_type qbool_type_aarch64
-#define qbus_create qbus_create_aarch64
-#define qbus_create_inplace qbus_create_inplace_aarch64
-#define qbus_finalize qbus_finalize_aarch64
-#define qbus_initfn qbus_initfn_aarch64
-#define qbus_realize qbus_realize_aarch64
-#define qdev_create qdev_create_aarch64
-#define qdev_get_type qdev_get_type_aarch64
-#define qdev_register_types qdev_register_types_aarch64
-#define qdev_set_parent_bus qdev_set_parent_bus_aarch64
-#define qdev_try_create qdev_try_create_aarch64
-#define qdict_add_key qdict_add_key_aarch64
-#define qdict_array_split qdict_array_split_aarch64
-#define qdict_clone_shallow qdict_clone_shallow_aarch64
-#define qdict_del qdict_del_aarch64
-#define qdict_destroy_obj qdict_destroy_obj_aarch64
-#define qdict_entry_key qdict_entry_key_aarch64
-#define qdict_entry_value qdict_entry_value_aarch64
-#define qdict_extract_subqdict qdict_extract_subqdict_aarch64
-#define qdict_find qdict_find_aarch64
-#define qdict_first qdict_first_aarch64
-#define qdict_flatten qdict_flatten_aarch64
-#define qdict_flatten_qdict qdict_flatten_qdict_aarch64
-#define qdict_flatten_qlist qdict_flatten_qlist_aarch64
-#define qdict_get qdict_get_aarch64
-#define qdict_get_bool qdict_get_bool_aarch64
-#define qdict_get_double qdict_get_double_aarch64
-#define qdict_get_int qdict_get_int_aarch64
-#define qdict_get_obj qdict_get_obj_aarch64
-#define qdict_get_qdict qdict_get_qdict_aarch64
-#define qdict_get_qlist qdict_get_qlist_aarch64
-#define qdict_get_str qdict_get_str_aarch64
-#define qdict_get_try_bool qdict_get_try_bool_aarch64
-#define qdict_get_try_int qdict_get_try_int_aarch64
-#define qdict_get_try_str qdict_get_try_str_aarch64
-#define qdict_haskey qdict_haskey_aarch64
-#define qdict_has_prefixed_entries qdict_has_prefixed_entries_aarch64
-#define qdict_iter qdict_iter_aarch64
-#define qdict_join qdict_join_aarch64
-#define qdict_new qdict_new_aarch64
-#define qdict_next qdict_next_aarch64
-#define qdict_next_entry qdict_next_entry_aarch64
-#define qdict_put_obj qdict_put_obj_aarch64
-#define qdict_size qdict_size_aarch64
-#define qdict_type qdict_type_aarch64
 #define qemu_clock_get_us qemu_clock_get_us_aarch64
-#define qemu_clock_ptr qemu_clock_ptr_aarch64
 #define qemu_clocks qemu_clocks_aarch64
-#define qemu_cond_destroy qemu_cond_destroy_aarch64
 #define qemu_cpu_is_self qemu_cpu_is_self_aarch64
-#define qemu_cpu_kick_thread qemu_cpu_kick_thread_aarch64
-#define qemu_daemon qemu_daemon_aarch64
-#define qemu_event_destroy qemu_event_destroy_aarch64
-#define qemu_event_init qemu_event_init_aarch64
-#define qemu_event_reset qemu_event_reset_aarch64
-#define qemu_event_set qemu_event_set_aarch64
-#define qemu_event_wait qemu_event_wait_aarch64
-#define qemu_fdatasync qemu_fdatasync_aarch64
 #define qemu_flush_coalesced_mmio_buffer qemu_flush_coalesced_mmio_buffer_aarch64
 #define qemu_get_cpu qemu_get_cpu_aarch64
 #define qemu_get_guest_memory_mapping qemu_get_guest_memory_mapping_aarch64
 #define qemu_get_guest_simple_memory_mapping qemu_get_guest_simple_memory_mapping_aarch64
-#define qemu_get_local_state_pathname qemu_get_local_state_pathname_aarch64
 #define qemu_get_ram_block qemu_get_ram_block_aarch64
 #define qemu_get_ram_block_host_ptr qemu_get_ram_block_host_ptr_aarch64
 #define qemu_get_ram_fd qemu_get_ram_fd_aarch64
 #define qemu_get_ram_ptr qemu_get_ram_ptr_aarch64
+#define qemu_ram_block_base qemu_ram_block_base_aarch64
 #define qemu_host_page_mask qemu_host_page_mask_aarch64
 #define qemu_host_page_size qemu_host_page_size_aarch64
 #define qemu_init_vcpu qemu_init_vcpu_aarch64
@@ -2445,55 +2218,8 @@
 #define qemu_log_flush qemu_log_flush_aarch64
 #define qemu_loglevel_mask qemu_loglevel_mask_aarch64
 #define qemu_log_vprintf qemu_log_vprintf_aarch64
-#define qemu_mutex_destroy qemu_mutex_destroy_aarch64
 #define qemu_mutex_lock_ramlist qemu_mutex_lock_ramlist_aarch64
-#define qemu_mutex_trylock qemu_mutex_trylock_aarch64
 #define qemu_mutex_unlock_ramlist qemu_mutex_unlock_ramlist_aarch64
-#define qemu_oom_check qemu_oom_check_aarch64
-#define qemu_opt_del qemu_opt_del_aarch64
-#define qemu_opt_del_all qemu_opt_del_all_aarch64
-#define qemu_opt_find qemu_opt_find_aarch64
-#define qemu_opt_foreach qemu_opt_foreach_aarch64
-#define qemu_opt_get qemu_opt_get_aarch64
-#define qemu_opt_get_bool qemu_opt_get_bool_aarch64
-#define qemu_opt_get_bool_del qemu_opt_get_bool_del_aarch64
-#define qemu_opt_get_bool_helper qemu_opt_get_bool_helper_aarch64
-#define qemu_opt_get_del qemu_opt_get_del_aarch64
-#define qemu_opt_get_number qemu_opt_get_number_aarch64
-#define qemu_opt_get_number_del qemu_opt_get_number_del_aarch64
-#define qemu_opt_get_number_helper qemu_opt_get_number_helper_aarch64
-#define qemu_opt_get_size qemu_opt_get_size_aarch64
-#define qemu_opt_get_size_del qemu_opt_get_size_del_aarch64
-#define qemu_opt_get_size_helper qemu_opt_get_size_helper_aarch64
-#define qemu_opt_has_help_opt qemu_opt_has_help_opt_aarch64
-#define qemu_opt_parse qemu_opt_parse_aarch64
-#define qemu_opts_absorb_qdict qemu_opts_absorb_qdict_aarch64
-#define qemu_opts_append qemu_opts_append_aarch64
-#define qemu_opts_create qemu_opts_create_aarch64
-#define qemu_opts_del qemu_opts_del_aarch64
-#define qemu_opts_do_parse qemu_opts_do_parse_aarch64
-#define qemu_opt_set qemu_opt_set_aarch64
-#define qemu_opt_set_bool qemu_opt_set_bool_aarch64
-#define qemu_opt_set_err qemu_opt_set_err_aarch64
-#define qemu_opt_set_number qemu_opt_set_number_aarch64
-#define qemu_opts_find qemu_opts_find_aarch64
-#define qemu_opts_foreach qemu_opts_foreach_aarch64
-#define qemu_opts_free qemu_opts_free_aarch64
-#define qemu_opts_from_qdict qemu_opts_from_qdict_aarch64
-#define qemu_opts_from_qdict_1 qemu_opts_from_qdict_1_aarch64
-#define qemu_opts_id qemu_opts_id_aarch64
-#define qemu_opts_parse qemu_opts_parse_aarch64
-#define qemu_opts_print qemu_opts_print_aarch64
-#define qemu_opts_print_help qemu_opts_print_help_aarch64
-#define qemu_opts_reset qemu_opts_reset_aarch64
-#define qemu_opts_set qemu_opts_set_aarch64
-#define qemu_opts_set_defaults qemu_opts_set_defaults_aarch64
-#define qemu_opts_set_id qemu_opts_set_id_aarch64
-#define qemu_opts_to_qdict qemu_opts_to_qdict_aarch64
-#define qemu_opts_validate qemu_opts_validate_aarch64
-#define qemu_opt_unset qemu_opt_unset_aarch64
-#define qemu_parse_fd qemu_parse_fd_aarch64
-#define qemu_pipe qemu_pipe_aarch64
 #define qemu_ram_addr_from_host qemu_ram_addr_from_host_aarch64
 #define qemu_ram_addr_from_host_nofail qemu_ram_addr_from_host_nofail_aarch64
 #define qemu_ram_alloc qemu_ram_alloc_aarch64
@@ -2506,110 +2232,16 @@
 #define qemu_ram_setup_dump qemu_ram_setup_dump_aarch64
 #define qemu_ram_unset_idstr qemu_ram_unset_idstr_aarch64
 #define qemu_real_host_page_size qemu_real_host_page_size_aarch64
-#define qemu_sem_destroy qemu_sem_destroy_aarch64
-#define qemu_sem_init qemu_sem_init_aarch64
-#define qemu_sem_post qemu_sem_post_aarch64
-#define qemu_sem_timedwait qemu_sem_timedwait_aarch64
-#define qemu_sem_wait qemu_sem_wait_aarch64
-#define qemu_set_cloexec qemu_set_cloexec_aarch64
-#define qemu_set_tty_echo qemu_set_tty_echo_aarch64
 #define qemu_st_helpers qemu_st_helpers_aarch64
-#define qemu_strnlen qemu_strnlen_aarch64
-#define qemu_strsep qemu_strsep_aarch64
 #define qemu_tcg_cpu_thread_fn qemu_tcg_cpu_thread_fn_aarch64
 #define qemu_tcg_init_vcpu qemu_tcg_init_vcpu_aarch64
-#define qemu_thread_exit qemu_thread_exit_aarch64
-#define qemu_try_memalign qemu_try_memalign_aarch64
-#define qentry_destroy qentry_destroy_aarch64
-#define qerror_human qerror_human_aarch64
-#define qerror_report qerror_report_aarch64
-#define qerror_report_err qerror_report_err_aarch64
-#define qfloat_destroy_obj qfloat_destroy_obj_aarch64
-#define qfloat_from_double qfloat_from_double_aarch64
-#define qfloat_get_double qfloat_get_double_aarch64
-#define qfloat_type qfloat_type_aarch64
-#define qint_destroy_obj qint_destroy_obj_aarch64
-#define qint_from_int qint_from_int_aarch64
-#define qint_get_int qint_get_int_aarch64
-#define qint_type qint_type_aarch64
-#define qlist_append_obj qlist_append_obj_aarch64
-#define qlist_copy qlist_copy_aarch64
-#define qlist_copy_elem qlist_copy_elem_aarch64
-#define qlist_destroy_obj qlist_destroy_obj_aarch64
-#define qlist_empty qlist_empty_aarch64
 #define qlist_entry_obj qlist_entry_obj_aarch64
 #define qlist_first qlist_first_aarch64
-#define qlist_iter qlist_iter_aarch64
-#define qlist_new qlist_new_aarch64
 #define qlist_next qlist_next_aarch64
-#define qlist_peek qlist_peek_aarch64
-#define qlist_pop qlist_pop_aarch64
-#define qlist_size qlist_size_aarch64
-#define qlist_size_iter qlist_size_iter_aarch64
-#define qlist_type qlist_type_aarch64
-#define qmp_input_end_implicit_struct qmp_input_end_implicit_struct_aarch64
-#define qmp_input_end_list qmp_input_end_list_aarch64
-#define qmp_input_end_struct qmp_input_end_struct_aarch64
-#define qmp_input_get_next_type qmp_input_get_next_type_aarch64
-#define qmp_input_get_object qmp_input_get_object_aarch64
-#define qmp_input_get_visitor qmp_input_get_visitor_aarch64
-#define qmp_input_next_list qmp_input_next_list_aarch64
-#define qmp_input_optional qmp_input_optional_aarch64
-#define qmp_input_pop qmp_input_pop_aarch64
-#define qmp_input_push qmp_input_push_aarch64
-#define qmp_input_start_implicit_struct qmp_input_start_implicit_struct_aarch64
-#define qmp_input_start_list qmp_input_start_list_aarch64
-#define qmp_input_start_struct qmp_input_start_struct_aarch64
-#define qmp_input_type_bool qmp_input_type_bool_aarch64
-#define qmp_input_type_int qmp_input_type_int_aarch64
-#define qmp_input_type_number qmp_input_type_number_aarch64
-#define qmp_input_type_str qmp_input_type_str_aarch64
-#define qmp_input_visitor_cleanup qmp_input_visitor_cleanup_aarch64
-#define qmp_input_visitor_new qmp_input_visitor_new_aarch64
-#define qmp_input_visitor_new_strict qmp_input_visitor_new_strict_aarch64
-#define qmp_output_add_obj qmp_output_add_obj_aarch64
-#define qmp_output_end_list qmp_output_end_list_aarch64
-#define qmp_output_end_struct qmp_output_end_struct_aarch64
-#define qmp_output_first qmp_output_first_aarch64
-#define qmp_output_get_qobject qmp_output_get_qobject_aarch64
-#define qmp_output_get_visitor qmp_output_get_visitor_aarch64
-#define qmp_output_last qmp_output_last_aarch64
-#define qmp_output_next_list qmp_output_next_list_aarch64
-#define qmp_output_pop qmp_output_pop_aarch64
-#define qmp_output_push_obj qmp_output_push_obj_aarch64
-#define qmp_output_start_list qmp_output_start_list_aarch64
-#define qmp_output_start_struct qmp_output_start_struct_aarch64
-#define qmp_output_type_bool qmp_output_type_bool_aarch64
-#define qmp_output_type_int qmp_output_type_int_aarch64
-#define qmp_output_type_number qmp_output_type_number_aarch64
-#define qmp_output_type_str qmp_output_type_str_aarch64
-#define qmp_output_visitor_cleanup qmp_output_visitor_cleanup_aarch64
-#define qmp_output_visitor_new qmp_output_visitor_new_aarch64
 #define qobject_decref qobject_decref_aarch64
-#define qobject_from_json qobject_from_json_aarch64
-#define qobject_from_jsonf qobject_from_jsonf_aarch64
-#define qobject_from_jsonv qobject_from_jsonv_aarch64
 #define qobject_incref qobject_incref_aarch64
-#define qobject_to_json qobject_to_json_aarch64
-#define qobject_to_json_pretty qobject_to_json_pretty_aarch64
-#define qobject_to_qbool qobject_to_qbool_aarch64
-#define qobject_to_qdict qobject_to_qdict_aarch64
-#define qobject_to_qfloat qobject_to_qfloat_aarch64
-#define qobject_to_qint qobject_to_qint_aarch64
-#define qobject_to_qlist qobject_to_qlist_aarch64
-#define qobject_to_qstring qobject_to_qstring_aarch64
 #define qobject_type qobject_type_aarch64
-#define qstring_append qstring_append_aarch64
-#define qstring_append_chr qstring_append_chr_aarch64
-#define qstring_append_int qstring_append_int_aarch64
-#define qstring_destroy_obj qstring_destroy_obj_aarch64
 #define qstring_from_escaped_str qstring_from_escaped_str_aarch64
-#define qstring_from_str qstring_from_str_aarch64
-#define qstring_from_substr qstring_from_substr_aarch64
-#define qstring_get_length qstring_get_length_aarch64
-#define qstring_get_str qstring_get_str_aarch64
-#define qstring_new qstring_new_aarch64
-#define qstring_type qstring_type_aarch64
 #define ram_block_add ram_block_add_aarch64
 #define ram_size ram_size_aarch64
 #define range_compare range_compare_aarch64
@@ -2619,7 +2251,6 @@
 #define ranges_can_merge ranges_can_merge_aarch64
 #define raw_read raw_read_aarch64
 #define raw_write raw_write_aarch64
-#define rcon rcon_aarch64
 #define read_raw_cp_reg read_raw_cp_reg_aarch64
 #define recip_estimate recip_estimate_aarch64
 #define recip_sqrt_estimate recip_sqrt_estimate_aarch64
@@ -2627,7 +2258,6 @@
 #define register_multipage register_multipage_aarch64
 #define register_subpage register_subpage_aarch64
 #define register_tm_clones register_tm_clones_aarch64
-#define register_types_object register_types_object_aarch64
 #define regnames regnames_aarch64
 #define render_memory_region render_memory_region_aarch64
 #define reset_all_temps reset_all_temps_aarch64
@@ -2678,15 +2308,6 @@
 #define shortShift192Left shortShift192Left_aarch64
 #define simple_mpu_ap_bits simple_mpu_ap_bits_aarch64
 #define size_code_gen_buffer size_code_gen_buffer_aarch64
-#define slow_bitmap_and slow_bitmap_and_aarch64
-#define slow_bitmap_andnot slow_bitmap_andnot_aarch64
-#define slow_bitmap_complement slow_bitmap_complement_aarch64
-#define slow_bitmap_empty slow_bitmap_empty_aarch64
-#define slow_bitmap_equal slow_bitmap_equal_aarch64
-#define slow_bitmap_full slow_bitmap_full_aarch64
-#define slow_bitmap_intersects slow_bitmap_intersects_aarch64
-#define slow_bitmap_or slow_bitmap_or_aarch64
-#define slow_bitmap_xor slow_bitmap_xor_aarch64
 #define softmmu_lock_user softmmu_lock_user_aarch64
 #define softmmu_lock_user_string softmmu_lock_user_string_aarch64
 #define softmmu_tget32 softmmu_tget32_aarch64
@@ -2699,7 +2320,6 @@
 #define spin_unlock spin_unlock_aarch64
 #define spsel_read spsel_read_aarch64
 #define spsel_write spsel_write_aarch64
-#define start_list start_list_aarch64
 #define stb_p stb_p_aarch64
 #define stb_phys stb_phys_aarch64
 #define stl_be_p stl_be_p_aarch64
@@ -2720,22 +2340,7 @@
 #define stq_le_p stq_le_p_aarch64
 #define stq_le_phys stq_le_phys_aarch64
 #define stq_phys stq_phys_aarch64
-#define string_input_get_visitor string_input_get_visitor_aarch64
-#define string_input_visitor_cleanup string_input_visitor_cleanup_aarch64
-#define string_input_visitor_new string_input_visitor_new_aarch64
-#define string_output_append string_output_append_aarch64
-#define string_output_append_range string_output_append_range_aarch64
-#define string_output_get_string string_output_get_string_aarch64
-#define string_output_get_visitor string_output_get_visitor_aarch64
-#define string_output_set string_output_set_aarch64
-#define string_output_visitor_cleanup string_output_visitor_cleanup_aarch64
-#define string_output_visitor_new string_output_visitor_new_aarch64
-#define stristart stristart_aarch64
 #define strongarm_cp_reginfo strongarm_cp_reginfo_aarch64
-#define strpadcpy strpadcpy_aarch64
-#define strstart strstart_aarch64
-#define strtosz strtosz_aarch64
-#define strtosz_suffix strtosz_suffix_aarch64
 #define stw_be_p stw_be_p_aarch64
 #define stw_be_phys stw_be_phys_aarch64
 #define stw_he_p stw_he_p_aarch64
@@ -2759,7 +2364,6 @@
 #define subpage_read subpage_read_aarch64
 #define subpage_register subpage_register_aarch64
 #define subpage_write subpage_write_aarch64
-#define suffix_mul suffix_mul_aarch64
 #define swap_commutative swap_commutative_aarch64
 #define swap_commutative2 swap_commutative2_aarch64
 #define switch_mode switch_mode_aarch64
@@ -2801,6 +2405,7 @@
 #define tb_hash_remove tb_hash_remove_aarch64
 #define tb_invalidate_phys_addr tb_invalidate_phys_addr_aarch64
 #define tb_invalidate_phys_page_range tb_invalidate_phys_page_range_aarch64
+#define tb_invalidate_pc_range tb_invalidate_pc_range_aarch64
 #define tb_invalidate_phys_range tb_invalidate_phys_range_aarch64
 #define tb_jmp_cache_hash_func tb_jmp_cache_hash_func_aarch64
 #define tb_jmp_cache_hash_page tb_jmp_cache_hash_page_aarch64
@@ -2811,8 +2416,6 @@
 #define tb_phys_invalidate tb_phys_invalidate_aarch64
 #define tb_reset_jump tb_reset_jump_aarch64
 #define tb_set_jmp_target tb_set_jmp_target_aarch64
-#define tcg_accel_class_init tcg_accel_class_init_aarch64
-#define tcg_accel_type tcg_accel_type_aarch64
 #define tcg_add_param_i32 tcg_add_param_i32_aarch64
 #define tcg_add_param_i64 tcg_add_param_i64_aarch64
 #define tcg_add_target_add_op_defs tcg_add_target_add_op_defs_aarch64
@@ -2944,7 +2547,6 @@
 #define tcg_global_reg_new_i64 tcg_global_reg_new_i64_aarch64
 #define tcg_global_reg_new_internal tcg_global_reg_new_internal_aarch64
 #define tcg_handle_interrupt tcg_handle_interrupt_aarch64
-#define tcg_init tcg_init_aarch64
 #define tcg_invert_cond tcg_invert_cond_aarch64
 #define tcg_la_bb_end tcg_la_bb_end_aarch64
 #define tcg_la_br_end tcg_la_br_end_aarch64
@@ -3040,7 +2642,6 @@
 #define tcg_temp_new_internal tcg_temp_new_internal_aarch64
 #define tcg_temp_new_internal_i32 tcg_temp_new_internal_i32_aarch64
 #define tcg_temp_new_internal_i64 tcg_temp_new_internal_i64_aarch64
-#define tdb_hash tdb_hash_aarch64
 #define teecr_write teecr_write_aarch64
 #define teehbr_access teehbr_access_aarch64
 #define temp_allocate_frame temp_allocate_frame_aarch64
@@ -3076,34 +2677,16 @@
 #define tlb_set_dirty1 tlb_set_dirty1_aarch64
 #define tlb_unprotect_code_phys tlb_unprotect_code_phys_aarch64
 #define tlb_vaddr_to_host tlb_vaddr_to_host_aarch64
-#define to_json to_json_aarch64
-#define to_json_dict_iter to_json_dict_iter_aarch64
-#define to_json_list_iter to_json_list_iter_aarch64
 #define token_get_type token_get_type_aarch64
 #define token_get_value token_get_value_aarch64
 #define token_is_escape token_is_escape_aarch64
 #define token_is_keyword token_is_keyword_aarch64
 #define token_is_operator token_is_operator_aarch64
 #define tokens_append_from_iter tokens_append_from_iter_aarch64
-#define to_qiv to_qiv_aarch64
-#define to_qov to_qov_aarch64
 #define tosa_init tosa_init_aarch64
 #define tosa_machine_init tosa_machine_init_aarch64
 #define tswap32 tswap32_aarch64
 #define tswap64 tswap64_aarch64
-#define type_class_get_size type_class_get_size_aarch64
-#define type_get_by_name type_get_by_name_aarch64
-#define type_get_parent type_get_parent_aarch64
-#define type_has_parent type_has_parent_aarch64
-#define type_initialize type_initialize_aarch64
-#define type_initialize_interface type_initialize_interface_aarch64
-#define type_is_ancestor type_is_ancestor_aarch64
-#define type_new type_new_aarch64
-#define type_object_get_size type_object_get_size_aarch64
-#define type_register_internal type_register_internal_aarch64
-#define type_table_add type_table_add_aarch64
-#define type_table_get type_table_get_aarch64
-#define type_table_lookup type_table_lookup_aarch64
 #define uint16_to_float32 uint16_to_float32_aarch64
 #define uint16_to_float64 uint16_to_float64_aarch64
 #define uint32_to_float32 uint32_to_float32_aarch64
@@ -3111,8 +2694,6 @@
 #define uint64_to_float128 uint64_to_float128_aarch64
 #define uint64_to_float32 uint64_to_float32_aarch64
 #define uint64_to_float64 uint64_to_float64_aarch64
-#define uleb128_decode_small uleb128_decode_small_aarch64
-#define uleb128_encode_small uleb128_encode_small_aarch64
 #define unassigned_io_ops unassigned_io_ops_aarch64
 #define unassigned_io_read unassigned_io_read_aarch64
 #define unassigned_io_write unassigned_io_write_aarch64
@@ -3142,17 +2723,6 @@
 #define vfp_set_fpcr vfp_set_fpcr_aarch64
 #define vfp_set_fpscr vfp_set_fpscr_aarch64
 #define vfp_set_fpsr vfp_set_fpsr_aarch64
-#define visit_end_implicit_struct visit_end_implicit_struct_aarch64
-#define visit_end_list visit_end_list_aarch64
-#define visit_end_struct visit_end_struct_aarch64
-#define visit_end_union visit_end_union_aarch64
-#define visit_get_next_type visit_get_next_type_aarch64
-#define visit_next_list visit_next_list_aarch64
-#define visit_optional visit_optional_aarch64
-#define visit_start_implicit_struct visit_start_implicit_struct_aarch64
-#define visit_start_list visit_start_list_aarch64
-#define visit_start_struct visit_start_struct_aarch64
-#define visit_start_union visit_start_union_aarch64
 #define vmsa_cp_reginfo vmsa_cp_reginfo_aarch64
 #define vmsa_tcr_el1_write vmsa_tcr_el1_write_aarch64
 #define vmsa_ttbcr_raw_write vmsa_ttbcr_raw_write_aarch64
@@ -35,7 +35,6 @@
 // use default size for TCG translated block
 #define TCG_TB_SIZE 0
 
-static bool tcg_allowed = true;
 static int tcg_init(MachineState *ms);
 static AccelClass *accel_find(struct uc_struct *uc, const char *opt_name);
 static int accel_init_machine(AccelClass *acc, MachineState *ms);
@@ -93,7 +92,9 @@ static void tcg_accel_class_init(struct uc_struct *uc, ObjectClass *oc, void *da
     AccelClass *ac = ACCEL_CLASS(uc, oc);
     ac->name = "tcg";
     ac->init_machine = tcg_init;
-    ac->allowed = &tcg_allowed;
+    /* ac->allowed stays NULL: a process-wide flag behind a shared class
+       would be written by every engine (tcg_enabled() checks the
+       per-engine code buffer instead). */
 }
 
 /* Lookup AccelClass from opt_name. Returns NULL if not found */
@@ -112,11 +113,9 @@ static int accel_init_machine(AccelClass *acc, MachineState *ms)
     AccelState *accel = ACCEL(ms->uc, object_new(ms->uc, cname));
     int ret;
     ms->accelerator = accel;
-    *(acc->allowed) = true;
     ret = acc->init_machine(ms);
     if (ret < 0) {
         ms->accelerator = NULL;
-        *(acc->allowed) = false;
         object_unref(ms->uc, OBJECT(accel));
     }
     return ret;
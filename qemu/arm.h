@@ -10,13 +10,38 @@
 #define tb_invalidate_phys_page_fast tb_invalidate_phys_page_fast_arm
 #define phys_mem_clean phys_mem_clean_arm
 #define tb_cleanup tb_cleanup_arm
+#define page_tree_reclaim page_tree_reclaim_arm
+#define tb_profile_flush tb_profile_flush_arm
 #define memory_map memory_map_arm
+#define memory_snapshot_ram memory_snapshot_ram_arm
+#define memory_restore_ram memory_restore_ram_arm
+#define memory_snapshot_free_ram memory_snapshot_free_ram_arm
+#define memory_ckpt_delta memory_ckpt_delta_arm
+#define memory_ckpt_apply memory_ckpt_apply_arm
+#define memory_ckpt_delta_free memory_ckpt_delta_free_arm
+#define qemu_ram_make_shareable qemu_ram_make_shareable_arm
+#define qemu_ram_set_owned qemu_ram_set_owned_arm
 #define memory_map_ptr memory_map_ptr_arm
+#define memory_map_io memory_map_io_arm
 #define memory_unmap memory_unmap_arm
+#define memory_decommit memory_decommit_arm
+#define memory_dirty_query memory_dirty_query_arm
+#define memory_dirty_reset memory_dirty_reset_arm
 #define memory_free memory_free_arm
 #define helper_raise_exception helper_raise_exception_arm
 #define tcg_enabled tcg_enabled_arm
 #define tcg_exec_init tcg_exec_init_arm
+#define tcg_buffer_resize tcg_buffer_resize_arm
+#define tb_cache_save tb_cache_save_arm
+#define tb_cache_load tb_cache_load_arm
+#define tb_prewarm tb_prewarm_arm
+#define tb_meta_get tb_meta_get_arm
+#define tb_readahead tb_readahead_arm
+#define tb_stats tb_stats_arm
+#define mem_stats mem_stats_arm
+#define tb_crosspage_link tb_crosspage_link_arm
+#define tb_crosspage_unchain tb_crosspage_unchain_arm
+#define tb_superblock tb_superblock_arm
 #define memory_register_types memory_register_types_arm
 #define cpu_exec_init_all cpu_exec_init_all_arm
 #define vm_start vm_start_arm
@@ -37,9 +62,6 @@
 #define aarch64_banked_spsr_index aarch64_banked_spsr_index_arm
 #define aarch64_restore_sp aarch64_restore_sp_arm
 #define aarch64_save_sp aarch64_save_sp_arm
-#define accel_find accel_find_arm
-#define accel_init_machine accel_init_machine_arm
-#define accel_type accel_type_arm
 #define access_with_adjusted_size access_with_adjusted_size_arm
 #define add128 add128_arm
 #define add16_sat add16_sat_arm
@@ -81,16 +103,9 @@
 #define addrrange_make addrrange_make_arm
 #define addrrange_shift addrrange_shift_arm
 #define adjust_endianness adjust_endianness_arm
-#define AES_cbc_encrypt AES_cbc_encrypt_arm
-#define AES_decrypt AES_decrypt_arm
-#define AES_encrypt AES_encrypt_arm
 #define AES_imc AES_imc_arm
-#define AES_set_decrypt_key AES_set_decrypt_key_arm
-#define AES_set_encrypt_key AES_set_encrypt_key_arm
 #define all_helpers all_helpers_arm
 #define alloc_code_gen_buffer alloc_code_gen_buffer_arm
-#define alloc_entry alloc_entry_arm
-#define always_true always_true_arm
 #define arm1026_initfn arm1026_initfn_arm
 #define arm1136_initfn arm1136_initfn_arm
 #define arm1136_r2_initfn arm1136_r2_initfn_arm
@@ -148,6 +163,7 @@
 #define tlb_fill tlb_fill_arm
 #define tlb_flush tlb_flush_arm
 #define tlb_flush_page tlb_flush_page_arm
+#define tlb_flush_range tlb_flush_range_arm
 #define tlb_set_page tlb_set_page_arm
 #define arm_translate_init arm_translate_init_arm
 #define arm_v7m_class_init arm_v7m_class_init_arm
@@ -156,21 +172,15 @@
 #define ats_write ats_write_arm
 #define bad_mode_switch bad_mode_switch_arm
 #define bank_number bank_number_arm
-#define bitmap_find_next_zero_area bitmap_find_next_zero_area_arm
 #define bitmap_zero_extend bitmap_zero_extend_arm
 #define bp_wp_matches bp_wp_matches_arm
 #define breakpoint_invalidate breakpoint_invalidate_arm
 #define build_page_bitmap build_page_bitmap_arm
-#define bus_add_child bus_add_child_arm
-#define bus_class_init bus_class_init_arm
-#define bus_info bus_info_arm
-#define bus_unparent bus_unparent_arm
 #define cache_block_ops_cp_reginfo cache_block_ops_cp_reginfo_arm
 #define cache_dirty_status_cp_reginfo cache_dirty_status_cp_reginfo_arm
 #define cache_test_clean_cp_reginfo cache_test_clean_cp_reginfo_arm
 #define call_recip_estimate call_recip_estimate_arm
 #define can_merge can_merge_arm
-#define capacity_increase capacity_increase_arm
 #define ccsidr_read ccsidr_read_arm
 #define check_ap check_ap_arm
 #define check_breakpoints check_breakpoints_arm
@@ -186,12 +196,7 @@
 #define commonNaNToFloat32 commonNaNToFloat32_arm
 #define commonNaNToFloat64 commonNaNToFloat64_arm
 #define commonNaNToFloatx80 commonNaNToFloatx80_arm
-#define compute_abs_deadline compute_abs_deadline_arm
 #define cond_name cond_name_arm
-#define configure_accelerator configure_accelerator_arm
-#define container_get container_get_arm
-#define container_info container_info_arm
-#define container_register_types container_register_types_arm
 #define contextidr_write contextidr_write_arm
 #define core_log_global_start core_log_global_start_arm
 #define core_log_global_stop core_log_global_stop_arm
@@ -228,23 +233,9 @@
 #define cpu_breakpoint_remove_by_ref cpu_breakpoint_remove_by_ref_arm
 #define cpu_can_do_io cpu_can_do_io_arm
 #define cpu_can_run cpu_can_run_arm
-#define cpu_class_init cpu_class_init_arm
-#define cpu_common_class_by_name cpu_common_class_by_name_arm
-#define cpu_common_exec_interrupt cpu_common_exec_interrupt_arm
-#define cpu_common_get_arch_id cpu_common_get_arch_id_arm
-#define cpu_common_get_memory_mapping cpu_common_get_memory_mapping_arm
-#define cpu_common_get_paging_enabled cpu_common_get_paging_enabled_arm
-#define cpu_common_has_work cpu_common_has_work_arm
-#define cpu_common_initfn cpu_common_initfn_arm
-#define cpu_common_noop cpu_common_noop_arm
-#define cpu_common_parse_features cpu_common_parse_features_arm
-#define cpu_common_realizefn cpu_common_realizefn_arm
-#define cpu_common_reset cpu_common_reset_arm
-#define cpu_dump_statistics cpu_dump_statistics_arm
 #define cpu_exec_init cpu_exec_init_arm
 #define cpu_flush_icache_range cpu_flush_icache_range_arm
 #define cpu_gen_init cpu_gen_init_arm
-#define cpu_get_clock cpu_get_clock_arm
 #define cpu_get_real_ticks cpu_get_real_ticks_arm
 #define cpu_get_tb_cpu_state cpu_get_tb_cpu_state_arm
 #define cpu_handle_debug_exception cpu_handle_debug_exception_arm
@@ -281,7 +272,6 @@
 #define cpu_physical_memory_write_rom cpu_physical_memory_write_rom_arm
 #define cpu_physical_memory_write_rom_internal cpu_physical_memory_write_rom_internal_arm
 #define cpu_register cpu_register_arm
-#define cpu_register_types cpu_register_types_arm
 #define cpu_restore_state cpu_restore_state_arm
 #define cpu_restore_state_from_tb cpu_restore_state_from_tb_arm
 #define cpu_single_step cpu_single_step_arm
@@ -290,14 +280,12 @@
 #define cpu_to_be64 cpu_to_be64_arm
 #define cpu_to_le32 cpu_to_le32_arm
 #define cpu_to_le64 cpu_to_le64_arm
-#define cpu_type_info cpu_type_info_arm
 #define cpu_unassigned_access cpu_unassigned_access_arm
 #define cpu_watchpoint_address_matches cpu_watchpoint_address_matches_arm
 #define cpu_watchpoint_insert cpu_watchpoint_insert_arm
 #define cpu_watchpoint_remove cpu_watchpoint_remove_arm
 #define cpu_watchpoint_remove_all cpu_watchpoint_remove_all_arm
 #define cpu_watchpoint_remove_by_ref cpu_watchpoint_remove_by_ref_arm
-#define crc32c_table crc32c_table_arm
 #define create_new_memory_mapping create_new_memory_mapping_arm
 #define csselr_write csselr_write_arm
 #define cto32 cto32_arm
@@ -320,15 +308,6 @@
 #define deposit32 deposit32_arm
 #define deposit64 deposit64_arm
 #define deregister_tm_clones deregister_tm_clones_arm
-#define device_class_base_init device_class_base_init_arm
-#define device_class_init device_class_init_arm
-#define device_finalize device_finalize_arm
-#define device_get_realized device_get_realized_arm
-#define device_initfn device_initfn_arm
-#define device_post_init device_post_init_arm
-#define device_reset device_reset_arm
-#define device_set_realized device_set_realized_arm
-#define device_type_info device_type_info_arm
 #define disas_arm_insn disas_arm_insn_arm
 #define disas_coproc_insn disas_coproc_insn_arm
 #define disas_dsp_insn disas_dsp_insn_arm
@@ -356,19 +335,12 @@
 #define do_usat do_usat_arm
 #define do_v7m_exception_exit do_v7m_exception_exit_arm
 #define dummy_c15_cp_reginfo dummy_c15_cp_reginfo_arm
-#define dummy_func dummy_func_arm
 #define dummy_section dummy_section_arm
 #define _DYNAMIC _DYNAMIC_arm
 #define _edata _edata_arm
 #define _end _end_arm
-#define end_list end_list_arm
 #define eq128 eq128_arm
 #define ErrorClass_lookup ErrorClass_lookup_arm
-#define error_copy error_copy_arm
-#define error_exit error_exit_arm
-#define error_get_class error_get_class_arm
-#define error_get_pretty error_get_pretty_arm
-#define error_setg_file_open error_setg_file_open_arm
 #define estimateDiv128To64 estimateDiv128To64_arm
 #define estimateSqrt32 estimateSqrt32_arm
 #define excnames excnames_arm
@@ -393,13 +365,10 @@
 #define extractFloatx80Exp extractFloatx80Exp_arm
 #define extractFloatx80Frac extractFloatx80Frac_arm
 #define extractFloatx80Sign extractFloatx80Sign_arm
-#define fcntl_setfl fcntl_setfl_arm
 #define fcse_write fcse_write_arm
 #define find_better_copy find_better_copy_arm
-#define find_default_machine find_default_machine_arm
 #define find_desc_by_name find_desc_by_name_arm
 #define find_first_bit find_first_bit_arm
-#define find_last_bit find_last_bit_arm
 #define find_paging_enabled_cpu find_paging_enabled_cpu_arm
 #define find_ram_block find_ram_block_arm
 #define find_ram_offset find_ram_offset_arm
@@ -603,13 +572,9 @@
 #define floatx80_unordered floatx80_unordered_arm
 #define floatx80_unordered_quiet floatx80_unordered_quiet_arm
 #define flush_icache_range flush_icache_range_arm
-#define format_string format_string_arm
 #define fp_decode_rm fp_decode_rm_arm
 #define frame_dummy frame_dummy_arm
-#define free_range free_range_arm
 #define fstat64 fstat64_arm
-#define futex_wait futex_wait_arm
-#define futex_wake futex_wake_arm
 #define gen_aa32_ld16s gen_aa32_ld16s_arm
 #define gen_aa32_ld16u gen_aa32_ld16u_arm
 #define gen_aa32_ld32u gen_aa32_ld32u_arm
@@ -1314,8 +1279,6 @@
 #define get_level1_table_address get_level1_table_address_arm
 #define get_mem_index get_mem_index_arm
 #define get_next_param_value get_next_param_value_arm
-#define get_opt_name get_opt_name_arm
-#define get_opt_value get_opt_value_arm
 #define get_page_addr_code get_page_addr_code_arm
 #define get_param_value get_param_value_arm
 #define get_phys_addr get_phys_addr_arm
@@ -1348,7 +1311,6 @@
 #define handle_vminmaxnm handle_vminmaxnm_arm
 #define handle_vrint handle_vrint_arm
 #define handle_vsel handle_vsel_arm
-#define has_help_option has_help_option_arm
 #define have_bmi1 have_bmi1_arm
 #define have_bmi2 have_bmi2_arm
 #define hcr_write hcr_write_arm
@@ -1904,7 +1866,6 @@
 #define _init _init_arm
 #define init_cpreg_list init_cpreg_list_arm
 #define init_lists init_lists_arm
-#define input_type_enum input_type_enum_arm
 #define int128_2_64 int128_2_64_arm
 #define int128_add int128_add_arm
 #define int128_addto int128_addto_arm
@@ -1949,7 +1910,6 @@
 #define io_writeq io_writeq_arm
 #define io_writew io_writew_arm
 #define is_a64 is_a64_arm
-#define is_help_option is_help_option_arm
 #define is_power_of_2 is_power_of_2_arm
 #define isr_read isr_read_arm
 #define is_valid_option_list is_valid_option_list_arm
@@ -1959,19 +1919,6 @@
 #define iwmmxt_store_reg iwmmxt_store_reg_arm
 #define __jit_debug_descriptor __jit_debug_descriptor_arm
 #define __jit_debug_register_code __jit_debug_register_code_arm
-#define json_lexer json_lexer_arm
-#define json_lexer_destroy json_lexer_destroy_arm
-#define json_lexer_feed json_lexer_feed_arm
-#define json_lexer_feed_char json_lexer_feed_char_arm
-#define json_lexer_flush json_lexer_flush_arm
-#define json_lexer_init json_lexer_init_arm
-#define json_message_parser_destroy json_message_parser_destroy_arm
-#define json_message_parser_feed json_message_parser_feed_arm
-#define json_message_parser_flush json_message_parser_flush_arm
-#define json_message_parser_init json_message_parser_init_arm
-#define json_message_process_token json_message_process_token_arm
-#define json_parser_parse json_parser_parse_arm
-#define json_parser_parse_err json_parser_parse_err_arm
 #define kvm_to_cpreg_id kvm_to_cpreg_id_arm
 #define last_ram_offset last_ram_offset_arm
 #define ldl_be_p ldl_be_p_arm
@@ -2007,11 +1954,6 @@
 #define log_cpu_state log_cpu_state_arm
 #define lpae_cp_reginfo lpae_cp_reginfo_arm
 #define lt128 lt128_arm
-#define machine_class_init machine_class_init_arm
-#define machine_finalize machine_finalize_arm
-#define machine_info machine_info_arm
-#define machine_initfn machine_initfn_arm
-#define machine_register_types machine_register_types_arm
 #define machvirt_init machvirt_init_arm
 #define machvirt_machine_init machvirt_machine_init_arm
 #define maj maj_arm
@@ -2111,10 +2053,7 @@
 #define memory_region_write_accessor memory_region_write_accessor_arm
 #define memory_region_wrong_endianness memory_region_wrong_endianness_arm
 #define memory_try_enable_merging memory_try_enable_merging_arm
-#define mktimegm mktimegm_arm
-#define module_call_init module_call_init_arm
 #define module_load module_load_arm
-#define mod_utf8_codepoint mod_utf8_codepoint_arm
 #define mpidr_cp_reginfo mpidr_cp_reginfo_arm
 #define mpidr_read mpidr_read_arm
 #define msr_mask msr_mask_arm
@@ -2135,7 +2074,6 @@
 #define neon_store_reg64 neon_store_reg64_arm
 #define neon_store_scratch neon_store_scratch_arm
 #define new_ldst_label new_ldst_label_arm
-#define next_list next_list_arm
 #define normalizeFloat128Subnormal normalizeFloat128Subnormal_arm
 #define normalizeFloat16Subnormal normalizeFloat16Subnormal_arm
 #define normalizeFloat32Subnormal normalizeFloat32Subnormal_arm
@@ -2148,61 +2086,6 @@
 #define not_v6_cp_reginfo not_v6_cp_reginfo_arm
 #define not_v7_cp_reginfo not_v7_cp_reginfo_arm
 #define not_v8_cp_reginfo not_v8_cp_reginfo_arm
-#define object_child_foreach object_child_foreach_arm
-#define object_class_foreach object_class_foreach_arm
-#define object_class_foreach_tramp object_class_foreach_tramp_arm
-#define object_class_get_list object_class_get_list_arm
-#define object_class_get_list_tramp object_class_get_list_tramp_arm
-#define object_class_get_parent object_class_get_parent_arm
-#define object_deinit object_deinit_arm
-#define object_dynamic_cast object_dynamic_cast_arm
-#define object_finalize object_finalize_arm
-#define object_finalize_child_property object_finalize_child_property_arm
-#define object_get_child_property object_get_child_property_arm
-#define object_get_link_property object_get_link_property_arm
-#define object_get_root object_get_root_arm
-#define object_initialize_with_type object_initialize_with_type_arm
-#define object_init_with_type object_init_with_type_arm
-#define object_instance_init object_instance_init_arm
-#define object_new_with_type object_new_with_type_arm
-#define object_post_init_with_type object_post_init_with_type_arm
-#define object_property_add_alias object_property_add_alias_arm
-#define object_property_add_link object_property_add_link_arm
-#define object_property_add_uint16_ptr object_property_add_uint16_ptr_arm
-#define object_property_add_uint32_ptr object_property_add_uint32_ptr_arm
-#define object_property_add_uint64_ptr object_property_add_uint64_ptr_arm
-#define object_property_add_uint8_ptr object_property_add_uint8_ptr_arm
-#define object_property_allow_set_link object_property_allow_set_link_arm
-#define object_property_del object_property_del_arm
-#define object_property_del_all object_property_del_all_arm
-#define object_property_del_child object_property_del_child_arm
-#define object_property_find object_property_find_arm
-#define object_property_get object_property_get_arm
-#define object_property_get_bool object_property_get_bool_arm
-#define object_property_get_enum object_property_get_enum_arm
-#define object_property_get_int object_property_get_int_arm
-#define object_property_get_link object_property_get_link_arm
-#define object_property_get_qobject object_property_get_qobject_arm
-#define object_property_get_str object_property_get_str_arm
-#define object_property_get_type object_property_get_type_arm
-#define object_property_get_uint16List object_property_get_uint16List_arm
-#define object_property_is_child object_property_is_child_arm
-#define object_property_print object_property_print_arm
-#define object_property_set object_property_set_arm
-#define object_property_set_description object_property_set_description_arm
-#define object_property_set_link object_property_set_link_arm
-#define object_property_set_qobject object_property_set_qobject_arm
-#define object_release_link_property object_release_link_property_arm
-#define object_resolve_abs_path object_resolve_abs_path_arm
-#define object_resolve_child_property object_resolve_child_property_arm
-#define object_resolve_link object_resolve_link_arm
-#define object_resolve_link_property object_resolve_link_property_arm
-#define object_resolve_partial_path object_resolve_partial_path_arm
-#define object_resolve_path object_resolve_path_arm
-#define object_resolve_path_component object_resolve_path_component_arm
-#define object_resolve_path_type object_resolve_path_type_arm
-#define object_set_link_property object_set_link_property_arm
-#define object_unparent object_unparent_arm
 #define omap_cachemaint_write omap_cachemaint_write_arm
 #define omap_cp_reginfo omap_cp_reginfo_arm
 #define omap_threadid_write omap_threadid_write_arm
@@ -2216,7 +2099,6 @@
 #define opts_do_parse opts_do_parse_arm
 #define opt_set opt_set_arm
 #define opts_parse opts_parse_arm
-#define output_type_enum output_type_enum_arm
 #define packFloat128 packFloat128_arm
 #define packFloat16 packFloat16_arm
 #define packFloat32 packFloat32_arm
@@ -2236,10 +2118,6 @@
 #define parse_keyword parse_keyword_arm
 #define parse_literal parse_literal_arm
 #define parse_object parse_object_arm
-#define parse_optional parse_optional_arm
-#define parse_option_bool parse_option_bool_arm
-#define parse_option_number parse_option_number_arm
-#define parse_option_size parse_option_size_arm
 #define parse_pair parse_pair_arm
 #define parser_context_free parser_context_free_arm
 #define parser_context_new parser_context_new_arm
@@ -2247,14 +2125,6 @@
 #define parser_context_pop_token parser_context_pop_token_arm
 #define parser_context_restore parser_context_restore_arm
 #define parser_context_save parser_context_save_arm
-#define parse_str parse_str_arm
-#define parse_type_bool parse_type_bool_arm
-#define parse_type_int parse_type_int_arm
-#define parse_type_number parse_type_number_arm
-#define parse_type_size parse_type_size_arm
-#define parse_type_str parse_type_str_arm
-#define parse_uint parse_uint_arm
-#define parse_uint_full parse_uint_full_arm
 #define parse_value parse_value_arm
 #define par_write par_write_arm
 #define patch_reloc patch_reloc_arm
@@ -2292,32 +2162,12 @@
 #define pmsav5_insn_ap_write pmsav5_insn_ap_write_arm
 #define pmuserenr_write pmuserenr_write_arm
 #define pmxevtyper_write pmxevtyper_write_arm
-#define pow2floor pow2floor_arm
-#define print_type_bool print_type_bool_arm
-#define print_type_int print_type_int_arm
-#define print_type_number print_type_number_arm
-#define print_type_size print_type_size_arm
-#define print_type_str print_type_str_arm
 #define propagateFloat128NaN propagateFloat128NaN_arm
 #define propagateFloat32MulAddNaN propagateFloat32MulAddNaN_arm
 #define propagateFloat32NaN propagateFloat32NaN_arm
 #define propagateFloat64MulAddNaN propagateFloat64MulAddNaN_arm
 #define propagateFloat64NaN propagateFloat64NaN_arm
 #define propagateFloatx80NaN propagateFloatx80NaN_arm
-#define property_get_alias property_get_alias_arm
-#define property_get_bool property_get_bool_arm
-#define property_get_str property_get_str_arm
-#define property_get_uint16_ptr property_get_uint16_ptr_arm
-#define property_get_uint32_ptr property_get_uint32_ptr_arm
-#define property_get_uint64_ptr property_get_uint64_ptr_arm
-#define property_get_uint8_ptr property_get_uint8_ptr_arm
-#define property_release_alias property_release_alias_arm
-#define property_release_bool property_release_bool_arm
-#define property_release_str property_release_str_arm
-#define property_resolve_alias property_resolve_alias_arm
-#define property_set_alias property_set_alias_arm
-#define property_set_bool property_set_bool_arm
-#define property_set_str property_set_str_arm
 #define pstate_read pstate_read_arm
 #define pstate_write pstate_write_arm
 #define pxa250_initfn pxa250_initfn_arm
@@ -2331,25 +2181,6 @@
 #define pxa270b1_initfn pxa270b1_initfn_arm
 #define pxa270c0_initfn pxa270c0_initfn_arm
 #define pxa270c5_initfn pxa270c5_initfn_arm
-#define qapi_dealloc_end_implicit_struct qapi_dealloc_end_implicit_struct_arm
-#define qapi_dealloc_end_list qapi_dealloc_end_list_arm
-#define qapi_dealloc_end_struct qapi_dealloc_end_struct_arm
-#define qapi_dealloc_get_visitor qapi_dealloc_get_visitor_arm
-#define qapi_dealloc_next_list qapi_dealloc_next_list_arm
-#define qapi_dealloc_pop qapi_dealloc_pop_arm
-#define qapi_dealloc_push qapi_dealloc_push_arm
-#define qapi_dealloc_start_implicit_struct qapi_dealloc_start_implicit_struct_arm
-#define qapi_dealloc_start_list qapi_dealloc_start_list_arm
-#define qapi_dealloc_start_struct qapi_dealloc_start_struct_arm
-#define qapi_dealloc_start_union qapi_dealloc_start_union_arm
-#define qapi_dealloc_type_bool qapi_dealloc_type_bool_arm
-#define qapi_dealloc_type_enum qapi_dealloc_type_enum_arm
-#define qapi_dealloc_type_int qapi_dealloc_type_int_arm
-#define qapi_dealloc_type_number qapi_dealloc_type_number_arm
-#define qapi_dealloc_type_size qapi_dealloc_type_size_arm
-#define qapi_dealloc_type_str qapi_dealloc_type_str_arm
-#define qapi_dealloc_visitor_cleanup qapi_dealloc_visitor_cleanup_arm
-#define qapi_dealloc_visitor_new qapi_dealloc_visitor_new_arm
 #define qapi_free_boolList qapi_free_boolList_arm
 #define qapi_free_ErrorClassList qapi_free_ErrorClassList_arm
 #define qapi_free_int16List qapi_free_int16List_arm
@@ -2366,76 +2197,18 @@
 #define qapi_free_X86CPUFeatureWordInfo qapi_free_X86CPUFeatureWordInfo_arm
 #define qapi_free_X86CPUFeatureWordInfoList qapi_free_X86CPUFeatureWordInfoList_arm
 #define qapi_free_X86CPURegister32List qapi_free_X86CPURegister32List_arm
-#define qbool_destroy_obj qbool_destroy_obj_arm
-#define qbool_from_int qbool_from_int_arm
-#define qbool_get_int qbool_get_int_arm
-#define qbool_type qbool_type_arm
-#define qbus_create qbus_create_arm
-#define qbus_create_inplace qbus_create_inplace_arm
-#define qbus_finalize qbus_finalize_arm
-#define qbus_initfn qbus_initfn_arm
-#define qbus_realize qbus_realize_arm
-#define qdev_create qdev_create_arm
-#define qdev_get_type qdev_get_type_arm
-#define qdev_register_types qdev_register_types_arm
-#define qdev_set_parent_bus qdev_set_parent_bus_arm
-#define qdev_try_create qdev_try_create_arm
-#define qdict_add_key qdict_add_key_arm
-#define qdict_array_split qdict_array_split_arm
-#define qdict_clone_shallow qdict_clone_shallow_arm
-#define qdict_del qdict_del_arm
-#define qdict_destroy_obj qdict_destroy_obj_arm
-#define qdict_entry_key qdict_entry_key_arm
-#define qdict_entry_value qdict_entry_value_arm
-#define qdict_extract_subqdict qdict_extract_subqdict_arm
-#define qdict_find qdict_find_arm
-#define qdict_first qdict_first_arm
-#define qdict_flatten qdict_flatten_arm
-#define qdict_flatten_qdict qdict_flatten_qdict_arm
-#define qdict_flatten_qlist qdict_flatten_qlist_arm
-#define qdict_get qdict_get_arm
-#define qdict_get_bool qdict_get_bool_arm
-#define qdict_get_double qdict_get_double_arm
-#define qdict_get_int qdict_get_int_arm
-#define qdict_get_obj qdict_get_obj_arm
-#define qdict_get_qdict qdict_get_qdict_arm
-#define qdict_get_qlist qdict_get_qlist_arm
-#define qdict_get_str qdict_get_str_arm
-#define qdict_get_try_bool qdict_get_try_bool_arm
-#define qdict_get_try_int qdict_get_try_int_arm
-#define qdict_get_try_str qdict_get_try_str_arm
-#define qdict_haskey qdict_haskey_arm
-#define qdict_has_prefixed_entries qdict_has_prefixed_entries_arm
-#define qdict_iter qdict_iter_arm
-#define qdict_join qdict_join_arm
-#define qdict_new qdict_new_arm
-#define qdict_next qdict_next_arm
-#define qdict_next_entry qdict_next_entry_arm
-#define qdict_put_obj qdict_put_obj_arm
-#define qdict_size qdict_size_arm
-#define qdict_type qdict_type_arm
 #define qemu_clock_get_us qemu_clock_get_us_arm
-#define qemu_clock_ptr qemu_clock_ptr_arm
 #define qemu_clocks qemu_clocks_arm
-#define qemu_cond_destroy qemu_cond_destroy_arm
 #define qemu_cpu_is_self qemu_cpu_is_self_arm
-#define qemu_cpu_kick_thread qemu_cpu_kick_thread_arm
-#define qemu_daemon qemu_daemon_arm
-#define qemu_event_destroy qemu_event_destroy_arm
-#define qemu_event_init qemu_event_init_arm
-#define qemu_event_reset qemu_event_reset_arm
-#define qemu_event_set qemu_event_set_arm
-#define qemu_event_wait qemu_event_wait_arm
-#define qemu_fdatasync qemu_fdatasync_arm
 #define qemu_flush_coalesced_mmio_buffer qemu_flush_coalesced_mmio_buffer_arm
 #define qemu_get_cpu qemu_get_cpu_arm
 #define qemu_get_guest_memory_mapping qemu_get_guest_memory_mapping_arm
 #define qemu_get_guest_simple_memory_mapping qemu_get_guest_simple_memory_mapping_arm
-#define qemu_get_local_state_pathname qemu_get_local_state_pathname_arm
 #define qemu_get_ram_block qemu_get_ram_block_arm
 #define qemu_get_ram_block_host_ptr qemu_get_ram_block_host_ptr_arm
 #define qemu_get_ram_fd qemu_get_ram_fd_arm
 #define qemu_get_ram_ptr qemu_get_ram_ptr_arm
+#define qemu_ram_block_base qemu_ram_block_base_arm
 #define qemu_host_page_mask qemu_host_page_mask_arm
 #define qemu_host_page_size qemu_host_page_size_arm
 #define qemu_init_vcpu qemu_init_vcpu_arm
@@ -2445,55 +2218,8 @@
 #define qemu_log_flush qemu_log_flush_arm
 #define qemu_loglevel_mask qemu_loglevel_mask_arm
 #define qemu_log_vprintf qemu_log_vprintf_arm
-#define qemu_mutex_destroy qemu_mutex_destroy_arm
 #define qemu_mutex_lock_ramlist qemu_mutex_lock_ramlist_arm
-#define qemu_mutex_trylock qemu_mutex_trylock_arm
 #define qemu_mutex_unlock_ramlist qemu_mutex_unlock_ramlist_arm
-#define qemu_oom_check qemu_oom_check_arm
-#define qemu_opt_del qemu_opt_del_arm
-#define qemu_opt_del_all qemu_opt_del_all_arm
-#define qemu_opt_find qemu_opt_find_arm
-#define qemu_opt_foreach qemu_opt_foreach_arm
-#define qemu_opt_get qemu_opt_get_arm
-#define qemu_opt_get_bool qemu_opt_get_bool_arm
-#define qemu_opt_get_bool_del qemu_opt_get_bool_del_arm
-#define qemu_opt_get_bool_helper qemu_opt_get_bool_helper_arm
-#define qemu_opt_get_del qemu_opt_get_del_arm
-#define qemu_opt_get_number qemu_opt_get_number_arm
-#define qemu_opt_get_number_del qemu_opt_get_number_del_arm
-#define qemu_opt_get_number_helper qemu_opt_get_number_helper_arm
-#define qemu_opt_get_size qemu_opt_get_size_arm
-#define qemu_opt_get_size_del qemu_opt_get_size_del_arm
-#define qemu_opt_get_size_helper qemu_opt_get_size_helper_arm
-#define qemu_opt_has_help_opt qemu_opt_has_help_opt_arm
-#define qemu_opt_parse qemu_opt_parse_arm
-#define qemu_opts_absorb_qdict qemu_opts_absorb_qdict_arm
-#define qemu_opts_append qemu_opts_append_arm
-#define qemu_opts_create qemu_opts_create_arm
-#define qemu_opts_del qemu_opts_del_arm
-#define qemu_opts_do_parse qemu_opts_do_parse_arm
-#define qemu_opt_set qemu_opt_set_arm
-#define qemu_opt_set_bool qemu_opt_set_bool_arm
-#define qemu_opt_set_err qemu_opt_set_err_arm
-#define qemu_opt_set_number qemu_opt_set_number_arm
-#define qemu_opts_find qemu_opts_find_arm
-#define qemu_opts_foreach qemu_opts_foreach_arm
-#define qemu_opts_free qemu_opts_free_arm
-#define qemu_opts_from_qdict qemu_opts_from_qdict_arm
-#define qemu_opts_from_qdict_1 qemu_opts_from_qdict_1_arm
-#define qemu_opts_id qemu_opts_id_arm
-#define qemu_opts_parse qemu_opts_parse_arm
-#define qemu_opts_print qemu_opts_print_arm
-#define qemu_opts_print_help qemu_opts_print_help_arm
-#define qemu_opts_reset qemu_opts_reset_arm
-#define qemu_opts_set qemu_opts_set_arm
-#define qemu_opts_set_defaults qemu_opts_set_defaults_arm
-#define qemu_opts_set_id qemu_opts_set_id_arm
-#define qemu_opts_to_qdict qemu_opts_to_qdict_arm
-#define qemu_opts_validate qemu_opts_validate_arm
-#define qemu_opt_unset qemu_opt_unset_arm
-#define qemu_parse_fd qemu_parse_fd_arm
-#define qemu_pipe qemu_pipe_arm
 #define qemu_ram_addr_from_host qemu_ram_addr_from_host_arm
 #define qemu_ram_addr_from_host_nofail qemu_ram_addr_from_host_nofail_arm
 #define qemu_ram_alloc qemu_ram_alloc_arm
@@ -2506,110 +2232,16 @@
 #define qemu_ram_setup_dump qemu_ram_setup_dump_arm
 #define qemu_ram_unset_idstr qemu_ram_unset_idstr_arm
 #define qemu_real_host_page_size qemu_real_host_page_size_arm
-#define qemu_sem_destroy qemu_sem_destroy_arm
-#define qemu_sem_init qemu_sem_init_arm
-#define qemu_sem_post qemu_sem_post_arm
-#define qemu_sem_timedwait qemu_sem_timedwait_arm
-#define qemu_sem_wait qemu_sem_wait_arm
-#define qemu_set_cloexec qemu_set_cloexec_arm
-#define qemu_set_tty_echo qemu_set_tty_echo_arm
 #define qemu_st_helpers qemu_st_helpers_arm
-#define qemu_strnlen qemu_strnlen_arm
-#define qemu_strsep qemu_strsep_arm
 #define qemu_tcg_cpu_thread_fn qemu_tcg_cpu_thread_fn_arm
 #define qemu_tcg_init_vcpu qemu_tcg_init_vcpu_arm
-#define qemu_thread_exit qemu_thread_exit_arm
-#define qemu_try_memalign qemu_try_memalign_arm
-#define qentry_destroy qentry_destroy_arm
-#define qerror_human qerror_human_arm
-#define qerror_report qerror_report_arm
-#define qerror_report_err qerror_report_err_arm
-#define qfloat_destroy_obj qfloat_destroy_obj_arm
-#define qfloat_from_double qfloat_from_double_arm
-#define qfloat_get_double qfloat_get_double_arm
-#define qfloat_type qfloat_type_arm
-#define qint_destroy_obj qint_destroy_obj_arm
-#define qint_from_int qint_from_int_arm
-#define qint_get_int qint_get_int_arm
-#define qint_type qint_type_arm
-#define qlist_append_obj qlist_append_obj_arm
-#define qlist_copy qlist_copy_arm
-#define qlist_copy_elem qlist_copy_elem_arm
-#define qlist_destroy_obj qlist_destroy_obj_arm
-#define qlist_empty qlist_empty_arm
 #define qlist_entry_obj qlist_entry_obj_arm
 #define qlist_first qlist_first_arm
-#define qlist_iter qlist_iter_arm
-#define qlist_new qlist_new_arm
 #define qlist_next qlist_next_arm
-#define qlist_peek qlist_peek_arm
-#define qlist_pop qlist_pop_arm
-#define qlist_size qlist_size_arm
-#define qlist_size_iter qlist_size_iter_arm
-#define qlist_type qlist_type_arm
-#define qmp_input_end_implicit_struct qmp_input_end_implicit_struct_arm
-#define qmp_input_end_list qmp_input_end_list_arm
-#define qmp_input_end_struct qmp_input_end_struct_arm
-#define qmp_input_get_next_type qmp_input_get_next_type_arm
-#define qmp_input_get_object qmp_input_get_object_arm
-#define qmp_input_get_visitor qmp_input_get_visitor_arm
-#define qmp_input_next_list qmp_input_next_list_arm
-#define qmp_input_optional qmp_input_optional_arm
-#define qmp_input_pop qmp_input_pop_arm
-#define qmp_input_push qmp_input_push_arm
-#define qmp_input_start_implicit_struct qmp_input_start_implicit_struct_arm
-#define qmp_input_start_list qmp_input_start_list_arm
-#define qmp_input_start_struct qmp_input_start_struct_arm
-#define qmp_input_type_bool qmp_input_type_bool_arm
-#define qmp_input_type_int qmp_input_type_int_arm
-#define qmp_input_type_number qmp_input_type_number_arm
-#define qmp_input_type_str qmp_input_type_str_arm
-#define qmp_input_visitor_cleanup qmp_input_visitor_cleanup_arm
-#define qmp_input_visitor_new qmp_input_visitor_new_arm
-#define qmp_input_visitor_new_strict qmp_input_visitor_new_strict_arm
-#define qmp_output_add_obj qmp_output_add_obj_arm
-#define qmp_output_end_list qmp_output_end_list_arm
-#define qmp_output_end_struct qmp_output_end_struct_arm
-#define qmp_output_first qmp_output_first_arm
-#define qmp_output_get_qobject qmp_output_get_qobject_arm
-#define qmp_output_get_visitor qmp_output_get_visitor_arm
-#define qmp_output_last qmp_output_last_arm
-#define qmp_output_next_list qmp_output_next_list_arm
-#define qmp_output_pop qmp_output_pop_arm
-#define qmp_output_push_obj qmp_output_push_obj_arm
-#define qmp_output_start_list qmp_output_start_list_arm
-#define qmp_output_start_struct qmp_output_start_struct_arm
-#define qmp_output_type_bool qmp_output_type_bool_arm
-#define qmp_output_type_int qmp_output_type_int_arm
-#define qmp_output_type_number qmp_output_type_number_arm
-#define qmp_output_type_str qmp_output_type_str_arm
-#define qmp_output_visitor_cleanup qmp_output_visitor_cleanup_arm
-#define qmp_output_visitor_new qmp_output_visitor_new_arm
 #define qobject_decref qobject_decref_arm
-#define qobject_from_json qobject_from_json_arm
-#define qobject_from_jsonf qobject_from_jsonf_arm
-#define qobject_from_jsonv qobject_from_jsonv_arm
 #define qobject_incref qobject_incref_arm
-#define qobject_to_json qobject_to_json_arm
-#define qobject_to_json_pretty qobject_to_json_pretty_arm
-#define qobject_to_qbool qobject_to_qbool_arm
-#define qobject_to_qdict qobject_to_qdict_arm
-#define qobject_to_qfloat qobject_to_qfloat_arm
-#define qobject_to_qint qobject_to_qint_arm
-#define qobject_to_qlist qobject_to_qlist_arm
-#define qobject_to_qstring qobject_to_qstring_arm
 #define qobject_type qobject_type_arm
-#define qstring_append qstring_append_arm
-#define qstring_append_chr qstring_append_chr_arm
-#define qstring_append_int qstring_append_int_arm
-#define qstring_destroy_obj qstring_destroy_obj_arm
 #define qstring_from_escaped_str qstring_from_escaped_str_arm
-#define qstring_from_str qstring_from_str_arm
-#define qstring_from_substr qstring_from_substr_arm
-#define qstring_get_length qstring_get_length_arm
-#define qstring_get_str qstring_get_str_arm
-#define qstring_new qstring_new_arm
-#define qstring_type qstring_type_arm
 #define ram_block_add ram_block_add_arm
 #define ram_size ram_size_arm
 #define range_compare range_compare_arm
@@ -2619,7 +2251,6 @@
 #define ranges_can_merge ranges_can_merge_arm
 #define raw_read raw_read_arm
 #define raw_write raw_write_arm
-#define rcon rcon_arm
 #define read_raw_cp_reg read_raw_cp_reg_arm
 #define recip_estimate recip_estimate_arm
 #define recip_sqrt_estimate recip_sqrt_estimate_arm
@@ -2627,7 +2258,6 @@
 #define register_multipage register_multipage_arm
 #define register_subpage register_subpage_arm
 #define register_tm_clones register_tm_clones_arm
-#define register_types_object register_types_object_arm
 #define regnames regnames_arm
 #define render_memory_region render_memory_region_arm
 #define reset_all_temps reset_all_temps_arm
@@ -2678,15 +2308,6 @@
 #define shortShift192Left shortShift192Left_arm
 #define simple_mpu_ap_bits simple_mpu_ap_bits_arm
 #define size_code_gen_buffer size_code_gen_buffer_arm
-#define slow_bitmap_and slow_bitmap_and_arm
-#define slow_bitmap_andnot slow_bitmap_andnot_arm
-#define slow_bitmap_complement slow_bitmap_complement_arm
-#define slow_bitmap_empty slow_bitmap_empty_arm
-#define slow_bitmap_equal slow_bitmap_equal_arm
-#define slow_bitmap_full slow_bitmap_full_arm
-#define slow_bitmap_intersects slow_bitmap_intersects_arm
-#define slow_bitmap_or slow_bitmap_or_arm
-#define slow_bitmap_xor slow_bitmap_xor_arm
 #define softmmu_lock_user softmmu_lock_user_arm
 #define softmmu_lock_user_string softmmu_lock_user_string_arm
 #define softmmu_tget32 softmmu_tget32_arm
@@ -2699,7 +2320,6 @@
 #define spin_unlock spin_unlock_arm
 #define spsel_read spsel_read_arm
 #define spsel_write spsel_write_arm
-#define start_list start_list_arm
 #define stb_p stb_p_arm
 #define stb_phys stb_phys_arm
 #define stl_be_p stl_be_p_arm
@@ -2720,22 +2340,7 @@
 #define stq_le_p stq_le_p_arm
 #define stq_le_phys stq_le_phys_arm
 #define stq_phys stq_phys_arm
-#define string_input_get_visitor string_input_get_visitor_arm
-#define string_input_visitor_cleanup string_input_visitor_cleanup_arm
-#define string_input_visitor_new string_input_visitor_new_arm
-#define string_output_append string_output_append_arm
-#define string_output_append_range string_output_append_range_arm
-#define string_output_get_string string_output_get_string_arm
-#define string_output_get_visitor string_output_get_visitor_arm
-#define string_output_set string_output_set_arm
-#define string_output_visitor_cleanup string_output_visitor_cleanup_arm
-#define string_output_visitor_new string_output_visitor_new_arm
-#define stristart stristart_arm
 #define strongarm_cp_reginfo strongarm_cp_reginfo_arm
-#define strpadcpy strpadcpy_arm
-#define strstart strstart_arm
-#define strtosz strtosz_arm
-#define strtosz_suffix strtosz_suffix_arm
 #define stw_be_p stw_be_p_arm
 #define stw_be_phys stw_be_phys_arm
 #define stw_he_p stw_he_p_arm
@@ -2759,7 +2364,6 @@
 #define subpage_read subpage_read_arm
 #define subpage_register subpage_register_arm
 #define subpage_write subpage_write_arm
-#define suffix_mul suffix_mul_arm
 #define swap_commutative swap_commutative_arm
 #define swap_commutative2 swap_commutative2_arm
 #define switch_mode switch_mode_arm
@@ -2801,6 +2405,7 @@
 #define tb_hash_remove tb_hash_remove_arm
 #define tb_invalidate_phys_addr tb_invalidate_phys_addr_arm
 #define tb_invalidate_phys_page_range tb_invalidate_phys_page_range_arm
+#define tb_invalidate_pc_range tb_invalidate_pc_range_arm
 #define tb_invalidate_phys_range tb_invalidate_phys_range_arm
 #define tb_jmp_cache_hash_func tb_jmp_cache_hash_func_arm
 #define tb_jmp_cache_hash_page tb_jmp_cache_hash_page_arm
@@ -2811,8 +2416,6 @@
 #define tb_phys_invalidate tb_phys_invalidate_arm
 #define tb_reset_jump tb_reset_jump_arm
 #define tb_set_jmp_target tb_set_jmp_target_arm
-#define tcg_accel_class_init tcg_accel_class_init_arm
-#define tcg_accel_type tcg_accel_type_arm
 #define tcg_add_param_i32 tcg_add_param_i32_arm
 #define tcg_add_param_i64 tcg_add_param_i64_arm
 #define tcg_add_target_add_op_defs tcg_add_target_add_op_defs_arm
@@ -2944,7 +2547,6 @@
 #define tcg_global_reg_new_i64 tcg_global_reg_new_i64_arm
 #define tcg_global_reg_new_internal tcg_global_reg_new_internal_arm
 #define tcg_handle_interrupt tcg_handle_interrupt_arm
-#define tcg_init tcg_init_arm
 #define tcg_invert_cond tcg_invert_cond_arm
 #define tcg_la_bb_end tcg_la_bb_end_arm
 #define tcg_la_br_end tcg_la_br_end_arm
@@ -3040,7 +2642,6 @@
 #define tcg_temp_new_internal tcg_temp_new_internal_arm
 #define tcg_temp_new_internal_i32 tcg_temp_new_internal_i32_arm
 #define tcg_temp_new_internal_i64 tcg_temp_new_internal_i64_arm
-#define tdb_hash tdb_hash_arm
 #define teecr_write teecr_write_arm
 #define teehbr_access teehbr_access_arm
 #define temp_allocate_frame temp_allocate_frame_arm
@@ -3076,34 +2677,16 @@
 #define tlb_set_dirty1 tlb_set_dirty1_arm
 #define tlb_unprotect_code_phys tlb_unprotect_code_phys_arm
 #define tlb_vaddr_to_host tlb_vaddr_to_host_arm
-#define to_json to_json_arm
-#define to_json_dict_iter to_json_dict_iter_arm
-#define to_json_list_iter to_json_list_iter_arm
 #define token_get_type token_get_type_arm
 #define token_get_value token_get_value_arm
 #define token_is_escape token_is_escape_arm
 #define token_is_keyword token_is_keyword_arm
 #define token_is_operator token_is_operator_arm
 #define tokens_append_from_iter tokens_append_from_iter_arm
-#define to_qiv to_qiv_arm
-#define to_qov to_qov_arm
 #define tosa_init tosa_init_arm
 #define tosa_machine_init tosa_machine_init_arm
 #define tswap32 tswap32_arm
 #define tswap64 tswap64_arm
-#define type_class_get_size type_class_get_size_arm
-#define type_get_by_name type_get_by_name_arm
-#define type_get_parent type_get_parent_arm
-#define type_has_parent type_has_parent_arm
-#define type_initialize type_initialize_arm
-#define type_initialize_interface type_initialize_interface_arm
-#define type_is_ancestor type_is_ancestor_arm
-#define type_new type_new_arm
-#define type_object_get_size type_object_get_size_arm
-#define type_register_internal type_register_internal_arm
-#define type_table_add type_table_add_arm
-#define type_table_get type_table_get_arm
-#define type_table_lookup type_table_lookup_arm
 #define uint16_to_float32 uint16_to_float32_arm
 #define uint16_to_float64 uint16_to_float64_arm
 #define uint32_to_float32 uint32_to_float32_arm
@@ -3111,8 +2694,6 @@
 #define uint64_to_float128 uint64_to_float128_arm
 #define uint64_to_float32 uint64_to_float32_arm
 #define uint64_to_float64 uint64_to_float64_arm
-#define uleb128_decode_small uleb128_decode_small_arm
-#define uleb128_encode_small uleb128_encode_small_arm
 #define unassigned_io_ops unassigned_io_ops_arm
 #define unassigned_io_read unassigned_io_read_arm
 #define unassigned_io_write unassigned_io_write_arm
@@ -3142,17 +2723,6 @@
 #define vfp_set_fpcr vfp_set_fpcr_arm
 #define vfp_set_fpscr vfp_set_fpscr_arm
 #define vfp_set_fpsr vfp_set_fpsr_arm
-#define visit_end_implicit_struct visit_end_implicit_struct_arm
-#define visit_end_list visit_end_list_arm
-#define visit_end_struct visit_end_struct_arm
-#define visit_end_union visit_end_union_arm
-#define visit_get_next_type visit_get_next_type_arm
-#define visit_next_list visit_next_list_arm
-#define visit_optional visit_optional_arm
-#define visit_start_implicit_struct visit_start_implicit_struct_arm
-#define visit_start_list visit_start_list_arm
-#define visit_start_struct visit_start_struct_arm
-#define visit_start_union visit_start_union_arm
 #define vmsa_cp_reginfo vmsa_cp_reginfo_arm
 #define vmsa_tcr_el1_write vmsa_tcr_el1_write_arm
 #define vmsa_ttbcr_raw_write vmsa_ttbcr_raw_write_arm
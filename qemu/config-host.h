@@ -0,0 +1,27 @@
+/* Automatically generated by create_config - do not modify */
+#define CONFIG_QEMU_CONFDIR "/usr/local/etc/qemu"
+#define CONFIG_QEMU_DATADIR ""
+#define CONFIG_QEMU_DOCDIR "/usr/local/share/doc/qemu"
+#define CONFIG_QEMU_MODDIR "/usr/local/lib/qemu"
+#define CONFIG_QEMU_LOCALSTATEDIR "/usr/local/var"
+#define CONFIG_QEMU_HELPERDIR "/usr/local/libexec"
+#define HOST_X86_64 1
+#define CONFIG_POSIX 1
+#define CONFIG_LINUX 1
+#define QEMU_VERSION "2.2.1"
+#define QEMU_PKGVERSION ""
+#define CONFIG_PIPE2 1
+#define CONFIG_EVENTFD 1
+#define CONFIG_PPOLL 1
+#define CONFIG_PRCTL_PR_SET_TIMERSLACK 1
+#define CONFIG_BYTESWAP_H 1
+#define CONFIG_SIGNALFD 1
+#define CONFIG_ZERO_MALLOC 1
+#define CONFIG_LINUX_MAGIC_H 1
+#define CONFIG_PRAGMA_DIAGNOSTIC_AVAILABLE 1
+#define CONFIG_HAS_ENVIRON 1
+#define CONFIG_CPUID_H 1
+#define CONFIG_INT128 1
+#define CONFIG_THREAD_SETNAME_BYTHREAD 1
+#define CONFIG_PTHREAD_SETNAME_NP 1
+#define HOST_DSOSUF ".so"
@@ -0,0 +1,75 @@
+# Automatically generated by configure - do not modify
+
+all:
+prefix=/usr/local
+bindir=${prefix}/bin
+libdir=${prefix}/lib
+libexecdir=${prefix}/libexec
+includedir=${prefix}/include
+mandir=${prefix}/share/man
+sysconfdir=${prefix}/etc
+qemu_confdir=${prefix}/etc/qemu
+qemu_datadir=
+qemu_docdir=${prefix}/share/doc/qemu
+qemu_moddir=${prefix}/lib/qemu
+qemu_localstatedir=${prefix}/var
+qemu_helperdir=${prefix}/libexec
+extra_cflags=-m64 -DUNICORN_HAS_X86 -fPIC  -fvisibility=hidden
+extra_ldflags=
+libs_softmmu=-lutil 
+ARCH=x86_64
+STRIP=strip
+CONFIG_POSIX=y
+CONFIG_LINUX=y
+VERSION=2.2.1
+PKGVERSION=
+SRC_PATH=/root/repo/qemu
+TARGET_DIRS=x86_64-softmmu 
+CONFIG_PIPE2=y
+CONFIG_EVENTFD=y
+CONFIG_PPOLL=y
+CONFIG_PRCTL_PR_SET_TIMERSLACK=y
+CONFIG_BYTESWAP_H=y
+GLIB_CFLAGS=-I/usr/include/glib-2.0 -I/usr/lib/x86_64-linux-gnu/glib-2.0/include 
+CONFIG_SIGNALFD=y
+CONFIG_ZERO_MALLOC=y
+CONFIG_LINUX_MAGIC_H=y
+CONFIG_PRAGMA_DIAGNOSTIC_AVAILABLE=y
+CONFIG_HAS_ENVIRON=y
+CONFIG_CPUID_H=y
+CONFIG_INT128=y
+CONFIG_THREAD_SETNAME_BYTHREAD=y
+CONFIG_PTHREAD_SETNAME_NP=y
+MAKE=make
+INSTALL=install
+INSTALL_DIR=install -d -m 0755
+INSTALL_DATA=install -c -m 0644
+INSTALL_PROG=install -c -m 0755
+INSTALL_LIB=install -c -m 0644
+PYTHON=/root/.pyenv/versions/2.7.18/bin/python2 -B
+CC=cc
+CC_I386=$(CC) -m32
+HOST_CC=cc
+OBJCC=cc
+AR=ar
+ARFLAGS=rv
+AS=as
+CPP=cc -E
+OBJCOPY=objcopy
+LD=ld
+NM=nm
+WINDRES=windres
+LIBTOOL=
+CFLAGS=-I/usr/include/glib-2.0 -I/usr/lib/x86_64-linux-gnu/glib-2.0/include  -g 
+CFLAGS_NOPIE=
+QEMU_CFLAGS=-fPIE -DPIE -m64 -D_GNU_SOURCE -D_FILE_OFFSET_BITS=64 -D_LARGEFILE_SOURCE -Wstrict-prototypes -Wredundant-decls -Wall -Wundef -Wwrite-strings -Wmissing-prototypes -fno-strict-aliasing -fno-common -DUNICORN_HAS_X86 -fPIC  -fvisibility=hidden  -Wendif-labels -Wmissing-include-dirs -Wempty-body -Wnested-externs -Wformat-security -Wformat-y2k -Winit-self -Wignored-qualifiers -Wold-style-declaration -Wold-style-definition -Wtype-limits -fstack-protector-strong
+QEMU_INCLUDES=-I$(SRC_PATH)/tcg -I$(SRC_PATH)/tcg/i386 -I. -I$(SRC_PATH) -I$(SRC_PATH)/include
+AUTOCONF_HOST := 
+LDFLAGS=-Wl,--warn-common -Wl,-z,relro -Wl,-z,now -pie -m64 -g 
+LDFLAGS_NOPIE=
+LIBTOOLFLAGS= -Wc,-fstack-protector-strong
+LIBS+=-lm -L/tmp/fakelib -lglib-2.0 -lgthread-2.0   -lz
+EXESUF=
+DSOSUF=.so
+LDFLAGS_SHARED=-shared
+TRANSLATE_OPT_CFLAGS=
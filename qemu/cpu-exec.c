@@ -23,13 +23,126 @@
 #include "sysemu/sysemu.h"
 
 #include "uc_priv.h"
+#include "uc_probe.h"
+
+/* Unicorn: each target object links exactly one CPU implementation, so
+   the CPUClass hooks used on the execution hot path resolve at compile
+   time; calling the implementations directly lets the compiler inline
+   them. Hooks that stay class-dependent within one target keep the
+   indirect call: on arm, M-profile cores override cpu_exec_interrupt and
+   aarch64 builds carry two set_pc variants. Targets without a hook of
+   their own get the base class behavior (a no-op). */
+#if defined(TARGET_I386)
+#define CPU_EXEC_ENTER(cc, cpu)          ((void)(cc), x86_cpu_exec_enter(cpu))
+#define CPU_EXEC_EXIT(cc, cpu)           ((void)(cc), x86_cpu_exec_exit(cpu))
+#define CPU_EXEC_INTERRUPT(cc, cpu, irq) ((void)(cc), x86_cpu_exec_interrupt(cpu, irq))
+#define CPU_SYNC_FROM_TB(cc, cpu, tb)    ((void)(cc), x86_cpu_synchronize_from_tb(cpu, tb))
+#define CPU_DEBUG_EXCP(cc, cpu)          ((void)(cc), breakpoint_handler(cpu))
+#elif defined(TARGET_ARM)
+void arm_debug_excp_handler(CPUState *cs);  /* see target-arm/internals.h */
+#define CPU_EXEC_ENTER(cc, cpu)          ((void)(cc), (void)(cpu))
+#define CPU_EXEC_EXIT(cc, cpu)           ((void)(cc), (void)(cpu))
+#define CPU_EXEC_INTERRUPT(cc, cpu, irq) ((cc)->cpu_exec_interrupt(cpu, irq))
+#define CPU_SET_PC(cc, cpu, pc)          ((cc)->set_pc(cpu, pc))
+#define CPU_DEBUG_EXCP(cc, cpu)          ((void)(cc), arm_debug_excp_handler(cpu))
+#elif defined(TARGET_M68K)
+#define CPU_EXEC_ENTER(cc, cpu)          ((void)(cc), m68k_cpu_exec_enter(cpu))
+#define CPU_EXEC_EXIT(cc, cpu)           ((void)(cc), m68k_cpu_exec_exit(cpu))
+#define CPU_EXEC_INTERRUPT(cc, cpu, irq) ((void)(cc), m68k_cpu_exec_interrupt(cpu, irq))
+#define CPU_SET_PC(cc, cpu, pc)          ((void)(cc), m68k_cpu_set_pc(cpu, pc))
+#define CPU_DEBUG_EXCP(cc, cpu)          ((void)(cc), (void)(cpu))
+#elif defined(TARGET_MIPS)
+#define CPU_EXEC_ENTER(cc, cpu)          ((void)(cc), (void)(cpu))
+#define CPU_EXEC_EXIT(cc, cpu)           ((void)(cc), (void)(cpu))
+#define CPU_EXEC_INTERRUPT(cc, cpu, irq) ((void)(cc), mips_cpu_exec_interrupt(cpu, irq))
+#define CPU_SYNC_FROM_TB(cc, cpu, tb)    ((void)(cc), mips_cpu_synchronize_from_tb(cpu, tb))
+#define CPU_DEBUG_EXCP(cc, cpu)          ((void)(cc), (void)(cpu))
+#elif defined(TARGET_SPARC)
+#define CPU_EXEC_ENTER(cc, cpu)          ((void)(cc), (void)(cpu))
+#define CPU_EXEC_EXIT(cc, cpu)           ((void)(cc), (void)(cpu))
+#define CPU_EXEC_INTERRUPT(cc, cpu, irq) ((void)(cc), sparc_cpu_exec_interrupt(cpu, irq))
+#define CPU_SYNC_FROM_TB(cc, cpu, tb)    ((void)(cc), sparc_cpu_synchronize_from_tb(cpu, tb))
+#define CPU_DEBUG_EXCP(cc, cpu)          ((void)(cc), (void)(cpu))
+#else
+#define CPU_EXEC_ENTER(cc, cpu)          ((cc)->cpu_exec_enter(cpu))
+#define CPU_EXEC_EXIT(cc, cpu)           ((cc)->cpu_exec_exit(cpu))
+#define CPU_EXEC_INTERRUPT(cc, cpu, irq) ((cc)->cpu_exec_interrupt(cpu, irq))
+#define CPU_SET_PC(cc, cpu, pc)          ((cc)->set_pc(cpu, pc))
+#define CPU_DEBUG_EXCP(cc, cpu)          ((cc)->debug_excp_handler(cpu))
+#endif
 
 static tcg_target_ulong cpu_tb_exec(CPUState *cpu, uint8_t *tb_ptr);
+static void cpu_exec_nocache(CPUArchState *env, int max_cycles,
+        TranslationBlock *orig_tb);
 static TranslationBlock *tb_find_slow(CPUArchState *env, target_ulong pc,
         target_ulong cs_base, uint64_t flags);
 static TranslationBlock *tb_find_fast(CPUArchState *env);
 static void cpu_handle_debug_exception(CPUArchState *env);
 
+/* Decode and dispatch pending interrupt/exit work for one iteration of the
+   execution loop. Deliberately out of line: the per-TB fast path in
+   cpu_exec() only tests the combined flag word and never decodes it.
+   Returns true when the outer loop must take over (an exception or exit
+   was queued); *next_tb is zeroed when the program flow changed so that
+   no TB jump gets patched. */
+static bool cpu_handle_interrupt(CPUArchState *env, CPUState *cpu,
+                                 CPUClass *cc, uintptr_t *next_tb)
+{
+    int interrupt_request = cpu->interrupt_request;
+
+    if (interrupt_request) {
+        if (unlikely(cpu->singlestep_enabled & SSTEP_NOIRQ)) {
+            /* Mask out external interrupts for this step. */
+            interrupt_request &= ~CPU_INTERRUPT_SSTEP_MASK;
+        }
+        if (interrupt_request & CPU_INTERRUPT_DEBUG) {
+            cpu->interrupt_request &= ~CPU_INTERRUPT_DEBUG;
+            cpu->exception_index = EXCP_DEBUG;
+            return true;
+        }
+        if (interrupt_request & CPU_INTERRUPT_HALT) {
+            cpu->interrupt_request &= ~CPU_INTERRUPT_HALT;
+            cpu->halted = 1;
+            cpu->exception_index = EXCP_HLT;
+            return true;
+        }
+#if defined(TARGET_I386)
+        if (interrupt_request & CPU_INTERRUPT_INIT) {
+            X86CPU *x86_cpu = X86_CPU(env->uc, cpu);
+            cpu_svm_check_intercept_param(env, SVM_EXIT_INIT, 0);
+            do_cpu_init(x86_cpu);
+            cpu->exception_index = EXCP_HALTED;
+            return true;
+        }
+#else
+        if (interrupt_request & CPU_INTERRUPT_RESET) {
+            cpu_reset(cpu);
+        }
+#endif
+        /* The target hook has 3 exit conditions:
+           False when the interrupt isn't processed,
+           True when it is, and we should restart on a new TB,
+           and via longjmp via cpu_loop_exit.  */
+        if (CPU_EXEC_INTERRUPT(cc, cpu, interrupt_request)) {
+            *next_tb = 0;
+        }
+        /* Don't use the cached interrupt_request value,
+           do_interrupt may have updated the EXITTB flag. */
+        if (cpu->interrupt_request & CPU_INTERRUPT_EXITTB) {
+            cpu->interrupt_request &= ~CPU_INTERRUPT_EXITTB;
+            /* ensure that no TB jump will be modified as
+               the program flow was changed */
+            *next_tb = 0;
+        }
+    }
+    if (unlikely(cpu->exit_request)) {
+        cpu->exit_request = 0;
+        cpu->exception_index = EXCP_INTERRUPT;
+        return true;
+    }
+    return false;
+}
+
 void cpu_loop_exit(CPUState *cpu)
 {
     cpu->current_tb = NULL;
@@ -57,10 +170,7 @@ int cpu_exec(struct uc_struct *uc, CPUArchState *env)   // qq
     CPUState *cpu = ENV_GET_CPU(env);
     TCGContext *tcg_ctx = env->uc->tcg_ctx;
     CPUClass *cc = CPU_GET_CLASS(uc, cpu);
-#ifdef TARGET_I386
-    X86CPU *x86_cpu = X86_CPU(uc, cpu);
-#endif
-    int ret, interrupt_request;
+    int ret;
     TranslationBlock *tb;
     uint8_t *tc_ptr;
     uintptr_t next_tb;
@@ -92,193 +202,249 @@ int cpu_exec(struct uc_struct *uc, CPUArchState *env)   // qq
         cpu->exit_request = 1;
     }
 
-    cc->cpu_exec_enter(cpu);
+    CPU_EXEC_ENTER(cc, cpu);
     cpu->exception_index = -1;
     env->invalid_error = UC_ERR_OK;
 
-    /* prepare setjmp context for exception handling */
+    /* Prepare the longjmp context for exception handling. The buffer is
+       armed once and stays valid for the lifetime of this frame, so the
+       raising paths that really need to unwind - faults from helpers and
+       the softmmu - can re-enter here repeatedly without a fresh register
+       save per entry. Expected exits (stop requests, halt, expired
+       instruction budgets) use plain control flow below instead of
+       cpu_loop_exit(). */
+    if (sigsetjmp(cpu->jmp_env, 0) != 0) {
+        /* Reload env after longjmp - the compiler may have smashed all
+         * local variables as longjmp is marked 'noreturn'. */
+        cpu = uc->current_cpu;
+        env = cpu->env_ptr;
+        cc = CPU_GET_CLASS(uc, cpu);
+        if (have_tb_lock) {
+            spin_unlock(&tcg_ctx->tb_ctx.tb_lock);
+            have_tb_lock = false;
+        }
+    }
+
     for(;;) {
-        if (sigsetjmp(cpu->jmp_env, 0) == 0) {
-            if (uc->stop_request || uc->invalid_error)
+        if (uc->stop_request || uc->invalid_error)
+            break;
+
+        /* if an exception is pending, we execute it here */
+        if (cpu->exception_index >= 0) {
+            //printf(">>> GOT INTERRUPT. exception idx = %x\n", cpu->exception_index);	// qq
+            if (uc->stop_interrupt && uc->stop_interrupt(cpu->exception_index)) {
+                cpu->halted = 1;
+                uc->invalid_error = UC_ERR_INSN_INVALID;
+                ret = EXCP_HLT;
                 break;
+            }
 
-            /* if an exception is pending, we execute it here */
-            if (cpu->exception_index >= 0) {
-                //printf(">>> GOT INTERRUPT. exception idx = %x\n", cpu->exception_index);	// qq
-                if (uc->stop_interrupt && uc->stop_interrupt(cpu->exception_index)) {
-                    cpu->halted = 1;
-                    uc->invalid_error = UC_ERR_INSN_INVALID;
-                    ret = EXCP_HLT;
-                    break;
+            if (cpu->exception_index >= EXCP_INTERRUPT) {
+                /* exit request from the cpu execution loop */
+                ret = cpu->exception_index;
+                if (ret == EXCP_DEBUG) {
+                    cpu_handle_debug_exception(env);
                 }
-
-                if (cpu->exception_index >= EXCP_INTERRUPT) {
-                    /* exit request from the cpu execution loop */
-                    ret = cpu->exception_index;
-                    if (ret == EXCP_DEBUG) {
-                        cpu_handle_debug_exception(env);
-                    }
-                    break;
-                } else {
+                break;
+            } else {
 #if defined(CONFIG_USER_ONLY)
-                    /* if user mode only, we simulate a fake exception
-                       which will be handled outside the cpu execution
-                       loop */
+                /* if user mode only, we simulate a fake exception
+                   which will be handled outside the cpu execution
+                   loop */
 #if defined(TARGET_I386)
-                    cc->do_interrupt(cpu);
+                cc->do_interrupt(cpu);
 #endif
-                    ret = cpu->exception_index;
-                    break;
+                ret = cpu->exception_index;
+                break;
 #else
-                    // Unicorn: call registered interrupt callbacks
-                    HOOK_FOREACH(uc, hook, UC_HOOK_INTR) {
-                        ((uc_cb_hookintr_t)hook->callback)(uc, cpu->exception_index, hook->user_data);
-                    }
-                    cpu->exception_index = -1;
+                // Unicorn: call registered interrupt callbacks
+                HOOK_FOREACH(uc, hook, UC_HOOK_INTR) {
+                    ((uc_cb_hookintr_t)hook->callback)(uc, cpu->exception_index, hook->user_data);
+                }
+                cpu->exception_index = -1;
 #if defined(TARGET_X86_64)
-                    // point EIP to the next instruction after INT
-                    env->eip = env->exception_next_eip;
+                // point EIP to the next instruction after INT
+                env->eip = env->exception_next_eip;
 #endif
 #if defined(TARGET_MIPS) || defined(TARGET_MIPS64)
-                    env->active_tc.PC = uc->next_pc;
+                env->active_tc.PC = uc->next_pc;
 #endif
 #endif
-                }
             }
+        }
 
-            next_tb = 0; /* force lookup of first TB */
-            for(;;) {
-                interrupt_request = cpu->interrupt_request;
-
-                if (unlikely(interrupt_request)) {
-                    if (unlikely(cpu->singlestep_enabled & SSTEP_NOIRQ)) {
-                        /* Mask out external interrupts for this step. */
-                        interrupt_request &= ~CPU_INTERRUPT_SSTEP_MASK;
-                    }
-                    if (interrupt_request & CPU_INTERRUPT_DEBUG) {
-                        cpu->interrupt_request &= ~CPU_INTERRUPT_DEBUG;
-                        cpu->exception_index = EXCP_DEBUG;
-                        cpu_loop_exit(cpu);
-                    }
-                    if (interrupt_request & CPU_INTERRUPT_HALT) {
-                        cpu->interrupt_request &= ~CPU_INTERRUPT_HALT;
-                        cpu->halted = 1;
-                        cpu->exception_index = EXCP_HLT;
-                        cpu_loop_exit(cpu);
-                    }
-#if defined(TARGET_I386)
-                    if (interrupt_request & CPU_INTERRUPT_INIT) {
-                        cpu_svm_check_intercept_param(env, SVM_EXIT_INIT, 0);
-                        do_cpu_init(x86_cpu);
-                        cpu->exception_index = EXCP_HALTED;
-                        cpu_loop_exit(cpu);
-                    }
-#else
-                    if (interrupt_request & CPU_INTERRUPT_RESET) {
-                        cpu_reset(cpu);
-                    }
-#endif
-                    /* The target hook has 3 exit conditions:
-                       False when the interrupt isn't processed,
-                       True when it is, and we should restart on a new TB,
-                       and via longjmp via cpu_loop_exit.  */
-                    if (cc->cpu_exec_interrupt(cpu, interrupt_request)) {
-                        next_tb = 0;
-                    }
-                    /* Don't use the cached interrupt_request value,
-                       do_interrupt may have updated the EXITTB flag. */
-                    if (cpu->interrupt_request & CPU_INTERRUPT_EXITTB) {
-                        cpu->interrupt_request &= ~CPU_INTERRUPT_EXITTB;
-                        /* ensure that no TB jump will be modified as
-                           the program flow was changed */
-                        next_tb = 0;
-                    }
-                }
-                if (unlikely(cpu->exit_request)) {
-                    cpu->exit_request = 0;
-                    cpu->exception_index = EXCP_INTERRUPT;
-                    cpu_loop_exit(cpu);
-                }
-                spin_lock(&tcg_ctx->tb_ctx.tb_lock);
-                have_tb_lock = true;
-                tb = tb_find_fast(env);	// qq
-                if (!tb) {   // invalid TB due to invalid code?
-                    uc->invalid_error = UC_ERR_FETCH_UNMAPPED;
-                    ret = EXCP_HLT;
+        next_tb = 0; /* force lookup of first TB */
+        for(;;) {
+            /* Unicorn: interrupts and exit requests are raised from a
+               handful of well-known places (uc_emu_stop(), the timer
+               thread, the target's do_interrupt), so the per-TB cost is
+               one predictable test of the combined flag word; the decode
+               lives out of line in cpu_handle_interrupt(). When it queues
+               an exception this is an expected exit: the outer loop
+               dispatches it, no longjmp needed from here. */
+            if (unlikely(cpu->interrupt_request | cpu->exit_request)) {
+                if (cpu_handle_interrupt(env, cpu, cc, &next_tb)) {
+                    cpu->current_tb = NULL;
                     break;
                 }
-                /* Note: we do it here to avoid a gcc bug on Mac OS X when
-                   doing it in tb_find_slow */
-                if (tcg_ctx->tb_ctx.tb_invalidated_flag) {
-                    /* as some TB could have been invalidated because
-                       of memory exceptions while generating the code, we
-                       must recompute the hash index here */
-                    next_tb = 0;
-                    tcg_ctx->tb_ctx.tb_invalidated_flag = 0;
+            }
+            spin_lock(&tcg_ctx->tb_ctx.tb_lock);
+            have_tb_lock = true;
+            tb = tb_find_fast(env);	// qq
+            if (!tb) {   // invalid TB due to invalid code?
+                uc->invalid_error = UC_ERR_FETCH_UNMAPPED;
+                ret = EXCP_HLT;
+                break;
+            }
+            /* Note: we do it here to avoid a gcc bug on Mac OS X when
+               doing it in tb_find_slow */
+            if (tcg_ctx->tb_ctx.tb_invalidated_flag) {
+                /* as some TB could have been invalidated because
+                   of memory exceptions while generating the code, we
+                   must recompute the hash index here */
+                next_tb = 0;
+                tcg_ctx->tb_ctx.tb_invalidated_flag = 0;
+            }
+            /* see if we can patch the calling TB. Unicorn: chaining
+               stays enabled for timeout runs (the deadline is enforced
+               by the timer thread, see timer_worker() in uc.c) and for
+               TBs spanning two pages: write invalidation unchains
+               through jmp_first, and links into two-page TBs are
+               recorded so the TLB flush paths can undo them when the
+               second page's mapping changes (see tb_crosspage_link). */
+            if (next_tb != 0) {
+                TranslationBlock *src =
+                        (TranslationBlock *)(next_tb & ~TB_EXIT_MASK);
+                int n = next_tb & TB_EXIT_MASK;
+
+                if (tb->page_addr[1] != -1 && !src->jmp_next[n]) {
+                    tb_crosspage_link(env->uc, src, n, tb);
                 }
-                /* see if we can patch the calling TB. When the TB
-                   spans two pages, we cannot safely do a direct
-                   jump. */
-                if (next_tb != 0 && tb->page_addr[1] == -1) {
-                    tb_add_jump((TranslationBlock *)(next_tb & ~TB_EXIT_MASK),
-                            next_tb & TB_EXIT_MASK, tb);
+                tb_add_jump(src, n, tb);
+            }
+            have_tb_lock = false;
+            spin_unlock(&tcg_ctx->tb_ctx.tb_lock);
+
+            /* cpu_interrupt might be called while translating the
+               TB, but before it is linked into a potentially
+               infinite loop and becomes env->current_tb. Avoid
+               starting execution if there is a pending interrupt. */
+            cpu->current_tb = tb;
+            barrier();
+            if (likely(!cpu->exit_request)) {
+                tc_ptr = tb->tc_ptr;
+                /* per-engine counters for UC_QUERY_EXEC_BLOCK_COUNT /
+                   UC_QUERY_EXEC_INSN_COUNT; blocks that chain inside the
+                   code buffer are not seen here, so this counts
+                   dispatches (exact when chaining is off) */
+                uc->exec_block_count++;
+                uc->exec_insn_count += tb->icount;
+                /* guest-PC sampling profiler (uc_sample_enable()):
+                   every Nth dispatched block lands one sample on the
+                   block's start pc */
+                if (uc->sample_table != NULL &&
+                        --uc->sample_countdown == 0) {
+                    uc->sample_countdown = uc->sample_interval;
+                    uc_sample_record(uc, tb->pc);
                 }
-                have_tb_lock = false;
-                spin_unlock(&tcg_ctx->tb_ctx.tb_lock);
-
-                /* cpu_interrupt might be called while translating the
-                   TB, but before it is linked into a potentially
-                   infinite loop and becomes env->current_tb. Avoid
-                   starting execution if there is a pending interrupt. */
-                cpu->current_tb = tb;
-                barrier();
-                if (likely(!cpu->exit_request)) {
-                    tc_ptr = tb->tc_ptr;
-                    /* execute the generated code */
-                    next_tb = cpu_tb_exec(cpu, tc_ptr);	// qq
-
-                    switch (next_tb & TB_EXIT_MASK) {
-                        case TB_EXIT_REQUESTED:
-                            /* Something asked us to stop executing
-                             * chained TBs; just continue round the main
-                             * loop. Whatever requested the exit will also
-                             * have set something else (eg exit_request or
-                             * interrupt_request) which we will handle
-                             * next time around the loop.
-                             */
-                            tb = (TranslationBlock *)(next_tb & ~TB_EXIT_MASK);
+                /* execute the generated code */
+                next_tb = cpu_tb_exec(cpu, tc_ptr);	// qq
+
+                switch (next_tb & TB_EXIT_MASK) {
+                    case TB_EXIT_REQUESTED:
+                        /* Something asked us to stop executing
+                         * chained TBs; just continue round the main
+                         * loop. Whatever requested the exit will also
+                         * have set something else (eg exit_request or
+                         * interrupt_request) which we will handle
+                         * next time around the loop.
+                         */
+                        tb = (TranslationBlock *)(next_tb & ~TB_EXIT_MASK);
+                        next_tb = 0;
+                        /* Unicorn: the block crossed the execution
+                         * threshold set by uc_superblock_enable();
+                         * retranslate it with jump following before
+                         * it runs again (see tb_superblock()). */
+                        if (unlikely(cpu->sb_request)) {
+                            cpu->sb_request = 0;
+                            spin_lock(&tcg_ctx->tb_ctx.tb_lock);
+                            tb_superblock(cpu, tb);
+                            spin_unlock(&tcg_ctx->tb_ctx.tb_lock);
+                        }
+                        break;
+                    case TB_EXIT_ICOUNT_EXPIRED:
+                    {
+                        /* Unicorn: the instruction count budget of a
+                         * count-limited uc_emu_start() run does not
+                         * cover the next TB. */
+                        int insns_left;
+                        tb = (TranslationBlock *)(next_tb & ~TB_EXIT_MASK);
+                        insns_left = cpu->icount_decr.u32;
+                        if (cpu->icount_extra && insns_left >= 0) {
+                            /* Refill decrementer and continue execution.  */
+                            cpu->icount_extra += insns_left;
+                            if (cpu->icount_extra > 0xffff) {
+                                insns_left = 0xffff;
+                            } else {
+                                insns_left = cpu->icount_extra;
+                            }
+                            cpu->icount_extra -= insns_left;
+                            cpu->icount_decr.u16.low = insns_left;
                             next_tb = 0;
-                            break;
-                        default:
-                            break;
+                        } else {
+                            if (insns_left > 0) {
+                                /* Execute remaining instructions.  */
+                                cpu_exec_nocache(env, insns_left, tb);
+                            }
+                            cpu->icount_decr.u16.low = 0;
+                            if (uc->vcpu_count > 1) {
+                                /* Unicorn: only this vCPU's round-robin
+                                   slice ended; yield the thread back to
+                                   tcg_exec_all(), which charges the slice
+                                   against the run's budget and moves on
+                                   to the next vCPU. */
+                                uc->vcpu_yield = true;
+                            } else {
+                                /* the budget is used up: stop emulation
+                                   the same way uc_emu_stop() does */
+                                uc->stop_request = true;
+                            }
+                            cpu->exception_index = EXCP_INTERRUPT;
+                            cpu->current_tb = NULL;
+                            goto tb_exit;
+                        }
+                        break;
                     }
+                    default:
+                        break;
                 }
-                cpu->current_tb = NULL;
-                /* reset soft MMU for next block (it can currently
-                   only be set by a memory fault) */
-            } /* for(;;) */
-        } else {
-            /* Reload env after longjmp - the compiler may have smashed all
-             * local variables as longjmp is marked 'noreturn'. */
-            cpu = uc->current_cpu;
-            env = cpu->env_ptr;
-            cc = CPU_GET_CLASS(uc, cpu);
-#ifdef TARGET_I386
-            x86_cpu = X86_CPU(uc, cpu);
-#endif
-            if (have_tb_lock) {
-                spin_unlock(&tcg_ctx->tb_ctx.tb_lock);
-                have_tb_lock = false;
             }
-        }
+            cpu->current_tb = NULL;
+            /* reset soft MMU for next block (it can currently
+               only be set by a memory fault) */
+        } /* for(;;) */
+tb_exit: ;
     } /* for(;;) */
 
-    cc->cpu_exec_exit(cpu);
+    CPU_EXEC_EXIT(cc, cpu);
 
     // Unicorn: flush JIT cache to because emulation might stop in
     // the middle of translation, thus generate incomplete code.
     // TODO: optimize this for better performance
-    tb_flush(env);
+    // A scheduling yield returns at a clean TB boundary, so the cache
+    // stays valid for the next vCPU's slice.
+    if (uc->vcpu_yield) {
+        uc->vcpu_yield = false;
+    } else if (uc->tb_pruned && uc->quit_request) {
+        // a bounded code/block hook change already dropped the affected
+        // TBs (uc_hook_add()/uc_hook_del()); emulation resumes right away,
+        // so the rest of the warm cache stays valid. A real stop still
+        // flushes, keeping the cache empty between runs.
+        uc->tb_pruned = false;
+    } else {
+        uc->tb_pruned = false;
+        tb_flush(env);
+    }
 
     /* fail safe : never use current_cpu outside cpu_exec() */
     uc->current_cpu = NULL;
@@ -292,7 +458,9 @@ static tcg_target_ulong cpu_tb_exec(CPUState *cpu, uint8_t *tb_ptr)
     TCGContext *tcg_ctx = env->uc->tcg_ctx;
     uintptr_t next_tb;
 
-    next_tb = tcg_qemu_tb_exec(env, tb_ptr);
+    /* tc_ptr values stay in the writable view of a dual-mapped W^X
+       buffer; execution enters through the executable one */
+    next_tb = tcg_qemu_tb_exec(env, tb_ptr + tcg_ctx->code_rx_delta);
 
     if ((next_tb & TB_EXIT_MASK) > TB_EXIT_IDX1) {
         /* We didn't start executing this TB (eg because the instruction
@@ -301,17 +469,15 @@ static tcg_target_ulong cpu_tb_exec(CPUState *cpu, uint8_t *tb_ptr)
          */
         CPUClass *cc = CPU_GET_CLASS(env->uc, cpu);
         TranslationBlock *tb = (TranslationBlock *)(next_tb & ~TB_EXIT_MASK);
-        if (cc->synchronize_from_tb) {
-            // avoid sync twice when helper_uc_tracecode() already did this.
-            if (env->uc->emu_counter <= env->uc->emu_count &&
-                    !env->uc->stop_request && !env->uc->quit_request)
-                cc->synchronize_from_tb(cpu, tb);
-        } else {
-            assert(cc->set_pc);
-            // avoid sync twice when helper_uc_tracecode() already did this.
-            if (env->uc->emu_counter <= env->uc->emu_count && !env->uc->quit_request)
-                cc->set_pc(cpu, tb->pc);
-        }
+#if defined(CPU_SYNC_FROM_TB)
+        // avoid sync twice when helper_uc_tracecode() already did this.
+        if (!env->uc->stop_request && !env->uc->quit_request)
+            CPU_SYNC_FROM_TB(cc, cpu, tb);
+#else
+        // avoid sync twice when helper_uc_tracecode() already did this.
+        if (!env->uc->quit_request)
+            CPU_SET_PC(cc, cpu, tb->pc);
+#endif
     }
     if ((next_tb & TB_EXIT_MASK) == TB_EXIT_REQUESTED) {
         /* We were asked to stop executing TBs (probably a pending
@@ -322,6 +488,29 @@ static tcg_target_ulong cpu_tb_exec(CPUState *cpu, uint8_t *tb_ptr)
     return next_tb;
 }
 
+/* Execute the remaining instructions of an expired count budget with a
+   one-off TB translated to exactly that many instructions. */
+static void cpu_exec_nocache(CPUArchState *env, int max_cycles,
+        TranslationBlock *orig_tb)
+{
+    CPUState *cpu = ENV_GET_CPU(env);
+    TranslationBlock *tb;
+
+    /* Should never happen.
+       We only end up here when an existing TB is too long.  */
+    if (max_cycles > CF_COUNT_MASK)
+        max_cycles = CF_COUNT_MASK;
+
+    tb = tb_gen_code(cpu, orig_tb->pc, orig_tb->cs_base, orig_tb->flags,
+                     max_cycles);
+    cpu->current_tb = tb;
+    /* execute the generated code */
+    cpu_tb_exec(cpu, tb->tc_ptr);
+    cpu->current_tb = NULL;
+    tb_phys_invalidate(cpu->uc, tb, -1);
+    tb_free(cpu->uc, tb);
+}
+
 static TranslationBlock *tb_find_slow(CPUArchState *env, target_ulong pc,
         target_ulong cs_base, uint64_t flags)   // qq
 {
@@ -333,6 +522,8 @@ static TranslationBlock *tb_find_slow(CPUArchState *env, target_ulong pc,
     target_ulong virt_page2;
 
     tcg_ctx->tb_ctx.tb_invalidated_flag = 0;
+    env->uc->tb_slow_lookup_count++;
+    UC_PROBE1(tb_find_slow, pc);
 
     /* find translated block using physical mappings */
     phys_pc = get_page_addr_code(env, pc);  // qq
@@ -340,7 +531,7 @@ static TranslationBlock *tb_find_slow(CPUArchState *env, target_ulong pc,
         return NULL;
     }
     phys_page1 = phys_pc & TARGET_PAGE_MASK;
-    h = tb_phys_hash_func(phys_pc);
+    h = tb_phys_hash_func(phys_pc, tcg_ctx->tb_ctx.tb_phys_hash_mask);
     ptb1 = &tcg_ctx->tb_ctx.tb_phys_hash[h];
     for(;;) {
         tb = *ptb1;
@@ -368,6 +559,11 @@ static TranslationBlock *tb_find_slow(CPUArchState *env, target_ulong pc,
 not_found:
     /* if no translated code available, then translate it now */
     tb = tb_gen_code(cpu, pc, cs_base, flags, 0);   // qq
+    /* Unicorn: a miss in cold code predicts more just ahead; translate
+       the static successors now (see uc_translate_readahead) */
+    if (env->uc->tb_readahead) {
+        tb_readahead(cpu, tb);
+    }
 
 found:
     /* Move the last found TB to the head of the list */
@@ -377,7 +573,9 @@ found:
         tcg_ctx->tb_ctx.tb_phys_hash[h] = tb;
     }
     /* we add the TB in the virtual pc hash table */
-    cpu->tb_jmp_cache[tb_jmp_cache_hash_func(pc)] = tb;
+    h = tb_jmp_cache_hash_func(pc, env->uc->jmp_cache_bits);
+    cpu->tb_jmp_cache[h] = tb;
+    cpu->tb_jmp_cache_gen[h] = cpu->jmp_cache_gen;
     return tb;
 }
 
@@ -386,14 +584,19 @@ static TranslationBlock *tb_find_fast(CPUArchState *env)    // qq
     CPUState *cpu = ENV_GET_CPU(env);
     TranslationBlock *tb;
     target_ulong cs_base, pc;
+    unsigned int h;
     int flags;
 
     /* we record a subset of the CPU state. It will
        always be the same before a given translated block
        is executed. */
     cpu_get_tb_cpu_state(env, &pc, &cs_base, &flags);
-    tb = cpu->tb_jmp_cache[tb_jmp_cache_hash_func(pc)];
-    if (unlikely(!tb || tb->pc != pc || tb->cs_base != cs_base ||
+    env->uc->tb_lookup_count++;
+    h = tb_jmp_cache_hash_func(pc, env->uc->jmp_cache_bits);
+    tb = cpu->tb_jmp_cache[h];
+    /* an entry from before the last flush fails the generation check */
+    if (unlikely(!tb || cpu->tb_jmp_cache_gen[h] != cpu->jmp_cache_gen ||
+                tb->pc != pc || tb->cs_base != cs_base ||
                 tb->flags != flags)) {
         tb = tb_find_slow(env, pc, cs_base, flags); // qq
     }
@@ -406,11 +609,11 @@ static void cpu_handle_debug_exception(CPUArchState *env)
     CPUClass *cc = CPU_GET_CLASS(env->uc, cpu);
     CPUWatchpoint *wp;
 
-    if (!cpu->watchpoint_hit) {
+    if (!cpu->watchpoint_hit && cpu->watchpoint_count) {
         QTAILQ_FOREACH(wp, &cpu->watchpoints, entry) {
             wp->flags &= ~BP_WATCHPOINT_HIT;
         }
     }
 
-    cc->debug_excp_handler(cpu);
+    CPU_DEBUG_EXCP(cc, cpu);
 }
@@ -38,7 +38,6 @@ static void cpu_handle_guest_debug(CPUState *cpu);
 static int tcg_cpu_exec(struct uc_struct *uc, CPUArchState *env);
 static bool tcg_exec_all(struct uc_struct* uc);
 static int qemu_tcg_init_vcpu(CPUState *cpu);
-static void *qemu_tcg_cpu_thread_fn(void *arg);
 
 int vm_start(struct uc_struct* uc)
 {
@@ -46,9 +45,6 @@ int vm_start(struct uc_struct* uc)
         return -1;
     }
 
-    // kick off TCG thread
-    qemu_mutex_unlock_iothread(uc);
-
     return 0;
 }
 
@@ -65,7 +61,6 @@ void run_on_cpu(CPUState *cpu, void (*func)(void *data), void *data)
     }
 }
 
-// send halt_cond/tcg_halt_cond to @cpu
 bool qemu_cpu_is_self(CPUState *cpu)
 {
     return qemu_thread_is_self(cpu->thread);
@@ -76,7 +71,8 @@ void pause_all_vcpus(struct uc_struct *uc)
     CPUState *cpu;
 
     CPU_FOREACH(cpu) {
-        qemu_thread_join(cpu->thread);	// qq: fix qemu_thread_join() to work for instance
+        cpu->stop = false;
+        cpu->stopped = true;
     }
 }
 
@@ -85,29 +81,49 @@ int resume_all_vcpus(struct uc_struct *uc)
 {
     CPUState *cpu;
 
-    {
-        // Fix call multiple time (vu).
-        // We have to check whether this is the second time, then reset all CPU.
-        bool created = false;
-        CPU_FOREACH(cpu) {
-            created |= cpu->created;
-        }
-        if (!created) {
-            CPU_FOREACH(cpu) {
-                cpu->created = true;
-                cpu->halted = 0;
-                if (qemu_init_vcpu(cpu))
-                    return -1;
-            }
-            qemu_mutex_lock_iothread(uc);
+    // vcpus are only initialized on their first run; later runs reuse the
+    // same execution state.  uc_vcpu_create() may have appended fresh ones
+    // since the last run.
+    CPU_FOREACH(cpu) {
+        if (!cpu->created) {
+            cpu->created = true;
+            cpu->halted = 0;
+            if (qemu_init_vcpu(cpu))
+                return -1;
         }
     }
 
     //qemu_clock_enable(QEMU_CLOCK_VIRTUAL, true);
+    uc->emu_count_left = uc->emu_count;
     CPU_FOREACH(cpu) {
+        // seed the instruction count budget checked in the TB prologues
+        // (see gen_tb_start); the decrementer holds at most 16 bits and
+        // icount_extra carries the rest.  With more than one vCPU the
+        // budget is shared and handed out slice by slice in tcg_exec_all().
+        if (uc->vcpu_count > 1) {
+            cpu->icount_decr.u16.low = 0;
+            cpu->icount_extra = 0;
+        } else if (uc->emu_count > 0) {
+            if (uc->emu_count > 0xffff) {
+                cpu->icount_decr.u16.low = 0xffff;
+                cpu->icount_extra = uc->emu_count - 0xffff;
+            } else {
+                cpu->icount_decr.u16.low = uc->emu_count;
+                cpu->icount_extra = 0;
+            }
+        } else {
+            cpu->icount_decr.u16.low = 0;
+            cpu->icount_extra = 0;
+        }
         cpu_resume(cpu);
     }
 
+    // run the emulation on the calling thread; this returns only when
+    // emulation is finished, so there is no vcpu thread to create or join
+    while (!tcg_exec_all(uc)) {
+        ;
+    }
+
     return 0;
 }
 
@@ -125,85 +141,21 @@ int qemu_init_vcpu(CPUState *cpu)
 }
 
 
-static void *qemu_tcg_cpu_thread_fn(void *arg)
-{
-    CPUState *cpu = arg;
-    struct uc_struct *uc = cpu->uc;
-
-    //qemu_tcg_init_cpu_signals();
-    qemu_thread_get_self(uc, cpu->thread);
-
-    qemu_mutex_lock(&uc->qemu_global_mutex);
-    CPU_FOREACH(cpu) {
-        cpu->thread_id = qemu_get_thread_id();
-        cpu->created = true;
-    }
-    qemu_cond_signal(&uc->qemu_cpu_cond);
-
-   /* wait for initial kick-off after machine start */
-    while (QTAILQ_FIRST(&uc->cpus)->stopped) {
-        qemu_cond_wait(uc->tcg_halt_cond, &uc->qemu_global_mutex);
-    }
-
-    while (1) {
-#if 0
-        int count = 0;
-        if (count < 10) {
-            count++;
-            unsigned int eip = X86_CPU(mycpu)->env.eip;
-            printf(">>> current EIP = %x\n", eip);
-            printf(">>> ECX = %x\n", (unsigned int)X86_CPU(mycpu)->env.regs[R_ECX]);
-            printf(">>> EDX = %x\n", (unsigned int)X86_CPU(mycpu)->env.regs[R_EDX]);
-        }
-#endif
-
-        if (tcg_exec_all(uc))
-            break;
-    }
-
-    CPU_FOREACH(cpu) {
-        cpu->thread_id = 0;
-        cpu->created = false;
-    }
-
-    qemu_mutex_unlock(&uc->qemu_global_mutex);
-
-    return NULL;
-}
-
-
-
-/* For temporary buffers for forming a name */
-#define VCPU_THREAD_NAME_SIZE 16
-
 static int qemu_tcg_init_vcpu(CPUState *cpu)
 {
     struct uc_struct *uc = cpu->uc;
-    char thread_name[VCPU_THREAD_NAME_SIZE];
 
     tcg_cpu_address_space_init(cpu, cpu->as);
 
-    /* share a single thread for all cpus with TCG */
+    /* emulation runs synchronously on the thread calling uc_emu_start();
+       record that thread so qemu_cpu_is_self() keeps working */
     if (!uc->tcg_cpu_thread) {
         cpu->thread = g_malloc0(sizeof(QemuThread));
-        cpu->halt_cond = g_malloc0(sizeof(QemuCond));
-        qemu_cond_init(cpu->halt_cond);
-        uc->tcg_halt_cond = cpu->halt_cond;
-        snprintf(thread_name, VCPU_THREAD_NAME_SIZE, "CPU %d/TCG",
-                cpu->cpu_index);
-        if (qemu_thread_create(uc, cpu->thread, thread_name, qemu_tcg_cpu_thread_fn,
-                cpu, QEMU_THREAD_JOINABLE))
-            return -1;
-#ifdef _WIN32
-        cpu->hThread = qemu_thread_get_handle(cpu->thread);
-#endif
-        while (!cpu->created) {
-            qemu_cond_wait(&uc->qemu_cpu_cond, &uc->qemu_global_mutex);
-        }
+        qemu_thread_get_self(cpu->thread);
+        cpu->thread_id = qemu_get_thread_id();
         uc->tcg_cpu_thread = cpu->thread;
     } else {
         cpu->thread = uc->tcg_cpu_thread;
-        cpu->halt_cond = uc->tcg_halt_cond;
     }
 
     return 0;
@@ -221,19 +173,41 @@ static bool tcg_exec_all(struct uc_struct* uc)
     CPUState *next_cpu = uc->next_cpu;
 
     if (next_cpu == NULL) {
-        next_cpu = first_cpu;
+        next_cpu = QTAILQ_FIRST(&uc->cpus);
     }
 
     for (; next_cpu != NULL && !uc->exit_request; next_cpu = CPU_NEXT(next_cpu)) {
         CPUState *cpu = next_cpu;
         CPUArchState *env = cpu->env_ptr;
+        uint32_t slice = 0;
 
         //qemu_clock_enable(QEMU_CLOCK_VIRTUAL,
         //                  (cpu->singlestep_enabled & SSTEP_NOTIMER) == 0);
         if (cpu_can_run(cpu)) {
+            // hand the vCPU its round-robin slice: the smaller of the
+            // scheduling quantum and what is left of the run's budget
+            if (uc->vcpu_count > 1) {
+                slice = uc->vcpu_quantum;
+                if (uc->emu_count > 0 && uc->emu_count_left < (size_t)slice) {
+                    slice = uc->emu_count_left;
+                }
+                cpu->icount_decr.u16.low = slice;
+                cpu->icount_extra = 0;
+            }
+
             uc->quit_request = false;
             r = tcg_cpu_exec(uc, env);
 
+            // charge the consumed part of the slice against the shared
+            // budget; the run ends when the budget does
+            if (uc->vcpu_count > 1 && uc->emu_count > 0) {
+                uc->emu_count_left -= slice - cpu->icount_decr.u16.low;
+                if (uc->emu_count_left == 0) {
+                    finish = true;
+                    break;
+                }
+            }
+
             // quit current TB but continue emulating?
             if (uc->quit_request) {
                 // reset stop_request
@@ -249,6 +223,9 @@ static bool tcg_exec_all(struct uc_struct* uc)
                 // printf(">>> invalid memory accessed, STOP = %u!!!\n", env->invalid_error);
                 uc->invalid_addr = env->invalid_addr;
                 uc->invalid_error = env->invalid_error;
+                // consumed: a run suspended under a nested uc_emu_start()
+                // must not see the sub-emulation's fault again on resume
+                env->invalid_error = 0;
                 finish = true;
                 break;
             }
@@ -258,8 +235,24 @@ static bool tcg_exec_all(struct uc_struct* uc)
                 cpu_handle_guest_debug(cpu);
                 break;
             }
-            if (r == EXCP_HLT) {
+            if (r == EXCP_HLT || (r == EXCP_HALTED && uc->vcpu_count > 1)) {
                 //printf(">>> got HLT!!!\n");
+                if (uc->vcpu_count > 1) {
+                    // a halted vCPU parks; the run only ends when every
+                    // vCPU has halted
+                    CPUState *other;
+                    bool all_halted = true;
+
+                    CPU_FOREACH(other) {
+                        if (!other->halted) {
+                            all_halted = false;
+                            break;
+                        }
+                    }
+                    if (!all_halted) {
+                        continue;
+                    }
+                }
                 finish = true;
                 break;
             }
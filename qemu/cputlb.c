@@ -33,6 +33,7 @@
 #include "tcg/tcg.h"
 
 #include "uc_priv.h"
+#include "uc_probe.h"
 
 //#define DEBUG_TLB
 //#define DEBUG_TLB_CHECK
@@ -63,6 +64,8 @@ void tlb_flush(CPUState *cpu, int flush_global)
 {
     CPUArchState *env = cpu->env_ptr;
 
+    UC_PROBE1(tlb_flush, flush_global);
+
 #if defined(DEBUG_TLB)
     printf("tlb_flush:\n");
 #endif
@@ -70,9 +73,22 @@ void tlb_flush(CPUState *cpu, int flush_global)
        links while we are modifying them */
     cpu->current_tb = NULL;
 
-    memset(env->tlb_table, -1, sizeof(env->tlb_table));
+    /* only the first tlb_entries slots of each row are ever populated,
+       so a small per-instance TLB also makes every flush cheaper */
+    if (cpu->uc->tlb_entries == CPU_TLB_SIZE) {
+        memset(env->tlb_table, -1, sizeof(env->tlb_table));
+    } else {
+        int mmu_idx;
+
+        for (mmu_idx = 0; mmu_idx < NB_MMU_MODES; mmu_idx++) {
+            memset(env->tlb_table[mmu_idx], -1,
+                   cpu->uc->tlb_entries * sizeof(CPUTLBEntry));
+        }
+    }
     memset(env->tlb_v_table, -1, sizeof(env->tlb_v_table));
-    memset(cpu->tb_jmp_cache, 0, sizeof(cpu->tb_jmp_cache));
+    tb_jmp_cache_flush(cpu);
+    /* direct jumps into two-page TBs depend on the flushed mappings */
+    tb_crosspage_unchain(cpu->uc, (target_ulong)-1);
 
     env->vtlb_index = 0;
     env->tlb_flush_addr = -1;
@@ -104,7 +120,7 @@ void tlb_flush_page(CPUState *cpu, target_ulong addr)
     cpu->current_tb = NULL;
 
     addr &= TARGET_PAGE_MASK;
-    i = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    i = (addr >> TARGET_PAGE_BITS) & (cpu->uc->tlb_entries - 1);
     for (mmu_idx = 0; mmu_idx < NB_MMU_MODES; mmu_idx++) {
         tlb_flush_entry(&env->tlb_table[mmu_idx][i], addr);
     }
@@ -118,6 +134,30 @@ void tlb_flush_page(CPUState *cpu, target_ulong addr)
     }
 
     tb_flush_jmp_cache(cpu, addr);
+    /* direct jumps into two-page TBs depend on this page's mapping */
+    tb_crosspage_unchain(cpu->uc, addr);
+}
+
+/* Flush only the TLB entries covering [addr, addr + len), so a mapping or
+   protection change on a few pages does not throw away every warm entry.
+   Falls back to a full flush when the range spans more pages than the TLB
+   has slots, where the per-page walk costs more than refilling from
+   scratch. */
+void tlb_flush_range(CPUState *cpu, target_ulong addr, target_ulong len)
+{
+    target_ulong end = addr + len;
+
+    if (len == 0) {
+        return;
+    }
+    /* full flush on overflow or ranges larger than the TLB itself */
+    if (end < addr || (len >> TARGET_PAGE_BITS) >= cpu->uc->tlb_entries) {
+        tlb_flush(cpu, 1);
+        return;
+    }
+    for (addr &= TARGET_PAGE_MASK; addr < end; addr += TARGET_PAGE_SIZE) {
+        tlb_flush_page(cpu, addr);
+    }
 }
 
 /* update the TLBs so that writes to code in the virtual page 'addr'
@@ -162,7 +202,7 @@ void cpu_tlb_reset_dirty_all(struct uc_struct *uc,
         for (mmu_idx = 0; mmu_idx < NB_MMU_MODES; mmu_idx++) {
             unsigned int i;
 
-            for (i = 0; i < CPU_TLB_SIZE; i++) {
+            for (i = 0; i < cpu->uc->tlb_entries; i++) {
                 tlb_reset_dirty_range(&env->tlb_table[mmu_idx][i],
                                       start1, length);
             }
@@ -183,7 +223,7 @@ void tlb_set_dirty(CPUArchState *env, target_ulong vaddr)
     int mmu_idx;
 
     vaddr &= TARGET_PAGE_MASK;
-    i = (vaddr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    i = (vaddr >> TARGET_PAGE_BITS) & (env->uc->tlb_entries - 1);
     for (mmu_idx = 0; mmu_idx < NB_MMU_MODES; mmu_idx++) {
         tlb_set_dirty1(&env->tlb_table[mmu_idx][i], vaddr);
     }
@@ -213,6 +253,17 @@ void tlb_set_page(CPUState *cpu, target_ulong vaddr,
     CPUTLBEntry *te;
     hwaddr iotlb, xlat, sz;
     unsigned vidx = env->vtlb_index++ % CPU_VTLB_SIZE;
+    MemoryRegion *uc_mr;
+    uint32_t uc_perms;
+
+    cpu->uc->tlb_fill_count++;  /* reported by UC_QUERY_TLB_FILL_COUNT */
+
+    /* Unicorn: pages whose effective permissions restrict an access must
+       take the slow path, where the UC_PROT_* checks run. With the
+       per-page table from uc_mem_protect() this can differ from the
+       region-wide perms. */
+    uc_mr = memory_mapping(cpu->uc, vaddr);
+    uc_perms = uc_mr ? memory_perms(uc_mr, vaddr) : UC_PROT_ALL;
 
     assert(size >= TARGET_PAGE_SIZE);
     if (size != TARGET_PAGE_SIZE) {
@@ -244,7 +295,7 @@ void tlb_set_page(CPUState *cpu, target_ulong vaddr,
     iotlb = memory_region_section_get_iotlb(cpu, section, vaddr, paddr, xlat,
                                             prot, &address);
 
-    index = (vaddr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    index = (vaddr >> TARGET_PAGE_BITS) & (cpu->uc->tlb_entries - 1);
     te = &env->tlb_table[mmu_idx][index];
 
     /* do not discard the translation in te, evict it into a victim tlb */
@@ -256,6 +307,16 @@ void tlb_set_page(CPUState *cpu, target_ulong vaddr,
     te->addend = addend - vaddr;
     if (prot & PAGE_READ) {
         te->addr_read = address;
+        /* Unicorn: only pages intersecting a memory hook range pay the
+           instrumented slow path; everything else keeps the inline TLB
+           fast path generated by the TCG backend.  */
+        if (HOOK_EXISTS_RANGE(cpu->uc, UC_HOOK_MEM_READ, vaddr,
+                              vaddr + TARGET_PAGE_SIZE - 1)
+                || uc_watch_exists_range(cpu->uc, UC_HOOK_MEM_READ, vaddr,
+                                         vaddr + TARGET_PAGE_SIZE - 1)
+                || !(uc_perms & UC_PROT_READ)) {
+            te->addr_read |= TLB_UCHOOK;
+        }
     } else {
         te->addr_read = -1;
     }
@@ -277,6 +338,14 @@ void tlb_set_page(CPUState *cpu, target_ulong vaddr,
         } else {
             te->addr_write = address;
         }
+        /* Unicorn: see addr_read above */
+        if (HOOK_EXISTS_RANGE(cpu->uc, UC_HOOK_MEM_WRITE, vaddr,
+                              vaddr + TARGET_PAGE_SIZE - 1)
+                || uc_watch_exists_range(cpu->uc, UC_HOOK_MEM_WRITE, vaddr,
+                                         vaddr + TARGET_PAGE_SIZE - 1)
+                || !(uc_perms & UC_PROT_WRITE)) {
+            te->addr_write |= TLB_UCHOOK;
+        }
     } else {
         te->addr_write = -1;
     }
@@ -295,7 +364,7 @@ tb_page_addr_t get_page_addr_code(CPUArchState *env1, target_ulong addr)
     ram_addr_t  ram_addr;
     CPUState *cpu = ENV_GET_CPU(env1);
 
-    page_index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    page_index = (addr >> TARGET_PAGE_BITS) & (env1->uc->tlb_entries - 1);
     mmu_idx = cpu_mmu_index(env1);
     if (unlikely(env1->tlb_table[mmu_idx][page_index].addr_code !=
                  (addr & TARGET_PAGE_MASK))) {
@@ -46,6 +46,7 @@
 #include "exec/ram_addr.h"
 
 #include "qemu/range.h"
+#include "qemu/thread.h"
 
 #include "uc_priv.h"
 
@@ -505,6 +506,7 @@ int cpu_watchpoint_insert(CPUState *cpu, vaddr addr, vaddr len,
     } else {
         QTAILQ_INSERT_TAIL(&cpu->watchpoints, wp, entry);
     }
+    cpu->watchpoint_count++;
 
     tlb_flush_page(cpu, addr);
 
@@ -533,6 +535,7 @@ int cpu_watchpoint_remove(CPUState *cpu, vaddr addr, vaddr len,
 void cpu_watchpoint_remove_by_ref(CPUState *cpu, CPUWatchpoint *watchpoint)
 {
     QTAILQ_REMOVE(&cpu->watchpoints, watchpoint, entry);
+    cpu->watchpoint_count--;
 
     tlb_flush_page(cpu, watchpoint->vaddr);
 
@@ -747,6 +750,338 @@ void cpu_physical_memory_reset_dirty(struct uc_struct* uc,
     }
 }
 
+/* The page copy of a snapshot or restore is fanned out over a few
+   transient worker threads once there is enough guest RAM to make it
+   pay: a single-threaded memcpy nowhere near saturates the memory
+   channels of a large host, and the copy is what bounds the
+   snapshot/restore rate on multi-GB guests.  More workers than this
+   stop helping well before the core count does.  */
+#define SNAPSHOT_COPY_WORKERS 4
+/* below this much RAM the copy is cheaper than the thread creation */
+#define SNAPSHOT_COPY_PARALLEL_MIN (32u << 20)
+
+struct snapshot_copy {
+    struct uc_struct *uc;
+    struct uc_snapshot *snapshot;
+    uint8_t **hosts;        /* host base of each snapshot block */
+    int index, nb_workers;
+    bool restore;
+};
+
+/* Copy this worker's shard - the index'th slice of every block's pages.
+   The slices are disjoint page ranges and the dirty bitmap is only read,
+   so the workers need no synchronization beyond the final joins.  */
+static void *snapshot_copy_worker(void *opaque)
+{
+    struct snapshot_copy *c = opaque;
+    uint32_t i;
+
+    for (i = 0; i < c->snapshot->block_count; i++) {
+        struct snapshot_block *sb = &c->snapshot->blocks[i];
+        uint8_t *host = c->hosts[i];
+        ram_addr_t pages = (sb->length + TARGET_PAGE_SIZE - 1) /
+                TARGET_PAGE_SIZE;
+        ram_addr_t lo = pages * c->index / c->nb_workers * TARGET_PAGE_SIZE;
+        ram_addr_t hi = pages * (c->index + 1) / c->nb_workers *
+                TARGET_PAGE_SIZE;
+        ram_addr_t off;
+
+        hi = MIN(hi, sb->length);
+        for (off = lo; off < hi; off += TARGET_PAGE_SIZE) {
+            size_t chunk = MIN(TARGET_PAGE_SIZE, sb->length - off);
+
+            if (c->restore) {
+                if (cpu_physical_memory_get_dirty_flag(c->uc,
+                            sb->offset + off, DIRTY_MEMORY_MIGRATION)) {
+                    memcpy(host + off, sb->data + off, chunk);
+                }
+            } else {
+                /* only copy pages that contain data: the buffer comes
+                   back zeroed, so skipping an all-zero page both avoids
+                   the copy and leaves its backing unallocated.  Most of
+                   a typical guest space is zero. */
+                if (!buffer_is_zero(host + off, chunk)) {
+                    memcpy(sb->data + off, host + off, chunk);
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+static void snapshot_copy_run(struct uc_struct *uc,
+                              struct uc_snapshot *snapshot, uint8_t **hosts,
+                              uint64_t total, bool restore)
+{
+    struct snapshot_copy args[SNAPSHOT_COPY_WORKERS];
+    QemuThread threads[SNAPSHOT_COPY_WORKERS];
+    int nb_workers = SNAPSHOT_COPY_WORKERS;
+    int i, spawned = 0;
+
+    if (total < SNAPSHOT_COPY_PARALLEL_MIN) {
+        nb_workers = 1;
+    }
+    for (i = 0; i < nb_workers; i++) {
+        args[i].uc = uc;
+        args[i].snapshot = snapshot;
+        args[i].hosts = hosts;
+        args[i].index = i;
+        args[i].nb_workers = nb_workers;
+        args[i].restore = restore;
+    }
+    for (i = 1; i < nb_workers; i++) {
+        /* a failed spawn is not fatal: the leftover shards run inline */
+        if (qemu_thread_create(&threads[i], "snapcopy", snapshot_copy_worker,
+                               &args[i], QEMU_THREAD_JOINABLE)) {
+            break;
+        }
+        spawned = i;
+    }
+    /* shard 0 always runs on the calling thread */
+    snapshot_copy_worker(&args[0]);
+    for (i = spawned + 1; i < nb_workers; i++) {
+        snapshot_copy_worker(&args[i]);
+    }
+    for (i = 1; i <= spawned; i++) {
+        qemu_thread_join(&threads[i]);
+    }
+}
+
+/* Capture the current contents of guest RAM for uc_snapshot(), then reset
+   the migration dirty bitmap so that a later memory_restore_ram() only has
+   to copy back the pages that were written in the meantime.  */
+int memory_snapshot_ram(struct uc_struct *uc, struct uc_snapshot *snapshot)
+{
+    RAMBlock *block;
+    struct snapshot_block *sb;
+    uint8_t **hosts;
+    uint64_t total = 0;
+    uint32_t count = 0;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        count++;
+    }
+
+    snapshot->blocks = g_malloc0(count * sizeof(*snapshot->blocks));
+    if (snapshot->blocks == NULL) {
+        return -1;
+    }
+    hosts = g_malloc0(count * sizeof(*hosts));
+    if (hosts == NULL) {
+        memory_snapshot_free_ram(uc, snapshot);
+        return -1;
+    }
+
+    sb = snapshot->blocks;
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        sb->offset = block->offset;
+        sb->length = block->length;
+        sb->data = g_malloc0(block->length);
+        if (sb->data == NULL) {
+            g_free(hosts);
+            memory_snapshot_free_ram(uc, snapshot);
+            return -1;
+        }
+        hosts[snapshot->block_count] = block->host;
+        total += block->length;
+        snapshot->block_count++;
+        sb++;
+    }
+
+    snapshot_copy_run(uc, snapshot, hosts, total, false);
+    g_free(hosts);
+
+    /* from here on, track which pages get written to */
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        cpu_physical_memory_reset_dirty(uc, block->offset, block->length,
+                                        DIRTY_MEMORY_MIGRATION);
+    }
+
+    return 0;
+}
+
+/* Copy back the pages dirtied since memory_snapshot_ram(), and re-arm the
+   dirty bitmap so the snapshot can be restored again.  */
+int memory_restore_ram(struct uc_struct *uc, struct uc_snapshot *snapshot)
+{
+    struct snapshot_block *sb;
+    RAMBlock *block;
+    ram_addr_t addr, end;
+    uint8_t **hosts;
+    uint64_t total = 0;
+    uint32_t i;
+
+    hosts = g_malloc0(snapshot->block_count * sizeof(*hosts));
+    if (hosts == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < snapshot->block_count; i++) {
+        sb = &snapshot->blocks[i];
+        block = qemu_get_ram_block(uc, sb->offset);
+        if (block == NULL || block->offset != sb->offset
+                || block->length != sb->length) {
+            /* the mapping layout changed since the snapshot was taken */
+            g_free(hosts);
+            return -1;
+        }
+        hosts[i] = block->host;
+        total += sb->length;
+    }
+
+    snapshot_copy_run(uc, snapshot, hosts, total, true);
+    g_free(hosts);
+
+    /* the translated-code bookkeeping is not thread safe, so the dirty
+       pages are walked again here for the invalidations; against the
+       copy above this rescan is noise */
+    for (i = 0; i < snapshot->block_count; i++) {
+        sb = &snapshot->blocks[i];
+
+        end = sb->offset + sb->length;
+        for (addr = sb->offset; addr < end; addr += TARGET_PAGE_SIZE) {
+            if (!cpu_physical_memory_get_dirty_flag(uc, addr,
+                                                    DIRTY_MEMORY_MIGRATION)) {
+                continue;
+            }
+            /* drop any code translated from the dirtied page */
+            tb_invalidate_phys_page_range(uc, addr, addr + TARGET_PAGE_SIZE, 0);
+        }
+
+        cpu_physical_memory_reset_dirty(uc, sb->offset, sb->length,
+                                        DIRTY_MEMORY_MIGRATION);
+    }
+
+    return 0;
+}
+
+void memory_snapshot_free_ram(struct uc_struct *uc, struct uc_snapshot *snapshot)
+{
+    uint32_t i;
+
+    for (i = 0; i < snapshot->block_count; i++) {
+        g_free(snapshot->blocks[i].data);
+    }
+    g_free(snapshot->blocks);
+    snapshot->blocks = NULL;
+    snapshot->block_count = 0;
+}
+
+/* Base offset of the RAM block containing @addr.  Identifies the mapped
+   region code at @addr belongs to (every uc_mem_map() region has its own
+   block); used to key the code-buffer allocation groups in
+   tb_group_select().  */
+ram_addr_t qemu_ram_block_base(struct uc_struct *uc, ram_addr_t addr)
+{
+    return qemu_get_ram_block(uc, addr)->offset;
+}
+
+/* Record which pages were written since the migration bitmap was last
+   reset (i.e. since the previous checkpoint of the ring was taken), one
+   bitmap per RAM block. uc_rewind() steps from a checkpoint to its
+   predecessor by copying back only these pages.  */
+int memory_ckpt_delta(struct uc_struct *uc, struct uc_ckpt_delta *delta)
+{
+    const unsigned long *dirty = uc->ram_list.dirty_memory[DIRTY_MEMORY_MIGRATION];
+    RAMBlock *block;
+    struct ckpt_delta_block *db;
+    uint32_t count = 0;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        count++;
+    }
+
+    delta->blocks = g_malloc0(count * sizeof(*delta->blocks));
+    if (delta->blocks == NULL) {
+        return -1;
+    }
+
+    db = delta->blocks;
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        unsigned long pages, page, end, found;
+
+        db->offset = block->offset;
+        db->length = block->length;
+        pages = (block->length + TARGET_PAGE_SIZE - 1) >> TARGET_PAGE_BITS;
+        db->bits = g_malloc0(BITS_TO_LONGS(pages) * sizeof(unsigned long));
+        if (db->bits == NULL) {
+            memory_ckpt_delta_free(uc, delta);
+            return -1;
+        }
+        /* jump from one dirty page to the next; the bitmap is mostly
+           clean when checkpoints are frequent */
+        page = block->offset >> TARGET_PAGE_BITS;
+        end = (block->offset + block->length) >> TARGET_PAGE_BITS;
+        for (found = find_next_bit(dirty, end, page);
+             found < end;
+             found = find_next_bit(dirty, end, found + 1)) {
+            set_bit(found - page, db->bits);
+        }
+        delta->block_count++;
+        db++;
+    }
+
+    return 0;
+}
+
+/* Copy the pages marked in @delta back from @snapshot (the checkpoint
+   taken just before those pages were dirtied), dropping any code
+   translated from them. Returns -1 if the mapping layout changed.  */
+int memory_ckpt_apply(struct uc_struct *uc, struct uc_snapshot *snapshot,
+        struct uc_ckpt_delta *delta)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < delta->block_count; i++) {
+        struct ckpt_delta_block *db = &delta->blocks[i];
+        struct snapshot_block *sb = NULL;
+        RAMBlock *block;
+        unsigned long pages, page;
+
+        block = qemu_get_ram_block(uc, db->offset);
+        if (block == NULL || block->offset != db->offset
+                || block->length != db->length) {
+            return -1;
+        }
+        for (j = 0; j < snapshot->block_count; j++) {
+            if (snapshot->blocks[j].offset == db->offset) {
+                sb = &snapshot->blocks[j];
+                break;
+            }
+        }
+        if (sb == NULL || sb->length != db->length) {
+            return -1;
+        }
+
+        pages = (db->length + TARGET_PAGE_SIZE - 1) >> TARGET_PAGE_BITS;
+        for (page = find_next_bit(db->bits, pages, 0);
+             page < pages;
+             page = find_next_bit(db->bits, pages, page + 1)) {
+            ram_addr_t off = (ram_addr_t)page << TARGET_PAGE_BITS;
+            size_t chunk = MIN(TARGET_PAGE_SIZE, db->length - off);
+
+            memcpy(block->host + off, sb->data + off, chunk);
+            /* drop any code translated from the rewound page */
+            tb_invalidate_phys_page_range(uc, db->offset + off,
+                                          db->offset + off + chunk, 0);
+        }
+    }
+
+    return 0;
+}
+
+void memory_ckpt_delta_free(struct uc_struct *uc, struct uc_ckpt_delta *delta)
+{
+    uint32_t i;
+
+    for (i = 0; i < delta->block_count; i++) {
+        g_free(delta->blocks[i].bits);
+    }
+    g_free(delta->blocks);
+    delta->blocks = NULL;
+    delta->block_count = 0;
+}
+
 hwaddr memory_region_section_get_iotlb(CPUState *cpu,
         MemoryRegionSection *section,
         target_ulong vaddr,
@@ -772,14 +1107,17 @@ hwaddr memory_region_section_get_iotlb(CPUState *cpu,
     }
 
     /* Make accesses to pages with watchpoints go via the
-       watchpoint trap routines.  */
-    QTAILQ_FOREACH(wp, &cpu->watchpoints, entry) {
-        if (cpu_watchpoint_address_matches(wp, vaddr, TARGET_PAGE_SIZE)) {
-            /* Avoid trapping reads of pages with a write breakpoint. */
-            if ((prot & PAGE_WRITE) || (wp->flags & BP_MEM_READ)) {
-                iotlb = PHYS_SECTION_WATCH + paddr;
-                *address |= TLB_MMIO;
-                break;
+       watchpoint trap routines.  Engines without watchpoints - the vast
+       majority - skip the walk on every TLB fill.  */
+    if (unlikely(cpu->watchpoint_count)) {
+        QTAILQ_FOREACH(wp, &cpu->watchpoints, entry) {
+            if (cpu_watchpoint_address_matches(wp, vaddr, TARGET_PAGE_SIZE)) {
+                /* Avoid trapping reads of pages with a write breakpoint. */
+                if ((prot & PAGE_WRITE) || (wp->flags & BP_MEM_READ)) {
+                    iotlb = PHYS_SECTION_WATCH + paddr;
+                    *address |= TLB_MMIO;
+                    break;
+                }
             }
         }
     }
@@ -1080,6 +1418,10 @@ static ram_addr_t ram_block_add(struct uc_struct *uc, RAMBlock *new_block, Error
     //qemu_madvise(new_block->host, new_block->length, QEMU_MADV_HUGEPAGE);
     //qemu_madvise(new_block->host, new_block->length, QEMU_MADV_DONTFORK);
 
+    /* regions are created 1:1 with RAMBlocks, so cache the host base on the
+       region and spare later lookups the walk over ram_list */
+    new_block->mr->ram_host = new_block->host;
+
     return new_block->offset;
 }
 
@@ -1128,6 +1470,9 @@ void qemu_ram_free_from_ptr(struct uc_struct *uc, ram_addr_t addr)
             QTAILQ_REMOVE(&uc->ram_list.blocks, block, next);
             uc->ram_list.mru_block = NULL;
             uc->ram_list.version++;
+            if (block->mr) {
+                block->mr->ram_host = NULL;
+            }
             g_free(block);
             break;
         }
@@ -1146,6 +1491,9 @@ void qemu_ram_free(struct uc_struct *uc, ram_addr_t addr)
             QTAILQ_REMOVE(&uc->ram_list.blocks, block, next);
             uc->ram_list.mru_block = NULL;
             uc->ram_list.version++;
+            if (block->mr) {
+                block->mr->ram_host = NULL;
+            }
             if (block->flags & RAM_PREALLOC) {
                 ;
 #ifndef _WIN32
@@ -1164,6 +1512,80 @@ void qemu_ram_free(struct uc_struct *uc, ram_addr_t addr)
 
 }
 
+#ifndef _WIN32
+/* Give the RAM block backing @mr a file backing, remapped in place so that
+   host pointers cached in this engine's TLB stay valid, and return the fd.
+   uc_clone() uses the fd to map the block copy-on-write into child engines.
+   Returns -1 on failure.  */
+int qemu_ram_make_shareable(struct uc_struct *uc, MemoryRegion *mr)
+{
+    RAMBlock *block = NULL, *b;
+    char path[] = "/tmp/unicorn-cow-XXXXXX";
+    size_t done = 0;
+    ssize_t n;
+    int fd;
+
+    QTAILQ_FOREACH(b, &uc->ram_list.blocks, next) {
+        if (b->mr == mr) {
+            block = b;
+            break;
+        }
+    }
+
+    /* blocks backed by user memory (uc_mem_map_ptr) cannot be shared */
+    if (block == NULL || (block->flags & RAM_PREALLOC)) {
+        return -1;
+    }
+
+    if (block->flags & RAM_SHARED) {
+        /* already converted by an earlier clone */
+        return block->fd;
+    }
+
+    fd = mkstemp(path);
+    if (fd < 0) {
+        return -1;
+    }
+    unlink(path);
+
+    while (done < block->length) {
+        n = write(fd, block->host + done, block->length - done);
+        if (n <= 0) {
+            close(fd);
+            return -1;
+        }
+        done += n;
+    }
+
+    /* replace the anonymous pages with the shared file mapping, in place */
+    if (mmap(block->host, block->length, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    block->fd = fd;
+    block->flags |= RAM_SHARED;
+
+    return fd;
+}
+
+/* Mark the RAM block backing @mr as owning its mmap'ed host memory, so that
+   qemu_ram_free() unmaps it. Used for the private mappings of uc_clone(),
+   which arrive through the RAM_PREALLOC (user owned) path.  */
+void qemu_ram_set_owned(struct uc_struct *uc, MemoryRegion *mr)
+{
+    RAMBlock *block;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        if (block->mr == mr) {
+            block->flags &= ~RAM_PREALLOC;
+            break;
+        }
+    }
+}
+#endif
+
 #ifndef _WIN32
 void qemu_ram_remap(struct uc_struct *uc, ram_addr_t addr, ram_addr_t length)
 {
@@ -1242,6 +1664,18 @@ void *qemu_get_ram_ptr(struct uc_struct *uc, ram_addr_t addr)
     return block->host + (addr - block->offset);
 }
 
+/* Like qemu_get_ram_ptr(), but uses the host base cached on the region at
+   allocation time.  Regions map 1:1 onto RAMBlocks here, which turns the
+   walk over ram_list into a field load on paths that already hold the
+   region.  */
+static inline void *memory_region_ram_ptr(MemoryRegion *mr, ram_addr_t addr)
+{
+    if (mr->ram_host) {
+        return mr->ram_host + (addr - (mr->ram_addr & TARGET_PAGE_MASK));
+    }
+    return qemu_get_ram_ptr(mr->uc, addr);
+}
+
 /* Return a host pointer to guest's ram. Similar to qemu_get_ram_ptr
  * but takes a size argument */
 static void *qemu_ram_ptr_length(struct uc_struct *uc, ram_addr_t addr, hwaddr *size)
@@ -1687,6 +2121,29 @@ bool address_space_rw(AddressSpace *as, hwaddr addr, uint8_t *buf,
     MemoryRegion *mr;
     bool error = false;
 
+    /* Fast path: when the whole request is direct RAM inside one region,
+     * resolve it once and memcpy straight to/from the RAMBlock host
+     * buffer, instead of re-translating and dispatching chunk by chunk.
+     * uc_mem_read()/uc_mem_write() always land here region by region.
+     */
+    if (len > 0) {
+        l = len;
+        mr = address_space_translate(as, addr, &addr1, &l, is_write);
+        if (!mr)
+            return true;
+        if (l == (hwaddr)len && memory_access_is_direct(mr, is_write)) {
+            addr1 += memory_region_get_ram_addr(mr);
+            ptr = memory_region_ram_ptr(mr, addr1);
+            if (is_write) {
+                memcpy(ptr, buf, len);
+                invalidate_and_set_dirty(as->uc, addr1, len);
+            } else {
+                memcpy(buf, ptr, len);
+            }
+            return false;
+        }
+    }
+
     while (len > 0) {
         l = len;
 
@@ -1726,7 +2183,7 @@ bool address_space_rw(AddressSpace *as, hwaddr addr, uint8_t *buf,
             } else {
                 addr1 += memory_region_get_ram_addr(mr);
                 /* RAM case */
-                ptr = qemu_get_ram_ptr(as->uc, addr1);
+                ptr = memory_region_ram_ptr(mr, addr1);
                 memcpy(ptr, buf, l);
                 invalidate_and_set_dirty(as->uc, addr1, l);
             }
@@ -1761,7 +2218,7 @@ bool address_space_rw(AddressSpace *as, hwaddr addr, uint8_t *buf,
                 }
             } else {
                 /* RAM case */
-                ptr = qemu_get_ram_ptr(as->uc, mr->ram_addr + addr1);
+                ptr = memory_region_ram_ptr(mr, mr->ram_addr + addr1);
                 memcpy(buf, ptr, l);
             }
         }
@@ -1814,7 +2271,7 @@ static inline void cpu_physical_memory_write_rom_internal(AddressSpace *as,
         } else {
             addr1 += memory_region_get_ram_addr(mr);
             /* ROM/RAM case */
-            ptr = qemu_get_ram_ptr(as->uc, addr1);
+            ptr = memory_region_ram_ptr(mr, addr1);
             switch (type) {
                 case WRITE_DATA:
                     memcpy(ptr, buf, l);
@@ -2009,7 +2466,7 @@ static inline uint32_t ldl_phys_internal(AddressSpace *as, hwaddr addr,
 #endif
     } else {
         /* RAM case */
-        ptr = qemu_get_ram_ptr(as->uc, (memory_region_get_ram_addr(mr)
+        ptr = memory_region_ram_ptr(mr, (memory_region_get_ram_addr(mr)
                     & TARGET_PAGE_MASK)
                 + addr1);
         switch (endian) {
@@ -2068,7 +2525,7 @@ static inline uint64_t ldq_phys_internal(AddressSpace *as, hwaddr addr,
 #endif
     } else {
         /* RAM case */
-        ptr = qemu_get_ram_ptr(as->uc, (memory_region_get_ram_addr(mr)
+        ptr = memory_region_ram_ptr(mr, (memory_region_get_ram_addr(mr)
                     & TARGET_PAGE_MASK)
                 + addr1);
         switch (endian) {
@@ -2135,7 +2592,7 @@ static inline uint32_t lduw_phys_internal(AddressSpace *as, hwaddr addr,
 #endif
     } else {
         /* RAM case */
-        ptr = qemu_get_ram_ptr(as->uc, (memory_region_get_ram_addr(mr)
+        ptr = memory_region_ram_ptr(mr, (memory_region_get_ram_addr(mr)
                     & TARGET_PAGE_MASK)
                 + addr1);
         switch (endian) {
@@ -2184,7 +2641,7 @@ void stl_phys_notdirty(AddressSpace *as, hwaddr addr, uint32_t val)
         io_mem_write(mr, addr1, val, 4);
     } else {
         addr1 += memory_region_get_ram_addr(mr) & TARGET_PAGE_MASK;
-        ptr = qemu_get_ram_ptr(as->uc, addr1);
+        ptr = memory_region_ram_ptr(mr, addr1);
         stl_p(ptr, val);
     }
 }
@@ -2215,7 +2672,7 @@ static inline void stl_phys_internal(AddressSpace *as,
     } else {
         /* RAM case */
         addr1 += memory_region_get_ram_addr(mr) & TARGET_PAGE_MASK;
-        ptr = qemu_get_ram_ptr(as->uc, addr1);
+        ptr = memory_region_ram_ptr(mr, addr1);
         switch (endian) {
             case DEVICE_LITTLE_ENDIAN:
                 stl_le_p(ptr, val);
@@ -2278,7 +2735,7 @@ static inline void stw_phys_internal(AddressSpace *as,
     } else {
         /* RAM case */
         addr1 += memory_region_get_ram_addr(mr) & TARGET_PAGE_MASK;
-        ptr = qemu_get_ram_ptr(as->uc, addr1);
+        ptr = memory_region_ram_ptr(mr, addr1);
         switch (endian) {
             case DEVICE_LITTLE_ENDIAN:
                 stw_le_p(ptr, val);
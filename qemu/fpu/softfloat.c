@@ -2016,6 +2016,118 @@ static float32 subFloat32Sigs( float32 a, float32 b, flag zSign STATUS_PARAM)
 
 }
 
+/*----------------------------------------------------------------------------
+| Host FPU fast path.  FP-heavy guests spend nearly all of their time in
+| round-to-nearest operations on normal values, which the host FPU already
+| computes bit-exactly.  The fast path is only taken when no IEEE flag
+| information can be lost: the rounding mode is nearest-even, denormal
+| flushing is off, and the sticky inexact flag is already set (real code
+| raises it within the first few operations and never clears it).  Inputs
+| must be normal or zero, and a host result that is an infinity, a NaN or a
+| subnormal falls back to the bit-exact code below, since those may have to
+| raise flags or pick NaN payloads.  The emulator never changes the host
+| rounding mode, but the embedding process may have (fesetround(), or FTZ/DAZ
+| enabled by -ffast-math startup code), so the host environment is checked
+| per call before it is trusted.
+*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+| Returns 1 when the host FP environment is at its IEEE defaults: rounding to
+| nearest-even and no denormal flushing.  Read straight from the control
+| register each time - unicorn is a library and the host application can
+| switch modes between calls; a control register read costs a few cycles
+| against a libm call for fegetround().
+*----------------------------------------------------------------------------*/
+
+static inline flag float_host_env_default( void )
+{
+#if defined( __x86_64__ )
+    uint32_t mxcsr;
+    __asm__ __volatile__( "stmxcsr %0" : "=m"( mxcsr ) );
+    /* RC (bits 13-14) nearest-even, FTZ (bit 15) and DAZ (bit 6) clear */
+    return ( mxcsr & 0xE040 ) == 0;
+#elif defined( __aarch64__ )
+    uint64_t fpcr;
+    __asm__ __volatile__( "mrs %0, fpcr" : "=r"( fpcr ) );
+    /* RMode (bits 22-23) nearest-even, FZ (bit 24) and FZ16 (bit 19)
+       clear */
+    return ( fpcr & 0x01C80000 ) == 0;
+#else
+    return 0;
+#endif
+}
+
+static inline flag float_use_host_fpu( float_status *status )
+{
+#if defined( __x86_64__ ) || defined( __aarch64__ )
+    return ( status->float_rounding_mode == float_round_nearest_even )
+        && ( status->float_exception_flags & float_flag_inexact )
+        && ! status->flush_to_zero
+        && ! status->flush_inputs_to_zero
+        && float_host_env_default();
+#else
+    /* other hosts may evaluate C float expressions in wider precision
+       (x87 excess precision) or flush denormals by default; keep them on
+       the bit-exact path */
+    return 0;
+#endif
+}
+
+static inline float float32_to_host( float32 a )
+{
+    union { float h; uint32_t v; } u;
+    u.v = float32_val( a );
+    return u.h;
+}
+
+static inline float32 float32_from_host( float h )
+{
+    union { float h; uint32_t v; } u;
+    u.h = h;
+    return make_float32( u.v );
+}
+
+static inline flag float32_host_arg_ok( float32 a )
+{
+    uint32_t v = float32_val( a );
+    int_fast16_t exp = ( v>>23 ) & 0xFF;
+    return ( exp != 0xFF ) && ( exp != 0 || ( v & 0x007FFFFF ) == 0 );
+}
+
+static inline flag float32_host_result_normal( float32 a )
+{
+    int_fast16_t exp = ( float32_val( a )>>23 ) & 0xFF;
+    return ( exp != 0 ) && ( exp != 0xFF );
+}
+
+static inline double float64_to_host( float64 a )
+{
+    union { double h; uint64_t v; } u;
+    u.v = float64_val( a );
+    return u.h;
+}
+
+static inline float64 float64_from_host( double h )
+{
+    union { double h; uint64_t v; } u;
+    u.h = h;
+    return make_float64( u.v );
+}
+
+static inline flag float64_host_arg_ok( float64 a )
+{
+    uint64_t v = float64_val( a );
+    int_fast16_t exp = ( v>>52 ) & 0x7FF;
+    return ( exp != 0x7FF )
+        && ( exp != 0 || ( v & LIT64( 0x000FFFFFFFFFFFFF ) ) == 0 );
+}
+
+static inline flag float64_host_result_normal( float64 a )
+{
+    int_fast16_t exp = ( float64_val( a )>>52 ) & 0x7FF;
+    return ( exp != 0 ) && ( exp != 0x7FF );
+}
+
 /*----------------------------------------------------------------------------
 | Returns the result of adding the single-precision floating-point values `a'
 | and `b'.  The operation is performed according to the IEC/IEEE Standard for
@@ -2025,6 +2137,17 @@ static float32 subFloat32Sigs( float32 a, float32 b, flag zSign STATUS_PARAM)
 float32 float32_add( float32 a, float32 b STATUS_PARAM )
 {
     flag aSign, bSign;
+
+    if ( float_use_host_fpu( status )
+         && float32_host_arg_ok( a ) && float32_host_arg_ok( b ) ) {
+        float32 r =
+            float32_from_host( float32_to_host( a ) + float32_to_host( b ) );
+        /* a sum that cancels to zero is exact; only infinities and
+           subnormals fall back to raise the right flags */
+        if ( float32_host_result_normal( r ) || float32_is_zero( r ) ) {
+            return r;
+        }
+    }
     a = float32_squash_input_denormal(a STATUS_VAR);
     b = float32_squash_input_denormal(b STATUS_VAR);
 
@@ -2048,6 +2171,15 @@ float32 float32_add( float32 a, float32 b STATUS_PARAM )
 float32 float32_sub( float32 a, float32 b STATUS_PARAM )
 {
     flag aSign, bSign;
+
+    if ( float_use_host_fpu( status )
+         && float32_host_arg_ok( a ) && float32_host_arg_ok( b ) ) {
+        float32 r =
+            float32_from_host( float32_to_host( a ) - float32_to_host( b ) );
+        if ( float32_host_result_normal( r ) || float32_is_zero( r ) ) {
+            return r;
+        }
+    }
     a = float32_squash_input_denormal(a STATUS_VAR);
     b = float32_squash_input_denormal(b STATUS_VAR);
 
@@ -2076,6 +2208,18 @@ float32 float32_mul( float32 a, float32 b STATUS_PARAM )
     uint64_t zSig64;
     uint32_t zSig;
 
+    if ( float_use_host_fpu( status )
+         && float32_host_arg_ok( a ) && float32_host_arg_ok( b ) ) {
+        float32 r =
+            float32_from_host( float32_to_host( a ) * float32_to_host( b ) );
+        /* a zero product is only exact when one factor is zero; a zero
+           produced by underflow falls back for the flags */
+        if ( float32_host_result_normal( r )
+             || ( float32_is_zero( r )
+                  && ( float32_is_zero( a ) || float32_is_zero( b ) ) ) ) {
+            return r;
+        }
+    }
     a = float32_squash_input_denormal(a STATUS_VAR);
     b = float32_squash_input_denormal(b STATUS_VAR);
 
@@ -2136,6 +2280,17 @@ float32 float32_div( float32 a, float32 b STATUS_PARAM )
     flag aSign, bSign, zSign;
     int_fast16_t aExp, bExp, zExp;
     uint32_t aSig, bSig, zSig;
+
+    if ( float_use_host_fpu( status )
+         && float32_host_arg_ok( a ) && float32_host_arg_ok( b ) ) {
+        float32 r =
+            float32_from_host( float32_to_host( a ) / float32_to_host( b ) );
+        /* a zero quotient is only exact when the dividend is zero */
+        if ( float32_host_result_normal( r )
+             || ( float32_is_zero( r ) && float32_is_zero( a ) ) ) {
+            return r;
+        }
+    }
     a = float32_squash_input_denormal(a STATUS_VAR);
     b = float32_squash_input_denormal(b STATUS_VAR);
 
@@ -2312,6 +2467,18 @@ float32 float32_muladd(float32 a, float32 b, float32 c, int flags STATUS_PARAM)
     int shiftcount;
     flag signflip, infzero;
 
+    if ( flags == 0 && float_use_host_fpu( status )
+         && float32_host_arg_ok( a ) && float32_host_arg_ok( b )
+         && float32_host_arg_ok( c ) ) {
+        float32 r = float32_from_host( __builtin_fmaf( float32_to_host( a ),
+                                                       float32_to_host( b ),
+                                                       float32_to_host( c ) ) );
+        /* only plain normal results are safe here: exact-zero analysis for
+           a fused multiply-add is not worth the extra tests */
+        if ( float32_host_result_normal( r ) ) {
+            return r;
+        }
+    }
     a = float32_squash_input_denormal(a STATUS_VAR);
     b = float32_squash_input_denormal(b STATUS_VAR);
     c = float32_squash_input_denormal(c STATUS_VAR);
@@ -3769,6 +3936,17 @@ static float64 subFloat64Sigs( float64 a, float64 b, flag zSign STATUS_PARAM )
 float64 float64_add( float64 a, float64 b STATUS_PARAM )
 {
     flag aSign, bSign;
+
+    if ( float_use_host_fpu( status )
+         && float64_host_arg_ok( a ) && float64_host_arg_ok( b ) ) {
+        float64 r =
+            float64_from_host( float64_to_host( a ) + float64_to_host( b ) );
+        /* a sum that cancels to zero is exact; only infinities and
+           subnormals fall back to raise the right flags */
+        if ( float64_host_result_normal( r ) || float64_is_zero( r ) ) {
+            return r;
+        }
+    }
     a = float64_squash_input_denormal(a STATUS_VAR);
     b = float64_squash_input_denormal(b STATUS_VAR);
 
@@ -3792,6 +3970,15 @@ float64 float64_add( float64 a, float64 b STATUS_PARAM )
 float64 float64_sub( float64 a, float64 b STATUS_PARAM )
 {
     flag aSign, bSign;
+
+    if ( float_use_host_fpu( status )
+         && float64_host_arg_ok( a ) && float64_host_arg_ok( b ) ) {
+        float64 r =
+            float64_from_host( float64_to_host( a ) - float64_to_host( b ) );
+        if ( float64_host_result_normal( r ) || float64_is_zero( r ) ) {
+            return r;
+        }
+    }
     a = float64_squash_input_denormal(a STATUS_VAR);
     b = float64_squash_input_denormal(b STATUS_VAR);
 
@@ -3818,6 +4005,18 @@ float64 float64_mul( float64 a, float64 b STATUS_PARAM )
     int_fast16_t aExp, bExp, zExp;
     uint64_t aSig, bSig, zSig0, zSig1;
 
+    if ( float_use_host_fpu( status )
+         && float64_host_arg_ok( a ) && float64_host_arg_ok( b ) ) {
+        float64 r =
+            float64_from_host( float64_to_host( a ) * float64_to_host( b ) );
+        /* a zero product is only exact when one factor is zero; a zero
+           produced by underflow falls back for the flags */
+        if ( float64_host_result_normal( r )
+             || ( float64_is_zero( r )
+                  && ( float64_is_zero( a ) || float64_is_zero( b ) ) ) ) {
+            return r;
+        }
+    }
     a = float64_squash_input_denormal(a STATUS_VAR);
     b = float64_squash_input_denormal(b STATUS_VAR);
 
@@ -3880,6 +4079,17 @@ float64 float64_div( float64 a, float64 b STATUS_PARAM )
     uint64_t aSig, bSig, zSig;
     uint64_t rem0, rem1;
     uint64_t term0, term1;
+
+    if ( float_use_host_fpu( status )
+         && float64_host_arg_ok( a ) && float64_host_arg_ok( b ) ) {
+        float64 r =
+            float64_from_host( float64_to_host( a ) / float64_to_host( b ) );
+        /* a zero quotient is only exact when the dividend is zero */
+        if ( float64_host_result_normal( r )
+             || ( float64_is_zero( r ) && float64_is_zero( a ) ) ) {
+            return r;
+        }
+    }
     a = float64_squash_input_denormal(a STATUS_VAR);
     b = float64_squash_input_denormal(b STATUS_VAR);
 
@@ -4046,6 +4256,18 @@ float64 float64_muladd(float64 a, float64 b, float64 c, int flags STATUS_PARAM)
     int shiftcount;
     flag signflip, infzero;
 
+    if ( flags == 0 && float_use_host_fpu( status )
+         && float64_host_arg_ok( a ) && float64_host_arg_ok( b )
+         && float64_host_arg_ok( c ) ) {
+        float64 r = float64_from_host( __builtin_fma( float64_to_host( a ),
+                                                      float64_to_host( b ),
+                                                      float64_to_host( c ) ) );
+        /* only plain normal results are safe here: exact-zero analysis for
+           a fused multiply-add is not worth the extra tests */
+        if ( float64_host_result_normal( r ) ) {
+            return r;
+        }
+    }
     a = float64_squash_input_denormal(a STATUS_VAR);
     b = float64_squash_input_denormal(b STATUS_VAR);
     c = float64_squash_input_denormal(c STATUS_VAR);
@@ -16,13 +16,38 @@ symbols = (
     'tb_invalidate_phys_page_fast',
     'phys_mem_clean',
     'tb_cleanup',
+    'page_tree_reclaim',
+    'tb_profile_flush',
     'memory_map',
+    'memory_snapshot_ram',
+    'memory_restore_ram',
+    'memory_snapshot_free_ram',
+    'memory_ckpt_delta',
+    'memory_ckpt_apply',
+    'memory_ckpt_delta_free',
+    'qemu_ram_make_shareable',
+    'qemu_ram_set_owned',
     'memory_map_ptr',
+    'memory_map_io',
     'memory_unmap',
+    'memory_decommit',
+    'memory_dirty_query',
+    'memory_dirty_reset',
     'memory_free',
     'helper_raise_exception',
     'tcg_enabled',
     'tcg_exec_init',
+    'tcg_buffer_resize',
+    'tb_cache_save',
+    'tb_cache_load',
+    'tb_prewarm',
+    'tb_meta_get',
+    'tb_readahead',
+    'tb_stats',
+    'mem_stats',
+    'tb_crosspage_link',
+    'tb_crosspage_unchain',
+    'tb_superblock',
     'memory_register_types',
     'cpu_exec_init_all',
     'vm_start',
@@ -43,9 +68,6 @@ symbols = (
     'aarch64_banked_spsr_index',
     'aarch64_restore_sp',
     'aarch64_save_sp',
-    'accel_find',
-    'accel_init_machine',
-    'accel_type',
     'access_with_adjusted_size',
     'add128',
     'add16_sat',
@@ -87,16 +109,9 @@ symbols = (
     'addrrange_make',
     'addrrange_shift',
     'adjust_endianness',
-    'AES_cbc_encrypt',
-    'AES_decrypt',
-    'AES_encrypt',
     'AES_imc',
-    'AES_set_decrypt_key',
-    'AES_set_encrypt_key',
     'all_helpers',
     'alloc_code_gen_buffer',
-    'alloc_entry',
-    'always_true',
     'arm1026_initfn',
     'arm1136_initfn',
     'arm1136_r2_initfn',
@@ -154,6 +169,7 @@ symbols = (
     'tlb_fill',
     'tlb_flush',
     'tlb_flush_page',
+    'tlb_flush_range',
     'tlb_set_page',
     'arm_translate_init',
     'arm_v7m_class_init',
@@ -162,21 +178,15 @@ symbols = (
     'ats_write',
     'bad_mode_switch',
     'bank_number',
-    'bitmap_find_next_zero_area',
     'bitmap_zero_extend',
     'bp_wp_matches',
     'breakpoint_invalidate',
     'build_page_bitmap',
-    'bus_add_child',
-    'bus_class_init',
-    'bus_info',
-    'bus_unparent',
     'cache_block_ops_cp_reginfo',
     'cache_dirty_status_cp_reginfo',
     'cache_test_clean_cp_reginfo',
     'call_recip_estimate',
     'can_merge',
-    'capacity_increase',
     'ccsidr_read',
     'check_ap',
     'check_breakpoints',
@@ -192,12 +202,7 @@ symbols = (
     'commonNaNToFloat32',
     'commonNaNToFloat64',
     'commonNaNToFloatx80',
-    'compute_abs_deadline',
     'cond_name',
-    'configure_accelerator',
-    'container_get',
-    'container_info',
-    'container_register_types',
     'contextidr_write',
     'core_log_global_start',
     'core_log_global_stop',
@@ -234,23 +239,9 @@ symbols = (
     'cpu_breakpoint_remove_by_ref',
     'cpu_can_do_io',
     'cpu_can_run',
-    'cpu_class_init',
-    'cpu_common_class_by_name',
-    'cpu_common_exec_interrupt',
-    'cpu_common_get_arch_id',
-    'cpu_common_get_memory_mapping',
-    'cpu_common_get_paging_enabled',
-    'cpu_common_has_work',
-    'cpu_common_initfn',
-    'cpu_common_noop',
-    'cpu_common_parse_features',
-    'cpu_common_realizefn',
-    'cpu_common_reset',
-    'cpu_dump_statistics',
     'cpu_exec_init',
     'cpu_flush_icache_range',
     'cpu_gen_init',
-    'cpu_get_clock',
     'cpu_get_real_ticks',
     'cpu_get_tb_cpu_state',
     'cpu_handle_debug_exception',
@@ -287,7 +278,6 @@ symbols = (
     'cpu_physical_memory_write_rom',
     'cpu_physical_memory_write_rom_internal',
     'cpu_register',
-    'cpu_register_types',
     'cpu_restore_state',
     'cpu_restore_state_from_tb',
     'cpu_single_step',
@@ -296,14 +286,12 @@ symbols = (
     'cpu_to_be64',
     'cpu_to_le32',
     'cpu_to_le64',
-    'cpu_type_info',
     'cpu_unassigned_access',
     'cpu_watchpoint_address_matches',
     'cpu_watchpoint_insert',
     'cpu_watchpoint_remove',
     'cpu_watchpoint_remove_all',
     'cpu_watchpoint_remove_by_ref',
-    'crc32c_table',
     'create_new_memory_mapping',
     'csselr_write',
     'cto32',
@@ -326,15 +314,6 @@ symbols = (
     'deposit32',
     'deposit64',
     'deregister_tm_clones',
-    'device_class_base_init',
-    'device_class_init',
-    'device_finalize',
-    'device_get_realized',
-    'device_initfn',
-    'device_post_init',
-    'device_reset',
-    'device_set_realized',
-    'device_type_info',
     'disas_arm_insn',
     'disas_coproc_insn',
     'disas_dsp_insn',
@@ -362,19 +341,12 @@ symbols = (
     'do_usat',
     'do_v7m_exception_exit',
     'dummy_c15_cp_reginfo',
-    'dummy_func',
     'dummy_section',
     '_DYNAMIC',
     '_edata',
     '_end',
-    'end_list',
     'eq128',
     'ErrorClass_lookup',
-    'error_copy',
-    'error_exit',
-    'error_get_class',
-    'error_get_pretty',
-    'error_setg_file_open',
     'estimateDiv128To64',
     'estimateSqrt32',
     'excnames',
@@ -399,13 +371,10 @@ symbols = (
     'extractFloatx80Exp',
     'extractFloatx80Frac',
     'extractFloatx80Sign',
-    'fcntl_setfl',
     'fcse_write',
     'find_better_copy',
-    'find_default_machine',
     'find_desc_by_name',
     'find_first_bit',
-    'find_last_bit',
     'find_paging_enabled_cpu',
     'find_ram_block',
     'find_ram_offset',
@@ -609,13 +578,9 @@ symbols = (
     'floatx80_unordered',
     'floatx80_unordered_quiet',
     'flush_icache_range',
-    'format_string',
     'fp_decode_rm',
     'frame_dummy',
-    'free_range',
     'fstat64',
-    'futex_wait',
-    'futex_wake',
     'gen_aa32_ld16s',
     'gen_aa32_ld16u',
     'gen_aa32_ld32u',
@@ -1320,8 +1285,6 @@ symbols = (
     'get_level1_table_address',
     'get_mem_index',
     'get_next_param_value',
-    'get_opt_name',
-    'get_opt_value',
     'get_page_addr_code',
     'get_param_value',
     'get_phys_addr',
@@ -1354,7 +1317,6 @@ symbols = (
     'handle_vminmaxnm',
     'handle_vrint',
     'handle_vsel',
-    'has_help_option',
     'have_bmi1',
     'have_bmi2',
     'hcr_write',
@@ -1910,7 +1872,6 @@ symbols = (
     '_init',
     'init_cpreg_list',
     'init_lists',
-    'input_type_enum',
     'int128_2_64',
     'int128_add',
     'int128_addto',
@@ -1955,7 +1916,6 @@ symbols = (
     'io_writeq',
     'io_writew',
     'is_a64',
-    'is_help_option',
     'is_power_of_2',
     'isr_read',
     'is_valid_option_list',
@@ -1965,19 +1925,6 @@ symbols = (
     'iwmmxt_store_reg',
     '__jit_debug_descriptor',
     '__jit_debug_register_code',
-    'json_lexer',
-    'json_lexer_destroy',
-    'json_lexer_feed',
-    'json_lexer_feed_char',
-    'json_lexer_flush',
-    'json_lexer_init',
-    'json_message_parser_destroy',
-    'json_message_parser_feed',
-    'json_message_parser_flush',
-    'json_message_parser_init',
-    'json_message_process_token',
-    'json_parser_parse',
-    'json_parser_parse_err',
     'kvm_to_cpreg_id',
     'last_ram_offset',
     'ldl_be_p',
@@ -2013,11 +1960,6 @@ symbols = (
     'log_cpu_state',
     'lpae_cp_reginfo',
     'lt128',
-    'machine_class_init',
-    'machine_finalize',
-    'machine_info',
-    'machine_initfn',
-    'machine_register_types',
     'machvirt_init',
     'machvirt_machine_init',
     'maj',
@@ -2117,10 +2059,7 @@ symbols = (
     'memory_region_write_accessor',
     'memory_region_wrong_endianness',
     'memory_try_enable_merging',
-    'mktimegm',
-    'module_call_init',
     'module_load',
-    'mod_utf8_codepoint',
     'mpidr_cp_reginfo',
     'mpidr_read',
     'msr_mask',
@@ -2141,7 +2080,6 @@ symbols = (
     'neon_store_reg64',
     'neon_store_scratch',
     'new_ldst_label',
-    'next_list',
     'normalizeFloat128Subnormal',
     'normalizeFloat16Subnormal',
     'normalizeFloat32Subnormal',
@@ -2154,61 +2092,6 @@ symbols = (
     'not_v6_cp_reginfo',
     'not_v7_cp_reginfo',
     'not_v8_cp_reginfo',
-    'object_child_foreach',
-    'object_class_foreach',
-    'object_class_foreach_tramp',
-    'object_class_get_list',
-    'object_class_get_list_tramp',
-    'object_class_get_parent',
-    'object_deinit',
-    'object_dynamic_cast',
-    'object_finalize',
-    'object_finalize_child_property',
-    'object_get_child_property',
-    'object_get_link_property',
-    'object_get_root',
-    'object_initialize_with_type',
-    'object_init_with_type',
-    'object_instance_init',
-    'object_new_with_type',
-    'object_post_init_with_type',
-    'object_property_add_alias',
-    'object_property_add_link',
-    'object_property_add_uint16_ptr',
-    'object_property_add_uint32_ptr',
-    'object_property_add_uint64_ptr',
-    'object_property_add_uint8_ptr',
-    'object_property_allow_set_link',
-    'object_property_del',
-    'object_property_del_all',
-    'object_property_del_child',
-    'object_property_find',
-    'object_property_get',
-    'object_property_get_bool',
-    'object_property_get_enum',
-    'object_property_get_int',
-    'object_property_get_link',
-    'object_property_get_qobject',
-    'object_property_get_str',
-    'object_property_get_type',
-    'object_property_get_uint16List',
-    'object_property_is_child',
-    'object_property_print',
-    'object_property_set',
-    'object_property_set_description',
-    'object_property_set_link',
-    'object_property_set_qobject',
-    'object_release_link_property',
-    'object_resolve_abs_path',
-    'object_resolve_child_property',
-    'object_resolve_link',
-    'object_resolve_link_property',
-    'object_resolve_partial_path',
-    'object_resolve_path',
-    'object_resolve_path_component',
-    'object_resolve_path_type',
-    'object_set_link_property',
-    'object_unparent',
     'omap_cachemaint_write',
     'omap_cp_reginfo',
     'omap_threadid_write',
@@ -2222,7 +2105,6 @@ symbols = (
     'opts_do_parse',
     'opt_set',
     'opts_parse',
-    'output_type_enum',
     'packFloat128',
     'packFloat16',
     'packFloat32',
@@ -2242,10 +2124,6 @@ symbols = (
     'parse_keyword',
     'parse_literal',
     'parse_object',
-    'parse_optional',
-    'parse_option_bool',
-    'parse_option_number',
-    'parse_option_size',
     'parse_pair',
     'parser_context_free',
     'parser_context_new',
@@ -2253,14 +2131,6 @@ symbols = (
     'parser_context_pop_token',
     'parser_context_restore',
     'parser_context_save',
-    'parse_str',
-    'parse_type_bool',
-    'parse_type_int',
-    'parse_type_number',
-    'parse_type_size',
-    'parse_type_str',
-    'parse_uint',
-    'parse_uint_full',
     'parse_value',
     'par_write',
     'patch_reloc',
@@ -2298,32 +2168,12 @@ symbols = (
     'pmsav5_insn_ap_write',
     'pmuserenr_write',
     'pmxevtyper_write',
-    'pow2floor',
-    'print_type_bool',
-    'print_type_int',
-    'print_type_number',
-    'print_type_size',
-    'print_type_str',
     'propagateFloat128NaN',
     'propagateFloat32MulAddNaN',
     'propagateFloat32NaN',
     'propagateFloat64MulAddNaN',
     'propagateFloat64NaN',
     'propagateFloatx80NaN',
-    'property_get_alias',
-    'property_get_bool',
-    'property_get_str',
-    'property_get_uint16_ptr',
-    'property_get_uint32_ptr',
-    'property_get_uint64_ptr',
-    'property_get_uint8_ptr',
-    'property_release_alias',
-    'property_release_bool',
-    'property_release_str',
-    'property_resolve_alias',
-    'property_set_alias',
-    'property_set_bool',
-    'property_set_str',
     'pstate_read',
     'pstate_write',
     'pxa250_initfn',
@@ -2337,25 +2187,6 @@ symbols = (
     'pxa270b1_initfn',
     'pxa270c0_initfn',
     'pxa270c5_initfn',
-    'qapi_dealloc_end_implicit_struct',
-    'qapi_dealloc_end_list',
-    'qapi_dealloc_end_struct',
-    'qapi_dealloc_get_visitor',
-    'qapi_dealloc_next_list',
-    'qapi_dealloc_pop',
-    'qapi_dealloc_push',
-    'qapi_dealloc_start_implicit_struct',
-    'qapi_dealloc_start_list',
-    'qapi_dealloc_start_struct',
-    'qapi_dealloc_start_union',
-    'qapi_dealloc_type_bool',
-    'qapi_dealloc_type_enum',
-    'qapi_dealloc_type_int',
-    'qapi_dealloc_type_number',
-    'qapi_dealloc_type_size',
-    'qapi_dealloc_type_str',
-    'qapi_dealloc_visitor_cleanup',
-    'qapi_dealloc_visitor_new',
     'qapi_free_boolList',
     'qapi_free_ErrorClassList',
     'qapi_free_int16List',
@@ -2372,76 +2203,18 @@ symbols = (
     'qapi_free_X86CPUFeatureWordInfo',
     'qapi_free_X86CPUFeatureWordInfoList',
     'qapi_free_X86CPURegister32List',
-    'qbool_destroy_obj',
-    'qbool_from_int',
-    'qbool_get_int',
-    'qbool_type',
-    'qbus_create',
-    'qbus_create_inplace',
-    'qbus_finalize',
-    'qbus_initfn',
-    'qbus_realize',
-    'qdev_create',
-    'qdev_get_type',
-    'qdev_register_types',
-    'qdev_set_parent_bus',
-    'qdev_try_create',
-    'qdict_add_key',
-    'qdict_array_split',
-    'qdict_clone_shallow',
-    'qdict_del',
-    'qdict_destroy_obj',
-    'qdict_entry_key',
-    'qdict_entry_value',
-    'qdict_extract_subqdict',
-    'qdict_find',
-    'qdict_first',
-    'qdict_flatten',
-    'qdict_flatten_qdict',
-    'qdict_flatten_qlist',
-    'qdict_get',
-    'qdict_get_bool',
-    'qdict_get_double',
-    'qdict_get_int',
-    'qdict_get_obj',
-    'qdict_get_qdict',
-    'qdict_get_qlist',
-    'qdict_get_str',
-    'qdict_get_try_bool',
-    'qdict_get_try_int',
-    'qdict_get_try_str',
-    'qdict_haskey',
-    'qdict_has_prefixed_entries',
-    'qdict_iter',
-    'qdict_join',
-    'qdict_new',
-    'qdict_next',
-    'qdict_next_entry',
-    'qdict_put_obj',
-    'qdict_size',
-    'qdict_type',
     'qemu_clock_get_us',
-    'qemu_clock_ptr',
     'qemu_clocks',
-    'qemu_cond_destroy',
     'qemu_cpu_is_self',
-    'qemu_cpu_kick_thread',
-    'qemu_daemon',
-    'qemu_event_destroy',
-    'qemu_event_init',
-    'qemu_event_reset',
-    'qemu_event_set',
-    'qemu_event_wait',
-    'qemu_fdatasync',
     'qemu_flush_coalesced_mmio_buffer',
     'qemu_get_cpu',
     'qemu_get_guest_memory_mapping',
     'qemu_get_guest_simple_memory_mapping',
-    'qemu_get_local_state_pathname',
     'qemu_get_ram_block',
     'qemu_get_ram_block_host_ptr',
     'qemu_get_ram_fd',
     'qemu_get_ram_ptr',
+    'qemu_ram_block_base',
     'qemu_host_page_mask',
     'qemu_host_page_size',
     'qemu_init_vcpu',
@@ -2451,55 +2224,8 @@ symbols = (
     'qemu_log_flush',
     'qemu_loglevel_mask',
     'qemu_log_vprintf',
-    'qemu_mutex_destroy',
     'qemu_mutex_lock_ramlist',
-    'qemu_mutex_trylock',
     'qemu_mutex_unlock_ramlist',
-    'qemu_oom_check',
-    'qemu_opt_del',
-    'qemu_opt_del_all',
-    'qemu_opt_find',
-    'qemu_opt_foreach',
-    'qemu_opt_get',
-    'qemu_opt_get_bool',
-    'qemu_opt_get_bool_del',
-    'qemu_opt_get_bool_helper',
-    'qemu_opt_get_del',
-    'qemu_opt_get_number',
-    'qemu_opt_get_number_del',
-    'qemu_opt_get_number_helper',
-    'qemu_opt_get_size',
-    'qemu_opt_get_size_del',
-    'qemu_opt_get_size_helper',
-    'qemu_opt_has_help_opt',
-    'qemu_opt_parse',
-    'qemu_opts_absorb_qdict',
-    'qemu_opts_append',
-    'qemu_opts_create',
-    'qemu_opts_del',
-    'qemu_opts_do_parse',
-    'qemu_opt_set',
-    'qemu_opt_set_bool',
-    'qemu_opt_set_err',
-    'qemu_opt_set_number',
-    'qemu_opts_find',
-    'qemu_opts_foreach',
-    'qemu_opts_free',
-    'qemu_opts_from_qdict',
-    'qemu_opts_from_qdict_1',
-    'qemu_opts_id',
-    'qemu_opts_parse',
-    'qemu_opts_print',
-    'qemu_opts_print_help',
-    'qemu_opts_reset',
-    'qemu_opts_set',
-    'qemu_opts_set_defaults',
-    'qemu_opts_set_id',
-    'qemu_opts_to_qdict',
-    'qemu_opts_validate',
-    'qemu_opt_unset',
-    'qemu_parse_fd',
-    'qemu_pipe',
     'qemu_ram_addr_from_host',
     'qemu_ram_addr_from_host_nofail',
     'qemu_ram_alloc',
@@ -2512,110 +2238,16 @@ symbols = (
     'qemu_ram_setup_dump',
     'qemu_ram_unset_idstr',
     'qemu_real_host_page_size',
-    'qemu_sem_destroy',
-    'qemu_sem_init',
-    'qemu_sem_post',
-    'qemu_sem_timedwait',
-    'qemu_sem_wait',
-    'qemu_set_cloexec',
-    'qemu_set_tty_echo',
     'qemu_st_helpers',
-    'qemu_strnlen',
-    'qemu_strsep',
     'qemu_tcg_cpu_thread_fn',
     'qemu_tcg_init_vcpu',
-    'qemu_thread_exit',
-    'qemu_try_memalign',
-    'qentry_destroy',
-    'qerror_human',
-    'qerror_report',
-    'qerror_report_err',
-    'qfloat_destroy_obj',
-    'qfloat_from_double',
-    'qfloat_get_double',
-    'qfloat_type',
-    'qint_destroy_obj',
-    'qint_from_int',
-    'qint_get_int',
-    'qint_type',
-    'qlist_append_obj',
-    'qlist_copy',
-    'qlist_copy_elem',
-    'qlist_destroy_obj',
-    'qlist_empty',
     'qlist_entry_obj',
     'qlist_first',
-    'qlist_iter',
-    'qlist_new',
     'qlist_next',
-    'qlist_peek',
-    'qlist_pop',
-    'qlist_size',
-    'qlist_size_iter',
-    'qlist_type',
-    'qmp_input_end_implicit_struct',
-    'qmp_input_end_list',
-    'qmp_input_end_struct',
-    'qmp_input_get_next_type',
-    'qmp_input_get_object',
-    'qmp_input_get_visitor',
-    'qmp_input_next_list',
-    'qmp_input_optional',
-    'qmp_input_pop',
-    'qmp_input_push',
-    'qmp_input_start_implicit_struct',
-    'qmp_input_start_list',
-    'qmp_input_start_struct',
-    'qmp_input_type_bool',
-    'qmp_input_type_int',
-    'qmp_input_type_number',
-    'qmp_input_type_str',
-    'qmp_input_visitor_cleanup',
-    'qmp_input_visitor_new',
-    'qmp_input_visitor_new_strict',
-    'qmp_output_add_obj',
-    'qmp_output_end_list',
-    'qmp_output_end_struct',
-    'qmp_output_first',
-    'qmp_output_get_qobject',
-    'qmp_output_get_visitor',
-    'qmp_output_last',
-    'qmp_output_next_list',
-    'qmp_output_pop',
-    'qmp_output_push_obj',
-    'qmp_output_start_list',
-    'qmp_output_start_struct',
-    'qmp_output_type_bool',
-    'qmp_output_type_int',
-    'qmp_output_type_number',
-    'qmp_output_type_str',
-    'qmp_output_visitor_cleanup',
-    'qmp_output_visitor_new',
     'qobject_decref',
-    'qobject_from_json',
-    'qobject_from_jsonf',
-    'qobject_from_jsonv',
     'qobject_incref',
-    'qobject_to_json',
-    'qobject_to_json_pretty',
-    'qobject_to_qbool',
-    'qobject_to_qdict',
-    'qobject_to_qfloat',
-    'qobject_to_qint',
-    'qobject_to_qlist',
-    'qobject_to_qstring',
     'qobject_type',
-    'qstring_append',
-    'qstring_append_chr',
-    'qstring_append_int',
-    'qstring_destroy_obj',
     'qstring_from_escaped_str',
-    'qstring_from_str',
-    'qstring_from_substr',
-    'qstring_get_length',
-    'qstring_get_str',
-    'qstring_new',
-    'qstring_type',
     'ram_block_add',
     'ram_size',
     'range_compare',
@@ -2625,7 +2257,6 @@ symbols = (
     'ranges_can_merge',
     'raw_read',
     'raw_write',
-    'rcon',
     'read_raw_cp_reg',
     'recip_estimate',
     'recip_sqrt_estimate',
@@ -2633,7 +2264,6 @@ symbols = (
     'register_multipage',
     'register_subpage',
     'register_tm_clones',
-    'register_types_object',
     'regnames',
     'render_memory_region',
     'reset_all_temps',
@@ -2684,15 +2314,6 @@ symbols = (
     'shortShift192Left',
     'simple_mpu_ap_bits',
     'size_code_gen_buffer',
-    'slow_bitmap_and',
-    'slow_bitmap_andnot',
-    'slow_bitmap_complement',
-    'slow_bitmap_empty',
-    'slow_bitmap_equal',
-    'slow_bitmap_full',
-    'slow_bitmap_intersects',
-    'slow_bitmap_or',
-    'slow_bitmap_xor',
     'softmmu_lock_user',
     'softmmu_lock_user_string',
     'softmmu_tget32',
@@ -2705,7 +2326,6 @@ symbols = (
     'spin_unlock',
     'spsel_read',
     'spsel_write',
-    'start_list',
     'stb_p',
     'stb_phys',
     'stl_be_p',
@@ -2726,22 +2346,7 @@ symbols = (
     'stq_le_p',
     'stq_le_phys',
     'stq_phys',
-    'string_input_get_visitor',
-    'string_input_visitor_cleanup',
-    'string_input_visitor_new',
-    'string_output_append',
-    'string_output_append_range',
-    'string_output_get_string',
-    'string_output_get_visitor',
-    'string_output_set',
-    'string_output_visitor_cleanup',
-    'string_output_visitor_new',
-    'stristart',
     'strongarm_cp_reginfo',
-    'strpadcpy',
-    'strstart',
-    'strtosz',
-    'strtosz_suffix',
     'stw_be_p',
     'stw_be_phys',
     'stw_he_p',
@@ -2765,7 +2370,6 @@ symbols = (
     'subpage_read',
     'subpage_register',
     'subpage_write',
-    'suffix_mul',
     'swap_commutative',
     'swap_commutative2',
     'switch_mode',
@@ -2807,6 +2411,7 @@ symbols = (
     'tb_hash_remove',
     'tb_invalidate_phys_addr',
     'tb_invalidate_phys_page_range',
+    'tb_invalidate_pc_range',
     'tb_invalidate_phys_range',
     'tb_jmp_cache_hash_func',
     'tb_jmp_cache_hash_page',
@@ -2817,8 +2422,6 @@ symbols = (
     'tb_phys_invalidate',
     'tb_reset_jump',
     'tb_set_jmp_target',
-    'tcg_accel_class_init',
-    'tcg_accel_type',
     'tcg_add_param_i32',
     'tcg_add_param_i64',
     'tcg_add_target_add_op_defs',
@@ -2950,7 +2553,6 @@ symbols = (
     'tcg_global_reg_new_i64',
     'tcg_global_reg_new_internal',
     'tcg_handle_interrupt',
-    'tcg_init',
     'tcg_invert_cond',
     'tcg_la_bb_end',
     'tcg_la_br_end',
@@ -3046,7 +2648,6 @@ symbols = (
     'tcg_temp_new_internal',
     'tcg_temp_new_internal_i32',
     'tcg_temp_new_internal_i64',
-    'tdb_hash',
     'teecr_write',
     'teehbr_access',
     'temp_allocate_frame',
@@ -3082,34 +2683,16 @@ symbols = (
     'tlb_set_dirty1',
     'tlb_unprotect_code_phys',
     'tlb_vaddr_to_host',
-    'to_json',
-    'to_json_dict_iter',
-    'to_json_list_iter',
     'token_get_type',
     'token_get_value',
     'token_is_escape',
     'token_is_keyword',
     'token_is_operator',
     'tokens_append_from_iter',
-    'to_qiv',
-    'to_qov',
     'tosa_init',
     'tosa_machine_init',
     'tswap32',
     'tswap64',
-    'type_class_get_size',
-    'type_get_by_name',
-    'type_get_parent',
-    'type_has_parent',
-    'type_initialize',
-    'type_initialize_interface',
-    'type_is_ancestor',
-    'type_new',
-    'type_object_get_size',
-    'type_register_internal',
-    'type_table_add',
-    'type_table_get',
-    'type_table_lookup',
     'uint16_to_float32',
     'uint16_to_float64',
     'uint32_to_float32',
@@ -3117,8 +2700,6 @@ symbols = (
     'uint64_to_float128',
     'uint64_to_float32',
     'uint64_to_float64',
-    'uleb128_decode_small',
-    'uleb128_encode_small',
     'unassigned_io_ops',
     'unassigned_io_read',
     'unassigned_io_write',
@@ -3148,17 +2729,6 @@ symbols = (
     'vfp_set_fpcr',
     'vfp_set_fpscr',
     'vfp_set_fpsr',
-    'visit_end_implicit_struct',
-    'visit_end_list',
-    'visit_end_struct',
-    'visit_end_union',
-    'visit_get_next_type',
-    'visit_next_list',
-    'visit_optional',
-    'visit_start_implicit_struct',
-    'visit_start_list',
-    'visit_start_struct',
-    'visit_start_union',
     'vmsa_cp_reginfo',
     'vmsa_tcr_el1_write',
     'vmsa_ttbcr_raw_write',
@@ -3943,6 +3513,7 @@ mips_symbols = (
     'exception_resume_pc',
     'mips_cpu_do_interrupt',
     'mips_cpu_exec_interrupt',
+    'mips_cpu_synchronize_from_tb',
     'r4k_invalidate_tlb',
     'helper_absq_s_ob',
     'helper_absq_s_qh',
@@ -4139,6 +3710,8 @@ sparc_symbols = (
     'helper_taddcctv',
     'helper_tsubcctv',
     'sparc_cpu_do_interrupt',
+    'sparc_cpu_exec_interrupt',
+    'sparc_cpu_synchronize_from_tb',
     'helper_check_align',
     'helper_ld_asi',
     'helper_st_asi',
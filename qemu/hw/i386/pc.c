@@ -58,7 +58,8 @@ void cpu_smm_update(CPUX86State *env)
 {
     struct uc_struct *uc = x86_env_get_cpu(env)->parent_obj.uc;
 
-    if (smm_set && smm_arg && CPU(x86_env_get_cpu(env)) == first_cpu) {
+    /* the boot CPU, not the vCPU selected for the register APIs */
+    if (smm_set && smm_arg && CPU(x86_env_get_cpu(env)) == QTAILQ_FIRST(&uc->cpus)) {
         smm_set(!!(env->hflags & HF_SMM_MASK), smm_arg);
     }
 }
@@ -216,16 +216,6 @@ static int apic_common_realize(struct uc_struct *uc, DeviceState *dev, Error **e
         uc->mmio_registered = true;
     }
 
-    /* Note: We need at least 1M to map the VAPIC option ROM */
-    if (!uc->vapic && s->vapic_control & VAPIC_ENABLE_MASK) {
-        // ram_size >= 1024 * 1024) {	// FIXME
-        uc->vapic = NULL;
-    }
-    s->vapic = uc->vapic;
-    if (uc->apic_report_tpr_access && info->enable_tpr_reporting) {
-        info->enable_tpr_reporting(s, true);
-    }
-
     return 0;
 }
 
@@ -297,6 +297,9 @@ CPUArchState *cpu_copy(CPUArchState *env);
 #define TLB_NOTDIRTY    (1 << 4)
 /* Set if TLB entry is an IO callback.  */
 #define TLB_MMIO        (1 << 5)
+/* Unicorn: set if the page intersects a UC_HOOK_MEM_READ/WRITE hook range,
+   so accesses must take the instrumented slow path.  */
+#define TLB_UCHOOK      (1 << 6)
 
 ram_addr_t last_ram_offset(struct uc_struct *uc);
 void qemu_mutex_lock_ramlist(struct uc_struct *uc);
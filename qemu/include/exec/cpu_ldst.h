@@ -358,32 +358,61 @@ uint64_t helper_ldq_cmmu(CPUArchState *env, target_ulong addr, int mmu_idx);
  * This is the equivalent of the initial fast-path code used by
  * TCG backends for guest load and store accesses.
  */
-static inline void *tlb_vaddr_to_host(CPUArchState *env, target_ulong addr,
-                                      int access_type, int mmu_idx)
+/* Read the comparison address of @entry for @access_type (0 read, 1 write,
+ * 2 execute).
+ */
+static inline target_ulong tlb_entry_addr(CPUTLBEntry *entry, int access_type)
 {
-    int index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
-    CPUTLBEntry *tlbentry = &env->tlb_table[mmu_idx][index];
-    target_ulong tlb_addr;
-    uintptr_t haddr;
-
     switch (access_type) {
     case 0:
-        tlb_addr = tlbentry->addr_read;
-        break;
+        return entry->addr_read;
     case 1:
-        tlb_addr = tlbentry->addr_write;
-        break;
+        return entry->addr_write;
     case 2:
-        tlb_addr = tlbentry->addr_code;
-        break;
+        return entry->addr_code;
     default:
         g_assert_not_reached();
     }
+}
+
+static inline void *tlb_vaddr_to_host(CPUArchState *env, target_ulong addr,
+                                      int access_type, int mmu_idx)
+{
+    int index = (addr >> TARGET_PAGE_BITS) & (env->uc->tlb_entries - 1);
+    CPUTLBEntry *tlbentry = &env->tlb_table[mmu_idx][index];
+    target_ulong tlb_addr = tlb_entry_addr(tlbentry, access_type);
+    uintptr_t haddr;
 
     if ((addr & TARGET_PAGE_MASK)
         != (tlb_addr & (TARGET_PAGE_MASK | TLB_INVALID_MASK))) {
-        /* TLB entry is for a different page */
-        return NULL;
+        /* The direct-mapped entry is for a different page: two hot pages
+         * aliasing to the same set would otherwise ping-pong through the
+         * tlb_set_page() slow path, so probe the victim tlb the same way
+         * the softmmu helpers do before giving up.
+         */
+        int vidx;
+        CPUTLBEntry tmptlb;
+        hwaddr tmpiotlb;
+
+        for (vidx = CPU_VTLB_SIZE - 1; vidx >= 0; --vidx) {
+            CPUTLBEntry *vtlb = &env->tlb_v_table[mmu_idx][vidx];
+
+            if (tlb_entry_addr(vtlb, access_type) == (addr & TARGET_PAGE_MASK)) {
+                /* found entry in victim tlb, swap tlb and iotlb */
+                tmptlb = *tlbentry;
+                *tlbentry = *vtlb;
+                *vtlb = tmptlb;
+                tmpiotlb = env->iotlb[mmu_idx][index];
+                env->iotlb[mmu_idx][index] = env->iotlb_v[mmu_idx][vidx];
+                env->iotlb_v[mmu_idx][vidx] = tmpiotlb;
+                break;
+            }
+        }
+        if (vidx < 0) {
+            /* TLB entry is for a different page */
+            return NULL;
+        }
+        tlb_addr = tlb_entry_addr(tlbentry, access_type);
     }
 
     if (tlb_addr & ~TARGET_PAGE_MASK) {
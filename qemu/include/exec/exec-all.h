@@ -83,6 +83,7 @@ void QEMU_NORETURN cpu_io_recompile(CPUState *cpu, uintptr_t retaddr);
 TranslationBlock *tb_gen_code(CPUState *cpu,
                               target_ulong pc, target_ulong cs_base, int flags,
                               int cflags);
+void tb_readahead(CPUState *cpu, TranslationBlock *tb);
 void cpu_exec_init(CPUArchState *env, void *opaque);
 
 void QEMU_NORETURN cpu_loop_exit(CPUState *cpu);
@@ -96,6 +97,7 @@ void tcg_cpu_address_space_init(CPUState *cpu, AddressSpace *as);
 /* cputlb.c */
 void tlb_flush_page(CPUState *cpu, target_ulong addr);
 void tlb_flush(CPUState *cpu, int flush_global);
+void tlb_flush_range(CPUState *cpu, target_ulong addr, target_ulong len);
 void tlb_set_page(CPUState *cpu, target_ulong vaddr,
                   hwaddr paddr, int prot,
                   int mmu_idx, target_ulong size);
@@ -110,13 +112,15 @@ static inline void tlb_flush_page(CPUState *cpu, target_ulong addr)
 static inline void tlb_flush(CPUState *cpu, int flush_global)
 {
 }
+
+static inline void tlb_flush_range(CPUState *cpu, target_ulong addr,
+                                   target_ulong len)
+{
+}
 #endif
 
 #define CODE_GEN_ALIGN           16 /* must be >= of the size of a icache line */
 
-#define CODE_GEN_PHYS_HASH_BITS     15
-#define CODE_GEN_PHYS_HASH_SIZE     (1 << CODE_GEN_PHYS_HASH_BITS)
-
 /* estimated block size for TB allocation */
 /* XXX: use a per code average code fragment size and modulate it
    according to the host CPU */
@@ -167,51 +171,145 @@ struct TranslationBlock {
     struct TranslationBlock *jmp_next[2];
     struct TranslationBlock *jmp_first;
     uint32_t icount;
+    uint32_t exec_count;  /* executions since translation, see uc_profile_enable() */
+    /* unlinked ahead of its segment; tb_seg_rotate() must skip it */
+    uint8_t invalidated;
+    /* remaining unconditional-jump follow budget when retranslating this
+       block as a superblock, see tb_superblock(); zero for normal TBs */
+    uint8_t sb_follow;
+    /* instruction boundary metadata captured lazily for uc_tb_meta();
+       a uc_tb_insn array of icount entries, owned by the TB and freed
+       when the translation dies (see tb_meta_get()) */
+    void *insn_meta;
 };
 
+/* how many unconditional direct jumps a superblock retranslation may
+   follow before it has to end the block */
+#define TB_SUPERBLOCK_FOLLOW 16
+
+/* The code buffer is recycled one segment at a time instead of being
+   flushed wholesale; see tb_seg_rotate().  Small buffers use fewer
+   segments (down to one, which degenerates to the old full flush). */
+#define CODE_GEN_MAX_SEGS 8
+
+/* Segments are parcelled out to allocation groups keyed by the RAM block
+   backing the translated code (see tb_group_select), so a churning
+   region - self-modifying code, or a module that is unmapped and
+   remapped - recycles only its own group's segments and leaves the other
+   groups' warm code alone.  Buffers with fewer segments get fewer
+   groups, down to one (no partitioning). */
+#define CODE_GEN_MAX_GROUPS 4
+
 #include "exec/spinlock.h"
 
 typedef struct TBContext TBContext;
 
+/* one direct jump into a TB that spans two guest pages: jump 'n' of 'src'
+   was patched to point at 'dest', whose translation also depends on the
+   virtual mapping of its second page 'virt_page2'.  Recorded by
+   tb_crosspage_link() so tlb_flush()/tlb_flush_page() can undo the link
+   when that mapping may have changed. */
+typedef struct CrossPageLink {
+    TranslationBlock *src;
+    TranslationBlock *dest;
+    target_ulong virt_page2;
+    int n;
+} CrossPageLink;
+
 struct TBContext {
 
     TranslationBlock *tbs;
-    TranslationBlock *tb_phys_hash[CODE_GEN_PHYS_HASH_SIZE];
-    int nb_tbs;
+    /* hash of translated blocks by guest physical pc, chained through
+       tb->phys_hash_next; sized from the block budget in code_gen_alloc()
+       so chains stay short even with the cache full */
+    TranslationBlock **tb_phys_hash;
+    unsigned int tb_phys_hash_mask;
+    /* each segment of the code buffer owns an equal slice of tbs[],
+       filled in tc_ptr order so tb_find_pc() can search it on its own */
+    int cur_seg;
+    int seg_nb_tbs[CODE_GEN_MAX_SEGS];
+    /* cur_seg and the TCGContext code_gen_ptr always describe the active
+       group; the cursors of the other groups are parked here until
+       tb_group_select() swaps them back in */
+    int cur_group;
+    int group_cur_seg[CODE_GEN_MAX_GROUPS];
+    void *group_gen_ptr[CODE_GEN_MAX_GROUPS];
     /* any access to the tbs or the page table must use this lock */
     spinlock_t tb_lock;
 
+    /* direct jumps into two-page TBs, undone on TLB flushes (see
+       tb_crosspage_link); grown on demand */
+    CrossPageLink *crosspage_links;
+    unsigned int crosspage_count;
+    unsigned int crosspage_capacity;
+
+    /* live TBs carrying captured instruction metadata; lets tb_flush()
+       skip the freeing sweep when uc_tb_meta() was never used */
+    int nb_insn_meta;
+
     /* statistics */
     int tb_flush_count;
     int tb_phys_invalidate_count;
+    int tb_seg_evict_count;
 
     int tb_invalidated_flag;
 };
 
-static inline unsigned int tb_jmp_cache_hash_page(target_ulong pc)
+/* The jump cache index splits in two: the high half of the index selects
+   a contiguous group of entries from a hash of the page number, the low
+   half comes from the address inside the page.  tb_flush_jmp_cache()
+   depends on the split: invalidating one page costs one group, not the
+   whole cache.  The page hash is a golden-ratio multiply keeping the top
+   bits, so every page-number bit ends up mixed into the group selection;
+   the old xor-fold let the regularly spaced pages of a large code
+   footprint collide on a few groups.  The effective cache size is
+   per-engine (see uc_jmp_cache_resize()), hence the bits argument. */
+static inline unsigned int tb_jmp_cache_hash_page(target_ulong pc,
+                                                  unsigned int bits)
 {
-    target_ulong tmp;
-    tmp = pc ^ (pc >> (TARGET_PAGE_BITS - TB_JMP_PAGE_BITS));
-    return (tmp >> (TARGET_PAGE_BITS - TB_JMP_PAGE_BITS)) & TB_JMP_PAGE_MASK;
+    target_ulong page = pc >> TARGET_PAGE_BITS;
+
+#if TARGET_LONG_BITS == 64
+    page *= 0x9E3779B97F4A7C15ULL;
+#else
+    page *= 0x9E3779B9u;
+#endif
+    return (unsigned int)(page >> (TARGET_LONG_BITS - bits / 2))
+            << (bits - bits / 2);
 }
 
-static inline unsigned int tb_jmp_cache_hash_func(target_ulong pc)
+static inline unsigned int tb_jmp_cache_hash_func(target_ulong pc,
+                                                  unsigned int bits)
 {
-    target_ulong tmp;
-    tmp = pc ^ (pc >> (TARGET_PAGE_BITS - TB_JMP_PAGE_BITS));
-    return (((tmp >> (TARGET_PAGE_BITS - TB_JMP_PAGE_BITS)) & TB_JMP_PAGE_MASK)
-	    | (tmp & TB_JMP_ADDR_MASK));
+    target_ulong tmp = pc ^ (pc >> (TARGET_PAGE_BITS - bits / 2));
+
+    return tb_jmp_cache_hash_page(pc, bits)
+            | (tmp & ((1u << (bits - bits / 2)) - 1));
 }
 
-static inline unsigned int tb_phys_hash_func(tb_page_addr_t pc)
+/* A multiplicative mix spreads the structured bits of guest physical pcs
+   over the whole table; the old (pc >> 2) & mask sent the blocks of one
+   hot region marching through a few buckets in lockstep. */
+static inline unsigned int tb_phys_hash_func(tb_page_addr_t pc,
+                                             unsigned int mask)
 {
-    return (pc >> 2) & (CODE_GEN_PHYS_HASH_SIZE - 1);
+    uint64_t h = (uint64_t)pc * 0x9E3779B97F4A7C15ULL;
+
+    return (unsigned int)(h >> 32) & mask;
 }
 
 void tb_free(struct uc_struct *uc, TranslationBlock *tb);
 void tb_flush(CPUArchState *env);
+void tb_profile_flush(struct uc_struct *uc);
+struct uc_tb_insn;
+int tb_meta_get(struct uc_struct *uc, uint64_t addr,
+    struct uc_tb_insn *insns, uint32_t *count);
 void tb_phys_invalidate(struct uc_struct *uc,
     TranslationBlock *tb, tb_page_addr_t page_addr);
+void tb_crosspage_link(struct uc_struct *uc,
+    TranslationBlock *src, int n, TranslationBlock *dest);
+void tb_crosspage_unchain(struct uc_struct *uc, target_ulong addr);
+void tb_superblock(CPUState *cpu, TranslationBlock *hot);
 
 #if defined(USE_DIRECT_JUMP)
 
@@ -3,14 +3,13 @@
 
 #include "qemu/timer.h"
 
-/* Helpers for instruction counting code generation.  */
+#include "uc_priv.h"
 
-//static TCGArg *icount_arg;
-//static int icount_label;
+/* Helpers for instruction counting code generation.  */
 
-static inline void gen_tb_start(TCGContext *tcg_ctx)
+static inline void gen_tb_start(TCGContext *tcg_ctx, TranslationBlock *tb)
 {
-    // TCGv_i32 count;
+    TCGv_i32 count;
     TCGv_i32 flag;
 
     tcg_ctx->exitreq_label = gen_new_label(tcg_ctx);
@@ -20,23 +19,58 @@ static inline void gen_tb_start(TCGContext *tcg_ctx)
     tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_NE, flag, 0, tcg_ctx->exitreq_label);
     tcg_temp_free_i32(tcg_ctx, flag);
 
-#if 0
-    if (!use_icount)
-        return;
+    /* Unicorn: bump the per-TB execution counter for uc_profile_enable()
+       and uc_superblock_enable(); the counter address is a translate-time
+       constant. */
+    if (tcg_ctx->uc->tb_profile || tcg_ctx->uc->sb_threshold) {
+        TCGv_ptr taddr = tcg_const_ptr(tcg_ctx, &tb->exec_count);
+        count = tcg_temp_new_i32(tcg_ctx);
+        tcg_gen_ld_i32(tcg_ctx, count, taddr, 0);
+        tcg_gen_addi_i32(tcg_ctx, count, count, 1);
+        tcg_gen_st_i32(tcg_ctx, count, taddr, 0);
+        /* On the exact crossing of the superblock threshold, flag the
+           request and take the slow exit so cpu_exec() retranslates this
+           block with jump following; superblocks themselves and blocks
+           translated under a block hook keep the plain counter.  The gate
+           is tb->sb_follow, not uc->sb_generating, so a later search_pc
+           retranslation emits the same code. */
+        if (tcg_ctx->uc->sb_threshold && tb->sb_follow == 0 &&
+                !HOOK_EXISTS(tcg_ctx->uc, UC_HOOK_BLOCK)) {
+            int skip = gen_new_label(tcg_ctx);
+            TCGv_i32 one;
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_NE, count,
+                                tcg_ctx->uc->sb_threshold, skip);
+            one = tcg_const_i32(tcg_ctx, 1);
+            tcg_gen_st_i32(tcg_ctx, one, tcg_ctx->cpu_env,
+                           offsetof(CPUState, sb_request) - ENV_OFFSET);
+            tcg_temp_free_i32(tcg_ctx, one);
+            tcg_gen_br(tcg_ctx, tcg_ctx->exitreq_label);
+            gen_set_label(tcg_ctx, skip);
+        }
+        tcg_temp_free_i32(tcg_ctx, count);
+        tcg_temp_free_ptr(tcg_ctx, taddr);
+    }
 
-    icount_label = gen_new_label();
-    count = tcg_temp_local_new_i32();
-    tcg_gen_ld_i32(count, cpu_env,
-                   -ENV_OFFSET + offsetof(CPUState, icount_decr.u32));
-    /* This is a horrid hack to allow fixing up the value later.  */
-    icount_arg = tcg_ctx.gen_opparam_ptr + 1;
-    tcg_gen_subi_i32(count, count, 0xdeadbeef);
+    /* Unicorn: instruction count budget for count-limited uc_emu_start()
+       runs. Subtract this TB's instruction count from the decrementer and
+       take the slow exit when the budget does not cover the whole TB; the
+       subtrahend is patched with the real count in gen_tb_end(). The same
+       decrementer carries the round-robin scheduling slice when more than
+       one vCPU exists (see tcg_exec_all()). */
+    if (tcg_ctx->uc->emu_count > 0 || tcg_ctx->uc->vcpu_count > 1) {
+        tcg_ctx->icount_label = gen_new_label(tcg_ctx);
+        count = tcg_temp_local_new_i32(tcg_ctx);
+        tcg_gen_ld_i32(tcg_ctx, count, tcg_ctx->cpu_env,
+                       offsetof(CPUState, icount_decr.u32) - ENV_OFFSET);
+        /* This is a horrid hack to allow fixing up the value later.  */
+        tcg_ctx->icount_arg = tcg_ctx->gen_opparam_ptr + 1;
+        tcg_gen_subi_i32(tcg_ctx, count, count, 0xdeadbeef);
 
-    tcg_gen_brcondi_i32(TCG_COND_LT, count, 0, icount_label);
-    tcg_gen_st16_i32(count, cpu_env,
-                     -ENV_OFFSET + offsetof(CPUState, icount_decr.u16.low));
-    tcg_temp_free_i32(count);
-#endif
+        tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_LT, count, 0, tcg_ctx->icount_label);
+        tcg_gen_st16_i32(tcg_ctx, count, tcg_ctx->cpu_env,
+                         offsetof(CPUState, icount_decr.u16.low) - ENV_OFFSET);
+        tcg_temp_free_i32(tcg_ctx, count);
+    }
 }
 
 static inline void gen_tb_end(TCGContext *tcg_ctx, TranslationBlock *tb, int num_insns)
@@ -44,13 +78,11 @@ static inline void gen_tb_end(TCGContext *tcg_ctx, TranslationBlock *tb, int num
     gen_set_label(tcg_ctx, tcg_ctx->exitreq_label);
     tcg_gen_exit_tb(tcg_ctx, (uintptr_t)tb + TB_EXIT_REQUESTED);
 
-#if 0
-    if (use_icount) {
-        *icount_arg = num_insns;
-        gen_set_label(icount_label);
-        tcg_gen_exit_tb((uintptr_t)tb + TB_EXIT_ICOUNT_EXPIRED);
+    if (tcg_ctx->uc->emu_count > 0 || tcg_ctx->uc->vcpu_count > 1) {
+        *tcg_ctx->icount_arg = num_insns;
+        gen_set_label(tcg_ctx, tcg_ctx->icount_label);
+        tcg_gen_exit_tb(tcg_ctx, (uintptr_t)tb + TB_EXIT_ICOUNT_EXPIRED);
     }
-#endif
 }
 
 #if 0
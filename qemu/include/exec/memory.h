@@ -171,6 +171,8 @@ struct MemoryRegion {
     NotifierList iommu_notify;
     struct uc_struct *uc;
     uint32_t perms;   //all perms, partially redundant with readonly
+    uint8_t *page_perms;  //per-page override of perms, installed by uc_mem_protect()
+    uint8_t *ram_host;  //host base of the backing RAMBlock, cached at allocation
     uint64_t end;
 };
 
@@ -940,9 +942,35 @@ void memory_register_types(struct uc_struct *uc);
 
 MemoryRegion *memory_map(struct uc_struct *uc, ram_addr_t begin, size_t size, uint32_t perms);
 MemoryRegion *memory_map_ptr(struct uc_struct *uc, ram_addr_t begin, size_t size, uint32_t perms, void *ptr);
+/* callback types spelled out because unicorn.h is not visible here */
+MemoryRegion *memory_map_io(struct uc_struct *uc, ram_addr_t begin, size_t size,
+                            uint64_t (*read_cb)(struct uc_struct *uc, uint64_t offset, unsigned size, void *user_data),
+                            void (*write_cb)(struct uc_struct *uc, uint64_t offset, unsigned size, uint64_t value, void *user_data),
+                            void *user_data_read, void *user_data_write);
 void memory_unmap(struct uc_struct *uc, MemoryRegion *mr);
+void memory_decommit(struct uc_struct *uc, MemoryRegion *mr, hwaddr addr, size_t size);
+void memory_dirty_query(struct uc_struct *uc, MemoryRegion *mr, hwaddr addr, size_t size, uint8_t *bitmap, uint64_t first_bit);
+void memory_dirty_reset(struct uc_struct *uc, MemoryRegion *mr, hwaddr addr, size_t size);
 int memory_free(struct uc_struct *uc);
 
+#ifndef _WIN32
+// copy-on-write sharing of RAM blocks for uc_clone()
+int qemu_ram_make_shareable(struct uc_struct *uc, MemoryRegion *mr);
+void qemu_ram_set_owned(struct uc_struct *uc, MemoryRegion *mr);
+#endif
+
+// snapshot/restore of guest RAM for uc_snapshot()/uc_restore()
+struct uc_snapshot;
+int memory_snapshot_ram(struct uc_struct *uc, struct uc_snapshot *snapshot);
+int memory_restore_ram(struct uc_struct *uc, struct uc_snapshot *snapshot);
+void memory_snapshot_free_ram(struct uc_struct *uc, struct uc_snapshot *snapshot);
+
+// dirty-page deltas between checkpoints of the ring, for uc_rewind()
+struct uc_ckpt_delta;
+int memory_ckpt_delta(struct uc_struct *uc, struct uc_ckpt_delta *delta);
+int memory_ckpt_apply(struct uc_struct *uc, struct uc_snapshot *snapshot, struct uc_ckpt_delta *delta);
+void memory_ckpt_delta_free(struct uc_struct *uc, struct uc_ckpt_delta *delta);
+
 #endif
 
 #endif
@@ -136,8 +136,6 @@ typedef struct VAPICState {
     uint8_t enabled;
 } QEMU_PACKED VAPICState;
 
-extern bool apic_report_tpr_access;
-
 bool apic_next_timer(APICCommonState *s, int64_t current_time);
 void apic_enable_vapic(struct uc_struct *uc, DeviceState *d, hwaddr paddr);
 
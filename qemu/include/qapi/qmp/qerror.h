@@ -12,20 +12,14 @@
 #ifndef QERROR_H
 #define QERROR_H
 
-#include "qapi/qmp/qstring.h"
 #include "qapi/error.h"
 #include "qapi-types.h"
-#include <stdarg.h>
 
-typedef struct QError {
-    QObject_HEAD;
-    char *err_msg;
-    ErrorClass err_class;
-} QError;
-
-QString *qerror_human(const QError *qerror);
-void qerror_report(ErrorClass err_class, const char *fmt, ...) GCC_FMT_ATTR(2, 3);
-void qerror_report_err(Error *err);
+/*
+ * Unicorn: only the error class/format macros below are left of the
+ * QError module; the QError object and its reporting functions served
+ * the QMP monitor and had no callers here.
+ */
 
 /*
  * QError class list
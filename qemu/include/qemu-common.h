@@ -150,6 +150,7 @@ int qemu_fls(int i);
 int qemu_fdatasync(int fd);
 int fcntl_setfl(int fd, int flag);
 int qemu_parse_fd(const char *param);
+bool buffer_is_zero(const void *buf, size_t len);
 
 int parse_uint(const char *s, unsigned long long *value, char **endptr,
                int base);
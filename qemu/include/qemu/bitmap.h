@@ -237,7 +237,15 @@ static inline unsigned long *bitmap_zero_extend(unsigned long *old,
                                                 long old_nbits, long new_nbits)
 {
     long new_len = BITS_TO_LONGS(new_nbits) * sizeof(unsigned long);
-    unsigned long *new = g_realloc(old, new_len);
+    unsigned long *new;
+
+    if (old == NULL) {
+        /* a fresh bitmap comes straight from the allocator's zero
+           pages; clearing it by hand would fault in every page of a
+           bitmap sized to guest RAM before a single bit is set */
+        return g_malloc0(new_len);
+    }
+    new = g_realloc(old, new_len);
     bitmap_clear(new, old_nbits, new_nbits - old_nbits);
     return new;
 }
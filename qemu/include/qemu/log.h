@@ -22,7 +22,13 @@ extern int qemu_loglevel;
  */
 static inline bool qemu_log_enabled(void)
 {
+#ifdef UNICORN_NO_LOG
+    /* constant false: every "if (qemu_log_enabled())" block and its format
+       strings are discarded as dead code in UNICORN_NO_LOG builds */
+    return false;
+#else
     return qemu_logfile != NULL;
+#endif
 }
 
 #define CPU_LOG_TB_OUT_ASM (1 << 0)
@@ -42,11 +48,35 @@ static inline bool qemu_log_enabled(void)
  */
 static inline bool qemu_loglevel_mask(int mask)
 {
+#ifdef UNICORN_NO_LOG
+    return false;
+#else
     return (qemu_loglevel & mask) != 0;
+#endif
 }
 
 /* Logging functions: */
 
+#ifdef UNICORN_NO_LOG
+
+/* Empty inline bodies rather than macros so the format strings are still
+   type-checked; the calls compile to nothing and the strings are not
+   emitted into the binary. */
+static inline void GCC_FMT_ATTR(1, 2) qemu_log(const char *fmt, ...)
+{
+}
+
+static inline void GCC_FMT_ATTR(1, 0)
+qemu_log_vprintf(const char *fmt, va_list va)
+{
+}
+
+static inline void GCC_FMT_ATTR(2, 3) qemu_log_mask(int mask, const char *fmt, ...)
+{
+}
+
+#else
+
 /* main logging function
  */
 void GCC_FMT_ATTR(1, 2) qemu_log(const char *fmt, ...);
@@ -65,6 +95,8 @@ qemu_log_vprintf(const char *fmt, va_list va)
  */
 void GCC_FMT_ATTR(2, 3) qemu_log_mask(int mask, const char *fmt, ...);
 
+#endif /* UNICORN_NO_LOG */
+
 
 /* Special cases: */
 
@@ -56,6 +56,4 @@ typedef enum {
 void register_module_init(void (*fn)(void), module_init_type type);
 void register_dso_module_init(void (*fn)(void), module_init_type type);
 
-void module_call_init(struct uc_struct *uc, module_init_type type);
-
 #endif
@@ -52,14 +52,13 @@ void qemu_event_reset(QemuEvent *ev);
 void qemu_event_wait(QemuEvent *ev);
 void qemu_event_destroy(QemuEvent *ev);
 
-struct uc_struct;
 // return -1 on error, 0 on success
-int qemu_thread_create(struct uc_struct *uc, QemuThread *thread, const char *name,
+int qemu_thread_create(QemuThread *thread, const char *name,
                         void *(*start_routine)(void *),
                         void *arg, int mode);
 void *qemu_thread_join(QemuThread *thread);
-void qemu_thread_get_self(struct uc_struct *uc, QemuThread *thread);
+void qemu_thread_get_self(QemuThread *thread);
 bool qemu_thread_is_self(QemuThread *thread);
-void qemu_thread_exit(struct uc_struct *uc, void *retval);
+void qemu_thread_exit(void *retval);
 
 #endif
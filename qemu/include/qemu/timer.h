@@ -653,13 +653,40 @@ static inline int64_t get_clock(void)
 #else
 
 extern int use_rt_clock;
+extern int use_coarse_clock;
 
 static inline int64_t get_clock(void)
 {
+#ifdef CLOCK_MONOTONIC
+    if (use_rt_clock) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+#endif
     return get_clock_realtime();
 }
 #endif
 
+/* Coarse variant for code that polls the clock, e.g. deadline checks:
+ * CLOCK_MONOTONIC_COARSE reads a tick-updated value from the vDSO with
+ * no syscall, trading ~1-4ms of resolution for a read that costs a few
+ * nanoseconds.  Shares the CLOCK_MONOTONIC epoch, so it can be compared
+ * against deadlines taken with get_clock(); it only lags by up to one
+ * tick.  Falls back to get_clock() where the coarse clock is missing.
+ */
+static inline int64_t get_clock_coarse(void)
+{
+#if !defined(_WIN32) && defined(CLOCK_MONOTONIC_COARSE)
+    if (use_coarse_clock) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+#endif
+    return get_clock();
+}
+
 /* icount */
 int64_t cpu_get_icount(void);
 int64_t cpu_get_clock(void);
@@ -172,8 +172,13 @@ typedef struct CPUWatchpoint {
 struct KVMState;
 struct kvm_run;
 
+/* default jump cache size; the effective size is per-engine
+   (uc->jmp_cache_bits, see uc_jmp_cache_resize()) and the array is laid
+   out for the maximum so resizing never reallocates */
 #define TB_JMP_CACHE_BITS 12
 #define TB_JMP_CACHE_SIZE (1 << TB_JMP_CACHE_BITS)
+#define TB_JMP_CACHE_MAX_BITS 16
+#define TB_JMP_CACHE_MAX_SIZE (1 << TB_JMP_CACHE_MAX_BITS)
 
 /**
  * CPUState:
@@ -222,7 +227,6 @@ struct CPUState {
     int thread_id;
     uint32_t host_tid;
     bool running;
-    struct QemuCond *halt_cond;
     struct qemu_work_item *queued_work_first, *queued_work_last;
     bool thread_kicked;
     bool created;
@@ -239,13 +243,21 @@ struct CPUState {
 
     void *env_ptr; /* CPUArchState */
     struct TranslationBlock *current_tb;
-    struct TranslationBlock *tb_jmp_cache[TB_JMP_CACHE_SIZE];
+    struct TranslationBlock *tb_jmp_cache[TB_JMP_CACHE_MAX_SIZE];
+    /* generation tag per tb_jmp_cache entry: an entry is only valid when
+       its tag matches jmp_cache_gen, so a whole-cache flush is a counter
+       bump (tb_jmp_cache_flush()) instead of a multi-KB memset */
+    uint32_t tb_jmp_cache_gen[TB_JMP_CACHE_MAX_SIZE];
+    uint32_t jmp_cache_gen;
     QTAILQ_ENTRY(CPUState) node;
 
     /* ice debug support */
     QTAILQ_HEAD(breakpoints_head, CPUBreakpoint) breakpoints;
 
     QTAILQ_HEAD(watchpoints_head, CPUWatchpoint) watchpoints;
+    /* length of the watchpoints list; lets the hot paths skip the list
+       walks entirely in the common case of no watchpoints at all */
+    int watchpoint_count;
     CPUWatchpoint *watchpoint_hit;
 
     void *opaque;
@@ -271,6 +283,10 @@ struct CPUState {
     uint32_t can_do_io;
     int32_t exception_index; /* used by m68k TCG */
 
+    /* Set from generated code when a TB crosses the superblock formation
+       threshold; checked on the TB_EXIT_REQUESTED path in cpu_exec(). */
+    uint32_t sb_request;
+
     /* Note that this is accessed at the start of every TB via a negative
        offset from AREG0.  Leave this field at the end so as to make the
        (absolute value) offset as small as possible.  This reduces code
@@ -279,6 +295,22 @@ struct CPUState {
     struct uc_struct* uc;
 };
 
+/**
+ * tb_jmp_cache_flush:
+ * @cpu: The CPU whose jump cache is to be invalidated.
+ *
+ * Invalidates every tb_jmp_cache entry in O(1) by bumping the generation
+ * counter; stale entries fail the tag comparison in tb_find_fast().  The
+ * one real memset handles the 32-bit counter wrapping around, so a tag
+ * left behind 4 billion flushes ago can never read as valid again.
+ */
+static inline void tb_jmp_cache_flush(CPUState *cpu)
+{
+    if (unlikely(++cpu->jmp_cache_gen == 0)) {
+        memset(cpu->tb_jmp_cache_gen, 0, sizeof(cpu->tb_jmp_cache_gen));
+        cpu->jmp_cache_gen = 1;
+    }
+}
 
 /**
  * cpu_paging_enabled:
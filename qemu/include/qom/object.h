@@ -351,8 +351,6 @@ typedef struct ObjectProperty
     ObjectPropertyResolve *resolve;
     ObjectPropertyRelease *release;
     void *opaque;
-
-    QTAILQ_ENTRY(ObjectProperty) node;
 } ObjectProperty;
 
 /**
@@ -412,7 +410,7 @@ struct Object
     /*< private >*/
     ObjectClass *class;
     ObjectFree *free;
-    QTAILQ_HEAD(, ObjectProperty) properties;
+    GHashTable *properties;
     uint32_t ref;
     Object *parent;
 };
@@ -681,6 +679,29 @@ Type type_register_static(struct uc_struct *uc, const TypeInfo *info);
  */
 Type type_register(struct uc_struct *uc, const TypeInfo *info);
 
+/**
+ * type_table_attach:
+ * @key: identifies the arch variant whose type graph is wanted.
+ *
+ * Point @uc at the process-global type graph published by an earlier
+ * instance of the same arch variant, if there is one. Attached graphs
+ * are immutable: type_register() resolves against them instead of
+ * interning new types.
+ *
+ * Returns: true when a published graph was found.
+ */
+bool type_table_attach(struct uc_struct *uc, void *key);
+
+/**
+ * type_table_publish:
+ * @key: identifies the arch variant the graph was built for.
+ *
+ * Initialize every class of the freshly built type graph of @uc and
+ * publish it process-wide, so later instances of the same arch variant
+ * can attach to it instead of rebuilding it.
+ */
+void type_table_publish(struct uc_struct *uc, void *key);
+
 /**
  * object_class_dynamic_cast_assert:
  * @klass: The #ObjectClass to attempt to cast.
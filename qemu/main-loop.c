@@ -35,64 +35,11 @@
 #ifndef _WIN32
 #endif
 
-static void qemu_cpu_kick_thread(CPUState *cpu);
-
-void qemu_mutex_lock_iothread(struct uc_struct* uc)
-{
-    if (!uc->tcg_enabled(uc)) { // arch-dependent
-        qemu_mutex_lock(&uc->qemu_global_mutex);
-    } else {
-        if (qemu_mutex_trylock(&uc->qemu_global_mutex)) {
-            qemu_cpu_kick_thread(first_cpu);
-            qemu_mutex_lock(&uc->qemu_global_mutex);
-        }
-    }
-}
-
-void qemu_mutex_unlock_iothread(struct uc_struct* uc)
-{
-    qemu_mutex_unlock(&uc->qemu_global_mutex);
-}
-
-static void qemu_cpu_kick_thread(CPUState *cpu)
-{
-#ifndef _WIN32
-    int err;
-
-    err = pthread_kill(cpu->thread->thread, SIG_IPI);
-    if (err) {
-        fprintf(stderr, "qemu:%s: %s", __func__, strerror(err));
-        exit(1);
-    }
-#else /* _WIN32 */
-    if (!qemu_thread_is_self(cpu->thread)) {
-        CONTEXT tcgContext;
-
-        if (SuspendThread(cpu->hThread) == (DWORD)-1) {
-            fprintf(stderr, "qemu:%s: GetLastError:%lu\n", __func__,
-                    GetLastError());
-            exit(1);
-        }
-
-        /* On multi-core systems, we are not sure that the thread is actually
-         * suspended until we can get the context.
-         */
-        tcgContext.ContextFlags = CONTEXT_CONTROL;
-        while (GetThreadContext(cpu->hThread, &tcgContext) != 0) {
-            continue;
-        }
-
-				// FIXME(danghvu): anysignal ?
-        // cpu_signal(0);
-
-        if (ResumeThread(cpu->hThread) == (DWORD)-1) {
-            fprintf(stderr, "qemu:%s: GetLastError:%lu\n", __func__,
-                    GetLastError());
-            exit(1);
-        }
-    }
-#endif
-}
+/* Emulation runs synchronously on the thread calling uc_emu_start(), so
+ * there is no iothread/vcpu-thread rendezvous left: the iothread mutex,
+ * the cpu start/stop condvars and the SIG_IPI kick have all gone away
+ * with it.  qemu_cpu_kick() in vl.c is the remaining (empty) stub.
+ */
 
 
 #if 0
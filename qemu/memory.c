@@ -15,6 +15,10 @@
 
 /* Modified for Unicorn Engine by Nguyen Anh Quynh, 2015 */
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
 #include "exec/memory.h"
 #include "exec/address-spaces.h"
 #include "exec/ioport.h"
@@ -34,16 +38,48 @@
 MemoryRegion *memory_map(struct uc_struct *uc, ram_addr_t begin, size_t size, uint32_t perms)
 {
     MemoryRegion *ram = g_new(MemoryRegion, 1);
+    bool hugepage = perms & UC_MEM_HUGEPAGE;
+    bool mergeable = perms & UC_MEM_MERGEABLE;
 
+    perms &= UC_PROT_ALL;
     memory_region_init_ram(uc, ram, NULL, "pc.ram", size, perms, &error_abort);
     if (ram->ram_addr == -1)
         // out of memory
         return NULL;
 
+#if defined(MADV_HUGEPAGE) || defined(MADV_MERGEABLE)
+    if (hugepage || mergeable) {
+        RAMBlock *block;
+
+        QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+            if (block->mr != ram)
+                continue;
+#if defined(MADV_HUGEPAGE)
+            /* qemu_anon_ram_alloc() aligns blocks to QEMU_VMALLOC_ALIGN (2MB
+               on x86), so asking for transparent huge pages is all that is
+               left to do. Best effort: a kernel without THP just returns an
+               error. */
+            if (hugepage)
+                madvise(block->host, size, MADV_HUGEPAGE);
+#endif
+#if defined(MADV_MERGEABLE)
+            /* blocks are page aligned, which is all KSM needs; merged pages
+               break on the first guest write, so contents stay correct */
+            if (mergeable)
+                madvise(block->host, size, MADV_MERGEABLE);
+#endif
+            break;
+        }
+    }
+#else
+    (void)hugepage;
+    (void)mergeable;
+#endif
+
     memory_region_add_subregion(get_system_memory(uc), begin, ram);
 
     if (uc->current_cpu)
-        tlb_flush(uc->current_cpu, 1);
+        tlb_flush_range(uc->current_cpu, begin, size);
 
     return ram;
 }
@@ -61,22 +97,80 @@ MemoryRegion *memory_map_ptr(struct uc_struct *uc, ram_addr_t begin, size_t size
     memory_region_add_subregion(get_system_memory(uc), begin, ram);
 
     if (uc->current_cpu)
-        tlb_flush(uc->current_cpu, 1);
+        tlb_flush_range(uc->current_cpu, begin, size);
 
     return ram;
 }
 
+/* per-region bundle of the user MMIO callbacks; lives in mr->opaque and
+   is freed together with the region */
+typedef struct {
+    uc_cb_mmio_read_t read;
+    void *user_data_read;
+    uc_cb_mmio_write_t write;
+    void *user_data_write;
+} mmio_cbs;
+
+static uint64_t mmio_region_read(struct uc_struct *uc, void *opaque,
+        hwaddr addr, unsigned size)
+{
+    mmio_cbs *cbs = opaque;
+
+    if (cbs->read) {
+        return cbs->read(uc, addr, size, cbs->user_data_read);
+    }
+    return 0;
+}
+
+static void mmio_region_write(struct uc_struct *uc, void *opaque,
+        hwaddr addr, uint64_t data, unsigned size)
+{
+    mmio_cbs *cbs = opaque;
+
+    if (cbs->write) {
+        cbs->write(uc, addr, size, data, cbs->user_data_write);
+    }
+}
+
+static const MemoryRegionOps mmio_region_ops = {
+    .read = mmio_region_read,
+    .write = mmio_region_write,
+    .endianness = DEVICE_NATIVE_ENDIAN,
+    .impl.min_access_size = 1,
+    .impl.max_access_size = 8,
+};
+
+MemoryRegion *memory_map_io(struct uc_struct *uc, ram_addr_t begin, size_t size,
+        uc_cb_mmio_read_t read_cb, uc_cb_mmio_write_t write_cb,
+        void *user_data_read, void *user_data_write)
+{
+    MemoryRegion *mmio = g_new(MemoryRegion, 1);
+    mmio_cbs *cbs = g_new0(mmio_cbs, 1);
+
+    cbs->read = read_cb;
+    cbs->user_data_read = user_data_read;
+    cbs->write = write_cb;
+    cbs->user_data_write = user_data_write;
+
+    memory_region_init_io(uc, mmio, NULL, &mmio_region_ops, cbs, "uc.mmio", size);
+    mmio->perms = (read_cb? UC_PROT_READ : 0) | (write_cb? UC_PROT_WRITE : 0);
+
+    memory_region_add_subregion(get_system_memory(uc), begin, mmio);
+
+    if (uc->current_cpu)
+        tlb_flush_range(uc->current_cpu, begin, size);
+
+    return mmio;
+}
+
 void memory_unmap(struct uc_struct *uc, MemoryRegion *mr)
 {
     int i;
-    target_ulong addr;
 
     // Make sure all pages associated with the MemoryRegion are flushed
     // Only need to do this if we are in a running state
     if (uc->current_cpu) {
-        for (addr = mr->addr; addr < mr->end; addr += uc->target_page_size) {
-           tlb_flush_page(uc->current_cpu, addr);
-        }
+        tlb_flush_range(uc->current_cpu, mr->addr, mr->end - mr->addr);
     }
     mr->enabled = false;
     memory_region_del_subregion(get_system_memory(uc), mr);
@@ -84,11 +178,88 @@ void memory_unmap(struct uc_struct *uc, MemoryRegion *mr)
     for (i = 0; i < uc->mapped_block_count; i++) {
         if (uc->mapped_blocks[i] == mr) {
             uc->mapped_block_count--;
+            uc->mem_generation++;   // invalidates e.g. the uc_mem_xlat() table
             //shift remainder of array down over deleted pointer
             memmove(&uc->mapped_blocks[i], &uc->mapped_blocks[i + 1], sizeof(MemoryRegion*) * (uc->mapped_block_count - i));
             mr->destructor(mr);
             g_free((char *)mr->name);
             g_free(mr->ioeventfds);
+            g_free(mr->page_perms);
+            if (!mr->ram)
+                // MMIO region: release the user callback bundle
+                g_free(mr->opaque);
+            break;
+        }
+    }
+}
+
+/* Return the host pages backing [addr, addr+size) of @mr to the OS while
+   keeping the mapping itself intact. Anonymous backing reads back as zero
+   afterwards; file/shared backed blocks re-read their backing store. */
+void memory_decommit(struct uc_struct *uc, MemoryRegion *mr, hwaddr addr, size_t size)
+{
+    RAMBlock *block;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        if (block->mr == mr) {
+#ifdef _WIN32
+            VirtualAlloc(block->host + (addr - mr->addr), size,
+                         MEM_RESET, PAGE_READWRITE);
+#else
+            madvise(block->host + (addr - mr->addr), size, MADV_DONTNEED);
+#endif
+            /* the contents changed: a later uc_restore() must copy these
+               pages back from its snapshot */
+            cpu_physical_memory_set_dirty_range(uc,
+                    block->offset + (addr - mr->addr), size);
+            break;
+        }
+    }
+}
+
+/* Set one bit per written page of [addr, addr+size) of @mr in @bitmap,
+   LSB first, starting at @first_bit. Pages count as written from the moment
+   they are mapped until memory_dirty_reset() clears them again. */
+void memory_dirty_query(struct uc_struct *uc, MemoryRegion *mr, hwaddr addr,
+        size_t size, uint8_t *bitmap, uint64_t first_bit)
+{
+    const unsigned long *dirty = uc->ram_list.dirty_memory[DIRTY_MEMORY_VGA];
+    RAMBlock *block;
+    ram_addr_t ra;
+    unsigned long page, end, found;
+    uint64_t bit;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        if (block->mr == mr) {
+            ra = block->offset + (addr - mr->addr);
+            page = ra >> TARGET_PAGE_BITS;
+            end = (ra + size) >> TARGET_PAGE_BITS;
+            /* jump from one dirty page to the next instead of testing
+               every page: snapshot diffs query mostly-clean bitmaps */
+            for (found = find_next_bit(dirty, end, page);
+                 found < end;
+                 found = find_next_bit(dirty, end, found + 1)) {
+                bit = first_bit + (found - page);
+                bitmap[bit / 8] |= (uint8_t)(1 << (bit % 8));
+            }
+            break;
+        }
+    }
+}
+
+/* Clear the dirty bits reported by memory_dirty_query() for
+   [addr, addr+size) of @mr and write-protect the affected TLB entries,
+   so the next guest write marks its page dirty again. */
+void memory_dirty_reset(struct uc_struct *uc, MemoryRegion *mr, hwaddr addr,
+        size_t size)
+{
+    RAMBlock *block;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        if (block->mr == mr) {
+            cpu_physical_memory_reset_dirty(uc,
+                    block->offset + (addr - mr->addr), size,
+                    DIRTY_MEMORY_VGA);
             break;
         }
     }
@@ -107,6 +278,9 @@ int memory_free(struct uc_struct *uc)
         mr->destructor(mr);
         g_free((char *)mr->name);
         g_free(mr->ioeventfds);
+        g_free(mr->page_perms);
+        if (!mr->ram)
+            g_free(mr->opaque);
         g_free(mr);
     }
 
@@ -414,6 +588,85 @@ static void flatview_simplify(FlatView *view)
     }
 }
 
+/* Remember what kind of topology change is queued, so that commit can patch
+ * the current FlatView in place when the whole batch is one added region.
+ * @added is the new region for a subregion add, NULL for everything else.
+ */
+static void flatview_note_update(struct uc_struct *uc, MemoryRegion *added)
+{
+    if (uc->memory_region_update_pending || added == NULL) {
+        /* several changes in one batch, or an attribute change */
+        uc->flat_full_pending = true;
+    } else {
+        uc->flat_add_pending = added;
+    }
+    uc->memory_region_update_pending = true;
+}
+
+static FlatView *flatview_clone(FlatView *old)
+{
+    FlatView *view = g_new(FlatView, 1);
+    unsigned i;
+
+    flatview_init(view);
+    view->nr_allocated = old->nr + 1;
+    view->ranges = g_new(FlatRange, view->nr_allocated);
+    memcpy(view->ranges, old->ranges, old->nr * sizeof(FlatRange));
+    view->nr = old->nr;
+    for (i = 0; i < view->nr; i++) {
+        memory_region_ref(view->ranges[i].mr);
+    }
+    return view;
+}
+
+/* Build a copy of @old with the leaf region @mr inserted, skipping the full
+ * recursive re-render in generate_memory_topology(). Only the simple case a
+ * uc_mem_map() produces is handled - a terminating, non-aliased region that
+ * does not overlap any existing range; returns NULL when @mr is anything
+ * else so the caller falls back to the full rebuild.
+ */
+static FlatView *flatview_insert_region(FlatView *old, MemoryRegion *mr)
+{
+    FlatView *view;
+    FlatRange fr;
+    Int128 start, end;
+    unsigned lo, hi, mid;
+
+    if (!mr->enabled || mr->alias || !mr->terminates || mr->may_overlap
+            || !QTAILQ_EMPTY(&mr->subregions)) {
+        return NULL;
+    }
+
+    /* Binary search for the first range ending beyond the new start. */
+    start = int128_make64(mr->addr);
+    end = int128_add(start, mr->size);
+    lo = 0;
+    hi = old->nr;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (int128_le(addrrange_end(old->ranges[mid].addr), start)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < old->nr && int128_lt(old->ranges[lo].addr.start, end)) {
+        /* overlaps an existing range: not the simple case */
+        return NULL;
+    }
+
+    view = flatview_clone(old);
+    fr.mr = mr;
+    fr.offset_in_region = 0;
+    fr.addr = addrrange_make(start, mr->size);
+    fr.dirty_log_mask = mr->dirty_log_mask;
+    fr.romd_mode = mr->romd_mode;
+    fr.readonly = mr->readonly;
+    flatview_insert(view, lo, &fr);
+    return view;
+}
+
 static bool memory_region_big_endian(MemoryRegion *mr)
 {
 #ifdef TARGET_WORDS_BIGENDIAN
@@ -830,8 +1083,23 @@ static void address_space_update_topology_pass(AddressSpace *as,
 
 static void address_space_update_topology(AddressSpace *as)
 {
+    struct uc_struct *uc = as->uc;
     FlatView *old_view = address_space_get_flatview(as);
-    FlatView *new_view = generate_memory_topology(as->root);
+    FlatView *new_view = NULL;
+
+    /* When the batch was a single region mapped directly under our root,
+     * patch the view in place: O(log n) search plus one insert instead of
+     * the recursive re-render and re-coalesce of everything.
+     */
+    if (!uc->flat_full_pending && uc->flat_add_pending
+            && uc->flat_add_pending->container == as->root
+            && as->root->enabled && !as->root->terminates
+            && !as->root->readonly && as->root->addr == 0) {
+        new_view = flatview_insert_region(old_view, uc->flat_add_pending);
+    }
+    if (new_view == NULL) {
+        new_view = generate_memory_topology(as->root);
+    }
 
     address_space_update_topology_pass(as, old_view, new_view, false);
     address_space_update_topology_pass(as, old_view, new_view, true);
@@ -862,6 +1130,10 @@ static void memory_region_clear_pending(struct uc_struct *uc)
 {
     uc->memory_region_update_pending = false;
     uc->ioeventfd_update_pending = false;
+    // flat_full_pending is NOT cleared here: a region delete queues no
+    // update (the region is disabled first) but must still force the next
+    // rebuild to be a full one, so the flag has to survive empty commits
+    uc->flat_add_pending = NULL;
 }
 
 void memory_region_transaction_commit(struct uc_struct *uc)
@@ -877,6 +1149,7 @@ void memory_region_transaction_commit(struct uc_struct *uc)
             QTAILQ_FOREACH(as, &uc->address_spaces, address_spaces_link) {
                 address_space_update_topology(as);
             }
+            uc->flat_full_pending = false;
 
             MEMORY_LISTENER_CALL_GLOBAL(commit, Forward);
         } else if (uc->ioeventfd_update_pending) {
@@ -1377,7 +1650,9 @@ void memory_region_set_readonly(MemoryRegion *mr, bool readonly)
         else {
             mr->perms |= UC_PROT_WRITE;
         }
-        mr->uc->memory_region_update_pending |= mr->enabled;
+        if (mr->enabled) {
+            flatview_note_update(mr->uc, NULL);
+        }
         memory_region_transaction_commit(mr->uc);
     }
 }
@@ -1387,7 +1662,9 @@ void memory_region_rom_device_set_romd(MemoryRegion *mr, bool romd_mode)
     if (mr->romd_mode != romd_mode) {
         memory_region_transaction_begin(mr->uc);
         mr->romd_mode = romd_mode;
-        mr->uc->memory_region_update_pending |= mr->enabled;
+        if (mr->enabled) {
+            flatview_note_update(mr->uc, NULL);
+        }
         memory_region_transaction_commit(mr->uc);
     }
 }
@@ -1585,7 +1862,9 @@ static void memory_region_update_container_subregions(MemoryRegion *subregion)
     }
     QTAILQ_INSERT_TAIL(&mr->subregions, subregion, subregions_link);
 done:
-    mr->uc->memory_region_update_pending |= mr->enabled && subregion->enabled;
+    if (mr->enabled && subregion->enabled) {
+        flatview_note_update(mr->uc, subregion);
+    }
     memory_region_transaction_commit(mr->uc);
 }
 
@@ -1627,7 +1906,15 @@ void memory_region_del_subregion(MemoryRegion *mr,
     subregion->container = NULL;
     QTAILQ_REMOVE(&mr->subregions, subregion, subregions_link);
     memory_region_unref(subregion);
-    mr->uc->memory_region_update_pending |= mr->enabled && subregion->enabled;
+    /* memory_unmap() disables the region first, so usually no update is
+     * queued here and its stale range stays in the FlatView until the next
+     * rebuild; force that rebuild to be a full one so a single-region add
+     * cannot patch the stale range back into the new view.
+     */
+    mr->uc->flat_full_pending = true;
+    if (mr->enabled && subregion->enabled) {
+        flatview_note_update(mr->uc, NULL);
+    }
     memory_region_transaction_commit(mr->uc);
 }
 
@@ -1638,7 +1925,7 @@ void memory_region_set_enabled(MemoryRegion *mr, bool enabled)
     }
     memory_region_transaction_begin(mr->uc);
     mr->enabled = enabled;
-    mr->uc->memory_region_update_pending = true;
+    flatview_note_update(mr->uc, NULL);
     memory_region_transaction_commit(mr->uc);
 }
 
@@ -1675,7 +1962,9 @@ void memory_region_set_alias_offset(MemoryRegion *mr, hwaddr offset)
 
     memory_region_transaction_begin(mr->uc);
     mr->alias_offset = offset;
-    mr->uc->memory_region_update_pending |= mr->enabled;
+    if (mr->enabled) {
+        flatview_note_update(mr->uc, NULL);
+    }
     memory_region_transaction_commit(mr->uc);
 }
 
@@ -1850,7 +2139,9 @@ void address_space_init(struct uc_struct *uc, AddressSpace *as, MemoryRegion *ro
     QTAILQ_INSERT_TAIL(&uc->address_spaces, as, address_spaces_link);
     as->name = g_strdup(name ? name : "anonymous");
     address_space_init_dispatch(as);
-    uc->memory_region_update_pending |= root->enabled;
+    if (root->enabled) {
+        flatview_note_update(uc, NULL);
+    }
     memory_region_transaction_commit(uc);
 }
 
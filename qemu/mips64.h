@@ -10,13 +10,38 @@
 #define tb_invalidate_phys_page_fast tb_invalidate_phys_page_fast_mips64
 #define phys_mem_clean phys_mem_clean_mips64
 #define tb_cleanup tb_cleanup_mips64
+#define page_tree_reclaim page_tree_reclaim_mips64
+#define tb_profile_flush tb_profile_flush_mips64
 #define memory_map memory_map_mips64
+#define memory_snapshot_ram memory_snapshot_ram_mips64
+#define memory_restore_ram memory_restore_ram_mips64
+#define memory_snapshot_free_ram memory_snapshot_free_ram_mips64
+#define memory_ckpt_delta memory_ckpt_delta_mips64
+#define memory_ckpt_apply memory_ckpt_apply_mips64
+#define memory_ckpt_delta_free memory_ckpt_delta_free_mips64
+#define qemu_ram_make_shareable qemu_ram_make_shareable_mips64
+#define qemu_ram_set_owned qemu_ram_set_owned_mips64
 #define memory_map_ptr memory_map_ptr_mips64
+#define memory_map_io memory_map_io_mips64
 #define memory_unmap memory_unmap_mips64
+#define memory_decommit memory_decommit_mips64
+#define memory_dirty_query memory_dirty_query_mips64
+#define memory_dirty_reset memory_dirty_reset_mips64
 #define memory_free memory_free_mips64
 #define helper_raise_exception helper_raise_exception_mips64
 #define tcg_enabled tcg_enabled_mips64
 #define tcg_exec_init tcg_exec_init_mips64
+#define tcg_buffer_resize tcg_buffer_resize_mips64
+#define tb_cache_save tb_cache_save_mips64
+#define tb_cache_load tb_cache_load_mips64
+#define tb_prewarm tb_prewarm_mips64
+#define tb_meta_get tb_meta_get_mips64
+#define tb_readahead tb_readahead_mips64
+#define tb_stats tb_stats_mips64
+#define mem_stats mem_stats_mips64
+#define tb_crosspage_link tb_crosspage_link_mips64
+#define tb_crosspage_unchain tb_crosspage_unchain_mips64
+#define tb_superblock tb_superblock_mips64
 #define memory_register_types memory_register_types_mips64
 #define cpu_exec_init_all cpu_exec_init_all_mips64
 #define vm_start vm_start_mips64
@@ -37,9 +62,6 @@
 #define aarch64_banked_spsr_index aarch64_banked_spsr_index_mips64
 #define aarch64_restore_sp aarch64_restore_sp_mips64
 #define aarch64_save_sp aarch64_save_sp_mips64
-#define accel_find accel_find_mips64
-#define accel_init_machine accel_init_machine_mips64
-#define accel_type accel_type_mips64
 #define access_with_adjusted_size access_with_adjusted_size_mips64
 #define add128 add128_mips64
 #define add16_sat add16_sat_mips64
@@ -81,16 +103,9 @@
 #define addrrange_make addrrange_make_mips64
 #define addrrange_shift addrrange_shift_mips64
 #define adjust_endianness adjust_endianness_mips64
-#define AES_cbc_encrypt AES_cbc_encrypt_mips64
-#define AES_decrypt AES_decrypt_mips64
-#define AES_encrypt AES_encrypt_mips64
 #define AES_imc AES_imc_mips64
-#define AES_set_decrypt_key AES_set_decrypt_key_mips64
-#define AES_set_encrypt_key AES_set_encrypt_key_mips64
 #define all_helpers all_helpers_mips64
 #define alloc_code_gen_buffer alloc_code_gen_buffer_mips64
-#define alloc_entry alloc_entry_mips64
-#define always_true always_true_mips64
 #define arm1026_initfn arm1026_initfn_mips64
 #define arm1136_initfn arm1136_initfn_mips64
 #define arm1136_r2_initfn arm1136_r2_initfn_mips64
@@ -148,6 +163,7 @@
 #define tlb_fill tlb_fill_mips64
 #define tlb_flush tlb_flush_mips64
 #define tlb_flush_page tlb_flush_page_mips64
+#define tlb_flush_range tlb_flush_range_mips64
 #define tlb_set_page tlb_set_page_mips64
 #define arm_translate_init arm_translate_init_mips64
 #define arm_v7m_class_init arm_v7m_class_init_mips64
@@ -156,21 +172,15 @@
 #define ats_write ats_write_mips64
 #define bad_mode_switch bad_mode_switch_mips64
 #define bank_number bank_number_mips64
-#define bitmap_find_next_zero_area bitmap_find_next_zero_area_mips64
 #define bitmap_zero_extend bitmap_zero_extend_mips64
 #define bp_wp_matches bp_wp_matches_mips64
 #define breakpoint_invalidate breakpoint_invalidate_mips64
 #define build_page_bitmap build_page_bitmap_mips64
-#define bus_add_child bus_add_child_mips64
-#define bus_class_init bus_class_init_mips64
-#define bus_info bus_info_mips64
-#define bus_unparent bus_unparent_mips64
 #define cache_block_ops_cp_reginfo cache_block_ops_cp_reginfo_mips64
 #define cache_dirty_status_cp_reginfo cache_dirty_status_cp_reginfo_mips64
 #define cache_test_clean_cp_reginfo cache_test_clean_cp_reginfo_mips64
 #define call_recip_estimate call_recip_estimate_mips64
 #define can_merge can_merge_mips64
-#define capacity_increase capacity_increase_mips64
 #define ccsidr_read ccsidr_read_mips64
 #define check_ap check_ap_mips64
 #define check_breakpoints check_breakpoints_mips64
@@ -186,12 +196,7 @@
 #define commonNaNToFloat32 commonNaNToFloat32_mips64
 #define commonNaNToFloat64 commonNaNToFloat64_mips64
 #define commonNaNToFloatx80 commonNaNToFloatx80_mips64
-#define compute_abs_deadline compute_abs_deadline_mips64
 #define cond_name cond_name_mips64
-#define configure_accelerator configure_accelerator_mips64
-#define container_get container_get_mips64
-#define container_info container_info_mips64
-#define container_register_types container_register_types_mips64
 #define contextidr_write contextidr_write_mips64
 #define core_log_global_start core_log_global_start_mips64
 #define core_log_global_stop core_log_global_stop_mips64
@@ -228,23 +233,9 @@
 #define cpu_breakpoint_remove_by_ref cpu_breakpoint_remove_by_ref_mips64
 #define cpu_can_do_io cpu_can_do_io_mips64
 #define cpu_can_run cpu_can_run_mips64
-#define cpu_class_init cpu_class_init_mips64
-#define cpu_common_class_by_name cpu_common_class_by_name_mips64
-#define cpu_common_exec_interrupt cpu_common_exec_interrupt_mips64
-#define cpu_common_get_arch_id cpu_common_get_arch_id_mips64
-#define cpu_common_get_memory_mapping cpu_common_get_memory_mapping_mips64
-#define cpu_common_get_paging_enabled cpu_common_get_paging_enabled_mips64
-#define cpu_common_has_work cpu_common_has_work_mips64
-#define cpu_common_initfn cpu_common_initfn_mips64
-#define cpu_common_noop cpu_common_noop_mips64
-#define cpu_common_parse_features cpu_common_parse_features_mips64
-#define cpu_common_realizefn cpu_common_realizefn_mips64
-#define cpu_common_reset cpu_common_reset_mips64
-#define cpu_dump_statistics cpu_dump_statistics_mips64
 #define cpu_exec_init cpu_exec_init_mips64
 #define cpu_flush_icache_range cpu_flush_icache_range_mips64
 #define cpu_gen_init cpu_gen_init_mips64
-#define cpu_get_clock cpu_get_clock_mips64
 #define cpu_get_real_ticks cpu_get_real_ticks_mips64
 #define cpu_get_tb_cpu_state cpu_get_tb_cpu_state_mips64
 #define cpu_handle_debug_exception cpu_handle_debug_exception_mips64
@@ -281,7 +272,6 @@
 #define cpu_physical_memory_write_rom cpu_physical_memory_write_rom_mips64
 #define cpu_physical_memory_write_rom_internal cpu_physical_memory_write_rom_internal_mips64
 #define cpu_register cpu_register_mips64
-#define cpu_register_types cpu_register_types_mips64
 #define cpu_restore_state cpu_restore_state_mips64
 #define cpu_restore_state_from_tb cpu_restore_state_from_tb_mips64
 #define cpu_single_step cpu_single_step_mips64
@@ -290,14 +280,12 @@
 #define cpu_to_be64 cpu_to_be64_mips64
 #define cpu_to_le32 cpu_to_le32_mips64
 #define cpu_to_le64 cpu_to_le64_mips64
-#define cpu_type_info cpu_type_info_mips64
 #define cpu_unassigned_access cpu_unassigned_access_mips64
 #define cpu_watchpoint_address_matches cpu_watchpoint_address_matches_mips64
 #define cpu_watchpoint_insert cpu_watchpoint_insert_mips64
 #define cpu_watchpoint_remove cpu_watchpoint_remove_mips64
 #define cpu_watchpoint_remove_all cpu_watchpoint_remove_all_mips64
 #define cpu_watchpoint_remove_by_ref cpu_watchpoint_remove_by_ref_mips64
-#define crc32c_table crc32c_table_mips64
 #define create_new_memory_mapping create_new_memory_mapping_mips64
 #define csselr_write csselr_write_mips64
 #define cto32 cto32_mips64
@@ -320,15 +308,6 @@
 #define deposit32 deposit32_mips64
 #define deposit64 deposit64_mips64
 #define deregister_tm_clones deregister_tm_clones_mips64
-#define device_class_base_init device_class_base_init_mips64
-#define device_class_init device_class_init_mips64
-#define device_finalize device_finalize_mips64
-#define device_get_realized device_get_realized_mips64
-#define device_initfn device_initfn_mips64
-#define device_post_init device_post_init_mips64
-#define device_reset device_reset_mips64
-#define device_set_realized device_set_realized_mips64
-#define device_type_info device_type_info_mips64
 #define disas_arm_insn disas_arm_insn_mips64
 #define disas_coproc_insn disas_coproc_insn_mips64
 #define disas_dsp_insn disas_dsp_insn_mips64
@@ -356,19 +335,12 @@
 #define do_usat do_usat_mips64
 #define do_v7m_exception_exit do_v7m_exception_exit_mips64
 #define dummy_c15_cp_reginfo dummy_c15_cp_reginfo_mips64
-#define dummy_func dummy_func_mips64
 #define dummy_section dummy_section_mips64
 #define _DYNAMIC _DYNAMIC_mips64
 #define _edata _edata_mips64
 #define _end _end_mips64
-#define end_list end_list_mips64
 #define eq128 eq128_mips64
 #define ErrorClass_lookup ErrorClass_lookup_mips64
-#define error_copy error_copy_mips64
-#define error_exit error_exit_mips64
-#define error_get_class error_get_class_mips64
-#define error_get_pretty error_get_pretty_mips64
-#define error_setg_file_open error_setg_file_open_mips64
 #define estimateDiv128To64 estimateDiv128To64_mips64
 #define estimateSqrt32 estimateSqrt32_mips64
 #define excnames excnames_mips64
@@ -393,13 +365,10 @@
 #define extractFloatx80Exp extractFloatx80Exp_mips64
 #define extractFloatx80Frac extractFloatx80Frac_mips64
 #define extractFloatx80Sign extractFloatx80Sign_mips64
-#define fcntl_setfl fcntl_setfl_mips64
 #define fcse_write fcse_write_mips64
 #define find_better_copy find_better_copy_mips64
-#define find_default_machine find_default_machine_mips64
 #define find_desc_by_name find_desc_by_name_mips64
 #define find_first_bit find_first_bit_mips64
-#define find_last_bit find_last_bit_mips64
 #define find_paging_enabled_cpu find_paging_enabled_cpu_mips64
 #define find_ram_block find_ram_block_mips64
 #define find_ram_offset find_ram_offset_mips64
@@ -603,13 +572,9 @@
 #define floatx80_unordered floatx80_unordered_mips64
 #define floatx80_unordered_quiet floatx80_unordered_quiet_mips64
 #define flush_icache_range flush_icache_range_mips64
-#define format_string format_string_mips64
 #define fp_decode_rm fp_decode_rm_mips64
 #define frame_dummy frame_dummy_mips64
-#define free_range free_range_mips64
 #define fstat64 fstat64_mips64
-#define futex_wait futex_wait_mips64
-#define futex_wake futex_wake_mips64
 #define gen_aa32_ld16s gen_aa32_ld16s_mips64
 #define gen_aa32_ld16u gen_aa32_ld16u_mips64
 #define gen_aa32_ld32u gen_aa32_ld32u_mips64
@@ -1314,8 +1279,6 @@
 #define get_level1_table_address get_level1_table_address_mips64
 #define get_mem_index get_mem_index_mips64
 #define get_next_param_value get_next_param_value_mips64
-#define get_opt_name get_opt_name_mips64
-#define get_opt_value get_opt_value_mips64
 #define get_page_addr_code get_page_addr_code_mips64
 #define get_param_value get_param_value_mips64
 #define get_phys_addr get_phys_addr_mips64
@@ -1348,7 +1311,6 @@
 #define handle_vminmaxnm handle_vminmaxnm_mips64
 #define handle_vrint handle_vrint_mips64
 #define handle_vsel handle_vsel_mips64
-#define has_help_option has_help_option_mips64
 #define have_bmi1 have_bmi1_mips64
 #define have_bmi2 have_bmi2_mips64
 #define hcr_write hcr_write_mips64
@@ -1904,7 +1866,6 @@
 #define _init _init_mips64
 #define init_cpreg_list init_cpreg_list_mips64
 #define init_lists init_lists_mips64
-#define input_type_enum input_type_enum_mips64
 #define int128_2_64 int128_2_64_mips64
 #define int128_add int128_add_mips64
 #define int128_addto int128_addto_mips64
@@ -1949,7 +1910,6 @@
 #define io_writeq io_writeq_mips64
 #define io_writew io_writew_mips64
 #define is_a64 is_a64_mips64
-#define is_help_option is_help_option_mips64
 #define is_power_of_2 is_power_of_2_mips64
 #define isr_read isr_read_mips64
 #define is_valid_option_list is_valid_option_list_mips64
@@ -1959,19 +1919,6 @@
 #define iwmmxt_store_reg iwmmxt_store_reg_mips64
 #define __jit_debug_descriptor __jit_debug_descriptor_mips64
 #define __jit_debug_register_code __jit_debug_register_code_mips64
-#define json_lexer json_lexer_mips64
-#define json_lexer_destroy json_lexer_destroy_mips64
-#define json_lexer_feed json_lexer_feed_mips64
-#define json_lexer_feed_char json_lexer_feed_char_mips64
-#define json_lexer_flush json_lexer_flush_mips64
-#define json_lexer_init json_lexer_init_mips64
-#define json_message_parser_destroy json_message_parser_destroy_mips64
-#define json_message_parser_feed json_message_parser_feed_mips64
-#define json_message_parser_flush json_message_parser_flush_mips64
-#define json_message_parser_init json_message_parser_init_mips64
-#define json_message_process_token json_message_process_token_mips64
-#define json_parser_parse json_parser_parse_mips64
-#define json_parser_parse_err json_parser_parse_err_mips64
 #define kvm_to_cpreg_id kvm_to_cpreg_id_mips64
 #define last_ram_offset last_ram_offset_mips64
 #define ldl_be_p ldl_be_p_mips64
@@ -2007,11 +1954,6 @@
 #define log_cpu_state log_cpu_state_mips64
 #define lpae_cp_reginfo lpae_cp_reginfo_mips64
 #define lt128 lt128_mips64
-#define machine_class_init machine_class_init_mips64
-#define machine_finalize machine_finalize_mips64
-#define machine_info machine_info_mips64
-#define machine_initfn machine_initfn_mips64
-#define machine_register_types machine_register_types_mips64
 #define machvirt_init machvirt_init_mips64
 #define machvirt_machine_init machvirt_machine_init_mips64
 #define maj maj_mips64
@@ -2111,10 +2053,7 @@
 #define memory_region_write_accessor memory_region_write_accessor_mips64
 #define memory_region_wrong_endianness memory_region_wrong_endianness_mips64
 #define memory_try_enable_merging memory_try_enable_merging_mips64
-#define mktimegm mktimegm_mips64
-#define module_call_init module_call_init_mips64
 #define module_load module_load_mips64
-#define mod_utf8_codepoint mod_utf8_codepoint_mips64
 #define mpidr_cp_reginfo mpidr_cp_reginfo_mips64
 #define mpidr_read mpidr_read_mips64
 #define msr_mask msr_mask_mips64
@@ -2135,7 +2074,6 @@
 #define neon_store_reg64 neon_store_reg64_mips64
 #define neon_store_scratch neon_store_scratch_mips64
 #define new_ldst_label new_ldst_label_mips64
-#define next_list next_list_mips64
 #define normalizeFloat128Subnormal normalizeFloat128Subnormal_mips64
 #define normalizeFloat16Subnormal normalizeFloat16Subnormal_mips64
 #define normalizeFloat32Subnormal normalizeFloat32Subnormal_mips64
@@ -2148,61 +2086,6 @@
 #define not_v6_cp_reginfo not_v6_cp_reginfo_mips64
 #define not_v7_cp_reginfo not_v7_cp_reginfo_mips64
 #define not_v8_cp_reginfo not_v8_cp_reginfo_mips64
-#define object_child_foreach object_child_foreach_mips64
-#define object_class_foreach object_class_foreach_mips64
-#define object_class_foreach_tramp object_class_foreach_tramp_mips64
-#define object_class_get_list object_class_get_list_mips64
-#define object_class_get_list_tramp object_class_get_list_tramp_mips64
-#define object_class_get_parent object_class_get_parent_mips64
-#define object_deinit object_deinit_mips64
-#define object_dynamic_cast object_dynamic_cast_mips64
-#define object_finalize object_finalize_mips64
-#define object_finalize_child_property object_finalize_child_property_mips64
-#define object_get_child_property object_get_child_property_mips64
-#define object_get_link_property object_get_link_property_mips64
-#define object_get_root object_get_root_mips64
-#define object_initialize_with_type object_initialize_with_type_mips64
-#define object_init_with_type object_init_with_type_mips64
-#define object_instance_init object_instance_init_mips64
-#define object_new_with_type object_new_with_type_mips64
-#define object_post_init_with_type object_post_init_with_type_mips64
-#define object_property_add_alias object_property_add_alias_mips64
-#define object_property_add_link object_property_add_link_mips64
-#define object_property_add_uint16_ptr object_property_add_uint16_ptr_mips64
-#define object_property_add_uint32_ptr object_property_add_uint32_ptr_mips64
-#define object_property_add_uint64_ptr object_property_add_uint64_ptr_mips64
-#define object_property_add_uint8_ptr object_property_add_uint8_ptr_mips64
-#define object_property_allow_set_link object_property_allow_set_link_mips64
-#define object_property_del object_property_del_mips64
-#define object_property_del_all object_property_del_all_mips64
-#define object_property_del_child object_property_del_child_mips64
-#define object_property_find object_property_find_mips64
-#define object_property_get object_property_get_mips64
-#define object_property_get_bool object_property_get_bool_mips64
-#define object_property_get_enum object_property_get_enum_mips64
-#define object_property_get_int object_property_get_int_mips64
-#define object_property_get_link object_property_get_link_mips64
-#define object_property_get_qobject object_property_get_qobject_mips64
-#define object_property_get_str object_property_get_str_mips64
-#define object_property_get_type object_property_get_type_mips64
-#define object_property_get_uint16List object_property_get_uint16List_mips64
-#define object_property_is_child object_property_is_child_mips64
-#define object_property_print object_property_print_mips64
-#define object_property_set object_property_set_mips64
-#define object_property_set_description object_property_set_description_mips64
-#define object_property_set_link object_property_set_link_mips64
-#define object_property_set_qobject object_property_set_qobject_mips64
-#define object_release_link_property object_release_link_property_mips64
-#define object_resolve_abs_path object_resolve_abs_path_mips64
-#define object_resolve_child_property object_resolve_child_property_mips64
-#define object_resolve_link object_resolve_link_mips64
-#define object_resolve_link_property object_resolve_link_property_mips64
-#define object_resolve_partial_path object_resolve_partial_path_mips64
-#define object_resolve_path object_resolve_path_mips64
-#define object_resolve_path_component object_resolve_path_component_mips64
-#define object_resolve_path_type object_resolve_path_type_mips64
-#define object_set_link_property object_set_link_property_mips64
-#define object_unparent object_unparent_mips64
 #define omap_cachemaint_write omap_cachemaint_write_mips64
 #define omap_cp_reginfo omap_cp_reginfo_mips64
 #define omap_threadid_write omap_threadid_write_mips64
@@ -2216,7 +2099,6 @@
 #define opts_do_parse opts_do_parse_mips64
 #define opt_set opt_set_mips64
 #define opts_parse opts_parse_mips64
-#define output_type_enum output_type_enum_mips64
 #define packFloat128 packFloat128_mips64
 #define packFloat16 packFloat16_mips64
 #define packFloat32 packFloat32_mips64
@@ -2236,10 +2118,6 @@
 #define parse_keyword parse_keyword_mips64
 #define parse_literal parse_literal_mips64
 #define parse_object parse_object_mips64
-#define parse_optional parse_optional_mips64
-#define parse_option_bool parse_option_bool_mips64
-#define parse_option_number parse_option_number_mips64
-#define parse_option_size parse_option_size_mips64
 #define parse_pair parse_pair_mips64
 #define parser_context_free parser_context_free_mips64
 #define parser_context_new parser_context_new_mips64
@@ -2247,14 +2125,6 @@
 #define parser_context_pop_token parser_context_pop_token_mips64
 #define parser_context_restore parser_context_restore_mips64
 #define parser_context_save parser_context_save_mips64
-#define parse_str parse_str_mips64
-#define parse_type_bool parse_type_bool_mips64
-#define parse_type_int parse_type_int_mips64
-#define parse_type_number parse_type_number_mips64
-#define parse_type_size parse_type_size_mips64
-#define parse_type_str parse_type_str_mips64
-#define parse_uint parse_uint_mips64
-#define parse_uint_full parse_uint_full_mips64
 #define parse_value parse_value_mips64
 #define par_write par_write_mips64
 #define patch_reloc patch_reloc_mips64
@@ -2292,32 +2162,12 @@
 #define pmsav5_insn_ap_write pmsav5_insn_ap_write_mips64
 #define pmuserenr_write pmuserenr_write_mips64
 #define pmxevtyper_write pmxevtyper_write_mips64
-#define pow2floor pow2floor_mips64
-#define print_type_bool print_type_bool_mips64
-#define print_type_int print_type_int_mips64
-#define print_type_number print_type_number_mips64
-#define print_type_size print_type_size_mips64
-#define print_type_str print_type_str_mips64
 #define propagateFloat128NaN propagateFloat128NaN_mips64
 #define propagateFloat32MulAddNaN propagateFloat32MulAddNaN_mips64
 #define propagateFloat32NaN propagateFloat32NaN_mips64
 #define propagateFloat64MulAddNaN propagateFloat64MulAddNaN_mips64
 #define propagateFloat64NaN propagateFloat64NaN_mips64
 #define propagateFloatx80NaN propagateFloatx80NaN_mips64
-#define property_get_alias property_get_alias_mips64
-#define property_get_bool property_get_bool_mips64
-#define property_get_str property_get_str_mips64
-#define property_get_uint16_ptr property_get_uint16_ptr_mips64
-#define property_get_uint32_ptr property_get_uint32_ptr_mips64
-#define property_get_uint64_ptr property_get_uint64_ptr_mips64
-#define property_get_uint8_ptr property_get_uint8_ptr_mips64
-#define property_release_alias property_release_alias_mips64
-#define property_release_bool property_release_bool_mips64
-#define property_release_str property_release_str_mips64
-#define property_resolve_alias property_resolve_alias_mips64
-#define property_set_alias property_set_alias_mips64
-#define property_set_bool property_set_bool_mips64
-#define property_set_str property_set_str_mips64
 #define pstate_read pstate_read_mips64
 #define pstate_write pstate_write_mips64
 #define pxa250_initfn pxa250_initfn_mips64
@@ -2331,25 +2181,6 @@
 #define pxa270b1_initfn pxa270b1_initfn_mips64
 #define pxa270c0_initfn pxa270c0_initfn_mips64
 #define pxa270c5_initfn pxa270c5_initfn_mips64
-#define qapi_dealloc_end_implicit_struct qapi_dealloc_end_implicit_struct_mips64
-#define qapi_dealloc_end_list qapi_dealloc_end_list_mips64
-#define qapi_dealloc_end_struct qapi_dealloc_end_struct_mips64
-#define qapi_dealloc_get_visitor qapi_dealloc_get_visitor_mips64
-#define qapi_dealloc_next_list qapi_dealloc_next_list_mips64
-#define qapi_dealloc_pop qapi_dealloc_pop_mips64
-#define qapi_dealloc_push qapi_dealloc_push_mips64
-#define qapi_dealloc_start_implicit_struct qapi_dealloc_start_implicit_struct_mips64
-#define qapi_dealloc_start_list qapi_dealloc_start_list_mips64
-#define qapi_dealloc_start_struct qapi_dealloc_start_struct_mips64
-#define qapi_dealloc_start_union qapi_dealloc_start_union_mips64
-#define qapi_dealloc_type_bool qapi_dealloc_type_bool_mips64
-#define qapi_dealloc_type_enum qapi_dealloc_type_enum_mips64
-#define qapi_dealloc_type_int qapi_dealloc_type_int_mips64
-#define qapi_dealloc_type_number qapi_dealloc_type_number_mips64
-#define qapi_dealloc_type_size qapi_dealloc_type_size_mips64
-#define qapi_dealloc_type_str qapi_dealloc_type_str_mips64
-#define qapi_dealloc_visitor_cleanup qapi_dealloc_visitor_cleanup_mips64
-#define qapi_dealloc_visitor_new qapi_dealloc_visitor_new_mips64
 #define qapi_free_boolList qapi_free_boolList_mips64
 #define qapi_free_ErrorClassList qapi_free_ErrorClassList_mips64
 #define qapi_free_int16List qapi_free_int16List_mips64
@@ -2366,76 +2197,18 @@
 #define qapi_free_X86CPUFeatureWordInfo qapi_free_X86CPUFeatureWordInfo_mips64
 #define qapi_free_X86CPUFeatureWordInfoList qapi_free_X86CPUFeatureWordInfoList_mips64
 #define qapi_free_X86CPURegister32List qapi_free_X86CPURegister32List_mips64
-#define qbool_destroy_obj qbool_destroy_obj_mips64
-#define qbool_from_int qbool_from_int_mips64
-#define qbool_get_int qbool_get_int_mips64
-#define qbool_type qbool_type_mips64
-#define qbus_create qbus_create_mips64
-#define qbus_create_inplace qbus_create_inplace_mips64
-#define qbus_finalize qbus_finalize_mips64
-#define qbus_initfn qbus_initfn_mips64
-#define qbus_realize qbus_realize_mips64
-#define qdev_create qdev_create_mips64
-#define qdev_get_type qdev_get_type_mips64
-#define qdev_register_types qdev_register_types_mips64
-#define qdev_set_parent_bus qdev_set_parent_bus_mips64
-#define qdev_try_create qdev_try_create_mips64
-#define qdict_add_key qdict_add_key_mips64
-#define qdict_array_split qdict_array_split_mips64
-#define qdict_clone_shallow qdict_clone_shallow_mips64
-#define qdict_del qdict_del_mips64
-#define qdict_destroy_obj qdict_destroy_obj_mips64
-#define qdict_entry_key qdict_entry_key_mips64
-#define qdict_entry_value qdict_entry_value_mips64
-#define qdict_extract_subqdict qdict_extract_subqdict_mips64
-#define qdict_find qdict_find_mips64
-#define qdict_first qdict_first_mips64
-#define qdict_flatten qdict_flatten_mips64
-#define qdict_flatten_qdict qdict_flatten_qdict_mips64
-#define qdict_flatten_qlist qdict_flatten_qlist_mips64
-#define qdict_get qdict_get_mips64
-#define qdict_get_bool qdict_get_bool_mips64
-#define qdict_get_double qdict_get_double_mips64
-#define qdict_get_int qdict_get_int_mips64
-#define qdict_get_obj qdict_get_obj_mips64
-#define qdict_get_qdict qdict_get_qdict_mips64
-#define qdict_get_qlist qdict_get_qlist_mips64
-#define qdict_get_str qdict_get_str_mips64
-#define qdict_get_try_bool qdict_get_try_bool_mips64
-#define qdict_get_try_int qdict_get_try_int_mips64
-#define qdict_get_try_str qdict_get_try_str_mips64
-#define qdict_haskey qdict_haskey_mips64
-#define qdict_has_prefixed_entries qdict_has_prefixed_entries_mips64
-#define qdict_iter qdict_iter_mips64
-#define qdict_join qdict_join_mips64
-#define qdict_new qdict_new_mips64
-#define qdict_next qdict_next_mips64
-#define qdict_next_entry qdict_next_entry_mips64
-#define qdict_put_obj qdict_put_obj_mips64
-#define qdict_size qdict_size_mips64
-#define qdict_type qdict_type_mips64
 #define qemu_clock_get_us qemu_clock_get_us_mips64
-#define qemu_clock_ptr qemu_clock_ptr_mips64
 #define qemu_clocks qemu_clocks_mips64
-#define qemu_cond_destroy qemu_cond_destroy_mips64
 #define qemu_cpu_is_self qemu_cpu_is_self_mips64
-#define qemu_cpu_kick_thread qemu_cpu_kick_thread_mips64
-#define qemu_daemon qemu_daemon_mips64
-#define qemu_event_destroy qemu_event_destroy_mips64
-#define qemu_event_init qemu_event_init_mips64
-#define qemu_event_reset qemu_event_reset_mips64
-#define qemu_event_set qemu_event_set_mips64
-#define qemu_event_wait qemu_event_wait_mips64
-#define qemu_fdatasync qemu_fdatasync_mips64
 #define qemu_flush_coalesced_mmio_buffer qemu_flush_coalesced_mmio_buffer_mips64
 #define qemu_get_cpu qemu_get_cpu_mips64
 #define qemu_get_guest_memory_mapping qemu_get_guest_memory_mapping_mips64
 #define qemu_get_guest_simple_memory_mapping qemu_get_guest_simple_memory_mapping_mips64
-#define qemu_get_local_state_pathname qemu_get_local_state_pathname_mips64
 #define qemu_get_ram_block qemu_get_ram_block_mips64
 #define qemu_get_ram_block_host_ptr qemu_get_ram_block_host_ptr_mips64
 #define qemu_get_ram_fd qemu_get_ram_fd_mips64
 #define qemu_get_ram_ptr qemu_get_ram_ptr_mips64
+#define qemu_ram_block_base qemu_ram_block_base_mips64
 #define qemu_host_page_mask qemu_host_page_mask_mips64
 #define qemu_host_page_size qemu_host_page_size_mips64
 #define qemu_init_vcpu qemu_init_vcpu_mips64
@@ -2445,55 +2218,8 @@
 #define qemu_log_flush qemu_log_flush_mips64
 #define qemu_loglevel_mask qemu_loglevel_mask_mips64
 #define qemu_log_vprintf qemu_log_vprintf_mips64
-#define qemu_mutex_destroy qemu_mutex_destroy_mips64
 #define qemu_mutex_lock_ramlist qemu_mutex_lock_ramlist_mips64
-#define qemu_mutex_trylock qemu_mutex_trylock_mips64
 #define qemu_mutex_unlock_ramlist qemu_mutex_unlock_ramlist_mips64
-#define qemu_oom_check qemu_oom_check_mips64
-#define qemu_opt_del qemu_opt_del_mips64
-#define qemu_opt_del_all qemu_opt_del_all_mips64
-#define qemu_opt_find qemu_opt_find_mips64
-#define qemu_opt_foreach qemu_opt_foreach_mips64
-#define qemu_opt_get qemu_opt_get_mips64
-#define qemu_opt_get_bool qemu_opt_get_bool_mips64
-#define qemu_opt_get_bool_del qemu_opt_get_bool_del_mips64
-#define qemu_opt_get_bool_helper qemu_opt_get_bool_helper_mips64
-#define qemu_opt_get_del qemu_opt_get_del_mips64
-#define qemu_opt_get_number qemu_opt_get_number_mips64
-#define qemu_opt_get_number_del qemu_opt_get_number_del_mips64
-#define qemu_opt_get_number_helper qemu_opt_get_number_helper_mips64
-#define qemu_opt_get_size qemu_opt_get_size_mips64
-#define qemu_opt_get_size_del qemu_opt_get_size_del_mips64
-#define qemu_opt_get_size_helper qemu_opt_get_size_helper_mips64
-#define qemu_opt_has_help_opt qemu_opt_has_help_opt_mips64
-#define qemu_opt_parse qemu_opt_parse_mips64
-#define qemu_opts_absorb_qdict qemu_opts_absorb_qdict_mips64
-#define qemu_opts_append qemu_opts_append_mips64
-#define qemu_opts_create qemu_opts_create_mips64
-#define qemu_opts_del qemu_opts_del_mips64
-#define qemu_opts_do_parse qemu_opts_do_parse_mips64
-#define qemu_opt_set qemu_opt_set_mips64
-#define qemu_opt_set_bool qemu_opt_set_bool_mips64
-#define qemu_opt_set_err qemu_opt_set_err_mips64
-#define qemu_opt_set_number qemu_opt_set_number_mips64
-#define qemu_opts_find qemu_opts_find_mips64
-#define qemu_opts_foreach qemu_opts_foreach_mips64
-#define qemu_opts_free qemu_opts_free_mips64
-#define qemu_opts_from_qdict qemu_opts_from_qdict_mips64
-#define qemu_opts_from_qdict_1 qemu_opts_from_qdict_1_mips64
-#define qemu_opts_id qemu_opts_id_mips64
-#define qemu_opts_parse qemu_opts_parse_mips64
-#define qemu_opts_print qemu_opts_print_mips64
-#define qemu_opts_print_help qemu_opts_print_help_mips64
-#define qemu_opts_reset qemu_opts_reset_mips64
-#define qemu_opts_set qemu_opts_set_mips64
-#define qemu_opts_set_defaults qemu_opts_set_defaults_mips64
-#define qemu_opts_set_id qemu_opts_set_id_mips64
-#define qemu_opts_to_qdict qemu_opts_to_qdict_mips64
-#define qemu_opts_validate qemu_opts_validate_mips64
-#define qemu_opt_unset qemu_opt_unset_mips64
-#define qemu_parse_fd qemu_parse_fd_mips64
-#define qemu_pipe qemu_pipe_mips64
 #define qemu_ram_addr_from_host qemu_ram_addr_from_host_mips64
 #define qemu_ram_addr_from_host_nofail qemu_ram_addr_from_host_nofail_mips64
 #define qemu_ram_alloc qemu_ram_alloc_mips64
@@ -2506,110 +2232,16 @@
 #define qemu_ram_setup_dump qemu_ram_setup_dump_mips64
 #define qemu_ram_unset_idstr qemu_ram_unset_idstr_mips64
 #define qemu_real_host_page_size qemu_real_host_page_size_mips64
-#define qemu_sem_destroy qemu_sem_destroy_mips64
-#define qemu_sem_init qemu_sem_init_mips64
-#define qemu_sem_post qemu_sem_post_mips64
-#define qemu_sem_timedwait qemu_sem_timedwait_mips64
-#define qemu_sem_wait qemu_sem_wait_mips64
-#define qemu_set_cloexec qemu_set_cloexec_mips64
-#define qemu_set_tty_echo qemu_set_tty_echo_mips64
 #define qemu_st_helpers qemu_st_helpers_mips64
-#define qemu_strnlen qemu_strnlen_mips64
-#define qemu_strsep qemu_strsep_mips64
 #define qemu_tcg_cpu_thread_fn qemu_tcg_cpu_thread_fn_mips64
 #define qemu_tcg_init_vcpu qemu_tcg_init_vcpu_mips64
-#define qemu_thread_exit qemu_thread_exit_mips64
-#define qemu_try_memalign qemu_try_memalign_mips64
-#define qentry_destroy qentry_destroy_mips64
-#define qerror_human qerror_human_mips64
-#define qerror_report qerror_report_mips64
-#define qerror_report_err qerror_report_err_mips64
-#define qfloat_destroy_obj qfloat_destroy_obj_mips64
-#define qfloat_from_double qfloat_from_double_mips64
-#define qfloat_get_double qfloat_get_double_mips64
-#define qfloat_type qfloat_type_mips64
-#define qint_destroy_obj qint_destroy_obj_mips64
-#define qint_from_int qint_from_int_mips64
-#define qint_get_int qint_get_int_mips64
-#define qint_type qint_type_mips64
-#define qlist_append_obj qlist_append_obj_mips64
-#define qlist_copy qlist_copy_mips64
-#define qlist_copy_elem qlist_copy_elem_mips64
-#define qlist_destroy_obj qlist_destroy_obj_mips64
-#define qlist_empty qlist_empty_mips64
 #define qlist_entry_obj qlist_entry_obj_mips64
 #define qlist_first qlist_first_mips64
-#define qlist_iter qlist_iter_mips64
-#define qlist_new qlist_new_mips64
 #define qlist_next qlist_next_mips64
-#define qlist_peek qlist_peek_mips64
-#define qlist_pop qlist_pop_mips64
-#define qlist_size qlist_size_mips64
-#define qlist_size_iter qlist_size_iter_mips64
-#define qlist_type qlist_type_mips64
-#define qmp_input_end_implicit_struct qmp_input_end_implicit_struct_mips64
-#define qmp_input_end_list qmp_input_end_list_mips64
-#define qmp_input_end_struct qmp_input_end_struct_mips64
-#define qmp_input_get_next_type qmp_input_get_next_type_mips64
-#define qmp_input_get_object qmp_input_get_object_mips64
-#define qmp_input_get_visitor qmp_input_get_visitor_mips64
-#define qmp_input_next_list qmp_input_next_list_mips64
-#define qmp_input_optional qmp_input_optional_mips64
-#define qmp_input_pop qmp_input_pop_mips64
-#define qmp_input_push qmp_input_push_mips64
-#define qmp_input_start_implicit_struct qmp_input_start_implicit_struct_mips64
-#define qmp_input_start_list qmp_input_start_list_mips64
-#define qmp_input_start_struct qmp_input_start_struct_mips64
-#define qmp_input_type_bool qmp_input_type_bool_mips64
-#define qmp_input_type_int qmp_input_type_int_mips64
-#define qmp_input_type_number qmp_input_type_number_mips64
-#define qmp_input_type_str qmp_input_type_str_mips64
-#define qmp_input_visitor_cleanup qmp_input_visitor_cleanup_mips64
-#define qmp_input_visitor_new qmp_input_visitor_new_mips64
-#define qmp_input_visitor_new_strict qmp_input_visitor_new_strict_mips64
-#define qmp_output_add_obj qmp_output_add_obj_mips64
-#define qmp_output_end_list qmp_output_end_list_mips64
-#define qmp_output_end_struct qmp_output_end_struct_mips64
-#define qmp_output_first qmp_output_first_mips64
-#define qmp_output_get_qobject qmp_output_get_qobject_mips64
-#define qmp_output_get_visitor qmp_output_get_visitor_mips64
-#define qmp_output_last qmp_output_last_mips64
-#define qmp_output_next_list qmp_output_next_list_mips64
-#define qmp_output_pop qmp_output_pop_mips64
-#define qmp_output_push_obj qmp_output_push_obj_mips64
-#define qmp_output_start_list qmp_output_start_list_mips64
-#define qmp_output_start_struct qmp_output_start_struct_mips64
-#define qmp_output_type_bool qmp_output_type_bool_mips64
-#define qmp_output_type_int qmp_output_type_int_mips64
-#define qmp_output_type_number qmp_output_type_number_mips64
-#define qmp_output_type_str qmp_output_type_str_mips64
-#define qmp_output_visitor_cleanup qmp_output_visitor_cleanup_mips64
-#define qmp_output_visitor_new qmp_output_visitor_new_mips64
 #define qobject_decref qobject_decref_mips64
-#define qobject_from_json qobject_from_json_mips64
-#define qobject_from_jsonf qobject_from_jsonf_mips64
-#define qobject_from_jsonv qobject_from_jsonv_mips64
 #define qobject_incref qobject_incref_mips64
-#define qobject_to_json qobject_to_json_mips64
-#define qobject_to_json_pretty qobject_to_json_pretty_mips64
-#define qobject_to_qbool qobject_to_qbool_mips64
-#define qobject_to_qdict qobject_to_qdict_mips64
-#define qobject_to_qfloat qobject_to_qfloat_mips64
-#define qobject_to_qint qobject_to_qint_mips64
-#define qobject_to_qlist qobject_to_qlist_mips64
-#define qobject_to_qstring qobject_to_qstring_mips64
 #define qobject_type qobject_type_mips64
-#define qstring_append qstring_append_mips64
-#define qstring_append_chr qstring_append_chr_mips64
-#define qstring_append_int qstring_append_int_mips64
-#define qstring_destroy_obj qstring_destroy_obj_mips64
 #define qstring_from_escaped_str qstring_from_escaped_str_mips64
-#define qstring_from_str qstring_from_str_mips64
-#define qstring_from_substr qstring_from_substr_mips64
-#define qstring_get_length qstring_get_length_mips64
-#define qstring_get_str qstring_get_str_mips64
-#define qstring_new qstring_new_mips64
-#define qstring_type qstring_type_mips64
 #define ram_block_add ram_block_add_mips64
 #define ram_size ram_size_mips64
 #define range_compare range_compare_mips64
@@ -2619,7 +2251,6 @@
 #define ranges_can_merge ranges_can_merge_mips64
 #define raw_read raw_read_mips64
 #define raw_write raw_write_mips64
-#define rcon rcon_mips64
 #define read_raw_cp_reg read_raw_cp_reg_mips64
 #define recip_estimate recip_estimate_mips64
 #define recip_sqrt_estimate recip_sqrt_estimate_mips64
@@ -2627,7 +2258,6 @@
 #define register_multipage register_multipage_mips64
 #define register_subpage register_subpage_mips64
 #define register_tm_clones register_tm_clones_mips64
-#define register_types_object register_types_object_mips64
 #define regnames regnames_mips64
 #define render_memory_region render_memory_region_mips64
 #define reset_all_temps reset_all_temps_mips64
@@ -2678,15 +2308,6 @@
 #define shortShift192Left shortShift192Left_mips64
 #define simple_mpu_ap_bits simple_mpu_ap_bits_mips64
 #define size_code_gen_buffer size_code_gen_buffer_mips64
-#define slow_bitmap_and slow_bitmap_and_mips64
-#define slow_bitmap_andnot slow_bitmap_andnot_mips64
-#define slow_bitmap_complement slow_bitmap_complement_mips64
-#define slow_bitmap_empty slow_bitmap_empty_mips64
-#define slow_bitmap_equal slow_bitmap_equal_mips64
-#define slow_bitmap_full slow_bitmap_full_mips64
-#define slow_bitmap_intersects slow_bitmap_intersects_mips64
-#define slow_bitmap_or slow_bitmap_or_mips64
-#define slow_bitmap_xor slow_bitmap_xor_mips64
 #define softmmu_lock_user softmmu_lock_user_mips64
 #define softmmu_lock_user_string softmmu_lock_user_string_mips64
 #define softmmu_tget32 softmmu_tget32_mips64
@@ -2699,7 +2320,6 @@
 #define spin_unlock spin_unlock_mips64
 #define spsel_read spsel_read_mips64
 #define spsel_write spsel_write_mips64
-#define start_list start_list_mips64
 #define stb_p stb_p_mips64
 #define stb_phys stb_phys_mips64
 #define stl_be_p stl_be_p_mips64
@@ -2720,22 +2340,7 @@
 #define stq_le_p stq_le_p_mips64
 #define stq_le_phys stq_le_phys_mips64
 #define stq_phys stq_phys_mips64
-#define string_input_get_visitor string_input_get_visitor_mips64
-#define string_input_visitor_cleanup string_input_visitor_cleanup_mips64
-#define string_input_visitor_new string_input_visitor_new_mips64
-#define string_output_append string_output_append_mips64
-#define string_output_append_range string_output_append_range_mips64
-#define string_output_get_string string_output_get_string_mips64
-#define string_output_get_visitor string_output_get_visitor_mips64
-#define string_output_set string_output_set_mips64
-#define string_output_visitor_cleanup string_output_visitor_cleanup_mips64
-#define string_output_visitor_new string_output_visitor_new_mips64
-#define stristart stristart_mips64
 #define strongarm_cp_reginfo strongarm_cp_reginfo_mips64
-#define strpadcpy strpadcpy_mips64
-#define strstart strstart_mips64
-#define strtosz strtosz_mips64
-#define strtosz_suffix strtosz_suffix_mips64
 #define stw_be_p stw_be_p_mips64
 #define stw_be_phys stw_be_phys_mips64
 #define stw_he_p stw_he_p_mips64
@@ -2759,7 +2364,6 @@
 #define subpage_read subpage_read_mips64
 #define subpage_register subpage_register_mips64
 #define subpage_write subpage_write_mips64
-#define suffix_mul suffix_mul_mips64
 #define swap_commutative swap_commutative_mips64
 #define swap_commutative2 swap_commutative2_mips64
 #define switch_mode switch_mode_mips64
@@ -2801,6 +2405,7 @@
 #define tb_hash_remove tb_hash_remove_mips64
 #define tb_invalidate_phys_addr tb_invalidate_phys_addr_mips64
 #define tb_invalidate_phys_page_range tb_invalidate_phys_page_range_mips64
+#define tb_invalidate_pc_range tb_invalidate_pc_range_mips64
 #define tb_invalidate_phys_range tb_invalidate_phys_range_mips64
 #define tb_jmp_cache_hash_func tb_jmp_cache_hash_func_mips64
 #define tb_jmp_cache_hash_page tb_jmp_cache_hash_page_mips64
@@ -2811,8 +2416,6 @@
 #define tb_phys_invalidate tb_phys_invalidate_mips64
 #define tb_reset_jump tb_reset_jump_mips64
 #define tb_set_jmp_target tb_set_jmp_target_mips64
-#define tcg_accel_class_init tcg_accel_class_init_mips64
-#define tcg_accel_type tcg_accel_type_mips64
 #define tcg_add_param_i32 tcg_add_param_i32_mips64
 #define tcg_add_param_i64 tcg_add_param_i64_mips64
 #define tcg_add_target_add_op_defs tcg_add_target_add_op_defs_mips64
@@ -2944,7 +2547,6 @@
 #define tcg_global_reg_new_i64 tcg_global_reg_new_i64_mips64
 #define tcg_global_reg_new_internal tcg_global_reg_new_internal_mips64
 #define tcg_handle_interrupt tcg_handle_interrupt_mips64
-#define tcg_init tcg_init_mips64
 #define tcg_invert_cond tcg_invert_cond_mips64
 #define tcg_la_bb_end tcg_la_bb_end_mips64
 #define tcg_la_br_end tcg_la_br_end_mips64
@@ -3040,7 +2642,6 @@
 #define tcg_temp_new_internal tcg_temp_new_internal_mips64
 #define tcg_temp_new_internal_i32 tcg_temp_new_internal_i32_mips64
 #define tcg_temp_new_internal_i64 tcg_temp_new_internal_i64_mips64
-#define tdb_hash tdb_hash_mips64
 #define teecr_write teecr_write_mips64
 #define teehbr_access teehbr_access_mips64
 #define temp_allocate_frame temp_allocate_frame_mips64
@@ -3076,34 +2677,16 @@
 #define tlb_set_dirty1 tlb_set_dirty1_mips64
 #define tlb_unprotect_code_phys tlb_unprotect_code_phys_mips64
 #define tlb_vaddr_to_host tlb_vaddr_to_host_mips64
-#define to_json to_json_mips64
-#define to_json_dict_iter to_json_dict_iter_mips64
-#define to_json_list_iter to_json_list_iter_mips64
 #define token_get_type token_get_type_mips64
 #define token_get_value token_get_value_mips64
 #define token_is_escape token_is_escape_mips64
 #define token_is_keyword token_is_keyword_mips64
 #define token_is_operator token_is_operator_mips64
 #define tokens_append_from_iter tokens_append_from_iter_mips64
-#define to_qiv to_qiv_mips64
-#define to_qov to_qov_mips64
 #define tosa_init tosa_init_mips64
 #define tosa_machine_init tosa_machine_init_mips64
 #define tswap32 tswap32_mips64
 #define tswap64 tswap64_mips64
-#define type_class_get_size type_class_get_size_mips64
-#define type_get_by_name type_get_by_name_mips64
-#define type_get_parent type_get_parent_mips64
-#define type_has_parent type_has_parent_mips64
-#define type_initialize type_initialize_mips64
-#define type_initialize_interface type_initialize_interface_mips64
-#define type_is_ancestor type_is_ancestor_mips64
-#define type_new type_new_mips64
-#define type_object_get_size type_object_get_size_mips64
-#define type_register_internal type_register_internal_mips64
-#define type_table_add type_table_add_mips64
-#define type_table_get type_table_get_mips64
-#define type_table_lookup type_table_lookup_mips64
 #define uint16_to_float32 uint16_to_float32_mips64
 #define uint16_to_float64 uint16_to_float64_mips64
 #define uint32_to_float32 uint32_to_float32_mips64
@@ -3111,8 +2694,6 @@
 #define uint64_to_float128 uint64_to_float128_mips64
 #define uint64_to_float32 uint64_to_float32_mips64
 #define uint64_to_float64 uint64_to_float64_mips64
-#define uleb128_decode_small uleb128_decode_small_mips64
-#define uleb128_encode_small uleb128_encode_small_mips64
 #define unassigned_io_ops unassigned_io_ops_mips64
 #define unassigned_io_read unassigned_io_read_mips64
 #define unassigned_io_write unassigned_io_write_mips64
@@ -3142,17 +2723,6 @@
 #define vfp_set_fpcr vfp_set_fpcr_mips64
 #define vfp_set_fpscr vfp_set_fpscr_mips64
 #define vfp_set_fpsr vfp_set_fpsr_mips64
-#define visit_end_implicit_struct visit_end_implicit_struct_mips64
-#define visit_end_list visit_end_list_mips64
-#define visit_end_struct visit_end_struct_mips64
-#define visit_end_union visit_end_union_mips64
-#define visit_get_next_type visit_get_next_type_mips64
-#define visit_next_list visit_next_list_mips64
-#define visit_optional visit_optional_mips64
-#define visit_start_implicit_struct visit_start_implicit_struct_mips64
-#define visit_start_list visit_start_list_mips64
-#define visit_start_struct visit_start_struct_mips64
-#define visit_start_union visit_start_union_mips64
 #define vmsa_cp_reginfo vmsa_cp_reginfo_mips64
 #define vmsa_tcr_el1_write vmsa_tcr_el1_write_mips64
 #define vmsa_ttbcr_raw_write vmsa_ttbcr_raw_write_mips64
@@ -3934,6 +3504,7 @@
 #define exception_resume_pc exception_resume_pc_mips64
 #define mips_cpu_do_interrupt mips_cpu_do_interrupt_mips64
 #define mips_cpu_exec_interrupt mips_cpu_exec_interrupt_mips64
+#define mips_cpu_synchronize_from_tb mips_cpu_synchronize_from_tb_mips64
 #define r4k_invalidate_tlb r4k_invalidate_tlb_mips64
 #define helper_absq_s_ob helper_absq_s_ob_mips64
 #define helper_absq_s_qh helper_absq_s_qh_mips64
@@ -14,7 +14,6 @@
 #include "qapi/string-input-visitor.h"
 #include "qapi/visitor-impl.h"
 #include "qapi/qmp/qerror.h"
-#include "qemu/option.h"
 #include "qemu/queue.h"
 #include "qemu/range.h"
 
@@ -221,6 +220,39 @@ error:
               "an int64 value or range");
 }
 
+/* Unicorn: was parse_option_size() in the removed util/qemu-option.c;
+   this visitor was its last user */
+static void parse_size(const char *name, const char *value,
+                       uint64_t *ret, Error **errp)
+{
+    char *postfix;
+    double sizef;
+
+    sizef = strtod(value, &postfix);
+    switch (*postfix) {
+    case 'T':
+        sizef *= 1024;
+        /* fall through */
+    case 'G':
+        sizef *= 1024;
+        /* fall through */
+    case 'M':
+        sizef *= 1024;
+        /* fall through */
+    case 'K':
+    case 'k':
+        sizef *= 1024;
+        /* fall through */
+    case 'b':
+    case '\0':
+        *ret = (uint64_t) sizef;
+        break;
+    default:
+        error_set(errp, QERR_INVALID_PARAMETER_VALUE, name, "a size");
+        break;
+    }
+}
+
 static void parse_type_size(Visitor *v, uint64_t *obj, const char *name,
                             Error **errp)
 {
@@ -229,7 +261,7 @@ static void parse_type_size(Visitor *v, uint64_t *obj, const char *name,
     uint64_t val;
 
     if (siv->string) {
-        parse_option_size(name, siv->string, &val, &err);
+        parse_size(name, siv->string, &val, &err);
     } else {
         error_set(errp, QERR_INVALID_PARAMETER_TYPE, name ? name : "null",
                   "size");
@@ -20,9 +20,12 @@
 #include "qemu-common.h"
 #include "qemu/log.h"
 
+/* The globals stay defined even in UNICORN_NO_LOG builds so that call
+   sites the optimizer does not eliminate still link. */
 FILE *qemu_logfile;
 int qemu_loglevel;
 
+#ifndef UNICORN_NO_LOG
 void qemu_log(const char *fmt, ...)
 {
     va_list ap;
@@ -44,4 +47,5 @@ void qemu_log_mask(int mask, const char *fmt, ...)
     }
     va_end(ap);
 }
+#endif /* !UNICORN_NO_LOG */
 
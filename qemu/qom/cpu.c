@@ -168,7 +168,10 @@ static void cpu_common_reset(CPUState *cpu)
     cpu->icount_extra = 0;
     cpu->icount_decr.u32 = 0;
     cpu->can_do_io = 0;
-    memset(cpu->tb_jmp_cache, 0, TB_JMP_CACHE_SIZE * sizeof(void *));
+    /* O(1) generation bump instead of clearing the maximum-size array;
+       on the bring-up path the cache pages then stay untouched zero
+       pages until translation actually fills them */
+    tb_jmp_cache_flush(cpu);
 }
 
 static bool cpu_common_has_work(CPUState *cs)
@@ -129,6 +129,17 @@ static TypeImpl *type_new(struct uc_struct *uc, const TypeInfo *info)
 static TypeImpl *type_register_internal(struct uc_struct *uc, const TypeInfo *info)
 {
     TypeImpl *ti;
+
+    /* Attached to a published type graph (see type_table_attach): every
+       static TypeInfo was already interned by the engine that built the
+       graph, so re-registration resolves to the existing type. */
+    if (uc->type_table_shared) {
+        ti = type_table_lookup(uc, info->name);
+        if (ti != NULL) {
+            return ti;
+        }
+    }
+
     ti = type_new(uc, info);
 
     type_table_add(uc, ti);
@@ -300,6 +311,71 @@ static void type_initialize(struct uc_struct *uc, TypeImpl *ti)
     }
 }
 
+/* Process-global cache of fully built type graphs, one per arch variant
+   (keyed by the arch init entry point, see machine_initialize()). The
+   TypeImpl graph and its classes hold only static data and function
+   pointers, so later instances attach to the published graph instead of
+   re-interning every static TypeInfo table. */
+typedef struct TypeTableCache {
+    void *key;
+    GHashTable *table;
+    struct TypeTableCache *next;
+} TypeTableCache;
+
+static TypeTableCache *type_table_caches;
+
+bool type_table_attach(struct uc_struct *uc, void *key)
+{
+    TypeTableCache *c = type_table_caches;
+
+    /* pairs with the smp_wmb() in type_table_publish(): a cache node is
+       only reachable once its fields are visible */
+    smp_rmb();
+    for (; c != NULL; c = c->next) {
+        if (c->key == key) {
+            uc->type_table = c->table;
+            uc->type_table_shared = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void type_table_collect(gpointer key, gpointer value, gpointer opaque)
+{
+    GSList **types = opaque;
+
+    *types = g_slist_prepend(*types, value);
+}
+
+void type_table_publish(struct uc_struct *uc, void *key)
+{
+    TypeTableCache *c;
+    GSList *types = NULL, *e;
+
+    /* Initialize every class up front: attached engines only ever read
+       the graph, they never grow it through a lazy type_initialize().
+       (type_initialize() interns interface types, so the type list is
+       collected before walking it.) */
+    g_hash_table_foreach(uc->type_table, type_table_collect, &types);
+    for (e = types; e != NULL; e = e->next) {
+        type_initialize(uc, e->data);
+    }
+    g_slist_free(types);
+
+    /* Two first opens of the same variant racing here at worst publish
+       the graph twice; attachers take the first match and the duplicate
+       just goes unused. */
+    c = g_new0(TypeTableCache, 1);
+    c->key = key;
+    c->table = uc->type_table;
+    c->next = type_table_caches;
+    smp_wmb();
+    type_table_caches = c;
+    uc->type_table_shared = true;
+}
+
 static void object_init_with_type(struct uc_struct *uc, Object *obj, TypeImpl *ti)
 {
     if (type_has_parent(ti)) {
@@ -322,7 +398,22 @@ static void object_post_init_with_type(struct uc_struct *uc, Object *obj, TypeIm
     }
 }
 
-static void object_initialize_with_type(struct uc_struct *uc, void *data, size_t size, TypeImpl *type)
+static void object_property_free(gpointer data)
+{
+    ObjectProperty *prop = data;
+
+    g_free(prop->name);
+    g_free(prop->type);
+    g_free(prop->description);
+    g_free(prop);
+}
+
+/* Initialize an instance whose storage is already zero-filled.  Keeping
+   the memset out of this path lets object_new_with_type() hand over the
+   allocator's untouched zero pages: large instances - the CPU with its
+   TLB tables and TB jump cache - then only fault pages in as they are
+   first written, instead of dirtying the whole instance up front. */
+static void object_initialize_with_type_zeroed(struct uc_struct *uc, void *data, size_t size, TypeImpl *type)
 {
     Object *obj = data;
 
@@ -333,14 +424,25 @@ static void object_initialize_with_type(struct uc_struct *uc, void *data, size_t
     g_assert(type->abstract == false);
     g_assert(size >= type->instance_size);
 
-    memset(obj, 0, type->instance_size);
     obj->class = type->class;
     object_ref(obj);
-    QTAILQ_INIT(&obj->properties);
+    obj->properties = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                            NULL, object_property_free);
     object_init_with_type(uc, obj, type);
     object_post_init_with_type(uc, obj, type);
 }
 
+static void object_initialize_with_type(struct uc_struct *uc, void *data, size_t size, TypeImpl *type)
+{
+    g_assert(type != NULL);
+    type_initialize(uc, type);
+
+    /* embedded instances arrive in whatever state the container left
+       them; they do need the explicit clear */
+    memset(data, 0, type->instance_size);
+    object_initialize_with_type_zeroed(uc, data, size, type);
+}
+
 void object_initialize(struct uc_struct *uc, void *data, size_t size, const char *typename)
 {
     TypeImpl *type = type_get_by_name(uc, typename);
@@ -355,27 +457,40 @@ static inline bool object_property_is_child(ObjectProperty *prop)
 
 static void object_property_del_all(struct uc_struct *uc, Object *obj)
 {
-    while (!QTAILQ_EMPTY(&obj->properties)) {
-        ObjectProperty *prop = QTAILQ_FIRST(&obj->properties);
-
-        QTAILQ_REMOVE(&obj->properties, prop, node);
-
-        if (prop->release) {
-            prop->release(uc, obj, prop->name, prop->opaque);
+    ObjectProperty *prop;
+    GHashTableIter iter;
+    gpointer key, value;
+    bool released;
+
+    /* a release callback may itself add or delete properties, which
+     * invalidates the iterator; restart the scan whenever one ran */
+    do {
+        released = false;
+        g_hash_table_iter_init(&iter, obj->properties);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            prop = value;
+            if (prop->release) {
+                prop->release(uc, obj, prop->name, prop->opaque);
+                prop->release = NULL;
+                released = true;
+                break;
+            }
+            g_hash_table_iter_remove(&iter);
         }
+    } while (released);
 
-        g_free(prop->name);
-        g_free(prop->type);
-        g_free(prop->description);
-        g_free(prop);
-    }
+    g_hash_table_unref(obj->properties);
 }
 
 static void object_property_del_child(struct uc_struct *uc, Object *obj, Object *child, Error **errp)
 {
     ObjectProperty *prop;
+    GHashTableIter iter;
+    gpointer key, value;
 
-    QTAILQ_FOREACH(prop, &obj->properties, node) {
+    g_hash_table_iter_init(&iter, obj->properties);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        prop = value;
         if (object_property_is_child(prop) && prop->opaque == child) {
             object_property_del(uc, obj, prop->name, errp);
             break;
@@ -422,8 +537,11 @@ static Object *object_new_with_type(struct uc_struct *uc, Type type)
     g_assert(type != NULL);
     type_initialize(uc, type);
 
-    obj = g_malloc(type->instance_size);
-    object_initialize_with_type(uc, obj, type->instance_size, type);
+    /* g_malloc0() gets its zeroes from the allocator (mmap zero pages
+       for anything this big), so the instance costs no resident memory
+       until its fields are actually written */
+    obj = g_malloc0(type->instance_size);
+    object_initialize_with_type_zeroed(uc, obj, type->instance_size, type);
     obj->free = g_free;
 
     return obj;
@@ -661,10 +779,14 @@ void object_class_foreach(struct uc_struct *uc, void (*fn)(ObjectClass *klass, v
 int object_child_foreach(Object *obj, int (*fn)(Object *child, void *opaque),
                          void *opaque)
 {
-    ObjectProperty *prop, *next;
+    ObjectProperty *prop;
+    GHashTableIter iter;
+    gpointer key, value;
     int ret = 0;
 
-    QTAILQ_FOREACH_SAFE(prop, &obj->properties, node, next) {
+    g_hash_table_iter_init(&iter, obj->properties);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        prop = value;
         if (object_property_is_child(prop)) {
             ret = fn(prop->opaque, opaque);
             if (ret != 0) {
@@ -743,13 +865,11 @@ object_property_add(Object *obj, const char *name, const char *type,
         return ret;
     }
 
-    QTAILQ_FOREACH(prop, &obj->properties, node) {
-        if (strcmp(prop->name, name) == 0) {
-            error_setg(errp, "attempt to add duplicate property '%s'"
-                       " to object (type '%s')", name,
-                       object_get_typename(obj));
-            return NULL;
-        }
+    if (g_hash_table_lookup(obj->properties, name) != NULL) {
+        error_setg(errp, "attempt to add duplicate property '%s'"
+                   " to object (type '%s')", name,
+                   object_get_typename(obj));
+        return NULL;
     }
 
     prop = g_malloc0(sizeof(*prop));
@@ -762,23 +882,19 @@ object_property_add(Object *obj, const char *name, const char *type,
     prop->release = release;
     prop->opaque = opaque;
 
-    QTAILQ_INSERT_TAIL(&obj->properties, prop, node);
+    g_hash_table_insert(obj->properties, prop->name, prop);
     return prop;
 }
 
 ObjectProperty *object_property_find(Object *obj, const char *name,
                                      Error **errp)
 {
-    ObjectProperty *prop;
+    ObjectProperty *prop = g_hash_table_lookup(obj->properties, name);
 
-    QTAILQ_FOREACH(prop, &obj->properties, node) {
-        if (strcmp(prop->name, name) == 0) {
-            return prop;
-        }
+    if (prop == NULL) {
+        error_setg(errp, "Property '.%s' not found", name);
     }
-
-    error_setg(errp, "Property '.%s' not found", name);
-    return NULL;
+    return prop;
 }
 
 void object_property_del(struct uc_struct *uc, Object *obj, const char *name, Error **errp)
@@ -792,12 +908,7 @@ void object_property_del(struct uc_struct *uc, Object *obj, const char *name, Er
         prop->release(uc, obj, name, prop->opaque);
     }
 
-    QTAILQ_REMOVE(&obj->properties, prop, node);
-
-    g_free(prop->name);
-    g_free(prop->type);
-    g_free(prop->description);
-    g_free(prop);
+    g_hash_table_remove(obj->properties, name);
 }
 
 void object_property_get(struct uc_struct *uc, Object *obj, Visitor *v, const char *name,
@@ -1262,11 +1373,15 @@ out:
 gchar *object_get_canonical_path_component(Object *obj)
 {
     ObjectProperty *prop = NULL;
+    GHashTableIter iter;
+    gpointer key, value;
 
     g_assert(obj);
     g_assert(obj->parent != NULL);
 
-    QTAILQ_FOREACH(prop, &obj->parent->properties, node) {
+    g_hash_table_iter_init(&iter, obj->parent->properties);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        prop = value;
         if (!object_property_is_child(prop)) {
             continue;
         }
@@ -1351,12 +1466,16 @@ static Object *object_resolve_partial_path(struct uc_struct *uc, Object *parent,
 {
     Object *obj;
     ObjectProperty *prop;
+    GHashTableIter iter;
+    gpointer key, value;
 
     obj = object_resolve_abs_path(uc, parent, parts, typename, 0);
 
-    QTAILQ_FOREACH(prop, &parent->properties, node) {
+    g_hash_table_iter_init(&iter, parent->properties);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
         Object *found;
 
+        prop = value;
         if (!object_property_is_child(prop)) {
             continue;
         }
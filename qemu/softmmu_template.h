@@ -173,7 +173,7 @@ static __attribute__((unused))
 WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
                             uintptr_t retaddr)
 {
-    int index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    int index = (addr >> TARGET_PAGE_BITS) & (env->uc->tlb_entries - 1);
     target_ulong tlb_addr = env->tlb_table[mmu_idx][index].ADDR_READ;
     uintptr_t haddr;
     DATA_TYPE res;
@@ -184,6 +184,10 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
     struct uc_struct *uc = env->uc;
     MemoryRegion *mr = memory_mapping(uc, addr);
 
+    // where the generated code resumes after this access; a nested
+    // uc_emu_start() from a hook below pins that code against eviction
+    uc->hook_ra = retaddr;
+
     // memory might be still unmapped while reading or fetching
     if (mr == NULL) {
         handled = false;
@@ -192,6 +196,7 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_FETCH_UNMAPPED) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_FETCH_UNMAPPED, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -200,6 +205,7 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ_UNMAPPED) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_READ_UNMAPPED, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -218,11 +224,12 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
 
 #if defined(SOFTMMU_CODE_ACCESS)
     // Unicorn: callback on fetch from NX
-    if (mr != NULL && !(mr->perms & UC_PROT_EXEC)) {  // non-executable
+    if (mr != NULL && !(memory_perms(mr, addr) & UC_PROT_EXEC)) {  // non-executable
         handled = false;
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_FETCH_PROT) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_FETCH_PROT, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -241,19 +248,35 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
 
     // Unicorn: callback on memory read
     if (READ_ACCESS_TYPE == MMU_DATA_LOAD) {
-        HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ) {
-            if (!HOOK_BOUND_CHECK(hook, addr))
-                continue;
-            ((uc_cb_hookmem_t)hook->callback)(env->uc, UC_MEM_READ, addr, DATA_SIZE, 0, hook->user_data);
+        if (HOOK_TRACED(uc, UC_HOOK_MEM_READ)) {
+            // binary trace mode records the event instead of running callbacks
+            uc->hook_event_count++;
+            uc_trace_append(uc, UC_HOOK_MEM_READ, addr, DATA_SIZE);
+        } else {
+            HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ) {
+                if (!HOOK_BOUND_CHECK(hook, addr)
+                        || !HOOK_FILTER_SIZE(hook, DATA_SIZE))
+                    continue;
+                uc->hook_event_count++;
+                if (hook->async)
+                    uc_async_publish(uc, hook, UC_HOOK_MEM_READ, addr, DATA_SIZE, 0);
+                else
+                    ((uc_cb_hookmem_t)hook->callback)(env->uc, UC_MEM_READ, addr, DATA_SIZE, 0, hook->user_data);
+            }
         }
+        // Unicorn: data watchpoints (uc_watch_add()); only accesses to
+        // watched pages reach this slow path, see tlb_set_page()
+        if (uc->watch_count != 0)
+            uc_watch_dispatch(uc, UC_HOOK_MEM_READ, UC_MEM_READ, addr, DATA_SIZE, 0);
     }
 
     // Unicorn: callback on non-readable memory
-    if (READ_ACCESS_TYPE == MMU_DATA_LOAD && mr != NULL && !(mr->perms & UC_PROT_READ)) {  //non-readable
+    if (READ_ACCESS_TYPE == MMU_DATA_LOAD && mr != NULL && !(memory_perms(mr, addr) & UC_PROT_READ)) {  //non-readable
         handled = false;
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ_PROT) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_READ_PROT, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -296,8 +319,9 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
         tlb_addr = env->tlb_table[mmu_idx][index].ADDR_READ;
     }
 
-    /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    /* Handle an IO access.  TLB_UCHOOK only forces the slow path and does
+       not make the page IO, so mask it out here.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_UCHOOK))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
@@ -385,7 +409,7 @@ static __attribute__((unused))
 WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
                             uintptr_t retaddr)
 {
-    int index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    int index = (addr >> TARGET_PAGE_BITS) & (env->uc->tlb_entries - 1);
     target_ulong tlb_addr = env->tlb_table[mmu_idx][index].ADDR_READ;
     uintptr_t haddr;
     DATA_TYPE res;
@@ -396,6 +420,10 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
     struct uc_struct *uc = env->uc;
     MemoryRegion *mr = memory_mapping(uc, addr);
 
+    // where the generated code resumes after this access; a nested
+    // uc_emu_start() from a hook below pins that code against eviction
+    uc->hook_ra = retaddr;
+
     // memory can be unmapped while reading or fetching
     if (mr == NULL) {
         handled = false;
@@ -404,6 +432,7 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_FETCH_UNMAPPED) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_FETCH_UNMAPPED, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -412,6 +441,7 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ_UNMAPPED) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_READ_UNMAPPED, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -430,11 +460,12 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
 
 #if defined(SOFTMMU_CODE_ACCESS)
     // Unicorn: callback on fetch from NX
-    if (mr != NULL && !(mr->perms & UC_PROT_EXEC)) {  // non-executable
+    if (mr != NULL && !(memory_perms(mr, addr) & UC_PROT_EXEC)) {  // non-executable
         handled = false;
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_FETCH_PROT) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_FETCH_PROT, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -453,19 +484,35 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
 
     // Unicorn: callback on memory read
     if (READ_ACCESS_TYPE == MMU_DATA_LOAD) {
-        HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ) {
-            if (!HOOK_BOUND_CHECK(hook, addr))
-                continue;
-            ((uc_cb_hookmem_t)hook->callback)(env->uc, UC_MEM_READ, addr, DATA_SIZE, 0, hook->user_data);
+        if (HOOK_TRACED(uc, UC_HOOK_MEM_READ)) {
+            // binary trace mode records the event instead of running callbacks
+            uc->hook_event_count++;
+            uc_trace_append(uc, UC_HOOK_MEM_READ, addr, DATA_SIZE);
+        } else {
+            HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ) {
+                if (!HOOK_BOUND_CHECK(hook, addr)
+                        || !HOOK_FILTER_SIZE(hook, DATA_SIZE))
+                    continue;
+                uc->hook_event_count++;
+                if (hook->async)
+                    uc_async_publish(uc, hook, UC_HOOK_MEM_READ, addr, DATA_SIZE, 0);
+                else
+                    ((uc_cb_hookmem_t)hook->callback)(env->uc, UC_MEM_READ, addr, DATA_SIZE, 0, hook->user_data);
+            }
         }
+        // Unicorn: data watchpoints (uc_watch_add()); only accesses to
+        // watched pages reach this slow path, see tlb_set_page()
+        if (uc->watch_count != 0)
+            uc_watch_dispatch(uc, UC_HOOK_MEM_READ, UC_MEM_READ, addr, DATA_SIZE, 0);
     }
 
     // Unicorn: callback on non-readable memory
-    if (READ_ACCESS_TYPE == MMU_DATA_LOAD && mr != NULL && !(mr->perms & UC_PROT_READ)) {  //non-readable
+    if (READ_ACCESS_TYPE == MMU_DATA_LOAD && mr != NULL && !(memory_perms(mr, addr) & UC_PROT_READ)) {  //non-readable
         handled = false;
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_READ_PROT) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_READ_PROT, addr, DATA_SIZE, 0, hook->user_data)))
                 break;
         }
@@ -508,8 +555,9 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr, int mmu_idx,
         tlb_addr = env->tlb_table[mmu_idx][index].ADDR_READ;
     }
 
-    /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    /* Handle an IO access.  TLB_UCHOOK only forces the slow path and does
+       not make the page IO, so mask it out here.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_UCHOOK))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
@@ -636,7 +684,7 @@ static inline void glue(io_write, SUFFIX)(CPUArchState *env,
 void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
                        int mmu_idx, uintptr_t retaddr)
 {
-    int index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    int index = (addr >> TARGET_PAGE_BITS) & (env->uc->tlb_entries - 1);
     target_ulong tlb_addr = env->tlb_table[mmu_idx][index].addr_write;
     uintptr_t haddr;
     struct hook *hook;
@@ -645,12 +693,32 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     struct uc_struct *uc = env->uc;
     MemoryRegion *mr = memory_mapping(uc, addr);
 
+    // where the generated code resumes after this access; a nested
+    // uc_emu_start() from a hook below pins that code against eviction
+    uc->hook_ra = retaddr;
+
     // Unicorn: callback on memory write
-    HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE) {
-            if (!HOOK_BOUND_CHECK(hook, addr))
+    if (HOOK_TRACED(uc, UC_HOOK_MEM_WRITE)) {
+        // binary trace mode records the event instead of running callbacks
+        uc->hook_event_count++;
+        uc_trace_append(uc, UC_HOOK_MEM_WRITE, addr, DATA_SIZE);
+    } else {
+        HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE) {
+            if (!HOOK_BOUND_CHECK(hook, addr)
+                    || !HOOK_FILTER_SIZE(hook, DATA_SIZE)
+                    || !HOOK_FILTER_VALUE(hook, val))
                 continue;
-        ((uc_cb_hookmem_t)hook->callback)(uc, UC_MEM_WRITE, addr, DATA_SIZE, val, hook->user_data);
+            uc->hook_event_count++;
+            if (hook->async)
+                uc_async_publish(uc, hook, UC_HOOK_MEM_WRITE, addr, DATA_SIZE, val);
+            else
+                ((uc_cb_hookmem_t)hook->callback)(uc, UC_MEM_WRITE, addr, DATA_SIZE, val, hook->user_data);
+        }
     }
+    // Unicorn: data watchpoints (uc_watch_add()); only accesses to
+    // watched pages reach this slow path, see tlb_set_page()
+    if (uc->watch_count != 0)
+        uc_watch_dispatch(uc, UC_HOOK_MEM_WRITE, UC_MEM_WRITE, addr, DATA_SIZE, val);
 
     // Unicorn: callback on invalid memory
     if (mr == NULL) {
@@ -658,6 +726,7 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE_UNMAPPED) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_WRITE_UNMAPPED, addr, DATA_SIZE, val, hook->user_data)))
                 break;
         }
@@ -676,11 +745,12 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     }
 
     // Unicorn: callback on non-writable memory
-    if (mr != NULL && !(mr->perms & UC_PROT_WRITE)) {  //non-writable
+    if (mr != NULL && !(memory_perms(mr, addr) & UC_PROT_WRITE)) {  //non-writable
         handled = false;
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE_PROT) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_WRITE_PROT, addr, DATA_SIZE, val, hook->user_data)))
                 break;
         }
@@ -718,8 +788,9 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
         tlb_addr = env->tlb_table[mmu_idx][index].addr_write;
     }
 
-    /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    /* Handle an IO access.  TLB_UCHOOK only forces the slow path and does
+       not make the page IO, so mask it out here.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_UCHOOK))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
@@ -794,7 +865,7 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
 void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
                        int mmu_idx, uintptr_t retaddr)
 {
-    int index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
+    int index = (addr >> TARGET_PAGE_BITS) & (env->uc->tlb_entries - 1);
     target_ulong tlb_addr = env->tlb_table[mmu_idx][index].addr_write;
     uintptr_t haddr;
     struct hook *hook;
@@ -803,12 +874,32 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     struct uc_struct *uc = env->uc;
     MemoryRegion *mr = memory_mapping(uc, addr);
 
+    // where the generated code resumes after this access; a nested
+    // uc_emu_start() from a hook below pins that code against eviction
+    uc->hook_ra = retaddr;
+
     // Unicorn: callback on memory write
-    HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE) {
-        if (!HOOK_BOUND_CHECK(hook, addr))
-            continue;
-        ((uc_cb_hookmem_t)hook->callback)(uc, UC_MEM_WRITE, addr, DATA_SIZE, val, hook->user_data);
+    if (HOOK_TRACED(uc, UC_HOOK_MEM_WRITE)) {
+        // binary trace mode records the event instead of running callbacks
+        uc->hook_event_count++;
+        uc_trace_append(uc, UC_HOOK_MEM_WRITE, addr, DATA_SIZE);
+    } else {
+        HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE) {
+            if (!HOOK_BOUND_CHECK(hook, addr)
+                    || !HOOK_FILTER_SIZE(hook, DATA_SIZE)
+                    || !HOOK_FILTER_VALUE(hook, val))
+                continue;
+            uc->hook_event_count++;
+            if (hook->async)
+                uc_async_publish(uc, hook, UC_HOOK_MEM_WRITE, addr, DATA_SIZE, val);
+            else
+                ((uc_cb_hookmem_t)hook->callback)(uc, UC_MEM_WRITE, addr, DATA_SIZE, val, hook->user_data);
+        }
     }
+    // Unicorn: data watchpoints (uc_watch_add()); only accesses to
+    // watched pages reach this slow path, see tlb_set_page()
+    if (uc->watch_count != 0)
+        uc_watch_dispatch(uc, UC_HOOK_MEM_WRITE, UC_MEM_WRITE, addr, DATA_SIZE, val);
 
     // Unicorn: callback on invalid memory
     if (mr == NULL) {
@@ -816,6 +907,7 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE_UNMAPPED) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_WRITE_UNMAPPED, addr, DATA_SIZE, val, hook->user_data)))
                 break;
         }
@@ -834,11 +926,12 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     }
 
     // Unicorn: callback on non-writable memory
-    if (mr != NULL && !(mr->perms & UC_PROT_WRITE)) {  //non-writable
+    if (mr != NULL && !(memory_perms(mr, addr) & UC_PROT_WRITE)) {  //non-writable
         handled = false;
         HOOK_FOREACH(uc, hook, UC_HOOK_MEM_WRITE_PROT) {
             if (!HOOK_BOUND_CHECK(hook, addr))
                 continue;
+            uc->hook_event_count++;
             if ((handled = ((uc_cb_eventmem_t)hook->callback)(uc, UC_MEM_WRITE_PROT, addr, DATA_SIZE, val, hook->user_data)))
                 break;
         }
@@ -876,8 +969,9 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
         tlb_addr = env->tlb_table[mmu_idx][index].addr_write;
     }
 
-    /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+    /* Handle an IO access.  TLB_UCHOOK only forces the slow path and does
+       not make the page IO, so mask it out here.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_UCHOOK))) {
         hwaddr ioaddr;
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
@@ -10,13 +10,38 @@
 #define tb_invalidate_phys_page_fast tb_invalidate_phys_page_fast_sparc
 #define phys_mem_clean phys_mem_clean_sparc
 #define tb_cleanup tb_cleanup_sparc
+#define page_tree_reclaim page_tree_reclaim_sparc
+#define tb_profile_flush tb_profile_flush_sparc
 #define memory_map memory_map_sparc
+#define memory_snapshot_ram memory_snapshot_ram_sparc
+#define memory_restore_ram memory_restore_ram_sparc
+#define memory_snapshot_free_ram memory_snapshot_free_ram_sparc
+#define memory_ckpt_delta memory_ckpt_delta_sparc
+#define memory_ckpt_apply memory_ckpt_apply_sparc
+#define memory_ckpt_delta_free memory_ckpt_delta_free_sparc
+#define qemu_ram_make_shareable qemu_ram_make_shareable_sparc
+#define qemu_ram_set_owned qemu_ram_set_owned_sparc
 #define memory_map_ptr memory_map_ptr_sparc
+#define memory_map_io memory_map_io_sparc
 #define memory_unmap memory_unmap_sparc
+#define memory_decommit memory_decommit_sparc
+#define memory_dirty_query memory_dirty_query_sparc
+#define memory_dirty_reset memory_dirty_reset_sparc
 #define memory_free memory_free_sparc
 #define helper_raise_exception helper_raise_exception_sparc
 #define tcg_enabled tcg_enabled_sparc
 #define tcg_exec_init tcg_exec_init_sparc
+#define tcg_buffer_resize tcg_buffer_resize_sparc
+#define tb_cache_save tb_cache_save_sparc
+#define tb_cache_load tb_cache_load_sparc
+#define tb_prewarm tb_prewarm_sparc
+#define tb_meta_get tb_meta_get_sparc
+#define tb_readahead tb_readahead_sparc
+#define tb_stats tb_stats_sparc
+#define mem_stats mem_stats_sparc
+#define tb_crosspage_link tb_crosspage_link_sparc
+#define tb_crosspage_unchain tb_crosspage_unchain_sparc
+#define tb_superblock tb_superblock_sparc
 #define memory_register_types memory_register_types_sparc
 #define cpu_exec_init_all cpu_exec_init_all_sparc
 #define vm_start vm_start_sparc
@@ -37,9 +62,6 @@
 #define aarch64_banked_spsr_index aarch64_banked_spsr_index_sparc
 #define aarch64_restore_sp aarch64_restore_sp_sparc
 #define aarch64_save_sp aarch64_save_sp_sparc
-#define accel_find accel_find_sparc
-#define accel_init_machine accel_init_machine_sparc
-#define accel_type accel_type_sparc
 #define access_with_adjusted_size access_with_adjusted_size_sparc
 #define add128 add128_sparc
 #define add16_sat add16_sat_sparc
@@ -81,16 +103,9 @@
 #define addrrange_make addrrange_make_sparc
 #define addrrange_shift addrrange_shift_sparc
 #define adjust_endianness adjust_endianness_sparc
-#define AES_cbc_encrypt AES_cbc_encrypt_sparc
-#define AES_decrypt AES_decrypt_sparc
-#define AES_encrypt AES_encrypt_sparc
 #define AES_imc AES_imc_sparc
-#define AES_set_decrypt_key AES_set_decrypt_key_sparc
-#define AES_set_encrypt_key AES_set_encrypt_key_sparc
 #define all_helpers all_helpers_sparc
 #define alloc_code_gen_buffer alloc_code_gen_buffer_sparc
-#define alloc_entry alloc_entry_sparc
-#define always_true always_true_sparc
 #define arm1026_initfn arm1026_initfn_sparc
 #define arm1136_initfn arm1136_initfn_sparc
 #define arm1136_r2_initfn arm1136_r2_initfn_sparc
@@ -148,6 +163,7 @@
 #define tlb_fill tlb_fill_sparc
 #define tlb_flush tlb_flush_sparc
 #define tlb_flush_page tlb_flush_page_sparc
+#define tlb_flush_range tlb_flush_range_sparc
 #define tlb_set_page tlb_set_page_sparc
 #define arm_translate_init arm_translate_init_sparc
 #define arm_v7m_class_init arm_v7m_class_init_sparc
@@ -156,21 +172,15 @@
 #define ats_write ats_write_sparc
 #define bad_mode_switch bad_mode_switch_sparc
 #define bank_number bank_number_sparc
-#define bitmap_find_next_zero_area bitmap_find_next_zero_area_sparc
 #define bitmap_zero_extend bitmap_zero_extend_sparc
 #define bp_wp_matches bp_wp_matches_sparc
 #define breakpoint_invalidate breakpoint_invalidate_sparc
 #define build_page_bitmap build_page_bitmap_sparc
-#define bus_add_child bus_add_child_sparc
-#define bus_class_init bus_class_init_sparc
-#define bus_info bus_info_sparc
-#define bus_unparent bus_unparent_sparc
 #define cache_block_ops_cp_reginfo cache_block_ops_cp_reginfo_sparc
 #define cache_dirty_status_cp_reginfo cache_dirty_status_cp_reginfo_sparc
 #define cache_test_clean_cp_reginfo cache_test_clean_cp_reginfo_sparc
 #define call_recip_estimate call_recip_estimate_sparc
 #define can_merge can_merge_sparc
-#define capacity_increase capacity_increase_sparc
 #define ccsidr_read ccsidr_read_sparc
 #define check_ap check_ap_sparc
 #define check_breakpoints check_breakpoints_sparc
@@ -186,12 +196,7 @@
 #define commonNaNToFloat32 commonNaNToFloat32_sparc
 #define commonNaNToFloat64 commonNaNToFloat64_sparc
 #define commonNaNToFloatx80 commonNaNToFloatx80_sparc
-#define compute_abs_deadline compute_abs_deadline_sparc
 #define cond_name cond_name_sparc
-#define configure_accelerator configure_accelerator_sparc
-#define container_get container_get_sparc
-#define container_info container_info_sparc
-#define container_register_types container_register_types_sparc
 #define contextidr_write contextidr_write_sparc
 #define core_log_global_start core_log_global_start_sparc
 #define core_log_global_stop core_log_global_stop_sparc
@@ -228,23 +233,9 @@
 #define cpu_breakpoint_remove_by_ref cpu_breakpoint_remove_by_ref_sparc
 #define cpu_can_do_io cpu_can_do_io_sparc
 #define cpu_can_run cpu_can_run_sparc
-#define cpu_class_init cpu_class_init_sparc
-#define cpu_common_class_by_name cpu_common_class_by_name_sparc
-#define cpu_common_exec_interrupt cpu_common_exec_interrupt_sparc
-#define cpu_common_get_arch_id cpu_common_get_arch_id_sparc
-#define cpu_common_get_memory_mapping cpu_common_get_memory_mapping_sparc
-#define cpu_common_get_paging_enabled cpu_common_get_paging_enabled_sparc
-#define cpu_common_has_work cpu_common_has_work_sparc
-#define cpu_common_initfn cpu_common_initfn_sparc
-#define cpu_common_noop cpu_common_noop_sparc
-#define cpu_common_parse_features cpu_common_parse_features_sparc
-#define cpu_common_realizefn cpu_common_realizefn_sparc
-#define cpu_common_reset cpu_common_reset_sparc
-#define cpu_dump_statistics cpu_dump_statistics_sparc
 #define cpu_exec_init cpu_exec_init_sparc
 #define cpu_flush_icache_range cpu_flush_icache_range_sparc
 #define cpu_gen_init cpu_gen_init_sparc
-#define cpu_get_clock cpu_get_clock_sparc
 #define cpu_get_real_ticks cpu_get_real_ticks_sparc
 #define cpu_get_tb_cpu_state cpu_get_tb_cpu_state_sparc
 #define cpu_handle_debug_exception cpu_handle_debug_exception_sparc
@@ -281,7 +272,6 @@
 #define cpu_physical_memory_write_rom cpu_physical_memory_write_rom_sparc
 #define cpu_physical_memory_write_rom_internal cpu_physical_memory_write_rom_internal_sparc
 #define cpu_register cpu_register_sparc
-#define cpu_register_types cpu_register_types_sparc
 #define cpu_restore_state cpu_restore_state_sparc
 #define cpu_restore_state_from_tb cpu_restore_state_from_tb_sparc
 #define cpu_single_step cpu_single_step_sparc
@@ -290,14 +280,12 @@
 #define cpu_to_be64 cpu_to_be64_sparc
 #define cpu_to_le32 cpu_to_le32_sparc
 #define cpu_to_le64 cpu_to_le64_sparc
-#define cpu_type_info cpu_type_info_sparc
 #define cpu_unassigned_access cpu_unassigned_access_sparc
 #define cpu_watchpoint_address_matches cpu_watchpoint_address_matches_sparc
 #define cpu_watchpoint_insert cpu_watchpoint_insert_sparc
 #define cpu_watchpoint_remove cpu_watchpoint_remove_sparc
 #define cpu_watchpoint_remove_all cpu_watchpoint_remove_all_sparc
 #define cpu_watchpoint_remove_by_ref cpu_watchpoint_remove_by_ref_sparc
-#define crc32c_table crc32c_table_sparc
 #define create_new_memory_mapping create_new_memory_mapping_sparc
 #define csselr_write csselr_write_sparc
 #define cto32 cto32_sparc
@@ -320,15 +308,6 @@
 #define deposit32 deposit32_sparc
 #define deposit64 deposit64_sparc
 #define deregister_tm_clones deregister_tm_clones_sparc
-#define device_class_base_init device_class_base_init_sparc
-#define device_class_init device_class_init_sparc
-#define device_finalize device_finalize_sparc
-#define device_get_realized device_get_realized_sparc
-#define device_initfn device_initfn_sparc
-#define device_post_init device_post_init_sparc
-#define device_reset device_reset_sparc
-#define device_set_realized device_set_realized_sparc
-#define device_type_info device_type_info_sparc
 #define disas_arm_insn disas_arm_insn_sparc
 #define disas_coproc_insn disas_coproc_insn_sparc
 #define disas_dsp_insn disas_dsp_insn_sparc
@@ -356,19 +335,12 @@
 #define do_usat do_usat_sparc
 #define do_v7m_exception_exit do_v7m_exception_exit_sparc
 #define dummy_c15_cp_reginfo dummy_c15_cp_reginfo_sparc
-#define dummy_func dummy_func_sparc
 #define dummy_section dummy_section_sparc
 #define _DYNAMIC _DYNAMIC_sparc
 #define _edata _edata_sparc
 #define _end _end_sparc
-#define end_list end_list_sparc
 #define eq128 eq128_sparc
 #define ErrorClass_lookup ErrorClass_lookup_sparc
-#define error_copy error_copy_sparc
-#define error_exit error_exit_sparc
-#define error_get_class error_get_class_sparc
-#define error_get_pretty error_get_pretty_sparc
-#define error_setg_file_open error_setg_file_open_sparc
 #define estimateDiv128To64 estimateDiv128To64_sparc
 #define estimateSqrt32 estimateSqrt32_sparc
 #define excnames excnames_sparc
@@ -393,13 +365,10 @@
 #define extractFloatx80Exp extractFloatx80Exp_sparc
 #define extractFloatx80Frac extractFloatx80Frac_sparc
 #define extractFloatx80Sign extractFloatx80Sign_sparc
-#define fcntl_setfl fcntl_setfl_sparc
 #define fcse_write fcse_write_sparc
 #define find_better_copy find_better_copy_sparc
-#define find_default_machine find_default_machine_sparc
 #define find_desc_by_name find_desc_by_name_sparc
 #define find_first_bit find_first_bit_sparc
-#define find_last_bit find_last_bit_sparc
 #define find_paging_enabled_cpu find_paging_enabled_cpu_sparc
 #define find_ram_block find_ram_block_sparc
 #define find_ram_offset find_ram_offset_sparc
@@ -603,13 +572,9 @@
 #define floatx80_unordered floatx80_unordered_sparc
 #define floatx80_unordered_quiet floatx80_unordered_quiet_sparc
 #define flush_icache_range flush_icache_range_sparc
-#define format_string format_string_sparc
 #define fp_decode_rm fp_decode_rm_sparc
 #define frame_dummy frame_dummy_sparc
-#define free_range free_range_sparc
 #define fstat64 fstat64_sparc
-#define futex_wait futex_wait_sparc
-#define futex_wake futex_wake_sparc
 #define gen_aa32_ld16s gen_aa32_ld16s_sparc
 #define gen_aa32_ld16u gen_aa32_ld16u_sparc
 #define gen_aa32_ld32u gen_aa32_ld32u_sparc
@@ -1314,8 +1279,6 @@
 #define get_level1_table_address get_level1_table_address_sparc
 #define get_mem_index get_mem_index_sparc
 #define get_next_param_value get_next_param_value_sparc
-#define get_opt_name get_opt_name_sparc
-#define get_opt_value get_opt_value_sparc
 #define get_page_addr_code get_page_addr_code_sparc
 #define get_param_value get_param_value_sparc
 #define get_phys_addr get_phys_addr_sparc
@@ -1348,7 +1311,6 @@
 #define handle_vminmaxnm handle_vminmaxnm_sparc
 #define handle_vrint handle_vrint_sparc
 #define handle_vsel handle_vsel_sparc
-#define has_help_option has_help_option_sparc
 #define have_bmi1 have_bmi1_sparc
 #define have_bmi2 have_bmi2_sparc
 #define hcr_write hcr_write_sparc
@@ -1904,7 +1866,6 @@
 #define _init _init_sparc
 #define init_cpreg_list init_cpreg_list_sparc
 #define init_lists init_lists_sparc
-#define input_type_enum input_type_enum_sparc
 #define int128_2_64 int128_2_64_sparc
 #define int128_add int128_add_sparc
 #define int128_addto int128_addto_sparc
@@ -1949,7 +1910,6 @@
 #define io_writeq io_writeq_sparc
 #define io_writew io_writew_sparc
 #define is_a64 is_a64_sparc
-#define is_help_option is_help_option_sparc
 #define is_power_of_2 is_power_of_2_sparc
 #define isr_read isr_read_sparc
 #define is_valid_option_list is_valid_option_list_sparc
@@ -1959,19 +1919,6 @@
 #define iwmmxt_store_reg iwmmxt_store_reg_sparc
 #define __jit_debug_descriptor __jit_debug_descriptor_sparc
 #define __jit_debug_register_code __jit_debug_register_code_sparc
-#define json_lexer json_lexer_sparc
-#define json_lexer_destroy json_lexer_destroy_sparc
-#define json_lexer_feed json_lexer_feed_sparc
-#define json_lexer_feed_char json_lexer_feed_char_sparc
-#define json_lexer_flush json_lexer_flush_sparc
-#define json_lexer_init json_lexer_init_sparc
-#define json_message_parser_destroy json_message_parser_destroy_sparc
-#define json_message_parser_feed json_message_parser_feed_sparc
-#define json_message_parser_flush json_message_parser_flush_sparc
-#define json_message_parser_init json_message_parser_init_sparc
-#define json_message_process_token json_message_process_token_sparc
-#define json_parser_parse json_parser_parse_sparc
-#define json_parser_parse_err json_parser_parse_err_sparc
 #define kvm_to_cpreg_id kvm_to_cpreg_id_sparc
 #define last_ram_offset last_ram_offset_sparc
 #define ldl_be_p ldl_be_p_sparc
@@ -2007,11 +1954,6 @@
 #define log_cpu_state log_cpu_state_sparc
 #define lpae_cp_reginfo lpae_cp_reginfo_sparc
 #define lt128 lt128_sparc
-#define machine_class_init machine_class_init_sparc
-#define machine_finalize machine_finalize_sparc
-#define machine_info machine_info_sparc
-#define machine_initfn machine_initfn_sparc
-#define machine_register_types machine_register_types_sparc
 #define machvirt_init machvirt_init_sparc
 #define machvirt_machine_init machvirt_machine_init_sparc
 #define maj maj_sparc
@@ -2111,10 +2053,7 @@
 #define memory_region_write_accessor memory_region_write_accessor_sparc
 #define memory_region_wrong_endianness memory_region_wrong_endianness_sparc
 #define memory_try_enable_merging memory_try_enable_merging_sparc
-#define mktimegm mktimegm_sparc
-#define module_call_init module_call_init_sparc
 #define module_load module_load_sparc
-#define mod_utf8_codepoint mod_utf8_codepoint_sparc
 #define mpidr_cp_reginfo mpidr_cp_reginfo_sparc
 #define mpidr_read mpidr_read_sparc
 #define msr_mask msr_mask_sparc
@@ -2135,7 +2074,6 @@
 #define neon_store_reg64 neon_store_reg64_sparc
 #define neon_store_scratch neon_store_scratch_sparc
 #define new_ldst_label new_ldst_label_sparc
-#define next_list next_list_sparc
 #define normalizeFloat128Subnormal normalizeFloat128Subnormal_sparc
 #define normalizeFloat16Subnormal normalizeFloat16Subnormal_sparc
 #define normalizeFloat32Subnormal normalizeFloat32Subnormal_sparc
@@ -2148,61 +2086,6 @@
 #define not_v6_cp_reginfo not_v6_cp_reginfo_sparc
 #define not_v7_cp_reginfo not_v7_cp_reginfo_sparc
 #define not_v8_cp_reginfo not_v8_cp_reginfo_sparc
-#define object_child_foreach object_child_foreach_sparc
-#define object_class_foreach object_class_foreach_sparc
-#define object_class_foreach_tramp object_class_foreach_tramp_sparc
-#define object_class_get_list object_class_get_list_sparc
-#define object_class_get_list_tramp object_class_get_list_tramp_sparc
-#define object_class_get_parent object_class_get_parent_sparc
-#define object_deinit object_deinit_sparc
-#define object_dynamic_cast object_dynamic_cast_sparc
-#define object_finalize object_finalize_sparc
-#define object_finalize_child_property object_finalize_child_property_sparc
-#define object_get_child_property object_get_child_property_sparc
-#define object_get_link_property object_get_link_property_sparc
-#define object_get_root object_get_root_sparc
-#define object_initialize_with_type object_initialize_with_type_sparc
-#define object_init_with_type object_init_with_type_sparc
-#define object_instance_init object_instance_init_sparc
-#define object_new_with_type object_new_with_type_sparc
-#define object_post_init_with_type object_post_init_with_type_sparc
-#define object_property_add_alias object_property_add_alias_sparc
-#define object_property_add_link object_property_add_link_sparc
-#define object_property_add_uint16_ptr object_property_add_uint16_ptr_sparc
-#define object_property_add_uint32_ptr object_property_add_uint32_ptr_sparc
-#define object_property_add_uint64_ptr object_property_add_uint64_ptr_sparc
-#define object_property_add_uint8_ptr object_property_add_uint8_ptr_sparc
-#define object_property_allow_set_link object_property_allow_set_link_sparc
-#define object_property_del object_property_del_sparc
-#define object_property_del_all object_property_del_all_sparc
-#define object_property_del_child object_property_del_child_sparc
-#define object_property_find object_property_find_sparc
-#define object_property_get object_property_get_sparc
-#define object_property_get_bool object_property_get_bool_sparc
-#define object_property_get_enum object_property_get_enum_sparc
-#define object_property_get_int object_property_get_int_sparc
-#define object_property_get_link object_property_get_link_sparc
-#define object_property_get_qobject object_property_get_qobject_sparc
-#define object_property_get_str object_property_get_str_sparc
-#define object_property_get_type object_property_get_type_sparc
-#define object_property_get_uint16List object_property_get_uint16List_sparc
-#define object_property_is_child object_property_is_child_sparc
-#define object_property_print object_property_print_sparc
-#define object_property_set object_property_set_sparc
-#define object_property_set_description object_property_set_description_sparc
-#define object_property_set_link object_property_set_link_sparc
-#define object_property_set_qobject object_property_set_qobject_sparc
-#define object_release_link_property object_release_link_property_sparc
-#define object_resolve_abs_path object_resolve_abs_path_sparc
-#define object_resolve_child_property object_resolve_child_property_sparc
-#define object_resolve_link object_resolve_link_sparc
-#define object_resolve_link_property object_resolve_link_property_sparc
-#define object_resolve_partial_path object_resolve_partial_path_sparc
-#define object_resolve_path object_resolve_path_sparc
-#define object_resolve_path_component object_resolve_path_component_sparc
-#define object_resolve_path_type object_resolve_path_type_sparc
-#define object_set_link_property object_set_link_property_sparc
-#define object_unparent object_unparent_sparc
 #define omap_cachemaint_write omap_cachemaint_write_sparc
 #define omap_cp_reginfo omap_cp_reginfo_sparc
 #define omap_threadid_write omap_threadid_write_sparc
@@ -2216,7 +2099,6 @@
 #define opts_do_parse opts_do_parse_sparc
 #define opt_set opt_set_sparc
 #define opts_parse opts_parse_sparc
-#define output_type_enum output_type_enum_sparc
 #define packFloat128 packFloat128_sparc
 #define packFloat16 packFloat16_sparc
 #define packFloat32 packFloat32_sparc
@@ -2236,10 +2118,6 @@
 #define parse_keyword parse_keyword_sparc
 #define parse_literal parse_literal_sparc
 #define parse_object parse_object_sparc
-#define parse_optional parse_optional_sparc
-#define parse_option_bool parse_option_bool_sparc
-#define parse_option_number parse_option_number_sparc
-#define parse_option_size parse_option_size_sparc
 #define parse_pair parse_pair_sparc
 #define parser_context_free parser_context_free_sparc
 #define parser_context_new parser_context_new_sparc
@@ -2247,14 +2125,6 @@
 #define parser_context_pop_token parser_context_pop_token_sparc
 #define parser_context_restore parser_context_restore_sparc
 #define parser_context_save parser_context_save_sparc
-#define parse_str parse_str_sparc
-#define parse_type_bool parse_type_bool_sparc
-#define parse_type_int parse_type_int_sparc
-#define parse_type_number parse_type_number_sparc
-#define parse_type_size parse_type_size_sparc
-#define parse_type_str parse_type_str_sparc
-#define parse_uint parse_uint_sparc
-#define parse_uint_full parse_uint_full_sparc
 #define parse_value parse_value_sparc
 #define par_write par_write_sparc
 #define patch_reloc patch_reloc_sparc
@@ -2292,32 +2162,12 @@
 #define pmsav5_insn_ap_write pmsav5_insn_ap_write_sparc
 #define pmuserenr_write pmuserenr_write_sparc
 #define pmxevtyper_write pmxevtyper_write_sparc
-#define pow2floor pow2floor_sparc
-#define print_type_bool print_type_bool_sparc
-#define print_type_int print_type_int_sparc
-#define print_type_number print_type_number_sparc
-#define print_type_size print_type_size_sparc
-#define print_type_str print_type_str_sparc
 #define propagateFloat128NaN propagateFloat128NaN_sparc
 #define propagateFloat32MulAddNaN propagateFloat32MulAddNaN_sparc
 #define propagateFloat32NaN propagateFloat32NaN_sparc
 #define propagateFloat64MulAddNaN propagateFloat64MulAddNaN_sparc
 #define propagateFloat64NaN propagateFloat64NaN_sparc
 #define propagateFloatx80NaN propagateFloatx80NaN_sparc
-#define property_get_alias property_get_alias_sparc
-#define property_get_bool property_get_bool_sparc
-#define property_get_str property_get_str_sparc
-#define property_get_uint16_ptr property_get_uint16_ptr_sparc
-#define property_get_uint32_ptr property_get_uint32_ptr_sparc
-#define property_get_uint64_ptr property_get_uint64_ptr_sparc
-#define property_get_uint8_ptr property_get_uint8_ptr_sparc
-#define property_release_alias property_release_alias_sparc
-#define property_release_bool property_release_bool_sparc
-#define property_release_str property_release_str_sparc
-#define property_resolve_alias property_resolve_alias_sparc
-#define property_set_alias property_set_alias_sparc
-#define property_set_bool property_set_bool_sparc
-#define property_set_str property_set_str_sparc
 #define pstate_read pstate_read_sparc
 #define pstate_write pstate_write_sparc
 #define pxa250_initfn pxa250_initfn_sparc
@@ -2331,25 +2181,6 @@
 #define pxa270b1_initfn pxa270b1_initfn_sparc
 #define pxa270c0_initfn pxa270c0_initfn_sparc
 #define pxa270c5_initfn pxa270c5_initfn_sparc
-#define qapi_dealloc_end_implicit_struct qapi_dealloc_end_implicit_struct_sparc
-#define qapi_dealloc_end_list qapi_dealloc_end_list_sparc
-#define qapi_dealloc_end_struct qapi_dealloc_end_struct_sparc
-#define qapi_dealloc_get_visitor qapi_dealloc_get_visitor_sparc
-#define qapi_dealloc_next_list qapi_dealloc_next_list_sparc
-#define qapi_dealloc_pop qapi_dealloc_pop_sparc
-#define qapi_dealloc_push qapi_dealloc_push_sparc
-#define qapi_dealloc_start_implicit_struct qapi_dealloc_start_implicit_struct_sparc
-#define qapi_dealloc_start_list qapi_dealloc_start_list_sparc
-#define qapi_dealloc_start_struct qapi_dealloc_start_struct_sparc
-#define qapi_dealloc_start_union qapi_dealloc_start_union_sparc
-#define qapi_dealloc_type_bool qapi_dealloc_type_bool_sparc
-#define qapi_dealloc_type_enum qapi_dealloc_type_enum_sparc
-#define qapi_dealloc_type_int qapi_dealloc_type_int_sparc
-#define qapi_dealloc_type_number qapi_dealloc_type_number_sparc
-#define qapi_dealloc_type_size qapi_dealloc_type_size_sparc
-#define qapi_dealloc_type_str qapi_dealloc_type_str_sparc
-#define qapi_dealloc_visitor_cleanup qapi_dealloc_visitor_cleanup_sparc
-#define qapi_dealloc_visitor_new qapi_dealloc_visitor_new_sparc
 #define qapi_free_boolList qapi_free_boolList_sparc
 #define qapi_free_ErrorClassList qapi_free_ErrorClassList_sparc
 #define qapi_free_int16List qapi_free_int16List_sparc
@@ -2366,76 +2197,18 @@
 #define qapi_free_X86CPUFeatureWordInfo qapi_free_X86CPUFeatureWordInfo_sparc
 #define qapi_free_X86CPUFeatureWordInfoList qapi_free_X86CPUFeatureWordInfoList_sparc
 #define qapi_free_X86CPURegister32List qapi_free_X86CPURegister32List_sparc
-#define qbool_destroy_obj qbool_destroy_obj_sparc
-#define qbool_from_int qbool_from_int_sparc
-#define qbool_get_int qbool_get_int_sparc
-#define qbool_type qbool_type_sparc
-#define qbus_create qbus_create_sparc
-#define qbus_create_inplace qbus_create_inplace_sparc
-#define qbus_finalize qbus_finalize_sparc
-#define qbus_initfn qbus_initfn_sparc
-#define qbus_realize qbus_realize_sparc
-#define qdev_create qdev_create_sparc
-#define qdev_get_type qdev_get_type_sparc
-#define qdev_register_types qdev_register_types_sparc
-#define qdev_set_parent_bus qdev_set_parent_bus_sparc
-#define qdev_try_create qdev_try_create_sparc
-#define qdict_add_key qdict_add_key_sparc
-#define qdict_array_split qdict_array_split_sparc
-#define qdict_clone_shallow qdict_clone_shallow_sparc
-#define qdict_del qdict_del_sparc
-#define qdict_destroy_obj qdict_destroy_obj_sparc
-#define qdict_entry_key qdict_entry_key_sparc
-#define qdict_entry_value qdict_entry_value_sparc
-#define qdict_extract_subqdict qdict_extract_subqdict_sparc
-#define qdict_find qdict_find_sparc
-#define qdict_first qdict_first_sparc
-#define qdict_flatten qdict_flatten_sparc
-#define qdict_flatten_qdict qdict_flatten_qdict_sparc
-#define qdict_flatten_qlist qdict_flatten_qlist_sparc
-#define qdict_get qdict_get_sparc
-#define qdict_get_bool qdict_get_bool_sparc
-#define qdict_get_double qdict_get_double_sparc
-#define qdict_get_int qdict_get_int_sparc
-#define qdict_get_obj qdict_get_obj_sparc
-#define qdict_get_qdict qdict_get_qdict_sparc
-#define qdict_get_qlist qdict_get_qlist_sparc
-#define qdict_get_str qdict_get_str_sparc
-#define qdict_get_try_bool qdict_get_try_bool_sparc
-#define qdict_get_try_int qdict_get_try_int_sparc
-#define qdict_get_try_str qdict_get_try_str_sparc
-#define qdict_haskey qdict_haskey_sparc
-#define qdict_has_prefixed_entries qdict_has_prefixed_entries_sparc
-#define qdict_iter qdict_iter_sparc
-#define qdict_join qdict_join_sparc
-#define qdict_new qdict_new_sparc
-#define qdict_next qdict_next_sparc
-#define qdict_next_entry qdict_next_entry_sparc
-#define qdict_put_obj qdict_put_obj_sparc
-#define qdict_size qdict_size_sparc
-#define qdict_type qdict_type_sparc
 #define qemu_clock_get_us qemu_clock_get_us_sparc
-#define qemu_clock_ptr qemu_clock_ptr_sparc
 #define qemu_clocks qemu_clocks_sparc
-#define qemu_cond_destroy qemu_cond_destroy_sparc
 #define qemu_cpu_is_self qemu_cpu_is_self_sparc
-#define qemu_cpu_kick_thread qemu_cpu_kick_thread_sparc
-#define qemu_daemon qemu_daemon_sparc
-#define qemu_event_destroy qemu_event_destroy_sparc
-#define qemu_event_init qemu_event_init_sparc
-#define qemu_event_reset qemu_event_reset_sparc
-#define qemu_event_set qemu_event_set_sparc
-#define qemu_event_wait qemu_event_wait_sparc
-#define qemu_fdatasync qemu_fdatasync_sparc
 #define qemu_flush_coalesced_mmio_buffer qemu_flush_coalesced_mmio_buffer_sparc
 #define qemu_get_cpu qemu_get_cpu_sparc
 #define qemu_get_guest_memory_mapping qemu_get_guest_memory_mapping_sparc
 #define qemu_get_guest_simple_memory_mapping qemu_get_guest_simple_memory_mapping_sparc
-#define qemu_get_local_state_pathname qemu_get_local_state_pathname_sparc
 #define qemu_get_ram_block qemu_get_ram_block_sparc
 #define qemu_get_ram_block_host_ptr qemu_get_ram_block_host_ptr_sparc
 #define qemu_get_ram_fd qemu_get_ram_fd_sparc
 #define qemu_get_ram_ptr qemu_get_ram_ptr_sparc
+#define qemu_ram_block_base qemu_ram_block_base_sparc
 #define qemu_host_page_mask qemu_host_page_mask_sparc
 #define qemu_host_page_size qemu_host_page_size_sparc
 #define qemu_init_vcpu qemu_init_vcpu_sparc
@@ -2445,55 +2218,8 @@
 #define qemu_log_flush qemu_log_flush_sparc
 #define qemu_loglevel_mask qemu_loglevel_mask_sparc
 #define qemu_log_vprintf qemu_log_vprintf_sparc
-#define qemu_mutex_destroy qemu_mutex_destroy_sparc
 #define qemu_mutex_lock_ramlist qemu_mutex_lock_ramlist_sparc
-#define qemu_mutex_trylock qemu_mutex_trylock_sparc
 #define qemu_mutex_unlock_ramlist qemu_mutex_unlock_ramlist_sparc
-#define qemu_oom_check qemu_oom_check_sparc
-#define qemu_opt_del qemu_opt_del_sparc
-#define qemu_opt_del_all qemu_opt_del_all_sparc
-#define qemu_opt_find qemu_opt_find_sparc
-#define qemu_opt_foreach qemu_opt_foreach_sparc
-#define qemu_opt_get qemu_opt_get_sparc
-#define qemu_opt_get_bool qemu_opt_get_bool_sparc
-#define qemu_opt_get_bool_del qemu_opt_get_bool_del_sparc
-#define qemu_opt_get_bool_helper qemu_opt_get_bool_helper_sparc
-#define qemu_opt_get_del qemu_opt_get_del_sparc
-#define qemu_opt_get_number qemu_opt_get_number_sparc
-#define qemu_opt_get_number_del qemu_opt_get_number_del_sparc
-#define qemu_opt_get_number_helper qemu_opt_get_number_helper_sparc
-#define qemu_opt_get_size qemu_opt_get_size_sparc
-#define qemu_opt_get_size_del qemu_opt_get_size_del_sparc
-#define qemu_opt_get_size_helper qemu_opt_get_size_helper_sparc
-#define qemu_opt_has_help_opt qemu_opt_has_help_opt_sparc
-#define qemu_opt_parse qemu_opt_parse_sparc
-#define qemu_opts_absorb_qdict qemu_opts_absorb_qdict_sparc
-#define qemu_opts_append qemu_opts_append_sparc
-#define qemu_opts_create qemu_opts_create_sparc
-#define qemu_opts_del qemu_opts_del_sparc
-#define qemu_opts_do_parse qemu_opts_do_parse_sparc
-#define qemu_opt_set qemu_opt_set_sparc
-#define qemu_opt_set_bool qemu_opt_set_bool_sparc
-#define qemu_opt_set_err qemu_opt_set_err_sparc
-#define qemu_opt_set_number qemu_opt_set_number_sparc
-#define qemu_opts_find qemu_opts_find_sparc
-#define qemu_opts_foreach qemu_opts_foreach_sparc
-#define qemu_opts_free qemu_opts_free_sparc
-#define qemu_opts_from_qdict qemu_opts_from_qdict_sparc
-#define qemu_opts_from_qdict_1 qemu_opts_from_qdict_1_sparc
-#define qemu_opts_id qemu_opts_id_sparc
-#define qemu_opts_parse qemu_opts_parse_sparc
-#define qemu_opts_print qemu_opts_print_sparc
-#define qemu_opts_print_help qemu_opts_print_help_sparc
-#define qemu_opts_reset qemu_opts_reset_sparc
-#define qemu_opts_set qemu_opts_set_sparc
-#define qemu_opts_set_defaults qemu_opts_set_defaults_sparc
-#define qemu_opts_set_id qemu_opts_set_id_sparc
-#define qemu_opts_to_qdict qemu_opts_to_qdict_sparc
-#define qemu_opts_validate qemu_opts_validate_sparc
-#define qemu_opt_unset qemu_opt_unset_sparc
-#define qemu_parse_fd qemu_parse_fd_sparc
-#define qemu_pipe qemu_pipe_sparc
 #define qemu_ram_addr_from_host qemu_ram_addr_from_host_sparc
 #define qemu_ram_addr_from_host_nofail qemu_ram_addr_from_host_nofail_sparc
 #define qemu_ram_alloc qemu_ram_alloc_sparc
@@ -2506,110 +2232,16 @@
 #define qemu_ram_setup_dump qemu_ram_setup_dump_sparc
 #define qemu_ram_unset_idstr qemu_ram_unset_idstr_sparc
 #define qemu_real_host_page_size qemu_real_host_page_size_sparc
-#define qemu_sem_destroy qemu_sem_destroy_sparc
-#define qemu_sem_init qemu_sem_init_sparc
-#define qemu_sem_post qemu_sem_post_sparc
-#define qemu_sem_timedwait qemu_sem_timedwait_sparc
-#define qemu_sem_wait qemu_sem_wait_sparc
-#define qemu_set_cloexec qemu_set_cloexec_sparc
-#define qemu_set_tty_echo qemu_set_tty_echo_sparc
 #define qemu_st_helpers qemu_st_helpers_sparc
-#define qemu_strnlen qemu_strnlen_sparc
-#define qemu_strsep qemu_strsep_sparc
 #define qemu_tcg_cpu_thread_fn qemu_tcg_cpu_thread_fn_sparc
 #define qemu_tcg_init_vcpu qemu_tcg_init_vcpu_sparc
-#define qemu_thread_exit qemu_thread_exit_sparc
-#define qemu_try_memalign qemu_try_memalign_sparc
-#define qentry_destroy qentry_destroy_sparc
-#define qerror_human qerror_human_sparc
-#define qerror_report qerror_report_sparc
-#define qerror_report_err qerror_report_err_sparc
-#define qfloat_destroy_obj qfloat_destroy_obj_sparc
-#define qfloat_from_double qfloat_from_double_sparc
-#define qfloat_get_double qfloat_get_double_sparc
-#define qfloat_type qfloat_type_sparc
-#define qint_destroy_obj qint_destroy_obj_sparc
-#define qint_from_int qint_from_int_sparc
-#define qint_get_int qint_get_int_sparc
-#define qint_type qint_type_sparc
-#define qlist_append_obj qlist_append_obj_sparc
-#define qlist_copy qlist_copy_sparc
-#define qlist_copy_elem qlist_copy_elem_sparc
-#define qlist_destroy_obj qlist_destroy_obj_sparc
-#define qlist_empty qlist_empty_sparc
 #define qlist_entry_obj qlist_entry_obj_sparc
 #define qlist_first qlist_first_sparc
-#define qlist_iter qlist_iter_sparc
-#define qlist_new qlist_new_sparc
 #define qlist_next qlist_next_sparc
-#define qlist_peek qlist_peek_sparc
-#define qlist_pop qlist_pop_sparc
-#define qlist_size qlist_size_sparc
-#define qlist_size_iter qlist_size_iter_sparc
-#define qlist_type qlist_type_sparc
-#define qmp_input_end_implicit_struct qmp_input_end_implicit_struct_sparc
-#define qmp_input_end_list qmp_input_end_list_sparc
-#define qmp_input_end_struct qmp_input_end_struct_sparc
-#define qmp_input_get_next_type qmp_input_get_next_type_sparc
-#define qmp_input_get_object qmp_input_get_object_sparc
-#define qmp_input_get_visitor qmp_input_get_visitor_sparc
-#define qmp_input_next_list qmp_input_next_list_sparc
-#define qmp_input_optional qmp_input_optional_sparc
-#define qmp_input_pop qmp_input_pop_sparc
-#define qmp_input_push qmp_input_push_sparc
-#define qmp_input_start_implicit_struct qmp_input_start_implicit_struct_sparc
-#define qmp_input_start_list qmp_input_start_list_sparc
-#define qmp_input_start_struct qmp_input_start_struct_sparc
-#define qmp_input_type_bool qmp_input_type_bool_sparc
-#define qmp_input_type_int qmp_input_type_int_sparc
-#define qmp_input_type_number qmp_input_type_number_sparc
-#define qmp_input_type_str qmp_input_type_str_sparc
-#define qmp_input_visitor_cleanup qmp_input_visitor_cleanup_sparc
-#define qmp_input_visitor_new qmp_input_visitor_new_sparc
-#define qmp_input_visitor_new_strict qmp_input_visitor_new_strict_sparc
-#define qmp_output_add_obj qmp_output_add_obj_sparc
-#define qmp_output_end_list qmp_output_end_list_sparc
-#define qmp_output_end_struct qmp_output_end_struct_sparc
-#define qmp_output_first qmp_output_first_sparc
-#define qmp_output_get_qobject qmp_output_get_qobject_sparc
-#define qmp_output_get_visitor qmp_output_get_visitor_sparc
-#define qmp_output_last qmp_output_last_sparc
-#define qmp_output_next_list qmp_output_next_list_sparc
-#define qmp_output_pop qmp_output_pop_sparc
-#define qmp_output_push_obj qmp_output_push_obj_sparc
-#define qmp_output_start_list qmp_output_start_list_sparc
-#define qmp_output_start_struct qmp_output_start_struct_sparc
-#define qmp_output_type_bool qmp_output_type_bool_sparc
-#define qmp_output_type_int qmp_output_type_int_sparc
-#define qmp_output_type_number qmp_output_type_number_sparc
-#define qmp_output_type_str qmp_output_type_str_sparc
-#define qmp_output_visitor_cleanup qmp_output_visitor_cleanup_sparc
-#define qmp_output_visitor_new qmp_output_visitor_new_sparc
 #define qobject_decref qobject_decref_sparc
-#define qobject_from_json qobject_from_json_sparc
-#define qobject_from_jsonf qobject_from_jsonf_sparc
-#define qobject_from_jsonv qobject_from_jsonv_sparc
 #define qobject_incref qobject_incref_sparc
-#define qobject_to_json qobject_to_json_sparc
-#define qobject_to_json_pretty qobject_to_json_pretty_sparc
-#define qobject_to_qbool qobject_to_qbool_sparc
-#define qobject_to_qdict qobject_to_qdict_sparc
-#define qobject_to_qfloat qobject_to_qfloat_sparc
-#define qobject_to_qint qobject_to_qint_sparc
-#define qobject_to_qlist qobject_to_qlist_sparc
-#define qobject_to_qstring qobject_to_qstring_sparc
 #define qobject_type qobject_type_sparc
-#define qstring_append qstring_append_sparc
-#define qstring_append_chr qstring_append_chr_sparc
-#define qstring_append_int qstring_append_int_sparc
-#define qstring_destroy_obj qstring_destroy_obj_sparc
 #define qstring_from_escaped_str qstring_from_escaped_str_sparc
-#define qstring_from_str qstring_from_str_sparc
-#define qstring_from_substr qstring_from_substr_sparc
-#define qstring_get_length qstring_get_length_sparc
-#define qstring_get_str qstring_get_str_sparc
-#define qstring_new qstring_new_sparc
-#define qstring_type qstring_type_sparc
 #define ram_block_add ram_block_add_sparc
 #define ram_size ram_size_sparc
 #define range_compare range_compare_sparc
@@ -2619,7 +2251,6 @@
 #define ranges_can_merge ranges_can_merge_sparc
 #define raw_read raw_read_sparc
 #define raw_write raw_write_sparc
-#define rcon rcon_sparc
 #define read_raw_cp_reg read_raw_cp_reg_sparc
 #define recip_estimate recip_estimate_sparc
 #define recip_sqrt_estimate recip_sqrt_estimate_sparc
@@ -2627,7 +2258,6 @@
 #define register_multipage register_multipage_sparc
 #define register_subpage register_subpage_sparc
 #define register_tm_clones register_tm_clones_sparc
-#define register_types_object register_types_object_sparc
 #define regnames regnames_sparc
 #define render_memory_region render_memory_region_sparc
 #define reset_all_temps reset_all_temps_sparc
@@ -2678,15 +2308,6 @@
 #define shortShift192Left shortShift192Left_sparc
 #define simple_mpu_ap_bits simple_mpu_ap_bits_sparc
 #define size_code_gen_buffer size_code_gen_buffer_sparc
-#define slow_bitmap_and slow_bitmap_and_sparc
-#define slow_bitmap_andnot slow_bitmap_andnot_sparc
-#define slow_bitmap_complement slow_bitmap_complement_sparc
-#define slow_bitmap_empty slow_bitmap_empty_sparc
-#define slow_bitmap_equal slow_bitmap_equal_sparc
-#define slow_bitmap_full slow_bitmap_full_sparc
-#define slow_bitmap_intersects slow_bitmap_intersects_sparc
-#define slow_bitmap_or slow_bitmap_or_sparc
-#define slow_bitmap_xor slow_bitmap_xor_sparc
 #define softmmu_lock_user softmmu_lock_user_sparc
 #define softmmu_lock_user_string softmmu_lock_user_string_sparc
 #define softmmu_tget32 softmmu_tget32_sparc
@@ -2699,7 +2320,6 @@
 #define spin_unlock spin_unlock_sparc
 #define spsel_read spsel_read_sparc
 #define spsel_write spsel_write_sparc
-#define start_list start_list_sparc
 #define stb_p stb_p_sparc
 #define stb_phys stb_phys_sparc
 #define stl_be_p stl_be_p_sparc
@@ -2720,22 +2340,7 @@
 #define stq_le_p stq_le_p_sparc
 #define stq_le_phys stq_le_phys_sparc
 #define stq_phys stq_phys_sparc
-#define string_input_get_visitor string_input_get_visitor_sparc
-#define string_input_visitor_cleanup string_input_visitor_cleanup_sparc
-#define string_input_visitor_new string_input_visitor_new_sparc
-#define string_output_append string_output_append_sparc
-#define string_output_append_range string_output_append_range_sparc
-#define string_output_get_string string_output_get_string_sparc
-#define string_output_get_visitor string_output_get_visitor_sparc
-#define string_output_set string_output_set_sparc
-#define string_output_visitor_cleanup string_output_visitor_cleanup_sparc
-#define string_output_visitor_new string_output_visitor_new_sparc
-#define stristart stristart_sparc
 #define strongarm_cp_reginfo strongarm_cp_reginfo_sparc
-#define strpadcpy strpadcpy_sparc
-#define strstart strstart_sparc
-#define strtosz strtosz_sparc
-#define strtosz_suffix strtosz_suffix_sparc
 #define stw_be_p stw_be_p_sparc
 #define stw_be_phys stw_be_phys_sparc
 #define stw_he_p stw_he_p_sparc
@@ -2759,7 +2364,6 @@
 #define subpage_read subpage_read_sparc
 #define subpage_register subpage_register_sparc
 #define subpage_write subpage_write_sparc
-#define suffix_mul suffix_mul_sparc
 #define swap_commutative swap_commutative_sparc
 #define swap_commutative2 swap_commutative2_sparc
 #define switch_mode switch_mode_sparc
@@ -2801,6 +2405,7 @@
 #define tb_hash_remove tb_hash_remove_sparc
 #define tb_invalidate_phys_addr tb_invalidate_phys_addr_sparc
 #define tb_invalidate_phys_page_range tb_invalidate_phys_page_range_sparc
+#define tb_invalidate_pc_range tb_invalidate_pc_range_sparc
 #define tb_invalidate_phys_range tb_invalidate_phys_range_sparc
 #define tb_jmp_cache_hash_func tb_jmp_cache_hash_func_sparc
 #define tb_jmp_cache_hash_page tb_jmp_cache_hash_page_sparc
@@ -2811,8 +2416,6 @@
 #define tb_phys_invalidate tb_phys_invalidate_sparc
 #define tb_reset_jump tb_reset_jump_sparc
 #define tb_set_jmp_target tb_set_jmp_target_sparc
-#define tcg_accel_class_init tcg_accel_class_init_sparc
-#define tcg_accel_type tcg_accel_type_sparc
 #define tcg_add_param_i32 tcg_add_param_i32_sparc
 #define tcg_add_param_i64 tcg_add_param_i64_sparc
 #define tcg_add_target_add_op_defs tcg_add_target_add_op_defs_sparc
@@ -2944,7 +2547,6 @@
 #define tcg_global_reg_new_i64 tcg_global_reg_new_i64_sparc
 #define tcg_global_reg_new_internal tcg_global_reg_new_internal_sparc
 #define tcg_handle_interrupt tcg_handle_interrupt_sparc
-#define tcg_init tcg_init_sparc
 #define tcg_invert_cond tcg_invert_cond_sparc
 #define tcg_la_bb_end tcg_la_bb_end_sparc
 #define tcg_la_br_end tcg_la_br_end_sparc
@@ -3040,7 +2642,6 @@
 #define tcg_temp_new_internal tcg_temp_new_internal_sparc
 #define tcg_temp_new_internal_i32 tcg_temp_new_internal_i32_sparc
 #define tcg_temp_new_internal_i64 tcg_temp_new_internal_i64_sparc
-#define tdb_hash tdb_hash_sparc
 #define teecr_write teecr_write_sparc
 #define teehbr_access teehbr_access_sparc
 #define temp_allocate_frame temp_allocate_frame_sparc
@@ -3076,34 +2677,16 @@
 #define tlb_set_dirty1 tlb_set_dirty1_sparc
 #define tlb_unprotect_code_phys tlb_unprotect_code_phys_sparc
 #define tlb_vaddr_to_host tlb_vaddr_to_host_sparc
-#define to_json to_json_sparc
-#define to_json_dict_iter to_json_dict_iter_sparc
-#define to_json_list_iter to_json_list_iter_sparc
 #define token_get_type token_get_type_sparc
 #define token_get_value token_get_value_sparc
 #define token_is_escape token_is_escape_sparc
 #define token_is_keyword token_is_keyword_sparc
 #define token_is_operator token_is_operator_sparc
 #define tokens_append_from_iter tokens_append_from_iter_sparc
-#define to_qiv to_qiv_sparc
-#define to_qov to_qov_sparc
 #define tosa_init tosa_init_sparc
 #define tosa_machine_init tosa_machine_init_sparc
 #define tswap32 tswap32_sparc
 #define tswap64 tswap64_sparc
-#define type_class_get_size type_class_get_size_sparc
-#define type_get_by_name type_get_by_name_sparc
-#define type_get_parent type_get_parent_sparc
-#define type_has_parent type_has_parent_sparc
-#define type_initialize type_initialize_sparc
-#define type_initialize_interface type_initialize_interface_sparc
-#define type_is_ancestor type_is_ancestor_sparc
-#define type_new type_new_sparc
-#define type_object_get_size type_object_get_size_sparc
-#define type_register_internal type_register_internal_sparc
-#define type_table_add type_table_add_sparc
-#define type_table_get type_table_get_sparc
-#define type_table_lookup type_table_lookup_sparc
 #define uint16_to_float32 uint16_to_float32_sparc
 #define uint16_to_float64 uint16_to_float64_sparc
 #define uint32_to_float32 uint32_to_float32_sparc
@@ -3111,8 +2694,6 @@
 #define uint64_to_float128 uint64_to_float128_sparc
 #define uint64_to_float32 uint64_to_float32_sparc
 #define uint64_to_float64 uint64_to_float64_sparc
-#define uleb128_decode_small uleb128_decode_small_sparc
-#define uleb128_encode_small uleb128_encode_small_sparc
 #define unassigned_io_ops unassigned_io_ops_sparc
 #define unassigned_io_read unassigned_io_read_sparc
 #define unassigned_io_write unassigned_io_write_sparc
@@ -3142,17 +2723,6 @@
 #define vfp_set_fpcr vfp_set_fpcr_sparc
 #define vfp_set_fpscr vfp_set_fpscr_sparc
 #define vfp_set_fpsr vfp_set_fpsr_sparc
-#define visit_end_implicit_struct visit_end_implicit_struct_sparc
-#define visit_end_list visit_end_list_sparc
-#define visit_end_struct visit_end_struct_sparc
-#define visit_end_union visit_end_union_sparc
-#define visit_get_next_type visit_get_next_type_sparc
-#define visit_next_list visit_next_list_sparc
-#define visit_optional visit_optional_sparc
-#define visit_start_implicit_struct visit_start_implicit_struct_sparc
-#define visit_start_list visit_start_list_sparc
-#define visit_start_struct visit_start_struct_sparc
-#define visit_start_union visit_start_union_sparc
 #define vmsa_cp_reginfo vmsa_cp_reginfo_sparc
 #define vmsa_tcr_el1_write vmsa_tcr_el1_write_sparc
 #define vmsa_ttbcr_raw_write vmsa_ttbcr_raw_write_sparc
@@ -3219,6 +2789,8 @@
 #define helper_taddcctv helper_taddcctv_sparc
 #define helper_tsubcctv helper_tsubcctv_sparc
 #define sparc_cpu_do_interrupt sparc_cpu_do_interrupt_sparc
+#define sparc_cpu_exec_interrupt sparc_cpu_exec_interrupt_sparc
+#define sparc_cpu_synchronize_from_tb sparc_cpu_synchronize_from_tb_sparc
 #define helper_check_align helper_check_align_sparc
 #define helper_ld_asi helper_ld_asi_sparc
 #define helper_st_asi helper_st_asi_sparc
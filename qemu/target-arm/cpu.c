@@ -271,7 +271,9 @@ static void arm_cpu_initfn(struct uc_struct *uc, Object *obj, void *opaque)
     ARMCPU *cpu = ARM_CPU(uc, obj);
 
     cs->env_ptr = &cpu->env;
-    cpu_exec_init(&cpu->env, opaque);
+    /* the type graph may be shared between instances (see type_table_attach):
+       use the opening engine, not the userdata of whoever registered the type */
+    cpu_exec_init(&cpu->env, uc);
     cpu->cp_regs = g_hash_table_new_full(g_int_hash, g_int_equal,
                                          g_free, g_free);
 
@@ -1092,7 +1094,6 @@ void arm_cpu_register_types(void *opaque)
     const TypeInfo arm_cpu_type_info = {
         .name = TYPE_ARM_CPU,
         .parent = TYPE_CPU,
-        .instance_userdata = opaque,
         .instance_size = sizeof(ARMCPU),
         .instance_init = arm_cpu_initfn,
         .instance_post_init = arm_cpu_post_init,
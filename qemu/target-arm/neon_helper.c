@@ -18,6 +18,32 @@
 
 #define SET_QC() env->vfp.xregs[ARM_VFP_FPSCR] |= CPSR_Q
 
+/* Most helpers below unpack their operands into per-lane structures and
+   loop.  On an x86-64 host the byte and halfword saturating, narrowing and
+   widening forms map onto single SSE2 instructions, and NEON-heavy guest
+   code (memcpy, strlen, codec kernels) calls them hard enough for that to
+   matter.  SSE2 is part of the x86-64 baseline, so unlike the AES path in
+   target-i386/ops_sse.h no runtime CPU check is needed; the scalar bodies
+   stay as the portable fallback.  The QC flag is derived by comparing the
+   saturated result against a modular one. */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAVE_NEON_HOST_SIMD 1
+#include <emmintrin.h>
+
+#define NEON_HOST_QOP(name, satop, modop) \
+uint32_t HELPER(glue(neon_,name))(CPUARMState *env, uint32_t arg1, \
+                                  uint32_t arg2) \
+{ \
+    __m128i a = _mm_cvtsi32_si128(arg1); \
+    __m128i b = _mm_cvtsi32_si128(arg2); \
+    __m128i sat = satop(a, b); \
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(sat, modop(a, b))) != 0xffff) { \
+        SET_QC(); \
+    } \
+    return _mm_cvtsi128_si32(sat); \
+}
+#endif
+
 #define NEON_TYPE1(name, type) \
 typedef struct \
 { \
@@ -156,6 +182,10 @@ uint32_t HELPER(glue(neon_,name))(uint32_t arg) \
 }
 
 
+#ifdef HAVE_NEON_HOST_SIMD
+NEON_HOST_QOP(qadd_u8, _mm_adds_epu8, _mm_add_epi8)
+NEON_HOST_QOP(qadd_u16, _mm_adds_epu16, _mm_add_epi16)
+#else
 #define NEON_USAT(dest, src1, src2, type) do { \
     uint32_t tmp = (uint32_t)src1 + (uint32_t)src2; \
     if (tmp != (type)tmp) { \
@@ -171,6 +201,7 @@ NEON_VOP_ENV(qadd_u8, neon_u8, 4)
 NEON_VOP_ENV(qadd_u16, neon_u16, 2)
 #undef NEON_FN
 #undef NEON_USAT
+#endif
 
 uint32_t HELPER(neon_qadd_u32)(CPUARMState *env, uint32_t a, uint32_t b)
 {
@@ -194,6 +225,10 @@ uint64_t HELPER(neon_qadd_u64)(CPUARMState *env, uint64_t src1, uint64_t src2)
     return res;
 }
 
+#ifdef HAVE_NEON_HOST_SIMD
+NEON_HOST_QOP(qadd_s8, _mm_adds_epi8, _mm_add_epi8)
+NEON_HOST_QOP(qadd_s16, _mm_adds_epi16, _mm_add_epi16)
+#else
 #define NEON_SSAT(dest, src1, src2, type) do { \
     int32_t tmp = (uint32_t)src1 + (uint32_t)src2; \
     if (tmp != (type)tmp) { \
@@ -213,6 +248,7 @@ NEON_VOP_ENV(qadd_s8, neon_s8, 4)
 NEON_VOP_ENV(qadd_s16, neon_s16, 2)
 #undef NEON_FN
 #undef NEON_SSAT
+#endif
 
 uint32_t HELPER(neon_qadd_s32)(CPUARMState *env, uint32_t a, uint32_t b)
 {
@@ -401,6 +437,10 @@ uint64_t HELPER(neon_sqadd_u64)(CPUARMState *env, uint64_t a, uint64_t b)
 }
 
 
+#ifdef HAVE_NEON_HOST_SIMD
+NEON_HOST_QOP(qsub_u8, _mm_subs_epu8, _mm_sub_epi8)
+NEON_HOST_QOP(qsub_u16, _mm_subs_epu16, _mm_sub_epi16)
+#else
 #define NEON_USAT(dest, src1, src2, type) do { \
     uint32_t tmp = (uint32_t)src1 - (uint32_t)src2; \
     if (tmp != (type)tmp) { \
@@ -416,6 +456,7 @@ NEON_VOP_ENV(qsub_u8, neon_u8, 4)
 NEON_VOP_ENV(qsub_u16, neon_u16, 2)
 #undef NEON_FN
 #undef NEON_USAT
+#endif
 
 uint32_t HELPER(neon_qsub_u32)(CPUARMState *env, uint32_t a, uint32_t b)
 {
@@ -440,6 +481,10 @@ uint64_t HELPER(neon_qsub_u64)(CPUARMState *env, uint64_t src1, uint64_t src2)
     return res;
 }
 
+#ifdef HAVE_NEON_HOST_SIMD
+NEON_HOST_QOP(qsub_s8, _mm_subs_epi8, _mm_sub_epi8)
+NEON_HOST_QOP(qsub_s16, _mm_subs_epi16, _mm_sub_epi16)
+#else
 #define NEON_SSAT(dest, src1, src2, type) do { \
     int32_t tmp = (uint32_t)src1 - (uint32_t)src2; \
     if (tmp != (type)tmp) { \
@@ -459,6 +504,7 @@ NEON_VOP_ENV(qsub_s8, neon_s8, 4)
 NEON_VOP_ENV(qsub_s16, neon_s16, 2)
 #undef NEON_FN
 #undef NEON_SSAT
+#endif
 
 uint32_t HELPER(neon_qsub_s32)(CPUARMState *env, uint32_t a, uint32_t b)
 {
@@ -1401,6 +1447,17 @@ uint32_t HELPER(neon_narrow_round_high_u16)(uint64_t x)
 
 uint32_t HELPER(neon_unarrow_sat8)(CPUARMState *env, uint64_t x)
 {
+#ifdef HAVE_NEON_HOST_SIMD
+    /* signed halfwords to unsigned bytes is exactly PACKUSWB */
+    __m128i v = _mm_cvtsi64_si128(x);
+    __m128i out = _mm_cmpgt_epi16(v, _mm_set1_epi16(0xff));
+    out = _mm_or_si128(out, _mm_cmpgt_epi16(_mm_setzero_si128(), v));
+
+    if (_mm_movemask_epi8(out)) {
+        SET_QC();
+    }
+    return _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+#else
     uint16_t s;
     uint8_t d;
     uint32_t res = 0;
@@ -1424,10 +1481,24 @@ uint32_t HELPER(neon_unarrow_sat8)(CPUARMState *env, uint64_t x)
     SAT8(48);
 #undef SAT8
     return res;
+#endif
 }
 
 uint32_t HELPER(neon_narrow_sat_u8)(CPUARMState *env, uint64_t x)
 {
+#ifdef HAVE_NEON_HOST_SIMD
+    /* PACKUSWB consumes signed input, so clamp to 255 first; the amount
+       clamped off doubles as the saturation indicator */
+    __m128i v = _mm_cvtsi64_si128(x);
+    __m128i over = _mm_subs_epu16(v, _mm_set1_epi16(0xff));
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(over, _mm_setzero_si128())) !=
+            0xffff) {
+        SET_QC();
+    }
+    v = _mm_sub_epi16(v, over);
+    return _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+#else
     uint16_t s;
     uint8_t d;
     uint32_t res = 0;
@@ -1447,10 +1518,21 @@ uint32_t HELPER(neon_narrow_sat_u8)(CPUARMState *env, uint64_t x)
     SAT8(48);
 #undef SAT8
     return res;
+#endif
 }
 
 uint32_t HELPER(neon_narrow_sat_s8)(CPUARMState *env, uint64_t x)
 {
+#ifdef HAVE_NEON_HOST_SIMD
+    __m128i v = _mm_cvtsi64_si128(x);
+    __m128i out = _mm_cmpgt_epi16(v, _mm_set1_epi16(0x7f));
+    out = _mm_or_si128(out, _mm_cmpgt_epi16(_mm_set1_epi16(-0x80), v));
+
+    if (_mm_movemask_epi8(out)) {
+        SET_QC();
+    }
+    return _mm_cvtsi128_si32(_mm_packs_epi16(v, v));
+#else
     int16_t s;
     uint8_t d;
     uint32_t res = 0;
@@ -1470,6 +1552,7 @@ uint32_t HELPER(neon_narrow_sat_s8)(CPUARMState *env, uint64_t x)
     SAT8(48);
 #undef SAT8
     return res;
+#endif
 }
 
 uint32_t HELPER(neon_unarrow_sat16)(CPUARMState *env, uint64_t x)
@@ -1562,6 +1645,11 @@ uint32_t HELPER(neon_narrow_sat_s32)(CPUARMState *env, uint64_t x)
 
 uint64_t HELPER(neon_widen_u8)(uint32_t x)
 {
+#ifdef HAVE_NEON_HOST_SIMD
+    __m128i v = _mm_cvtsi32_si128(x);
+
+    return _mm_cvtsi128_si64(_mm_unpacklo_epi8(v, _mm_setzero_si128()));
+#else
     uint64_t tmp;
     uint64_t ret;
     ret = (uint8_t)x;
@@ -1572,10 +1660,18 @@ uint64_t HELPER(neon_widen_u8)(uint32_t x)
     tmp = (uint8_t)(x >> 24);
     ret |= tmp << 48;
     return ret;
+#endif
 }
 
 uint64_t HELPER(neon_widen_s8)(uint32_t x)
 {
+#ifdef HAVE_NEON_HOST_SIMD
+    /* duplicate each byte into both halves of its halfword, then shift the
+       copy out arithmetically to sign-extend */
+    __m128i v = _mm_cvtsi32_si128(x);
+
+    return _mm_cvtsi128_si64(_mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8));
+#else
     uint64_t tmp;
     uint64_t ret;
     ret = (uint16_t)(int8_t)x;
@@ -1586,6 +1682,7 @@ uint64_t HELPER(neon_widen_s8)(uint32_t x)
     tmp = (uint16_t)(int8_t)(x >> 24);
     ret |= tmp << 48;
     return ret;
+#endif
 }
 
 uint64_t HELPER(neon_widen_u16)(uint32_t x)
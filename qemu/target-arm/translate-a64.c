@@ -10985,7 +10985,7 @@ static void disas_a64_insn(CPUARMState *env, DisasContext *s)
 
     // Unicorn: trace this instruction on request
     if (HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_CODE, s->pc - 4)) {
-        gen_uc_tracecode(tcg_ctx, 4, UC_HOOK_CODE_IDX, env->uc, s->pc - 4);
+        gen_uc_tracecode(tcg_ctx, 4, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), s->pc - 4);
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
     }
@@ -11099,12 +11099,17 @@ void gen_intermediate_code_internal_a64(ARMCPU *cpu,
         max_insns = CF_COUNT_MASK;
     }
 
+    // Unicorn: engine-wide cap on instructions per block
+    if (env->uc->tb_max_insns && max_insns > env->uc->tb_max_insns) {
+        max_insns = env->uc->tb_max_insns;
+    }
+
     tcg_clear_temp_count();
 
     // Unicorn: early check to see if the address of this block is the until address
     if (tb->pc == env->uc->addr_end) {
         // imitate WFI instruction to halt emulation
-        gen_tb_start(tcg_ctx);
+        gen_tb_start(tcg_ctx, tb);
         dc->is_jmp = DISAS_WFI;
         goto done_generating;
     }
@@ -11115,10 +11120,13 @@ void gen_intermediate_code_internal_a64(ARMCPU *cpu,
     if (!env->uc->block_full && HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_BLOCK, pc_start)) {
         // save block address to see if we need to patch block size later
         env->uc->block_addr = pc_start;
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, env->uc, pc_start);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, offsetof(CPUArchState, uc), pc_start);
     }
 
-    gen_tb_start(tcg_ctx);
+    // Unicorn: update the edge coverage bitmap for this block
+    UC_GEN_COVERAGE(tcg_ctx, env->uc, pc_start);
+
+    gen_tb_start(tcg_ctx, tb);
 
     do {
         if (unlikely(!QTAILQ_EMPTY(&cs->breakpoints))) {
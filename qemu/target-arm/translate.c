@@ -830,20 +830,33 @@ static const uint8_t table_logic_cc[16] = {
     1, /* mvn */
 };
 
+static inline void gen_goto_tb(DisasContext *s, int n, target_ulong dest);
+
 /* Set PC and Thumb state from an immediate address.  */
 static inline void gen_bx_im(DisasContext *s, uint32_t addr)
 {
     TCGv_i32 tmp;
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
 
-    s->is_jmp = DISAS_UPDATE;
     if (s->thumb != (addr & 1)) {
         tmp = tcg_temp_new_i32(tcg_ctx);
         tcg_gen_movi_i32(tcg_ctx, tmp, addr & 1);
         tcg_gen_st_i32(tcg_ctx, tmp, tcg_ctx->cpu_env, offsetof(CPUARMState, thumb));
         tcg_temp_free_i32(tcg_ctx, tmp);
     }
-    tcg_gen_movi_i32(tcg_ctx, tcg_ctx->cpu_R[15], addr & ~1);
+    // Unicorn: destination and Thumb state are both translate-time
+    // constants here and the Thumb bit is part of tb->flags, so an
+    // interworking immediate branch can chain like any direct jump: the
+    // stored thumb bit is live when tb_find_fast() resolves the link, and
+    // the patched jump then always targets a TB of the right mode.  This
+    // used to force a hash table lookup on every BLX execution.
+    if (unlikely(s->singlestep_enabled || s->ss_active)) {
+        s->is_jmp = DISAS_UPDATE;
+        tcg_gen_movi_i32(tcg_ctx, tcg_ctx->cpu_R[15], addr & ~1);
+    } else {
+        gen_goto_tb(s, 0, addr & ~1);
+        s->is_jmp = DISAS_TB_JUMP;
+    }
 }
 
 /* Set PC and Thumb state from var.  var is marked as dead.  */
@@ -7688,7 +7701,7 @@ static void disas_arm_insn(DisasContext *s, unsigned int insn)  // qq
 
     // Unicorn: trace this instruction on request
     if (HOOK_EXISTS_BOUNDED(s->uc, UC_HOOK_CODE, s->pc - 4)) {
-        gen_uc_tracecode(tcg_ctx, 4, UC_HOOK_CODE_IDX, s->uc, s->pc - 4);
+        gen_uc_tracecode(tcg_ctx, 4, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), s->pc - 4);
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
     }
@@ -10407,7 +10420,7 @@ static void disas_thumb_insn(CPUARMState *env, DisasContext *s) // qq
 
     // Unicorn: trace this instruction on request
     if (HOOK_EXISTS_BOUNDED(s->uc, UC_HOOK_CODE, s->pc)) {
-        gen_uc_tracecode(tcg_ctx, 2, UC_HOOK_CODE_IDX, s->uc, s->pc);
+        gen_uc_tracecode(tcg_ctx, 2, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), s->pc);
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
     }
@@ -11217,12 +11230,16 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
     if (max_insns == 0)
         max_insns = CF_COUNT_MASK;
 
+    // Unicorn: engine-wide cap on instructions per block
+    if (env->uc->tb_max_insns && max_insns > env->uc->tb_max_insns)
+        max_insns = env->uc->tb_max_insns;
+
     tcg_clear_temp_count();
 
     // Unicorn: early check to see if the address of this block is the until address
     if (tb->pc == env->uc->addr_end) {
         // imitate WFI instruction to halt emulation
-        gen_tb_start(tcg_ctx);
+        gen_tb_start(tcg_ctx, tb);
         dc->is_jmp = DISAS_WFI;
         goto tb_end;
     }
@@ -11233,10 +11250,13 @@ static inline void gen_intermediate_code_internal(ARMCPU *cpu,
     if (!env->uc->block_full && HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_BLOCK, pc_start)) {
         // save block address to see if we need to patch block size later
         env->uc->block_addr = pc_start;
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, env->uc, pc_start);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, offsetof(CPUArchState, uc), pc_start);
     }
 
-    gen_tb_start(tcg_ctx);
+    // Unicorn: update the edge coverage bitmap for this block
+    UC_GEN_COVERAGE(tcg_ctx, env->uc, pc_start);
+
+    gen_tb_start(tcg_ctx, tb);
 
     /* A note on handling of the condexec (IT) bits:
      *
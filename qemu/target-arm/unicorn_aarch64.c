@@ -80,6 +80,32 @@ int arm64_reg_write(struct uc_struct *uc, unsigned int regid, const void *value)
     return 0;
 }
 
+static void arm64_arch_state(struct uc_struct *uc, uc_arch_state *state)
+{
+    CPUARMState *env = first_cpu->env_ptr;
+
+    state->reg_count = 31;  // x0-x30; sp and pc are separate fields
+    state->reg_bytes = sizeof(env->xregs[0]);
+    state->flags_bytes = sizeof(env->pstate);
+    state->regs = env->xregs;
+    state->pc = &env->pc;
+    state->flags = &env->pstate;
+}
+
+// create one more vCPU of the model machvirt_init() uses
+static int arm64_vcpu_add(struct uc_struct *uc)
+{
+    ObjectClass *oc = cpu_class_by_name(uc, TYPE_ARM_CPU, "cortex-a57");
+    Object *cpuobj;
+
+    if (oc == NULL) {
+        return -1;
+    }
+    cpuobj = object_new(uc, object_class_get_name(oc));
+    object_property_set_bool(uc, cpuobj, true, "realized", NULL);
+    return 0;
+}
+
 __attribute__ ((visibility ("default")))
 void arm64_uc_init(struct uc_struct* uc)
 {
@@ -91,5 +117,7 @@ void arm64_uc_init(struct uc_struct* uc)
     uc->reg_write = arm64_reg_write;
     uc->reg_reset = arm64_reg_reset;
     uc->set_pc = arm64_set_pc;
+    uc->arch_state = arm64_arch_state;
+    uc->vcpu_add = arm64_vcpu_add;
     uc_common_init(uc);
 }
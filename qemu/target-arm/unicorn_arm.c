@@ -76,8 +76,14 @@ int arm_reg_write(struct uc_struct *uc, unsigned int regid, const void *value)
                 break;
             //case UC_ARM_REG_PC:
             case UC_ARM_REG_R15:
-                ARM_CPU(uc, mycpu)->env.pc = *(uint32_t *)value;
-                ARM_CPU(uc, mycpu)->env.regs[15] = *(uint32_t *)value;
+                // interworking write, like BX: a set bit 0 selects Thumb
+                // state.  An even address leaves the current state alone,
+                // since ARM and Thumb code are indistinguishable by address.
+                if (*(uint32_t *)value & 1) {
+                    ARM_CPU(uc, mycpu)->env.thumb = 1;
+                }
+                ARM_CPU(uc, mycpu)->env.pc = *(uint32_t *)value & ~1;
+                ARM_CPU(uc, mycpu)->env.regs[15] = *(uint32_t *)value & ~1;
                 // force to quit execution and flush TB
                 uc->quit_request = true;
                 uc_emu_stop(uc);
@@ -99,6 +105,24 @@ static bool arm_stop_interrupt(int intno)
     }
 }
 
+static void arm_arch_state(struct uc_struct *uc, uc_arch_state *state)
+{
+    CPUARMState *env = first_cpu->env_ptr;
+
+    state->reg_count = 16;
+    state->reg_bytes = sizeof(env->regs[0]);
+    state->flags_bytes = sizeof(env->uncached_cpsr);
+    state->regs = env->regs;
+    state->pc = &env->regs[15];
+    state->flags = &env->uncached_cpsr;
+}
+
+// create one more vCPU of the model tosa_machine_init() uses
+static int arm_vcpu_add(struct uc_struct *uc)
+{
+    return cpu_arm_init(uc, "cortex-a15") == NULL ? -1 : 0;
+}
+
 static uc_err arm_query(struct uc_struct *uc, uc_query_type type, size_t *result)
 {
     CPUState *mycpu = first_cpu;
@@ -128,5 +152,7 @@ void arm_uc_init(struct uc_struct* uc)
     uc->set_pc = arm_set_pc;
     uc->stop_interrupt = arm_stop_interrupt;
     uc->query = arm_query;
+    uc->arch_state = arm_arch_state;
+    uc->vcpu_add = arm_vcpu_add;
     uc_common_init(uc);
 }
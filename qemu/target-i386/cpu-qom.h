@@ -154,5 +154,6 @@ int x86_cpu_gdb_write_register(CPUState *cpu, uint8_t *buf, int reg);
 
 void x86_cpu_exec_enter(CPUState *cpu);
 void x86_cpu_exec_exit(CPUState *cpu);
+void x86_cpu_synchronize_from_tb(CPUState *cpu, struct TranslationBlock *tb);
 
 #endif
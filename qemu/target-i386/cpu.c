@@ -25,7 +25,6 @@
 #include "sysemu/cpus.h"
 #include "topology.h"
 
-#include "qemu/option.h"
 #include "qapi/qmp/qerror.h"
 
 #include "qapi-types.h"
@@ -40,6 +39,8 @@
 #include "hw/i386/apic_internal.h"
 #endif
 
+#include "uc_priv.h"
+
 /* Cache topology CPUID constants: */
 
 /* CPUID Leaf 2 Descriptors */
@@ -2297,7 +2298,12 @@ static int x86_cpu_realizefn(struct uc_struct *uc, DeviceState *dev, Error **err
 #ifndef CONFIG_USER_ONLY
     //qemu_register_reset(x86_cpu_machine_reset_cb, cpu);
 
-    if (cpu->env.features[FEAT_1_EDX] & CPUID_APIC || smp_cpus > 1) {
+    if (uc->mode & UC_MODE_BARE) {
+        /* Unicorn: bare profile runs flat-memory code that never talks to
+           an interrupt controller; skip the APIC device and stop CPUID
+           from advertising one */
+        cpu_clear_apic_feature(env);
+    } else if (cpu->env.features[FEAT_1_EDX] & CPUID_APIC || smp_cpus > 1) {
         x86_cpu_apic_create(cpu, &local_err);
         if (local_err != NULL) {
             goto out;
@@ -2365,7 +2371,9 @@ static void x86_cpu_initfn(struct uc_struct *uc, Object *obj, void *opaque)
     CPUX86State *env = &cpu->env;
 
     cs->env_ptr = env;
-    cpu_exec_init(env, opaque);
+    /* the type graph may be shared between instances (see type_table_attach):
+       use the opening engine, not the userdata of whoever registered the type */
+    cpu_exec_init(env, uc);
 
     object_property_add(obj, "family", "int",
                         x86_cpuid_version_get_family,
@@ -2433,7 +2441,7 @@ static void x86_cpu_set_pc(CPUState *cs, vaddr value)
     cpu->env.eip = value;
 }
 
-static void x86_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
+void x86_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
 {
     X86CPU *cpu = X86_CPU(cs->uc, cs);
 
@@ -2447,7 +2455,7 @@ static bool x86_cpu_has_work(CPUState *cs)
 
 #if !defined(CONFIG_USER_ONLY)
     if (cs->interrupt_request & CPU_INTERRUPT_POLL) {
-        apic_poll_irq(cpu->apic_state);
+        /* the stub APIC never buffers an interrupt behind a poll request */
         cpu_reset_interrupt(cs, CPU_INTERRUPT_POLL);
     }
 #endif
@@ -2503,7 +2511,6 @@ void x86_cpu_register_types(void *opaque)
 	const TypeInfo x86_cpu_type_info = {
 		.name = TYPE_X86_CPU,
 		.parent = TYPE_CPU,
-		.instance_userdata = opaque,
 		.instance_size = sizeof(X86CPU),
 		.instance_init = x86_cpu_initfn,
 		.abstract = true,
@@ -5,6 +5,9 @@ DEF_HELPER_FLAGS_4(cc_compute_c, TCG_CALL_NO_RWG_SE, tl, tl, tl, tl, int)
 
 DEF_HELPER_1(lock, void, env)
 DEF_HELPER_1(unlock, void, env)
+DEF_HELPER_4(rep_movs, void, env, i32, i32, i32)
+DEF_HELPER_3(rep_stos, void, env, i32, i32)
+DEF_HELPER_3(rep_scasb, void, env, i32, i32)
 DEF_HELPER_3(write_eflags, void, env, tl, i32)
 DEF_HELPER_1(read_eflags, tl, env)
 DEF_HELPER_2(divb_AL, void, env, tl)
@@ -55,6 +58,12 @@ DEF_HELPER_2(sysexit, void, env, int)
 DEF_HELPER_2(syscall, void, env, int)
 DEF_HELPER_2(sysret, void, env, int)
 #endif
+/* direct-dispatch variants for a single UC_HOOK_INSN hook resolved at
+   translation time, see HOOK_INSN_SINGLE */
+DEF_HELPER_4(uc_sysenter, void, env, ptr, ptr, int)
+#ifdef TARGET_X86_64
+DEF_HELPER_4(uc_syscall, void, env, ptr, ptr, int)
+#endif
 DEF_HELPER_2(hlt, void, env, int)
 DEF_HELPER_2(monitor, void, env, tl)
 DEF_HELPER_2(mwait, void, env, int)
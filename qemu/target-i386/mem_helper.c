@@ -106,6 +106,203 @@ void helper_boundl(CPUX86State *env, target_ulong a0, int v)
     }
 }
 
+// Unicorn: bulk fast paths for the REP string instructions.
+//
+// The translated loop (see gen_repz_movs() and friends) moves one element
+// per TB execution and pays a softmmu TLB lookup per element.  When nothing
+// can observe the individual iterations - direction flag clear, no memory,
+// code or block hooks, no instruction count budget, no single-stepping -
+// the remaining transfer runs here as a host memcpy/memset, one TLB probe
+// per guest page touched.  Every exit leaves ECX/ESI/EDI describing the
+// exact resume point, so anything this code will not handle (MMIO, a page
+// held non-writable for SMC detection, an overlapping copy, an element
+// straddling a page) simply falls back to the one-element loop.
+
+static bool rep_fast_ok(CPUX86State *env)
+{
+    CPUState *cs = CPU(x86_env_get_cpu(env));
+    struct uc_struct *uc = env->uc;
+
+    return env->df == 1
+        && uc->emu_count == 0
+        && !cs->singlestep_enabled
+        && !(env->eflags & TF_MASK)
+        && !HOOK_EXISTS(uc, UC_HOOK_MEM_READ)
+        && !HOOK_EXISTS(uc, UC_HOOK_MEM_WRITE)
+        && !HOOK_EXISTS(uc, UC_HOOK_CODE)
+        && !HOOK_EXISTS(uc, UC_HOOK_BLOCK);
+}
+
+// aflag is the address size as a TCGMemOp: 1 = 16-bit, 2 = 32-bit, 3 = 64-bit
+static target_ulong rep_addr_mask(uint32_t aflag)
+{
+    return aflag == 3 ? (target_ulong)-1
+         : aflag == 2 ? 0xffffffffu : 0xffff;
+}
+
+static target_ulong rep_linear(CPUX86State *env, int seg, target_ulong ofs,
+                               uint32_t aflag)
+{
+    target_ulong lin = env->segs[seg].base + ofs;
+
+    // outside long mode the generated address path truncates to 32 bits
+    // after the segment base is added; mirror it exactly
+    return aflag == 3 ? lin : lin & 0xffffffff;
+}
+
+void helper_rep_movs(CPUX86State *env, uint32_t ot, uint32_t seg,
+                     uint32_t aflag)
+{
+    target_ulong mask = rep_addr_mask(aflag);
+    target_ulong count, esi, edi;
+    int mmu_idx = cpu_mmu_index(env);
+
+    if (!rep_fast_ok(env)) {
+        return;
+    }
+    count = env->regs[R_ECX] & mask;
+    esi = env->regs[R_ESI];
+    edi = env->regs[R_EDI];
+
+    while (count > 0) {
+        target_ulong src = rep_linear(env, seg, esi & mask, aflag);
+        target_ulong dst = rep_linear(env, R_ES, edi & mask, aflag);
+        target_ulong n = count, bytes;
+        void *sp, *dp;
+
+        n = MIN(n, (TARGET_PAGE_SIZE - (src & ~TARGET_PAGE_MASK)) >> ot);
+        n = MIN(n, (TARGET_PAGE_SIZE - (dst & ~TARGET_PAGE_MASK)) >> ot);
+        if (aflag != 3) {
+            // elements left before the index register wraps its window
+            n = MIN(n, ((mask - (esi & mask)) >> ot) + 1);
+            n = MIN(n, ((mask - (edi & mask)) >> ot) + 1);
+        }
+        bytes = n << ot;
+        // a forward copy into its own source tail replicates element by
+        // element; only the iterative loop reproduces that
+        if (n == 0 || (src < dst && dst < src + bytes)) {
+            break;
+        }
+        sp = tlb_vaddr_to_host(env, src, 0, mmu_idx);
+        dp = tlb_vaddr_to_host(env, dst, 1, mmu_idx);
+        if (sp == NULL || dp == NULL) {
+            break;
+        }
+        memmove(dp, sp, bytes);
+        esi = (esi & ~mask) | ((esi + bytes) & mask);
+        edi = (edi & ~mask) | ((edi + bytes) & mask);
+        count -= n;
+        env->regs[R_ESI] = esi;
+        env->regs[R_EDI] = edi;
+        env->regs[R_ECX] = (env->regs[R_ECX] & ~mask) | count;
+    }
+}
+
+void helper_rep_stos(CPUX86State *env, uint32_t ot, uint32_t aflag)
+{
+    target_ulong mask = rep_addr_mask(aflag);
+    target_ulong count, edi, val;
+    int mmu_idx = cpu_mmu_index(env);
+
+    if (!rep_fast_ok(env)) {
+        return;
+    }
+    count = env->regs[R_ECX] & mask;
+    edi = env->regs[R_EDI];
+    val = env->regs[R_EAX];
+
+    while (count > 0) {
+        target_ulong dst = rep_linear(env, R_ES, edi & mask, aflag);
+        target_ulong n = count, bytes, i;
+        uint8_t *dp;
+
+        n = MIN(n, (TARGET_PAGE_SIZE - (dst & ~TARGET_PAGE_MASK)) >> ot);
+        if (aflag != 3) {
+            n = MIN(n, ((mask - (edi & mask)) >> ot) + 1);
+        }
+        if (n == 0) {
+            break;
+        }
+        dp = tlb_vaddr_to_host(env, dst, 1, mmu_idx);
+        if (dp == NULL) {
+            break;
+        }
+        bytes = n << ot;
+        switch (ot) {
+        case 0:
+            memset(dp, val & 0xff, bytes);
+            break;
+        case 1:
+            for (i = 0; i < n; i++) {
+                stw_le_p(dp + (i << 1), (uint16_t)val);
+            }
+            break;
+        case 2:
+            for (i = 0; i < n; i++) {
+                stl_le_p(dp + (i << 2), (uint32_t)val);
+            }
+            break;
+        default:
+            for (i = 0; i < n; i++) {
+                stq_le_p(dp + (i << 3), val);
+            }
+            break;
+        }
+        edi = (edi & ~mask) | ((edi + bytes) & mask);
+        count -= n;
+        env->regs[R_EDI] = edi;
+        env->regs[R_ECX] = (env->regs[R_ECX] & ~mask) | count;
+    }
+}
+
+void helper_rep_scasb(CPUX86State *env, uint32_t aflag, uint32_t nz)
+{
+    target_ulong mask = rep_addr_mask(aflag);
+    target_ulong count, edi;
+    uint8_t al = env->regs[R_EAX] & 0xff;
+    int mmu_idx = cpu_mmu_index(env);
+
+    if (!rep_fast_ok(env)) {
+        return;
+    }
+    count = env->regs[R_ECX] & mask;
+    edi = env->regs[R_EDI];
+
+    // consume only bytes that provably do not terminate the scan and always
+    // leave the last one, so the iterative loop performs the architectural
+    // compare and sets the flags
+    while (count > 1) {
+        target_ulong dst = rep_linear(env, R_ES, edi & mask, aflag);
+        target_ulong n = count - 1, k;
+        const uint8_t *dp;
+
+        n = MIN(n, TARGET_PAGE_SIZE - (dst & ~TARGET_PAGE_MASK));
+        if (aflag != 3) {
+            n = MIN(n, (mask - (edi & mask)) + 1);
+        }
+        dp = tlb_vaddr_to_host(env, dst, 0, mmu_idx);
+        if (n == 0 || dp == NULL) {
+            break;
+        }
+        if (nz) {
+            const uint8_t *hit = memchr(dp, al, n);
+
+            k = hit != NULL ? (target_ulong)(hit - dp) : n;
+        } else {
+            for (k = 0; k < n && dp[k] == al; k++) {
+                ;
+            }
+        }
+        edi = (edi & ~mask) | ((edi + k) & mask);
+        count -= k;
+        env->regs[R_EDI] = edi;
+        env->regs[R_ECX] = (env->regs[R_ECX] & ~mask) | count;
+        if (k < n) {
+            break;
+        }
+    }
+}
+
 #if !defined(CONFIG_USER_ONLY)
 /* try to fill the TLB and return an exception if error. If retaddr is
  * NULL, it means that the function was called in C code (i.e. not
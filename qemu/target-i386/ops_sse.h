@@ -20,6 +20,13 @@
 
 #include "qemu/aes.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
 #if SHIFT == 0
 #define Reg MMXReg
 #define XMM_ONLY(...)
@@ -371,6 +378,61 @@ static inline int satsw(int x)
 #define FAVG(a, b) (((a) + (b) + 1) >> 1)
 #endif
 
+#if SHIFT == 1 && defined(__SSE2__)
+/* On an SSE2-capable host each of these element loops is a single host
+   vector instruction applied to the whole register; only helpers with
+   an exact host counterpart are specialized, everything else keeps the
+   portable loops.  XMMReg is not guaranteed 16-byte aligned inside
+   CPUX86State, hence the unaligned loads and stores. */
+#define SSE_HELPER_HOST(name, intrin)                           \
+    void glue(name, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)   \
+    {                                                           \
+        _mm_storeu_si128((__m128i *)d->_b,                      \
+            intrin(_mm_loadu_si128((const __m128i *)d->_b),     \
+                   _mm_loadu_si128((const __m128i *)s->_b)));   \
+    }
+
+SSE_HELPER_HOST(helper_paddb, _mm_add_epi8)
+SSE_HELPER_HOST(helper_paddw, _mm_add_epi16)
+SSE_HELPER_HOST(helper_paddl, _mm_add_epi32)
+SSE_HELPER_HOST(helper_paddq, _mm_add_epi64)
+
+SSE_HELPER_HOST(helper_psubb, _mm_sub_epi8)
+SSE_HELPER_HOST(helper_psubw, _mm_sub_epi16)
+SSE_HELPER_HOST(helper_psubl, _mm_sub_epi32)
+SSE_HELPER_HOST(helper_psubq, _mm_sub_epi64)
+
+SSE_HELPER_HOST(helper_paddusb, _mm_adds_epu8)
+SSE_HELPER_HOST(helper_paddsb, _mm_adds_epi8)
+SSE_HELPER_HOST(helper_psubusb, _mm_subs_epu8)
+SSE_HELPER_HOST(helper_psubsb, _mm_subs_epi8)
+
+SSE_HELPER_HOST(helper_paddusw, _mm_adds_epu16)
+SSE_HELPER_HOST(helper_paddsw, _mm_adds_epi16)
+SSE_HELPER_HOST(helper_psubusw, _mm_subs_epu16)
+SSE_HELPER_HOST(helper_psubsw, _mm_subs_epi16)
+
+SSE_HELPER_HOST(helper_pminub, _mm_min_epu8)
+SSE_HELPER_HOST(helper_pmaxub, _mm_max_epu8)
+
+SSE_HELPER_HOST(helper_pminsw, _mm_min_epi16)
+SSE_HELPER_HOST(helper_pmaxsw, _mm_max_epi16)
+
+SSE_HELPER_HOST(helper_pcmpgtb, _mm_cmpgt_epi8)
+SSE_HELPER_HOST(helper_pcmpgtw, _mm_cmpgt_epi16)
+SSE_HELPER_HOST(helper_pcmpgtl, _mm_cmpgt_epi32)
+
+SSE_HELPER_HOST(helper_pcmpeqb, _mm_cmpeq_epi8)
+SSE_HELPER_HOST(helper_pcmpeqw, _mm_cmpeq_epi16)
+SSE_HELPER_HOST(helper_pcmpeql, _mm_cmpeq_epi32)
+
+SSE_HELPER_HOST(helper_pmullw, _mm_mullo_epi16)
+SSE_HELPER_HOST(helper_pmulhuw, _mm_mulhi_epu16)
+SSE_HELPER_HOST(helper_pmulhw, _mm_mulhi_epi16)
+
+SSE_HELPER_HOST(helper_pavgb, _mm_avg_epu8)
+SSE_HELPER_HOST(helper_pavgw, _mm_avg_epu16)
+#else
 SSE_HELPER_B(helper_paddb, FADD)
 SSE_HELPER_W(helper_paddw, FADD)
 SSE_HELPER_L(helper_paddl, FADD)
@@ -397,11 +459,6 @@ SSE_HELPER_B(helper_pmaxub, FMAXUB)
 SSE_HELPER_W(helper_pminsw, FMINSW)
 SSE_HELPER_W(helper_pmaxsw, FMAXSW)
 
-SSE_HELPER_Q(helper_pand, FAND)
-SSE_HELPER_Q(helper_pandn, FANDN)
-SSE_HELPER_Q(helper_por, FOR)
-SSE_HELPER_Q(helper_pxor, FXOR)
-
 SSE_HELPER_B(helper_pcmpgtb, FCMPGTB)
 SSE_HELPER_W(helper_pcmpgtw, FCMPGTW)
 SSE_HELPER_L(helper_pcmpgtl, FCMPGTL)
@@ -411,14 +468,21 @@ SSE_HELPER_W(helper_pcmpeqw, FCMPEQ)
 SSE_HELPER_L(helper_pcmpeql, FCMPEQ)
 
 SSE_HELPER_W(helper_pmullw, FMULLW)
-#if SHIFT == 0
-SSE_HELPER_W(helper_pmulhrw, FMULHRW)
-#endif
 SSE_HELPER_W(helper_pmulhuw, FMULHUW)
 SSE_HELPER_W(helper_pmulhw, FMULHW)
 
 SSE_HELPER_B(helper_pavgb, FAVG)
 SSE_HELPER_W(helper_pavgw, FAVG)
+#endif /* SHIFT == 1 && __SSE2__ */
+
+SSE_HELPER_Q(helper_pand, FAND)
+SSE_HELPER_Q(helper_pandn, FANDN)
+SSE_HELPER_Q(helper_por, FOR)
+SSE_HELPER_Q(helper_pxor, FXOR)
+
+#if SHIFT == 0
+SSE_HELPER_W(helper_pmulhrw, FMULHRW)
+#endif
 
 void glue(helper_pmuludq, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
@@ -1389,6 +1453,16 @@ void helper_pswapd(CPUX86State *env, MMXReg *d, MMXReg *s)
 #endif
 
 /* SSSE3 op helpers */
+#if SHIFT == 1 && defined(__SSSE3__)
+void glue(helper_pshufb, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
+{
+    /* the guest semantics (clear on bit 7, else index mod 16) are
+       exactly those of the host instruction */
+    _mm_storeu_si128((__m128i *)d->_b,
+        _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)d->_b),
+                         _mm_loadu_si128((const __m128i *)s->_b)));
+}
+#else
 void glue(helper_pshufb, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
     int i;
@@ -1400,6 +1474,7 @@ void glue(helper_pshufb, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 
     *d = r;
 }
+#endif
 
 void glue(helper_phaddw, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
@@ -2183,11 +2258,89 @@ target_ulong helper_popcnt(CPUX86State *env, target_ulong n, uint32_t type)
 #endif
 }
 
+#if defined(__x86_64__) && defined(__GNUC__)
+/* AESENC & friends and PCLMULQDQ are single instructions on hosts with
+   AES-NI/PCLMUL, and guest TLS handshakes hammer these helpers.  Use the
+   host instruction when the CPU has it; the table-driven code below stays
+   as the portable fallback.  The target attributes let this compile
+   without -maes/-mpclmul in the global CFLAGS. */
+#define HAVE_HOST_AES 1
+#include <immintrin.h>
+
+static inline __m128i host_read_xmm(const Reg *r)
+{
+    return _mm_loadu_si128((const __m128i *)r);
+}
+
+static inline void host_write_xmm(Reg *r, __m128i v)
+{
+    _mm_storeu_si128((__m128i *)r, v);
+}
+
+static __attribute__((target("aes"))) void host_aesdec(Reg *d, Reg *s)
+{
+    host_write_xmm(d, _mm_aesdec_si128(host_read_xmm(d), host_read_xmm(s)));
+}
+
+static __attribute__((target("aes"))) void host_aesdeclast(Reg *d, Reg *s)
+{
+    host_write_xmm(d, _mm_aesdeclast_si128(host_read_xmm(d),
+                                           host_read_xmm(s)));
+}
+
+static __attribute__((target("aes"))) void host_aesenc(Reg *d, Reg *s)
+{
+    host_write_xmm(d, _mm_aesenc_si128(host_read_xmm(d), host_read_xmm(s)));
+}
+
+static __attribute__((target("aes"))) void host_aesenclast(Reg *d, Reg *s)
+{
+    host_write_xmm(d, _mm_aesenclast_si128(host_read_xmm(d),
+                                           host_read_xmm(s)));
+}
+
+static __attribute__((target("aes"))) void host_aesimc(Reg *d, Reg *s)
+{
+    host_write_xmm(d, _mm_aesimc_si128(host_read_xmm(s)));
+}
+
+static __attribute__((target("pclmul"))) void host_pclmulqdq(Reg *d, Reg *s,
+                                                             uint32_t ctrl)
+{
+    __m128i a = host_read_xmm(d);
+    __m128i b = host_read_xmm(s);
+    __m128i r;
+
+    /* the intrinsic wants an immediate operand selector */
+    switch (ctrl & 0x11) {
+    case 0x00:
+        r = _mm_clmulepi64_si128(a, b, 0x00);
+        break;
+    case 0x01:
+        r = _mm_clmulepi64_si128(a, b, 0x01);
+        break;
+    case 0x10:
+        r = _mm_clmulepi64_si128(a, b, 0x10);
+        break;
+    default:
+        r = _mm_clmulepi64_si128(a, b, 0x11);
+        break;
+    }
+    host_write_xmm(d, r);
+}
+#endif
+
 void glue(helper_pclmulqdq, SUFFIX)(CPUX86State *env, Reg *d, Reg *s,
                                     uint32_t ctrl)
 {
     uint64_t ah, al, b, resh, resl;
 
+#ifdef HAVE_HOST_AES
+    if (__builtin_cpu_supports("pclmul")) {
+        host_pclmulqdq(d, s, ctrl);
+        return;
+    }
+#endif
     ah = 0;
     al = d->Q((ctrl & 1) != 0);
     b = s->Q((ctrl & 16) != 0);
@@ -2210,9 +2363,16 @@ void glue(helper_pclmulqdq, SUFFIX)(CPUX86State *env, Reg *d, Reg *s,
 void glue(helper_aesdec, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
     int i;
-    Reg st = *d;
-    Reg rk = *s;
+    Reg st, rk;
 
+#ifdef HAVE_HOST_AES
+    if (__builtin_cpu_supports("aes")) {
+        host_aesdec(d, s);
+        return;
+    }
+#endif
+    st = *d;
+    rk = *s;
     for (i = 0 ; i < 4 ; i++) {
         d->L(i) = rk.L(i) ^ bswap32(AES_Td0[st.B(AES_ishifts[4*i+0])] ^
                                     AES_Td1[st.B(AES_ishifts[4*i+1])] ^
@@ -2224,9 +2384,16 @@ void glue(helper_aesdec, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 void glue(helper_aesdeclast, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
     int i;
-    Reg st = *d;
-    Reg rk = *s;
+    Reg st, rk;
 
+#ifdef HAVE_HOST_AES
+    if (__builtin_cpu_supports("aes")) {
+        host_aesdeclast(d, s);
+        return;
+    }
+#endif
+    st = *d;
+    rk = *s;
     for (i = 0; i < 16; i++) {
         d->B(i) = rk.B(i) ^ (AES_Td4[st.B(AES_ishifts[i])] & 0xff);
     }
@@ -2235,9 +2402,16 @@ void glue(helper_aesdeclast, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 void glue(helper_aesenc, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
     int i;
-    Reg st = *d;
-    Reg rk = *s;
+    Reg st, rk;
 
+#ifdef HAVE_HOST_AES
+    if (__builtin_cpu_supports("aes")) {
+        host_aesenc(d, s);
+        return;
+    }
+#endif
+    st = *d;
+    rk = *s;
     for (i = 0 ; i < 4 ; i++) {
         d->L(i) = rk.L(i) ^ bswap32(AES_Te0[st.B(AES_shifts[4*i+0])] ^
                                     AES_Te1[st.B(AES_shifts[4*i+1])] ^
@@ -2249,9 +2423,16 @@ void glue(helper_aesenc, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 void glue(helper_aesenclast, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
     int i;
-    Reg st = *d;
-    Reg rk = *s;
+    Reg st, rk;
 
+#ifdef HAVE_HOST_AES
+    if (__builtin_cpu_supports("aes")) {
+        host_aesenclast(d, s);
+        return;
+    }
+#endif
+    st = *d;
+    rk = *s;
     for (i = 0; i < 16; i++) {
         d->B(i) = rk.B(i) ^ (AES_Te4[st.B(AES_shifts[i])] & 0xff);
     }
@@ -2261,8 +2442,15 @@ void glue(helper_aesenclast, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 void glue(helper_aesimc, SUFFIX)(CPUX86State *env, Reg *d, Reg *s)
 {
     int i;
-    Reg tmp = *s;
+    Reg tmp;
 
+#ifdef HAVE_HOST_AES
+    if (__builtin_cpu_supports("aes")) {
+        host_aesimc(d, s);
+        return;
+    }
+#endif
+    tmp = *s;
     for (i = 0 ; i < 4 ; i++) {
         d->L(i) = bswap32(AES_Td0[AES_Te4[tmp.B(4*i+0)] & 0xff] ^
                           AES_Td1[AES_Te4[tmp.B(4*i+1)] & 0xff] ^
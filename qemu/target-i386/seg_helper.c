@@ -945,66 +945,42 @@ void helper_syscall(CPUX86State *env, int next_eip_addend)
 #else
 void helper_syscall(CPUX86State *env, int next_eip_addend)
 {
-    // Unicorn: call registered syscall hooks
+    // Unicorn: a registered hook services the syscall from the host, so the
+    // segment reload machinery is skipped entirely.  Only the register
+    // effects the guest can observe afterwards are applied: in long mode
+    // SYSCALL clobbers rcx with the return rip and r11 with rflags, and the
+    // System V ABI marks both caller-clobbered for exactly that reason.
     struct hook *hook;
-    HOOK_FOREACH(env->uc, hook, UC_HOOK_INSN) {
+    bool handled = false;
+
+    HOOK_FOREACH_INSN(env->uc, hook, UC_X86_INS_SYSCALL) {
         if (!HOOK_BOUND_CHECK(hook, env->eip))
             continue;
-        if (hook->insn == UC_X86_INS_SYSCALL)
-            ((uc_cb_insn_syscall_t)hook->callback)(env->uc, hook->user_data);
+        if (!handled && (env->hflags & HF_LMA_MASK)) {
+            env->regs[R_ECX] = env->eip + next_eip_addend;
+            env->regs[11] = cpu_compute_eflags(env);
+        }
+        handled = true;
+        ((uc_cb_insn_syscall_t)hook->callback)(env->uc, hook->user_data);
     }
 
     env->eip += next_eip_addend;
-    return;
-
-    int selector;
+}
 
-    if (!(env->efer & MSR_EFER_SCE)) {
-        raise_exception_err(env, EXCP06_ILLOP, 0);
-    }
-    selector = (env->star >> 32) & 0xffff;
+// Direct-dispatch variant emitted when translation finds exactly one
+// UC_HOOK_INSN hook covering this syscall (see HOOK_INSN_SINGLE): the
+// callback and its user_data arrive baked into the TB as constants, so
+// the hot path skips the table walk and bound checks entirely.
+void helper_uc_syscall(CPUX86State *env, void *callback, void *user_data,
+                       int next_eip_addend)
+{
     if (env->hflags & HF_LMA_MASK) {
-        int code64;
-
         env->regs[R_ECX] = env->eip + next_eip_addend;
         env->regs[11] = cpu_compute_eflags(env);
-
-        code64 = env->hflags & HF_CS64_MASK;
-
-        env->eflags &= ~env->fmask;
-        cpu_load_eflags(env, env->eflags, 0);
-        cpu_x86_load_seg_cache(env, R_CS, selector & 0xfffc,
-                           0, 0xffffffff,
-                               DESC_G_MASK | DESC_P_MASK |
-                               DESC_S_MASK |
-                               DESC_CS_MASK | DESC_R_MASK | DESC_A_MASK |
-                               DESC_L_MASK);
-        cpu_x86_load_seg_cache(env, R_SS, (selector + 8) & 0xfffc,
-                               0, 0xffffffff,
-                               DESC_G_MASK | DESC_B_MASK | DESC_P_MASK |
-                               DESC_S_MASK |
-                               DESC_W_MASK | DESC_A_MASK);
-        if (code64) {
-            env->eip = env->lstar;
-        } else {
-            env->eip = env->cstar;
-        }
-    } else {
-        env->regs[R_ECX] = (uint32_t)(env->eip + next_eip_addend);
-
-        env->eflags &= ~(IF_MASK | RF_MASK | VM_MASK);
-        cpu_x86_load_seg_cache(env, R_CS, selector & 0xfffc,
-                           0, 0xffffffff,
-                               DESC_G_MASK | DESC_B_MASK | DESC_P_MASK |
-                               DESC_S_MASK |
-                               DESC_CS_MASK | DESC_R_MASK | DESC_A_MASK);
-        cpu_x86_load_seg_cache(env, R_SS, (selector + 8) & 0xfffc,
-                               0, 0xffffffff,
-                               DESC_G_MASK | DESC_B_MASK | DESC_P_MASK |
-                               DESC_S_MASK |
-                               DESC_W_MASK | DESC_A_MASK);
-        env->eip = (uint32_t)env->star;
     }
+    ((uc_cb_insn_syscall_t)callback)(env->uc, user_data);
+
+    env->eip += next_eip_addend;
 }
 #endif
 #endif
@@ -1291,8 +1267,9 @@ bool x86_cpu_exec_interrupt(CPUState *cs, int interrupt_request)
 
 #if !defined(CONFIG_USER_ONLY)
     if (interrupt_request & CPU_INTERRUPT_POLL) {
+        // nothing buffers interrupts behind the stub APIC, so the poll
+        // request is simply dropped instead of walking into the device model
         cs->interrupt_request &= ~CPU_INTERRUPT_POLL;
-        apic_poll_irq(cpu->apic_state);
     }
 #endif
     if (interrupt_request & CPU_INTERRUPT_SIPI) {
@@ -1324,10 +1301,15 @@ bool x86_cpu_exec_interrupt(CPUState *cs, int interrupt_request)
             cpu_svm_check_intercept_param(env, SVM_EXIT_INTR, 0);
             cs->interrupt_request &= ~(CPU_INTERRUPT_HARD |
                                        CPU_INTERRUPT_VIRQ);
-            intno = cpu_get_pic_interrupt(env);
-            qemu_log_mask(CPU_LOG_TB_IN_ASM,
-                          "Servicing hardware INT=0x%02x\n", intno);
-            do_interrupt_x86_hardirq(env, intno, 1);
+            // fixed-function controller: hooks latch at most one pending
+            // vector on uc_struct, so there is no APIC/PIC model to consult
+            intno = cs->uc->x86_hard_vector;
+            cs->uc->x86_hard_vector = -1;
+            if (intno >= 0) {
+                qemu_log_mask(CPU_LOG_TB_IN_ASM,
+                              "Servicing hardware INT=0x%02x\n", intno);
+                do_interrupt_x86_hardirq(env, intno, 1);
+            }
             /* ensure that no TB jump will be modified as
                the program flow was changed */
             ret = true;
@@ -2307,11 +2289,10 @@ void helper_sysenter(CPUX86State *env, int next_eip_addend)
 {
     // Unicorn: call registered SYSENTER hooks
     struct hook *hook;
-    HOOK_FOREACH(env->uc, hook, UC_HOOK_INSN) {
+    HOOK_FOREACH_INSN(env->uc, hook, UC_X86_INS_SYSENTER) {
         if (!HOOK_BOUND_CHECK(hook, env->eip))
             continue;
-        if (hook->insn == UC_X86_INS_SYSENTER)
-            ((uc_cb_insn_syscall_t)hook->callback)(env->uc, hook->user_data);
+        ((uc_cb_insn_syscall_t)hook->callback)(env->uc, hook->user_data);
     }
 
     env->eip += next_eip_addend;
@@ -2348,6 +2329,15 @@ void helper_sysenter(CPUX86State *env, int next_eip_addend)
     env->eip = env->sysenter_eip;
 }
 
+// Direct-dispatch variant of the SYSENTER hook call, see helper_uc_syscall()
+void helper_uc_sysenter(CPUX86State *env, void *callback, void *user_data,
+                        int next_eip_addend)
+{
+    ((uc_cb_insn_syscall_t)callback)(env->uc, user_data);
+
+    env->eip += next_eip_addend;
+}
+
 void helper_sysexit(CPUX86State *env, int dflag)
 {
     int cpl;
@@ -22,7 +22,7 @@
 
 /* SMM support */
 
-#if defined(CONFIG_USER_ONLY)
+#if defined(CONFIG_USER_ONLY) || defined(UNICORN_NO_SMM_SVM)
 
 void do_smm_enter(X86CPU *cpu)
 {
@@ -314,4 +314,4 @@ void helper_rsm(CPUX86State *env)
     log_cpu_state_mask(CPU_LOG_INT, CPU(cpu), CPU_DUMP_CCOP);
 }
 
-#endif /* !CONFIG_USER_ONLY */
+#endif /* !CONFIG_USER_ONLY && !UNICORN_NO_SMM_SVM */
@@ -106,6 +106,9 @@ typedef struct DisasContext {
 
     // Unicorn
     target_ulong prev_pc; /* save address of the previous instruction */
+    int sb_follow; /* superblock translation: unconditional jumps left to follow */
+    int sb_jmp;    /* set by gen_jmp_tb() when a jump was followed, not emitted */
+    target_ulong sb_next_pc; /* target of the followed jump */
 } DisasContext;
 
 static void gen_eob(DisasContext *s);
@@ -452,27 +455,27 @@ static inline void gen_op_addl_A0_reg_sN(TCGContext *s, int shift, int reg)
 static inline void gen_op_movl_A0_seg(TCGContext *s, int reg)
 {
     TCGv cpu_A0 = *(TCGv *)s->cpu_A0;
+    TCGv cpu_seg = *(TCGv *)s->cpu_seg_base[reg];
 
-    tcg_gen_ld32u_tl(s, cpu_A0, s->cpu_env, offsetof(CPUX86State, segs[reg].base) + REG_L_OFFSET);
+    tcg_gen_ext32u_tl(s, cpu_A0, cpu_seg);
 }
 
 static inline void gen_op_addl_A0_seg(DisasContext *s, int reg)
 {
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
     TCGv cpu_A0 = *(TCGv *)tcg_ctx->cpu_A0;
-    TCGv cpu_tmp0 = *(TCGv *)tcg_ctx->cpu_tmp0;
+    TCGv cpu_seg = *(TCGv *)tcg_ctx->cpu_seg_base[reg];
 
-    tcg_gen_ld_tl(tcg_ctx, cpu_tmp0, tcg_ctx->cpu_env, offsetof(CPUX86State, segs[reg].base));
 #ifdef TARGET_X86_64
     if (CODE64(s)) {
         tcg_gen_andi_tl(tcg_ctx, cpu_A0, cpu_A0, 0xffffffff);
-        tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_tmp0);
+        tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_seg);
     } else {
-        tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_tmp0);
+        tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_seg);
         tcg_gen_andi_tl(tcg_ctx, cpu_A0, cpu_A0, 0xffffffff);
     }
 #else
-    tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_tmp0);
+    tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_seg);
 #endif
 }
 
@@ -480,17 +483,17 @@ static inline void gen_op_addl_A0_seg(DisasContext *s, int reg)
 static inline void gen_op_movq_A0_seg(TCGContext *s, int reg)
 {
     TCGv cpu_A0 = *(TCGv *)s->cpu_A0;
+    TCGv cpu_seg = *(TCGv *)s->cpu_seg_base[reg];
 
-    tcg_gen_ld_tl(s, cpu_A0, s->cpu_env, offsetof(CPUX86State, segs[reg].base));
+    tcg_gen_mov_tl(s, cpu_A0, cpu_seg);
 }
 
 static inline void gen_op_addq_A0_seg(TCGContext *s, int reg)
 {
     TCGv cpu_A0 = *(TCGv *)s->cpu_A0;
-    TCGv cpu_tmp0 = *(TCGv *)s->cpu_tmp0;
+    TCGv cpu_seg = *(TCGv *)s->cpu_seg_base[reg];
 
-    tcg_gen_ld_tl(s, cpu_tmp0, s->cpu_env, offsetof(CPUX86State, segs[reg].base));
-    tcg_gen_add_tl(s, cpu_A0, cpu_A0, cpu_tmp0);
+    tcg_gen_add_tl(s, cpu_A0, cpu_A0, cpu_seg);
 }
 
 static inline void gen_op_movq_A0_reg(TCGContext *s, int reg)
@@ -692,36 +695,46 @@ static inline void gen_op_jz_ecx(TCGContext *s, TCGMemOp size, int label1)
 
 static void gen_helper_in_func(TCGContext *s, TCGMemOp ot, TCGv v, TCGv_i32 n)
 {
+    /* fetch the engine from env instead of embedding its address */
+    TCGv_ptr tuc = tcg_temp_new_ptr(s);
+
+    tcg_gen_ld_ptr(s, tuc, s->cpu_env, offsetof(CPUX86State, uc));
     switch (ot) {
     case MO_8:
-        gen_helper_inb(s, v, tcg_const_ptr(s, s->uc), n);
+        gen_helper_inb(s, v, tuc, n);
         break;
     case MO_16:
-        gen_helper_inw(s, v, tcg_const_ptr(s, s->uc), n);
+        gen_helper_inw(s, v, tuc, n);
         break;
     case MO_32:
-        gen_helper_inl(s, v, tcg_const_ptr(s, s->uc), n);
+        gen_helper_inl(s, v, tuc, n);
         break;
     default:
         tcg_abort();
     }
+    tcg_temp_free_ptr(s, tuc);
 }
 
 static void gen_helper_out_func(TCGContext *s, TCGMemOp ot, TCGv_i32 v, TCGv_i32 n)
 {
+    /* fetch the engine from env instead of embedding its address */
+    TCGv_ptr tuc = tcg_temp_new_ptr(s);
+
+    tcg_gen_ld_ptr(s, tuc, s->cpu_env, offsetof(CPUX86State, uc));
     switch (ot) {
     case MO_8:
-        gen_helper_outb(s, tcg_const_ptr(s, s->uc), v, n);
+        gen_helper_outb(s, tuc, v, n);
         break;
     case MO_16:
-        gen_helper_outw(s, tcg_const_ptr(s, s->uc), v, n);
+        gen_helper_outw(s, tuc, v, n);
         break;
     case MO_32:
-        gen_helper_outl(s, tcg_const_ptr(s, s->uc), v, n);
+        gen_helper_outl(s, tuc, v, n);
         break;
     default:
         tcg_abort();
     }
+    tcg_temp_free_ptr(s, tuc);
 }
 
 static void gen_check_io(DisasContext *s, TCGMemOp ot, target_ulong cur_eip,
@@ -756,6 +769,7 @@ static void gen_check_io(DisasContext *s, TCGMemOp ot, target_ulong cur_eip,
             tcg_abort();
         }
     }
+#ifndef UNICORN_NO_SMM_SVM
     if(s->flags & HF_SVMI_MASK) {
         if (!state_saved) {
             gen_update_cc_op(s);
@@ -768,6 +782,7 @@ static void gen_check_io(DisasContext *s, TCGMemOp ot, target_ulong cur_eip,
                                 tcg_const_i32(tcg_ctx, svm_flags),
                                 tcg_const_i32(tcg_ctx, next_eip - cur_eip));
     }
+#endif
 }
 
 static inline void gen_movs(DisasContext *s, TCGMemOp ot)
@@ -1026,6 +1041,7 @@ static CCPrepare gen_prepare_eflags_o(DisasContext *s, TCGv reg)
     case CC_OP_ADCOX:
         return (CCPrepare) { .cond = TCG_COND_NE, .reg = cpu_cc_src2,
                              .mask = -1, .no_setcond = true };
+    case CC_OP_LOGICB ... CC_OP_LOGICQ:
     case CC_OP_CLR:
         return (CCPrepare) { .cond = TCG_COND_NEVER, .mask = -1 };
     default:
@@ -1072,6 +1088,7 @@ static CCPrepare gen_prepare_cc(DisasContext *s, int b, TCGv reg)
     CCPrepare cc;
     TCGv t0;
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
+    TCGv cpu_cc_dst = *(TCGv *)tcg_ctx->cpu_cc_dst;
     TCGv cpu_cc_src = *(TCGv *)tcg_ctx->cpu_cc_src;
     TCGv cpu_cc_srcT = *(TCGv *)tcg_ctx->cpu_cc_srcT;
     TCGv cpu_tmp0 = *(TCGv *)tcg_ctx->cpu_tmp0;
@@ -1111,6 +1128,32 @@ static CCPrepare gen_prepare_cc(DisasContext *s, int b, TCGv reg)
         }
         break;
 
+    case CC_OP_LOGICB ... CC_OP_LOGICQ:
+        /* C and O are clear after logic ops, so the unsigned and signed
+           relational operators collapse to compares of the (extended)
+           result against zero.  */
+        size = s->cc_op - CC_OP_LOGICB;
+        switch (jcc_op) {
+        case JCC_BE:    /* C | Z -> Z */
+            t0 = gen_ext_tl(tcg_ctx, reg, cpu_cc_dst, size, false);
+            cc = (CCPrepare) { .cond = TCG_COND_EQ, .reg = t0, .mask = -1 };
+            break;
+
+        case JCC_L:     /* S ^ O -> S */
+            t0 = gen_ext_tl(tcg_ctx, reg, cpu_cc_dst, size, true);
+            cc = (CCPrepare) { .cond = TCG_COND_LT, .reg = t0, .mask = -1 };
+            break;
+
+        case JCC_LE:    /* (S ^ O) | Z -> S | Z */
+            t0 = gen_ext_tl(tcg_ctx, reg, cpu_cc_dst, size, true);
+            cc = (CCPrepare) { .cond = TCG_COND_LE, .reg = t0, .mask = -1 };
+            break;
+
+        default:
+            goto slow_jcc;
+        }
+        break;
+
     default:
     slow_jcc:
         /* This actually generates good code for JC, JZ and JS.  */
@@ -2093,7 +2136,6 @@ static void gen_lea_modrm(CPUX86State *env, DisasContext *s, int modrm)
     TCGv sum;
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
     TCGv cpu_A0 = *(TCGv *)tcg_ctx->cpu_A0;
-    TCGv cpu_tmp0 = *(TCGv *)tcg_ctx->cpu_tmp0;
     TCGv **cpu_regs = (TCGv **)tcg_ctx->cpu_regs;
 
     override = s->override;
@@ -2182,17 +2224,19 @@ static void gen_lea_modrm(CPUX86State *env, DisasContext *s, int modrm)
                 }
             }
 
-            tcg_gen_ld_tl(tcg_ctx, cpu_tmp0, tcg_ctx->cpu_env,
-                          offsetof(CPUX86State, segs[override].base));
-            if (CODE64(s)) {
-                if (s->aflag == MO_32) {
-                    tcg_gen_ext32u_tl(tcg_ctx, cpu_A0, cpu_A0);
+            {
+                TCGv cpu_seg = *(TCGv *)tcg_ctx->cpu_seg_base[override];
+
+                if (CODE64(s)) {
+                    if (s->aflag == MO_32) {
+                        tcg_gen_ext32u_tl(tcg_ctx, cpu_A0, cpu_A0);
+                    }
+                    tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_seg);
+                    return;
                 }
-                tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_tmp0);
-                return;
-            }
 
-            tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_tmp0);
+                tcg_gen_add_tl(tcg_ctx, cpu_A0, cpu_A0, cpu_seg);
+            }
         }
 
         if (s->aflag == MO_32) {
@@ -2450,6 +2494,40 @@ static inline void gen_jcc(DisasContext *s, int b,
     int l1, l2;
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
 
+    /* Unicorn: when retranslating a hot block as a superblock (see
+       tb_superblock()), follow the likely edge of a conditional direct
+       jump instead of ending the block: a backward target is a loop
+       backedge and likely taken, a forward one likely falls through.
+       Translation continues at the followed edge with the condition code
+       state still live, so its flag uses compile against the known CC_OP
+       instead of materializing eflags at the block boundary.  The
+       unlikely edge becomes an unchained side exit that stores CC_OP by
+       hand, leaving the translator state of the followed edge intact. */
+    if (s->sb_follow > 0 && s->jmp_opt) {
+        int follow_taken = val < next_eip;
+        target_ulong follow_eip = follow_taken ? val : next_eip;
+        target_ulong other_eip = follow_taken ? next_eip : val;
+
+        if (((s->cs_base + follow_eip) & TARGET_PAGE_MASK) ==
+                (s->tb->pc & TARGET_PAGE_MASK)) {
+            TCGv_i32 cpu_cc_op = tcg_ctx->cpu_cc_op;
+
+            l1 = gen_new_label(tcg_ctx);
+            gen_jcc1_noeob(s, follow_taken ? b : b ^ 1, l1);
+            if (s->cc_op_dirty) {
+                tcg_gen_movi_i32(tcg_ctx, cpu_cc_op, s->cc_op);
+            }
+            gen_jmp_im(s, other_eip);
+            tcg_gen_exit_tb(tcg_ctx, 0);
+            gen_set_label(tcg_ctx, l1);
+
+            s->sb_follow--;
+            s->sb_jmp = 1;
+            s->sb_next_pc = s->cs_base + follow_eip;
+            return;
+        }
+    }
+
     if (s->jmp_opt) {
         l1 = gen_new_label(tcg_ctx);
         gen_jcc1(s, b, l1);
@@ -2517,13 +2595,13 @@ static inline void gen_op_movl_T0_seg(TCGContext *s, int seg_reg)
 static inline void gen_op_movl_seg_T0_vm(TCGContext *s, int seg_reg)
 {
     TCGv **cpu_T = (TCGv **)s->cpu_T;
+    TCGv cpu_seg = *(TCGv *)s->cpu_seg_base[seg_reg];
 
     tcg_gen_andi_tl(s, *cpu_T[0], *cpu_T[0], 0xffff);
     tcg_gen_st32_tl(s, *cpu_T[0], s->cpu_env,
                     offsetof(CPUX86State,segs[seg_reg].selector));
     tcg_gen_shli_tl(s, *cpu_T[0], *cpu_T[0], 4);
-    tcg_gen_st_tl(s, *cpu_T[0], s->cpu_env,
-                  offsetof(CPUX86State,segs[seg_reg].base));
+    tcg_gen_mov_tl(s, cpu_seg, *cpu_T[0]);
 }
 
 /* move T0 to seg_reg and compute if the CPU state may change. Never
@@ -2562,6 +2640,7 @@ static inline void
 gen_svm_check_intercept_param(DisasContext *s, target_ulong pc_start,
                               uint32_t type, uint64_t param)
 {
+#ifndef UNICORN_NO_SMM_SVM
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
 
     /* no SVM activated; fast case */
@@ -2571,6 +2650,7 @@ gen_svm_check_intercept_param(DisasContext *s, target_ulong pc_start,
     gen_jmp_im(s, pc_start - s->cs_base);
     gen_helper_svm_check_intercept_param(tcg_ctx, tcg_ctx->cpu_env, tcg_const_i32(tcg_ctx, type),
                                          tcg_const_i64(tcg_ctx, param));
+#endif
 }
 
 static inline void
@@ -2839,6 +2919,19 @@ static void gen_eob(DisasContext *s)
    direct call to the next block may occur */
 static void gen_jmp_tb(DisasContext *s, target_ulong eip, int tb_num)
 {
+    /* Unicorn: when retranslating a hot block as a superblock (see
+       tb_superblock()), follow an unconditional direct jump that stays on
+       the block's first page instead of ending the block; translation
+       continues at the target, keeping the condition code state live
+       across the jump.  The budget bounds unrolling of backward jumps. */
+    if (s->sb_follow > 0 && s->jmp_opt && tb_num == 0 &&
+            ((s->cs_base + eip) & TARGET_PAGE_MASK) ==
+            (s->tb->pc & TARGET_PAGE_MASK)) {
+        s->sb_follow--;
+        s->sb_jmp = 1;
+        s->sb_next_pc = s->cs_base + eip;
+        return;
+    }
     gen_update_cc_op(s);
     set_cc_op(s, CC_OP_DYNAMIC);
     if (s->jmp_opt) {
@@ -4743,6 +4836,7 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
     int modrm, reg, rm, mod, op, opreg, val;
     target_ulong next_eip, tval;
     int rex_w, rex_r;
+    struct hook *hook;
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
     TCGv_ptr cpu_env = tcg_ctx->cpu_env;
     TCGv_i32 cpu_tmp2_i32 = tcg_ctx->cpu_tmp2_i32;
@@ -4783,7 +4877,7 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
             s->last_cc_op = s->cc_op;
             changed_cc_op = true;
         }
-        gen_uc_tracecode(tcg_ctx, 0xf1f1f1f1, UC_HOOK_CODE_IDX, env->uc, pc_start);
+        gen_uc_tracecode(tcg_ctx, 0xf1f1f1f1, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), pc_start);
         restore_eflags(s, tcg_ctx);
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
@@ -6607,6 +6701,11 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
     case 0xa5:
         ot = mo_b_d(b, dflag);
         if (prefixes & (PREFIX_REPZ | PREFIX_REPNZ)) {
+            // Unicorn: bulk-move whatever the host can before entering the
+            // one-element loop, see helper_rep_movs()
+            gen_helper_rep_movs(tcg_ctx, cpu_env, tcg_const_i32(tcg_ctx, ot),
+                                tcg_const_i32(tcg_ctx, s->override >= 0 ? s->override : R_DS),
+                                tcg_const_i32(tcg_ctx, s->aflag));
             gen_repz_movs(s, ot, pc_start - s->cs_base, s->pc - s->cs_base);
         } else {
             gen_movs(s, ot);
@@ -6617,6 +6716,8 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
     case 0xab:
         ot = mo_b_d(b, dflag);
         if (prefixes & (PREFIX_REPZ | PREFIX_REPNZ)) {
+            gen_helper_rep_stos(tcg_ctx, cpu_env, tcg_const_i32(tcg_ctx, ot),
+                                tcg_const_i32(tcg_ctx, s->aflag));
             gen_repz_stos(s, ot, pc_start - s->cs_base, s->pc - s->cs_base);
         } else {
             gen_stos(s, ot);
@@ -6635,8 +6736,20 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
     case 0xaf:
         ot = mo_b_d(b, dflag);
         if (prefixes & PREFIX_REPNZ) {
+            if (ot == MO_8) {
+                // skip past bytes that cannot terminate the scan; the loop
+                // below still does the flag-setting compare
+                gen_helper_rep_scasb(tcg_ctx, cpu_env,
+                                     tcg_const_i32(tcg_ctx, s->aflag),
+                                     tcg_const_i32(tcg_ctx, 1));
+            }
             gen_repz_scas(s, ot, pc_start - s->cs_base, s->pc - s->cs_base, 1);
         } else if (prefixes & PREFIX_REPZ) {
+            if (ot == MO_8) {
+                gen_helper_rep_scasb(tcg_ctx, cpu_env,
+                                     tcg_const_i32(tcg_ctx, s->aflag),
+                                     tcg_const_i32(tcg_ctx, 0));
+            }
             gen_repz_scas(s, ot, pc_start - s->cs_base, s->pc - s->cs_base, 0);
         } else {
             gen_scas(s, ot);
@@ -7438,7 +7551,18 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
         } else {
             gen_update_cc_op(s);
             gen_jmp_im(s, pc_start - s->cs_base);
-            gen_helper_sysenter(tcg_ctx, cpu_env, tcg_const_i32(tcg_ctx, s->pc - pc_start));
+            /* a single hook resolved now gets a monomorphic call with its
+               user_data baked in; otherwise fall back to the table walk */
+            hook = HOOK_INSN_SINGLE(s->uc, UC_X86_INS_SYSENTER,
+                                    pc_start - s->cs_base);
+            if (hook) {
+                gen_helper_uc_sysenter(tcg_ctx, cpu_env,
+                        tcg_const_ptr(tcg_ctx, hook->callback),
+                        tcg_const_ptr(tcg_ctx, hook->user_data),
+                        tcg_const_i32(tcg_ctx, s->pc - pc_start));
+            } else {
+                gen_helper_sysenter(tcg_ctx, cpu_env, tcg_const_i32(tcg_ctx, s->pc - pc_start));
+            }
             gen_eob(s);
         }
         break;
@@ -7460,7 +7584,18 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
         /* XXX: is it usable in real mode ? */
         gen_update_cc_op(s);
         gen_jmp_im(s, pc_start - s->cs_base);
-        gen_helper_syscall(tcg_ctx, cpu_env, tcg_const_i32(tcg_ctx, s->pc - pc_start));
+        /* see sysenter: one hook known at translation time means a direct
+           call; the generic helper also covers the no-hook case */
+        hook = HOOK_INSN_SINGLE(s->uc, UC_X86_INS_SYSCALL,
+                                pc_start - s->cs_base);
+        if (hook) {
+            gen_helper_uc_syscall(tcg_ctx, cpu_env,
+                    tcg_const_ptr(tcg_ctx, hook->callback),
+                    tcg_const_ptr(tcg_ctx, hook->user_data),
+                    tcg_const_i32(tcg_ctx, s->pc - pc_start));
+        } else {
+            gen_helper_syscall(tcg_ctx, cpu_env, tcg_const_i32(tcg_ctx, s->pc - pc_start));
+        }
         gen_eob(s);
         break;
     case 0x107: /* sysret */
@@ -7637,6 +7772,11 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
         case 2: /* lgdt */
         case 3: /* lidt */
             if (mod == 3) {
+#ifdef UNICORN_NO_SMM_SVM
+                /* SVM helpers are compiled out; the whole group decodes as
+                   invalid */
+                goto illegal_op;
+#else
                 gen_update_cc_op(s);
                 gen_jmp_im(s, pc_start - s->cs_base);
                 switch(rm) {
@@ -7721,6 +7861,7 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
                 default:
                     goto illegal_op;
                 }
+#endif
             } else if (s->cpl != 0) {
                 gen_exception(s, EXCP0D_GPF, pc_start - s->cs_base);
             } else {
@@ -7782,12 +7923,12 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
                         if (s->cpl != 0) {
                             gen_exception(s, EXCP0D_GPF, pc_start - s->cs_base);
                         } else {
-                            tcg_gen_ld_tl(tcg_ctx, *cpu_T[0], cpu_env,
-                                offsetof(CPUX86State,segs[R_GS].base));
+                            TCGv gs_base = *(TCGv *)tcg_ctx->cpu_seg_base[R_GS];
+
+                            tcg_gen_mov_tl(tcg_ctx, *cpu_T[0], gs_base);
                             tcg_gen_ld_tl(tcg_ctx, *cpu_T[1], cpu_env,
                                 offsetof(CPUX86State,kernelgsbase));
-                            tcg_gen_st_tl(tcg_ctx, *cpu_T[1], cpu_env,
-                                offsetof(CPUX86State,segs[R_GS].base));
+                            tcg_gen_mov_tl(tcg_ctx, gs_base, *cpu_T[1]);
                             tcg_gen_st_tl(tcg_ctx, *cpu_T[0], cpu_env,
                                 offsetof(CPUX86State,kernelgsbase));
                         }
@@ -8128,6 +8269,10 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
         /* ignore for now */
         break;
     case 0x1aa: /* rsm */
+#ifdef UNICORN_NO_SMM_SVM
+        /* SMM helpers are compiled out and nothing can enter SMM */
+        goto illegal_op;
+#else
         gen_svm_check_intercept(s, pc_start, SVM_EXIT_RSM);
         if (!(s->flags & HF_SMM_MASK))
             goto illegal_op;
@@ -8136,6 +8281,7 @@ static target_ulong disas_insn(CPUX86State *env, DisasContext *s,
         gen_helper_rsm(tcg_ctx, cpu_env);
         gen_eob(s);
         break;
+#endif
     case 0x1b8: /* SSE4.2 popcnt */
         if ((prefixes & (PREFIX_REPZ | PREFIX_LOCK | PREFIX_REPNZ)) !=
              PREFIX_REPZ)
@@ -8240,6 +8386,14 @@ void optimize_flags_init(struct uc_struct *uc)
         [R_ESP] = "esp",
 #endif
     };
+    static const char seg_base_names[6][8] = {
+        [R_ES] = "es_base",
+        [R_CS] = "cs_base",
+        [R_SS] = "ss_base",
+        [R_DS] = "ds_base",
+        [R_FS] = "fs_base",
+        [R_GS] = "gs_base",
+    };
     int i;
     TCGContext *tcg_ctx = uc->tcg_ctx;
 
@@ -8264,6 +8418,16 @@ void optimize_flags_init(struct uc_struct *uc)
                 offsetof(CPUX86State, regs[i]),
                 reg_names[i]);
     }
+
+    // segment bases live as globals so address generation reuses the value
+    // the register allocator already holds instead of reloading it from env
+    // on every access; real-mode code adds a base to every single one
+    for (i = 0; i < 6; ++i) {
+        tcg_ctx->cpu_seg_base[i] = g_malloc0(sizeof(TCGv));
+        *((TCGv *)tcg_ctx->cpu_seg_base[i]) = tcg_global_mem_new(uc->tcg_ctx, TCG_AREG0,
+                offsetof(CPUX86State, segs[i].base),
+                seg_base_names[i]);
+    }
 }
 
 /* generate intermediate code in gen_opc_buf and gen_opparam_buf for
@@ -8284,6 +8448,7 @@ static inline void gen_intermediate_code_internal(uint8_t *gen_opc_cc_op,
     int j, lj;
     uint64_t flags;
     target_ulong pc_start;
+    target_ulong pc_max;
     target_ulong cs_base;
     int num_insns = 0;
     int max_insns;
@@ -8310,6 +8475,9 @@ static inline void gen_intermediate_code_internal(uint8_t *gen_opc_cc_op,
     dc->cs_base = cs_base;
     dc->tb = tb;
     dc->popl_esp_hack = 0;
+    // Unicorn: nonzero only for superblock retranslations, see tb_superblock()
+    dc->sb_follow = tb->sb_follow;
+    dc->sb_jmp = 0;
     /* select memory access functions */
     dc->mem_index = 0;
     if (flags & HF_SOFTMMU_MASK) {
@@ -8371,11 +8539,12 @@ static inline void gen_intermediate_code_internal(uint8_t *gen_opc_cc_op,
     env->uc->init_tcg = true;
 
     pc_ptr = pc_start;
+    pc_max = pc_start;
 
     // early check to see if the address of this block is the until address
     if (tb->pc == env->uc->addr_end) {
         // imitate the HLT instruction
-        gen_tb_start(tcg_ctx);
+        gen_tb_start(tcg_ctx, tb);
         gen_jmp_im(dc, tb->pc - tb->cs_base);
         gen_helper_hlt(tcg_ctx, tcg_ctx->cpu_env, tcg_const_i32(tcg_ctx, 0));
         dc->is_jmp = DISAS_TB_JUMP;
@@ -8390,15 +8559,22 @@ static inline void gen_intermediate_code_internal(uint8_t *gen_opc_cc_op,
     if (max_insns <= 1)
         max_insns = CF_COUNT_MASK;
 
+    // Unicorn: engine-wide cap on instructions per block
+    if (env->uc->tb_max_insns && max_insns > env->uc->tb_max_insns)
+        max_insns = env->uc->tb_max_insns;
+
     // Unicorn: trace this block on request
     // Only hook this block if it is not broken from previous translation due to
     // full translation cache
     if (!env->uc->block_full && HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_BLOCK, pc_start)) {
         env->uc->block_addr = pc_start;
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, env->uc, pc_start);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, offsetof(CPUArchState, uc), pc_start);
     }
 
-    gen_tb_start(tcg_ctx);
+    // Unicorn: update the edge coverage bitmap for this block
+    UC_GEN_COVERAGE(tcg_ctx, env->uc, pc_start);
+
+    gen_tb_start(tcg_ctx, tb);
     for(;;) {
         if (unlikely(!QTAILQ_EMPTY(&cs->breakpoints))) {
             QTAILQ_FOREACH(bp, &cs->breakpoints, entry) {
@@ -8428,9 +8604,18 @@ static inline void gen_intermediate_code_internal(uint8_t *gen_opc_cc_op,
         dc->prev_pc = pc_ptr;
         pc_ptr = disas_insn(env, dc, pc_ptr);
         num_insns++;
+        // Unicorn: the highest address translated; followed jumps may move
+        // pc_ptr backwards, but the block still covers up to here
+        if (pc_ptr > pc_max)
+            pc_max = pc_ptr;
         /* stop translation if indicated */
         if (dc->is_jmp)
             break;
+        // Unicorn: continue the superblock at the target of a followed jump
+        if (dc->sb_jmp) {
+            dc->sb_jmp = 0;
+            pc_ptr = dc->sb_next_pc;
+        }
         /* if single step mode, we generate only one instruction and
            generate an exception */
         /* if irq were inhibited with HF_INHIBIT_IRQ_MASK, we clear
@@ -8444,7 +8629,7 @@ static inline void gen_intermediate_code_internal(uint8_t *gen_opc_cc_op,
         }
         /* if too long translation, stop generation too */
         if (tcg_ctx->gen_opc_ptr >= gen_opc_end ||
-            (pc_ptr - pc_start) >= (TARGET_PAGE_SIZE - 32) ||
+            (pc_max - pc_start) >= (TARGET_PAGE_SIZE - 32) ||
             num_insns >= max_insns) {
             gen_jmp_im(dc, pc_ptr - dc->cs_base);
             gen_eob(dc);
@@ -8466,7 +8651,7 @@ done_generating:
     }
 
     if (!search_pc) {
-        tb->size = pc_ptr - pc_start;
+        tb->size = pc_max - pc_start;
     }
 
     env->uc->block_full = block_full;
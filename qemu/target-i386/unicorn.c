@@ -39,6 +39,9 @@ void x86_release(void *ctx)
     for (i = 0; i < CPU_NB_REGS; ++i) {
         g_free(s->cpu_regs[i]);
     }
+    for (i = 0; i < 6; ++i) {
+        g_free(s->cpu_seg_base[i]);
+    }
 
     g_free(s->tb_ctx.tbs);
 }
@@ -47,6 +50,8 @@ void x86_reg_reset(struct uc_struct *uc)
 {
     CPUArchState *env = first_cpu->env_ptr;
 
+    uc->x86_hard_vector = -1;   // no interrupt pending
+
     env->features[FEAT_1_EDX] = CPUID_CX8 | CPUID_CMOV | CPUID_SSE2 | CPUID_FXSR | CPUID_SSE | CPUID_CLFLUSH;
     env->features[FEAT_1_ECX] = CPUID_EXT_SSSE3 | CPUID_EXT_SSE41 | CPUID_EXT_SSE42 | CPUID_EXT_AES;
     env->features[FEAT_8000_0001_EDX] = CPUID_EXT2_3DNOW | CPUID_EXT2_RDTSCP;
@@ -136,884 +141,389 @@ void x86_reg_reset(struct uc_struct *uc)
     }
 }
 
+// Map a Unicorn register id onto the CPUX86State field that backs it.
+// Sub-register aliases (AX/AH/AL, R8D/R8W/R8B, ...) carry a bit shift into
+// the full-width backing field, so extraction and insertion stay arithmetic
+// and therefore host-endian neutral.
+typedef struct RegDesc {
+    uint16_t offset;    // of the backing field inside CPUX86State
+    uint8_t fsize;      // size of the backing field (4 or 8 bytes)
+    uint8_t size;       // bytes transferred to/from the caller (0: no entry)
+    uint8_t shift;      // bit position of the alias within the field
+} RegDesc;
+
+#define REG_DESC(id, field, sz, sh) \
+    [id] = { offsetof(CPUX86State, field), \
+             sizeof(((CPUX86State *)0)->field), sz, sh }
+
+static const RegDesc x86_regmap[UC_X86_REG_ENDING] = {
+    REG_DESC(UC_X86_REG_EAX, regs[R_EAX], 4, 0),
+    REG_DESC(UC_X86_REG_AX,  regs[R_EAX], 2, 0),
+    REG_DESC(UC_X86_REG_AH,  regs[R_EAX], 1, 8),
+    REG_DESC(UC_X86_REG_AL,  regs[R_EAX], 1, 0),
+    REG_DESC(UC_X86_REG_EBX, regs[R_EBX], 4, 0),
+    REG_DESC(UC_X86_REG_BX,  regs[R_EBX], 2, 0),
+    REG_DESC(UC_X86_REG_BH,  regs[R_EBX], 1, 8),
+    REG_DESC(UC_X86_REG_BL,  regs[R_EBX], 1, 0),
+    REG_DESC(UC_X86_REG_ECX, regs[R_ECX], 4, 0),
+    REG_DESC(UC_X86_REG_CX,  regs[R_ECX], 2, 0),
+    REG_DESC(UC_X86_REG_CH,  regs[R_ECX], 1, 8),
+    REG_DESC(UC_X86_REG_CL,  regs[R_ECX], 1, 0),
+    REG_DESC(UC_X86_REG_EDX, regs[R_EDX], 4, 0),
+    REG_DESC(UC_X86_REG_DX,  regs[R_EDX], 2, 0),
+    REG_DESC(UC_X86_REG_DH,  regs[R_EDX], 1, 8),
+    REG_DESC(UC_X86_REG_DL,  regs[R_EDX], 1, 0),
+    REG_DESC(UC_X86_REG_ESP, regs[R_ESP], 4, 0),
+    REG_DESC(UC_X86_REG_SP,  regs[R_ESP], 2, 0),
+    REG_DESC(UC_X86_REG_EBP, regs[R_EBP], 4, 0),
+    REG_DESC(UC_X86_REG_BP,  regs[R_EBP], 2, 0),
+    REG_DESC(UC_X86_REG_ESI, regs[R_ESI], 4, 0),
+    REG_DESC(UC_X86_REG_SI,  regs[R_ESI], 2, 0),
+    REG_DESC(UC_X86_REG_EDI, regs[R_EDI], 4, 0),
+    REG_DESC(UC_X86_REG_DI,  regs[R_EDI], 2, 0),
+    REG_DESC(UC_X86_REG_EIP, eip, 4, 0),
+    REG_DESC(UC_X86_REG_IP,  eip, 2, 0),
+    REG_DESC(UC_X86_REG_CS,  segs[R_CS].selector, 2, 0),
+    REG_DESC(UC_X86_REG_DS,  segs[R_DS].selector, 2, 0),
+    REG_DESC(UC_X86_REG_SS,  segs[R_SS].selector, 2, 0),
+    REG_DESC(UC_X86_REG_ES,  segs[R_ES].selector, 2, 0),
+    REG_DESC(UC_X86_REG_FS,  segs[R_FS].selector, 2, 0),
+    REG_DESC(UC_X86_REG_GS,  segs[R_GS].selector, 2, 0),
+#ifdef TARGET_X86_64
+    REG_DESC(UC_X86_REG_RAX, regs[R_EAX], 8, 0),
+    REG_DESC(UC_X86_REG_RBX, regs[R_EBX], 8, 0),
+    REG_DESC(UC_X86_REG_RCX, regs[R_ECX], 8, 0),
+    REG_DESC(UC_X86_REG_RDX, regs[R_EDX], 8, 0),
+    REG_DESC(UC_X86_REG_RSP, regs[R_ESP], 8, 0),
+    REG_DESC(UC_X86_REG_SPL, regs[R_ESP], 1, 0),
+    REG_DESC(UC_X86_REG_RBP, regs[R_EBP], 8, 0),
+    REG_DESC(UC_X86_REG_BPL, regs[R_EBP], 1, 0),
+    REG_DESC(UC_X86_REG_RSI, regs[R_ESI], 8, 0),
+    REG_DESC(UC_X86_REG_SIL, regs[R_ESI], 1, 0),
+    REG_DESC(UC_X86_REG_RDI, regs[R_EDI], 8, 0),
+    REG_DESC(UC_X86_REG_DIL, regs[R_EDI], 1, 0),
+    REG_DESC(UC_X86_REG_RIP, eip, 8, 0),
+    REG_DESC(UC_X86_REG_R8,   regs[8],  8, 0),
+    REG_DESC(UC_X86_REG_R8D,  regs[8],  4, 0),
+    REG_DESC(UC_X86_REG_R8W,  regs[8],  2, 0),
+    REG_DESC(UC_X86_REG_R8B,  regs[8],  1, 0),
+    REG_DESC(UC_X86_REG_R9,   regs[9],  8, 0),
+    REG_DESC(UC_X86_REG_R9D,  regs[9],  4, 0),
+    REG_DESC(UC_X86_REG_R9W,  regs[9],  2, 0),
+    REG_DESC(UC_X86_REG_R9B,  regs[9],  1, 0),
+    REG_DESC(UC_X86_REG_R10,  regs[10], 8, 0),
+    REG_DESC(UC_X86_REG_R10D, regs[10], 4, 0),
+    REG_DESC(UC_X86_REG_R10W, regs[10], 2, 0),
+    REG_DESC(UC_X86_REG_R10B, regs[10], 1, 0),
+    REG_DESC(UC_X86_REG_R11,  regs[11], 8, 0),
+    REG_DESC(UC_X86_REG_R11D, regs[11], 4, 0),
+    REG_DESC(UC_X86_REG_R11W, regs[11], 2, 0),
+    REG_DESC(UC_X86_REG_R11B, regs[11], 1, 0),
+    REG_DESC(UC_X86_REG_R12,  regs[12], 8, 0),
+    REG_DESC(UC_X86_REG_R12D, regs[12], 4, 0),
+    REG_DESC(UC_X86_REG_R12W, regs[12], 2, 0),
+    REG_DESC(UC_X86_REG_R12B, regs[12], 1, 0),
+    REG_DESC(UC_X86_REG_R13,  regs[13], 8, 0),
+    REG_DESC(UC_X86_REG_R13D, regs[13], 4, 0),
+    REG_DESC(UC_X86_REG_R13W, regs[13], 2, 0),
+    REG_DESC(UC_X86_REG_R13B, regs[13], 1, 0),
+    REG_DESC(UC_X86_REG_R14,  regs[14], 8, 0),
+    REG_DESC(UC_X86_REG_R14D, regs[14], 4, 0),
+    REG_DESC(UC_X86_REG_R14W, regs[14], 2, 0),
+    REG_DESC(UC_X86_REG_R14B, regs[14], 1, 0),
+    REG_DESC(UC_X86_REG_R15,  regs[15], 8, 0),
+    REG_DESC(UC_X86_REG_R15D, regs[15], 4, 0),
+    REG_DESC(UC_X86_REG_R15W, regs[15], 2, 0),
+    REG_DESC(UC_X86_REG_R15B, regs[15], 1, 0),
+#endif
+};
+
+// UC_X86_REG_XSTATE: move the whole FPU/SSE/AVX state as one XSAVE-layout
+// blob, composed the same way FXSAVE would (see do_fxsave in fpu_helper.c).
+static void x86_xstate_read(CPUX86State *env, uc_x86_xstate *xs)
+{
+    int i, nb_xmm_regs;
+
+    memset(xs, 0, sizeof(*xs));
+    xs->fcw = env->fpuc;
+    xs->fsw = (env->fpus & ~0x3800) | (env->fpstt & 0x7) << 11;
+    for (i = 0; i < 8; i++) {
+        xs->ftw |= (env->fptags[i] ^ 1) << i;
+    }
+    xs->fop = env->fpop;
+    xs->mxcsr = env->mxcsr;
+    xs->mxcsr_mask = 0x0000ffff;
+    for (i = 0; i < 8; i++) {
+        floatx80 *st = &ST(i);
+        memcpy(xs->st[i], &st->low, 8);
+        memcpy(xs->st[i] + 8, &st->high, 2);
+    }
+    nb_xmm_regs = CPU_NB_REGS < 16 ? CPU_NB_REGS : 16;
+    for (i = 0; i < nb_xmm_regs; i++) {
+        memcpy(xs->xmm[i], &env->xmm_regs[i], 16);
+        memcpy(xs->ymmh[i], &env->ymmh_regs[i], 16);
+    }
+}
+
+static void x86_xstate_write(CPUX86State *env, const uc_x86_xstate *xs)
+{
+    int i, nb_xmm_regs;
+
+    cpu_set_fpuc(env, xs->fcw);
+    env->fpstt = (xs->fsw >> 11) & 7;
+    env->fpus = xs->fsw & ~0x3800;
+    for (i = 0; i < 8; i++) {
+        env->fptags[i] = ((xs->ftw >> i) & 1) ^ 1;
+    }
+    env->fpop = xs->fop;
+    cpu_set_mxcsr(env, xs->mxcsr);
+    for (i = 0; i < 8; i++) {
+        floatx80 *st = &ST(i);
+        memcpy(&st->low, xs->st[i], 8);
+        memcpy(&st->high, xs->st[i] + 8, 2);
+    }
+    nb_xmm_regs = CPU_NB_REGS < 16 ? CPU_NB_REGS : 16;
+    for (i = 0; i < nb_xmm_regs; i++) {
+        memcpy(&env->xmm_regs[i], xs->xmm[i], 16);
+        memcpy(&env->ymmh_regs[i], xs->ymmh[i], 16);
+    }
+}
+
 int x86_reg_read(struct uc_struct *uc, unsigned int regid, void *value)
 {
-    CPUState *mycpu = first_cpu;
+    CPUX86State *env = &(X86_CPU(uc, first_cpu)->env);
+    const RegDesc *d;
+    uint64_t v;
 
-    switch(uc->mode) {
+    // the few registers whose width or layout depends on the current mode
+    switch(regid) {
         default:
             break;
-        case UC_MODE_16:
-            switch(regid) {
-                default: break;
-                case UC_X86_REG_ES:
-                    *(int16_t *)value = X86_CPU(uc, mycpu)->env.segs[R_ES].selector;
-                    return 0;
-                case UC_X86_REG_SS:
-                    *(int16_t *)value = X86_CPU(uc, mycpu)->env.segs[R_SS].selector;
-                    return 0;
-                case UC_X86_REG_DS:
-                    *(int16_t *)value = X86_CPU(uc, mycpu)->env.segs[R_DS].selector;
-                    return 0;
-                case UC_X86_REG_FS:
-                    *(int16_t *)value = X86_CPU(uc, mycpu)->env.segs[R_FS].selector;
-                    return 0;
-                case UC_X86_REG_GS:
-                    *(int16_t *)value = X86_CPU(uc, mycpu)->env.segs[R_GS].selector;
-                    return 0;
+        case UC_X86_REG_EFLAGS:
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                *(int64_t *)value = env->eflags;
+                return 0;
             }
-            // fall-thru
-        case UC_MODE_32:
-            switch(regid) {
-                default:
-                    break;
-                case UC_X86_REG_CR0 ... UC_X86_REG_CR4:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.cr[regid - UC_X86_REG_CR0];
-                    break;
-                case UC_X86_REG_DR0 ... UC_X86_REG_DR7:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.dr[regid - UC_X86_REG_DR0];
-                    break;
-                case UC_X86_REG_EFLAGS:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.eflags;
-                    break;
-                case UC_X86_REG_EAX:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EAX];
-                    break;
-                case UC_X86_REG_AX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EAX]);
-                    break;
-                case UC_X86_REG_AH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EAX]);
-                    break;
-                case UC_X86_REG_AL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EAX]);
-                    break;
-                case UC_X86_REG_EBX:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EBX];
-                    break;
-                case UC_X86_REG_BX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBX]);
-                    break;
-                case UC_X86_REG_BH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EBX]);
-                    break;
-                case UC_X86_REG_BL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EBX]);
-                    break;
-                case UC_X86_REG_ECX:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_ECX];
-                    break;
-                case UC_X86_REG_CX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_ECX]);
-                    break;
-                case UC_X86_REG_CH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_ECX]);
-                    break;
-                case UC_X86_REG_CL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ECX]);
-                    break;
-                case UC_X86_REG_EDX:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EDX];
-                    break;
-                case UC_X86_REG_DX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDX]);
-                    break;
-                case UC_X86_REG_DH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EDX]);
-                    break;
-                case UC_X86_REG_DL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EDX]);
-                    break;
-                case UC_X86_REG_ESP:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_ESP];
-                    break;
-                case UC_X86_REG_SP:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESP]);
-                    break;
-                case UC_X86_REG_EBP:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EBP];
-                    break;
-                case UC_X86_REG_BP:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBP]);
-                    break;
-                case UC_X86_REG_ESI:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_ESI];
-                    break;
-                case UC_X86_REG_SI:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESI]);
-                    break;
-                case UC_X86_REG_EDI:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EDI];
-                    break;
-                case UC_X86_REG_DI:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDI]);
-                    break;
-                case UC_X86_REG_EIP:
-                    *(int32_t *)value = X86_CPU(uc, mycpu)->env.eip;
-                    break;
-                case UC_X86_REG_IP:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.eip);
-                    break;
-                case UC_X86_REG_CS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_CS].selector;
-                    break;
-                case UC_X86_REG_DS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_DS].selector;
-                    break;
-                case UC_X86_REG_SS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_SS].selector;
-                    break;
-                case UC_X86_REG_ES:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_ES].selector;
-                    break;
-                case UC_X86_REG_FS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_FS].selector;
-                    break;
-                case UC_X86_REG_GS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_GS].selector;
-                    break;
-                case UC_X86_REG_IDTR:
-                    ((uc_x86_mmr *)value)->limit = (uint16_t)X86_CPU(uc, mycpu)->env.idt.limit;
-                    ((uc_x86_mmr *)value)->base = (uint32_t)X86_CPU(uc, mycpu)->env.idt.base;
-                    break;
-                case UC_X86_REG_GDTR:
-                    ((uc_x86_mmr *)value)->limit = (uint16_t)X86_CPU(uc, mycpu)->env.gdt.limit;
-                    ((uc_x86_mmr *)value)->base = (uint32_t)X86_CPU(uc, mycpu)->env.gdt.base;
-                    break;
-                case UC_X86_REG_LDTR:
-                    ((uc_x86_mmr *)value)->limit = X86_CPU(uc, mycpu)->env.ldt.limit;
-                    ((uc_x86_mmr *)value)->base = (uint32_t)X86_CPU(uc, mycpu)->env.ldt.base;
-                    ((uc_x86_mmr *)value)->selector = (uint16_t)X86_CPU(uc, mycpu)->env.ldt.selector;
-                    ((uc_x86_mmr *)value)->flags = X86_CPU(uc, mycpu)->env.ldt.flags;
-                    break;
-                case UC_X86_REG_TR:
-                    ((uc_x86_mmr *)value)->limit = X86_CPU(uc, mycpu)->env.tr.limit;
-                    ((uc_x86_mmr *)value)->base = (uint32_t)X86_CPU(uc, mycpu)->env.tr.base;
-                    ((uc_x86_mmr *)value)->selector = (uint16_t)X86_CPU(uc, mycpu)->env.tr.selector;
-                    ((uc_x86_mmr *)value)->flags = X86_CPU(uc, mycpu)->env.tr.flags;
-                    break;
+#endif
+            *(int32_t *)value = env->eflags;
+            return 0;
+        case UC_X86_REG_CR0 ... UC_X86_REG_CR4:
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                *(int64_t *)value = env->cr[regid - UC_X86_REG_CR0];
+                return 0;
             }
-            break;
-
+#endif
+            *(int32_t *)value = env->cr[regid - UC_X86_REG_CR0];
+            return 0;
+        case UC_X86_REG_DR0 ... UC_X86_REG_DR7:
 #ifdef TARGET_X86_64
-        case UC_MODE_64:
-            switch(regid) {
-                default:
-                    break;
-                case UC_X86_REG_CR0 ... UC_X86_REG_CR4:
-                    *(int64_t *)value = X86_CPU(uc, mycpu)->env.cr[regid - UC_X86_REG_CR0];
-                    break;
-                case UC_X86_REG_DR0 ... UC_X86_REG_DR7:
-                    *(int64_t *)value = X86_CPU(uc, mycpu)->env.dr[regid - UC_X86_REG_DR0];
-                    break;
-                case UC_X86_REG_EFLAGS:
-                    *(int64_t *)value = X86_CPU(uc, mycpu)->env.eflags;
-                    break;
-                case UC_X86_REG_RAX:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EAX];
-                    break;
-                case UC_X86_REG_EAX:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EAX]);
-                    break;
-                case UC_X86_REG_AX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EAX]);
-                    break;
-                case UC_X86_REG_AH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EAX]);
-                    break;
-                case UC_X86_REG_AL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EAX]);
-                    break;
-                case UC_X86_REG_RBX:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EBX];
-                    break;
-                case UC_X86_REG_EBX:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EBX]);
-                    break;
-                case UC_X86_REG_BX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBX]);
-                    break;
-                case UC_X86_REG_BH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EBX]);
-                    break;
-                case UC_X86_REG_BL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EBX]);
-                    break;
-                case UC_X86_REG_RCX:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_ECX];
-                    break;
-                case UC_X86_REG_ECX:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_ECX]);
-                    break;
-                case UC_X86_REG_CX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_ECX]);
-                    break;
-                case UC_X86_REG_CH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_ECX]);
-                    break;
-                case UC_X86_REG_CL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ECX]);
-                    break;
-                case UC_X86_REG_RDX:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EDX];
-                    break;
-                case UC_X86_REG_EDX:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EDX]);
-                    break;
-                case UC_X86_REG_DX:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDX]);
-                    break;
-                case UC_X86_REG_DH:
-                    *(int8_t *)value = READ_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EDX]);
-                    break;
-                case UC_X86_REG_DL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EDX]);
-                    break;
-                case UC_X86_REG_RSP:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_ESP];
-                    break;
-                case UC_X86_REG_ESP:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_ESP]);
-                    break;
-                case UC_X86_REG_SP:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESP]);
-                    break;
-                case UC_X86_REG_SPL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ESP]);
-                    break;
-                case UC_X86_REG_RBP:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EBP];
-                    break;
-                case UC_X86_REG_EBP:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EBP]);
-                    break;
-                case UC_X86_REG_BP:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBP]);
-                    break;
-                case UC_X86_REG_BPL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EBP]);
-                    break;
-                case UC_X86_REG_RSI:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_ESI];
-                    break;
-                case UC_X86_REG_ESI:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_ESI]);
-                    break;
-                case UC_X86_REG_SI:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESI]);
-                    break;
-                case UC_X86_REG_SIL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ESI]);
-                    break;
-                case UC_X86_REG_RDI:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.regs[R_EDI];
-                    break;
-                case UC_X86_REG_EDI:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EDI]);
-                    break;
-                case UC_X86_REG_DI:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDI]);
-                    break;
-                case UC_X86_REG_DIL:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EDI]);
-                    break;
-                case UC_X86_REG_RIP:
-                    *(uint64_t *)value = X86_CPU(uc, mycpu)->env.eip;
-                    break;
-                case UC_X86_REG_EIP:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.eip);
-                    break;
-                case UC_X86_REG_IP:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.eip);
-                    break;
-                case UC_X86_REG_CS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_CS].selector;
-                    break;
-                case UC_X86_REG_DS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_DS].selector;
-                    break;
-                case UC_X86_REG_SS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_SS].selector;
-                    break;
-                case UC_X86_REG_ES:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_ES].selector;
-                    break;
-                case UC_X86_REG_FS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_FS].selector;
-                    break;
-                case UC_X86_REG_GS:
-                    *(int16_t *)value = (uint16_t)X86_CPU(uc, mycpu)->env.segs[R_GS].selector;
-                    break;
-                case UC_X86_REG_R8:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[8]);
-                    break;
-                case UC_X86_REG_R8D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[8]);
-                    break;
-                case UC_X86_REG_R8W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[8]);
-                    break;
-                case UC_X86_REG_R8B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[8]);
-                    break;
-                case UC_X86_REG_R9:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[9]);
-                    break;
-                case UC_X86_REG_R9D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[9]);
-                    break;
-                case UC_X86_REG_R9W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[9]);
-                    break;
-                case UC_X86_REG_R9B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[9]);
-                    break;
-                case UC_X86_REG_R10:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[10]);
-                    break;
-                case UC_X86_REG_R10D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[10]);
-                    break;
-                case UC_X86_REG_R10W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[10]);
-                    break;
-                case UC_X86_REG_R10B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[10]);
-                    break;
-                case UC_X86_REG_R11:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[11]);
-                    break;
-                case UC_X86_REG_R11D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[11]);
-                    break;
-                case UC_X86_REG_R11W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[11]);
-                    break;
-                case UC_X86_REG_R11B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[11]);
-                    break;
-                case UC_X86_REG_R12:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[12]);
-                    break;
-                case UC_X86_REG_R12D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[12]);
-                    break;
-                case UC_X86_REG_R12W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[12]);
-                    break;
-                case UC_X86_REG_R12B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[12]);
-                    break;
-                case UC_X86_REG_R13:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[13]);
-                    break;
-                case UC_X86_REG_R13D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[13]);
-                    break;
-                case UC_X86_REG_R13W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[13]);
-                    break;
-                case UC_X86_REG_R13B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[13]);
-                    break;
-                case UC_X86_REG_R14:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[14]);
-                    break;
-                case UC_X86_REG_R14D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[14]);
-                    break;
-                case UC_X86_REG_R14W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[14]);
-                    break;
-                case UC_X86_REG_R14B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[14]);
-                    break;
-                case UC_X86_REG_R15:
-                    *(int64_t *)value = READ_QWORD(X86_CPU(uc, mycpu)->env.regs[15]);
-                    break;
-                case UC_X86_REG_R15D:
-                    *(int32_t *)value = READ_DWORD(X86_CPU(uc, mycpu)->env.regs[15]);
-                    break;
-                case UC_X86_REG_R15W:
-                    *(int16_t *)value = READ_WORD(X86_CPU(uc, mycpu)->env.regs[15]);
-                    break;
-                case UC_X86_REG_R15B:
-                    *(int8_t *)value = READ_BYTE_L(X86_CPU(uc, mycpu)->env.regs[15]);
-                    break;
-                case UC_X86_REG_IDTR:
-                    ((uc_x86_mmr *)value)->limit = (uint16_t)X86_CPU(uc, mycpu)->env.idt.limit;
-                    ((uc_x86_mmr *)value)->base = X86_CPU(uc, mycpu)->env.idt.base;
-                    break;
-                case UC_X86_REG_GDTR:
-                    ((uc_x86_mmr *)value)->limit = (uint16_t)X86_CPU(uc, mycpu)->env.gdt.limit;
-                    ((uc_x86_mmr *)value)->base = X86_CPU(uc, mycpu)->env.gdt.base;
-                    break;
-                case UC_X86_REG_LDTR:
-                    ((uc_x86_mmr *)value)->limit = X86_CPU(uc, mycpu)->env.ldt.limit;
-                    ((uc_x86_mmr *)value)->base = X86_CPU(uc, mycpu)->env.ldt.base;
-                    ((uc_x86_mmr *)value)->selector = (uint16_t)X86_CPU(uc, mycpu)->env.ldt.selector;
-                    ((uc_x86_mmr *)value)->flags = X86_CPU(uc, mycpu)->env.ldt.flags;
-                    break;
-                case UC_X86_REG_TR:
-                    ((uc_x86_mmr *)value)->limit = X86_CPU(uc, mycpu)->env.tr.limit;
-                    ((uc_x86_mmr *)value)->base = X86_CPU(uc, mycpu)->env.tr.base;
-                    ((uc_x86_mmr *)value)->selector = (uint16_t)X86_CPU(uc, mycpu)->env.tr.selector;
-                    ((uc_x86_mmr *)value)->flags = X86_CPU(uc, mycpu)->env.tr.flags;
-                    break;
+            if (uc->mode & UC_MODE_64) {
+                *(int64_t *)value = env->dr[regid - UC_X86_REG_DR0];
+                return 0;
+            }
+#endif
+            *(int32_t *)value = env->dr[regid - UC_X86_REG_DR0];
+            return 0;
+        case UC_X86_REG_IDTR:
+            ((uc_x86_mmr *)value)->limit = (uint16_t)env->idt.limit;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                ((uc_x86_mmr *)value)->base = env->idt.base;
+                return 0;
             }
-            break;
 #endif
+            ((uc_x86_mmr *)value)->base = (uint32_t)env->idt.base;
+            return 0;
+        case UC_X86_REG_GDTR:
+            ((uc_x86_mmr *)value)->limit = (uint16_t)env->gdt.limit;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                ((uc_x86_mmr *)value)->base = env->gdt.base;
+                return 0;
+            }
+#endif
+            ((uc_x86_mmr *)value)->base = (uint32_t)env->gdt.base;
+            return 0;
+        case UC_X86_REG_LDTR:
+            ((uc_x86_mmr *)value)->limit = env->ldt.limit;
+            ((uc_x86_mmr *)value)->selector = (uint16_t)env->ldt.selector;
+            ((uc_x86_mmr *)value)->flags = env->ldt.flags;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                ((uc_x86_mmr *)value)->base = env->ldt.base;
+                return 0;
+            }
+#endif
+            ((uc_x86_mmr *)value)->base = (uint32_t)env->ldt.base;
+            return 0;
+        case UC_X86_REG_TR:
+            ((uc_x86_mmr *)value)->limit = env->tr.limit;
+            ((uc_x86_mmr *)value)->selector = (uint16_t)env->tr.selector;
+            ((uc_x86_mmr *)value)->flags = env->tr.flags;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                ((uc_x86_mmr *)value)->base = env->tr.base;
+                return 0;
+            }
+#endif
+            ((uc_x86_mmr *)value)->base = (uint32_t)env->tr.base;
+            return 0;
+        case UC_X86_REG_XSTATE:
+            x86_xstate_read(env, (uc_x86_xstate *)value);
+            return 0;
     }
 
+    // everything else is a bounds check plus a field extraction
+    if (regid >= UC_X86_REG_ENDING || x86_regmap[regid].size == 0) {
+        return 0;
+    }
+    d = &x86_regmap[regid];
+    if (d->fsize == 8) {
+        v = *(uint64_t *)((char *)env + d->offset);
+    } else {
+        v = *(uint32_t *)((char *)env + d->offset);
+    }
+    v >>= d->shift;
+    switch(d->size) {
+        case 1: *(uint8_t *)value = (uint8_t)v; break;
+        case 2: *(uint16_t *)value = (uint16_t)v; break;
+        case 4: *(uint32_t *)value = (uint32_t)v; break;
+        case 8: *(uint64_t *)value = v; break;
+    }
 
     return 0;
 }
 
 int x86_reg_write(struct uc_struct *uc, unsigned int regid, const void *value)
 {
-    CPUState *mycpu = first_cpu;
+    CPUX86State *env = &(X86_CPU(uc, first_cpu)->env);
+    const RegDesc *d;
+    uint64_t v, old, mask;
+    char *p;
 
-    switch(uc->mode) {
+    // the few registers whose width or layout depends on the current mode
+    switch(regid) {
         default:
             break;
-
-        case UC_MODE_16:
-            switch(regid) {
-                default: break;
-                case UC_X86_REG_ES:
-                    X86_CPU(uc, mycpu)->env.segs[R_ES].selector = *(uint16_t *)value;
-                    return 0;
-                case UC_X86_REG_SS:
-                    X86_CPU(uc, mycpu)->env.segs[R_SS].selector = *(uint16_t *)value;
-                    return 0;
-                case UC_X86_REG_DS:
-                    X86_CPU(uc, mycpu)->env.segs[R_DS].selector = *(uint16_t *)value;
-                    return 0;
-                case UC_X86_REG_FS:
-                    X86_CPU(uc, mycpu)->env.segs[R_FS].selector = *(uint16_t *)value;
-                    return 0;
-                case UC_X86_REG_GS:
-                    X86_CPU(uc, mycpu)->env.segs[R_GS].selector = *(uint16_t *)value;
-                    return 0;
+        case UC_X86_REG_EFLAGS:
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                env->eflags = *(uint64_t *)value;
+            } else
+#endif
+            {
+                env->eflags = *(uint32_t *)value;
             }
-            // fall-thru
-        case UC_MODE_32:
-            switch(regid) {
-                default:
-                    break;
-                case UC_X86_REG_CR0 ... UC_X86_REG_CR4:
-                    X86_CPU(uc, mycpu)->env.cr[regid - UC_X86_REG_CR0] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_DR0 ... UC_X86_REG_DR7:
-                    X86_CPU(uc, mycpu)->env.dr[regid - UC_X86_REG_DR0] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_EFLAGS:
-                    X86_CPU(uc, mycpu)->env.eflags = *(uint32_t *)value;
-                    X86_CPU(uc, mycpu)->env.eflags0 = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_EAX:
-                    X86_CPU(uc, mycpu)->env.regs[R_EAX] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_AX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EAX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_AH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EAX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_AL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EAX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_EBX:
-                    X86_CPU(uc, mycpu)->env.regs[R_EBX] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_BX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_BH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EBX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_BL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EBX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_ECX:
-                    X86_CPU(uc, mycpu)->env.regs[R_ECX] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_CX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_ECX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_CH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_ECX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_CL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ECX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_EDX:
-                    X86_CPU(uc, mycpu)->env.regs[R_EDX] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_DX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_DH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EDX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_DL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EDX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_ESP:
-                    X86_CPU(uc, mycpu)->env.regs[R_ESP] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_SP:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESP], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_EBP:
-                    X86_CPU(uc, mycpu)->env.regs[R_EBP] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_BP:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBP], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_ESI:
-                    X86_CPU(uc, mycpu)->env.regs[R_ESI] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_SI:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESI], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_EDI:
-                    X86_CPU(uc, mycpu)->env.regs[R_EDI] = *(uint32_t *)value;
-                    break;
-                case UC_X86_REG_DI:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDI], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_EIP:
-                    X86_CPU(uc, mycpu)->env.eip = *(uint32_t *)value;
-                    // force to quit execution and flush TB
-                    uc->quit_request = true;
-                    uc_emu_stop(uc);
-                    break;
-                case UC_X86_REG_IP:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.eip, *(uint16_t *)value);
-                    // force to quit execution and flush TB
-                    uc->quit_request = true;
-                    uc_emu_stop(uc);
-                    break;
-                case UC_X86_REG_CS:
-                    X86_CPU(uc, mycpu)->env.segs[R_CS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_DS:
-                    X86_CPU(uc, mycpu)->env.segs[R_DS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_SS:
-                    X86_CPU(uc, mycpu)->env.segs[R_SS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_ES:
-                    X86_CPU(uc, mycpu)->env.segs[R_ES].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_FS:
-                    X86_CPU(uc, mycpu)->env.segs[R_FS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_GS:
-                    X86_CPU(uc, mycpu)->env.segs[R_GS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_IDTR:
-                    X86_CPU(uc, mycpu)->env.idt.limit = (uint16_t)((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.idt.base = (uint32_t)((uc_x86_mmr *)value)->base;
-                    break;
-                case UC_X86_REG_GDTR:
-                    X86_CPU(uc, mycpu)->env.gdt.limit = (uint16_t)((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.gdt.base = (uint32_t)((uc_x86_mmr *)value)->base;
-                    break;
-                case UC_X86_REG_LDTR:
-                    X86_CPU(uc, mycpu)->env.ldt.limit = ((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.ldt.base = (uint32_t)((uc_x86_mmr *)value)->base;
-                    X86_CPU(uc, mycpu)->env.ldt.selector = (uint16_t)((uc_x86_mmr *)value)->selector;
-                    X86_CPU(uc, mycpu)->env.ldt.flags = ((uc_x86_mmr *)value)->flags;
-                    break;
-                case UC_X86_REG_TR:
-                    X86_CPU(uc, mycpu)->env.tr.limit = ((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.tr.base = (uint32_t)((uc_x86_mmr *)value)->base;
-                    X86_CPU(uc, mycpu)->env.tr.selector = (uint16_t)((uc_x86_mmr *)value)->selector;
-                    X86_CPU(uc, mycpu)->env.tr.flags = ((uc_x86_mmr *)value)->flags;
-                    break;
+            env->eflags0 = env->eflags;
+            return 0;
+        case UC_X86_REG_CR0 ... UC_X86_REG_CR4:
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                env->cr[regid - UC_X86_REG_CR0] = *(uint64_t *)value;
+                return 0;
             }
-            break;
-
+#endif
+            env->cr[regid - UC_X86_REG_CR0] = *(uint32_t *)value;
+            return 0;
+        case UC_X86_REG_DR0 ... UC_X86_REG_DR7:
 #ifdef TARGET_X86_64
-        case UC_MODE_64:
-            switch(regid) {
-                default:
-                    break;
-                case UC_X86_REG_CR0 ... UC_X86_REG_CR4:
-                    X86_CPU(uc, mycpu)->env.cr[regid - UC_X86_REG_CR0] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_DR0 ... UC_X86_REG_DR7:
-                    X86_CPU(uc, mycpu)->env.dr[regid - UC_X86_REG_DR0] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_EFLAGS:
-                    X86_CPU(uc, mycpu)->env.eflags = *(uint64_t *)value;
-                    X86_CPU(uc, mycpu)->env.eflags0 = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_RAX:
-                    X86_CPU(uc, mycpu)->env.regs[R_EAX] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_EAX:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EAX], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_AX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EAX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_AH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EAX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_AL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EAX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RBX:
-                    X86_CPU(uc, mycpu)->env.regs[R_EBX] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_EBX:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EBX], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_BX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_BH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EBX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_BL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EBX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RCX:
-                    X86_CPU(uc, mycpu)->env.regs[R_ECX] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_ECX:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_ECX], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_CX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_ECX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_CH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_ECX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_CL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ECX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RDX:
-                    X86_CPU(uc, mycpu)->env.regs[R_EDX] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_EDX:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EDX], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_DX:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDX], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_DH:
-                    WRITE_BYTE_H(X86_CPU(uc, mycpu)->env.regs[R_EDX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_DL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EDX], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RSP:
-                    X86_CPU(uc, mycpu)->env.regs[R_ESP] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_ESP:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_ESP], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_SP:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESP], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_SPL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ESP], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RBP:
-                    X86_CPU(uc, mycpu)->env.regs[R_EBP] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_EBP:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EBP], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_BP:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EBP], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_BPL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EBP], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RSI:
-                    X86_CPU(uc, mycpu)->env.regs[R_ESI] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_ESI:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_ESI], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_SI:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_ESI], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_SIL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_ESI], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RDI:
-                    X86_CPU(uc, mycpu)->env.regs[R_EDI] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_EDI:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[R_EDI], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_DI:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[R_EDI], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_DIL:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[R_EDI], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_RIP:
-                    X86_CPU(uc, mycpu)->env.eip = *(uint64_t *)value;
-                    // force to quit execution and flush TB
-                    uc->quit_request = true;
-                    uc_emu_stop(uc);
-                    break;
-                case UC_X86_REG_EIP:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.eip, *(uint32_t *)value);
-                    // force to quit execution and flush TB
-                    uc->quit_request = true;
-                    uc_emu_stop(uc);
-                    break;
-                case UC_X86_REG_IP:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.eip, *(uint16_t *)value);
-                    // force to quit execution and flush TB
-                    uc->quit_request = true;
-                    uc_emu_stop(uc);
-                    break;
-                case UC_X86_REG_CS:
-                    X86_CPU(uc, mycpu)->env.segs[R_CS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_DS:
-                    X86_CPU(uc, mycpu)->env.segs[R_DS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_SS:
-                    X86_CPU(uc, mycpu)->env.segs[R_SS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_ES:
-                    X86_CPU(uc, mycpu)->env.segs[R_ES].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_FS:
-                    X86_CPU(uc, mycpu)->env.segs[R_FS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_GS:
-                    X86_CPU(uc, mycpu)->env.segs[R_GS].selector = *(uint16_t *)value;
-                    break;
-                case UC_X86_REG_R8:
-                    X86_CPU(uc, mycpu)->env.regs[8] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R8D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[8], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R8W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[8], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R8B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[8], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_R9:
-                    X86_CPU(uc, mycpu)->env.regs[9] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R9D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[9], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R9W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[9], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R9B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[9], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_R10:
-                    X86_CPU(uc, mycpu)->env.regs[10] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R10D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[10], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R10W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[10], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R10B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[10], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_R11:
-                    X86_CPU(uc, mycpu)->env.regs[11] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R11D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[11], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R11W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[11], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R11B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[11], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_R12:
-                    X86_CPU(uc, mycpu)->env.regs[12] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R12D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[12], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R12W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[12], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R12B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[12], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_R13:
-                    X86_CPU(uc, mycpu)->env.regs[13] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R13D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[13], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R13W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[13], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R13B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[13], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_R14:
-                    X86_CPU(uc, mycpu)->env.regs[14] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R14D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[14], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R14W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[14], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R14B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[14], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_R15:
-                    X86_CPU(uc, mycpu)->env.regs[15] = *(uint64_t *)value;
-                    break;
-                case UC_X86_REG_R15D:
-                    WRITE_DWORD(X86_CPU(uc, mycpu)->env.regs[15], *(uint32_t *)value);
-                    break;
-                case UC_X86_REG_R15W:
-                    WRITE_WORD(X86_CPU(uc, mycpu)->env.regs[15], *(uint16_t *)value);
-                    break;
-                case UC_X86_REG_R15B:
-                    WRITE_BYTE_L(X86_CPU(uc, mycpu)->env.regs[15], *(uint8_t *)value);
-                    break;
-                case UC_X86_REG_IDTR:
-                    X86_CPU(uc, mycpu)->env.idt.limit = (uint16_t)((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.idt.base = ((uc_x86_mmr *)value)->base;
-                    break;
-                case UC_X86_REG_GDTR:
-                    X86_CPU(uc, mycpu)->env.gdt.limit = (uint16_t)((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.gdt.base = ((uc_x86_mmr *)value)->base;
-                    break;
-                case UC_X86_REG_LDTR:
-                    X86_CPU(uc, mycpu)->env.ldt.limit = ((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.ldt.base = ((uc_x86_mmr *)value)->base;
-                    X86_CPU(uc, mycpu)->env.ldt.selector = (uint16_t)((uc_x86_mmr *)value)->selector;
-                    X86_CPU(uc, mycpu)->env.ldt.flags = ((uc_x86_mmr *)value)->flags;
-                    break;
-                case UC_X86_REG_TR:
-                    X86_CPU(uc, mycpu)->env.tr.limit = ((uc_x86_mmr *)value)->limit;
-                    X86_CPU(uc, mycpu)->env.tr.base = ((uc_x86_mmr *)value)->base;
-                    X86_CPU(uc, mycpu)->env.tr.selector = (uint16_t)((uc_x86_mmr *)value)->selector;
-                    X86_CPU(uc, mycpu)->env.tr.flags = ((uc_x86_mmr *)value)->flags;
-                    break;
+            if (uc->mode & UC_MODE_64) {
+                env->dr[regid - UC_X86_REG_DR0] = *(uint64_t *)value;
+                return 0;
             }
+#endif
+            env->dr[regid - UC_X86_REG_DR0] = *(uint32_t *)value;
+            return 0;
+        case UC_X86_REG_IDTR:
+            env->idt.limit = (uint16_t)((uc_x86_mmr *)value)->limit;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                env->idt.base = ((uc_x86_mmr *)value)->base;
+                return 0;
+            }
+#endif
+            env->idt.base = (uint32_t)((uc_x86_mmr *)value)->base;
+            return 0;
+        case UC_X86_REG_GDTR:
+            env->gdt.limit = (uint16_t)((uc_x86_mmr *)value)->limit;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                env->gdt.base = ((uc_x86_mmr *)value)->base;
+                return 0;
+            }
+#endif
+            env->gdt.base = (uint32_t)((uc_x86_mmr *)value)->base;
+            return 0;
+        case UC_X86_REG_LDTR:
+            env->ldt.limit = ((uc_x86_mmr *)value)->limit;
+            env->ldt.selector = (uint16_t)((uc_x86_mmr *)value)->selector;
+            env->ldt.flags = ((uc_x86_mmr *)value)->flags;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                env->ldt.base = ((uc_x86_mmr *)value)->base;
+                return 0;
+            }
+#endif
+            env->ldt.base = (uint32_t)((uc_x86_mmr *)value)->base;
+            return 0;
+        case UC_X86_REG_TR:
+            env->tr.limit = ((uc_x86_mmr *)value)->limit;
+            env->tr.selector = (uint16_t)((uc_x86_mmr *)value)->selector;
+            env->tr.flags = ((uc_x86_mmr *)value)->flags;
+#ifdef TARGET_X86_64
+            if (uc->mode & UC_MODE_64) {
+                env->tr.base = ((uc_x86_mmr *)value)->base;
+                return 0;
+            }
+#endif
+            env->tr.base = (uint32_t)((uc_x86_mmr *)value)->base;
+            return 0;
+        case UC_X86_REG_XSTATE:
+            x86_xstate_write(env, (const uc_x86_xstate *)value);
+            return 0;
+    }
+
+    if (regid >= UC_X86_REG_ENDING || x86_regmap[regid].size == 0) {
+        return 0;
+    }
+    d = &x86_regmap[regid];
+    p = (char *)env + d->offset;
+    switch(d->size) {
+        default: return 0;
+        case 1: v = *(uint8_t *)value; break;
+        case 2: v = *(uint16_t *)value; break;
+        case 4: v = *(uint32_t *)value; break;
+        case 8: v = *(uint64_t *)value; break;
+    }
+    if (d->size == d->fsize) {
+        old = v;
+    } else {
+        // partial-width alias: insert into the backing field and keep the
+        // remaining bits, matching the old WRITE_WORD/WRITE_BYTE_* behavior
+        mask = ((UINT64_C(1) << (d->size * 8)) - 1) << d->shift;
+        old = (d->fsize == 8) ? *(uint64_t *)p : *(uint32_t *)p;
+        old = (old & ~mask) | ((v << d->shift) & mask);
+    }
+    if (d->fsize == 8) {
+        *(uint64_t *)p = old;
+    } else {
+        *(uint32_t *)p = (uint32_t)old;
+    }
+
+    switch(regid) {
+        default:
             break;
+        case UC_X86_REG_IP:
+        case UC_X86_REG_EIP:
+#ifdef TARGET_X86_64
+        case UC_X86_REG_RIP:
 #endif
+            // force to quit execution and flush TB
+            uc->quit_request = true;
+            uc_emu_stop(uc);
+            break;
     }
 
     return 0;
@@ -1025,6 +535,41 @@ int x86_uc_machine_init(struct uc_struct *uc)
     return machine_initialize(uc);
 }
 
+static void x86_arch_state(struct uc_struct *uc, uc_arch_state *state)
+{
+    CPUArchState *env = first_cpu->env_ptr;
+
+    state->reg_count = CPU_NB_REGS;
+    state->reg_bytes = sizeof(env->regs[0]);
+    state->flags_bytes = sizeof(env->eflags);
+    state->regs = env->regs;
+    state->pc = &env->eip;
+    state->flags = &env->eflags;
+}
+
+// create one more vCPU like pc_cpus_init() does, with the next APIC id
+static int x86_vcpu_add(struct uc_struct *uc)
+{
+    X86CPU *cpu;
+    Error *local_err = NULL;
+
+    cpu = cpu_x86_create(uc, "qemu64", &local_err);
+    if (local_err != NULL) {
+        error_free(local_err);
+        return -1;
+    }
+
+    object_property_set_int(uc, OBJECT(cpu), uc->vcpu_count, "apic-id",
+                            &local_err);
+    object_property_set_bool(uc, OBJECT(cpu), true, "realized", &local_err);
+    if (local_err != NULL) {
+        error_free(local_err);
+        object_unref(uc, OBJECT(cpu));
+        return -1;
+    }
+    return 0;
+}
+
 static bool x86_stop_interrupt(int intno)
 {
     switch(intno) {
@@ -1052,5 +597,7 @@ void x86_uc_init(struct uc_struct* uc)
     uc->release = x86_release;
     uc->set_pc = x86_set_pc;
     uc->stop_interrupt = x86_stop_interrupt;
+    uc->arch_state = x86_arch_state;
+    uc->vcpu_add = x86_vcpu_add;
     uc_common_init(uc);
 }
@@ -80,5 +80,6 @@ int m68k_cpu_gdb_write_register(CPUState *cpu, uint8_t *buf, int reg);
 
 void m68k_cpu_exec_enter(CPUState *cs);
 void m68k_cpu_exec_exit(CPUState *cs);
+void m68k_cpu_set_pc(CPUState *cs, vaddr value);
 
 #endif
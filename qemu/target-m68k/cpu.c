@@ -23,7 +23,7 @@
 #include "qemu-common.h"
 
 
-static void m68k_cpu_set_pc(CPUState *cs, vaddr value)
+void m68k_cpu_set_pc(CPUState *cs, vaddr value)
 {
     M68kCPU *cpu = M68K_CPU(cs->uc, cs);
 
@@ -166,7 +166,9 @@ static void m68k_cpu_initfn(struct uc_struct *uc, Object *obj, void *opaque)
     CPUM68KState *env = &cpu->env;
 
     cs->env_ptr = env;
-    cpu_exec_init(env, opaque);
+    /* the type graph may be shared between instances (see type_table_attach):
+       use the opening engine, not the userdata of whoever registered the type */
+    cpu_exec_init(env, uc);
 
     if (tcg_enabled(uc)) {
         m68k_tcg_init(uc);
@@ -216,7 +218,6 @@ void m68k_cpu_register_types(void *opaque)
     TypeInfo m68k_cpu_type_info = {
         .name = TYPE_M68K_CPU,
         .parent = TYPE_CPU,
-        .instance_userdata = opaque,
         .instance_size = sizeof(M68kCPU),
         .instance_init = m68k_cpu_initfn,
         .abstract = true,
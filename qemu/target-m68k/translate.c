@@ -672,14 +672,170 @@ static TCGv gen_ea(CPUM68KState *env, DisasContext *s, uint16_t insn,
     return *(TCGv *)tcg_ctx->NULL_QREG;
 }
 
+// Unicorn: branch on the lazy flag operands directly when the pending
+// CC_OP allows it, instead of materializing CVZN through
+// helper_flush_flags() before every conditional.  Returns false when the
+// caller must flush; the branch has been emitted on success.
+static bool gen_jmpcc_fast(DisasContext *s, int cond, int l1)
+{
+    TCGContext *tcg_ctx = s->uc->tcg_ctx;
+    TCGv dest = *(TCGv *)tcg_ctx->QREG_CC_DEST;
+    TCGv src = *(TCGv *)tcg_ctx->QREG_CC_SRC;
+    TCGv t0, t1;
+    TCGCond tcond;
+
+    switch (cond) {
+    case 0: /* T */
+        tcg_gen_br(tcg_ctx, l1);
+        return true;
+    case 1: /* F */
+        return true;
+    default:
+        break;
+    }
+
+    switch (s->cc_op) {
+    case CC_OP_LOGIC:
+        // N and Z come from the result; C and V are known zero
+        switch (cond) {
+        case 2: /* HI: !C && !Z, so just !Z */
+        case 6: /* NE */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_NE, dest, 0, l1);
+            return true;
+        case 3: /* LS: C || Z, so just Z */
+        case 7: /* EQ */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_EQ, dest, 0, l1);
+            return true;
+        case 4: /* CC */
+        case 8: /* VC */
+            tcg_gen_br(tcg_ctx, l1);
+            return true;
+        case 5: /* CS */
+        case 9: /* VS */
+            return true;
+        case 10: /* PL */
+        case 12: /* GE: !(N ^ V), so just !N */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_GE, dest, 0, l1);
+            return true;
+        case 11: /* MI */
+        case 13: /* LT: N ^ V, so just N */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_LT, dest, 0, l1);
+            return true;
+        case 14: /* GT: !Z && !N */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_GT, dest, 0, l1);
+            return true;
+        case 15: /* LE: Z || N */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_LE, dest, 0, l1);
+            return true;
+        }
+        return false;
+
+    case CC_OP_SUB:
+    case CC_OP_CMPB:
+    case CC_OP_CMPW:
+        // CC_DEST holds first_op - second_op and CC_SRC the second
+        // operand, so every operand-ordering condition is a single
+        // comparison of the reconstructed first operand against CC_SRC
+        // at the operation width
+        switch (cond) {
+        case 2:  tcond = TCG_COND_GTU; break; /* HI */
+        case 3:  tcond = TCG_COND_LEU; break; /* LS */
+        case 4:  tcond = TCG_COND_GEU; break; /* CC */
+        case 5:  tcond = TCG_COND_LTU; break; /* CS */
+        case 6:  tcond = TCG_COND_NE;  break; /* NE */
+        case 7:  tcond = TCG_COND_EQ;  break; /* EQ */
+        case 12: tcond = TCG_COND_GE;  break; /* GE */
+        case 13: tcond = TCG_COND_LT;  break; /* LT */
+        case 14: tcond = TCG_COND_GT;  break; /* GT */
+        case 15: tcond = TCG_COND_LE;  break; /* LE */
+        case 10: /* PL */
+        case 11: /* MI */
+            // N is the sign of the result at the operation width
+            t0 = tcg_temp_new(tcg_ctx);
+            if (s->cc_op == CC_OP_CMPB) {
+                tcg_gen_ext8s_i32(tcg_ctx, t0, dest);
+            } else if (s->cc_op == CC_OP_CMPW) {
+                tcg_gen_ext16s_i32(tcg_ctx, t0, dest);
+            } else {
+                tcg_gen_mov_i32(tcg_ctx, t0, dest);
+            }
+            tcg_gen_brcondi_i32(tcg_ctx,
+                                cond == 11 ? TCG_COND_LT : TCG_COND_GE,
+                                t0, 0, l1);
+            tcg_temp_free(tcg_ctx, t0);
+            return true;
+        default: /* VC/VS */
+            return false;
+        }
+        t0 = tcg_temp_new(tcg_ctx);
+        tcg_gen_add_i32(tcg_ctx, t0, dest, src);
+        if (s->cc_op == CC_OP_SUB) {
+            tcg_gen_brcond_i32(tcg_ctx, tcond, t0, src, l1);
+        } else {
+            t1 = tcg_temp_new(tcg_ctx);
+            if (is_unsigned_cond(tcond) || tcond == TCG_COND_EQ
+                || tcond == TCG_COND_NE) {
+                if (s->cc_op == CC_OP_CMPB) {
+                    tcg_gen_ext8u_i32(tcg_ctx, t0, t0);
+                    tcg_gen_ext8u_i32(tcg_ctx, t1, src);
+                } else {
+                    tcg_gen_ext16u_i32(tcg_ctx, t0, t0);
+                    tcg_gen_ext16u_i32(tcg_ctx, t1, src);
+                }
+            } else {
+                if (s->cc_op == CC_OP_CMPB) {
+                    tcg_gen_ext8s_i32(tcg_ctx, t0, t0);
+                    tcg_gen_ext8s_i32(tcg_ctx, t1, src);
+                } else {
+                    tcg_gen_ext16s_i32(tcg_ctx, t0, t0);
+                    tcg_gen_ext16s_i32(tcg_ctx, t1, src);
+                }
+            }
+            tcg_gen_brcond_i32(tcg_ctx, tcond, t0, t1, l1);
+            tcg_temp_free(tcg_ctx, t1);
+        }
+        tcg_temp_free(tcg_ctx, t0);
+        return true;
+
+    case CC_OP_ADD:
+        // CC_DEST holds the result and CC_SRC one addend; only the
+        // conditions that avoid V can be recovered directly
+        switch (cond) {
+        case 4: /* CC: the sum carried iff it is below either addend */
+            tcg_gen_brcond_i32(tcg_ctx, TCG_COND_GEU, dest, src, l1);
+            return true;
+        case 5: /* CS */
+            tcg_gen_brcond_i32(tcg_ctx, TCG_COND_LTU, dest, src, l1);
+            return true;
+        case 6: /* NE */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_NE, dest, 0, l1);
+            return true;
+        case 7: /* EQ */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_EQ, dest, 0, l1);
+            return true;
+        case 10: /* PL */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_GE, dest, 0, l1);
+            return true;
+        case 11: /* MI */
+            tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_LT, dest, 0, l1);
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
 /* This generates a conditional branch, clobbering all temporaries.  */
 static void gen_jmpcc(DisasContext *s, int cond, int l1)
 {
     TCGContext *tcg_ctx = s->uc->tcg_ctx;
     TCGv tmp;
 
-    /* TODO: Optimize compare/branch pairs rather than always flushing
-       flag state to CC_OP_FLAGS.  */
+    if (gen_jmpcc_fast(s, cond, l1)) {
+        return;
+    }
+    /* CC_OP_DYNAMIC, the X-carrying ops and the overflow conditions
+       still materialize the flags.  */
     gen_flush_flags(s);
     switch (cond) {
     case 0: /* T */
@@ -3044,7 +3200,7 @@ static void disas_m68k_insn(CPUM68KState * env, DisasContext *s)
 
     // Unicorn: trace this instruction on request
     if (HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_CODE, s->pc)) {
-        gen_uc_tracecode(tcg_ctx, 2, UC_HOOK_CODE_IDX, env->uc, s->pc);
+        gen_uc_tracecode(tcg_ctx, 2, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), s->pc);
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
     }
@@ -3096,9 +3252,13 @@ gen_intermediate_code_internal(M68kCPU *cpu, TranslationBlock *tb,
     if (max_insns == 0)
         max_insns = CF_COUNT_MASK;
 
+    // Unicorn: engine-wide cap on instructions per block
+    if (env->uc->tb_max_insns && max_insns > env->uc->tb_max_insns)
+        max_insns = env->uc->tb_max_insns;
+
     // Unicorn: early check to see if the address of this block is the until address
     if (tb->pc == env->uc->addr_end) {
-        gen_tb_start(tcg_ctx);
+        gen_tb_start(tcg_ctx, tb);
         gen_exception(dc, dc->pc, EXCP_HLT);
         goto done_generating;
     }
@@ -3109,10 +3269,13 @@ gen_intermediate_code_internal(M68kCPU *cpu, TranslationBlock *tb,
     if (!env->uc->block_full && HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_BLOCK, pc_start)) {
         // save block address to see if we need to patch block size later
         env->uc->block_addr = pc_start;
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, env->uc, pc_start);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, offsetof(CPUArchState, uc), pc_start);
     }
 
-    gen_tb_start(tcg_ctx);
+    // Unicorn: update the edge coverage bitmap for this block
+    UC_GEN_COVERAGE(tcg_ctx, env->uc, pc_start);
+
+    gen_tb_start(tcg_ctx, tb);
     do {
         pc_offset = dc->pc - pc_start;
         if (unlikely(!QTAILQ_EMPTY(&cs->breakpoints))) {
@@ -69,6 +69,12 @@ int m68k_reg_write(struct uc_struct *uc, unsigned int regid, const void *value)
     return 0;
 }
 
+// create one more vCPU of the model dummy_m68k_init() uses
+static int m68k_vcpu_add(struct uc_struct *uc)
+{
+    return cpu_m68k_init(uc, "cfv4e") == NULL ? -1 : 0;
+}
+
 __attribute__ ((visibility ("default")))
 void m68k_uc_init(struct uc_struct* uc)
 {
@@ -79,5 +85,6 @@ void m68k_uc_init(struct uc_struct* uc)
     uc->reg_write = m68k_reg_write;
     uc->reg_reset = m68k_reg_reset;
     uc->set_pc = m68k_set_pc;
+    uc->vcpu_add = m68k_vcpu_add;
     uc_common_init(uc);
 }
@@ -76,6 +76,7 @@ static inline MIPSCPU *mips_env_get_cpu(CPUMIPSState *env)
 
 void mips_cpu_do_interrupt(CPUState *cpu);
 bool mips_cpu_exec_interrupt(CPUState *cpu, int int_req);
+void mips_cpu_synchronize_from_tb(CPUState *cpu, struct TranslationBlock *tb);
 hwaddr mips_cpu_get_phys_page_debug(CPUState *cpu, vaddr addr);
 int mips_cpu_gdb_read_register(CPUState *cpu, uint8_t *buf, int reg);
 int mips_cpu_gdb_write_register(CPUState *cpu, uint8_t *buf, int reg);
@@ -38,7 +38,7 @@ static void mips_cpu_set_pc(CPUState *cs, vaddr value)
     }
 }
 
-static void mips_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
+void mips_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
 {
     MIPSCPU *cpu = MIPS_CPU(cs->uc, cs);
     CPUMIPSState *env = &cpu->env;
@@ -112,7 +112,9 @@ static void mips_cpu_initfn(struct uc_struct *uc, Object *obj, void *opaque)
     CPUMIPSState *env = &cpu->env;
 
     cs->env_ptr = env;
-    cpu_exec_init(env, opaque);
+    /* the type graph may be shared between instances (see type_table_attach):
+       use the opening engine, not the userdata of whoever registered the type */
+    cpu_exec_init(env, uc);
 
     if (tcg_enabled(uc)) {
         mips_tcg_init(uc);
@@ -150,7 +152,6 @@ void mips_cpu_register_types(void *opaque)
     const TypeInfo mips_cpu_type_info = {
         .name = TYPE_MIPS_CPU,
         .parent = TYPE_CPU,
-        .instance_userdata = opaque,
         .instance_size = sizeof(MIPSCPU),
         .instance_init = mips_cpu_initfn,
         .abstract = false,
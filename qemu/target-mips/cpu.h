@@ -39,10 +39,16 @@ struct r4k_tlb_t {
 };
 
 #if !defined(CONFIG_USER_ONLY)
+// direct-mapped hint over the r4k TLB, see r4k_map_address()
+#define MIPS_TLB_HINT_SIZE 256
+
 typedef struct CPUMIPSTLBContext CPUMIPSTLBContext;
 struct CPUMIPSTLBContext {
     uint32_t nb_tlb;
     uint32_t tlb_in_use;
+    // last matching TLB index + 1 per hashed VPN/ASID, 0 when empty;
+    // re-validated on use, so guest TLB writes need not clear it
+    uint8_t lookup_hint[MIPS_TLB_HINT_SIZE];
     int (*map_address) (struct CPUMIPSState *env, hwaddr *physical, int *prot, target_ulong address, int rw, int access_type);
     void (*helper_tlbwi)(struct CPUMIPSState *env);
     void (*helper_tlbwr)(struct CPUMIPSState *env);
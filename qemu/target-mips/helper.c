@@ -65,45 +65,83 @@ int fixed_mmu_map_address (CPUMIPSState *env, hwaddr *physical, int *prot,
     return TLBRET_MATCH;
 }
 
+/* positive sentinel for "entry does not cover this access"; all TLBRET_*
+   codes are <= 0 */
+#define TLB_LOOKUP_NO_ENTRY 1
+
+static inline int r4k_tlb_lookup_one(CPUMIPSState *env, const r4k_tlb_t *tlb,
+                                     hwaddr *physical, int *prot,
+                                     target_ulong address, int rw,
+                                     uint8_t ASID)
+{
+    /* 1k pages are not supported. */
+    target_ulong mask = tlb->PageMask | ~(TARGET_PAGE_MASK << 1);
+    target_ulong tag = address & ~mask;
+    target_ulong VPN = tlb->VPN & ~mask;
+#if defined(TARGET_MIPS64)
+    tag &= env->SEGMask;
+#endif
+
+    /* Check ASID, virtual page number & size */
+    if ((tlb->G == 1 || tlb->ASID == ASID) && VPN == tag && !tlb->EHINV) {
+        /* TLB match */
+        int n = !!(address & mask & ~(mask >> 1));
+        /* Check access rights */
+        if (!(n ? tlb->V1 : tlb->V0)) {
+            return TLBRET_INVALID;
+        }
+        if (rw == MMU_INST_FETCH && (n ? tlb->XI1 : tlb->XI0)) {
+            return TLBRET_XI;
+        }
+        if (rw == MMU_DATA_LOAD && (n ? tlb->RI1 : tlb->RI0)) {
+            return TLBRET_RI;
+        }
+        if (rw != MMU_DATA_STORE || (n ? tlb->D1 : tlb->D0)) {
+            *physical = tlb->PFN[n] | (address & (mask >> 1));
+            *prot = PAGE_READ;
+            if (n ? tlb->D1 : tlb->D0)
+                *prot |= PAGE_WRITE;
+            return TLBRET_MATCH;
+        }
+        return TLBRET_DIRTY;
+    }
+    return TLB_LOOKUP_NO_ENTRY;
+}
+
+static inline uint32_t r4k_tlb_hint_slot(target_ulong address, uint8_t ASID)
+{
+    return ((uint32_t)(address >> (TARGET_PAGE_BITS + 1)) ^ ASID) &
+           (MIPS_TLB_HINT_SIZE - 1);
+}
+
 /* MIPS32/MIPS64 R4000-style MMU emulation */
 int r4k_map_address (CPUMIPSState *env, hwaddr *physical, int *prot,
                      target_ulong address, int rw, int access_type)
 {
     uint8_t ASID = env->CP0_EntryHi & 0xFF;
-    int i;
+    uint32_t slot = r4k_tlb_hint_slot(address, ASID);
+    int idx = (int)env->tlb->lookup_hint[slot] - 1;
+    int i, ret;
+
+    // Unicorn: every softmmu refill used to rescan the whole guest TLB.
+    // A direct-mapped hint remembers which entry matched a VPN/ASID last
+    // time; since the hint is checked against the live entry before use,
+    // guest TLB writes need no invalidation work - a stale hint just
+    // falls through to the scan below.
+    if (idx >= 0 && idx < env->tlb->tlb_in_use) {
+        ret = r4k_tlb_lookup_one(env, &env->tlb->mmu.r4k.tlb[idx], physical,
+                                 prot, address, rw, ASID);
+        if (ret != TLB_LOOKUP_NO_ENTRY) {
+            return ret;
+        }
+    }
 
     for (i = 0; i < env->tlb->tlb_in_use; i++) {
-        r4k_tlb_t *tlb = &env->tlb->mmu.r4k.tlb[i];
-        /* 1k pages are not supported. */
-        target_ulong mask = tlb->PageMask | ~(TARGET_PAGE_MASK << 1);
-        target_ulong tag = address & ~mask;
-        target_ulong VPN = tlb->VPN & ~mask;
-#if defined(TARGET_MIPS64)
-        tag &= env->SEGMask;
-#endif
-
-        /* Check ASID, virtual page number & size */
-        if ((tlb->G == 1 || tlb->ASID == ASID) && VPN == tag && !tlb->EHINV) {
-            /* TLB match */
-            int n = !!(address & mask & ~(mask >> 1));
-            /* Check access rights */
-            if (!(n ? tlb->V1 : tlb->V0)) {
-                return TLBRET_INVALID;
-            }
-            if (rw == MMU_INST_FETCH && (n ? tlb->XI1 : tlb->XI0)) {
-                return TLBRET_XI;
-            }
-            if (rw == MMU_DATA_LOAD && (n ? tlb->RI1 : tlb->RI0)) {
-                return TLBRET_RI;
-            }
-            if (rw != MMU_DATA_STORE || (n ? tlb->D1 : tlb->D0)) {
-                *physical = tlb->PFN[n] | (address & (mask >> 1));
-                *prot = PAGE_READ;
-                if (n ? tlb->D1 : tlb->D0)
-                    *prot |= PAGE_WRITE;
-                return TLBRET_MATCH;
-            }
-            return TLBRET_DIRTY;
+        ret = r4k_tlb_lookup_one(env, &env->tlb->mmu.r4k.tlb[i], physical,
+                                 prot, address, rw, ASID);
+        if (ret != TLB_LOOKUP_NO_ENTRY) {
+            env->tlb->lookup_hint[slot] = i + 1;
+            return ret;
         }
     }
     return TLBRET_NOMATCH;
@@ -11344,7 +11344,7 @@ static int decode_mips16_opc (CPUMIPSState *env, DisasContext *ctx, bool *insn_n
 
     // Unicorn: trace this instruction on request
     if (HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_CODE, ctx->pc)) {
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_CODE_IDX, env->uc, ctx->pc);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), ctx->pc);
         *insn_need_patch = true;
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
@@ -13940,7 +13940,7 @@ static int decode_micromips_opc (CPUMIPSState *env, DisasContext *ctx, bool *ins
 
     // Unicorn: trace this instruction on request
     if (HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_CODE, ctx->pc)) {
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_CODE_IDX, env->uc, ctx->pc);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), ctx->pc);
         *insn_need_patch = true;
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
@@ -18500,7 +18500,7 @@ static void hook_insn(CPUMIPSState *env, DisasContext *ctx, bool *insn_need_patc
 {
     TCGContext *tcg_ctx = ctx->uc->tcg_ctx;
     if (HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_CODE, ctx->pc)) {
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_CODE_IDX, env->uc, ctx->pc);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), ctx->pc);
         *insn_need_patch = true;
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
@@ -19201,11 +19201,15 @@ gen_intermediate_code_internal(MIPSCPU *cpu, TranslationBlock *tb,
     max_insns = tb->cflags & CF_COUNT_MASK;
     if (max_insns == 0)
         max_insns = CF_COUNT_MASK;
+
+    // Unicorn: engine-wide cap on instructions per block
+    if (env->uc->tb_max_insns && max_insns > env->uc->tb_max_insns)
+        max_insns = env->uc->tb_max_insns;
     LOG_DISAS("\ntb %p idx %d hflags %04x\n", tb, ctx.mem_idx, ctx.hflags);
 
     // Unicorn: early check to see if the address of this block is the until address
     if (tb->pc == env->uc->addr_end) {
-        gen_tb_start(tcg_ctx);
+        gen_tb_start(tcg_ctx, tb);
         gen_helper_wait(tcg_ctx, tcg_ctx->cpu_env);
         ctx.bstate = BS_EXCP;
         goto done_generating;
@@ -19217,10 +19221,13 @@ gen_intermediate_code_internal(MIPSCPU *cpu, TranslationBlock *tb,
     if (!env->uc->block_full && HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_BLOCK, pc_start)) {
         // save block address to see if we need to patch block size later
         env->uc->block_addr = pc_start;
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, env->uc, pc_start);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, offsetof(CPUArchState, uc), pc_start);
     }
 
-    gen_tb_start(tcg_ctx);
+    // Unicorn: update the edge coverage bitmap for this block
+    UC_GEN_COVERAGE(tcg_ctx, env->uc, pc_start);
+
+    gen_tb_start(tcg_ctx, tb);
     while (ctx.bstate == BS_NONE) {
         // printf(">>> mips pc = %x\n", ctx.pc);
         if (unlikely(!QTAILQ_EMPTY(&cs->breakpoints))) {
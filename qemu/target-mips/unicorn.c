@@ -10,20 +10,9 @@
 #include "uc_priv.h"
 
 
-static uint64_t mips_mem_redirect(uint64_t address)
-{
-    // kseg0 range masks off high address bit
-    if (address >= 0x80000000 && address <= 0x9fffffff)
-        return address & 0x7fffffff;
-
-    // kseg1 range masks off top 3 address bits
-    if (address >= 0xa0000000 && address <= 0xbfffffff) {
-        return address & 0x1fffffff;
-    }
-
-    // no redirect
-    return address;
-}
+// NOTE: the kseg0/kseg1 address redirect lives in uc.c (uc_mem_redirect());
+// it is compiled into the generic memory API paths rather than dispatched
+// through a per-engine function pointer.
 
 static void mips_set_pc(struct uc_struct *uc, uint64_t address)
 {
@@ -79,6 +68,16 @@ int mips_reg_write(struct uc_struct *uc, unsigned int regid, const void *value)
     return 0;
 }
 
+// create one more vCPU of the model mips_r4k_init() uses
+static int mips_vcpu_add(struct uc_struct *uc)
+{
+#ifdef TARGET_MIPS64
+    return cpu_mips_init(uc, "R4000") == NULL ? -1 : 0;
+#else
+    return cpu_mips_init(uc, "24Kf") == NULL ? -1 : 0;
+#endif
+}
+
 __attribute__ ((visibility ("default")))
 #ifdef TARGET_MIPS64
 #ifdef TARGET_WORDS_BIGENDIAN
@@ -101,6 +100,6 @@ __attribute__ ((visibility ("default")))
     uc->reg_write = mips_reg_write;
     uc->reg_reset = mips_reg_reset;
     uc->set_pc = mips_set_pc;
-    uc->mem_redirect = mips_mem_redirect;
+    uc->vcpu_add = mips_vcpu_add;
     uc_common_init(uc);
 }
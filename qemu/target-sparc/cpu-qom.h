@@ -76,6 +76,8 @@ static inline SPARCCPU *sparc_env_get_cpu(CPUSPARCState *env)
 #define ENV_OFFSET offsetof(SPARCCPU, env)
 
 void sparc_cpu_do_interrupt(CPUState *cpu);
+bool sparc_cpu_exec_interrupt(CPUState *cpu, int int_req);
+void sparc_cpu_synchronize_from_tb(CPUState *cpu, struct TranslationBlock *tb);
 void sparc_cpu_dump_state(CPUState *cpu, FILE *f,
                           fprintf_function cpu_fprintf, int flags);
 hwaddr sparc_cpu_get_phys_page_debug(CPUState *cpu, vaddr addr);
@@ -70,7 +70,7 @@ static void sparc_cpu_reset(CPUState *s)
     env->cache_control = 0;
 }
 
-static bool sparc_cpu_exec_interrupt(CPUState *cs, int interrupt_request)
+bool sparc_cpu_exec_interrupt(CPUState *cs, int interrupt_request)
 {
     if (interrupt_request & CPU_INTERRUPT_HARD) {
         SPARCCPU *cpu = SPARC_CPU(cs->uc, cs);
@@ -766,7 +766,7 @@ static void sparc_cpu_set_pc(CPUState *cs, vaddr value)
     cpu->env.npc = value + 4;
 }
 
-static void sparc_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
+void sparc_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
 {
     SPARCCPU *cpu = SPARC_CPU(cs->uc, cs);
 
@@ -809,7 +809,9 @@ static void sparc_cpu_initfn(struct uc_struct *uc, Object *obj, void *opaque)
     CPUSPARCState *env = &cpu->env;
 
     cs->env_ptr = env;
-    cpu_exec_init(env, opaque);
+    /* the type graph may be shared between instances (see type_table_attach):
+       use the opening engine, not the userdata of whoever registered the type */
+    cpu_exec_init(env, uc);
 
     if (tcg_enabled(uc)) {
         gen_intermediate_code_init(env);
@@ -860,7 +862,6 @@ void sparc_cpu_register_types(void *opaque)
     TypeInfo sparc_cpu_type_info = {
         .name = TYPE_SPARC_CPU,
         .parent = TYPE_CPU,
-        .instance_userdata = opaque,
         .instance_size = sizeof(SPARCCPU),
         .instance_init = sparc_cpu_initfn,
         .instance_finalize = sparc_cpu_uninitfn,
@@ -292,6 +292,81 @@ static inline void gen_store_gpr(DisasContext *dc, int reg, TCGv v)
     }
 }
 
+#ifndef TARGET_SPARC64
+// Unicorn: inline fast path for SAVE (delta = -1) and RESTORE (delta = 1).
+// In the common case the helpers only slide the window pointer; doing that
+// in translated code spares call-heavy guests a helper call per SAVE.  The
+// slow label covers everything cpu_set_cwp() treats specially: a
+// window-invalid-mask hit (window trap) and entering or leaving the wrap
+// window, which must copy the overlap registers.  The rd result and the
+// new cwp live in local temps because plain temps do not survive the
+// branches emitted here.
+static void gen_win_shift(DisasContext *dc, int delta, int rd, TCGv res)
+{
+    TCGContext *tcg_ctx = dc->uc->tcg_ctx;
+    int nwindows = dc->def->nwindows;
+    int lbl_slow = gen_new_label(tcg_ctx);
+    int lbl_done = gen_new_label(tcg_ctx);
+    TCGv_i32 t_old = tcg_temp_new_i32(tcg_ctx);
+    TCGv_i32 t_new = tcg_temp_local_new_i32(tcg_ctx);
+    TCGv_i32 t_wrap = tcg_temp_new_i32(tcg_ctx);
+    TCGv_i32 t_lim = tcg_const_i32(tcg_ctx, delta < 0 ? 0 : nwindows);
+    TCGv_i32 t_wim = tcg_temp_new_i32(tcg_ctx);
+    TCGv t_res = tcg_temp_local_new_i32(tcg_ctx);
+
+    // rd is computed against the old window but stored into the new one
+    tcg_gen_mov_tl(tcg_ctx, t_res, res);
+    tcg_gen_ld_i32(tcg_ctx, t_old, tcg_ctx->cpu_env,
+                   offsetof(CPUSPARCState, cwp));
+    tcg_gen_addi_i32(tcg_ctx, t_new, t_old, delta);
+    if (delta < 0) {
+        // cwp was 0: wrap up to nwindows - 1
+        tcg_gen_addi_i32(tcg_ctx, t_wrap, t_new, nwindows);
+        tcg_gen_movcond_i32(tcg_ctx, TCG_COND_LT, t_new, t_new, t_lim,
+                            t_wrap, t_new);
+    } else {
+        // cwp was nwindows - 1: wrap down to 0
+        tcg_gen_subi_i32(tcg_ctx, t_wrap, t_new, nwindows);
+        tcg_gen_movcond_i32(tcg_ctx, TCG_COND_GE, t_new, t_new, t_lim,
+                            t_wrap, t_new);
+    }
+
+    tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_EQ, t_old, nwindows - 1, lbl_slow);
+    tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_EQ, t_new, nwindows - 1, lbl_slow);
+    tcg_gen_ld_i32(tcg_ctx, t_wim, tcg_ctx->cpu_env,
+                   offsetof(CPUSPARCState, wim));
+    tcg_gen_shr_i32(tcg_ctx, t_wim, t_wim, t_new);
+    tcg_gen_andi_i32(tcg_ctx, t_wim, t_wim, 1);
+    tcg_gen_brcondi_i32(tcg_ctx, TCG_COND_NE, t_wim, 0, lbl_slow);
+
+    tcg_gen_st_i32(tcg_ctx, t_new, tcg_ctx->cpu_env,
+                   offsetof(CPUSPARCState, cwp));
+    tcg_gen_muli_i32(tcg_ctx, t_new, t_new, 16 * sizeof(target_ulong));
+    tcg_gen_ext_i32_ptr(tcg_ctx, tcg_ctx->cpu_regwptr, t_new);
+    tcg_gen_add_ptr(tcg_ctx, tcg_ctx->cpu_regwptr, tcg_ctx->cpu_regwptr,
+                    tcg_ctx->cpu_env);
+    tcg_gen_addi_ptr(tcg_ctx, tcg_ctx->cpu_regwptr, tcg_ctx->cpu_regwptr,
+                     offsetof(CPUSPARCState, regbase));
+    tcg_gen_br(tcg_ctx, lbl_done);
+
+    gen_set_label(tcg_ctx, lbl_slow);
+    if (delta < 0) {
+        gen_helper_save(tcg_ctx, tcg_ctx->cpu_env);
+    } else {
+        gen_helper_restore(tcg_ctx, tcg_ctx->cpu_env);
+    }
+    gen_set_label(tcg_ctx, lbl_done);
+    gen_store_gpr(dc, rd, t_res);
+
+    tcg_temp_free_i32(tcg_ctx, t_res);
+    tcg_temp_free_i32(tcg_ctx, t_wim);
+    tcg_temp_free_i32(tcg_ctx, t_lim);
+    tcg_temp_free_i32(tcg_ctx, t_wrap);
+    tcg_temp_free_i32(tcg_ctx, t_new);
+    tcg_temp_free_i32(tcg_ctx, t_old);
+}
+#endif
+
 static inline TCGv gen_dest_gpr(DisasContext *dc, int reg)
 {
     if (reg == 0 || reg >= 8) {
@@ -2632,7 +2707,7 @@ static void disas_sparc_insn(DisasContext * dc, unsigned int insn, bool hook_ins
 
     // Unicorn: trace this instruction on request
     if (hook_insn && HOOK_EXISTS_BOUNDED(dc->uc, UC_HOOK_CODE, dc->pc)) {
-        gen_uc_tracecode(tcg_ctx, 4, UC_HOOK_CODE_IDX, dc->uc, dc->pc);
+        gen_uc_tracecode(tcg_ctx, 4, UC_HOOK_CODE_IDX, offsetof(CPUArchState, uc), dc->pc);
         // the callback might want to stop emulation immediately
         check_exit_request(tcg_ctx);
     }
@@ -4702,13 +4777,21 @@ static void disas_sparc_insn(DisasContext * dc, unsigned int insn, bool hook_ins
                     break;
                 case 0x3c:      /* save */
                     save_state(dc);
+#ifdef TARGET_SPARC64
                     gen_helper_save(tcg_ctx, tcg_ctx->cpu_env);
                     gen_store_gpr(dc, rd, cpu_tmp0);
+#else
+                    gen_win_shift(dc, -1, rd, cpu_tmp0);
+#endif
                     break;
                 case 0x3d:      /* restore */
                     save_state(dc);
+#ifdef TARGET_SPARC64
                     gen_helper_restore(tcg_ctx, tcg_ctx->cpu_env);
                     gen_store_gpr(dc, rd, cpu_tmp0);
+#else
+                    gen_win_shift(dc, 1, rd, cpu_tmp0);
+#endif
                     break;
 #if !defined(CONFIG_USER_ONLY) && defined(TARGET_SPARC64)
                 case 0x3e:      /* V9 done/retry */
@@ -5398,7 +5481,7 @@ static inline void gen_intermediate_code_internal(SPARCCPU *cpu,
 
     // early check to see if the address of this block is the until address
     if (pc_start == env->uc->addr_end) {
-        gen_tb_start(tcg_ctx);
+        gen_tb_start(tcg_ctx, tb);
         gen_helper_power_down(tcg_ctx, tcg_ctx->cpu_env);
         goto done_generating;
     }
@@ -5407,9 +5490,13 @@ static inline void gen_intermediate_code_internal(SPARCCPU *cpu,
     if (max_insns == 0)
         max_insns = CF_COUNT_MASK;
 
+    // Unicorn: engine-wide cap on instructions per block
+    if (env->uc->tb_max_insns && max_insns > env->uc->tb_max_insns)
+        max_insns = env->uc->tb_max_insns;
+
     // Unicorn: early check to see if the address of this block is the until address
     if (tb->pc == env->uc->addr_end) {
-        gen_tb_start(tcg_ctx);
+        gen_tb_start(tcg_ctx, tb);
         save_state(dc);
         gen_helper_power_down(tcg_ctx, tcg_ctx->cpu_env);
         goto done_generating;
@@ -5421,10 +5508,13 @@ static inline void gen_intermediate_code_internal(SPARCCPU *cpu,
     if (!env->uc->block_full && HOOK_EXISTS_BOUNDED(env->uc, UC_HOOK_BLOCK, pc_start)) {
         // save block address to see if we need to patch block size later
         env->uc->block_addr = pc_start;
-        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, env->uc, pc_start);
+        gen_uc_tracecode(tcg_ctx, 0xf8f8f8f8, UC_HOOK_BLOCK_IDX, offsetof(CPUArchState, uc), pc_start);
     }
 
-    gen_tb_start(tcg_ctx);
+    // Unicorn: update the edge coverage bitmap for this block
+    UC_GEN_COVERAGE(tcg_ctx, env->uc, pc_start);
+
+    gen_tb_start(tcg_ctx, tb);
     do {
         if (unlikely(!QTAILQ_EMPTY(&cs->breakpoints))) {
             QTAILQ_FOREACH(bp, &cs->breakpoints, entry) {
@@ -91,6 +91,18 @@ int sparc_reg_write(struct uc_struct *uc, unsigned int regid, const void *value)
     return 0;
 }
 
+// create one more vCPU of the model leon3_generic_hw_init() uses
+static int sparc_vcpu_add(struct uc_struct *uc)
+{
+    SPARCCPU *cpu = cpu_sparc_init(uc, "LEON3");
+
+    if (cpu == NULL) {
+        return -1;
+    }
+    cpu_sparc_set_id(&cpu->env, uc->vcpu_count);
+    return 0;
+}
+
 __attribute__ ((visibility ("default")))
 void sparc_uc_init(struct uc_struct* uc)
 {
@@ -102,5 +114,6 @@ void sparc_uc_init(struct uc_struct* uc)
     uc->reg_reset = sparc_reg_reset;
     uc->set_pc = sparc_set_pc;
     uc->stop_interrupt = sparc_stop_interrupt;
+    uc->vcpu_add = sparc_vcpu_add;
     uc_common_init(uc);
 }
@@ -89,6 +89,12 @@ int sparc_reg_write(struct uc_struct *uc, unsigned int regid, const void *value)
     return 0;
 }
 
+// create one more vCPU of the model sun4u_init() uses
+static int sparc64_vcpu_add(struct uc_struct *uc)
+{
+    return cpu_sparc_init(uc, "Sun UltraSparc IV") == NULL ? -1 : 0;
+}
+
 __attribute__ ((visibility ("default")))
 void sparc64_uc_init(struct uc_struct* uc)
 {
@@ -100,5 +106,6 @@ void sparc64_uc_init(struct uc_struct* uc)
     uc->reg_reset = sparc_reg_reset;
     uc->set_pc = sparc_set_pc;
     uc->stop_interrupt = sparc_stop_interrupt;
+    uc->vcpu_add = sparc64_vcpu_add;
     uc_common_init(uc);
 }
@@ -1190,8 +1190,10 @@ static inline void tcg_out_tlb_load(TCGContext *s, TCGReg addrlo, TCGReg addrhi,
 
     tgen_arithi(s, ARITH_AND + trexw, r1,
                 TARGET_PAGE_MASK | ((1 << s_bits) - 1), 0);
+    /* the index mask is read at translation time: resizing the per-instance
+       TLB (uc_tlb_resize) flushes all TBs so no stale mask survives */
     tgen_arithi(s, ARITH_AND + hrexw, r0,
-                (CPU_TLB_SIZE - 1) << CPU_TLB_ENTRY_BITS, 0);
+                (s->uc->tlb_entries - 1) << CPU_TLB_ENTRY_BITS, 0);
 
     tcg_out_modrm_sib_offset(s, OPC_LEA + hrexw, r0, TCG_AREG0, r0, 0,
                              offsetof(CPUArchState, tlb_table[mem_index][0])
@@ -1208,11 +1210,10 @@ static inline void tcg_out_tlb_load(TCGContext *s, TCGReg addrlo, TCGReg addrhi,
        for the 32-bit host happens with the fastpath ADDL below.  */
     tcg_out_mov(s, ttype, r1, addrlo);
 
-    // Unicorn: fast path if hookmem is not enable
-    if (!HOOK_EXISTS(s->uc, UC_HOOK_MEM_READ) && !HOOK_EXISTS(s->uc, UC_HOOK_MEM_WRITE))
-        tcg_out_opc(s, OPC_JCC_long + JCC_JNE, 0, 0, 0);
-    else
-        tcg_out_opc(s, OPC_JMP_long, 0, 0, 0); /* slow_path */
+    /* Unicorn: pages intersecting a memory hook range carry TLB_UCHOOK in
+       their TLB entry, which makes this compare fail and diverts them to
+       the instrumented slow path.  Unhooked pages keep the fast path.  */
+    tcg_out_opc(s, OPC_JCC_long + JCC_JNE, 0, 0, 0);
     label_ptr[0] = s->code_ptr;
     s->code_ptr += 4;
 
@@ -65,6 +65,218 @@ static void reset_all_temps(TCGContext *s, int nb_temps)
     }
 }
 
+/* Unicorn: local value numbering for CPUArchState slots.
+
+   Guest state that is not mapped to a TCG global is accessed with
+   fixed-offset ld/st through the env pointer, and the translators emit
+   plenty of provably redundant ones (flag material, SSE/FPU slots,
+   segment state).  Within one basic block we remember which temp holds
+   the current value of a slot, so a repeated load collapses into a mov
+   (or movi) and a load after a full-width store is forwarded from the
+   stored temp.  A store that is overwritten by a covering store before
+   anything can observe memory is deleted outright.
+
+   Temps are validated with a per-temp write generation instead of a use
+   list: a cache entry is stale as soon as the temp it names has been
+   written again.  Slots that overlap the backing storage of a TCG
+   global are never tracked, since the register allocator spills and
+   refills globals behind our back.  Everything is dropped at basic
+   block boundaries and around ops that may read or write arbitrary CPU
+   state (helper calls, guest memory accesses, which can fault and land
+   in the exception path). */
+
+#define ENV_CACHE_SLOTS 8
+
+struct env_slot {
+    TCGArg off;         /* byte offset of the slot in CPUArchState */
+    TCGOpcode opc;      /* load opcode the cached value corresponds to */
+    TCGArg temp;        /* temp holding the slot value */
+    uint16_t gen;       /* write generation of temp when recorded */
+};
+
+struct env_store {
+    TCGArg off;
+    TCGOpcode opc;      /* store opcode, for the byte width */
+    int op_index;       /* position of the store in gen_opc_buf */
+    TCGArg *args_pos;   /* position of its args in the rewritten stream */
+};
+
+struct env_cache {
+    struct env_slot slots[ENV_CACHE_SLOTS];
+    int nb_slots;
+    struct env_store stores[ENV_CACHE_SLOTS];
+    int nb_stores;
+    uint16_t write_gen[TCG_MAX_TEMPS];
+};
+
+/* Byte width of a fixed-offset load, or 0 if OP is not one. */
+static int env_ld_size(TCGOpcode op)
+{
+    switch (op) {
+    case INDEX_op_ld8u_i32:
+    case INDEX_op_ld8s_i32:
+    case INDEX_op_ld8u_i64:
+    case INDEX_op_ld8s_i64:
+        return 1;
+    case INDEX_op_ld16u_i32:
+    case INDEX_op_ld16s_i32:
+    case INDEX_op_ld16u_i64:
+    case INDEX_op_ld16s_i64:
+        return 2;
+    case INDEX_op_ld_i32:
+    case INDEX_op_ld32u_i64:
+    case INDEX_op_ld32s_i64:
+        return 4;
+    case INDEX_op_ld_i64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/* Byte width of a fixed-offset store, or 0 if OP is not one. */
+static int env_st_size(TCGOpcode op)
+{
+    switch (op) {
+    case INDEX_op_st8_i32:
+    case INDEX_op_st8_i64:
+        return 1;
+    case INDEX_op_st16_i32:
+    case INDEX_op_st16_i64:
+        return 2;
+    case INDEX_op_st_i32:
+    case INDEX_op_st32_i64:
+        return 4;
+    case INDEX_op_st_i64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/* True if [off, off+size) overlaps the backing store of a TCG global. */
+static bool env_overlaps_global(TCGContext *s, TCGArg off, int size)
+{
+    tcg_target_long lo = off, hi = off + size;
+    int i;
+
+    for (i = 0; i < s->nb_globals; i++) {
+        const TCGTemp *ts = &s->temps[i];
+        int gsize;
+
+        if (ts->fixed_reg || !ts->mem_allocated) {
+            continue;
+        }
+        gsize = ts->type == TCG_TYPE_I64 ? 8 : 4;
+        if (lo < ts->mem_offset + gsize && ts->mem_offset < hi) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static struct env_slot *env_cache_lookup(struct env_cache *ec, TCGOpcode opc,
+                                         TCGArg off)
+{
+    int i;
+
+    for (i = 0; i < ec->nb_slots; i++) {
+        if (ec->slots[i].opc == opc && ec->slots[i].off == off) {
+            return &ec->slots[i];
+        }
+    }
+    return NULL;
+}
+
+static void env_cache_record(struct env_cache *ec, TCGOpcode opc, TCGArg off,
+                             TCGArg temp)
+{
+    struct env_slot *sl = env_cache_lookup(ec, opc, off);
+
+    if (sl == NULL) {
+        /* Full: overwrite the oldest entry. */
+        if (ec->nb_slots == ENV_CACHE_SLOTS) {
+            memmove(&ec->slots[0], &ec->slots[1],
+                    (ENV_CACHE_SLOTS - 1) * sizeof(ec->slots[0]));
+            ec->nb_slots--;
+        }
+        sl = &ec->slots[ec->nb_slots++];
+        sl->opc = opc;
+        sl->off = off;
+    }
+    sl->temp = temp;
+    sl->gen = ec->write_gen[temp];
+}
+
+/* Drop cached values overlapping a store to [off, off+size). */
+static void env_cache_invalidate(struct env_cache *ec, TCGArg off, int size)
+{
+    int i = 0;
+
+    while (i < ec->nb_slots) {
+        struct env_slot *sl = &ec->slots[i];
+
+        if (off < sl->off + env_ld_size(sl->opc) && sl->off < off + size) {
+            *sl = ec->slots[--ec->nb_slots];
+        } else {
+            i++;
+        }
+    }
+}
+
+/* A load from [off, off+size) was emitted: overlapping pending stores
+   are now observed and must not be deleted any more. */
+static void env_cache_observe(struct env_cache *ec, TCGArg off, int size)
+{
+    int i = 0;
+
+    while (i < ec->nb_stores) {
+        struct env_store *st = &ec->stores[i];
+
+        if (off < st->off + env_st_size(st->opc) && st->off < off + size) {
+            *st = ec->stores[--ec->nb_stores];
+        } else {
+            i++;
+        }
+    }
+}
+
+/* A store to [off, off+size) was emitted: pending stores whose range it
+   fully covers are dead and get replaced with nops; the new store
+   becomes pending itself (the caller checked it does not overlap a
+   global and is observable by nothing recorded so far). */
+static void env_cache_store(TCGContext *s, struct env_cache *ec, TCGOpcode opc,
+                            TCGArg off, int op_index, TCGArg *args_pos)
+{
+    int size = env_st_size(opc);
+    struct env_store *st;
+    int i = 0;
+
+    while (i < ec->nb_stores) {
+        st = &ec->stores[i];
+        if (st->off >= off && st->off + env_st_size(st->opc) <= off + size) {
+            /* nopn consumes the three already emitted store args */
+            s->gen_opc_buf[st->op_index] = INDEX_op_nopn;
+            st->args_pos[0] = 3;
+            st->args_pos[2] = 3;
+            *st = ec->stores[--ec->nb_stores];
+        } else {
+            i++;
+        }
+    }
+
+    if (ec->nb_stores == ENV_CACHE_SLOTS) {
+        memmove(&ec->stores[0], &ec->stores[1],
+                (ENV_CACHE_SLOTS - 1) * sizeof(ec->stores[0]));
+        ec->nb_stores--;
+    }
+    st = &ec->stores[ec->nb_stores++];
+    st->opc = opc;
+    st->off = off;
+    st->op_index = op_index;
+    st->args_pos = args_pos;
+}
+
 static int op_bits(TCGContext *s, TCGOpcode op)
 {
     const TCGOpDef *def = &s->tcg_op_defs[op];
@@ -539,6 +751,8 @@ static TCGArg *tcg_constant_folding(TCGContext *s, uint16_t *tcg_opc_ptr,
     struct tcg_temp_info *temps = s->temps2;
     int nb_ops, op_index, nb_temps, nb_globals;
     TCGArg *gen_args;
+    struct env_cache ec;
+    TCGArg env_temp = (TCGArg)-1;
 
     /* Array VALS has an element for each temp.
        If this temp holds a constant then its value is kept in VALS' element.
@@ -549,13 +763,23 @@ static TCGArg *tcg_constant_folding(TCGContext *s, uint16_t *tcg_opc_ptr,
     nb_globals = s->nb_globals;
     reset_all_temps(s, nb_temps);
 
+    /* The env pointer is the only fixed-register global; loads and
+       stores based on it address CPUArchState slots. */
+    memset(&ec, 0, sizeof(ec));
+    for (op_index = 0; op_index < nb_globals; op_index++) {
+        if (s->temps[op_index].fixed_reg) {
+            env_temp = op_index;
+            break;
+        }
+    }
+
     nb_ops = tcg_opc_ptr - s->gen_opc_buf;
     gen_args = args;
     for (op_index = 0; op_index < nb_ops; op_index++) {
         TCGOpcode op = s->gen_opc_buf[op_index];
         const TCGOpDef *def = &tcg_op_defs[op];
         tcg_target_ulong mask, partmask, affected;
-        int nb_oargs, nb_iargs, nb_args, i;
+        int nb_oargs, nb_iargs, nb_args, i, acc_size;
         TCGArg tmp;
 
         if (op == INDEX_op_call) {
@@ -576,6 +800,70 @@ static TCGArg *tcg_constant_folding(TCGContext *s, uint16_t *tcg_opc_ptr,
             }
         }
 
+        /* Unicorn: bump the write generation of every redefined temp, so
+           env cache entries naming it go stale. */
+        for (i = 0; i < nb_oargs; i++) {
+            ec.write_gen[args[i]]++;
+        }
+
+        /* Unicorn: eliminate redundant CPUArchState accesses.  A load
+           from a slot whose value is cached becomes a mov/movi; a store
+           superseded by a covering store before any possible observer is
+           deleted.  See the env_cache helpers above. */
+        if ((acc_size = env_ld_size(op)) != 0 && args[1] == env_temp) {
+            struct env_slot *sl = env_cache_lookup(&ec, op, args[2]);
+
+            if (sl != NULL && ec.write_gen[sl->temp] == sl->gen) {
+                if (temps[sl->temp].state == TCG_TEMP_CONST) {
+                    tcg_opt_gen_movi(s, op_index, gen_args, op,
+                                     args[0], temps[sl->temp].val);
+                    gen_args += 2;
+                } else if (temps_are_copies(s, args[0], sl->temp)) {
+                    s->gen_opc_buf[op_index] = INDEX_op_nop;
+                } else {
+                    tcg_opt_gen_mov(s, op_index, gen_args, op,
+                                    args[0], sl->temp);
+                    gen_args += 2;
+                }
+                args += 3;
+                continue;
+            }
+            /* The emitted load observes overlapping pending stores. */
+            env_cache_observe(&ec, args[2], acc_size);
+            if (!env_overlaps_global(s, args[2], acc_size)) {
+                env_cache_record(&ec, op, args[2], args[0]);
+            }
+        } else if ((acc_size = env_st_size(op)) != 0 && args[1] == env_temp) {
+            env_cache_invalidate(&ec, args[2], acc_size);
+            if (!env_overlaps_global(s, args[2], acc_size)) {
+                env_cache_store(s, &ec, op, args[2], op_index, gen_args);
+                /* A full-width store also defines the slot value. */
+                if (op == INDEX_op_st_i32) {
+                    env_cache_record(&ec, INDEX_op_ld_i32, args[2], args[0]);
+                } else if (op == INDEX_op_st_i64) {
+                    env_cache_record(&ec, INDEX_op_ld_i64, args[2], args[0]);
+                }
+            } else {
+                ec.nb_stores = 0;
+            }
+        } else if (op == INDEX_op_call) {
+            /* Helpers may read or write any slot. */
+            ec.nb_stores = 0;
+            if (!(args[nb_oargs + nb_iargs + 1] & TCG_CALL_NO_WRITE_GLOBALS)) {
+                ec.nb_slots = 0;
+            }
+        } else if (def->flags & (TCG_OPF_BB_END | TCG_OPF_CALL_CLOBBER
+                                 | TCG_OPF_SIDE_EFFECTS)) {
+            /* Control flow joins, or ops that may fault into the
+               exception path (guest memory accesses) or hide a helper. */
+            ec.nb_stores = 0;
+            ec.nb_slots = 0;
+        } else if (env_ld_size(op) != 0 || env_st_size(op) != 0) {
+            /* Access through a derived pointer: could alias anything. */
+            ec.nb_stores = 0;
+            ec.nb_slots = 0;
+        }
+
         /* For commutative operations make constant second argument */
         switch (op) {
         CASE_OP_32_64(add):
@@ -1522,7 +1522,7 @@ static TCGReg tcg_out_tlb_read(TCGContext* s, TCGReg addr_reg, TCGMemOp opc,
                      TARGET_PAGE_BITS - CPU_TLB_ENTRY_BITS);
         tcg_out_movi(s, TCG_TYPE_TL, TCG_REG_R3, addr_reg);
         tgen_andi(s, TCG_TYPE_I64, TCG_REG_R2,
-                  (CPU_TLB_SIZE - 1) << CPU_TLB_ENTRY_BITS);
+                  (s->uc->tlb_entries - 1) << CPU_TLB_ENTRY_BITS);
         tgen_andi(s, TCG_TYPE_TL, TCG_REG_R3, tlb_mask);
     }
 
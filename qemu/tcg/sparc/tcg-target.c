@@ -1005,7 +1005,7 @@ static TCGReg tcg_out_tlb_load(TCGContext *s, TCGReg addr, int mem_index,
                  TARGET_PAGE_MASK | ((1 << s_bits) - 1));
 
     /* Mask the tlb index.  */
-    tcg_out_arithi(s, r1, r1, CPU_TLB_SIZE - 1, ARITH_AND);
+    tcg_out_arithi(s, r1, r1, s->uc->tlb_entries - 1, ARITH_AND);
     
     /* Mask page, part 2.  */
     tcg_out_arith(s, r0, addr, TCG_REG_T1, ARITH_AND);
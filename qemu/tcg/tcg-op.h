@@ -27,13 +27,18 @@
 
 int gen_new_label(TCGContext *);
 
-static inline void gen_uc_tracecode(TCGContext *tcg_ctx, int32_t size, int32_t type, void *uc, uint64_t pc)
+/* uc_offset is offsetof(CPUArchState, uc): the engine is fetched from env
+   at run time rather than baked into the generated code as an immediate,
+   so the code is not tied to the translating instance */
+static inline void gen_uc_tracecode(TCGContext *tcg_ctx, int32_t size, int32_t type, size_t uc_offset, uint64_t pc)
 {
     TCGv_i32 tsize = tcg_const_i32(tcg_ctx, size);
     TCGv_i32 ttype = tcg_const_i32(tcg_ctx, type);
-    TCGv_ptr tuc = tcg_const_ptr(tcg_ctx, uc);
+    TCGv_ptr tuc = tcg_temp_new_ptr(tcg_ctx);
     TCGv_i64 tpc = tcg_const_i64(tcg_ctx, pc);
+    tcg_gen_ld_ptr(tcg_ctx, tuc, tcg_ctx->cpu_env, uc_offset);
     gen_helper_uc_tracecode(tcg_ctx, tsize, ttype, tuc, tpc);
+    tcg_temp_free_ptr(tcg_ctx, tuc);
 }
 
 static inline void tcg_gen_op0(TCGContext *s, TCGOpcode opc)
@@ -2770,3 +2775,34 @@ static inline void tcg_gen_qemu_st64(struct uc_struct *uc, TCGv_i64 arg, TCGv ad
 # define tcg_gen_ext_i32_ptr(S, R, A) \
     tcg_gen_ext_i32_i64(S, TCGV_PTR_TO_NAT(R), (A))
 #endif /* UINTPTR_MAX == UINT32_MAX */
+
+// Unicorn: inline edge coverage update for uc_coverage_enable(), emitted at
+// the start of a translation block:
+//    bitmap[cur ^ prev_loc]++; prev_loc = cur >> 1;
+// where @cur is the block's translate-time location hash. No helper call,
+// just a handful of loads and stores in the generated code.
+static inline void gen_uc_coverage(TCGContext *tcg_ctx, void *bitmap,
+        void *prev_loc, uint32_t cur)
+{
+    TCGv_ptr tprev = tcg_const_ptr(tcg_ctx, prev_loc);
+    TCGv_ptr tmap = tcg_const_ptr(tcg_ctx, bitmap);
+    TCGv_ptr taddr = tcg_temp_new_ptr(tcg_ctx);
+    TCGv_i32 tidx = tcg_temp_new_i32(tcg_ctx);
+    TCGv_i32 tcnt = tcg_temp_new_i32(tcg_ctx);
+
+    tcg_gen_ld_i32(tcg_ctx, tidx, tprev, 0);
+    tcg_gen_xori_i32(tcg_ctx, tidx, tidx, cur);
+    tcg_gen_ext_i32_ptr(tcg_ctx, taddr, tidx);
+    tcg_gen_add_ptr(tcg_ctx, taddr, taddr, tmap);
+    tcg_gen_ld8u_i32(tcg_ctx, tcnt, taddr, 0);
+    tcg_gen_addi_i32(tcg_ctx, tcnt, tcnt, 1);
+    tcg_gen_st8_i32(tcg_ctx, tcnt, taddr, 0);
+    tcg_gen_movi_i32(tcg_ctx, tidx, cur >> 1);
+    tcg_gen_st_i32(tcg_ctx, tidx, tprev, 0);
+
+    tcg_temp_free_i32(tcg_ctx, tcnt);
+    tcg_temp_free_i32(tcg_ctx, tidx);
+    tcg_temp_free_ptr(tcg_ctx, taddr);
+    tcg_temp_free_ptr(tcg_ctx, tmap);
+    tcg_temp_free_ptr(tcg_ctx, tprev);
+}
@@ -37,6 +37,7 @@
 #endif
 
 #include "qemu-common.h"
+#include "qemu/bitmap.h"
 #include "qemu/host-utils.h"
 #include "qemu/timer.h"
 
@@ -327,9 +328,20 @@ void tcg_context_init(TCGContext *s)
     int *sorted_args;
     GHashTable *helper_table;
 
-    memset(s, 0, sizeof(*s));
+    TCGPool *pool;
+
+    /* the caller (cpu_gen_init()) hands the context over zero-filled
+       straight from the allocator; clearing it again here would fault
+       in every page of the scratch arrays before first use */
     s->nb_globals = 0;
 
+    /* preallocate the translation-time arena (see TCG_POOL_ARENA_SIZE):
+       every per-TB allocation lands in this one recycled chunk */
+    pool = g_malloc(sizeof(TCGPool) + TCG_POOL_ARENA_SIZE);
+    pool->size = TCG_POOL_ARENA_SIZE;
+    pool->next = NULL;
+    s->pool_first = pool;
+
     // copy original tcg_op_defs_org for private usage
     s->tcg_op_defs = g_malloc(sizeof(tcg_op_defs_org));
     memcpy(s->tcg_op_defs, tcg_op_defs_org, sizeof(tcg_op_defs_org));
@@ -1416,40 +1428,39 @@ static inline void tcg_set_nop(TCGContext *s, uint16_t *opc_ptr,
     }
 }
 
+/* Unicorn: the liveness state is kept in bitsets rather than one byte
+   per temp.  The resets below run at every basic block boundary and
+   around every op with side effects, so with large blocks the old
+   per-temp byte loops dominated translation time; as bitsets they are a
+   handful of word copies against masks precomputed once per TB. */
+
 /* liveness analysis: end of function: all temps are dead, and globals
    should be in memory. */
-static inline void tcg_la_func_end(TCGContext *s, uint8_t *dead_temps,
-                                   uint8_t *mem_temps)
+static inline void tcg_la_func_end(TCGContext *s, unsigned long *dead_temps,
+                                   unsigned long *mem_temps,
+                                   const unsigned long *glob_mask)
 {
-    memset(dead_temps, 1, s->nb_temps);
-    memset(mem_temps, 1, s->nb_globals);
-    memset(mem_temps + s->nb_globals, 0, s->nb_temps - s->nb_globals);
+    bitmap_fill(dead_temps, s->nb_temps);
+    bitmap_copy(mem_temps, glob_mask, s->nb_temps);
 }
 
 /* liveness analysis: end of basic block: all temps are dead, globals
    and local temps should be in memory. */
-static inline void tcg_la_bb_end(TCGContext *s, uint8_t *dead_temps,
-                                 uint8_t *mem_temps)
+static inline void tcg_la_bb_end(TCGContext *s, unsigned long *dead_temps,
+                                 unsigned long *mem_temps,
+                                 const unsigned long *bb_mem_mask)
 {
-    int i;
-
-    memset(dead_temps, 1, s->nb_temps);
-    memset(mem_temps, 1, s->nb_globals);
-    for(i = s->nb_globals; i < s->nb_temps; i++) {
-        mem_temps[i] = s->temps[i].temp_local;
-    }
+    bitmap_fill(dead_temps, s->nb_temps);
+    bitmap_copy(mem_temps, bb_mem_mask, s->nb_temps);
 }
 
 /*
     Unicorn: for brcond, we should refresh liveness states for TCG globals
 */
-static inline void tcg_la_br_end(TCGContext *s, uint8_t *mem_temps)
+static inline void tcg_la_br_end(TCGContext *s, unsigned long *mem_temps,
+                                 const unsigned long *bb_mem_mask)
 {
-    int i;
-    memset(mem_temps, 1, s->nb_globals);
-    for(i = s->nb_globals; i < s->nb_temps; i++) {
-        mem_temps[i] = s->temps[i].temp_local;
-    }
+    bitmap_copy(mem_temps, bb_mem_mask, s->nb_temps);
 }
 
 /* Liveness analysis : update the opc_dead_args array to tell if a
@@ -1461,7 +1472,9 @@ static void tcg_liveness_analysis(TCGContext *s)
     TCGOpcode op, op_new, op_new2;
     TCGArg *args, arg;
     const TCGOpDef *def;
-    uint8_t *dead_temps, *mem_temps;
+    unsigned long *dead_temps, *mem_temps;
+    unsigned long *glob_mask, *bb_mem_mask;
+    int nlongs, glongs;
     uint16_t dead_args;
     uint8_t sync_args;
     bool have_op_new2;
@@ -1473,9 +1486,25 @@ static void tcg_liveness_analysis(TCGContext *s)
     s->op_dead_args = tcg_malloc(s, nb_ops * sizeof(uint16_t));
     s->op_sync_args = tcg_malloc(s, nb_ops * sizeof(uint8_t));
 
-    dead_temps = tcg_malloc(s, s->nb_temps);
-    mem_temps = tcg_malloc(s, s->nb_temps);
-    tcg_la_func_end(s, dead_temps, mem_temps);
+    nlongs = BITS_TO_LONGS(s->nb_temps);
+    glongs = BITS_TO_LONGS(s->nb_globals);
+    dead_temps = tcg_malloc(s, nlongs * sizeof(unsigned long));
+    mem_temps = tcg_malloc(s, nlongs * sizeof(unsigned long));
+
+    /* masks reused for every state reset below: the globals, and what a
+       basic block ending must leave in memory (globals + local temps) */
+    glob_mask = tcg_malloc(s, nlongs * sizeof(unsigned long));
+    bb_mem_mask = tcg_malloc(s, nlongs * sizeof(unsigned long));
+    bitmap_zero(glob_mask, s->nb_temps);
+    bitmap_fill(glob_mask, s->nb_globals);
+    bitmap_copy(bb_mem_mask, glob_mask, s->nb_temps);
+    for (i = s->nb_globals; i < s->nb_temps; i++) {
+        if (s->temps[i].temp_local) {
+            set_bit(i, bb_mem_mask);
+        }
+    }
+
+    tcg_la_func_end(s, dead_temps, mem_temps, glob_mask);
 
     args = s->gen_opparam_ptr;
     op_index = nb_ops - 1;
@@ -1499,7 +1528,8 @@ static void tcg_liveness_analysis(TCGContext *s)
                 if (call_flags & TCG_CALL_NO_SIDE_EFFECTS) {
                     for (i = 0; i < nb_oargs; i++) {
                         arg = args[i];
-                        if (!dead_temps[arg] || mem_temps[arg]) {
+                        if (!test_bit(arg, dead_temps)
+                            || test_bit(arg, mem_temps)) {
                             goto do_not_remove_call;
                         }
                     }
@@ -1513,34 +1543,38 @@ static void tcg_liveness_analysis(TCGContext *s)
                     sync_args = 0;
                     for (i = 0; i < nb_oargs; i++) {
                         arg = args[i];
-                        if (dead_temps[arg]) {
+                        if (test_bit(arg, dead_temps)) {
                             dead_args |= (1 << i);
                         }
-                        if (mem_temps[arg]) {
+                        if (test_bit(arg, mem_temps)) {
                             sync_args |= (1 << i);
                         }
-                        dead_temps[arg] = 1;
-                        mem_temps[arg] = 0;
+                        set_bit(arg, dead_temps);
+                        clear_bit(arg, mem_temps);
                     }
 
                     if (!(call_flags & TCG_CALL_NO_READ_GLOBALS)) {
                         /* globals should be synced to memory */
-                        memset(mem_temps, 1, s->nb_globals);
+                        for (i = 0; i < glongs; i++) {
+                            mem_temps[i] |= glob_mask[i];
+                        }
                     }
                     if (!(call_flags & (TCG_CALL_NO_WRITE_GLOBALS |
                                         TCG_CALL_NO_READ_GLOBALS))) {
                         /* globals should go back to memory */
-                        memset(dead_temps, 1, s->nb_globals);
+                        for (i = 0; i < glongs; i++) {
+                            dead_temps[i] |= glob_mask[i];
+                        }
                     }
 
                     /* input args are live */
                     for (i = nb_oargs; i < nb_iargs + nb_oargs; i++) {
                         arg = args[i];
                         if (arg != TCG_CALL_DUMMY_ARG) {
-                            if (dead_temps[arg]) {
+                            if (test_bit(arg, dead_temps)) {
                                 dead_args |= (1 << i);
                             }
-                            dead_temps[arg] = 0;
+                            clear_bit(arg, dead_temps);
                         }
                     }
                     s->op_dead_args[op_index] = dead_args;
@@ -1559,8 +1593,8 @@ static void tcg_liveness_analysis(TCGContext *s)
         case INDEX_op_discard:
             args--;
             /* mark the temporary as dead */
-            dead_temps[args[0]] = 1;
-            mem_temps[args[0]] = 0;
+            set_bit(args[0], dead_temps);
+            clear_bit(args[0], mem_temps);
             break;
         case INDEX_op_end:
             break;
@@ -1584,8 +1618,9 @@ static void tcg_liveness_analysis(TCGContext *s)
                the low part.  The result can be optimized to a simple
                add or sub.  This happens often for x86_64 guest when the
                cpu mode is set to 32 bit.  */
-            if (dead_temps[args[1]] && !mem_temps[args[1]]) {
-                if (dead_temps[args[0]] && !mem_temps[args[0]]) {
+            if (test_bit(args[1], dead_temps) && !test_bit(args[1], mem_temps)) {
+                if (test_bit(args[0], dead_temps)
+                    && !test_bit(args[0], mem_temps)) {
                     goto do_remove;
                 }
                 /* Create the single operation plus nop.  */
@@ -1624,8 +1659,9 @@ static void tcg_liveness_analysis(TCGContext *s)
             args -= 4;
             nb_iargs = 2;
             nb_oargs = 2;
-            if (dead_temps[args[1]] && !mem_temps[args[1]]) {
-                if (dead_temps[args[0]] && !mem_temps[args[0]]) {
+            if (test_bit(args[1], dead_temps) && !test_bit(args[1], mem_temps)) {
+                if (test_bit(args[0], dead_temps)
+                    && !test_bit(args[0], mem_temps)) {
                     /* Both parts of the operation are dead.  */
                     goto do_remove;
                 }
@@ -1633,8 +1669,8 @@ static void tcg_liveness_analysis(TCGContext *s)
                 s->gen_opc_buf[op_index] = op = op_new;
                 args[1] = args[2];
                 args[2] = args[3];
-            } else if (have_op_new2 && dead_temps[args[0]]
-                       && !mem_temps[args[0]]) {
+            } else if (have_op_new2 && test_bit(args[0], dead_temps)
+                       && !test_bit(args[0], mem_temps)) {
                 /* The low part of the operation is dead; generate the high.  */
                 s->gen_opc_buf[op_index] = op = op_new2;
                 args[0] = args[1];
@@ -1661,7 +1697,8 @@ static void tcg_liveness_analysis(TCGContext *s)
             if (!(def->flags & TCG_OPF_SIDE_EFFECTS) && nb_oargs != 0) {
                 for(i = 0; i < nb_oargs; i++) {
                     arg = args[i];
-                    if (!dead_temps[arg] || mem_temps[arg]) {
+                    if (!test_bit(arg, dead_temps)
+                        || test_bit(arg, mem_temps)) {
                         goto do_not_remove;
                     }
                 }
@@ -1678,14 +1715,14 @@ static void tcg_liveness_analysis(TCGContext *s)
                 sync_args = 0;
                 for(i = 0; i < nb_oargs; i++) {
                     arg = args[i];
-                    if (dead_temps[arg]) {
+                    if (test_bit(arg, dead_temps)) {
                         dead_args |= (1 << i);
                     }
-                    if (mem_temps[arg]) {
+                    if (test_bit(arg, mem_temps)) {
                         sync_args |= (1 << i);
                     }
-                    dead_temps[arg] = 1;
-                    mem_temps[arg] = 0;
+                    set_bit(arg, dead_temps);
+                    clear_bit(arg, mem_temps);
                 }
 
                 /* if end of basic block, update */
@@ -1695,26 +1732,28 @@ static void tcg_liveness_analysis(TCGContext *s)
                     // brcond instruction in the middle of the TB,
                     // which incorrectly flags end-of-block
                     if (op != INDEX_op_brcond_i32)
-                        tcg_la_bb_end(s, dead_temps, mem_temps);
+                        tcg_la_bb_end(s, dead_temps, mem_temps, bb_mem_mask);
                     // Unicorn: we do not touch dead temps for brcond,
                     // but we should refresh TCG globals In-Memory states,
                     // otherwise, important CPU states(especially conditional flags) might be forgotten,
                     // result in wrongly generated host code that run into wrong branch.
                     // Refer to https://github.com/unicorn-engine/unicorn/issues/287 for further information
                     else
-                        tcg_la_br_end(s, mem_temps);
+                        tcg_la_br_end(s, mem_temps, bb_mem_mask);
                 } else if (def->flags & TCG_OPF_SIDE_EFFECTS) {
                     /* globals should be synced to memory */
-                    memset(mem_temps, 1, s->nb_globals);
+                    for (i = 0; i < glongs; i++) {
+                        mem_temps[i] |= glob_mask[i];
+                    }
                 }
 
                 /* input args are live */
                 for(i = nb_oargs; i < nb_oargs + nb_iargs; i++) {
                     arg = args[i];
-                    if (dead_temps[arg]) {
+                    if (test_bit(arg, dead_temps)) {
                         dead_args |= (1 << i);
                     }
-                    dead_temps[arg] = 0;
+                    clear_bit(arg, dead_temps);
                 }
                 s->op_dead_args[op_index] = dead_args;
                 s->op_sync_args[op_index] = sync_args;
@@ -185,6 +185,14 @@ typedef struct TCGPool {
 
 #define TCG_POOL_CHUNK_SIZE 32768
 
+/* Size of the arena preallocated for the translation-time pool.  It must
+   cover the pool needs of one whole translation - the label table
+   (TCG_MAX_LABELS), the relocation records and the liveness arrays, all
+   bounded by TCG_MAX_LABELS/OPC_BUF_SIZE/TCG_MAX_TEMPS and together well
+   under 64K - so that steady-state translation is pure pointer bumping
+   and never reaches the chunked growth path of tcg_malloc_internal(). */
+#define TCG_POOL_ARENA_SIZE (128 * 1024)
+
 #define TCG_MAX_LABELS 512
 
 #define TCG_MAX_TEMPS 512
@@ -644,8 +652,23 @@ struct TCGContext {
     void *code_gen_prologue;
     void *code_gen_buffer;
     size_t code_gen_buffer_size;
+    /* Dual-mapped W^X buffer (see alloc_code_gen_buffer()): distance from
+       the writable view - which code_gen_buffer and every pointer derived
+       from it stay in - to the executable view of the same pages.  Zero
+       for an ordinary single RWX mapping. */
+    ptrdiff_t code_rx_delta;
     /* threshold to flush the translated code buffer */
     size_t code_gen_buffer_max_size;
+    /* eviction segments carved out of the buffer, see tb_seg_rotate() */
+    int code_gen_nb_segs;
+    size_t code_gen_seg_size;
+    /* threshold to stop allocating inside one segment */
+    size_t code_gen_seg_max_size;
+    int code_gen_seg_blocks;
+    /* region-keyed allocation groups, each owning an equal contiguous
+       run of segments; see tb_group_select() */
+    int code_gen_nb_groups;
+    int code_gen_group_segs;
     void *code_gen_ptr;
 
     TBContext tb_ctx;
@@ -659,6 +682,7 @@ struct TCGContext {
     TCGv_ptr cpu_env;
     TCGv_i32 cpu_cc_op;
     void *cpu_regs[16]; // 16 GRP for X86-64
+    void *cpu_seg_base[6]; // segment bases as globals, see optimize_flags_init()
     int x86_64_hregs;   // qemu/target-i386/translate.c
     uint8_t gen_opc_cc_op[OPC_BUF_SIZE];    // qemu/target-i386/translate.c
 
@@ -758,6 +782,8 @@ struct TCGContext {
     void *cpu_wim;
 
     int exitreq_label;  // gen_tb_start()
+    int icount_label;   // gen_tb_start(), instruction count budget
+    TCGArg *icount_arg; // patched with the TB's instruction count in gen_tb_end()
 };
 
 typedef struct TCGTargetOpDef {
@@ -867,7 +893,21 @@ static inline ptrdiff_t tcg_ptr_byte_diff(void *a, void *b)
 
 static inline ptrdiff_t tcg_pcrel_diff(TCGContext *s, void *target)
 {
-    return tcg_ptr_byte_diff(target, s->code_ptr);
+    ptrdiff_t diff = tcg_ptr_byte_diff(target, s->code_ptr);
+
+    /* With a dual-mapped W^X buffer the bytes being emitted execute
+       code_rx_delta away from where they are written.  In-buffer targets
+       (labels, slow-path return points, the prologue) shift along with
+       the executing pc, so their displacement is unchanged; out-of-buffer
+       targets (helper functions) do not and must be rebased.  The
+       prologue sits in the 1024 bytes stolen off the end of the mapping
+       in code_gen_alloc(), hence the bound.  */
+    if (s->code_rx_delta != 0 &&
+        !(target >= s->code_gen_buffer &&
+          target < s->code_gen_prologue + 1024)) {
+        diff -= s->code_rx_delta;
+    }
+    return diff;
 }
 
 /**
@@ -932,8 +972,11 @@ static inline size_t tcg_current_code_size(TCGContext *s)
 #define TB_EXIT_REQUESTED 3
 
 #if !defined(tcg_qemu_tb_exec)
+/* enter through the executable view of the prologue; code_rx_delta is 0
+   unless the buffer is dual-mapped for W^X hosts */
 # define tcg_qemu_tb_exec(env, tb_ptr) \
-    ((uintptr_t (*)(void *, void *))tcg_ctx->code_gen_prologue)(env, tb_ptr)
+    ((uintptr_t (*)(void *, void *))(tcg_ctx->code_gen_prologue + \
+                                     tcg_ctx->code_rx_delta))(env, tb_ptr)
 #endif
 
 /*
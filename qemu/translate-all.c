@@ -62,8 +62,7 @@
 #include "qemu/timer.h"
 
 #include "uc_priv.h"
-
-#define USE_STATIC_CODE_GEN_BUFFER
+#include "uc_probe.h"
 
 //#define DEBUG_TB_INVALIDATE
 //#define DEBUG_FLUSH
@@ -75,14 +74,14 @@
 #undef DEBUG_TB_CHECK
 #endif
 
-#define SMC_BITMAP_USE_THRESHOLD 10
-
 typedef struct PageDesc {
     /* list of TBs intersecting this ram page */
     TranslationBlock *first_tb;
-    /* in order to optimize self modifying code, we count the number
-       of lookups we do to a given page to use a bitmap */
-    unsigned int code_write_count;
+    /* byte-granular map of which bytes hold translated code, built on the
+       first guest write to the page; lets writes next to (not over) code
+       skip TB invalidation entirely.  Bits are only ever set while TBs
+       come and go (conservative), the map is dropped when code on the
+       page is actually invalidated */
     uint8_t *code_bitmap;
 #if defined(CONFIG_USER_ONLY)
     unsigned long flags;
@@ -130,28 +129,35 @@ static TranslationBlock *tb_find_pc(struct uc_struct *uc, uintptr_t tc_ptr);
 
 static void cpu_gen_init(struct uc_struct *uc)
 {
-    uc->tcg_ctx = g_malloc(sizeof(TCGContext));
+    /* zero-filled by the allocator rather than memset by
+       tcg_context_init(): the context is dominated by translation
+       scratch arrays (gen_opc_*, temps) that would otherwise all be
+       faulted in before the first instruction is ever translated */
+    uc->tcg_ctx = g_malloc0(sizeof(TCGContext));
     tcg_context_init(uc->tcg_ctx);
 }
 
-static void tb_clean_internal(struct uc_struct *uc, int i, void** lp)
-{
-    if (i == 0 || lp == 0) {
-        return;
-    }
-    tb_clean_internal(uc, i-1, (*lp) + ((0 >> (i * V_L2_BITS)) & (V_L2_SIZE - 1)));
-    if (lp && *lp) {
-        g_free(*lp);
-    }
-}
+static void page_flush_tb(struct uc_struct *uc);
+static inline void free_code_gen_buffer(struct uc_struct *uc);
 
 void tb_cleanup(struct uc_struct *uc)
 {
-    int index = 0;
-    /* Level 1.  Always allocated.  */
-    void** lp = uc->l1_map + ((index >> V_L1_SHIFT) & (V_L1_SIZE - 1));
-    /* Level 2..N-1.  */
-    tb_clean_internal(uc, V_L1_SHIFT / V_L2_BITS, lp);
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+
+    /* frees every allocated level below l1_map, not just the first-index
+       path: page descriptors of all translated pages are reclaimed */
+    page_flush_tb(uc);
+
+    g_free(tcg_ctx->tb_ctx.tbs);
+    tcg_ctx->tb_ctx.tbs = NULL;
+    g_free(tcg_ctx->tb_ctx.tb_phys_hash);
+    tcg_ctx->tb_ctx.tb_phys_hash = NULL;
+    g_free(tcg_ctx->tb_ctx.crosspage_links);
+    tcg_ctx->tb_ctx.crosspage_links = NULL;
+    tcg_ctx->tb_ctx.crosspage_count = 0;
+    tcg_ctx->tb_ctx.crosspage_capacity = 0;
+    free_code_gen_buffer(uc);
+    tcg_ctx->code_gen_buffer = NULL;
 }
 
 /* return non zero if the very first instruction is invalid so that
@@ -237,6 +243,10 @@ static int cpu_restore_state_from_tb(CPUState *cpu, TranslationBlock *tb,
 #ifdef CONFIG_PROFILER
     ti = profile_getclock();
 #endif
+    /* host return addresses come from the executable view of a
+       dual-mapped buffer; tc_ptr values live in the writable one */
+    searched_pc -= s->code_rx_delta;
+
     tcg_func_start(s);
 
     gen_intermediate_code_pc(env, tb);
@@ -313,16 +323,27 @@ static inline void map_exec(void *addr, long size)
 
 static void page_size_init(void)
 {
+    uintptr_t real_size, size;
+
+    /* These are host constants shared by every engine of this arch
+       variant, so a second engine initializing concurrently would store
+       the exact same values; skip the redundant stores and order the
+       first ones so no reader sees the mask without the sizes. */
+    if (qemu_host_page_mask != 0) {
+        return;
+    }
+
     /* NOTE: we can always suppose that qemu_host_page_size >=
        TARGET_PAGE_SIZE */
-    qemu_real_host_page_size = getpagesize();
-    if (qemu_host_page_size == 0) {
-        qemu_host_page_size = qemu_real_host_page_size;
-    }
-    if (qemu_host_page_size < TARGET_PAGE_SIZE) {
-        qemu_host_page_size = TARGET_PAGE_SIZE;
-    }
-    qemu_host_page_mask = ~(qemu_host_page_size - 1);
+    real_size = getpagesize();
+    size = real_size;
+    if (size < TARGET_PAGE_SIZE) {
+        size = TARGET_PAGE_SIZE;
+    }
+    qemu_real_host_page_size = real_size;
+    qemu_host_page_size = size;
+    smp_wmb();
+    qemu_host_page_mask = ~(size - 1);
 }
 
 static void page_init(void)
@@ -507,23 +528,27 @@ static inline PageDesc *page_find(struct uc_struct *uc, tb_page_addr_t index)
   (DEFAULT_CODE_GEN_BUFFER_SIZE_1 < MAX_CODE_GEN_BUFFER_SIZE \
    ? DEFAULT_CODE_GEN_BUFFER_SIZE_1 : MAX_CODE_GEN_BUFFER_SIZE)
 
+/* Trimmed buffer for UC_MODE_SMALL engines: snippet-sized emulations only
+   ever hold a handful of live blocks, and thousands of concurrent
+   instances must fit on one host.  Deliberately below
+   MIN_CODE_GEN_BUFFER_SIZE, which keeps gating explicit resizes.  */
+#define SMALL_CODE_GEN_BUFFER_SIZE   (512u * 1024)
+
 static inline size_t size_code_gen_buffer(struct uc_struct *uc, size_t tb_size)
 {
     TCGContext *tcg_ctx = uc->tcg_ctx;
 
     /* Size the buffer.  */
     if (tb_size == 0) {
-#ifdef USE_STATIC_CODE_GEN_BUFFER
-        tb_size = DEFAULT_CODE_GEN_BUFFER_SIZE;
-#else
-        /* ??? Needs adjustments.  */
-        /* ??? If we relax the requirement that CONFIG_USER_ONLY use the
-           static buffer, we could size this on RESERVED_VA, on the text
-           segment size of the executable, or continue to use the default.  */
-        tb_size = (unsigned long)(uc->ram_size / 4);
-#endif
-    }
-    if (tb_size < MIN_CODE_GEN_BUFFER_SIZE) {
+        /* guest RAM is not sized yet when the machine initializes, so a
+           fraction-of-ram heuristic is useless here; start every engine
+           from the fixed default and let uc_tcg_buffer_resize() tune it */
+        if (uc->mode & UC_MODE_SMALL) {
+            tb_size = SMALL_CODE_GEN_BUFFER_SIZE;
+        } else {
+            tb_size = DEFAULT_CODE_GEN_BUFFER_SIZE;
+        }
+    } else if (tb_size < MIN_CODE_GEN_BUFFER_SIZE) {
         tb_size = MIN_CODE_GEN_BUFFER_SIZE;
     }
     if (tb_size > MAX_CODE_GEN_BUFFER_SIZE) {
@@ -577,7 +602,62 @@ static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
     map_exec(buf, tcg_ctx->code_gen_buffer_size);
     return buf;
 }
+
+static inline void free_code_gen_buffer(struct uc_struct *uc)
+{
+    /* static array; nothing to release */
+}
 #elif defined(USE_MMAP)
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/* Dual-mapped W^X fallback: the same pages mapped twice through a memfd,
+   one RW view for the translator and one RX view for execution.  Hosts
+   enforcing W^X (SELinux deny_execmem, PaX MPROTECT, OpenBSD-style
+   policies) refuse the plain RWX mapping below; with two views nothing
+   is ever writable and executable at once and no mprotect flipping per
+   translation is needed.  All internal pointers stay in the RW view;
+   tcg_ctx->code_rx_delta rebases the few places that hand addresses to
+   (or take them from) executing code. */
+static void *alloc_code_gen_buffer_splitwx(struct uc_struct *uc)
+{
+#if defined(__linux__) && defined(__NR_memfd_create)
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    size_t size = tcg_ctx->code_gen_buffer_size;
+    void *rw, *rx;
+    int fd;
+
+    fd = syscall(__NR_memfd_create, "unicorn-tcg", 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, size) < 0) {
+        close(fd);
+        return NULL;
+    }
+    rw = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (rw == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    rx = mmap(NULL, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+    if (rx == MAP_FAILED) {
+        munmap(rw, size);
+        close(fd);
+        return NULL;
+    }
+    /* the mappings keep the memory object alive */
+    close(fd);
+
+    tcg_ctx->code_rx_delta = (char *)rx - (char *)rw;
+    return rw;
+#else
+    return NULL;
+#endif
+}
+
 static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
 {
     int flags = MAP_PRIVATE | MAP_ANONYMOUS;
@@ -585,6 +665,8 @@ static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
     void *buf;
     TCGContext *tcg_ctx = uc->tcg_ctx;
 
+    tcg_ctx->code_rx_delta = 0;
+
     /* Constrain the position of the buffer based on the host cpu.
        Note that these addresses are chosen in concert with the
        addresses assigned in the relevant linker script file.  */
@@ -619,7 +701,8 @@ static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
     buf = mmap((void *)start, tcg_ctx->code_gen_buffer_size,
                PROT_WRITE | PROT_READ | PROT_EXEC, flags, -1, 0);
     if (buf == MAP_FAILED) {
-        return NULL;
+        /* the host may simply forbid RWX mappings: retry dual-mapped */
+        return alloc_code_gen_buffer_splitwx(uc);
     }
 
 #ifdef __mips__
@@ -649,6 +732,47 @@ static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
 
     return buf;
 }
+
+static inline void free_code_gen_buffer(struct uc_struct *uc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+
+    if (tcg_ctx->code_gen_buffer) {
+        /* the prologue bytes stolen in code_gen_alloc() belong to the
+           same mapping */
+        if (tcg_ctx->code_rx_delta != 0) {
+            munmap(tcg_ctx->code_gen_buffer + tcg_ctx->code_rx_delta,
+                   tcg_ctx->code_gen_buffer_size + 1024);
+            tcg_ctx->code_rx_delta = 0;
+        }
+        munmap(tcg_ctx->code_gen_buffer,
+               tcg_ctx->code_gen_buffer_size + 1024);
+    }
+}
+#elif defined(_WIN32)
+static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+
+    /* A dedicated executable mapping, not heap memory flipped to RWX
+       with VirtualProtect: the buffer does not inflate the heap, honors
+       whatever size uc_tcg_buffer_resize() asked for, and is returned
+       to the OS as a whole by free_code_gen_buffer().  */
+    tcg_ctx->code_rx_delta = 0;
+    return VirtualAlloc(NULL, tcg_ctx->code_gen_buffer_size,
+                        MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+}
+
+static inline void free_code_gen_buffer(struct uc_struct *uc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+
+    if (tcg_ctx->code_gen_buffer) {
+        /* releases the whole allocation, including the prologue bytes
+           stolen in code_gen_alloc() */
+        VirtualFree(tcg_ctx->code_gen_buffer, 0, MEM_RELEASE);
+    }
+}
 #else
 static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
 {
@@ -658,6 +782,7 @@ static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
     if (buf == NULL) {
         return NULL;
     }
+    tcg_ctx->code_rx_delta = 0;
 
 #ifdef __mips__
     if (cross_256mb(buf, tcg_ctx->code_gen_buffer_size)) {
@@ -678,11 +803,35 @@ static inline void *alloc_code_gen_buffer(struct uc_struct *uc)
     map_exec(buf, tcg_ctx->code_gen_buffer_size);
     return buf;
 }
-#endif /* USE_STATIC_CODE_GEN_BUFFER, USE_MMAP */
+
+static inline void free_code_gen_buffer(struct uc_struct *uc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+
+    g_free(tcg_ctx->code_gen_buffer);
+}
+#endif /* USE_STATIC_CODE_GEN_BUFFER, USE_MMAP, _WIN32 */
+
+/* Park every allocation group's cursor at the start of its first segment
+   and make group 0 the active one (cur_seg/code_gen_ptr). */
+static void tb_group_reset(TCGContext *tcg_ctx)
+{
+    int g;
+
+    for (g = 0; g < tcg_ctx->code_gen_nb_groups; g++) {
+        tcg_ctx->tb_ctx.group_cur_seg[g] = g * tcg_ctx->code_gen_group_segs;
+        tcg_ctx->tb_ctx.group_gen_ptr[g] =
+                (uint8_t *)tcg_ctx->code_gen_buffer +
+                (size_t)g * tcg_ctx->code_gen_group_segs *
+                tcg_ctx->code_gen_seg_size;
+    }
+    tcg_ctx->tb_ctx.cur_group = 0;
+}
 
 static inline void code_gen_alloc(struct uc_struct *uc, size_t tb_size)
 {
     TCGContext *tcg_ctx = uc->tcg_ctx;
+    size_t hash_size;
 
     tcg_ctx->code_gen_buffer_size = size_code_gen_buffer(uc, tb_size);
     tcg_ctx->code_gen_buffer = alloc_code_gen_buffer(uc);
@@ -694,6 +843,10 @@ static inline void code_gen_alloc(struct uc_struct *uc, size_t tb_size)
     //qemu_madvise(tcg_ctx.code_gen_buffer, tcg_ctx.code_gen_buffer_size,
     //        QEMU_MADV_HUGEPAGE);
 
+    /* keep the effective size where uc_query() can reach it, before the
+       prologue steals its room below */
+    uc->tcg_buffer_size = tcg_ctx->code_gen_buffer_size;
+
     /* Steal room for the prologue at the end of the buffer.  This ensures
        (via the MAX_CODE_GEN_BUFFER_SIZE limits above) that direct branches
        from TB's to the prologue are going to be in range.  It also means
@@ -705,10 +858,47 @@ static inline void code_gen_alloc(struct uc_struct *uc, size_t tb_size)
 
     tcg_ctx->code_gen_buffer_max_size = tcg_ctx->code_gen_buffer_size -
         (TCG_MAX_OP_SIZE * OPC_BUF_SIZE);
-    tcg_ctx->code_gen_max_blocks = tcg_ctx->code_gen_buffer_size /
+
+    /* Carve the buffer into eviction segments.  Each must comfortably hold
+       the worst-case expansion of a single TB, so small buffers get fewer
+       segments; one segment degenerates to the old whole-buffer flush.  */
+    tcg_ctx->code_gen_nb_segs = CODE_GEN_MAX_SEGS;
+    while (tcg_ctx->code_gen_nb_segs > 1 &&
+           tcg_ctx->code_gen_buffer_size / tcg_ctx->code_gen_nb_segs <
+           4 * (TCG_MAX_OP_SIZE * OPC_BUF_SIZE)) {
+        tcg_ctx->code_gen_nb_segs /= 2;
+    }
+    tcg_ctx->code_gen_seg_size = tcg_ctx->code_gen_buffer_size /
+            tcg_ctx->code_gen_nb_segs;
+    tcg_ctx->code_gen_seg_max_size = tcg_ctx->code_gen_seg_size -
+        (TCG_MAX_OP_SIZE * OPC_BUF_SIZE);
+    tcg_ctx->code_gen_seg_blocks = tcg_ctx->code_gen_seg_size /
             CODE_GEN_AVG_BLOCK_SIZE;
+    tcg_ctx->code_gen_max_blocks = tcg_ctx->code_gen_seg_blocks *
+            tcg_ctx->code_gen_nb_segs;
+    /* parcel the segments out to region-keyed allocation groups; both
+       counts are powers of two, so the split is always even */
+    tcg_ctx->code_gen_nb_groups = MIN(CODE_GEN_MAX_GROUPS,
+            tcg_ctx->code_gen_nb_segs);
+    tcg_ctx->code_gen_group_segs = tcg_ctx->code_gen_nb_segs /
+            tcg_ctx->code_gen_nb_groups;
     tcg_ctx->tb_ctx.tbs =
             g_malloc(tcg_ctx->code_gen_max_blocks * sizeof(TranslationBlock));
+    /* size the phys hash with the block budget: the next power of two
+       above twice the maximum keeps the load factor under 1/2, so
+       tb_find_slow() chains stay short however full the cache gets
+       (g_free handles both first allocation and a buffer resize) */
+    hash_size = 1;
+    while (hash_size < (size_t)tcg_ctx->code_gen_max_blocks * 2) {
+        hash_size <<= 1;
+    }
+    g_free(tcg_ctx->tb_ctx.tb_phys_hash);
+    tcg_ctx->tb_ctx.tb_phys_hash =
+            g_malloc0(hash_size * sizeof(TranslationBlock *));
+    tcg_ctx->tb_ctx.tb_phys_hash_mask = hash_size - 1;
+    tcg_ctx->tb_ctx.cur_seg = 0;
+    memset(tcg_ctx->tb_ctx.seg_nb_tbs, 0, sizeof(tcg_ctx->tb_ctx.seg_nb_tbs));
+    tb_group_reset(tcg_ctx);
 }
 
 /* Must be called before using the QEMU cpus. 'tb_size' is the size
@@ -737,35 +927,893 @@ bool tcg_enabled(struct uc_struct *uc)
     return tcg_ctx->code_gen_buffer != NULL;
 }
 
-/* Allocate a new translation block. Flush the translation buffer if
-   too many translation blocks or too much generated code. */
+/* Replace this engine's translation cache with one of @tb_size bytes and
+   recompute the derived TB count. Every cached translation is dropped:
+   host code pointers into the old buffer die with it. Returns false when
+   the size is out of range or the buffer cannot be replaced. */
+bool tcg_buffer_resize(struct uc_struct *uc, size_t tb_size)
+{
+#ifdef USE_STATIC_CODE_GEN_BUFFER
+    /* a static buffer cannot change size */
+    return false;
+#else
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    CPUState *cpu;
+
+    if (tb_size < MIN_CODE_GEN_BUFFER_SIZE
+            || tb_size > MAX_CODE_GEN_BUFFER_SIZE) {
+        return false;
+    }
+
+    /* unlink every TB while the old buffer is still in place */
+    CPU_FOREACH(cpu) {
+        tb_flush(cpu->env_ptr);
+    }
+
+    free_code_gen_buffer(uc);
+    g_free(tcg_ctx->tb_ctx.tbs);
+    code_gen_alloc(uc, tb_size);
+    tcg_ctx->code_gen_ptr = tcg_ctx->code_gen_buffer;
+    tcg_prologue_init(tcg_ctx);
+    return true;
+#endif
+}
+
+/* Translate the guest code in [addr, addr+size) ahead of execution, with
+   the current CPU state supplying the translation mode and flags.  Blocks
+   already in the cache are skipped, so calling this twice is cheap.
+   Returns the number of blocks cached for the range; 0 when even the
+   first page cannot be fetched.  Translation stops early at invalid code
+   or when a block crosses out of mapped memory - executing that spot
+   would fault anyway, and the fault is better raised at execution time,
+   where the memory hooks are in place. */
+size_t tb_prewarm(struct uc_struct *uc, uint64_t addr, size_t size)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    CPUState *cpu = uc->cpu;
+    CPUArchState *env = cpu->env_ptr;
+    TranslationBlock *tb, **ptb1;
+    target_ulong pc, cs_base, cur_pc;
+    tb_page_addr_t phys_pc, phys_page1;
+    int flags;
+    uint64_t end = addr + size;
+    unsigned int h;
+    volatile size_t count = 0;
+
+    /* only the pc differs per block; mode and flags come from the cpu */
+    cpu_get_tb_cpu_state(env, &cur_pc, &cs_base, &flags);
+
+    if (sigsetjmp(cpu->jmp_env, 0) != 0) {
+        /* a fetch crossed into unmapped or protected memory mid-block;
+           keep what was translated so far */
+        return count;
+    }
+
+    pc = addr;
+    while (pc < end) {
+        phys_pc = get_page_addr_code(env, pc);
+        if (phys_pc == -1) {
+            break;
+        }
+        phys_page1 = phys_pc & TARGET_PAGE_MASK;
+        h = tb_phys_hash_func(phys_pc, tcg_ctx->tb_ctx.tb_phys_hash_mask);
+        for (ptb1 = &tcg_ctx->tb_ctx.tb_phys_hash[h]; (tb = *ptb1) != NULL;
+                ptb1 = &tb->phys_hash_next) {
+            if (tb->pc == pc && tb->cs_base == cs_base &&
+                    tb->flags == flags && tb->page_addr[0] == phys_page1) {
+                break;
+            }
+        }
+        if (tb == NULL) {
+            tb = tb_gen_code(cpu, pc, cs_base, flags, 0);
+        }
+        if (tb->size == 0) {
+            /* invalid instruction */
+            break;
+        }
+        count++;
+        pc += tb->size;
+    }
+    return count;
+}
+
+/* Speculatively translate the static successors of a freshly generated
+   block (see uc_translate_readahead()).  Called from the translation miss
+   path in tb_find_slow(): one miss in cold code predicts more just ahead,
+   so up to uc->tb_readahead fall-through blocks are translated while the
+   translator is hot, and execution then streams through warm cache.  A
+   wrong guess only costs an unused cache slot.  Speculative blocks are
+   never worth a segment eviction, so the walk also stops when the current
+   segment has no room left - real misses decide when to evict. */
+void tb_readahead(CPUState *cpu, TranslationBlock *tb)
+{
+    CPUArchState *env = cpu->env_ptr;
+    TCGContext *tcg_ctx = env->uc->tcg_ctx;
+    TranslationBlock *next, **ptb1;
+    target_ulong pc = tb->pc + tb->size;
+    target_ulong cs_base = tb->cs_base;
+    int flags = tb->flags;
+    int seg;
+    uint8_t *seg_base;
+    tb_page_addr_t phys_pc, phys_page1;
+    unsigned int h;
+    uint32_t n;
+    sigjmp_buf saved_jmp;
+
+    /* the caller sits inside the emulation's sigsetjmp scope; a fault
+       raised by a speculative fetch must not leak into it */
+    memcpy(&saved_jmp, &cpu->jmp_env, sizeof(saved_jmp));
+    if (sigsetjmp(cpu->jmp_env, 0) == 0) {
+        for (n = env->uc->tb_readahead; n > 0; n--) {
+            seg = tcg_ctx->tb_ctx.cur_seg;
+            seg_base = (uint8_t *)tcg_ctx->code_gen_buffer +
+                    (size_t)seg * tcg_ctx->code_gen_seg_size;
+            if (tcg_ctx->tb_ctx.seg_nb_tbs[seg] >=
+                        tcg_ctx->code_gen_seg_blocks ||
+                    (size_t)((uint8_t *)tcg_ctx->code_gen_ptr - seg_base) >=
+                        tcg_ctx->code_gen_seg_max_size) {
+                break;
+            }
+            phys_pc = get_page_addr_code(env, pc);
+            if (phys_pc == -1) {
+                break;
+            }
+            phys_page1 = phys_pc & TARGET_PAGE_MASK;
+            h = tb_phys_hash_func(phys_pc, tcg_ctx->tb_ctx.tb_phys_hash_mask);
+            for (ptb1 = &tcg_ctx->tb_ctx.tb_phys_hash[h];
+                    (next = *ptb1) != NULL; ptb1 = &next->phys_hash_next) {
+                if (next->pc == pc && next->cs_base == cs_base &&
+                        next->flags == flags &&
+                        next->page_addr[0] == phys_page1) {
+                    break;
+                }
+            }
+            if (next == NULL) {
+                next = tb_gen_code(cpu, pc, cs_base, flags, 0);
+            }
+            if (next->size == 0) {
+                /* invalid instruction - likely past the end of the code */
+                break;
+            }
+            pc += next->size;
+        }
+    }
+    memcpy(&cpu->jmp_env, &saved_jmp, sizeof(saved_jmp));
+}
+
+/* Recover the instruction boundaries of @tb by retranslating it in
+   search-pc mode - the machinery cpu_restore_state() already relies on
+   for faults - and cache the result on the TB.  Capture is lazy: only
+   blocks actually queried through uc_tb_meta() pay for it, once per
+   translation.  The bytes are read back through the debug accessor,
+   which reports errors instead of faulting. */
+static void tb_meta_capture(CPUState *cpu, TranslationBlock *tb)
+{
+    CPUArchState *env = cpu->env_ptr;
+    TCGContext *s = cpu->uc->tcg_ctx;
+    uc_tb_insn *insns;
+    uint64_t next;
+    uint32_t n, len;
+    int j, nb_ops;
+
+    tcg_func_start(s);
+    gen_intermediate_code_pc(env, tb);
+    nb_ops = (int)(s->gen_opc_ptr - s->gen_opc_buf);
+
+    insns = g_malloc0(tb->icount * sizeof(*insns));
+    n = 0;
+    for (j = 0; j < nb_ops && n < tb->icount; j++) {
+        if (s->gen_opc_instr_start[j]) {
+            insns[n++].address = s->gen_opc_pc[j];
+        }
+    }
+    for (j = 0; j < (int)n; j++) {
+        next = j + 1 < (int)n ? insns[j + 1].address
+                              : (uint64_t)tb->pc + tb->size;
+        /* sizes come from consecutive boundaries; across the folded jump
+           of a superblock the stream is not contiguous and the distance
+           is meaningless, so only read back what the buffer can hold */
+        insns[j].size = next > insns[j].address ?
+                (uint32_t)(next - insns[j].address) : 0;
+        len = MIN(insns[j].size, (uint32_t)sizeof(insns[j].bytes));
+        if (len != 0) {
+            cpu_memory_rw_debug(cpu, insns[j].address, insns[j].bytes,
+                                len, 0);
+        }
+    }
+
+    tb->insn_meta = insns;
+    s->tb_ctx.nb_insn_meta++;
+}
+
+/* Look up the live translation starting at @addr and report its
+   instruction boundaries through @insns/@count (see uc_tb_meta()); with
+   @insns NULL only the instruction count is reported.  Returns nonzero
+   when no live translation starts at @addr. */
+int tb_meta_get(struct uc_struct *uc, uint64_t addr, uc_tb_insn *insns,
+                uint32_t *count)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    CPUState *cpu = uc->cpu;
+    CPUArchState *env = cpu->env_ptr;
+    TranslationBlock *tb, **ptb1;
+    TranslationBlock * volatile hit = NULL;
+    target_ulong pc = addr, cur_pc, cs_base;
+    tb_page_addr_t phys_pc, phys_page1;
+    int flags;
+    unsigned int h;
+    uint32_t n;
+    sigjmp_buf saved_jmp;
+
+    /* only the pc is the caller's; mode and flags come from the cpu */
+    cpu_get_tb_cpu_state(env, &cur_pc, &cs_base, &flags);
+
+    /* a query for an unmapped address must not unwind the caller - it
+       usually sits inside a hook, under the emulation's sigsetjmp scope */
+    memcpy(&saved_jmp, &cpu->jmp_env, sizeof(saved_jmp));
+    if (sigsetjmp(cpu->jmp_env, 0) == 0) {
+        phys_pc = get_page_addr_code(env, pc);
+        if (phys_pc != -1) {
+            phys_page1 = phys_pc & TARGET_PAGE_MASK;
+            h = tb_phys_hash_func(phys_pc, tcg_ctx->tb_ctx.tb_phys_hash_mask);
+            for (ptb1 = &tcg_ctx->tb_ctx.tb_phys_hash[h]; (tb = *ptb1) != NULL;
+                    ptb1 = &tb->phys_hash_next) {
+                if (tb->pc == pc && tb->cs_base == cs_base &&
+                        tb->flags == flags && tb->page_addr[0] == phys_page1) {
+                    break;
+                }
+            }
+            if (tb != NULL && tb->icount != 0 && insns != NULL &&
+                    tb->insn_meta == NULL) {
+                tb_meta_capture(cpu, tb);
+            }
+            hit = tb;
+        }
+    }
+    memcpy(&cpu->jmp_env, &saved_jmp, sizeof(saved_jmp));
+
+    tb = hit;
+    if (tb == NULL || tb->icount == 0) {
+        return -1;
+    }
+    if (insns == NULL) {
+        *count = tb->icount;
+        return 0;
+    }
+    if (tb->insn_meta == NULL) {
+        /* the capture retranslation faulted mid-block */
+        return -1;
+    }
+    n = MIN(*count, tb->icount);
+    memcpy(insns, tb->insn_meta, n * sizeof(uc_tb_insn));
+    *count = n;
+    return 0;
+}
+
+/* Fill in the translation cache counters for uc_query().  Segments other
+   than the current one have no fill pointer once rotated into, so their
+   usage is reported as the whole segment - an upper bound that is exact
+   while the cache has never wrapped. */
+void tb_stats(struct uc_struct *uc, struct uc_tb_stats *stats)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    TranslationBlock *tb;
+    int seg, cur, i, g;
+    void *ptr;
+
+    memset(stats, 0, sizeof(*stats));
+    for (seg = 0; seg < tcg_ctx->code_gen_nb_segs; seg++) {
+        for (i = 0; i < tcg_ctx->tb_ctx.seg_nb_tbs[seg]; i++) {
+            tb = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks + i];
+            if (!tb->invalidated) {
+                stats->nb_tbs++;
+            }
+        }
+        /* each allocation group keeps a live fill pointer in its own
+           current segment (the active group's lives in cur_seg/ptr) */
+        g = seg / tcg_ctx->code_gen_group_segs;
+        if (g == tcg_ctx->tb_ctx.cur_group) {
+            cur = tcg_ctx->tb_ctx.cur_seg;
+            ptr = tcg_ctx->code_gen_ptr;
+        } else {
+            cur = tcg_ctx->tb_ctx.group_cur_seg[g];
+            ptr = tcg_ctx->tb_ctx.group_gen_ptr[g];
+        }
+        if (seg == cur) {
+            stats->buffer_used += (uint8_t *)ptr -
+                    ((uint8_t *)tcg_ctx->code_gen_buffer +
+                     (size_t)seg * tcg_ctx->code_gen_seg_size);
+        } else if (tcg_ctx->tb_ctx.seg_nb_tbs[seg] > 0) {
+            stats->buffer_used += tcg_ctx->code_gen_seg_size;
+        }
+    }
+    stats->flush_count = tcg_ctx->tb_ctx.tb_flush_count;
+    stats->invalidate_count = tcg_ctx->tb_ctx.tb_phys_invalidate_count;
+    stats->evict_count = tcg_ctx->tb_ctx.tb_seg_evict_count;
+}
+
+/* Accumulate the allocated bytes of one page-descriptor subtree; mirrors
+   the walk of page_tree_reclaim_1() but only reads. */
+static size_t page_tree_bytes_1(int level, void **lp)
+{
+    size_t bytes;
+    int i;
+
+    if (*lp == NULL) {
+        return 0;
+    }
+    if (level == 0) {
+        PageDesc *pd = *lp;
+
+        bytes = sizeof(PageDesc) * V_L2_SIZE;
+        for (i = 0; i < V_L2_SIZE; ++i) {
+            if (pd[i].code_bitmap) {
+                bytes += TARGET_PAGE_SIZE / 8;
+            }
+        }
+    } else {
+        void **pp = *lp;
+
+        bytes = sizeof(void *) * V_L2_SIZE;
+        for (i = 0; i < V_L2_SIZE; ++i) {
+            bytes += page_tree_bytes_1(level - 1, pp + i);
+        }
+    }
+    return bytes;
+}
+
+/* Fill in the live memory footprint for uc_query(UC_QUERY_MEM_*).  Every
+   number is bytes currently allocated, not a high-water mark; the TLB
+   tables are embedded in CPUArchState, so their share is reported even
+   though it is not a separate allocation. */
+void mem_stats(struct uc_struct *uc, struct uc_mem_stats *stats)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    size_t bits_per_long = sizeof(unsigned long) * 8;
+    size_t dirty_pages;
+    RAMBlock *block;
+    CPUState *cpu;
+    int i;
+
+    memset(stats, 0, sizeof(*stats));
+
+    stats->code_buffer = tcg_ctx->code_gen_buffer_size;
+    stats->tb_metadata =
+            tcg_ctx->code_gen_max_blocks * sizeof(TranslationBlock) +
+            ((size_t)tcg_ctx->tb_ctx.tb_phys_hash_mask + 1) *
+                    sizeof(TranslationBlock *);
+
+    if (uc->l1_map != NULL) {
+        stats->page_tables = uc->l1_map_size;
+        for (i = 0; i < V_L1_SIZE; i++) {
+            stats->page_tables +=
+                    page_tree_bytes_1(V_L1_SHIFT / V_L2_BITS - 1,
+                                      uc->l1_map + i);
+        }
+    }
+
+    CPU_FOREACH(cpu) {
+        stats->tlb += NB_MMU_MODES *
+                (CPU_TLB_SIZE * (sizeof(CPUTLBEntry) + sizeof(hwaddr)) +
+                 CPU_VTLB_SIZE * (sizeof(CPUTLBEntry) + sizeof(hwaddr)));
+    }
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        stats->guest_ram += block->length;
+    }
+
+    dirty_pages = last_ram_offset(uc) >> TARGET_PAGE_BITS;
+    for (i = 0; i < DIRTY_MEMORY_NUM; i++) {
+        if (uc->ram_list.dirty_memory[i] != NULL) {
+            stats->dirty_bitmaps +=
+                    (dirty_pages + bits_per_long - 1) / bits_per_long *
+                    sizeof(unsigned long);
+        }
+    }
+}
+
+/* Persistent translation cache.  Generated host code is full of absolute
+   addresses: helper call displacements, the TranslationBlock pointers
+   loaded by exit_tb, the uc_struct handed to the tracecode helpers.  A
+   saved cache is therefore only usable in a later process whose layout
+   matches byte for byte - same executable base, same code buffer, TB
+   array and uc_struct addresses.  The loader verifies all of that, plus
+   a hash of the guest bytes behind every block, and rejects the file (or
+   skips single blocks) when anything moved; the engine then simply
+   translates as usual.  Identical short-lived processes replaying one
+   guest image - the case worth optimizing - pass the checks. */
+
+#define TB_CACHE_MAGIC    0x55435443  /* "UCTC" */
+#define TB_CACHE_VERSION  3
+
+struct tb_cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t arch;
+    uint32_t mode;
+    uint32_t target_bits;
+    uint32_t nb_segs;
+    uint32_t nb_groups;
+    uint64_t seg_size;
+    uint64_t buffer_size;
+    uint64_t text_base;      /* address of a reference function */
+    uint64_t buffer_base;
+    uint64_t tbs_base;
+    uint64_t uc_base;
+    uint32_t cur_seg;
+    uint32_t cur_group;
+    uint32_t nb_tbs;
+    uint64_t code_gen_off;   /* code_gen_ptr - code_gen_buffer */
+    /* per-group cursors; the active group's mirror cur_seg/code_gen_off */
+    uint32_t group_cur_seg[CODE_GEN_MAX_GROUPS];
+    uint64_t group_gen_off[CODE_GEN_MAX_GROUPS];
+};
+
+struct tb_cache_entry {
+    uint64_t pc;
+    uint64_t cs_base;
+    uint64_t flags;
+    uint64_t page_addr[2];
+    uint64_t tc_off;         /* tc_ptr - code_gen_buffer */
+    uint64_t guest_hash;
+    uint32_t icount;
+    uint32_t seg;
+    uint16_t size;
+    uint16_t cflags;
+    uint16_t tb_next_offset[2];
+    uint16_t tb_jmp_offset[2];  /* unused without USE_DIRECT_JUMP */
+    /* superblock follow budget; a search_pc retranslation must replay
+       the same instruction stream the saved code was generated from */
+    uint8_t sb_follow;
+    uint8_t pad[3];
+};
+
+/* resolve a ram offset to its host pointer without the abort() in
+   qemu_get_ram_ptr(); NULL when nothing is mapped there */
+static uint8_t *tb_cache_ram_ptr(struct uc_struct *uc, ram_addr_t addr)
+{
+    RAMBlock *block;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        if (addr - block->offset < block->length) {
+            return block->host + (addr - block->offset);
+        }
+    }
+    return NULL;
+}
+
+/* FNV-1a over the guest bytes a TB was translated from; false when the
+   backing pages are gone */
+static bool tb_cache_guest_hash(struct uc_struct *uc, uint64_t pc,
+                                uint16_t size, const uint64_t *page_addr,
+                                uint64_t *hash)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    uint32_t first, i;
+    uint8_t *p;
+
+    if (size == 0) {
+        return false;
+    }
+    first = TARGET_PAGE_SIZE - (pc & ~TARGET_PAGE_MASK);
+    if (first > size) {
+        first = size;
+    }
+    p = tb_cache_ram_ptr(uc, page_addr[0] + (pc & ~TARGET_PAGE_MASK));
+    if (p == NULL) {
+        return false;
+    }
+    for (i = 0; i < first; i++) {
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    if (first < size) {
+        if (page_addr[1] == (uint64_t)-1) {
+            return false;
+        }
+        p = tb_cache_ram_ptr(uc, page_addr[1]);
+        if (p == NULL) {
+            return false;
+        }
+        for (i = 0; i < size - first; i++) {
+            h = (h ^ p[i]) * 0x100000001b3ULL;
+        }
+    }
+    *hash = h;
+    return true;
+}
+
+static void tb_cache_fill_header(struct uc_struct *uc,
+                                 struct tb_cache_header *h)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+
+    memset(h, 0, sizeof(*h));
+    h->magic = TB_CACHE_MAGIC;
+    h->version = TB_CACHE_VERSION;
+    h->arch = uc->arch;
+    h->mode = uc->mode;
+    h->target_bits = TARGET_LONG_BITS;
+    h->nb_segs = tcg_ctx->code_gen_nb_segs;
+    h->nb_groups = tcg_ctx->code_gen_nb_groups;
+    h->seg_size = tcg_ctx->code_gen_seg_size;
+    h->buffer_size = tcg_ctx->code_gen_buffer_size;
+    h->text_base = (uint64_t)(uintptr_t)tb_flush;
+    h->buffer_base = (uint64_t)(uintptr_t)tcg_ctx->code_gen_buffer;
+    h->tbs_base = (uint64_t)(uintptr_t)tcg_ctx->tb_ctx.tbs;
+    h->uc_base = (uint64_t)(uintptr_t)uc;
+}
+
+bool tb_cache_save(struct uc_struct *uc, const char *path)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    struct tb_cache_header hdr;
+    struct tb_cache_entry ent;
+    TranslationBlock *tb;
+    FILE *f;
+    uint64_t used;
+    bool ok;
+    int seg, i, g;
+
+    /* saved code encodes pc-relative helper displacements computed with
+       this run's RW/RX split; the loader's layout checks cannot account
+       for that, so refuse to save under a dual-mapped buffer */
+    if (tcg_ctx->code_rx_delta != 0) {
+        return false;
+    }
+
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        return false;
+    }
+
+    tb_cache_fill_header(uc, &hdr);
+    hdr.cur_seg = tcg_ctx->tb_ctx.cur_seg;
+    hdr.cur_group = tcg_ctx->tb_ctx.cur_group;
+    hdr.code_gen_off = (uint64_t)((uint8_t *)tcg_ctx->code_gen_ptr -
+            (uint8_t *)tcg_ctx->code_gen_buffer);
+    for (g = 0; g < tcg_ctx->code_gen_nb_groups; g++) {
+        if (g == tcg_ctx->tb_ctx.cur_group) {
+            hdr.group_cur_seg[g] = hdr.cur_seg;
+            hdr.group_gen_off[g] = hdr.code_gen_off;
+        } else {
+            hdr.group_cur_seg[g] = tcg_ctx->tb_ctx.group_cur_seg[g];
+            hdr.group_gen_off[g] =
+                    (uint64_t)((uint8_t *)tcg_ctx->tb_ctx.group_gen_ptr[g] -
+                    (uint8_t *)tcg_ctx->code_gen_buffer);
+        }
+    }
+    /* entry count is patched in below, once it is known */
+    fwrite(&hdr, sizeof(hdr), 1, f);
+
+    /* the used span of every segment; tails past the last block are
+       written as-is and simply never executed after a reload */
+    for (seg = 0; seg < tcg_ctx->code_gen_nb_segs; seg++) {
+        g = seg / tcg_ctx->code_gen_group_segs;
+        if (seg == (int)hdr.group_cur_seg[g]) {
+            used = hdr.group_gen_off[g] -
+                    (uint64_t)seg * tcg_ctx->code_gen_seg_size;
+        } else if (tcg_ctx->tb_ctx.seg_nb_tbs[seg] != 0) {
+            used = tcg_ctx->code_gen_seg_size;
+        } else {
+            used = 0;
+        }
+        fwrite(&used, sizeof(used), 1, f);
+        if (used != 0) {
+            fwrite((uint8_t *)tcg_ctx->code_gen_buffer +
+                   (size_t)seg * tcg_ctx->code_gen_seg_size, 1, used, f);
+        }
+    }
+
+    for (seg = 0; seg < tcg_ctx->code_gen_nb_segs; seg++) {
+        for (i = 0; i < tcg_ctx->tb_ctx.seg_nb_tbs[seg]; i++) {
+            tb = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks + i];
+            memset(&ent, 0, sizeof(ent));
+            ent.pc = tb->pc;
+            ent.cs_base = tb->cs_base;
+            ent.flags = tb->flags;
+            ent.page_addr[0] = tb->page_addr[0];
+            ent.page_addr[1] = tb->page_addr[1] == (tb_page_addr_t)-1 ?
+                    (uint64_t)-1 : (uint64_t)tb->page_addr[1];
+            ent.tc_off = (uint64_t)((uint8_t *)tb->tc_ptr -
+                    (uint8_t *)tcg_ctx->code_gen_buffer);
+            ent.icount = tb->icount;
+            ent.seg = seg;
+            ent.size = tb->size;
+            ent.cflags = tb->cflags;
+            ent.tb_next_offset[0] = tb->tb_next_offset[0];
+            ent.tb_next_offset[1] = tb->tb_next_offset[1];
+#ifdef USE_DIRECT_JUMP
+            ent.tb_jmp_offset[0] = tb->tb_jmp_offset[0];
+            ent.tb_jmp_offset[1] = tb->tb_jmp_offset[1];
+#endif
+            ent.sb_follow = tb->sb_follow;
+            if (tb->invalidated ||
+                !tb_cache_guest_hash(uc, ent.pc, ent.size, ent.page_addr,
+                                     &ent.guest_hash)) {
+                continue;
+            }
+            fwrite(&ent, sizeof(ent), 1, f);
+            hdr.nb_tbs++;
+        }
+    }
+
+    fseek(f, 0, SEEK_SET);
+    fwrite(&hdr, sizeof(hdr), 1, f);
+    ok = !ferror(f);
+    if (fclose(f) != 0) {
+        return false;
+    }
+    return ok;
+}
+
+bool tb_cache_load(struct uc_struct *uc, const char *path)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    struct tb_cache_header hdr, cur;
+    struct tb_cache_entry ent;
+    TranslationBlock *tb;
+    FILE *f;
+    uint64_t used, hash;
+    uint32_t n;
+    int seg, g;
+
+    /* see tb_cache_save(): cached displacements assume a direct-mapped
+       buffer */
+    if (tcg_ctx->code_rx_delta != 0) {
+        return false;
+    }
+
+    /* only into a fresh cache: restored code would clash with blocks
+       translated already */
+    for (seg = 0; seg < tcg_ctx->code_gen_nb_segs; seg++) {
+        if (tcg_ctx->tb_ctx.seg_nb_tbs[seg] != 0) {
+            return false;
+        }
+    }
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1) {
+        goto fail;
+    }
+    tb_cache_fill_header(uc, &cur);
+    /* everything but the per-save fields must match this process */
+    cur.cur_seg = hdr.cur_seg;
+    cur.cur_group = hdr.cur_group;
+    cur.nb_tbs = hdr.nb_tbs;
+    cur.code_gen_off = hdr.code_gen_off;
+    memcpy(cur.group_cur_seg, hdr.group_cur_seg, sizeof(cur.group_cur_seg));
+    memcpy(cur.group_gen_off, hdr.group_gen_off, sizeof(cur.group_gen_off));
+    if (memcmp(&hdr, &cur, sizeof(hdr)) != 0 ||
+        hdr.cur_seg >= hdr.nb_segs || hdr.cur_group >= hdr.nb_groups ||
+        hdr.code_gen_off > hdr.buffer_size) {
+        goto fail;
+    }
+    /* each group's cursor must sit inside that group's run of segments */
+    for (g = 0; g < (int)hdr.nb_groups; g++) {
+        if (hdr.group_cur_seg[g] / tcg_ctx->code_gen_group_segs != (uint32_t)g
+            || hdr.group_gen_off[g] > hdr.buffer_size) {
+            goto fail;
+        }
+    }
+
+    for (seg = 0; seg < (int)hdr.nb_segs; seg++) {
+        if (fread(&used, sizeof(used), 1, f) != 1 || used > hdr.seg_size) {
+            goto fail;
+        }
+        if (used != 0 &&
+            fread((uint8_t *)tcg_ctx->code_gen_buffer +
+                  (size_t)seg * tcg_ctx->code_gen_seg_size, 1, used, f) != used) {
+            goto fail;
+        }
+    }
+
+    for (n = 0; n < hdr.nb_tbs; n++) {
+        if (fread(&ent, sizeof(ent), 1, f) != 1 ||
+            ent.seg >= hdr.nb_segs || ent.tc_off >= hdr.buffer_size ||
+            tcg_ctx->tb_ctx.seg_nb_tbs[ent.seg] >=
+                tcg_ctx->code_gen_seg_blocks) {
+            goto fail_linked;
+        }
+        /* the guest bytes must still be mapped and unchanged; a block
+           that fails the check is skipped, not fatal */
+        if (!tb_cache_guest_hash(uc, ent.pc, ent.size, ent.page_addr,
+                                 &hash) || hash != ent.guest_hash) {
+            continue;
+        }
+        tb = &tcg_ctx->tb_ctx.tbs[ent.seg * tcg_ctx->code_gen_seg_blocks +
+                tcg_ctx->tb_ctx.seg_nb_tbs[ent.seg]++];
+        tb->pc = ent.pc;
+        tb->cs_base = ent.cs_base;
+        tb->flags = ent.flags;
+        tb->cflags = ent.cflags;
+        tb->size = ent.size;
+        tb->icount = ent.icount;
+        tb->exec_count = 0;
+        tb->invalidated = 0;
+        tb->insn_meta = NULL;
+        tb->sb_follow = ent.sb_follow;
+        tb->tc_ptr = (uint8_t *)tcg_ctx->code_gen_buffer + ent.tc_off;
+        tb->tb_next_offset[0] = ent.tb_next_offset[0];
+        tb->tb_next_offset[1] = ent.tb_next_offset[1];
+#ifdef USE_DIRECT_JUMP
+        tb->tb_jmp_offset[0] = ent.tb_jmp_offset[0];
+        tb->tb_jmp_offset[1] = ent.tb_jmp_offset[1];
+#endif
+        /* relinks the block and re-points its direct jumps at their own
+           continuation, undoing any chaining patched in before the save */
+        tb_link_page(uc, tb, ent.page_addr[0],
+                     ent.page_addr[1] == (uint64_t)-1 ?
+                         (tb_page_addr_t)-1 : (tb_page_addr_t)ent.page_addr[1]);
+    }
+
+    fclose(f);
+    tcg_ctx->tb_ctx.cur_seg = hdr.cur_seg;
+    tcg_ctx->tb_ctx.cur_group = hdr.cur_group;
+    for (g = 0; g < tcg_ctx->code_gen_nb_groups; g++) {
+        tcg_ctx->tb_ctx.group_cur_seg[g] = hdr.group_cur_seg[g];
+        tcg_ctx->tb_ctx.group_gen_ptr[g] =
+                (uint8_t *)tcg_ctx->code_gen_buffer + hdr.group_gen_off[g];
+    }
+    tcg_ctx->code_gen_ptr = (uint8_t *)tcg_ctx->code_gen_buffer +
+            hdr.code_gen_off;
+    return true;
+
+fail_linked:
+    /* some blocks are linked in already; drop them all */
+    fclose(f);
+    if (uc->cpu) {
+        tb_flush(uc->cpu->env_ptr);
+    }
+    return false;
+fail:
+    fclose(f);
+    return false;
+}
+
+/* Make the allocation group of the region backing @phys_pc the active
+   one: every uc_mem_map() region hashes (by its RAM block base) onto one
+   group, which fills and recycles only its own run of segments.  A
+   self-modifying or unmapped-and-remapped region therefore churns its
+   own group and leaves the warm code of the other groups alone.  The
+   inactive groups' cursors are parked in TBContext until they are
+   swapped back in here. */
+static void tb_group_select(struct uc_struct *uc, tb_page_addr_t phys_pc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    TBContext *tb_ctx = &tcg_ctx->tb_ctx;
+    int group;
+
+    if (tcg_ctx->code_gen_nb_groups <= 1) {
+        return;
+    }
+    group = (int)((qemu_ram_block_base(uc, phys_pc) >> TARGET_PAGE_BITS) %
+            tcg_ctx->code_gen_nb_groups);
+    if (group == tb_ctx->cur_group) {
+        return;
+    }
+    tb_ctx->group_cur_seg[tb_ctx->cur_group] = tb_ctx->cur_seg;
+    tb_ctx->group_gen_ptr[tb_ctx->cur_group] = tcg_ctx->code_gen_ptr;
+    tb_ctx->cur_seg = tb_ctx->group_cur_seg[group];
+    tcg_ctx->code_gen_ptr = tb_ctx->group_gen_ptr[group];
+    tb_ctx->cur_group = group;
+}
+
+/* Allocate a new translation block in the current segment. Returns NULL
+   when the segment is out of TB slots or code room; the caller then
+   rotates to the next segment with tb_seg_rotate() and retries. */
 static TranslationBlock *tb_alloc(struct uc_struct *uc, target_ulong pc)
 {
     TranslationBlock *tb;
     TCGContext *tcg_ctx = uc->tcg_ctx;
+    int seg = tcg_ctx->tb_ctx.cur_seg;
+    uint8_t *seg_base = (uint8_t *)tcg_ctx->code_gen_buffer +
+            (size_t)seg * tcg_ctx->code_gen_seg_size;
 
-    if (tcg_ctx->tb_ctx.nb_tbs >= tcg_ctx->code_gen_max_blocks ||
-        (tcg_ctx->code_gen_ptr - tcg_ctx->code_gen_buffer) >=
-         tcg_ctx->code_gen_buffer_max_size) {
+    if (tcg_ctx->tb_ctx.seg_nb_tbs[seg] >= tcg_ctx->code_gen_seg_blocks ||
+        (size_t)((uint8_t *)tcg_ctx->code_gen_ptr - seg_base) >=
+         tcg_ctx->code_gen_seg_max_size) {
         return NULL;
     }
-    tb = &tcg_ctx->tb_ctx.tbs[tcg_ctx->tb_ctx.nb_tbs++];
+    tb = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks +
+            tcg_ctx->tb_ctx.seg_nb_tbs[seg]++];
     tb->pc = pc;
     tb->cflags = 0;
+    tb->exec_count = 0;
+    tb->invalidated = 0;
+    tb->insn_meta = NULL;
+    /* a block translated while tb_superblock() is regenerating may follow
+       unconditional jumps; the budget lives on the TB so that a later
+       search_pc retranslation reproduces the same instruction stream */
+    tb->sb_follow = uc->sb_generating ? TB_SUPERBLOCK_FOLLOW : 0;
     return tb;
 }
 
+/* Advance to the next segment of the code buffer, evicting whatever it
+   still holds.  Segments are recycled in order, so the victim is always
+   the one translated longest ago - a FIFO approximation of coldest-first
+   that needs no per-TB bookkeeping.  The rest of the cache stays warm,
+   unlike the old whole-buffer tb_flush() on exhaustion, which forced
+   everything to retranslate from cold. */
+/* True when a uc_emu_start() run suspended by a nested run (see the
+   nesting path in uc_emu_start()) will resume into generated code that
+   lives in this segment.  Such code sits below us on the host stack, so
+   recycling the segment would have the outer run return into freshly
+   translated bytes. */
+static bool tb_seg_pinned(struct uc_struct *uc, int seg)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    /* nest_ra[] holds return addresses of executing code, so compare
+       against the executable view of the segment */
+    uintptr_t base = (uintptr_t)tcg_ctx->code_gen_buffer +
+            tcg_ctx->code_rx_delta +
+            (size_t)seg * tcg_ctx->code_gen_seg_size;
+    int d;
+
+    for (d = 0; d < uc->nest_depth; d++) {
+        if (uc->nest_ra[d] >= base &&
+                uc->nest_ra[d] < base + tcg_ctx->code_gen_seg_size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void tb_seg_rotate(struct uc_struct *uc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    TranslationBlock *tb;
+    int base, seg, i;
+
+    /* rotate within the active group's run of segments only, so one
+       region's churn never evicts another group's translations */
+    base = tcg_ctx->tb_ctx.cur_group * tcg_ctx->code_gen_group_segs;
+    seg = base + (tcg_ctx->tb_ctx.cur_seg - base + 1) %
+            tcg_ctx->code_gen_group_segs;
+    /* skip over segments pinned by suspended runs; when every segment is
+       pinned (a tiny buffer nested deeply) fall back to the plain FIFO
+       victim - uc_emu_start() bounds the depth so this cannot happen with
+       the default buffer geometry */
+    for (i = 0; i < tcg_ctx->code_gen_group_segs - 1 && tb_seg_pinned(uc, seg);
+            i++) {
+        seg = base + (seg - base + 1) % tcg_ctx->code_gen_group_segs;
+    }
+    for (i = 0; i < tcg_ctx->tb_ctx.seg_nb_tbs[seg]; i++) {
+        tb = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks + i];
+        if (!tb->invalidated) {
+            /* unlinks the TB everywhere, folds its exec_count into the
+               profile and raises tb_invalidated_flag so cpu_exec() does
+               not chain the next TB to a stale predecessor */
+            tb_phys_invalidate(uc, tb, -1);
+        }
+    }
+    tcg_ctx->tb_ctx.seg_nb_tbs[seg] = 0;
+    tcg_ctx->tb_ctx.cur_seg = seg;
+    tcg_ctx->code_gen_ptr = (uint8_t *)tcg_ctx->code_gen_buffer +
+            (size_t)seg * tcg_ctx->code_gen_seg_size;
+    tcg_ctx->tb_ctx.tb_seg_evict_count++;
+}
+
 void tb_free(struct uc_struct *uc, TranslationBlock *tb)
 {
     TCGContext *tcg_ctx = uc->tcg_ctx;
+    int seg = tcg_ctx->tb_ctx.cur_seg;
 
     /* In practice this is mostly used for single use temporary TB
        Ignore the hard cases and just back up if this TB happens to
        be the last one generated.  */
-    if (tcg_ctx->tb_ctx.nb_tbs > 0 &&
-            tb == &tcg_ctx->tb_ctx.tbs[tcg_ctx->tb_ctx.nb_tbs - 1]) {
+    if (tcg_ctx->tb_ctx.seg_nb_tbs[seg] > 0 &&
+            tb == &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks +
+                tcg_ctx->tb_ctx.seg_nb_tbs[seg] - 1]) {
+        if (tb->insn_meta != NULL) {
+            g_free(tb->insn_meta);
+            tb->insn_meta = NULL;
+            tcg_ctx->tb_ctx.nb_insn_meta--;
+        }
         tcg_ctx->code_gen_ptr = tb->tc_ptr;
-        tcg_ctx->tb_ctx.nb_tbs--;
+        tcg_ctx->tb_ctx.seg_nb_tbs[seg]--;
     }
 }
 
@@ -775,10 +1823,12 @@ static inline void invalidate_page_bitmap(PageDesc *p)
         g_free(p->code_bitmap);
         p->code_bitmap = NULL;
     }
-    p->code_write_count = 0;
 }
 
-/* Set to NULL all the 'first_tb' fields in all PageDescs. */
+/* Free the whole subtree below *lp. After a full TB flush no page holds a
+   TB any more, so instead of only clearing the first_tb fields the levels
+   are returned to the allocator; page_find_alloc() rebuilds them on
+   demand, keeping the tree sized to the pages that actually hold code. */
 static void page_flush_tb_1(int level, void **lp)
 {
     int i;
@@ -790,16 +1840,18 @@ static void page_flush_tb_1(int level, void **lp)
         PageDesc *pd = *lp;
 
         for (i = 0; i < V_L2_SIZE; ++i) {
-            pd[i].first_tb = NULL;
             invalidate_page_bitmap(pd + i);
         }
+        g_free(pd);
     } else {
         void **pp = *lp;
 
         for (i = 0; i < V_L2_SIZE; ++i) {
             page_flush_tb_1(level - 1, pp + i);
         }
+        g_free(pp);
     }
+    *lp = NULL;
 }
 
 static void page_flush_tb(struct uc_struct *uc)
@@ -814,6 +1866,165 @@ static void page_flush_tb(struct uc_struct *uc)
     }
 }
 
+/* Free every page-descriptor subtree that no longer holds any TB; returns
+   true when *lp became (or already was) empty. */
+static bool page_tree_reclaim_1(int level, void **lp)
+{
+    int i;
+
+    if (*lp == NULL) {
+        return true;
+    }
+    if (level == 0) {
+        PageDesc *pd = *lp;
+
+        for (i = 0; i < V_L2_SIZE; ++i) {
+            if (pd[i].first_tb != NULL) {
+                return false;
+            }
+        }
+        for (i = 0; i < V_L2_SIZE; ++i) {
+            invalidate_page_bitmap(pd + i);
+        }
+        g_free(pd);
+    } else {
+        void **pp = *lp;
+        bool empty = true;
+
+        for (i = 0; i < V_L2_SIZE; ++i) {
+            if (!page_tree_reclaim_1(level - 1, pp + i)) {
+                empty = false;
+            }
+        }
+        if (!empty) {
+            return false;
+        }
+        g_free(pp);
+    }
+    *lp = NULL;
+    return true;
+}
+
+/* Reclaim page descriptors left behind by unmapped or flushed regions.
+   The tree is indexed by ram offsets, which are recycled when regions come
+   and go, so without this a long-lived engine emulating many short-lived
+   modules accumulates descriptors for its whole lifetime. */
+void page_tree_reclaim(struct uc_struct *uc)
+{
+    int i;
+
+    if (uc->l1_map == NULL)
+        return;
+
+    for (i = 0; i < V_L1_SIZE; i++) {
+        page_tree_reclaim_1(V_L1_SHIFT / V_L2_BITS - 1, uc->l1_map + i);
+    }
+}
+
+/* Merge one block's execution count into the persistent profile table on
+   uc_struct (open addressing, linear probing; empty slots have
+   exec_count == 0). Returns false when the table cannot be grown. */
+static bool tb_profile_add(struct uc_struct *uc, uint64_t pc,
+                           uint32_t icount, uint32_t exec_count)
+{
+    struct tb_profile_entry *entry, *old_table;
+    uint32_t h, i, old_size;
+
+    if (uc->profile_table == NULL) {
+        uc->profile_size = 1024;
+        uc->profile_used = 0;
+        uc->profile_table = calloc(uc->profile_size, sizeof(*entry));
+        if (uc->profile_table == NULL) {
+            return false;
+        }
+    }
+
+    /* grow at 3/4 occupancy */
+    if (uc->profile_used * 4 >= uc->profile_size * 3) {
+        old_table = uc->profile_table;
+        old_size = uc->profile_size;
+        uc->profile_size = old_size * 2;
+        uc->profile_used = 0;
+        uc->profile_table = calloc(uc->profile_size, sizeof(*entry));
+        if (uc->profile_table == NULL) {
+            uc->profile_table = old_table;
+            uc->profile_size = old_size;
+            return false;
+        }
+        for (i = 0; i < old_size; i++) {
+            if (old_table[i].exec_count != 0) {
+                tb_profile_add(uc, old_table[i].pc, old_table[i].icount,
+                               old_table[i].exec_count);
+            }
+        }
+        free(old_table);
+    }
+
+    h = (uint32_t)(pc >> 2) * 2654435761u;
+    for (i = 0; i < uc->profile_size; i++) {
+        entry = &uc->profile_table[(h + i) & (uc->profile_size - 1)];
+        if (entry->exec_count == 0) {
+            entry->pc = pc;
+            entry->icount = icount;
+            entry->exec_count = exec_count;
+            uc->profile_used++;
+            return true;
+        }
+        if (entry->pc == pc && entry->icount == icount) {
+            entry->exec_count += exec_count;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Fold the execution counters of all live TBs into the profile table, so
+   the profile survives translation cache flushes. Called before tb_flush()
+   discards the cache and when uc_profile_top() is queried. */
+void tb_profile_flush(struct uc_struct *uc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    TranslationBlock *tb;
+    int seg, i;
+
+    if (!uc->tb_profile) {
+        return;
+    }
+
+    for (seg = 0; seg < tcg_ctx->code_gen_nb_segs; seg++) {
+        for (i = 0; i < tcg_ctx->tb_ctx.seg_nb_tbs[seg]; i++) {
+            tb = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks + i];
+            if (tb->exec_count != 0) {
+                tb_profile_add(uc, tb->pc, tb->icount, tb->exec_count);
+                tb->exec_count = 0;
+            }
+        }
+    }
+}
+
+/* Free the instruction metadata of every live TB; called before
+   tb_flush() discards the blocks owning it.  Most flushes never enter
+   the walk: nb_insn_meta is only raised by uc_tb_meta() queries. */
+static void tb_meta_flush(struct uc_struct *uc)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    TranslationBlock *tb;
+    int seg, i;
+
+    for (seg = 0; seg < tcg_ctx->code_gen_nb_segs &&
+            tcg_ctx->tb_ctx.nb_insn_meta > 0; seg++) {
+        for (i = 0; i < tcg_ctx->tb_ctx.seg_nb_tbs[seg]; i++) {
+            tb = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks + i];
+            if (tb->insn_meta != NULL) {
+                g_free(tb->insn_meta);
+                tb->insn_meta = NULL;
+                tcg_ctx->tb_ctx.nb_insn_meta--;
+            }
+        }
+    }
+}
+
 /* flush all the translation blocks */
 /* XXX: tb_flush is currently not thread safe */
 void tb_flush(CPUArchState *env1)
@@ -822,24 +2033,45 @@ void tb_flush(CPUArchState *env1)
     struct uc_struct* uc = cpu->uc;
     TCGContext *tcg_ctx = uc->tcg_ctx;
 
+    UC_PROBE1(tb_flush,
+              tcg_ctx->code_gen_ptr - tcg_ctx->code_gen_buffer);
+
 #if defined(DEBUG_FLUSH)
-    printf("qemu: flush code_size=%ld nb_tbs=%d avg_tb_size=%ld\n",
-           (unsigned long)(tcg_ctx->code_gen_ptr - tcg_ctx->code_gen_buffer),
-           tcg_ctx->tb_ctx.nb_tbs, tcg_ctx->tb_ctx.nb_tbs > 0 ?
-           ((unsigned long)(tcg_ctx->code_gen_ptr - tcg_ctx->code_gen_buffer)) /
-           tcg_ctx->tb_ctx.nb_tbs : 0);
+    {
+        int nb_tbs = 0, seg;
+        for (seg = 0; seg < tcg_ctx->code_gen_nb_segs; seg++) {
+            nb_tbs += tcg_ctx->tb_ctx.seg_nb_tbs[seg];
+        }
+        printf("qemu: flush code_size=%ld nb_tbs=%d avg_tb_size=%ld\n",
+               (unsigned long)(tcg_ctx->code_gen_ptr - tcg_ctx->code_gen_buffer),
+               nb_tbs, nb_tbs > 0 ?
+               ((unsigned long)(tcg_ctx->code_gen_ptr - tcg_ctx->code_gen_buffer)) /
+               nb_tbs : 0);
+    }
 #endif
     if ((unsigned long)(tcg_ctx->code_gen_ptr - tcg_ctx->code_gen_buffer)
         > tcg_ctx->code_gen_buffer_size) {
         cpu_abort(cpu, "Internal error: code buffer overflow\n");
     }
-    tcg_ctx->tb_ctx.nb_tbs = 0;
+
+    /* keep the execution counters of the discarded TBs */
+    tb_profile_flush(uc);
+    /* the cached instruction metadata goes with the blocks */
+    tb_meta_flush(uc);
+
+    tcg_ctx->tb_ctx.cur_seg = 0;
+    memset(tcg_ctx->tb_ctx.seg_nb_tbs, 0, sizeof(tcg_ctx->tb_ctx.seg_nb_tbs));
+    tb_group_reset(tcg_ctx);
 
     CPU_FOREACH(cpu) {
-        memset(cpu->tb_jmp_cache, 0, sizeof(cpu->tb_jmp_cache));
+        tb_jmp_cache_flush(cpu);
     }
 
-    memset(tcg_ctx->tb_ctx.tb_phys_hash, 0, sizeof(tcg_ctx->tb_ctx.tb_phys_hash));
+    memset(tcg_ctx->tb_ctx.tb_phys_hash, 0,
+           ((size_t)tcg_ctx->tb_ctx.tb_phys_hash_mask + 1) *
+           sizeof(TranslationBlock *));
+    /* every TB is gone, and with it every cross-page link */
+    tcg_ctx->tb_ctx.crosspage_count = 0;
     page_flush_tb(uc);
 
     tcg_ctx->code_gen_ptr = tcg_ctx->code_gen_buffer;
@@ -856,7 +2088,7 @@ static void tb_invalidate_check(target_ulong address)
     int i;
 
     address &= TARGET_PAGE_MASK;
-    for (i = 0; i < CODE_GEN_PHYS_HASH_SIZE; i++) {
+    for (i = 0; i <= (int)tb_ctx.tb_phys_hash_mask; i++) {
         for (tb = tb_ctx.tb_phys_hash[i]; tb != NULL; tb = tb->phys_hash_next) {
             if (!(address + TARGET_PAGE_SIZE <= tb->pc ||
                   address >= tb->pc + tb->size)) {
@@ -875,7 +2107,7 @@ static void tb_page_check(struct uc_struct *uc)
     int i, flags1, flags2;
     TCGContext *tcg_ctx = uc->tcg_ctx;
 
-    for (i = 0; i < CODE_GEN_PHYS_HASH_SIZE; i++) {
+    for (i = 0; i <= (int)tcg_ctx->tb_ctx.tb_phys_hash_mask; i++) {
         for (tb = tcg_ctx->tb_ctx.tb_phys_hash[i]; tb != NULL;
                 tb = tb->phys_hash_next) {
             flags1 = page_get_flags(tb->pc);
@@ -957,6 +2189,73 @@ static inline void tb_reset_jump(TranslationBlock *tb, int n)
     tb_set_jmp_target(tb, n, (uintptr_t)(tb->tc_ptr + tb->tb_next_offset[n]));
 }
 
+/* Unicorn: record a direct jump into a TB spanning two guest pages.
+   Writes to either page need no extra tracking (the TB sits in both page
+   lists, and tb_phys_invalidate() walks jmp_first to unchain incoming
+   jumps), but a direct jump also skips the phys_page2 check that
+   tb_find_slow() would have done, so the link must be undone whenever the
+   virtual mapping of the second page may have changed; see
+   tb_crosspage_unchain(), called from the TLB flush paths. */
+void tb_crosspage_link(struct uc_struct *uc,
+    TranslationBlock *src, int n, TranslationBlock *dest)
+{
+    TBContext *tb_ctx = &uc->tcg_ctx->tb_ctx;
+    CrossPageLink *l;
+
+    if (tb_ctx->crosspage_count == tb_ctx->crosspage_capacity) {
+        tb_ctx->crosspage_capacity = tb_ctx->crosspage_capacity ?
+                tb_ctx->crosspage_capacity * 2 : 16;
+        tb_ctx->crosspage_links = g_realloc(tb_ctx->crosspage_links,
+                tb_ctx->crosspage_capacity * sizeof(*tb_ctx->crosspage_links));
+    }
+    l = &tb_ctx->crosspage_links[tb_ctx->crosspage_count++];
+    l->src = src;
+    l->dest = dest;
+    /* the two pages of a TB are contiguous in the virtual address space */
+    l->virt_page2 = (dest->pc + dest->size - 1) & TARGET_PAGE_MASK;
+    l->n = n;
+}
+
+/* drop the recorded cross-page links touching a dying TB; the jumps
+   themselves are reset by tb_phys_invalidate() */
+static void tb_crosspage_remove(TBContext *tb_ctx, TranslationBlock *tb)
+{
+    unsigned int i = 0;
+
+    while (i < tb_ctx->crosspage_count) {
+        CrossPageLink *l = &tb_ctx->crosspage_links[i];
+
+        if (l->src == tb || l->dest == tb) {
+            *l = tb_ctx->crosspage_links[--tb_ctx->crosspage_count];
+        } else {
+            i++;
+        }
+    }
+}
+
+/* undo the cross-page direct jumps depending on virtual page 'addr', or
+   all of them when addr is -1. The sources fall back to the indirect
+   lookup path and may chain again on their next execution. */
+void tb_crosspage_unchain(struct uc_struct *uc, target_ulong addr)
+{
+    TBContext *tb_ctx = &uc->tcg_ctx->tb_ctx;
+    unsigned int i = 0;
+
+    while (i < tb_ctx->crosspage_count) {
+        CrossPageLink *l = &tb_ctx->crosspage_links[i];
+
+        if (addr != (target_ulong)-1 && l->virt_page2 != addr) {
+            i++;
+            continue;
+        }
+        if (l->src->jmp_next[l->n]) {
+            tb_jmp_remove(l->src, l->n);
+            tb_reset_jump(l->src, l->n);
+        }
+        *l = tb_ctx->crosspage_links[--tb_ctx->crosspage_count];
+    }
+}
+
 /* invalidate one TB */
 void tb_phys_invalidate(struct uc_struct *uc,
     TranslationBlock *tb, tb_page_addr_t page_addr)
@@ -968,9 +2267,22 @@ void tb_phys_invalidate(struct uc_struct *uc,
     tb_page_addr_t phys_pc;
     TranslationBlock *tb1, *tb2;
 
+    /* keep the execution counter of the invalidated TB */
+    if (uc->tb_profile && tb->exec_count != 0) {
+        tb_profile_add(uc, tb->pc, tb->icount, tb->exec_count);
+        tb->exec_count = 0;
+    }
+
+    /* the cached instruction metadata dies with the translation */
+    if (tb->insn_meta != NULL) {
+        g_free(tb->insn_meta);
+        tb->insn_meta = NULL;
+        tcg_ctx->tb_ctx.nb_insn_meta--;
+    }
+
     /* remove the TB from the hash list */
     phys_pc = tb->page_addr[0] + (tb->pc & ~TARGET_PAGE_MASK);
-    h = tb_phys_hash_func(phys_pc);
+    h = tb_phys_hash_func(phys_pc, tcg_ctx->tb_ctx.tb_phys_hash_mask);
     tb_hash_remove(&tcg_ctx->tb_ctx.tb_phys_hash[h], tb);
 
     /* remove the TB from the page list */
@@ -988,7 +2300,7 @@ void tb_phys_invalidate(struct uc_struct *uc,
     tcg_ctx->tb_ctx.tb_invalidated_flag = 1;
 
     /* remove the TB from the hash list */
-    h = tb_jmp_cache_hash_func(tb->pc);
+    h = tb_jmp_cache_hash_func(tb->pc, uc->jmp_cache_bits);
     CPU_FOREACH(cpu) {
         if (cpu->tb_jmp_cache[h] == tb) {
             cpu->tb_jmp_cache[h] = NULL;
@@ -1013,6 +2325,11 @@ void tb_phys_invalidate(struct uc_struct *uc,
         tb1 = tb2;
     }
     tb->jmp_first = (TranslationBlock *)((uintptr_t)tb | 2); /* fail safe */
+    /* forget the cross-page links this TB was part of */
+    tb_crosspage_remove(&tcg_ctx->tb_ctx, tb);
+    /* the slot stays in its segment's tbs[] slice until the segment is
+       recycled; mark it so tb_seg_rotate() does not unlink it twice */
+    tb->invalidated = 1;
 
     tcg_ctx->tb_ctx.tb_phys_invalidate_count++;
 }
@@ -1082,12 +2399,17 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     TranslationBlock *tb;
     tb_page_addr_t phys_pc, phys_page2;
     int code_gen_size;
+    int64_t ti = get_clock();   /* feeds UC_QUERY_JIT_TIME_NS */
 
+    UC_PROBE1(tb_gen_entry, pc);
     phys_pc = get_page_addr_code(env, pc);
+    /* translate into the allocation group of the region owning this code */
+    tb_group_select(env->uc, phys_pc);
     tb = tb_alloc(env->uc, pc);
     if (!tb) {
-        /* flush must be done */
-        tb_flush(env);
+        /* current segment is full: evict the oldest one and translate
+           into it, leaving the rest of the cache warm */
+        tb_seg_rotate(env->uc);
         /* cannot fail at this point */
         tb = tb_alloc(env->uc, pc);
         /* Don't forget to invalidate previous TB info.  */
@@ -1101,6 +2423,15 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     tcg_ctx->code_gen_ptr = (void *)(((uintptr_t)tcg_ctx->code_gen_ptr +
             code_gen_size + CODE_GEN_ALIGN - 1) & ~(CODE_GEN_ALIGN - 1));
 
+    /* Unicorn: label the translation with its guest pc so host-side
+       `perf record` resolves hits in the code buffer (uc_perfmap_enable) */
+    if (env->uc->perfmap) {
+        fprintf(env->uc->perfmap, "%" PRIxPTR " %x tb-0x%" PRIx64 "\n",
+                (uintptr_t)tb->tc_ptr + tcg_ctx->code_rx_delta,
+                code_gen_size, (uint64_t)pc);
+        fflush(env->uc->perfmap);
+    }
+
     phys_page2 = -1;
     /* check next page if needed */
     if (tb->size) {
@@ -1110,9 +2441,38 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
         }
     }
     tb_link_page(cpu->uc, tb, phys_pc, phys_page2);
+    env->uc->jit_time_ns += get_clock() - ti;
+    UC_PROBE2(tb_gen_exit, pc, tb->size);
     return tb;
 }
 
+/* Retranslate a block that crossed the execution threshold set by
+   uc_superblock_enable() as a superblock: with uc->sb_generating set the
+   target translator may follow unconditional direct jumps instead of
+   ending the block, giving the optimizer a larger window (see gen_jmp_tb()
+   in target-i386/translate.c).  The hot block is invalidated first, so its
+   incoming jumps are reset and the next lookup finds the new translation.
+   Called with tb_lock held, from the TB_EXIT_REQUESTED path in cpu_exec(). */
+void tb_superblock(CPUState *cpu, TranslationBlock *hot)
+{
+    struct uc_struct *uc = cpu->uc;
+    target_ulong pc, cs_base;
+    int flags, cflags;
+
+    if (hot->invalidated) {
+        return;
+    }
+    pc = hot->pc;
+    cs_base = hot->cs_base;
+    flags = hot->flags;
+    cflags = hot->cflags;
+    tb_phys_invalidate(uc, hot, -1);
+
+    uc->sb_generating = true;
+    tb_gen_code(cpu, pc, cs_base, flags, cflags);
+    uc->sb_generating = false;
+}
+
 /*
  * Invalidate all TBs which intersect with the target physical address range
  * [start;end[. NOTE: start and end may refer to *different* physical pages.
@@ -1130,6 +2490,32 @@ void tb_invalidate_phys_range(struct uc_struct *uc, tb_page_addr_t start, tb_pag
     }
 }
 
+/*
+ * Unicorn: invalidate every TB whose guest pc range intersects the
+ * *virtual* range [begin;end].  The translators gate their hook
+ * instrumentation on virtual pcs (HOOK_EXISTS_BOUNDED), so this is the
+ * right key when the hook tables change; tb_invalidate_phys_range()
+ * above keys on ram offsets and serves the self-modifying-code and
+ * unmap paths instead.  The invalidated slots stay in their segments
+ * until recycled, exactly as after tb_seg_rotate().
+ */
+void tb_invalidate_pc_range(struct uc_struct *uc, uint64_t begin, uint64_t end)
+{
+    TCGContext *tcg_ctx = uc->tcg_ctx;
+    TranslationBlock *tb;
+    int seg, i;
+
+    for (seg = 0; seg < tcg_ctx->code_gen_nb_segs; seg++) {
+        for (i = 0; i < tcg_ctx->tb_ctx.seg_nb_tbs[seg]; i++) {
+            tb = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks + i];
+            if (!tb->invalidated &&
+                    tb->pc <= end && tb->pc + tb->size - 1 >= begin) {
+                tb_phys_invalidate(uc, tb, -1);
+            }
+        }
+    }
+}
+
 /*
  * Invalidate all TBs which intersect with the target physical address range
  * [start;end[. NOTE: start and end must refer to the *same* physical page.
@@ -1161,10 +2547,11 @@ void tb_invalidate_phys_page_range(struct uc_struct *uc, tb_page_addr_t start, t
     if (!p) {
         return;
     }
-    if (!p->code_bitmap &&
-        ++p->code_write_count >= SMC_BITMAP_USE_THRESHOLD &&
-        is_cpu_write_access) {
-        /* build code bitmap */
+    if (!p->code_bitmap && is_cpu_write_access) {
+        /* build the code bitmap right away: without it every write to the
+           page walks the TB list below, so waiting for more writes only
+           repeats that walk.  JIT-style guests write near their own code
+           constantly */
         build_page_bitmap(p);
     }
 #if defined(TARGET_HAS_PRECISE_SMC)
@@ -1340,7 +2727,25 @@ static inline void tb_alloc_page(struct uc_struct *uc, TranslationBlock *tb,
     page_already_protected = p->first_tb != NULL;
 #endif
     p->first_tb = (TranslationBlock *)((uintptr_t)tb | n);
-    invalidate_page_bitmap(p);
+    if (p->code_bitmap) {
+        /* keep the bitmap warm instead of throwing it away: marking the
+           new TB's bytes is all a correct (conservative) map needs, and
+           dropping it here made every guest JIT compilation re-pay a
+           TB-list walk per subsequent write to the page */
+        int tb_start, tb_end;
+
+        if (n == 0) {
+            tb_start = tb->pc & ~TARGET_PAGE_MASK;
+            tb_end = tb_start + tb->size;
+            if (tb_end > TARGET_PAGE_SIZE) {
+                tb_end = TARGET_PAGE_SIZE;
+            }
+        } else {
+            tb_start = 0;
+            tb_end = (tb->pc + tb->size) & ~TARGET_PAGE_MASK;
+        }
+        set_bits(p->code_bitmap, tb_start, tb_end - tb_start);
+    }
 
 #if defined(TARGET_HAS_SMC) || 1
 
@@ -1428,7 +2833,7 @@ static void tb_link_page(struct uc_struct *uc,
        before we are done.  */
     mmap_lock();
     /* add in the physical hash table */
-    h = tb_phys_hash_func(phys_pc);
+    h = tb_phys_hash_func(phys_pc, tcg_ctx->tb_ctx.tb_phys_hash_mask);
     ptb = &tcg_ctx->tb_ctx.tb_phys_hash[h];
     tb->phys_hash_next = *ptb;
     *ptb = tb;
@@ -1464,23 +2869,38 @@ static void tb_link_page(struct uc_struct *uc,
 static TranslationBlock *tb_find_pc(struct uc_struct *uc, uintptr_t tc_ptr)
 {
     TCGContext *tcg_ctx = uc->tcg_ctx;
-    int m_min, m_max, m;
+    TranslationBlock *tbs, *tb;
+    int m_min, m_max, m, seg;
     uintptr_t v;
-    TranslationBlock *tb;
 
-    if (tcg_ctx->tb_ctx.nb_tbs <= 0) {
+    /* callers pass host pcs of executing code, which on a dual-mapped
+       buffer sit in the executable view; tb->tc_ptr is in the writable
+       one */
+    tc_ptr -= tcg_ctx->code_rx_delta;
+
+    if (tc_ptr < (uintptr_t)tcg_ctx->code_gen_buffer ||
+        tc_ptr >= (uintptr_t)tcg_ctx->code_gen_buffer +
+            (size_t)tcg_ctx->code_gen_nb_segs * tcg_ctx->code_gen_seg_size) {
         return NULL;
     }
-    if (tc_ptr < (uintptr_t)tcg_ctx->code_gen_buffer ||
+    /* segments fill sequentially, so each slice of the tbs array is
+       sorted by tc_ptr and can be searched on its own */
+    seg = (tc_ptr - (uintptr_t)tcg_ctx->code_gen_buffer) /
+            tcg_ctx->code_gen_seg_size;
+    if (tcg_ctx->tb_ctx.seg_nb_tbs[seg] <= 0) {
+        return NULL;
+    }
+    if (seg == tcg_ctx->tb_ctx.cur_seg &&
         tc_ptr >= (uintptr_t)tcg_ctx->code_gen_ptr) {
         return NULL;
     }
+    tbs = &tcg_ctx->tb_ctx.tbs[seg * tcg_ctx->code_gen_seg_blocks];
     /* binary search (cf Knuth) */
     m_min = 0;
-    m_max = tcg_ctx->tb_ctx.nb_tbs - 1;
+    m_max = tcg_ctx->tb_ctx.seg_nb_tbs[seg] - 1;
     while (m_min <= m_max) {
         m = (m_min + m_max) >> 1;
-        tb = &tcg_ctx->tb_ctx.tbs[m];
+        tb = &tbs[m];
         v = (uintptr_t)tb->tc_ptr;
         if (v == tc_ptr) {
             return tb;
@@ -1490,7 +2910,7 @@ static TranslationBlock *tb_find_pc(struct uc_struct *uc, uintptr_t tc_ptr)
             m_min = m + 1;
         }
     }
-    return &tcg_ctx->tb_ctx.tbs[m_max];
+    return &tbs[m_max];
 }
 
 #if defined(TARGET_HAS_ICE) && !defined(CONFIG_USER_ONLY)
@@ -1608,17 +3028,18 @@ void cpu_io_recompile(CPUState *cpu, uintptr_t retaddr)
 
 void tb_flush_jmp_cache(CPUState *cpu, target_ulong addr)
 {
+    unsigned int bits = cpu->uc->jmp_cache_bits;
+    size_t group = (size_t)1 << (bits - bits / 2);
     unsigned int i;
 
     /* Discard jump cache entries for any tb which might potentially
-       overlap the flushed page.  */
-    i = tb_jmp_cache_hash_page(addr - TARGET_PAGE_SIZE);
-    memset(&cpu->tb_jmp_cache[i], 0,
-           TB_JMP_PAGE_SIZE * sizeof(TranslationBlock *));
-
-    i = tb_jmp_cache_hash_page(addr);
-    memset(&cpu->tb_jmp_cache[i], 0,
-           TB_JMP_PAGE_SIZE * sizeof(TranslationBlock *));
+       overlap the flushed page.  A page hashes to one contiguous group
+       of entries (see tb_jmp_cache_hash_page).  */
+    i = tb_jmp_cache_hash_page(addr - TARGET_PAGE_SIZE, bits);
+    memset(&cpu->tb_jmp_cache[i], 0, group * sizeof(TranslationBlock *));
+
+    i = tb_jmp_cache_hash_page(addr, bits);
+    memset(&cpu->tb_jmp_cache[i], 0, group * sizeof(TranslationBlock *));
 }
 
 #if 0
@@ -29,6 +29,113 @@ static void free_table(gpointer key, gpointer value, gpointer data)
 }
 
 void tb_cleanup(struct uc_struct *uc);
+void tb_profile_flush(struct uc_struct *uc);
+void page_tree_reclaim(struct uc_struct *uc);
+bool tcg_buffer_resize(struct uc_struct *uc, size_t size);
+bool tb_cache_save(struct uc_struct *uc, const char *path);
+bool tb_cache_load(struct uc_struct *uc, const char *path);
+size_t tb_prewarm(struct uc_struct *uc, uint64_t addr, size_t size);
+int tb_meta_get(struct uc_struct *uc, uint64_t addr, uc_tb_insn *insns,
+                uint32_t *count);
+void tb_stats(struct uc_struct *uc, struct uc_tb_stats *stats);
+void mem_stats(struct uc_struct *uc, struct uc_mem_stats *stats);
+void tb_invalidate_pc_range(struct uc_struct *uc, uint64_t begin, uint64_t end);
+
+// drop only the TBs translated from [start, end), so permission changes on
+// a few pages do not cost a full translation cache flush.
+// The TB page table is indexed by ram offsets, not guest physical
+// addresses, so translate region by region before invalidating.
+static void tb_invalidate_range(struct uc_struct *uc, uint64_t start, uint64_t end)
+{
+    MemoryRegion *mr;
+    uint64_t len;
+    ram_addr_t ram_addr;
+
+    while (start < end) {
+        mr = memory_mapping(uc, start);
+        if (mr == NULL) {
+            // skip unmapped holes page by page
+            start = (start + TARGET_PAGE_SIZE) & TARGET_PAGE_MASK;
+            continue;
+        }
+        if (!mr->ram) {
+            // MMIO regions have no ram offsets and hold no translated code
+            start = mr->end;
+            continue;
+        }
+        len = MIN(end, mr->end) - start;
+        ram_addr = (mr->ram_addr & TARGET_PAGE_MASK) + (start - mr->addr);
+        tb_invalidate_phys_range(uc, ram_addr, ram_addr + len, 0);
+        start += len;
+    }
+}
+
+// change the effective TLB size for this instance. Translated code embeds
+// the old index mask, so every cached TB and TLB entry must be dropped.
+static bool tlb_resize(struct uc_struct *uc, uint32_t entries)
+{
+    CPUState *cpu;
+
+    if (entries == 0 || entries > CPU_TLB_SIZE
+            || (entries & (entries - 1)) != 0) {
+        return false;
+    }
+
+    // flush while the old size is still in effect: tlb_flush() only clears
+    // the first tlb_entries slots of each row, and shrinking first would
+    // leave stale valid entries beyond the new index mask
+    CPU_FOREACH(cpu) {
+        tb_flush(cpu->env_ptr);
+        tlb_flush(cpu, 1);
+    }
+    uc->tlb_entries = entries;
+    return true;
+}
+
+// change the effective size of the per-pc jump cache consulted before
+// the phys hash walk. Stale entries are only reachable through the new
+// mask after a clear, so the whole (maximum-sized) array is wiped.
+static bool jmp_cache_resize(struct uc_struct *uc, uint32_t entries)
+{
+    CPUState *cpu;
+    uint32_t bits = 0;
+
+    if (entries < 16 || entries > TB_JMP_CACHE_MAX_SIZE
+            || (entries & (entries - 1)) != 0) {
+        return false;
+    }
+    while ((1u << bits) < entries) {
+        bits++;
+    }
+
+    CPU_FOREACH(cpu) {
+        memset(cpu->tb_jmp_cache, 0, sizeof(cpu->tb_jmp_cache));
+    }
+    uc->jmp_cache_bits = bits;
+    return true;
+}
+
+// evict only the TLB entries overlapping [start, end), so unrelated warm
+// translations survive a mapping or protection change
+static void tlb_flush_range_all(struct uc_struct *uc, uint64_t start, uint64_t end)
+{
+    CPUState *cpu;
+
+    CPU_FOREACH(cpu) {
+        tlb_flush_range(cpu, start, end - start);
+    }
+}
+
+// drop all cached TLB entries, so that tlb_set_page() recomputes the
+// TLB_UCHOOK flag against the current memory hook tables
+static void tlb_flush_all(struct uc_struct *uc)
+{
+    CPUState *cpu;
+
+    CPU_FOREACH(cpu) {
+        tlb_flush(cpu, 1);
+    }
+}
 
 /** Freeing common resources */
 static void release_common(void *t)
@@ -74,11 +181,56 @@ static inline void uc_common_init(struct uc_struct* uc)
     uc->vm_start = vm_start;
     uc->memory_map = memory_map;
     uc->memory_map_ptr = memory_map_ptr;
+    uc->memory_map_io = memory_map_io;
     uc->memory_unmap = memory_unmap;
+    uc->memory_decommit = memory_decommit;
+    uc->memory_dirty_query = memory_dirty_query;
+    uc->memory_dirty_reset = memory_dirty_reset;
+    uc->memory_snapshot = memory_snapshot_ram;
+    uc->memory_restore = memory_restore_ram;
+    uc->memory_snapshot_free = memory_snapshot_free_ram;
+    uc->memory_ckpt_delta = memory_ckpt_delta;
+    uc->memory_ckpt_apply = memory_ckpt_apply;
+    uc->memory_ckpt_delta_free = memory_ckpt_delta_free;
+#ifndef _WIN32
+    uc->ram_make_shareable = qemu_ram_make_shareable;
+    uc->ram_set_owned = qemu_ram_set_owned;
+#endif
     uc->readonly_mem = memory_region_set_readonly;
+    uc->memory_batch_begin = memory_region_transaction_begin;
+    uc->memory_batch_commit = memory_region_transaction_commit;
+    uc->tlb_flush = tlb_flush_all;
+    uc->tlb_flush_range = tlb_flush_range_all;
+    uc->tlb_resize = tlb_resize;
+    uc->jmp_cache_resize = jmp_cache_resize;
+    uc->tcg_buffer_resize = tcg_buffer_resize;
+    uc->tb_cache_save = tb_cache_save;
+    uc->tb_cache_load = tb_cache_load;
+    uc->tb_prewarm = tb_prewarm;
+    uc->tb_meta_get = tb_meta_get;
+    uc->tb_stats = tb_stats;
+    uc->mem_stats = mem_stats;
+    uc->tb_invalidate_range = tb_invalidate_range;
+    uc->tb_invalidate_pc_range = tb_invalidate_pc_range;
+    uc->page_tree_reclaim = page_tree_reclaim;
+    uc->profile_flush = tb_profile_flush;
 
     uc->target_page_size = TARGET_PAGE_SIZE;
     uc->target_page_align = TARGET_PAGE_SIZE - 1;
+    uc->tlb_entries = CPU_TLB_SIZE;
+    uc->jmp_cache_bits = TB_JMP_CACHE_BITS;
+    if (uc->mode & UC_MODE_SMALL) {
+        // small-footprint profile: snippet workloads touch a few pages and a
+        // few blocks, so the lookup caches can shrink along with the code
+        // buffer (see SMALL_CODE_GEN_BUFFER_SIZE in translate-all.c)
+        uc->tlb_entries = 64;
+        uc->jmp_cache_bits = 8;
+    }
+
+    // snapshot everything in CPUArchState up to the CPU_COMMON marker:
+    // the TLB tables and the unicorn bookkeeping behind it must not be
+    // copied between save & restore.
+    uc->cpu_context_size = offsetof(CPUArchState, tlb_table);
 
     if (!uc->release)
         uc->release = release_common;
@@ -1215,6 +1215,59 @@ int AES_set_decrypt_key(const unsigned char *userKey, const int bits,
 	return 0;
 }
 
+#if defined(__x86_64__) && defined(__GNUC__)
+/* Single-block AES-NI versions of the table cipher below, used when the
+ * host CPU has the instructions (same dispatch as the ops_sse.h helpers:
+ * __builtin_cpu_supports() plus a target attribute, so no global -maes).
+ * The expanded key is stored as big-endian words (GETU32), so every
+ * round key word is byte-swapped on the way into the xmm register; the
+ * decryption schedule already carries the InvMixColumns form that
+ * AESDEC expects.
+ */
+#define HOST_AES_NI 1
+#include <immintrin.h>
+
+static inline __m128i aes_ni_round_key(const u32 *rk)
+{
+	return _mm_set_epi32(__builtin_bswap32(rk[3]),
+			     __builtin_bswap32(rk[2]),
+			     __builtin_bswap32(rk[1]),
+			     __builtin_bswap32(rk[0]));
+}
+
+static __attribute__((target("aes")))
+void aes_ni_encrypt(const unsigned char *in, unsigned char *out,
+		    const AES_KEY *key)
+{
+	const u32 *rk = key->rd_key;
+	__m128i x = _mm_loadu_si128((const __m128i *)in);
+	int r;
+
+	x = _mm_xor_si128(x, aes_ni_round_key(rk));
+	for (r = 1; r < key->rounds; r++) {
+		x = _mm_aesenc_si128(x, aes_ni_round_key(rk + 4 * r));
+	}
+	x = _mm_aesenclast_si128(x, aes_ni_round_key(rk + 4 * key->rounds));
+	_mm_storeu_si128((__m128i *)out, x);
+}
+
+static __attribute__((target("aes")))
+void aes_ni_decrypt(const unsigned char *in, unsigned char *out,
+		    const AES_KEY *key)
+{
+	const u32 *rk = key->rd_key;
+	__m128i x = _mm_loadu_si128((const __m128i *)in);
+	int r;
+
+	x = _mm_xor_si128(x, aes_ni_round_key(rk));
+	for (r = 1; r < key->rounds; r++) {
+		x = _mm_aesdec_si128(x, aes_ni_round_key(rk + 4 * r));
+	}
+	x = _mm_aesdeclast_si128(x, aes_ni_round_key(rk + 4 * key->rounds));
+	_mm_storeu_si128((__m128i *)out, x);
+}
+#endif
+
 #ifndef AES_ASM
 /*
  * Encrypt a single block
@@ -1230,6 +1283,13 @@ void AES_encrypt(const unsigned char *in, unsigned char *out,
 #endif /* ?FULL_UNROLL */
 
 	assert(in && out && key);
+
+#ifdef HOST_AES_NI
+	if (__builtin_cpu_supports("aes")) {
+		aes_ni_encrypt(in, out, key);
+		return;
+	}
+#endif
 	rk = key->rd_key;
 
 	/*
@@ -1421,6 +1481,13 @@ void AES_decrypt(const unsigned char *in, unsigned char *out,
 #endif /* ?FULL_UNROLL */
 
 	assert(in && out && key);
+
+#ifdef HOST_AES_NI
+	if (__builtin_cpu_supports("aes")) {
+		aes_ni_decrypt(in, out, key);
+		return;
+	}
+#endif
 	rk = key->rd_key;
 
 	/*
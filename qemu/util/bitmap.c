@@ -164,12 +164,19 @@ void bitmap_set(unsigned long *map, long start, long nr)
     int bits_to_set = BITS_PER_LONG - (start % BITS_PER_LONG);
     unsigned long mask_to_set = BITMAP_FIRST_WORD_MASK(start);
 
-    while (nr - bits_to_set >= 0) {
-        *p |= mask_to_set;
-        nr -= bits_to_set;
-        bits_to_set = BITS_PER_LONG;
+    /* masked partial word at the head, then memset for the whole words
+       in the middle: the dirty-memory paths set page-sized ranges in
+       bulk and memset is as wide as the host can go */
+    if (nr - bits_to_set >= 0) {
+        if (bits_to_set < BITS_PER_LONG) {
+            *p |= mask_to_set;
+            nr -= bits_to_set;
+            p++;
+        }
+        memset(p, 0xff, (nr / BITS_PER_LONG) * sizeof(unsigned long));
+        p += nr / BITS_PER_LONG;
+        nr %= BITS_PER_LONG;
         mask_to_set = ~0UL;
-        p++;
     }
     if (nr) {
         mask_to_set &= BITMAP_LAST_WORD_MASK(size);
@@ -184,12 +191,16 @@ void bitmap_clear(unsigned long *map, long start, long nr)
     int bits_to_clear = BITS_PER_LONG - (start % BITS_PER_LONG);
     unsigned long mask_to_clear = BITMAP_FIRST_WORD_MASK(start);
 
-    while (nr - bits_to_clear >= 0) {
-        *p &= ~mask_to_clear;
-        nr -= bits_to_clear;
-        bits_to_clear = BITS_PER_LONG;
+    if (nr - bits_to_clear >= 0) {
+        if (bits_to_clear < BITS_PER_LONG) {
+            *p &= ~mask_to_clear;
+            nr -= bits_to_clear;
+            p++;
+        }
+        memset(p, 0, (nr / BITS_PER_LONG) * sizeof(unsigned long));
+        p += nr / BITS_PER_LONG;
+        nr %= BITS_PER_LONG;
         mask_to_clear = ~0UL;
-        p++;
     }
     if (nr) {
         mask_to_clear &= BITMAP_LAST_WORD_MASK(size);
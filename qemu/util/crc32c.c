@@ -105,8 +105,40 @@ static const uint32_t crc32c_table[256] = {
 };
 
 
+#if defined(__x86_64__) && defined(__GNUC__)
+/* The SSE4.2 crc32 instruction implements exactly this polynomial, and
+ * guest CRC32C instruction helpers call us in tight loops.  Use the
+ * hardware op when the host has it; the table walk below stays as the
+ * portable fallback.  The target attribute lets this compile without
+ * -msse4.2 in the global CFLAGS.
+ */
+#include <immintrin.h>
+
+static __attribute__((target("sse4.2")))
+uint32_t crc32c_hw(uint32_t crc, const uint8_t *data, unsigned int length)
+{
+    while (length >= 8) {
+        uint64_t qword;
+
+        memcpy(&qword, data, 8);
+        crc = (uint32_t)_mm_crc32_u64(crc, qword);
+        data += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
 uint32_t crc32c(uint32_t crc, const uint8_t *data, unsigned int length)
 {
+#if defined(__x86_64__) && defined(__GNUC__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return crc32c_hw(crc, data, length) ^ 0xffffffff;
+    }
+#endif
     while (length--) {
         crc = crc32c_table[(crc ^ *data++) & 0xFFL] ^ (crc >> 8);
     }
@@ -56,13 +56,13 @@ static const ElfW_auxv_t *qemu_init_auxval(void)
 
     /* Allocate some initial storage.  Make sure the first entry is set
        to end-of-list, so that we've got a valid list in case of error.  */
-    auxv = a = g_malloc(size);
+    a = g_malloc(size);
     a[0].a_type = 0;
     a[0].a_val = 0;
 
     fd = open("/proc/self/auxv", O_RDONLY);
     if (fd < 0) {
-        return a;
+        goto done;
     }
 
     /* Read the first SIZE bytes.  Hopefully, this covers everything.  */
@@ -73,12 +73,17 @@ static const ElfW_auxv_t *qemu_init_auxval(void)
         do {
             ofs = size;
             size *= 2;
-            auxv = a = g_realloc(a, size);
+            a = g_realloc(a, size);
             r = read(fd, (char *)a + ofs, ofs);
         } while (r == ofs);
 }
 
     close(fd);
+done:
+    /* Publish only the completed list: callers on other threads read
+       auxv without a lock.  Racing first callers each build their own
+       copy; the extra ones leak, which is harmless and one-time.  */
+    auxv = a;
     return a;
 }
 
@@ -266,9 +266,10 @@ struct QemuThreadData {
     bool              exited;
     void             *ret;
     CRITICAL_SECTION  cs;
-    struct uc_struct *uc;
 };
 
+static __thread QemuThreadData *qemu_thread_data;
+
 static unsigned __stdcall win32_start_routine(void *arg)
 {
     QemuThreadData *data = (QemuThreadData *) arg;
@@ -279,13 +280,14 @@ static unsigned __stdcall win32_start_routine(void *arg)
         g_free(data);
         data = NULL;
     }
-    qemu_thread_exit(data->uc, start_routine(thread_arg));
+    qemu_thread_data = data;
+    qemu_thread_exit(start_routine(thread_arg));
     abort();
 }
 
-void qemu_thread_exit(struct uc_struct *uc, void *arg)
+void qemu_thread_exit(void *arg)
 {
-    QemuThreadData *data = uc->qemu_thread_data;
+    QemuThreadData *data = qemu_thread_data;
 
     if (data) {
         assert(data->mode != QEMU_THREAD_DETACHED);
@@ -326,7 +328,7 @@ void *qemu_thread_join(QemuThread *thread)
     return ret;
 }
 
-int qemu_thread_create(struct uc_struct *uc, QemuThread *thread, const char *name,
+int qemu_thread_create(QemuThread *thread, const char *name,
                        void *(*start_routine)(void *),
                        void *arg, int mode)
 {
@@ -338,9 +340,6 @@ int qemu_thread_create(struct uc_struct *uc, QemuThread *thread, const char *nam
     data->arg = arg;
     data->mode = mode;
     data->exited = false;
-    data->uc = uc;
-
-    uc->qemu_thread_data = data;
 
     if (data->mode != QEMU_THREAD_DETACHED) {
         InitializeCriticalSection(&data->cs);
@@ -359,9 +358,9 @@ int qemu_thread_create(struct uc_struct *uc, QemuThread *thread, const char *nam
     return 0;
 }
 
-void qemu_thread_get_self(struct uc_struct *uc, QemuThread *thread)
+void qemu_thread_get_self(QemuThread *thread)
 {
-    thread->data = uc->qemu_thread_data;
+    thread->data = qemu_thread_data;
     thread->tid = GetCurrentThreadId();
 }
 
@@ -45,10 +45,12 @@ static void __attribute__((constructor)) init_get_clock(void)
 #else
 
 int use_rt_clock;
+int use_coarse_clock;
 
 static void __attribute__((constructor)) init_get_clock(void)
 {
     use_rt_clock = 0;
+    use_coarse_clock = 0;
 #ifdef CLOCK_MONOTONIC
     {
         struct timespec ts;
@@ -57,5 +59,13 @@ static void __attribute__((constructor)) init_get_clock(void)
         }
     }
 #endif
+#ifdef CLOCK_MONOTONIC_COARSE
+    {
+        struct timespec ts;
+        if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0) {
+            use_coarse_clock = 1;
+        }
+    }
+#endif
 }
 #endif
@@ -47,14 +47,10 @@ void cpu_resume(CPUState *cpu)
 
 void qemu_cpu_kick(CPUState *cpu)
 {
-    qemu_cond_broadcast(cpu->halt_cond);
-}
-
-
-void qemu_init_cpu_loop(struct uc_struct* uc)
-{
-    qemu_cond_init(&uc->qemu_cpu_cond);
-    qemu_mutex_init(&uc->qemu_global_mutex);
+    // emulation runs synchronously on the thread that started it, so
+    // there is no sleeping vcpu thread to wake; a pending interrupt is
+    // noticed through interrupt_request/tcg_exit_req instead
+    (void)cpu;
 }
 
 void cpu_stop_current(struct uc_struct *uc)
@@ -93,8 +89,16 @@ int machine_initialize(struct uc_struct *uc)
 {
     MachineClass *machine_class;
     MachineState *current_machine;
+    bool attached;
+
+    /* Unicorn: the type graph of a given arch variant is identical for
+       every instance, and interning all the static TypeInfo tables again
+       is a measurable slice of uc_open(). Attach to the graph published
+       by the first open of this variant when there is one; the
+       registration calls below then resolve against it (type_register()
+       returns the existing types) instead of rebuilding it. */
+    attached = type_table_attach(uc, (void *)uc->init_arch);
 
-    module_call_init(uc, MODULE_INIT_QOM);
     register_types_object(uc);
     machine_register_types(uc);
     container_register_types(uc);
@@ -104,7 +108,9 @@ int machine_initialize(struct uc_struct *uc)
     // Initialize arch specific.
     uc->init_arch(uc);
 
-    module_call_init(uc, MODULE_INIT_MACHINE);
+    if (!attached) {
+        type_table_publish(uc, (void *)uc->init_arch);
+    }
     // this will auto initialize all register objects above.
     machine_class = find_default_machine(uc, uc->arch);
     if (machine_class == NULL) {
@@ -122,9 +128,6 @@ int machine_initialize(struct uc_struct *uc)
     machine_class->max_cpus = 1;
     configure_accelerator(current_machine);
 
-    qemu_init_cpu_loop(uc);
-    qemu_mutex_lock_iothread(uc);
-
     current_machine->cpu_model = NULL;
 
     return machine_class->init(uc, current_machine);
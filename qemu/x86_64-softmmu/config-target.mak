@@ -0,0 +1,9 @@
+# Automatically generated by configure - do not modify
+TARGET_X86_64=y
+TARGET_NAME=x86_64
+TARGET_BASE_ARCH=i386
+TARGET_ABI_DIR=x86_64
+CONFIG_SOFTMMU=y
+LDFLAGS+=
+QEMU_CFLAGS+=
+QEMU_CFLAGS+=-include x86_64.h
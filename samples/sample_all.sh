@@ -42,3 +42,7 @@ if test -e $DIR/sample_m68k; then
   echo "=========================="
   $DIR/sample_m68k
 fi
+if test -e $DIR/sample_fuzz; then
+  echo "=========================="
+  $DIR/sample_fuzz
+fi
@@ -0,0 +1,227 @@
+/* Unicorn Emulator Engine */
+
+/* Sample showing the fast path for fuzzing-style workloads: snapshot +
+   incremental dirty-page rollback, the inline edge-coverage bitmap,
+   persistent mode (uc_fuzz_loop), batched register setup and zero-copy
+   input placement - with a measured execs/sec printout.
+
+   This is the pattern to copy for high iteration rates. The slow pattern
+   (per-instruction UC_HOOK_CODE everywhere, uc_close()/uc_open() per
+   input, uc_mem_write() of all guest state every run) costs orders of
+   magnitude in throughput. */
+
+// windows specific
+#ifdef _MSC_VER
+#include <io.h>
+#include <windows.h>
+#define PRIx64 "llX"
+#ifdef DYNLOAD
+#include "unicorn_dynload.h"
+#else // DYNLOAD
+#include <unicorn/unicorn.h>
+#ifdef _WIN64
+#pragma comment(lib, "unicorn_staload64.lib")
+#else // _WIN64
+#pragma comment(lib, "unicorn_staload.lib")
+#endif // _WIN64
+#endif // DYNLOAD
+
+// posix specific
+#else // _MSC_VER
+#include <unistd.h>
+#include <inttypes.h>
+#include <unicorn/unicorn.h>
+#endif // _MSC_VER
+
+// common includes
+#include <string.h>
+#include <time.h>
+
+
+// The guest "parser" under test: checks the input at [edx] byte by byte
+// for the magic "UCF" and leaves a marker next to the input when it
+// matches, so successful runs dirty guest memory that the rollback has
+// to undo.
+//
+//   00: 8a 02          mov  al, [edx]
+//   02: 3c 55          cmp  al, 'U'
+//   04: 75 14          jne  done
+//   06: 8a 42 01       mov  al, [edx+1]
+//   09: 3c 43          cmp  al, 'C'
+//   0b: 75 0d          jne  done
+//   0d: 8a 42 02       mov  al, [edx+2]
+//   10: 3c 46          cmp  al, 'F'
+//   12: 75 06          jne  done
+//   14: c6 42 40 01    mov  byte [edx+0x40], 1
+//   18: eb 00          jmp  done
+//   1a:             done:                        <- exit address
+#define X86_PARSER \
+    "\x8a\x02\x3c\x55\x75\x14\x8a\x42\x01\x3c\x43\x75\x0d" \
+    "\x8a\x42\x02\x3c\x46\x75\x06\xc6\x42\x40\x01\xeb\x00"
+#define PARSER_SIZE (sizeof(X86_PARSER) - 1)
+
+#define CODE_ADDRESS  0x1000000
+#define INPUT_ADDRESS 0x200000
+#define INPUT_SIZE    4
+
+#define ITERATIONS    200000
+
+#define COV_MAP_SIZE  (1 << 16)
+static uint8_t cov_bitmap[COV_MAP_SIZE];
+
+// host pointer to the guest input page, from uc_mem_ptr(); writing the
+// next input through it skips the uc_mem_write() call per iteration
+static uint8_t *input_ptr;
+
+// derive a deterministic pseudo-random input for iteration @i; every so
+// often it hits the magic so both sides of each branch get executed
+static void make_input(uint8_t *input, uint64_t i)
+{
+    uint32_t x = (uint32_t)(i * 2654435761u);
+
+    input[0] = (i % 7) ? (uint8_t)x : 'U';
+    input[1] = (i % 5) ? (uint8_t)(x >> 8) : 'C';
+    input[2] = (i % 3) ? (uint8_t)(x >> 16) : 'F';
+    input[3] = (uint8_t)(x >> 24);
+}
+
+static bool place_input(uc_engine *uc, uint64_t iteration, void *user_data)
+{
+    make_input(input_ptr, iteration);
+    return true;
+}
+
+static int count_edges(void)
+{
+    int i, edges = 0;
+
+    for (i = 0; i < COV_MAP_SIZE; i++) {
+        if (cov_bitmap[i])
+            edges++;
+    }
+    return edges;
+}
+
+static double now_secs(void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static void test_fuzz(void)
+{
+    uc_engine *uc;
+    uc_err err;
+    struct uc_snapshot *snapshot;
+    const uint64_t exit_address = CODE_ADDRESS + PARSER_SIZE;
+    uint64_t r_edx = INPUT_ADDRESS;
+    uint64_t r_eax = 0;
+    int regs[] = { UC_X86_REG_EDX, UC_X86_REG_EAX };
+    void *vals[] = { &r_edx, &r_eax };
+    size_t avail;
+    double t0, manual_secs, persistent_secs;
+    uint64_t i;
+
+    printf("Fuzzing fast-path demo, %u iterations per mode\n", ITERATIONS);
+
+    err = uc_open(UC_ARCH_X86, UC_MODE_32, &uc);
+    if (err) {
+        printf("Failed on uc_open() with error returned: %u\n", err);
+        return;
+    }
+
+    uc_mem_map(uc, CODE_ADDRESS, 0x1000, UC_PROT_ALL);
+    uc_mem_map(uc, INPUT_ADDRESS, 0x1000, UC_PROT_READ | UC_PROT_WRITE);
+    uc_mem_write(uc, CODE_ADDRESS, X86_PARSER, PARSER_SIZE);
+
+    // one call sets every register the target needs; with many registers
+    // (a real calling convention, saved context) this beats a string of
+    // uc_reg_write() calls
+    uc_reg_write_batch(uc, regs, vals, 2);
+
+    // host pointer to the input page: inputs are placed with a memcpy
+    // into engine-owned memory, no per-iteration API call
+    err = uc_mem_ptr(uc, INPUT_ADDRESS, (void **)&input_ptr, &avail);
+    if (err) {
+        printf("Failed on uc_mem_ptr() with error returned: %u\n", err);
+        uc_close(uc);
+        return;
+    }
+
+    // inline AFL-style edge coverage; no callback runs, the generated
+    // code updates the bitmap itself
+    uc_coverage_enable(uc, cov_bitmap, COV_MAP_SIZE);
+
+    // setup writes are not interesting to the dirty tracking
+    uc_mem_dirty_reset(uc, INPUT_ADDRESS, 0x1000);
+
+    // ---- mode 1: explicit snapshot/restore loop ------------------------
+    // one full snapshot up front; every restore afterwards copies back
+    // only the pages the run dirtied (input page, marker byte), not the
+    // whole guest
+    err = uc_snapshot(uc, &snapshot);
+    if (err) {
+        printf("Failed on uc_snapshot() with error returned: %u\n", err);
+        uc_close(uc);
+        return;
+    }
+
+    t0 = now_secs();
+    for (i = 0; i < ITERATIONS; i++) {
+        make_input(input_ptr, i);
+        err = uc_emu_start(uc, CODE_ADDRESS, exit_address, 0, 0);
+        if (err) {
+            // a real fuzzer triages here: CPU and memory still hold the
+            // faulting state
+            printf("iteration %"PRIu64 " failed: %s\n", i, uc_strerror(err));
+            break;
+        }
+        uc_restore(uc, snapshot);
+    }
+    manual_secs = now_secs() - t0;
+    uc_snapshot_free(uc, snapshot);
+
+    // ---- mode 2: persistent mode ---------------------------------------
+    // the same loop run entirely inside the library; snapshot, rollback
+    // and exit detection are internal, the callback only places inputs
+    t0 = now_secs();
+    err = uc_fuzz_loop(uc, CODE_ADDRESS, &exit_address, 1, ITERATIONS,
+            place_input, NULL);
+    persistent_secs = now_secs() - t0;
+    if (err) {
+        printf("Failed on uc_fuzz_loop() with error returned: %u\n", err);
+        uc_close(uc);
+        return;
+    }
+
+    printf(">>> snapshot/restore loop: %.2f secs, %.0f execs/sec\n",
+            manual_secs, ITERATIONS / manual_secs);
+    printf(">>> persistent mode:       %.2f secs, %.0f execs/sec\n",
+            persistent_secs, ITERATIONS / persistent_secs);
+    printf(">>> edges covered: %d\n", count_edges());
+
+    uc_coverage_disable(uc);
+    uc_close(uc);
+}
+
+int main(int argc, char **argv, char **envp)
+{
+    // dynamically load shared library
+#ifdef DYNLOAD
+    if (!uc_dyn_load(NULL, 0)) {
+        printf("Error dynamically loading shared library.\n");
+        printf("Please check that unicorn.dll/unicorn.so is available as well as\n");
+        printf("any other dependent dll/so files.\n");
+        printf("The easiest way is to place them in the same directory as this app.\n");
+        return 1;
+    }
+#endif
+
+    test_fuzz();
+
+    // dynamically free shared library
+#ifdef DYNLOAD
+    uc_dyn_free();
+#endif
+
+    return 0;
+}
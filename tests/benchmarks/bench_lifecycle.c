@@ -0,0 +1,126 @@
+// Engine lifecycle latency benchmark, run with `make bench` from the
+// top level. uc_open() cost (machine init, QOM setup, the translation
+// buffer allocation) gates process-per-testcase architectures, so this
+// tracks it per arch:
+//
+//   <arch>_open_cold - the first uc_open() of that arch in the process,
+//                      before any lazily built type tables exist
+//   <arch>_open_warm - subsequent uc_open() calls, P50/P99
+//   <arch>_close     - uc_close(), P50/P99
+//   <arch>_reset     - uc_reset() on a live engine, P50/P99
+//
+// Output is one CSV line per metric for regression tracking:
+//   name,samples,p50_ns,p99_ns
+// (cold open is a single sample, so both percentiles repeat it).
+// Arches compiled out of the library are skipped with a '#' comment.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <unicorn/unicorn.h>
+
+#define WARM_SAMPLES 200
+
+static const struct {
+    const char *name;
+    uc_arch arch;
+    uc_mode mode;
+} arches[] = {
+    { "x86",    UC_ARCH_X86,   UC_MODE_32 },
+    { "x86_64", UC_ARCH_X86,   UC_MODE_64 },
+    { "arm",    UC_ARCH_ARM,   UC_MODE_ARM },
+    { "arm64",  UC_ARCH_ARM64, UC_MODE_ARM },
+    { "mips",   UC_ARCH_MIPS,  UC_MODE_MIPS32 },
+    { "sparc",  UC_ARCH_SPARC, UC_MODE_SPARC32 | UC_MODE_BIG_ENDIAN },
+    { "m68k",   UC_ARCH_M68K,  UC_MODE_BIG_ENDIAN },
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void report(const char *arch, const char *op, uint64_t *samples,
+        unsigned count)
+{
+    qsort(samples, count, sizeof(*samples), cmp_u64);
+    printf("%s_%s,%u,%llu,%llu\n", arch, op, count,
+            (unsigned long long)samples[count / 2],
+            (unsigned long long)samples[count - 1 - count / 100]);
+}
+
+static int bench_arch(const char *name, uc_arch arch, uc_mode mode)
+{
+    static uint64_t opens[WARM_SAMPLES], closes[WARM_SAMPLES],
+            resets[WARM_SAMPLES];
+    uc_engine *uc;
+    uint64_t t0, cold;
+    unsigned i;
+    uc_err err;
+
+    // cold open: first engine of this arch in the process
+    t0 = now_ns();
+    err = uc_open(arch, mode, &uc);
+    cold = now_ns() - t0;
+    if (err != UC_ERR_OK) {
+        printf("# %s skipped: %s\n", name, uc_strerror(err));
+        return 0;
+    }
+    printf("%s_open_cold,1,%llu,%llu\n", name, (unsigned long long)cold,
+            (unsigned long long)cold);
+
+    // reset latency on the live engine
+    for (i = 0; i < WARM_SAMPLES; i++) {
+        t0 = now_ns();
+        err = uc_reset(uc);
+        resets[i] = now_ns() - t0;
+        if (err != UC_ERR_OK) {
+            printf("# %s_reset failed: %s\n", name, uc_strerror(err));
+            uc_close(uc);
+            return 1;
+        }
+    }
+    report(name, "reset", resets, WARM_SAMPLES);
+    uc_close(uc);
+
+    // warm open/close pairs
+    for (i = 0; i < WARM_SAMPLES; i++) {
+        t0 = now_ns();
+        err = uc_open(arch, mode, &uc);
+        opens[i] = now_ns() - t0;
+        if (err != UC_ERR_OK) {
+            printf("# %s_open_warm failed: %s\n", name, uc_strerror(err));
+            return 1;
+        }
+        t0 = now_ns();
+        uc_close(uc);
+        closes[i] = now_ns() - t0;
+    }
+    report(name, "open_warm", opens, WARM_SAMPLES);
+    report(name, "close", closes, WARM_SAMPLES);
+    return 0;
+}
+
+int main(void)
+{
+    unsigned i;
+    int failures = 0;
+
+    printf("# name,samples,p50_ns,p99_ns\n");
+    for (i = 0; i < sizeof(arches) / sizeof(arches[0]); i++)
+        failures += bench_arch(arches[i].name, arches[i].arch,
+                arches[i].mode);
+
+    return failures;
+}
@@ -0,0 +1,175 @@
+// Mapping-churn stress benchmark, run with `make bench` from the top
+// level. Loader-heavy workloads regress on mapping cost more often than
+// on raw emulation speed; this exercises the paths behind it:
+//
+//   map_unmap_pair    - uc_mem_map() + uc_mem_unmap() of one page with
+//                       no other regions mapped
+//   map_many          - mapping thousands of disjoint pages, so each
+//                       map rebuilds a growing memory view
+//   unmap_many        - tearing those regions down again
+//   protect_many      - uc_mem_protect() over every mapped region
+//                       (perm update + tlb flush)
+//   split_unmap       - punching page holes into one large region,
+//                       forcing the region to be split and copied
+//   map_while_running - map/unmap between short uc_emu_start() bursts,
+//                       so every burst restarts with a cold TLB
+//
+// Output format matches bench_overhead.c: one CSV line per metric,
+// name,ops,total_ns,ns_per_op; '#' lines are comments.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <unicorn/unicorn.h>
+
+#define CODE_BASE   0x1000000
+#define CODE_SIZE   0x100000
+#define REGION_BASE 0x10000000
+#define REGION_STEP 0x2000
+#define NREGIONS    4096
+#define PAGE        0x1000
+
+// dec ecx; jnz <loop>
+static const uint8_t loop_code[] = {
+    0xff, 0xc9, 0x75, 0xfc,
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t ops, uint64_t total_ns)
+{
+    printf("%s,%llu,%llu,%.1f\n", name, (unsigned long long)ops,
+            (unsigned long long)total_ns, (double)total_ns / ops);
+}
+
+static int fail(const char *name, uc_err err)
+{
+    printf("# %s failed: %s\n", name, uc_strerror(err));
+    return 1;
+}
+
+static int bench_map_churn(uc_engine *uc)
+{
+    const uint64_t pairs = 10000;
+    uint64_t t0, i;
+    uc_err err = UC_ERR_OK;
+
+    t0 = now_ns();
+    for (i = 0; i < pairs && !err; i++) {
+        err = uc_mem_map(uc, REGION_BASE, PAGE, UC_PROT_ALL);
+        if (!err)
+            err = uc_mem_unmap(uc, REGION_BASE, PAGE);
+    }
+    if (err != UC_ERR_OK)
+        return fail("map_unmap_pair", err);
+    report("map_unmap_pair", pairs, now_ns() - t0);
+    return 0;
+}
+
+static int bench_many_regions(uc_engine *uc)
+{
+    uint64_t t0, i;
+    uc_err err = UC_ERR_OK;
+
+    t0 = now_ns();
+    for (i = 0; i < NREGIONS && !err; i++)
+        err = uc_mem_map(uc, REGION_BASE + i * REGION_STEP, PAGE,
+                UC_PROT_ALL);
+    if (err != UC_ERR_OK)
+        return fail("map_many", err);
+    report("map_many", NREGIONS, now_ns() - t0);
+
+    t0 = now_ns();
+    for (i = 0; i < NREGIONS && !err; i++)
+        err = uc_mem_protect(uc, REGION_BASE + i * REGION_STEP, PAGE,
+                UC_PROT_READ);
+    if (err != UC_ERR_OK)
+        return fail("protect_many", err);
+    report("protect_many", NREGIONS, now_ns() - t0);
+
+    t0 = now_ns();
+    for (i = 0; i < NREGIONS && !err; i++)
+        err = uc_mem_unmap(uc, REGION_BASE + i * REGION_STEP, PAGE);
+    if (err != UC_ERR_OK)
+        return fail("unmap_many", err);
+    report("unmap_many", NREGIONS, now_ns() - t0);
+    return 0;
+}
+
+static int bench_split(uc_engine *uc)
+{
+    const uint64_t holes = 256;
+    uint64_t t0, i;
+    uc_err err;
+
+    // one large region, then unmap every other page from the middle:
+    // each hole splits a region and copies its backing
+    err = uc_mem_map(uc, REGION_BASE, holes * 2 * PAGE, UC_PROT_ALL);
+    if (err != UC_ERR_OK)
+        return fail("split_unmap", err);
+    t0 = now_ns();
+    for (i = 0; i < holes && !err; i++)
+        err = uc_mem_unmap(uc, REGION_BASE + i * 2 * PAGE, PAGE);
+    if (err != UC_ERR_OK)
+        return fail("split_unmap", err);
+    report("split_unmap", holes, now_ns() - t0);
+
+    for (i = 0; i < holes; i++)
+        uc_mem_unmap(uc, REGION_BASE + i * 2 * PAGE + PAGE, PAGE);
+    return 0;
+}
+
+static int bench_map_while_running(uc_engine *uc)
+{
+    const uint64_t rounds = 1000;
+    uint64_t counter, t0, i;
+    uc_err err = UC_ERR_OK;
+
+    t0 = now_ns();
+    for (i = 0; i < rounds && !err; i++) {
+        counter = 1000;
+        err = uc_reg_write(uc, UC_X86_REG_ECX, &counter);
+        if (!err)
+            err = uc_emu_start(uc, CODE_BASE, CODE_BASE + sizeof(loop_code),
+                    0, 0);
+        if (!err)
+            err = uc_mem_map(uc, REGION_BASE, PAGE, UC_PROT_ALL);
+        if (!err)
+            err = uc_mem_unmap(uc, REGION_BASE, PAGE);
+    }
+    if (err != UC_ERR_OK)
+        return fail("map_while_running", err);
+    report("map_while_running", rounds, now_ns() - t0);
+    return 0;
+}
+
+int main(void)
+{
+    uc_engine *uc;
+    uc_err err;
+    int failures = 0;
+
+    err = uc_open(UC_ARCH_X86, UC_MODE_32, &uc);
+    if (!err)
+        err = uc_mem_map(uc, CODE_BASE, CODE_SIZE, UC_PROT_ALL);
+    if (!err)
+        err = uc_mem_write(uc, CODE_BASE, loop_code, sizeof(loop_code));
+    if (err != UC_ERR_OK)
+        return fail("setup", err);
+
+    printf("# name,ops,total_ns,ns_per_op\n");
+    failures += bench_map_churn(uc);
+    failures += bench_many_regions(uc);
+    failures += bench_split(uc);
+    failures += bench_map_while_running(uc);
+
+    uc_close(uc);
+    return failures;
+}
@@ -0,0 +1,239 @@
+// API-overhead microbenchmarks, run with `make bench` from the top
+// level. Measures the fixed cost per hook event and per API call that
+// gets quoted when comparing builds:
+//
+//   hook_code_event   - one UC_HOOK_CODE callback (helper_uc_tracecode
+//                       dispatch), net of the unhooked run of the same
+//                       kernel
+//   hook_mem_event    - one UC_HOOK_MEM_WRITE callback, same method
+//   reg_read          - one uc_reg_read() of a GPR
+//   mem_read_64b/4k/1m - one uc_mem_read() of that size
+//   hook_add_del      - one uc_hook_add()/uc_hook_del() pair
+//
+// Output is machine readable for regression tracking across commits,
+// one CSV line per metric:  name,events,total_ns,ns_per_event
+// Lines starting with '#' are comments. Everything runs on x86-32,
+// which every build of the library includes.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <unicorn/unicorn.h>
+
+#define CODE_BASE  0x1000000
+#define MAP_SIZE   (2 * 1024 * 1024)
+#define SRC_ADDR   (CODE_BASE + 0x100000)
+#define DST_ADDR   (CODE_BASE + 0x180000)
+
+// dec ecx; jnz <loop>
+static const uint8_t loop_code[] = {
+    0xff, 0xc9, 0x75, 0xfc,
+};
+
+// mov eax, [esi]; mov [edi], eax; dec ecx; jnz <loop>
+static const uint8_t memcpy_code[] = {
+    0x8b, 0x06, 0x89, 0x07, 0xff, 0xc9, 0x75, 0xf8,
+};
+
+static uint64_t event_count;
+
+static void count_code_cb(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    event_count++;
+}
+
+static void count_mem_cb(uc_engine *uc, uc_mem_type type, uint64_t address,
+        int size, int64_t value, void *user_data)
+{
+    event_count++;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void report(const char *name, uint64_t events, uint64_t total_ns)
+{
+    printf("%s,%llu,%llu,%.1f\n", name, (unsigned long long)events,
+            (unsigned long long)total_ns, (double)total_ns / events);
+}
+
+// open an engine with the benchmark map and the loop counter preset
+static uc_err open_engine(uc_engine **uc, const uint8_t *code, size_t size,
+        uint64_t iterations)
+{
+    uint64_t src = SRC_ADDR, dst = DST_ADDR;
+    uc_err err;
+
+    err = uc_open(UC_ARCH_X86, UC_MODE_32, uc);
+    if (err != UC_ERR_OK)
+        return err;
+    if (!err)
+        err = uc_mem_map(*uc, CODE_BASE, MAP_SIZE, UC_PROT_ALL);
+    if (!err)
+        err = uc_mem_write(*uc, CODE_BASE, code, size);
+    if (!err)
+        err = uc_reg_write(*uc, UC_X86_REG_ECX, &iterations);
+    if (!err)
+        err = uc_reg_write(*uc, UC_X86_REG_ESI, &src);
+    if (!err)
+        err = uc_reg_write(*uc, UC_X86_REG_EDI, &dst);
+    return err;
+}
+
+// wall time of one run of @code; with @htype != 0, a counting hook of
+// that type is registered first
+static uc_err run_kernel(const uint8_t *code, size_t size, int htype,
+        void *callback, uint64_t iterations, uint64_t *wall_ns)
+{
+    uc_engine *uc;
+    uc_hook hh = 0;
+    uint64_t t0;
+    uc_err err;
+
+    err = open_engine(&uc, code, size, iterations);
+    if (err != UC_ERR_OK)
+        return err;
+    if (htype != 0)
+        err = uc_hook_add(uc, &hh, htype, callback, NULL, (uint64_t)1, 0);
+    if (err == UC_ERR_OK) {
+        t0 = now_ns();
+        err = uc_emu_start(uc, CODE_BASE, CODE_BASE + size, 0, 0);
+        *wall_ns = now_ns() - t0;
+    }
+    uc_close(uc);
+    return err;
+}
+
+static int bench_hook_events(void)
+{
+    const uint64_t iterations = 1 << 20;
+    uint64_t plain_ns, hooked_ns, net;
+    uc_err err;
+
+    // UC_HOOK_CODE: every instruction of the loop fires the hook
+    err = run_kernel(loop_code, sizeof(loop_code), 0, NULL, iterations,
+            &plain_ns);
+    if (!err) {
+        event_count = 0;
+        err = run_kernel(loop_code, sizeof(loop_code), UC_HOOK_CODE,
+                count_code_cb, iterations, &hooked_ns);
+    }
+    if (err != UC_ERR_OK) {
+        printf("# hook_code_event failed: %s\n", uc_strerror(err));
+        return 1;
+    }
+    net = hooked_ns > plain_ns ? hooked_ns - plain_ns : 0;
+    report("hook_code_event", event_count, net);
+
+    // UC_HOOK_MEM_WRITE: one store per iteration fires the hook
+    err = run_kernel(memcpy_code, sizeof(memcpy_code), 0, NULL, iterations,
+            &plain_ns);
+    if (!err) {
+        event_count = 0;
+        err = run_kernel(memcpy_code, sizeof(memcpy_code), UC_HOOK_MEM_WRITE,
+                count_mem_cb, iterations, &hooked_ns);
+    }
+    if (err != UC_ERR_OK) {
+        printf("# hook_mem_event failed: %s\n", uc_strerror(err));
+        return 1;
+    }
+    net = hooked_ns > plain_ns ? hooked_ns - plain_ns : 0;
+    report("hook_mem_event", event_count, net);
+    return 0;
+}
+
+static int bench_reg_read(void)
+{
+    const uint64_t calls = 1 << 20;
+    uc_engine *uc;
+    uint64_t value, t0, i;
+    uc_err err;
+
+    err = open_engine(&uc, loop_code, sizeof(loop_code), 1);
+    if (err != UC_ERR_OK) {
+        printf("# reg_read failed: %s\n", uc_strerror(err));
+        return 1;
+    }
+    t0 = now_ns();
+    for (i = 0; i < calls; i++)
+        uc_reg_read(uc, UC_X86_REG_EAX, &value);
+    report("reg_read", calls, now_ns() - t0);
+    uc_close(uc);
+    return 0;
+}
+
+static int bench_mem_read(void)
+{
+    static const struct {
+        const char *name;
+        size_t size;
+        uint64_t calls;
+    } sizes[] = {
+        { "mem_read_64b", 64,          100000 },
+        { "mem_read_4k",  4096,        10000 },
+        { "mem_read_1m",  1024 * 1024, 100 },
+    };
+    static uint8_t buf[1024 * 1024];
+    uc_engine *uc;
+    uint64_t t0, i;
+    unsigned s;
+    uc_err err;
+
+    err = open_engine(&uc, loop_code, sizeof(loop_code), 1);
+    if (err != UC_ERR_OK) {
+        printf("# mem_read failed: %s\n", uc_strerror(err));
+        return 1;
+    }
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        t0 = now_ns();
+        for (i = 0; i < sizes[s].calls; i++)
+            uc_mem_read(uc, CODE_BASE, buf, sizes[s].size);
+        report(sizes[s].name, sizes[s].calls, now_ns() - t0);
+    }
+    uc_close(uc);
+    return 0;
+}
+
+static int bench_hook_churn(void)
+{
+    const uint64_t pairs = 100000;
+    uc_engine *uc;
+    uc_hook hh;
+    uint64_t t0, i;
+    uc_err err;
+
+    err = open_engine(&uc, loop_code, sizeof(loop_code), 1);
+    if (err != UC_ERR_OK) {
+        printf("# hook_add_del failed: %s\n", uc_strerror(err));
+        return 1;
+    }
+    t0 = now_ns();
+    for (i = 0; i < pairs; i++) {
+        uc_hook_add(uc, &hh, UC_HOOK_CODE, count_code_cb, NULL,
+                (uint64_t)1, 0);
+        uc_hook_del(uc, hh);
+    }
+    report("hook_add_del", pairs, now_ns() - t0);
+    uc_close(uc);
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    printf("# name,events,total_ns,ns_per_event\n");
+    failures += bench_hook_events();
+    failures += bench_reg_read();
+    failures += bench_mem_read();
+    failures += bench_hook_churn();
+
+    return failures;
+}
@@ -0,0 +1,277 @@
+// Throughput benchmarks: standardized guest kernels per arch, run with
+// `make bench` from the top level. Every kernel is a tight loop with a
+// known number of instructions per iteration, so the harness can report
+// guest-MIPS from wall time alone, plus how much of the wall time went
+// to translation (UC_QUERY_JIT_TIME_NS before/after the run).
+//
+// Kernels:
+//   int     - dhrystone-style integer ALU loop
+//   memcpy  - load/store pair per iteration
+//   branch  - branch-dense loop (taken and not-taken conditionals)
+//   fp      - floating point loop; x86 only, the ARM targets reset with
+//             the VFP/SIMD units disabled
+//
+// The loop counter, source and destination pointers are set through
+// uc_reg_write() before the run, so the code blobs contain only the loop
+// itself. Multi-byte instruction words are stored as host-endian
+// uint32_t and assume a little-endian host, like the rest of tests/.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <unicorn/unicorn.h>
+
+#define CODE_BASE  0x1000000
+#define MAP_SIZE   (2 * 1024 * 1024)
+#define SRC_ADDR   (CODE_BASE + 0x100000)
+#define DST_ADDR   (CODE_BASE + 0x180000)
+#define ITERATIONS (1 << 22)
+
+// x86: same encodings are valid in 32-bit and 64-bit mode (dec ecx is
+// spelled ff c9, since 0x49 is a REX prefix in long mode)
+
+static const uint8_t x86_int[] = {
+    0x01, 0xd8,             // add eax, ebx
+    0x31, 0xd0,             // xor eax, edx
+    0x83, 0xc0, 0x03,       // add eax, 3
+    0xd1, 0xc8,             // ror eax, 1
+    0xff, 0xc9,             // dec ecx
+    0x75, 0xf3,             // jnz <loop>
+};
+
+static const uint8_t x86_memcpy[] = {
+    0x8b, 0x06,             // mov eax, [esi]
+    0x89, 0x07,             // mov [edi], eax
+    0xff, 0xc9,             // dec ecx
+    0x75, 0xf8,             // jnz <loop>
+};
+
+static const uint8_t x86_branch[] = {
+    0xa8, 0x01,             // test al, 1
+    0x74, 0x00,             // jz <next>
+    0x04, 0x01,             // add al, 1
+    0xa8, 0x02,             // test al, 2
+    0x75, 0x00,             // jnz <next>
+    0xff, 0xc9,             // dec ecx
+    0x75, 0xf2,             // jnz <loop>
+};
+
+static const uint8_t x86_fp[] = {
+    0xd9, 0xe8,             // fld1
+    0xd9, 0xe8,             // fld1
+    0xd8, 0xc1,             // fadd st(0), st(1)
+    0xd8, 0xc9,             // fmul st(0), st(1)
+    0xff, 0xc9,             // dec ecx
+    0x75, 0xf8,             // jnz <loop>
+};
+
+static const uint32_t arm_int[] = {
+    0xe0811002,             // add r1, r1, r2
+    0xe0211003,             // eor r1, r1, r3
+    0xe2811003,             // add r1, r1, #3
+    0xe2500001,             // subs r0, r0, #1
+    0x1afffffa,             // bne <loop>
+};
+
+static const uint32_t arm_memcpy[] = {
+    0xe5912000,             // ldr r2, [r1]
+    0xe5842000,             // str r2, [r4]
+    0xe2500001,             // subs r0, r0, #1
+    0x1afffffb,             // bne <loop>
+};
+
+static const uint32_t arm_branch[] = {
+    0xe3110001,             // tst r1, #1
+    0x0affffff,             // beq <next>
+    0xe2811001,             // add r1, r1, #1
+    0xe3110002,             // tst r1, #2
+    0x1affffff,             // bne <next>
+    0xe2500001,             // subs r0, r0, #1
+    0x1afffff8,             // bne <loop>
+};
+
+static const uint32_t arm64_int[] = {
+    0x8b020021,             // add x1, x1, x2
+    0xca030021,             // eor x1, x1, x3
+    0x91000c21,             // add x1, x1, #3
+    0xf1000400,             // subs x0, x0, #1
+    0x54ffff81,             // b.ne <loop>
+};
+
+static const uint32_t arm64_memcpy[] = {
+    0xf9400022,             // ldr x2, [x1]
+    0xf9000082,             // str x2, [x4]
+    0xf1000400,             // subs x0, x0, #1
+    0x54ffffa1,             // b.ne <loop>
+};
+
+static const uint32_t arm64_branch[] = {
+    0xf1000c3f,             // cmp x1, #3
+    0x54000020,             // b.eq <next>
+    0x91000421,             // add x1, x1, #1
+    0xf100103f,             // cmp x1, #4
+    0x54000021,             // b.ne <next>
+    0xf1000400,             // subs x0, x0, #1
+    0x54ffff41,             // b.ne <loop>
+};
+
+// MIPS kernels fill the branch delay slots with nops, which count as
+// executed instructions
+
+static const uint32_t mips_int[] = {
+    0x00431021,             // addu $v0, $v0, $v1
+    0x00441026,             // xor $v0, $v0, $a0
+    0x24420003,             // addiu $v0, $v0, 3
+    0x24a5ffff,             // addiu $a1, $a1, -1
+    0x14a0fffb,             // bne $a1, $zero, <loop>
+    0x00000000,             // nop
+};
+
+static const uint32_t mips_memcpy[] = {
+    0x8c620000,             // lw $v0, 0($v1)
+    0xac820000,             // sw $v0, 0($a0)
+    0x24a5ffff,             // addiu $a1, $a1, -1
+    0x14a0fffc,             // bne $a1, $zero, <loop>
+    0x00000000,             // nop
+};
+
+static const uint32_t mips_branch[] = {
+    0x24420001,             // addiu $v0, $v0, 1
+    0x10400001,             // beq $v0, $zero, <skip>  (never taken)
+    0x00000000,             // nop
+    0x24420001,             // addiu $v0, $v0, 1
+    0x24a5ffff,             // addiu $a1, $a1, -1
+    0x14a0fffa,             // bne $a1, $zero, <loop>
+    0x00000000,             // nop
+};
+
+// registers holding the loop counter and the memcpy pointers, per arch
+struct regset {
+    int counter;
+    int src;
+    int dst;
+};
+
+static const struct regset x86_regs = {
+    UC_X86_REG_ECX, UC_X86_REG_ESI, UC_X86_REG_EDI
+};
+static const struct regset arm_regs = {
+    UC_ARM_REG_R0, UC_ARM_REG_R1, UC_ARM_REG_R4
+};
+static const struct regset arm64_regs = {
+    UC_ARM64_REG_X0, UC_ARM64_REG_X1, UC_ARM64_REG_X4
+};
+static const struct regset mips_regs = {
+    UC_MIPS_REG_5, UC_MIPS_REG_3, UC_MIPS_REG_4
+};
+
+struct bench {
+    const char *arch_name;
+    const char *kernel;
+    uc_arch arch;
+    uc_mode mode;
+    const void *code;
+    size_t size;
+    unsigned insns_per_iter;
+    const struct regset *regs;
+};
+
+#define B(arch_name, kernel, arch, mode, code, ipi, regs) \
+    { arch_name, kernel, arch, mode, code, sizeof(code), ipi, regs }
+
+static const struct bench benches[] = {
+    B("x86",    "int",    UC_ARCH_X86,   UC_MODE_32,     x86_int,      6, &x86_regs),
+    B("x86",    "memcpy", UC_ARCH_X86,   UC_MODE_32,     x86_memcpy,   4, &x86_regs),
+    B("x86",    "branch", UC_ARCH_X86,   UC_MODE_32,     x86_branch,   7, &x86_regs),
+    B("x86",    "fp",     UC_ARCH_X86,   UC_MODE_32,     x86_fp,       4, &x86_regs),
+    B("x86_64", "int",    UC_ARCH_X86,   UC_MODE_64,     x86_int,      6, &x86_regs),
+    B("x86_64", "memcpy", UC_ARCH_X86,   UC_MODE_64,     x86_memcpy,   4, &x86_regs),
+    B("x86_64", "branch", UC_ARCH_X86,   UC_MODE_64,     x86_branch,   7, &x86_regs),
+    B("x86_64", "fp",     UC_ARCH_X86,   UC_MODE_64,     x86_fp,       4, &x86_regs),
+    B("arm",    "int",    UC_ARCH_ARM,   UC_MODE_ARM,    arm_int,      5, &arm_regs),
+    B("arm",    "memcpy", UC_ARCH_ARM,   UC_MODE_ARM,    arm_memcpy,   4, &arm_regs),
+    B("arm",    "branch", UC_ARCH_ARM,   UC_MODE_ARM,    arm_branch,   7, &arm_regs),
+    B("arm64",  "int",    UC_ARCH_ARM64, UC_MODE_ARM,    arm64_int,    5, &arm64_regs),
+    B("arm64",  "memcpy", UC_ARCH_ARM64, UC_MODE_ARM,    arm64_memcpy, 4, &arm64_regs),
+    B("arm64",  "branch", UC_ARCH_ARM64, UC_MODE_ARM,    arm64_branch, 7, &arm64_regs),
+    B("mips",   "int",    UC_ARCH_MIPS,  UC_MODE_MIPS32, mips_int,     6, &mips_regs),
+    B("mips",   "memcpy", UC_ARCH_MIPS,  UC_MODE_MIPS32, mips_memcpy,  5, &mips_regs),
+    B("mips",   "branch", UC_ARCH_MIPS,  UC_MODE_MIPS32, mips_branch,  7, &mips_regs),
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int run_bench(const struct bench *b)
+{
+    uc_engine *uc;
+    uc_err err;
+    uint64_t counter = ITERATIONS, src = SRC_ADDR, dst = DST_ADDR;
+    size_t jit_before = 0, jit_after = 0;
+    uint64_t t0, t1, total_insns;
+    double wall_s, jit_ms, mips;
+
+    err = uc_open(b->arch, b->mode, &uc);
+    if (err != UC_ERR_OK) {
+        printf("%-7s %-7s SKIP (%s)\n", b->arch_name, b->kernel,
+                uc_strerror(err));
+        return 0;   // arch compiled out of the library
+    }
+
+    err = uc_mem_map(uc, CODE_BASE, MAP_SIZE, UC_PROT_ALL);
+    if (!err)
+        err = uc_mem_write(uc, CODE_BASE, b->code, b->size);
+    if (!err)
+        err = uc_reg_write(uc, b->regs->counter, &counter);
+    if (!err)
+        err = uc_reg_write(uc, b->regs->src, &src);
+    if (!err)
+        err = uc_reg_write(uc, b->regs->dst, &dst);
+    if (err != UC_ERR_OK) {
+        printf("%-7s %-7s FAIL setup (%s)\n", b->arch_name, b->kernel,
+                uc_strerror(err));
+        uc_close(uc);
+        return 1;
+    }
+
+    uc_query(uc, UC_QUERY_JIT_TIME_NS, &jit_before);
+    t0 = now_ns();
+    err = uc_emu_start(uc, CODE_BASE, CODE_BASE + b->size, 0, 0);
+    t1 = now_ns();
+    uc_query(uc, UC_QUERY_JIT_TIME_NS, &jit_after);
+    uc_close(uc);
+
+    if (err != UC_ERR_OK) {
+        printf("%-7s %-7s FAIL run (%s)\n", b->arch_name, b->kernel,
+                uc_strerror(err));
+        return 1;
+    }
+
+    total_insns = (uint64_t)ITERATIONS * b->insns_per_iter;
+    wall_s = (t1 - t0) / 1e9;
+    jit_ms = (jit_after - jit_before) / 1e6;
+    mips = total_insns / wall_s / 1e6;
+
+    printf("%-7s %-7s %8.1f guest-MIPS   wall %8.1f ms   jit %6.2f ms (%.2f%%)\n",
+            b->arch_name, b->kernel, mips, wall_s * 1e3, jit_ms,
+            100.0 * jit_ms / (wall_s * 1e3));
+    return 0;
+}
+
+int main(void)
+{
+    unsigned i;
+    int failures = 0;
+
+    printf("%u iterations per kernel\n", (unsigned)ITERATIONS);
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++)
+        failures += run_bench(&benches[i]);
+
+    return failures;
+}
@@ -0,0 +1,207 @@
+// Memory-footprint regression harness, run with `make footprint` from
+// the top level. LEAK_VALGRIND documents the known one-off leaks; this
+// enforces that the footprint of steady-state usage stays flat, the way
+// multi-day worker processes exercise it:
+//
+//   open_close   - uc_open()/uc_close() cycles must not grow RSS beyond
+//                  allocator noise (every engine allocation is on the
+//                  uc_close() free list)
+//   map_churn    - map/execute/unmap rounds on one long-lived engine
+//                  must not grow the page descriptor tree or the dirty
+//                  bitmaps (page_tree_reclaim() in translate-all.c and
+//                  the bitmap sizing in exec.c have both regressed here
+//                  before), nor RSS
+//
+// Each check warms up first so lazily built caches (type tables, the
+// translation cache, malloc arenas) do not count as growth, then runs
+// the workload and compares against a threshold. Output is one line per
+// check: name,baseline,after,limit,PASS|FAIL. Exit status is the number
+// of failed checks, so this can gate CI directly. Internal byte counts
+// come from uc_query(UC_QUERY_MEM_*); RSS comes from /proc/self/status
+// and those checks are skipped where that does not exist. Running the
+// whole binary under valgrind or massif still works for drilling into a
+// failure, but is not required.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unicorn/unicorn.h>
+
+#define CODE_BASE       0x1000000
+#define DATA_BASE       0x2000000
+
+#define OPEN_WARMUP     20
+#define OPEN_CYCLES     200
+#define OPEN_RSS_LIMIT  (2 * 1024 * 1024)   // bytes over OPEN_CYCLES
+
+#define CHURN_WARMUP    100
+#define CHURN_ROUNDS    2000
+#define CHURN_RSS_LIMIT (2 * 1024 * 1024)   // bytes over CHURN_ROUNDS
+// the reclaimed tree may keep the subtree of the hottest page alive, but
+// must not keep one per round
+#define CHURN_PAGE_TABLE_LIMIT  (256 * 1024)
+#define CHURN_DIRTY_LIMIT       (64 * 1024)
+
+// dec ecx; jnz <loop>
+static const uint8_t loop_code[] = {
+    0xff, 0xc9, 0x75, 0xfc,
+};
+
+static int failures;
+
+// current VmRSS in bytes, or 0 when /proc is not available
+static uint64_t rss_bytes(void)
+{
+    char line[256];
+    uint64_t kb = 0;
+    FILE *f;
+
+    f = fopen("/proc/self/status", "r");
+    if (f == NULL)
+        return 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "VmRSS: %llu kB", (unsigned long long *)&kb) == 1)
+            break;
+    }
+    fclose(f);
+    return kb * 1024;
+}
+
+static void check(const char *name, uint64_t baseline, uint64_t after,
+        uint64_t limit)
+{
+    uint64_t growth = after > baseline ? after - baseline : 0;
+    int fail = growth > limit;
+
+    printf("%s,%llu,%llu,%llu,%s\n", name, (unsigned long long)baseline,
+            (unsigned long long)after, (unsigned long long)limit,
+            fail ? "FAIL" : "PASS");
+    failures += fail;
+}
+
+static uc_err run_round(uc_engine *uc, uint64_t code_base, uint64_t data_base)
+{
+    uint64_t counter = 64;
+    uint8_t byte = 1;
+    uc_err err;
+
+    err = uc_mem_map(uc, code_base, 0x1000, UC_PROT_ALL);
+    if (!err)
+        err = uc_mem_map(uc, data_base, 0x1000, UC_PROT_ALL);
+    if (!err)
+        err = uc_mem_write(uc, code_base, loop_code, sizeof(loop_code));
+    if (!err)
+        err = uc_reg_write(uc, UC_X86_REG_ECX, &counter);
+    if (!err)
+        err = uc_emu_start(uc, code_base, code_base + sizeof(loop_code),
+                0, 0);
+    // dirty the data page too, so its bitmap bits and descriptors exist
+    if (!err)
+        err = uc_mem_write(uc, data_base, &byte, 1);
+    if (!err)
+        err = uc_mem_unmap(uc, code_base, 0x1000);
+    if (!err)
+        err = uc_mem_unmap(uc, data_base, 0x1000);
+    return err;
+}
+
+static int bench_open_close(void)
+{
+    uint64_t before, after;
+    uc_engine *uc;
+    uc_err err;
+    int i;
+
+    for (i = 0; i < OPEN_WARMUP; i++) {
+        err = uc_open(UC_ARCH_X86, UC_MODE_32, &uc);
+        if (err != UC_ERR_OK) {
+            printf("# open_close failed: %s\n", uc_strerror(err));
+            return 1;
+        }
+        uc_close(uc);
+    }
+
+    before = rss_bytes();
+    for (i = 0; i < OPEN_CYCLES; i++) {
+        err = uc_open(UC_ARCH_X86, UC_MODE_32, &uc);
+        if (err != UC_ERR_OK) {
+            printf("# open_close failed: %s\n", uc_strerror(err));
+            return 1;
+        }
+        uc_close(uc);
+    }
+    after = rss_bytes();
+
+    if (before == 0)
+        printf("# open_close_rss skipped: no /proc/self/status\n");
+    else
+        check("open_close_rss", before, after, OPEN_RSS_LIMIT);
+    return 0;
+}
+
+static int bench_map_churn(void)
+{
+    uint64_t rss_before, rss_after;
+    size_t pt_before, pt_after, dirty_before, dirty_after;
+    uc_engine *uc;
+    uc_err err;
+    int i;
+
+    err = uc_open(UC_ARCH_X86, UC_MODE_32, &uc);
+    if (err != UC_ERR_OK) {
+        printf("# map_churn failed: %s\n", uc_strerror(err));
+        return 1;
+    }
+
+    // spread rounds over distinct addresses so recycled ram offsets, not
+    // one hot page, carry the descriptor load - the production pattern
+    // that grew the tree
+    for (i = 0; i < CHURN_WARMUP && !err; i++)
+        err = run_round(uc, CODE_BASE + (uint64_t)(i % 64) * 0x10000,
+                DATA_BASE + (uint64_t)(i % 64) * 0x10000);
+
+    rss_before = rss_bytes();
+    if (!err)
+        err = uc_query(uc, UC_QUERY_MEM_PAGE_TABLES, &pt_before);
+    if (!err)
+        err = uc_query(uc, UC_QUERY_MEM_DIRTY_BITMAPS, &dirty_before);
+
+    for (i = 0; i < CHURN_ROUNDS && !err; i++)
+        err = run_round(uc, CODE_BASE + (uint64_t)(i % 64) * 0x10000,
+                DATA_BASE + (uint64_t)(i % 64) * 0x10000);
+
+    if (!err)
+        err = uc_query(uc, UC_QUERY_MEM_PAGE_TABLES, &pt_after);
+    if (!err)
+        err = uc_query(uc, UC_QUERY_MEM_DIRTY_BITMAPS, &dirty_after);
+    rss_after = rss_bytes();
+
+    if (err != UC_ERR_OK) {
+        printf("# map_churn failed: %s\n", uc_strerror(err));
+        uc_close(uc);
+        return 1;
+    }
+
+    check("map_churn_page_tables", pt_before, pt_after,
+            CHURN_PAGE_TABLE_LIMIT);
+    check("map_churn_dirty_bitmaps", dirty_before, dirty_after,
+            CHURN_DIRTY_LIMIT);
+    if (rss_before == 0)
+        printf("# map_churn_rss skipped: no /proc/self/status\n");
+    else
+        check("map_churn_rss", rss_before, rss_after, CHURN_RSS_LIMIT);
+
+    uc_close(uc);
+    return 0;
+}
+
+int main(void)
+{
+    printf("# name,baseline_bytes,after_bytes,limit_bytes,result\n");
+    failures += bench_open_close();
+    failures += bench_map_churn();
+
+    return failures;
+}
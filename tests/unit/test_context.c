@@ -0,0 +1,68 @@
+#include "unicorn_test.h"
+
+#define OK(x)   uc_assert_success(x)
+
+/* Make sure a saved context can be restored after register state changed */
+static void test_context_save_restore(void **state)
+{
+    uc_engine *uc;
+    uc_context *context;
+    uint64_t rax;
+
+    OK(uc_open(UC_ARCH_X86, UC_MODE_64, &uc));
+
+    rax = 0x1234;
+    OK(uc_reg_write(uc, UC_X86_REG_RAX, &rax));
+
+    OK(uc_context_alloc(uc, &context));
+    OK(uc_context_save(uc, context));
+
+    /* clobber the register... */
+    rax = 0xffff;
+    OK(uc_reg_write(uc, UC_X86_REG_RAX, &rax));
+
+    /* ...then roll it back */
+    OK(uc_context_restore(uc, context));
+
+    OK(uc_reg_read(uc, UC_X86_REG_RAX, &rax));
+    assert_int_equal(rax, 0x1234);
+
+    OK(uc_context_free(context));
+    OK(uc_close(uc));
+}
+
+/* Contexts must outlive the engine that saved them */
+static void test_context_outlives_engine(void **state)
+{
+    uc_engine *uc;
+    uc_context *context;
+    uint32_t eax;
+
+    OK(uc_open(UC_ARCH_X86, UC_MODE_32, &uc));
+
+    eax = 0xdeadbeef;
+    OK(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+
+    OK(uc_context_alloc(uc, &context));
+    OK(uc_context_save(uc, context));
+    OK(uc_close(uc));
+
+    /* restore into a brand new engine of the same arch/mode */
+    OK(uc_open(UC_ARCH_X86, UC_MODE_32, &uc));
+    OK(uc_context_restore(uc, context));
+
+    OK(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 0xdeadbeef);
+
+    OK(uc_context_free(context));
+    OK(uc_close(uc));
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_context_save_restore),
+        cmocka_unit_test(test_context_outlives_engine),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
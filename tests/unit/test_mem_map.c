@@ -6,7 +6,9 @@
  */
 #include "unicorn_test.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>     /* getpid/unlink, for test_perfmap */
 
 /* Called before every test to set up a new instance */
 static int setup(void **state)
@@ -119,6 +121,883 @@ static void test_rw_across_boundaries(void **state)
     assert_memory_equal(buf, "test", 4);
 }
 
+/**
+ * Verify the scatter-gather variants against the plain read/write API
+ */
+static void test_rw_vectored(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t buf1[4], buf2[6];
+
+    uc_assert_success(uc_mem_map(uc, 0, 0x2000, 0));
+
+    uc_mem_vec wvecs[] = {
+        { 0x100,  "abcd",   4 },
+        { 0x1000, "efghij", 6 },
+    };
+    uc_assert_success(uc_mem_write_v(uc, wvecs, 2));
+
+    uc_mem_vec rvecs[] = {
+        { 0x100,  buf1, sizeof(buf1) },
+        { 0x1000, buf2, sizeof(buf2) },
+    };
+    uc_assert_success(uc_mem_read_v(uc, rvecs, 2));
+
+    assert_memory_equal(buf1, "abcd", 4);
+    assert_memory_equal(buf2, "efghij", 6);
+
+    /* An unmapped entry must fail the whole call */
+    uc_mem_vec bad[] = {
+        { 0x4000, buf1, sizeof(buf1) },
+    };
+    uc_assert_fail(uc_mem_read_v(uc, bad, 1));
+}
+
+/**
+ * Verify that mappings made inside a batch become visible at commit
+ */
+static void test_map_batch(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t buf[4];
+
+    /* A commit with no open batch must fail */
+    uc_assert_err(UC_ERR_ARG, uc_mem_batch_commit(uc));
+
+    uc_assert_success(uc_mem_batch_begin(uc));
+    uc_assert_success(uc_mem_map(uc, 0,      0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_map(uc, 0x1000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_batch_commit(uc));
+
+    /* Both regions must be usable after the commit */
+    uc_assert_success(uc_mem_write(uc, 0x1000 - 2, "test", 4));
+    uc_assert_success(uc_mem_read(uc, 0x1000 - 2, buf, sizeof(buf)));
+    assert_memory_equal(buf, "test", 4);
+}
+
+/**
+ * Verify that protecting part of a region neither loses data nor splits
+ * the region
+ */
+static void test_protect_subrange(void **state)
+{
+    uc_engine *uc = *state;
+    uc_mem_region *regions;
+    uint32_t region_count;
+    uint8_t pattern[0x4000];
+    uint8_t buf[0x4000];
+    size_t i;
+
+    for (i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)i;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x4000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, pattern, sizeof(pattern)));
+
+    /* Make one page in the middle read-only */
+    uc_assert_success(uc_mem_protect(uc, 0x101000, 0x1000, UC_PROT_READ));
+
+    /* The contents must be untouched and the region must not be split */
+    uc_assert_success(uc_mem_read(uc, 0x100000, buf, sizeof(buf)));
+    assert_memory_equal(buf, pattern, sizeof(pattern));
+
+    uc_assert_success(uc_mem_regions(uc, &regions, &region_count));
+    assert_int_equal(region_count, 1);
+    free(regions);
+
+    /* Restoring the whole region goes back to uniform permissions */
+    uc_assert_success(uc_mem_protect(uc, 0x100000, 0x4000, UC_PROT_ALL));
+}
+
+static void test_map_hugepage(void **state)
+{
+    uc_engine *uc = *state;
+    uc_mem_region *regions;
+    uint32_t region_count;
+    uint8_t byte = 0xcc;
+
+    /* The hint must not change observable behaviour, whether or not the
+       host actually provides huge pages */
+    uc_assert_success(uc_mem_map(uc, 0x400000, 0x400000,
+                                 UC_PROT_ALL | UC_MEM_HUGEPAGE));
+    uc_assert_success(uc_mem_write(uc, 0x400000, &byte, 1));
+    uc_assert_success(uc_mem_read(uc, 0x400000, &byte, 1));
+    assert_int_equal(byte, 0xcc);
+
+    /* The hint is not reported back as a permission */
+    uc_assert_success(uc_mem_regions(uc, &regions, &region_count));
+    assert_int_equal(region_count, 1);
+    assert_int_equal(regions[0].perms, UC_PROT_ALL);
+    free(regions);
+}
+
+static void test_map_mergeable(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t byte = 0x5a;
+
+    /* Like UC_MEM_HUGEPAGE, a pure backing hint: contents and behaviour
+       are unchanged whether or not the host runs KSM */
+    uc_assert_success(uc_mem_map(uc, 0x200000, 0x10000,
+                                 UC_PROT_ALL | UC_MEM_MERGEABLE));
+    uc_assert_success(uc_mem_write(uc, 0x200000, &byte, 1));
+    byte = 0;
+    uc_assert_success(uc_mem_read(uc, 0x200000, &byte, 1));
+    assert_int_equal(byte, 0x5a);
+}
+
+static uint64_t mmio_read_cb(uc_engine *uc, uint64_t offset, unsigned size,
+        void *user_data)
+{
+    *(uint64_t*)user_data = offset;
+    return 0x41424344;
+}
+
+static void mmio_write_cb(uc_engine *uc, uint64_t offset, unsigned size,
+        uint64_t value, void *user_data)
+{
+    *(uint64_t*)user_data = value;
+}
+
+static void test_mmio(void **state)
+{
+    uc_engine *uc = *state;
+    uint64_t last_read_offset = -1, last_written = -1;
+    uint32_t word = 0;
+
+    uc_assert_success(uc_mmio_map(uc, 0x10000, 0x2000,
+                mmio_read_cb, &last_read_offset,
+                mmio_write_cb, &last_written));
+
+    /* reads dispatch to the read callback, with region-relative offsets */
+    uc_assert_success(uc_mem_read(uc, 0x10010, &word, sizeof(word)));
+    assert_int_equal(word, 0x41424344);
+    assert_int_equal(last_read_offset, 0x10);
+
+    /* writes dispatch to the write callback and never touch RAM */
+    word = 0xdeadbeef;
+    uc_assert_success(uc_mem_write(uc, 0x10020, &word, sizeof(word)));
+    assert_int_equal(last_written, 0xdeadbeef);
+
+    /* MMIO regions cannot be split or re-protected... */
+    uc_assert_err(UC_ERR_NOMEM, uc_mem_unmap(uc, 0x10000, 0x1000));
+    uc_assert_err(UC_ERR_ARG, uc_mem_protect(uc, 0x10000, 0x2000, UC_PROT_READ));
+
+    /* ...but unmapping the whole region works */
+    uc_assert_success(uc_mem_unmap(uc, 0x10000, 0x2000));
+}
+
+static void test_tlb_resize(void **state)
+{
+    uc_engine *uc = *state;
+    size_t size, resized;
+    uint8_t byte = 0xcc;
+
+    uc_assert_success(uc_query(uc, UC_QUERY_TLB_SIZE, &size));
+    assert_true(size >= 2);
+
+    /* not a power of two */
+    uc_assert_err(UC_ERR_ARG, uc_tlb_resize(uc, (uint32_t)size - 1));
+    /* beyond the compile-time maximum */
+    uc_assert_err(UC_ERR_ARG, uc_tlb_resize(uc, (uint32_t)size * 2));
+
+    uc_assert_success(uc_tlb_resize(uc, (uint32_t)size / 2));
+    uc_assert_success(uc_query(uc, UC_QUERY_TLB_SIZE, &resized));
+    assert_int_equal(resized, size / 2);
+
+    /* memory still works with the smaller TLB */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, &byte, 1));
+    byte = 0;
+    uc_assert_success(uc_mem_read(uc, 0x100000, &byte, 1));
+    assert_int_equal(byte, 0xcc);
+}
+
+static void test_tcg_buffer_resize(void **state)
+{
+    uc_engine *uc = *state;
+    size_t size, resized;
+    uint8_t byte = 0xcc;
+
+    uc_assert_success(uc_query(uc, UC_QUERY_TCG_BUFFER_SIZE, &size));
+    assert_true(size >= 1024 * 1024);
+
+    /* below the supported minimum */
+    uc_assert_err(UC_ERR_ARG, uc_tcg_buffer_resize(uc, 4096));
+
+    uc_assert_success(uc_tcg_buffer_resize(uc, 2 * 1024 * 1024));
+    uc_assert_success(uc_query(uc, UC_QUERY_TCG_BUFFER_SIZE, &resized));
+    assert_int_equal(resized, 2 * 1024 * 1024);
+
+    /* the engine still works with the smaller cache */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, &byte, 1));
+    byte = 0;
+    uc_assert_success(uc_mem_read(uc, 0x100000, &byte, 1));
+    assert_int_equal(byte, 0xcc);
+}
+
+static void test_tb_cache(void **state)
+{
+    uc_engine *uc = *state;
+    const char *path = "./test_tb_cache.bin";
+    uint8_t byte = 0xcc;
+    FILE *f;
+
+    uc_assert_err(UC_ERR_ARG, uc_tb_cache_save(uc, NULL));
+    uc_assert_err(UC_ERR_ARG, uc_tb_cache_load(uc, NULL));
+
+    /* a cache saved by this engine loads back into it while it is fresh */
+    uc_assert_success(uc_tb_cache_save(uc, path));
+    uc_assert_success(uc_tb_cache_load(uc, path));
+
+    /* a damaged file is rejected cleanly */
+    f = fopen(path, "wb");
+    assert_non_null(f);
+    fwrite("junk", 1, 4, f);
+    fclose(f);
+    uc_assert_err(UC_ERR_RESOURCE, uc_tb_cache_load(uc, path));
+    remove(path);
+
+    /* and a missing one too; the engine keeps working either way */
+    uc_assert_err(UC_ERR_RESOURCE, uc_tb_cache_load(uc, path));
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, &byte, 1));
+    byte = 0;
+    uc_assert_success(uc_mem_read(uc, 0x100000, &byte, 1));
+    assert_int_equal(byte, 0xcc);
+}
+
+static void test_translate(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t nops[16];
+
+    memset(nops, 0x90, sizeof(nops));   /* x86 NOP */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, nops, sizeof(nops)));
+
+    /* mapped executable code translates; repeating is a no-op */
+    uc_assert_success(uc_translate(uc, 0x100000, sizeof(nops)));
+    uc_assert_success(uc_translate(uc, 0x100000, sizeof(nops)));
+    uc_assert_success(uc_translate(uc, 0x100000, 0));
+
+    /* nothing to translate in unmapped memory */
+    uc_assert_err(UC_ERR_FETCH_UNMAPPED, uc_translate(uc, 0x200000, 0x10));
+}
+
+static void test_translate_readahead(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t nops[16];
+
+    uc_assert_success(uc_translate_readahead(uc, 4));
+    uc_assert_success(uc_translate_readahead(uc, UC_TRANSLATE_READAHEAD_MAX));
+    uc_assert_err(UC_ERR_ARG,
+            uc_translate_readahead(uc, UC_TRANSLATE_READAHEAD_MAX + 1));
+
+    /* translation still behaves with read-ahead enabled */
+    memset(nops, 0x90, sizeof(nops));   /* x86 NOP */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, nops, sizeof(nops)));
+    uc_assert_success(uc_translate(uc, 0x100000, 1));
+
+    uc_assert_success(uc_translate_readahead(uc, 0));
+}
+
+static void test_jmp_cache_resize(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t nops[16];
+    size_t entries;
+
+    uc_assert_success(uc_query(uc, UC_QUERY_JMP_CACHE_SIZE, &entries));
+    assert_int_equal(entries, 4096);
+
+    uc_assert_success(uc_jmp_cache_resize(uc, 16384));
+    uc_assert_success(uc_query(uc, UC_QUERY_JMP_CACHE_SIZE, &entries));
+    assert_int_equal(entries, 16384);
+
+    /* not a power of two, too small, too large */
+    uc_assert_err(UC_ERR_ARG, uc_jmp_cache_resize(uc, 1000));
+    uc_assert_err(UC_ERR_ARG, uc_jmp_cache_resize(uc, 8));
+    uc_assert_err(UC_ERR_ARG, uc_jmp_cache_resize(uc, 1 << 20));
+
+    /* the engine still translates with the bigger cache */
+    memset(nops, 0x90, sizeof(nops));   /* x86 NOP */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, nops, sizeof(nops)));
+    uc_assert_success(uc_translate(uc, 0x100000, sizeof(nops)));
+}
+
+static void test_query_tb_stats(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t nops[16];
+    size_t count, used;
+
+    /* a fresh engine has an empty cache */
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_COUNT, &count));
+    assert_int_equal(count, 0);
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_BUFFER_USED, &used));
+    assert_int_equal(used, 0);
+
+    /* translating something makes both counters move */
+    memset(nops, 0x90, sizeof(nops));   /* x86 NOP */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, nops, sizeof(nops)));
+    uc_assert_success(uc_translate(uc, 0x100000, sizeof(nops)));
+
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_COUNT, &count));
+    assert_true(count >= 1);
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_BUFFER_USED, &used));
+    assert_true(used > 0);
+
+    /* the event counters exist even if nothing has happened yet */
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_FLUSH_COUNT, &count));
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_INVALIDATE_COUNT, &count));
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_EVICT_COUNT, &count));
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_LOOKUP_COUNT, &count));
+    uc_assert_success(uc_query(uc, UC_QUERY_TB_SLOW_LOOKUP_COUNT, &count));
+}
+
+static void noop_code_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+}
+
+static void test_sample_profiler(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t loop[4] = { 0xff, 0xc9, 0x75, 0xfc }; /* dec ecx; jnz <loop> */
+    uint64_t counter = 10000;
+    uc_sample_entry entries[4];
+    uint32_t count;
+
+    /* interval 0 is invalid, querying before enabling too */
+    uc_assert_err(UC_ERR_ARG, uc_sample_enable(uc, 0));
+    count = 4;
+    uc_assert_err(UC_ERR_ARG, uc_sample_top(uc, entries, &count));
+
+    uc_assert_success(uc_sample_enable(uc, 1));
+
+    /* nothing sampled yet */
+    count = 4;
+    uc_assert_success(uc_sample_top(uc, entries, &count));
+    assert_int_equal(count, 0);
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, loop, sizeof(loop)));
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_ECX, &counter));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(loop),
+                0, 0));
+
+    /* the loop dominates the run, so its block tops the histogram */
+    count = 4;
+    uc_assert_success(uc_sample_top(uc, entries, &count));
+    assert_true(count >= 1);
+    assert_int_equal(entries[0].address, 0x100000);
+    assert_true(entries[0].count > 0);
+
+    uc_assert_success(uc_sample_disable(uc));
+    count = 4;
+    uc_assert_err(UC_ERR_ARG, uc_sample_top(uc, entries, &count));
+}
+
+static void test_query_mem_stats(void **state)
+{
+    uc_engine *uc = *state;
+    size_t bytes, ram, hooks;
+
+    /* the fixed-cost pools exist from uc_open() on */
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_CODE_BUFFER, &bytes));
+    assert_true(bytes > 0);
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_TB_METADATA, &bytes));
+    assert_true(bytes > 0);
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_TLB, &bytes));
+    assert_true(bytes > 0);
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_PAGE_TABLES, &bytes));
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_DIRTY_BITMAPS, &bytes));
+
+    /* guest RAM tracks mappings */
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_GUEST_RAM, &ram));
+    assert_int_equal(ram, 0);
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x4000, UC_PROT_ALL));
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_GUEST_RAM, &ram));
+    assert_int_equal(ram, 0x4000);
+
+    /* hook bookkeeping tracks registrations */
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_HOOKS, &hooks));
+    assert_int_equal(hooks, 0);
+    {
+        uc_hook hh;
+        uc_assert_success(uc_hook_add(uc, &hh, UC_HOOK_CODE,
+                    noop_code_hook, NULL, (uint64_t)1, (uint64_t)0));
+        uc_assert_success(uc_query(uc, UC_QUERY_MEM_HOOKS, &hooks));
+        assert_true(hooks > 0);
+    }
+}
+
+static void test_emu_timeout(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t loop[2] = { 0xeb, 0xfe };   /* x86: jmp $ */
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, loop, sizeof(loop)));
+
+    /* an infinite loop chains to itself, so returning here at all proves
+       the deadline can interrupt chained execution; hitting the timeout
+       is not an error */
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(loop),
+                10 * 1000, 0));
+
+    /* a second timed run reuses the timer thread */
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(loop),
+                10 * 1000, 0));
+}
+
+static void test_crosspage_chain(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t nops[24];
+    uint8_t jmp[2] = { 0xeb, 0xe6 };    /* x86: jmp -26 -> 0x100ff0 */
+    uint8_t nop = 0x90;
+    int eip;
+
+    /* a loop body crossing a page boundary: the whole loop is one TB
+       spanning two pages that chains back to itself */
+    memset(nops, 0x90, sizeof(nops));
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x2000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100ff0, nops, sizeof(nops)));
+    uc_assert_success(uc_mem_write(uc, 0x101008, jmp, sizeof(jmp)));
+
+    uc_assert_success(uc_emu_start(uc, 0x100ff0, 0x200000, 0, 1000));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EIP, &eip));
+    assert_true(eip >= 0x100ff0 && eip <= 0x10100a);
+
+    /* rewriting the second page invalidates the spanning TB and must
+       drop the recorded cross-page link with it */
+    uc_assert_success(uc_mem_write(uc, 0x101000, &nop, 1));
+    uc_assert_success(uc_emu_start(uc, 0x100ff0, 0x200000, 0, 500));
+
+    /* a protection change flushes the TLB, which unchains by page */
+    uc_assert_success(uc_mem_protect(uc, 0x101000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_emu_start(uc, 0x100ff0, 0x200000, 0, 500));
+}
+
+static void test_superblock(void **state)
+{
+    uc_engine *uc = *state;
+    /*  mov ecx, 100
+     *  loop: dec ecx
+     *  jmp over          ; unconditional, followed by the superblock
+     *  nop; nop
+     *  over: jnz loop */
+    uint8_t code[] = {
+        0xb9, 0x64, 0x00, 0x00, 0x00, 0x49, 0xeb, 0x02,
+        0x90, 0x90, 0x75, 0xf9,
+    };
+    int ecx;
+
+    uc_assert_success(uc_superblock_enable(uc, 4));
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    /* the loop body crosses the threshold and is retranslated mid-run;
+       results must not change */
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_ECX, &ecx));
+    assert_int_equal(ecx, 0);
+
+    /* a second run starts from flushed translations and re-forms them */
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_ECX, &ecx));
+    assert_int_equal(ecx, 0);
+
+    uc_assert_success(uc_superblock_enable(uc, 0));
+}
+
+static void test_adc_chain(void **state)
+{
+    uc_engine *uc = *state;
+    /*  mov ecx, 50
+     *  xor eax, eax
+     *  xor ebx, ebx
+     *  loop: add eax, 0x9e3779b9
+     *  adc ebx, 0
+     *  dec ecx
+     *  jnz loop */
+    uint8_t code[] = {
+        0xb9, 0x32, 0x00, 0x00, 0x00, 0x31, 0xc0, 0x31, 0xdb,
+        0x05, 0xb9, 0x79, 0x37, 0x9e, 0x83, 0xd3, 0x00, 0x49,
+        0x75, 0xf5,
+    };
+    uint64_t sum = 50ULL * 0x9e3779b9ULL;
+    int eax, ebx;
+
+    /* a flag-heavy carry chain: add/adc/dec force the condition code
+       state through memory repeatedly, which the optimizer now prunes;
+       the architectural result must be exact */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EBX, &ebx));
+    assert_int_equal((uint32_t)eax, (uint32_t)sum);
+    assert_int_equal((uint32_t)ebx, (uint32_t)(sum >> 32));
+}
+
+static void test_perfmap(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t code[] = { 0x41, 0x41 };    /* inc ecx; inc ecx */
+    char path[64];
+    char line[128];
+    FILE *f;
+
+    uc_assert_success(uc_perfmap_enable(uc));
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+
+    uc_assert_success(uc_perfmap_disable(uc));
+
+    /* the run translated at least one block, so the map must contain an
+       entry labeled with its guest pc */
+    snprintf(path, sizeof(path), "/tmp/perf-%u.map", (unsigned)getpid());
+    f = fopen(path, "r");
+    assert_non_null(f);
+    assert_non_null(fgets(line, sizeof(line), f));
+    assert_non_null(strstr(line, "tb-0x100000"));
+    fclose(f);
+    unlink(path);
+}
+
+static void test_sse_arith(void **state)
+{
+    uc_engine *uc = *state;
+    /*  movdqu xmm0, [0x100200]
+     *  movdqu xmm1, [0x100210]
+     *  pmullw xmm1, xmm0
+     *  paddb xmm0, [0x100210]
+     *  movdqu [0x100220], xmm0
+     *  movdqu [0x100230], xmm1 */
+    uint8_t code[] = {
+        0xf3, 0x0f, 0x6f, 0x05, 0x00, 0x02, 0x10, 0x00,
+        0xf3, 0x0f, 0x6f, 0x0d, 0x10, 0x02, 0x10, 0x00,
+        0x66, 0x0f, 0xd5, 0xc8,
+        0x66, 0x0f, 0xfc, 0x05, 0x10, 0x02, 0x10, 0x00,
+        0xf3, 0x0f, 0x7f, 0x05, 0x20, 0x02, 0x10, 0x00,
+        0xf3, 0x0f, 0x7f, 0x0d, 0x30, 0x02, 0x10, 0x00,
+    };
+    uint8_t a[16], b[16], sum[16], prod[16];
+    uint16_t aw, bw, pw;
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        a[i] = (uint8_t)(200 + i * 3);
+        b[i] = (uint8_t)(100 + i * 5);
+    }
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_mem_write(uc, 0x100200, a, sizeof(a)));
+    uc_assert_success(uc_mem_write(uc, 0x100210, b, sizeof(b)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+
+    uc_assert_success(uc_mem_read(uc, 0x100220, sum, sizeof(sum)));
+    uc_assert_success(uc_mem_read(uc, 0x100230, prod, sizeof(prod)));
+    for (i = 0; i < 16; i++) {
+        assert_int_equal(sum[i], (uint8_t)(a[i] + b[i]));
+    }
+    for (i = 0; i < 8; i++) {
+        memcpy(&aw, &a[i * 2], 2);
+        memcpy(&bw, &b[i * 2], 2);
+        pw = (uint16_t)(aw * bw);
+        assert_memory_equal(&prod[i * 2], &pw, 2);
+    }
+}
+
+static void test_logic_jcc(void **state)
+{
+    uc_engine *uc = *state;
+    /* for eax in {-5, 0, 7}: test eax,eax then count the fall-throughs of
+     * jle/jl and ja; the relational jumps after a logic op now translate
+     * to plain compares against zero instead of a flags helper call */
+    uint8_t code[] = {
+        0x31, 0xdb,                                     /* xor ebx, ebx */
+        0xb8, 0xfb, 0xff, 0xff, 0xff,                   /* mov eax, -5 */
+        0x85, 0xc0, 0x7e, 0x01, 0x43,                   /* test/jle/inc ebx */
+        0x85, 0xc0, 0x77, 0x01, 0x43,                   /* test/ja/inc ebx */
+        0xb8, 0x00, 0x00, 0x00, 0x00,                   /* mov eax, 0 */
+        0x85, 0xc0, 0x7e, 0x01, 0x43,                   /* test/jle/inc ebx */
+        0x85, 0xc0, 0x77, 0x01, 0x43,                   /* test/ja/inc ebx */
+        0xb8, 0x07, 0x00, 0x00, 0x00,                   /* mov eax, 7 */
+        0x85, 0xc0, 0x7c, 0x01, 0x43,                   /* test/jl/inc ebx */
+        0x85, 0xc0, 0x77, 0x01, 0x43,                   /* test/ja/inc ebx */
+    };
+    int ebx;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+
+    /* -5: jle and ja both taken; 0: only ja falls through;
+       7: only jl falls through */
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EBX, &ebx));
+    assert_int_equal(ebx, 2);
+}
+
+static void test_tb_insn_limit(void **state)
+{
+    uc_engine *uc = *state;
+    /*  inc eax (x8) */
+    uint8_t code[] = {
+        0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    };
+    int eax = 0;
+
+    /* force single-instruction blocks; the straight-line run must still
+       execute every instruction exactly once */
+    uc_assert_success(uc_tb_insn_limit(uc, 1));
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 8);
+
+    uc_assert_success(uc_tb_insn_limit(uc, 0));
+}
+
+static void test_emu_continue(void **state)
+{
+    uc_engine *uc = *state;
+    /*  inc eax (x4) */
+    uint8_t code[] = { 0x40, 0x40, 0x40, 0x40 };
+    int eax = 0;
+    uint32_t eip = 0;
+
+    /* nothing to continue before the first uc_emu_start() */
+    assert_int_equal(uc_emu_continue(uc), UC_ERR_ARG);
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+
+    /* count budget of 2 stops the run halfway through */
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 2));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 2);
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EIP, &eip));
+    assert_int_equal(eip, 0x100002);
+
+    /* pick up at the stop address and run to the original end address */
+    uc_assert_success(uc_emu_continue(uc));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 4);
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EIP, &eip));
+    assert_int_equal(eip, 0x100000 + sizeof(code));
+}
+
+static void test_icount_timeout(void **state)
+{
+    uc_engine *uc = *state;
+    /*  inc eax (x8) */
+    uint8_t code[] = {
+        0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    };
+    int eax = 0;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+
+    /* the timeout counts instructions now, so the stop point is exact */
+    uc_assert_success(uc_icount_timeout(uc, true));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                3, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 3);
+
+    /* an explicit smaller count still wins over the timeout budget */
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                6, 2));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 5);
+
+    uc_assert_success(uc_icount_timeout(uc, false));
+}
+
+static void test_reset(void **state)
+{
+    uc_engine *uc = *state;
+    /*  inc eax (x4) */
+    uint8_t code[] = { 0x40, 0x40, 0x40, 0x40 };
+    uint8_t byte;
+    int eax = 0;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 4);
+
+    uc_assert_success(uc_reset(uc));
+
+    /* registers are back to power-on values and the mapping is gone */
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 0);
+    uc_assert_err(UC_ERR_READ_UNMAPPED, uc_mem_read(uc, 0x100000, &byte, 1));
+
+    /* the recycled engine emulates like a fresh one */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + 2, 0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 2);
+}
+
+static void test_shared_type_graph(void **state)
+{
+    uc_engine *uc = *state;
+    uc_engine *uc2;
+    /*  inc eax (x2) */
+    uint8_t code[] = { 0x40, 0x40 };
+    int eax = 0;
+
+    /* a second engine of the same arch attaches to the published QOM
+       type graph instead of rebuilding it; it must emulate like the
+       first one */
+    uc_assert_success(uc_open(UC_ARCH_X86, UC_MODE_32, &uc2));
+    uc_assert_success(uc_mem_map(uc2, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc2, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc2, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_reg_read(uc2, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 2);
+    uc_assert_success(uc_close(uc2));
+
+    /* the shared graph survives the close: the remaining engine still
+       works, and so does yet another open afterwards */
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 2);
+
+    uc_assert_success(uc_open(UC_ARCH_X86, UC_MODE_32, &uc2));
+    uc_assert_success(uc_close(uc2));
+}
+
+static void test_bare_mode(void **state)
+{
+    uc_engine *uc2;
+    /*  inc eax (x2) */
+    uint8_t code[] = { 0x40, 0x40 };
+    int eax = 0;
+
+    /* the bare profile skips the APIC but emulates plain code the same */
+    uc_assert_success(uc_open(UC_ARCH_X86, UC_MODE_32 | UC_MODE_BARE, &uc2));
+    uc_assert_success(uc_mem_map(uc2, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc2, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc2, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_reg_read(uc2, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 2);
+    uc_assert_success(uc_close(uc2));
+}
+
+static void test_small_mode(void **state)
+{
+    uc_engine *uc2;
+    /*  inc eax (x2) */
+    uint8_t code[] = { 0x40, 0x40 };
+    int eax = 0;
+    size_t result = 0;
+
+    /* the small profile trims the per-instance caches but runs the same */
+    uc_assert_success(uc_open(UC_ARCH_X86, UC_MODE_32 | UC_MODE_SMALL, &uc2));
+    uc_assert_success(uc_query(uc2, UC_QUERY_TCG_BUFFER_SIZE, &result));
+    assert_int_equal(result, 512 * 1024);
+    uc_assert_success(uc_query(uc2, UC_QUERY_TLB_SIZE, &result));
+    assert_int_equal(result, 64);
+
+    uc_assert_success(uc_mem_map(uc2, 0x100000, 0x1000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc2, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc2, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_reg_read(uc2, UC_X86_REG_EAX, &eax));
+    assert_int_equal(eax, 2);
+    uc_assert_success(uc_close(uc2));
+}
+
+static void test_xstate(void **state)
+{
+    uc_engine *uc = *state;
+    uc_x86_xstate ws, rs;
+
+    /* one blob write/read must round-trip the FPU/SSE state */
+    memset(&ws, 0, sizeof(ws));
+    ws.fcw = 0x037f;
+    ws.mxcsr = 0x1f80;
+    ws.ftw = 0x01;          /* ST(0) holds a value */
+    ws.st[0][9] = 0x40;
+    ws.xmm[3][0] = 0xaa;
+    ws.xmm[3][15] = 0xbb;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_XSTATE, &ws));
+
+    memset(&rs, 0xcc, sizeof(rs));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_XSTATE, &rs));
+    assert_int_equal(rs.fcw, 0x037f);
+    assert_int_equal(rs.mxcsr, 0x1f80);
+    assert_int_equal(rs.ftw, 0x01);
+    assert_int_equal(rs.st[0][9], 0x40);
+    assert_int_equal(rs.xmm[3][0], 0xaa);
+    assert_int_equal(rs.xmm[3][15], 0xbb);
+}
+
+static void test_dirty_tracking(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t bitmap[1];   /* 4 pages -> 1 byte */
+    uint8_t byte = 0xcc;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x4000, UC_PROT_ALL));
+
+    /* Freshly mapped pages count as written */
+    uc_assert_success(uc_mem_dirty(uc, 0x100000, 0x4000, bitmap));
+    assert_int_equal(bitmap[0], 0x0f);
+
+    /* After a reset everything reads as clean */
+    uc_assert_success(uc_mem_dirty_reset(uc, 0x100000, 0x4000));
+    uc_assert_success(uc_mem_dirty(uc, 0x100000, 0x4000, bitmap));
+    assert_int_equal(bitmap[0], 0x00);
+
+    /* A write to the third page sets exactly its bit */
+    uc_assert_success(uc_mem_write(uc, 0x102000, &byte, 1));
+    uc_assert_success(uc_mem_dirty(uc, 0x100000, 0x4000, bitmap));
+    assert_int_equal(bitmap[0], 0x04);
+
+    /* Querying unmapped memory fails */
+    uc_assert_err(UC_ERR_NOMEM, uc_mem_dirty(uc, 0x200000, 0x1000, bitmap));
+}
+
 /* Try to unmap memory that has not been mapped */
 static void test_bad_unmap(void **state)
 {
@@ -167,14 +1046,823 @@ static void test_query_page_size(void **state)
     assert_int_equal(4096, page_size);
 }
 
-void write(uc_engine* uc, uint64_t addr, uint64_t len){
+static void test_arch_state_ptr(void **state)
+{
+    uc_engine *uc = *state;
+
+    uc_arch_state as;
+    uint32_t eax = 0xdeadbeef;
+    uint64_t reg0 = 0;
+
+    uc_assert_success(uc_arch_state_ptr(uc, &as));
+    assert_int_equal(UC_ARCH_STATE_VERSION, as.version);
+    assert_true(as.reg_count >= 8);
+    assert_true(as.reg_bytes <= sizeof(reg0));
+    assert_non_null(as.regs);
+    assert_non_null(as.pc);
+    assert_non_null(as.flags);
+
+    // regs[0] is EAX in the x86 numbering; a write through the API must be
+    // visible through the direct pointer
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+    memcpy(&reg0, as.regs, as.reg_bytes);
+    assert_int_equal(0xdeadbeef, (uint32_t)reg0);
+
+    // and a store through the pointer must be visible to the API
+    reg0 = 0x11223344;
+    memcpy(as.regs, &reg0, as.reg_bytes);
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(0x11223344, eax);
+}
+
+static void test_vcpu_registers(void **state)
+{
+    uc_engine *uc = *state;
+    int id = -1;
+    uint32_t val;
+
+    uc_assert_success(uc_vcpu_create(uc, &id));
+    assert_int_equal(1, id);
+
+    // each vCPU has its own register file
+    val = 0x1111;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &val));
+    uc_assert_success(uc_vcpu_select(uc, 1));
+    val = 0x2222;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &val));
+
+    uc_assert_success(uc_vcpu_select(uc, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &val));
+    assert_int_equal(0x1111, val);
+    uc_assert_success(uc_vcpu_select(uc, 1));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &val));
+    assert_int_equal(0x2222, val);
+
+    // selecting a vCPU that was never created must fail
+    assert_int_equal(UC_ERR_ARG, uc_vcpu_select(uc, 7));
+
+    uc_assert_success(uc_vcpu_select(uc, 0));
+}
+
+static void *counting_alloc(void *opaque, size_t size)
+{
+    (*(int *)opaque)++;
+    return malloc(size);
+}
+
+static void counting_release(void *opaque, void *ptr)
+{
+    (*(int *)opaque)--;
+    free(ptr);
+}
+
+static void empty_code_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+}
+
+static void test_set_allocator(void **state)
+{
+    uc_engine *uc;
+    uc_hook hh;
+    int live = 0;
+
+    // use a private engine so the allocation balance can be checked
+    // across uc_close()
+    uc_assert_success(uc_open(UC_ARCH_X86, UC_MODE_32, &uc));
+    uc_assert_success(uc_set_allocator(uc, counting_alloc,
+                counting_release, &live));
+
+    // both callbacks are required
+    assert_int_equal(UC_ERR_ARG,
+            uc_set_allocator(uc, counting_alloc, NULL, &live));
+
+    uc_assert_success(uc_hook_add(uc, &hh, UC_HOOK_CODE,
+                empty_code_hook, NULL, 1, 0));
+    assert_true(live > 0);
+
+    // with allocations outstanding the allocator is locked in
+    assert_int_equal(UC_ERR_ARG,
+            uc_set_allocator(uc, counting_alloc, counting_release, &live));
+
+    uc_assert_success(uc_close(uc));
+    assert_int_equal(0, live);
+}
+
+static void test_mem_regions_fill(void **state)
+{
+    uc_engine *uc = *state;
+    uc_mem_region small[1], regions[2];
+    uint32_t count;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_map(uc, 0x300000, 8192, UC_PROT_READ));
+
+    uc_assert_success(uc_mem_regions_fill(uc, regions, 2, &count));
+    assert_int_equal(2, count);
+    assert_int_equal(0x100000, regions[0].begin);
+    assert_int_equal(0x100000 + 4096 - 1, regions[0].end);
+    assert_int_equal(UC_PROT_ALL, regions[0].perms);
+    assert_int_equal(0x300000, regions[1].begin);
+    assert_int_equal(UC_PROT_READ, regions[1].perms);
+
+    // a too-small buffer still reports the total count
+    uc_assert_success(uc_mem_regions_fill(uc, small, 1, &count));
+    assert_int_equal(2, count);
+    assert_int_equal(0x100000, small[0].begin);
+}
+
+static void test_query_counters(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t code[] = { 0x41, 0x41, 0x90 };  // inc ecx; inc ecx; nop
+    size_t val;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+
+    uc_assert_success(uc_query(uc, UC_QUERY_EMU_START_COUNT, &val));
+    assert_int_equal(1, val);
+    uc_assert_success(uc_query(uc, UC_QUERY_MEM_API_BYTES, &val));
+    assert_int_equal(sizeof(code), val);
+    uc_assert_success(uc_query(uc, UC_QUERY_EXEC_BLOCK_COUNT, &val));
+    assert_true(val >= 1);
+    uc_assert_success(uc_query(uc, UC_QUERY_EXEC_INSN_COUNT, &val));
+    assert_true(val >= 1);
+    uc_assert_success(uc_query(uc, UC_QUERY_TLB_FILL_COUNT, &val));
+    assert_true(val >= 1);
+    // no hooks were registered, so no events should have fired
+    uc_assert_success(uc_query(uc, UC_QUERY_HOOK_EVENT_COUNT, &val));
+    assert_int_equal(0, val);
+}
+
+// run a sub-emulation of the code at 0x100100 from inside the hook and
+// record its result
+static void nested_start_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    uc_err *err = user_data;
+
+    *err = uc_emu_start(uc, 0x100100, 0x100101, 0, 0);
+}
+
+static void test_nested_emu_start(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t outer[] = { 0x40, 0x40 };   // inc eax; inc eax
+    uint8_t inner[] = { 0x41 };         // inc ecx
+    uc_err nested_err = UC_ERR_HANDLE;
+    uint64_t eax = 0, ecx = 0;
+    uc_hook hh;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, outer, sizeof(outer)));
+    uc_assert_success(uc_mem_write(uc, 0x100100, inner, sizeof(inner)));
+
+    // hook only the first outer instruction, so the nested run (and the
+    // rest of the outer run) do not re-trigger it
+    uc_assert_success(uc_hook_add(uc, &hh, UC_HOOK_CODE, nested_start_hook,
+                &nested_err, 0x100000, 0x100000));
+
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(outer),
+                0, 0));
+
+    // the sub-emulation succeeded, and both runs did their work: registers
+    // are shared live state between the two
+    uc_assert_success(nested_err);
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_ECX, &ecx));
+    assert_int_equal(2, eax);
+    assert_int_equal(1, ecx);
+}
+
+struct dyn_hook_state {
+    uc_hook a, b;
+    int a_hits, b_hits;
+};
+
+static void dyn_target_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    struct dyn_hook_state *st = user_data;
+
+    st->b_hits++;
+}
+
+// attach a bounded hook on the next block and detach this one, both from
+// inside a callback: the blocks under the changed ranges get retranslated
+// while the rest of the cache stays warm
+static void dyn_attach_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    struct dyn_hook_state *st = user_data;
+
+    st->a_hits++;
+    uc_assert_success(uc_hook_add(uc, &st->b, UC_HOOK_CODE, dyn_target_hook,
+                st, 0x100010, 0x100010));
+    uc_assert_success(uc_hook_del(uc, st->a));
+}
+
+static void test_hook_dynamic_attach(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t block1[] = { 0x40, 0xeb, 0x0d };    // inc eax; jmp 0x100010
+    uint8_t block2[] = { 0x41, 0x90 };          // inc ecx; nop
+    struct dyn_hook_state st = { 0 };
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, block1, sizeof(block1)));
+    uc_assert_success(uc_mem_write(uc, 0x100010, block2, sizeof(block2)));
+
+    uc_assert_success(uc_hook_add(uc, &st.a, UC_HOOK_CODE, dyn_attach_hook,
+                &st, 0x100000, 0x100000));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100010 + sizeof(block2),
+                0, 0));
+
+    // the hook installed mid-run caught its block later in the same run
+    assert_int_equal(1, st.a_hits);
+    assert_int_equal(1, st.b_hits);
+
+    // the detached hook stays quiet on a rerun, the attached one fires again
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100010 + sizeof(block2),
+                0, 0));
+    assert_int_equal(1, st.a_hits);
+    assert_int_equal(2, st.b_hits);
+
+    uc_assert_success(uc_hook_del(uc, st.b));
+}
+
+static void test_mem_xlat(void **state)
+{
+    uc_engine *uc = *state;
+    uc_xlat_table table, table2;
+    uint8_t byte = 0xaa;
+    uint8_t *host;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_map(uc, 0x103000, 4096, UC_PROT_ALL));
+
+    uc_assert_success(uc_mem_xlat(uc, &table));
+    assert_int_equal(0x100000, table.base);
+    assert_int_equal(4096, table.page_size);
+    // spans lowest to highest mapping, holes included
+    assert_int_equal(4, table.page_count);
+    assert_non_null(table.pages[0]);
+    assert_null(table.pages[1]);
+    assert_null(table.pages[2]);
+    assert_non_null(table.pages[3]);
+
+    // entries alias the guest RAM directly
+    uc_assert_success(uc_mem_write(uc, 0x103008, &byte, 1));
+    host = (uint8_t *)table.pages[3] + 8;
+    assert_int_equal(0xaa, *host);
+
+    // a topology change moves the generation on and shrinks the span
+    uc_assert_success(uc_mem_unmap(uc, 0x103000, 4096));
+    uc_assert_success(uc_mem_xlat(uc, &table2));
+    assert_true(table2.generation != table.generation);
+    assert_int_equal(1, table2.page_count);
+}
+
+struct fuzz_loop_log {
+    uint8_t seen[8];    // guest scratch byte observed before each iteration
+    uint64_t calls;
+};
+
+// record what the target's scratch byte looks like at input-placement time:
+// with per-iteration rollback it must always hold the snapshot value
+static bool fuzz_place_input(uc_engine *uc, uint64_t iteration,
+        void *user_data)
+{
+    struct fuzz_loop_log *log = user_data;
+
+    if (iteration >= 3) {
+        return false;
+    }
+    uc_mem_read(uc, 0x100800, &log->seen[iteration], 1);
+    log->calls++;
+    return true;
+}
+
+static void test_fuzz_loop(void **state)
+{
+    uc_engine *uc = *state;
+    // inc byte ptr [0x100800]; nop (the exit point)
+    uint8_t code[] = { 0xfe, 0x05, 0x00, 0x08, 0x10, 0x00, 0x90 };
+    struct fuzz_loop_log log = { { 0 }, 0 };
+    uint64_t exits[] = { 0x100006 };
+    uint8_t scratch = 0xff;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    // 0 iterations = run until the callback declines; it stops after 3
+    uc_assert_success(uc_fuzz_loop(uc, 0x100000, exits, 1, 0,
+                fuzz_place_input, &log));
+    assert_int_equal(3, log.calls);
+
+    // every iteration saw the snapshot state, not the previous run's write
+    assert_int_equal(0, log.seen[0]);
+    assert_int_equal(0, log.seen[1]);
+    assert_int_equal(0, log.seen[2]);
+
+    // and the final rollback left the guest at the baseline too
+    uc_assert_success(uc_mem_read(uc, 0x100800, &scratch, 1));
+    assert_int_equal(0, scratch);
+}
+
+// forces eax while recording; the replay must reproduce this write
+// without the hook installed
+static void record_write_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    uint32_t eax = 100;
+
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+}
+
+static void test_record_replay(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t code[] = { 0x40, 0x40, 0x90 };  // inc eax; inc eax; nop
+    char path[64];
+    uint32_t eax;
+    uc_hook hh;
+
+    snprintf(path, sizeof(path), "/tmp/rr-%u.log", (unsigned)getpid());
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    uc_assert_success(uc_hook_add(uc, &hh, UC_HOOK_CODE, record_write_hook,
+                NULL, 0x100001, 0x100001));
+
+    // recorded run: the hook overwrites eax before the second inc
+    uc_assert_success(uc_record_enable(uc));
+    eax = 5;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100002, 0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(101, eax);
+    uc_assert_success(uc_record_save(uc, path));
+    uc_assert_success(uc_record_disable(uc));
+    uc_assert_success(uc_hook_del(uc, hh));
+
+    // replayed run: same initial state, no hook, same final state
+    eax = 5;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+    uc_assert_success(uc_replay_load(uc, path));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100002, 0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(101, eax);
+    uc_assert_success(uc_replay_stop(uc));
+
+    unlink(path);
+}
+
+struct emu_done_state {
+    int calls;
+    uc_err err;
+};
+
+static void emu_done_cb(uc_engine *uc, uc_err err, void *user_data)
+{
+    struct emu_done_state *st = user_data;
+
+    st->calls++;
+    st->err = err;
+}
+
+static void test_emu_start_async(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t code[] = { 0x40 };      // inc eax
+    struct emu_done_state st = { 0, UC_ERR_OK };
+    uint32_t eax;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    eax = 5;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+
+    // nothing in flight: returns immediately
+    uc_assert_success(uc_emu_wait(uc));
+
+    uc_assert_success(uc_emu_start_async(uc, 0x100000, 0x100001, 0, 0,
+                emu_done_cb, &st));
+    uc_assert_success(uc_emu_wait(uc));
+    assert_int_equal(1, st.calls);
+    uc_assert_success(st.err);
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(6, eax);
+
+    // the worker is reused for later runs
+    uc_assert_success(uc_emu_start_async(uc, 0x100000, 0x100001, 0, 0,
+                emu_done_cb, &st));
+    uc_assert_success(uc_emu_wait(uc));
+    assert_int_equal(2, st.calls);
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(7, eax);
+
+    // and synchronous runs still work on the same engine afterwards
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100001, 0, 0));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(8, eax);
+}
+
+static void test_save_restore_file(void **state)
+{
+    uc_engine *uc = *state;
+    uc_engine *worker;
+    uint8_t code[] = { 0x40 };      // inc eax
+    char path[64];
+    uint32_t eax, val;
+
+    snprintf(path, sizeof(path), "/tmp/img-%u.uc", (unsigned)getpid());
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_map(uc, 0x200000, 8192,
+                UC_PROT_READ | UC_PROT_WRITE));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+    val = 0xdeadbeef;
+    uc_assert_success(uc_mem_write(uc, 0x201000, &val, sizeof(val)));
+    eax = 41;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+
+    uc_assert_success(uc_save_file(uc, path));
+
+    // a worker attaches to the prepared image and picks up where the
+    // saved engine left off
+    uc_assert_success(uc_open(UC_ARCH_X86, UC_MODE_32, &worker));
+    uc_assert_success(uc_restore_file(worker, path));
+    uc_assert_success(uc_reg_read(worker, UC_X86_REG_EAX, &eax));
+    assert_int_equal(41, eax);
+    uc_assert_success(uc_mem_read(worker, 0x201000, &val, sizeof(val)));
+    assert_int_equal(0xdeadbeef, val);
+    uc_assert_success(uc_emu_start(worker, 0x100000, 0x100001, 0, 0));
+    uc_assert_success(uc_reg_read(worker, UC_X86_REG_EAX, &eax));
+    assert_int_equal(42, eax);
+
+    // worker writes are copy-on-write: the image is untouched
+    val = 0;
+    uc_assert_success(uc_mem_write(worker, 0x201000, &val, sizeof(val)));
+    uc_assert_success(uc_close(worker));
+
+    uc_assert_success(uc_open(UC_ARCH_X86, UC_MODE_32, &worker));
+    uc_assert_success(uc_restore_file(worker, path));
+    uc_assert_success(uc_mem_read(worker, 0x201000, &val, sizeof(val)));
+    assert_int_equal(0xdeadbeef, val);
+
+    // restoring over existing overlapping mappings fails and unwinds
+    uc_assert_err(UC_ERR_MAP, uc_restore_file(worker, path));
+    uc_assert_success(uc_close(worker));
+
+    unlink(path);
+}
+
+struct pool_job_io {
+    uint32_t in, out;
+};
+
+static bool pool_setup_cb(uc_engine *uc, void *job_data)
+{
+    struct pool_job_io *io = job_data;
+
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &io->in));
+    return true;
+}
+
+static void pool_done_cb(uc_engine *uc, uc_err err, void *job_data)
+{
+    struct pool_job_io *io = job_data;
+
+    uc_assert_success(err);
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &io->out));
+}
+
+static void test_pool(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t code[] = { 0x40, 0x90 };    // inc eax; nop
+    struct pool_job_io io[8];
+    uc_pool *pool;
+    uc_pool_result res;
+    int i;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    // two workers, eight jobs: each job places its own eax and reads the
+    // incremented value back in its done callback
+    uc_assert_success(uc_pool_create(uc, 2, &pool));
+    for (i = 0; i < 8; i++) {
+        uc_pool_job job = { 0x100000, 0x100001, 0, 0,
+                pool_setup_cb, pool_done_cb, &io[i] };
+
+        io[i].in = 10 + i;
+        io[i].out = 0;
+        uc_assert_success(uc_pool_submit(pool, &job));
+    }
+    for (i = 0; i < 8; i++) {
+        uc_assert_success(uc_pool_collect(pool, &res));
+        uc_assert_success(res.err);
+    }
+    // everything collected: one more must not block
+    uc_assert_err(UC_ERR_ARG, uc_pool_collect(pool, &res));
+
+    // per-job rollback means no job saw another job's eax
+    for (i = 0; i < 8; i++) {
+        assert_int_equal(10 + i + 1, io[i].out);
+    }
+
+    uc_assert_success(uc_pool_free(pool));
+}
+
+static void test_checkpoint(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t code[] = { 0x40 };      // inc eax
+    uint32_t eax, val;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    eax = 5;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+    val = 0xaaaa;
+    uc_assert_success(uc_mem_write(uc, 0x100800, &val, sizeof(val)));
+
+    // anchor checkpoint: eax=5, [0x100800]=0xaaaa
+    uc_assert_success(uc_checkpoint_enable(uc, 1, 4));
+    uc_assert_err(UC_ERR_ARG, uc_checkpoint_enable(uc, 1, 4));
+
+    // every run takes one checkpoint at block entry, before the inc
+    eax = 10;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+    val = 0xbbbb;
+    uc_assert_success(uc_mem_write(uc, 0x100800, &val, sizeof(val)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100001, 0, 0));
+
+    eax = 20;
+    uc_assert_success(uc_reg_write(uc, UC_X86_REG_EAX, &eax));
+    val = 0xcccc;
+    uc_assert_success(uc_mem_write(uc, 0x100800, &val, sizeof(val)));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100001, 0, 0));
+
+    // one step back: the checkpoint taken at the start of the last run
+    uc_assert_success(uc_rewind(uc, 1));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(20, eax);
+    uc_assert_success(uc_mem_read(uc, 0x100800, &val, sizeof(val)));
+    assert_int_equal(0xcccc, val);
+
+    // two steps back crosses a checkpoint via its recorded delta
+    uc_assert_success(uc_rewind(uc, 2));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(10, eax);
+    uc_assert_success(uc_mem_read(uc, 0x100800, &val, sizeof(val)));
+    assert_int_equal(0xbbbb, val);
+
+    // and again, back to the anchor
+    uc_assert_success(uc_rewind(uc, 2));
+    uc_assert_success(uc_reg_read(uc, UC_X86_REG_EAX, &eax));
+    assert_int_equal(5, eax);
+    uc_assert_success(uc_mem_read(uc, 0x100800, &val, sizeof(val)));
+    assert_int_equal(0xaaaa, val);
+
+    // the anchor is the only checkpoint left
+    uc_assert_err(UC_ERR_ARG, uc_rewind(uc, 2));
+
+    uc_assert_success(uc_checkpoint_disable(uc));
+    uc_assert_err(UC_ERR_ARG, uc_checkpoint_disable(uc));
+}
+
+// query the block's instruction metadata while its translation is live
+static void tb_meta_block_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    uc_tb_insn insns[8];
+    uint32_t count = 0;
+    int i;
+
+    // count-only query
+    uc_assert_success(uc_tb_meta(uc, address, NULL, &count));
+    assert_int_equal(3, count);
+
+    count = 8;
+    uc_assert_success(uc_tb_meta(uc, address, insns, &count));
+    assert_int_equal(3, count);
+    for (i = 0; i < 3; i++) {
+        assert_int_equal(address + i, insns[i].address);
+        assert_int_equal(1, insns[i].size);
+        assert_int_equal(0x40 + i, insns[i].bytes[0]);
+    }
+
+    // a short buffer gets a truncated copy, not an error
+    count = 2;
+    uc_assert_success(uc_tb_meta(uc, address, insns, &count));
+    assert_int_equal(2, count);
+
+    (*(int *)user_data)++;
+}
+
+static void test_tb_meta(void **state)
+{
+    uc_engine *uc = *state;
+    uc_tb_insn insns[8];
+    uint32_t count;
+    uint8_t code[] = { 0x40, 0x41, 0x42 };      // inc eax; inc ecx; inc edx
+    int queried = 0;
+    uc_hook hh;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    uc_assert_success(uc_hook_add(uc, &hh, UC_HOOK_BLOCK, tb_meta_block_hook,
+                &queried, (uint64_t)1, (uint64_t)0));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    assert_int_equal(1, queried);
+
+    // stopping flushed the translation cache, and the metadata with it
+    count = 8;
+    uc_assert_err(UC_ERR_ARG, uc_tb_meta(uc, 0x100000, insns, &count));
+
+    uc_assert_success(uc_hook_del(uc, hh));
+}
+
+static void test_trace_stream(void **state)
+{
+    uc_engine *uc = *state;
+    uint8_t code[] = { 0x41, 0x41, 0x90 };  // inc ecx; inc ecx; nop
+    char path[] = "/tmp/uc_trace_XXXXXX";
+    uc_trace_file_header hdr;
+    uc_trace_stream_record rec;
+    size_t count, i;
+    int fd;
+
+    fd = mkstemp(path);
+    assert_true(fd >= 0);
+    unlink(path);
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    uc_assert_success(uc_trace_stream(uc, UC_HOOK_CODE, fd, 0));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_trace_count(uc, &count));
+    assert_int_equal(3, count);
+
+    // disabling flushes everything to the descriptor
+    uc_assert_success(uc_trace_disable(uc));
+
+    assert_int_equal(0, lseek(fd, 0, SEEK_SET));
+    assert_int_equal(sizeof(hdr), read(fd, &hdr, sizeof(hdr)));
+    assert_memory_equal("UCTR", hdr.magic, 4);
+    assert_int_equal(1, hdr.version);
+    assert_int_equal(sizeof(rec), hdr.record_size);
+    assert_int_equal(UC_ARCH_X86, hdr.arch);
+
+    for (i = 0; i < count; i++) {
+        assert_int_equal(sizeof(rec), read(fd, &rec, sizeof(rec)));
+        assert_int_equal(i, rec.seq);
+        assert_int_equal(0x100000 + i, rec.address);
+        assert_int_equal(UC_HOOK_CODE, rec.type);
+    }
+    // and nothing beyond the produced records
+    assert_int_equal(0, read(fd, &rec, sizeof(rec)));
+    close(fd);
+}
+
+static void test_trace_compress(void **state)
+{
+    uc_engine *uc = *state;
+    // mov ecx, 32; dec ecx; jnz -3; nop -- a loop producing a highly
+    // redundant instruction trace
+    uint8_t code[] = { 0xb9, 0x20, 0x00, 0x00, 0x00, 0x49, 0x75, 0xfd,
+            0x90 };
+    char path[] = "/tmp/uc_trace_XXXXXX";
+    uc_trace_stream_record recs[128];
+    uc_trace_file_header hdr;
+    uc_trace_frame frame;
+    uint8_t payload[4096];
+    size_t count, i;
+    int fd;
+
+    fd = mkstemp(path);
+    assert_true(fd >= 0);
+    unlink(path);
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 4096, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    uc_assert_success(uc_trace_compress(uc, true));
+    uc_assert_success(uc_trace_stream(uc, UC_HOOK_CODE, fd, 0));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    uc_assert_success(uc_trace_count(uc, &count));
+    assert_int_equal(1 + 32 * 2 + 1, count);    // mov + 32x(dec, jnz) + nop
+    uc_assert_success(uc_trace_disable(uc));
+
+    assert_int_equal(0, lseek(fd, 0, SEEK_SET));
+    assert_int_equal(sizeof(hdr), read(fd, &hdr, sizeof(hdr)));
+    assert_memory_equal("UCTR", hdr.magic, 4);
+    assert_true(hdr.flags & UC_TRACE_COMPRESSED);
+
+    assert_int_equal(sizeof(frame), read(fd, &frame, sizeof(frame)));
+    assert_int_equal(UC_TRACE_FRAME_MAGIC, frame.magic);
+    assert_int_equal(count, frame.record_count);
+    assert_int_equal(0, frame.first_seq);
+    assert_int_equal(count * sizeof(recs[0]), frame.raw_size);
+    // the loop must actually compress
+    assert_true(frame.compressed_size < frame.raw_size);
+
+    assert_int_equal(frame.compressed_size,
+            read(fd, payload, frame.compressed_size));
+    uc_assert_success(uc_trace_decompress(payload, frame.compressed_size,
+                recs, frame.raw_size));
+
+    for (i = 0; i < count; i++) {
+        assert_int_equal(i, recs[i].seq);
+        assert_int_equal(UC_HOOK_CODE, recs[i].type);
+    }
+    assert_int_equal(0x100000, recs[0].address);    // the mov
+    assert_int_equal(0x100005, recs[1].address);    // first dec
+    assert_int_equal(0x100008, recs[count - 1].address);    // the nop
+    close(fd);
+}
+
+struct watch_log {
+    uint64_t address[4];
+    int size[4];
+    int64_t value[4];
+    int count;
+};
+
+static void watch_hook(uc_engine *uc, uc_mem_type type, uint64_t address,
+        int size, int64_t value, void *user_data)
+{
+    struct watch_log *log = user_data;
+
+    assert_int_equal(UC_MEM_WRITE, type);
+    assert_true(log->count < 4);
+    log->address[log->count] = address;
+    log->size[log->count] = size;
+    log->value[log->count] = value;
+    log->count++;
+}
+
+static void test_watchpoint(void **state)
+{
+    uc_engine *uc = *state;
+    // mov byte [0x101800], 0x42  -- different page, not watched
+    // mov byte [0x100800], 0x41  -- inside the watched range
+    // mov dword [0x1007fe], 0x11223344 -- straddles into the watched range
+    uint8_t code[] = {
+            0xc6, 0x05, 0x00, 0x18, 0x10, 0x00, 0x42,
+            0xc6, 0x05, 0x00, 0x08, 0x10, 0x00, 0x41,
+            0xc7, 0x05, 0xfe, 0x07, 0x10, 0x00, 0x44, 0x33, 0x22, 0x11,
+    };
+    struct watch_log log = { 0 };
+    uc_hook wh;
+
+    uc_assert_success(uc_mem_map(uc, 0x100000, 0x8000, UC_PROT_ALL));
+    uc_assert_success(uc_mem_write(uc, 0x100000, code, sizeof(code)));
+
+    uc_assert_success(uc_watch_add(uc, &wh, UC_HOOK_MEM_WRITE, watch_hook,
+                &log, 0x100800, 4));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+
+    // the unwatched-page store must not fire
+    assert_int_equal(2, log.count);
+    assert_int_equal(0x100800, log.address[0]);
+    assert_int_equal(1, log.size[0]);
+    assert_int_equal(0x41, log.value[0]);
+    assert_int_equal(0x1007fe, log.address[1]);
+    assert_int_equal(4, log.size[1]);
+    assert_int_equal(0x11223344, log.value[1]);
+
+    // after deletion the same code runs without callbacks
+    uc_assert_success(uc_watch_del(uc, wh));
+    uc_assert_err(UC_ERR_HANDLE, uc_watch_del(uc, wh));
+    uc_assert_success(uc_emu_start(uc, 0x100000, 0x100000 + sizeof(code),
+                0, 0));
+    assert_int_equal(2, log.count);
+}
+
+/* renamed from write()/read(): those names collide with the unistd.h
+   declarations pulled in for getpid/unlink */
+void mem_write_checked(uc_engine* uc, uint64_t addr, uint64_t len){
   uint8_t* buff = alloca(len);
   memset(buff,0,len);
   uc_mem_write(uc, addr, buff, len);
 
 }
 
-void read(uc_engine* uc, uint64_t addr, uint64_t len){
+void mem_read_checked(uc_engine* uc, uint64_t addr, uint64_t len){
   uint8_t* buff = alloca(len);
   uc_mem_read(uc, addr, buff, len);
 }
@@ -226,10 +1914,59 @@ int main(void) {
         test(test_assertion_fail),
         test(test_bad_unmap),
         test(test_rw_across_boundaries),
+        test(test_rw_vectored),
+        test(test_map_batch),
+        test(test_protect_subrange),
+        test(test_dirty_tracking),
+        test(test_map_hugepage),
+        test(test_map_mergeable),
+        test(test_mmio),
+        test(test_tlb_resize),
+        test(test_tcg_buffer_resize),
+        test(test_tb_cache),
+        test(test_translate),
+        test(test_translate_readahead),
+        test(test_jmp_cache_resize),
+        test(test_query_tb_stats),
+        test(test_query_mem_stats),
+        test(test_sample_profiler),
+        test(test_emu_timeout),
+        test(test_crosspage_chain),
+        test(test_superblock),
+        test(test_adc_chain),
+        test(test_sse_arith),
+        test(test_perfmap),
+        test(test_logic_jcc),
+        test(test_tb_insn_limit),
+        test(test_emu_continue),
+        test(test_icount_timeout),
+        test(test_reset),
+        test(test_shared_type_graph),
+        test(test_bare_mode),
+        test(test_small_mode),
+        test(test_xstate),
         test(test_unmap_double_map),
         test(test_overlap_unmap_double_map),
         test(test_strange_map),
         test(test_query_page_size),
+        test(test_arch_state_ptr),
+        test(test_vcpu_registers),
+        test(test_set_allocator),
+        test(test_mem_regions_fill),
+        test(test_query_counters),
+        test(test_nested_emu_start),
+        test(test_hook_dynamic_attach),
+        test(test_mem_xlat),
+        test(test_fuzz_loop),
+        test(test_record_replay),
+        test(test_emu_start_async),
+        test(test_save_restore_file),
+        test(test_pool),
+        test(test_checkpoint),
+        test(test_tb_meta),
+        test(test_trace_stream),
+        test(test_trace_compress),
+        test(test_watchpoint),
     };
 #undef test
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -102,10 +102,55 @@ static void test_basic_blocks(void **state)
     OK(uc_emu_start(uc, address, address+sizeof(code), 0, 0));
 }
 
+static void test_hook_filter_callback(uc_engine *uc, uc_mem_type type,
+        uint64_t address, int size, int64_t value, void *user_data)
+{
+    int *hits = user_data;
+
+    (*hits)++;
+    assert_int_equal(type, UC_MEM_WRITE);
+    assert_int_equal(address, 0x1001000);
+    assert_int_equal(value, 0xdeadbeef);
+}
+
+static void test_hook_filter(void **state)
+{
+    uc_engine *uc = *state;
+    uc_hook trace;
+    int hits = 0;
+
+    uint64_t address = 0x1000000;
+    const uint8_t code[] = {
+        // mov dword ptr [0x1001000], 0x41424344
+        0xC7, 0x05, 0x00, 0x10, 0x00, 0x01, 0x44, 0x43, 0x42, 0x41,
+        // mov dword ptr [0x1001000], 0xdeadbeef
+        0xC7, 0x05, 0x00, 0x10, 0x00, 0x01, 0xEF, 0xBE, 0xAD, 0xDE,
+    };
+
+    uc_hook_filter filter = {
+        .begin = 1,
+        .end = 0,                   // catch-all address range
+        .value_mask = 0xffffffff,
+        .value = 0xdeadbeef,
+    };
+
+    OK(uc_mem_map(uc, address, 2 * 1024 * 1024, UC_PROT_ALL));
+    OK(uc_mem_write(uc, address, code, sizeof(code)));
+
+    OK(uc_hook_add(uc, &trace, UC_HOOK_MEM_WRITE, test_hook_filter_callback, &hits, 1, 0));
+    OK(uc_hook_set_filter(uc, trace, &filter));
+
+    OK(uc_emu_start(uc, address, address + sizeof(code), 0, 0));
+
+    // only the write of the matching value must reach the callback
+    assert_int_equal(hits, 1);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_basic_blocks, setup32, teardown),
+        cmocka_unit_test_setup_teardown(test_hook_filter, setup32, teardown),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
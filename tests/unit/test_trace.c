@@ -0,0 +1,84 @@
+#include "unicorn_test.h"
+
+#define OK(x)   uc_assert_success(x)
+
+#define ADDRESS 0x1000000
+
+/* INC ecx; DEC edx; INC ecx */
+static const uint8_t CODE[] = "\x41\x4a\x41";
+
+/* Instructions end up as one 16-byte record each in the ring buffer */
+static void test_trace_code(void **state)
+{
+    uc_engine *uc;
+    uc_trace_record records[16];
+    size_t count;
+
+    OK(uc_open(UC_ARCH_X86, UC_MODE_32, &uc));
+    OK(uc_mem_map(uc, ADDRESS, 4 * 1024, UC_PROT_ALL));
+    OK(uc_mem_write(uc, ADDRESS, CODE, sizeof(CODE) - 1));
+
+    OK(uc_trace_enable(uc, UC_HOOK_CODE, records, 16));
+
+    OK(uc_emu_start(uc, ADDRESS, ADDRESS + sizeof(CODE) - 1, 0, 0));
+
+    OK(uc_trace_count(uc, &count));
+    assert_int_equal(count, 3);
+    assert_int_equal(records[0].address, ADDRESS);
+    assert_int_equal(records[0].type, UC_HOOK_CODE);
+    assert_int_equal(records[1].address, ADDRESS + 1);
+    assert_int_equal(records[2].address, ADDRESS + 2);
+
+    OK(uc_trace_disable(uc));
+    OK(uc_close(uc));
+}
+
+/* The producer wraps around a full ring buffer instead of stopping */
+static void test_trace_wraps(void **state)
+{
+    uc_engine *uc;
+    uc_trace_record records[2];
+    size_t count;
+
+    OK(uc_open(UC_ARCH_X86, UC_MODE_32, &uc));
+    OK(uc_mem_map(uc, ADDRESS, 4 * 1024, UC_PROT_ALL));
+    OK(uc_mem_write(uc, ADDRESS, CODE, sizeof(CODE) - 1));
+
+    OK(uc_trace_enable(uc, UC_HOOK_CODE, records, 2));
+
+    OK(uc_emu_start(uc, ADDRESS, ADDRESS + sizeof(CODE) - 1, 0, 0));
+
+    OK(uc_trace_count(uc, &count));
+    assert_int_equal(count, 3);
+    /* record 2 overwrote record 0 */
+    assert_int_equal(records[0].address, ADDRESS + 2);
+    assert_int_equal(records[1].address, ADDRESS + 1);
+
+    OK(uc_trace_disable(uc));
+    OK(uc_close(uc));
+}
+
+static void test_trace_bad_args(void **state)
+{
+    uc_engine *uc;
+    uc_trace_record records[2];
+
+    OK(uc_open(UC_ARCH_X86, UC_MODE_32, &uc));
+
+    assert_int_equal(uc_trace_enable(uc, UC_HOOK_CODE, NULL, 2), UC_ERR_ARG);
+    assert_int_equal(uc_trace_enable(uc, UC_HOOK_CODE, records, 0), UC_ERR_ARG);
+    /* only code, block and data access events can be traced */
+    assert_int_equal(uc_trace_enable(uc, UC_HOOK_INTR, records, 2), UC_ERR_ARG);
+
+    OK(uc_close(uc));
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_trace_code),
+        cmocka_unit_test(test_trace_wraps),
+        cmocka_unit_test(test_trace_bad_args),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -17,9 +17,16 @@
 #include <string.h>
 #ifndef _WIN32
 #include <sys/mman.h>
+#include <errno.h>  // EINTR, for uc_trace_stream()
+#include <fcntl.h>  // open, for uc_mem_map_file()
+#include <unistd.h> // close
+#include <sys/stat.h>   // fstat, for uc_restore_file()
+#else
+#include <process.h>    // _getpid, for uc_perfmap_enable()
 #endif
 
 #include "uc_priv.h"
+#include "uc_probe.h"
 
 // target specific headers
 #include "qemu/target-m68k/unicorn.h"
@@ -30,6 +37,155 @@
 
 #include "qemu/include/hw/boards.h"
 
+// With UNICORN_PLUGINS the per-arch translators live in standalone shared
+// objects (libunicorn-<target>.so, built by the Makefile) and are loaded on
+// the first uc_open() of their arch, so single-arch consumers never map the
+// other translators. dlopen() refcounts repeated loads and the plugins stay
+// loaded for the life of the process, so no handle bookkeeping is needed.
+// The UC_ARCH_INIT() uses below collapse to plain function references in a
+// monolithic build.
+#ifdef UNICORN_PLUGINS
+#include <dlfcn.h>
+
+static uc_args_uc_t uc_plugin_init(const char *lib, const char *sym)
+{
+    void *handle = dlopen(lib, RTLD_NOW | RTLD_LOCAL);
+
+    if (handle == NULL) {
+        return NULL;
+    }
+    return (uc_args_uc_t)(uintptr_t)dlsym(handle, sym);
+}
+
+#define UC_ARCH_INIT(target, sym) uc_plugin_init("libunicorn-" target ".so", #sym)
+#else
+#define UC_ARCH_INIT(target, sym) sym
+#endif
+
+static void hook_sweep(struct uc_struct *uc);
+static uint32_t memory_region_upper_bound(struct uc_struct *uc, uint64_t address);
+static void trace_stream_stop(struct uc_struct *uc);
+static uint64_t rr_hits_bump(struct uc_struct *uc, struct uc_rr_slot **table,
+        uint32_t *size, uint32_t *used, uint64_t pc);
+static void rr_capture(struct uc_struct *uc, uint8_t kind, int32_t reg,
+        uint64_t addr, const void *data, uint32_t len);
+static void rr_record_free(struct uc_struct *uc);
+static void rr_replay_free(struct uc_struct *uc);
+static void ckpt_ring_free(struct uc_struct *uc);
+
+// engine-frontend allocations go through these wrappers so that
+// uc_set_allocator() can redirect them to a per-instance arena;
+// alloc_count tracks what is outstanding (the allocator may only be
+// configured while it is zero)
+static void *ualloc(struct uc_struct *uc, size_t size)
+{
+    void *p;
+
+    if (uc->mem_alloc) {
+        p = uc->mem_alloc(uc->mem_opaque, size);
+    } else {
+        p = malloc(size);
+    }
+    if (p) {
+        uc->alloc_count++;
+    }
+    return p;
+}
+
+static void *uzalloc(struct uc_struct *uc, size_t size)
+{
+    void *p = ualloc(uc, size);
+
+    if (p) {
+        memset(p, 0, size);
+    }
+    return p;
+}
+
+static void ufree(struct uc_struct *uc, void *p)
+{
+    if (p == NULL) {
+        return;
+    }
+    uc->alloc_count--;
+    if (uc->mem_release) {
+        uc->mem_release(uc->mem_opaque, p);
+    } else {
+        free(p);
+    }
+}
+
+// the custom allocator interface has no realloc, so growing means
+// allocate + copy + release; @old_size is what the caller knows is live
+static void *urealloc(struct uc_struct *uc, void *old, size_t old_size,
+        size_t size)
+{
+    void *p;
+
+    if (uc->mem_alloc == NULL) {
+        p = realloc(old, size);
+        if (p && old == NULL) {
+            uc->alloc_count++;
+        }
+        return p;
+    }
+
+    p = ualloc(uc, size);
+    if (p == NULL) {
+        return NULL;
+    }
+    if (old) {
+        memcpy(p, old, MIN(old_size, size));
+        ufree(uc, old);
+    }
+    return p;
+}
+
+UNICORN_EXPORT
+uc_err uc_set_allocator(uc_engine *uc, uc_cb_alloc_t alloc,
+        uc_cb_release_t release, void *opaque)
+{
+    if (alloc == NULL || release == NULL) {
+        return UC_ERR_ARG;
+    }
+    // switching allocators under live allocations would free memory with
+    // the wrong callback; the caller must do this on a fresh handle
+    if (uc->alloc_count != 0) {
+        return UC_ERR_ARG;
+    }
+
+    uc->mem_alloc = alloc;
+    uc->mem_release = release;
+    uc->mem_opaque = opaque;
+
+    return UC_ERR_OK;
+}
+
+// MIPS is the only architecture that redirects addresses handed to the
+// memory APIs: the fixed kseg0/kseg1 windows alias the low physical range.
+// The masking is known at compile time, so it is inlined here instead of
+// going through a per-engine function pointer, and builds without a MIPS
+// target compile the whole thing away.
+#if defined(UNICORN_HAS_MIPS) || defined(UNICORN_HAS_MIPSEL) \
+        || defined(UNICORN_HAS_MIPS64) || defined(UNICORN_HAS_MIPS64EL)
+static inline uint64_t uc_mem_redirect(struct uc_struct *uc, uint64_t address)
+{
+    if (uc->arch == UC_ARCH_MIPS) {
+        // kseg0 range masks off high address bit
+        if (address >= 0x80000000 && address <= 0x9fffffff) {
+            return address & 0x7fffffff;
+        }
+        // kseg1 range masks off top 3 address bits
+        if (address >= 0xa0000000 && address <= 0xbfffffff) {
+            return address & 0x1fffffff;
+        }
+    }
+    return address;
+}
+#else
+#define uc_mem_redirect(uc, address) (address)
+#endif
+
 
 UNICORN_EXPORT
 unsigned int uc_version(unsigned int *major, unsigned int *minor)
@@ -147,6 +303,8 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
         uc->errnum = UC_ERR_OK;
         uc->arch = arch;
         uc->mode = mode;
+        uc->vcpu_count = 1;
+        uc->vcpu_quantum = 4096;    // instructions per round-robin slice
 
         // uc->cpus = QTAILQ_HEAD_INITIALIZER(uc->cpus);
         uc->cpus.tqh_first = NULL;
@@ -173,7 +331,7 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
                     free(uc);
                     return UC_ERR_MODE;
                 }
-                uc->init_arch = m68k_uc_init;
+                uc->init_arch = UC_ARCH_INIT("m68k", m68k_uc_init);
                 break;
 #endif
 #ifdef UNICORN_HAS_X86
@@ -184,7 +342,7 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
                     free(uc);
                     return UC_ERR_MODE;
                 }
-                uc->init_arch = x86_uc_init;
+                uc->init_arch = UC_ARCH_INIT("x86_64", x86_uc_init);
                 break;
 #endif
 #ifdef UNICORN_HAS_ARM
@@ -194,7 +352,7 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
                     free(uc);
                     return UC_ERR_MODE;
                 }
-                uc->init_arch = arm_uc_init;
+                uc->init_arch = UC_ARCH_INIT("arm", arm_uc_init);
 
                 if (mode & UC_MODE_THUMB)
                     uc->thumb = 1;
@@ -207,7 +365,7 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
                     free(uc);
                     return UC_ERR_MODE;
                 }
-                uc->init_arch = arm64_uc_init;
+                uc->init_arch = UC_ARCH_INIT("aarch64", arm64_uc_init);
                 break;
 #endif
 
@@ -221,20 +379,20 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
                 if (mode & UC_MODE_BIG_ENDIAN) {
 #ifdef UNICORN_HAS_MIPS
                     if (mode & UC_MODE_MIPS32)
-                        uc->init_arch = mips_uc_init;
+                        uc->init_arch = UC_ARCH_INIT("mips", mips_uc_init);
 #endif
 #ifdef UNICORN_HAS_MIPS64
                     if (mode & UC_MODE_MIPS64)
-                        uc->init_arch = mips64_uc_init;
+                        uc->init_arch = UC_ARCH_INIT("mips64", mips64_uc_init);
 #endif
                 } else {    // little endian
 #ifdef UNICORN_HAS_MIPSEL
                     if (mode & UC_MODE_MIPS32)
-                        uc->init_arch = mipsel_uc_init;
+                        uc->init_arch = UC_ARCH_INIT("mipsel", mipsel_uc_init);
 #endif
 #ifdef UNICORN_HAS_MIPS64EL
                     if (mode & UC_MODE_MIPS64)
-                        uc->init_arch = mips64el_uc_init;
+                        uc->init_arch = UC_ARCH_INIT("mips64el", mips64el_uc_init);
 #endif
                 }
                 break;
@@ -249,14 +407,16 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
                     return UC_ERR_MODE;
                 }
                 if (mode & UC_MODE_SPARC64)
-                    uc->init_arch = sparc64_uc_init;
+                    uc->init_arch = UC_ARCH_INIT("sparc64", sparc64_uc_init);
                 else
-                    uc->init_arch = sparc_uc_init;
+                    uc->init_arch = UC_ARCH_INIT("sparc", sparc_uc_init);
                 break;
 #endif
         }
 
+        // also hit when a plugin build cannot load the arch's shared object
         if (uc->init_arch == NULL) {
+            free(uc);
             return UC_ERR_ARCH;
         }
 
@@ -275,13 +435,179 @@ uc_err uc_open(uc_arch arch, uc_mode mode, uc_engine **result)
 }
 
 
+// deadline timer thread: sleeps until the armed run's deadline and stops the
+// emulation if the run is still going by then. Enforcing the timeout here
+// instead of per-block in cpu_exec() lets timeout runs keep direct TB
+// chaining (see tb_add_jump in qemu/cpu-exec.c); stop latency stays bounded
+// because every TB prologue checks tcg_exit_req, which uc_emu_stop() raises.
+static void *timer_worker(void *opaque)
+{
+    uc_engine *uc = opaque;
+
+    for (;;) {
+        qemu_sem_wait(&uc->timer_arm);
+        if (uc->timer_exit) {
+            break;
+        }
+
+        for (;;) {
+            // the coarse clock lags the deadline's clock by at most one
+            // kernel tick, so the timeout can only fire late, never early
+            int64_t remaining = uc->deadline - get_clock_coarse();
+            if (remaining <= 0) {
+                // the run is still active past the deadline: stop it exactly
+                // like an explicit uc_emu_stop() would, then consume the
+                // end-of-run post below
+                uc_emu_stop(uc);
+                qemu_sem_wait(&uc->timer_cancel);
+                break;
+            }
+            // a successful wait means the run ended before the deadline;
+            // otherwise re-check the clock, the wait only has ms resolution
+            if (qemu_sem_timedwait(&uc->timer_cancel,
+                        (int)(remaining / 1000000) + 1) == 0) {
+                break;
+            }
+        }
+
+        // uc_emu_start() waits for this before returning, so a late firing
+        // can never leak into the next run
+        qemu_sem_post(&uc->timer_idle);
+    }
+
+    return NULL;
+}
+
+// start the deadline timer thread when the first timeout run begins
+static uc_err timer_start(uc_engine *uc)
+{
+    qemu_sem_init(&uc->timer_arm, 0);
+    qemu_sem_init(&uc->timer_cancel, 0);
+    qemu_sem_init(&uc->timer_idle, 0);
+    uc->timer_exit = false;
+
+    if (qemu_thread_create(&uc->timer_thread, "timeout",
+                timer_worker, uc, QEMU_THREAD_JOINABLE)) {
+        qemu_sem_destroy(&uc->timer_arm);
+        qemu_sem_destroy(&uc->timer_cancel);
+        qemu_sem_destroy(&uc->timer_idle);
+        return UC_ERR_RESOURCE;
+    }
+    uc->timer_started = true;
+
+    return UC_ERR_OK;
+}
+
+// background emulation thread for uc_emu_start_async(): emulation always
+// executes on whichever thread enters the vCPU loop (resume_all_vcpus()
+// runs it synchronously), so asynchronous runs get a per-engine worker,
+// parked between runs like the deadline timer thread. The completion
+// callback runs here, before the idle post releases uc_emu_wait().
+static void *emu_worker(void *opaque)
+{
+    uc_engine *uc = opaque;
+
+    for (;;) {
+        qemu_sem_wait(&uc->emu_worker_go);
+        if (uc->emu_worker_exit) {
+            break;
+        }
+
+        uc->emu_async_err = uc_emu_start(uc, uc->emu_async_begin,
+                uc->emu_async_until, uc->emu_async_timeout,
+                uc->emu_async_count);
+        if (uc->emu_async_done) {
+            uc->emu_async_done(uc, uc->emu_async_err,
+                    uc->emu_async_done_data);
+        }
+        uc->emu_async_active = false;
+        qemu_sem_post(&uc->emu_worker_idle);
+    }
+
+    return NULL;
+}
+
+// start the background emulation thread when the first async run begins
+static uc_err emu_worker_start(uc_engine *uc)
+{
+    qemu_sem_init(&uc->emu_worker_go, 0);
+    qemu_sem_init(&uc->emu_worker_idle, 0);
+    uc->emu_worker_exit = false;
+
+    if (qemu_thread_create(&uc->emu_worker_thread, "emu",
+                emu_worker, uc, QEMU_THREAD_JOINABLE)) {
+        qemu_sem_destroy(&uc->emu_worker_go);
+        qemu_sem_destroy(&uc->emu_worker_idle);
+        return UC_ERR_RESOURCE;
+    }
+    uc->emu_worker_started = true;
+
+    return UC_ERR_OK;
+}
+
+
 UNICORN_EXPORT
 uc_err uc_close(uc_engine *uc)
 {
     int i;
-    struct list_item *cur;
+    uint32_t j;
     struct hook *hook;
 
+    // stop the asynchronous hook dispatch thread after it drains the queue
+    if (uc->async_queue) {
+        qemu_mutex_lock(&uc->async_mutex);
+        uc->async_running = false;
+        qemu_cond_signal(&uc->async_avail);
+        qemu_mutex_unlock(&uc->async_mutex);
+        qemu_thread_join(&uc->async_thread);
+        qemu_mutex_destroy(&uc->async_mutex);
+        qemu_cond_destroy(&uc->async_avail);
+        qemu_cond_destroy(&uc->async_space);
+        ufree(uc, uc->async_queue);
+    }
+
+    // stop the streaming trace writer after it flushed what remains
+    trace_stream_stop(uc);
+
+    // drop any recording or replay in progress (the replay's internal
+    // hooks join the regular hook teardown below)
+    rr_record_free(uc);
+    rr_replay_free(uc);
+
+    // drop the checkpoint ring (its block hook joins the teardown too)
+    ckpt_ring_free(uc);
+
+    // stop the background emulation thread: stop a run still in flight
+    // (retrying around the window before the worker enters the vCPU
+    // loop), then wake the parked worker with the exit flag set
+    if (uc->emu_worker_started) {
+        while (uc->emu_async_active) {
+            uc_emu_stop(uc);
+            qemu_sem_timedwait(&uc->emu_worker_idle, 1);
+        }
+        uc->emu_worker_exit = true;
+        qemu_sem_post(&uc->emu_worker_go);
+        qemu_thread_join(&uc->emu_worker_thread);
+        qemu_sem_destroy(&uc->emu_worker_go);
+        qemu_sem_destroy(&uc->emu_worker_idle);
+    }
+
+    // stop the deadline timer thread; it is idle between runs, so one arm
+    // post with timer_exit set wakes it for good
+    if (uc->timer_started) {
+        uc->timer_exit = true;
+        qemu_sem_post(&uc->timer_arm);
+        qemu_thread_join(&uc->timer_thread);
+        qemu_sem_destroy(&uc->timer_arm);
+        qemu_sem_destroy(&uc->timer_cancel);
+        qemu_sem_destroy(&uc->timer_idle);
+    }
+
+    // flush any mapping batch the caller forgot to commit, so the release
+    // path below sees a consistent address space
+    while (uc->memory_region_transaction_depth)
+        uc->memory_batch_commit(uc);
+
     if (uc->release)
         uc->release(uc->tcg_ctx);
 
@@ -293,11 +619,19 @@ uc_err uc_close(uc_engine *uc)
         free(uc->bounce.buffer);
     }
 
+    if (uc->perfmap) {
+        fclose(uc->perfmap);
+    }
+
     g_free(uc->tcg_ctx);
 
     free((void*) uc->system_memory->name);
     g_free(uc->system_memory);
-    g_hash_table_destroy(uc->type_table);
+    // a shared type graph outlives this instance: later uc_open() calls
+    // for the same arch attach to it (see type_table_attach())
+    if (!uc->type_table_shared) {
+        g_hash_table_destroy(uc->type_table);
+    }
 
     for (i = 0; i < DIRTY_MEMORY_NUM; i++) {
         free(uc->ram_list.dirty_memory[i]);
@@ -306,22 +640,35 @@ uc_err uc_close(uc_engine *uc)
     // TODO: remove uc->root    (created with object_new())
     uc->root->free(uc->root);
 
-    // free hooks and hook lists
+    // free hooks and hook tables
     for (i = 0; i < UC_HOOK_MAX; i++) {
-        cur = uc->hook[i].head;
-        // hook can be in more than one list
+        // hook can be in more than one table
         // so we refcount to know when to free
-        while (cur) {
-            hook = (struct hook *)cur->data;
+        for (j = 0; j < uc->hook[i].count; j++) {
+            hook = uc->hook[i].items[j];
+            if (--hook->refs == 0) {
+                ufree(uc, hook);
+            }
+        }
+        ufree(uc, uc->hook[i].items);
+    }
+    for (j = 0; j < uc->insn_hooks_size; j++) {
+        uint32_t k;
+        for (k = 0; k < uc->insn_hooks[j].count; k++) {
+            hook = uc->insn_hooks[j].items[k];
             if (--hook->refs == 0) {
-                free(hook);
+                ufree(uc, hook);
             }
-            cur = cur->next;
         }
-        list_clear(&uc->hook[i]);
+        ufree(uc, uc->insn_hooks[j].items);
     }
+    ufree(uc, uc->insn_hooks);
+    ufree(uc, uc->watch);
+
+    free(uc->sample_table);
 
-    free(uc->mapped_blocks);
+    ufree(uc, uc->mapped_blocks);
+    ufree(uc, uc->xlat_pages);
 
     // finally, free uc itself.
     memset(uc, 0, sizeof(*uc));
@@ -330,6 +677,73 @@ uc_err uc_close(uc_engine *uc)
     return UC_ERR_OK;
 }
 
+UNICORN_EXPORT
+uc_err uc_reset(uc_engine *uc)
+{
+    int idx;
+    uint32_t i, j;
+
+    // cannot recycle a running engine
+    if (uc->current_cpu) {
+        return UC_ERR_ARG;
+    }
+
+    // drop any recording or replay before the hook teardown below frees
+    // the replay's internal hooks
+    rr_record_free(uc);
+    rr_replay_free(uc);
+    ckpt_ring_free(uc);
+
+    // drop every hook: marking plus one sweep reuses the uc_hook_del()
+    // reclaim path, including the refcounting across tables
+    for (idx = 0; idx < UC_HOOK_MAX; idx++) {
+        for (i = 0; i < uc->hook[idx].count; i++) {
+            uc->hook[idx].items[i]->deleted = true;
+        }
+    }
+    for (i = 0; i < uc->insn_hooks_size; i++) {
+        for (j = 0; j < uc->insn_hooks[i].count; j++) {
+            uc->insn_hooks[i].items[j]->deleted = true;
+        }
+    }
+    uc->hook_dirty = true;
+    hook_sweep(uc);
+    // drop the TLB_UCHOOK flags cached for the dead memory hooks
+    uc->tlb_flush(uc);
+
+    // unmap all guest memory under one flatview rebuild; the translations
+    // generated from each region die with it
+    uc->memory_batch_begin(uc);
+    while (uc->mapped_block_count) {
+        MemoryRegion *mr = uc->mapped_blocks[uc->mapped_block_count - 1];
+
+        uc->tb_invalidate_range(uc, mr->addr, mr->end);
+        uc->memory_unmap(uc, mr);   // removes mr from uc->mapped_blocks
+    }
+    uc->memory_batch_commit(uc);
+    uc->page_tree_reclaim(uc);
+
+    // architectural registers back to their power-on values
+    uc->reg_reset(uc);
+
+    // per-run state must not leak into the recycled engine
+    {
+        CPUState *cpu;
+
+        CPU_FOREACH(cpu) {
+            cpu->halted = 0;
+            cpu->exception_index = -1;
+            cpu->interrupt_request = 0;
+            cpu->exit_request = 0;
+        }
+    }
+    uc->errnum = UC_ERR_OK;
+    uc->invalid_error = UC_ERR_OK;
+    uc->block_full = false;
+
+    return UC_ERR_OK;
+}
+
 
 UNICORN_EXPORT
 uc_err uc_reg_read(uc_engine *uc, int regid, void *value)
@@ -351,9 +765,55 @@ uc_err uc_reg_write(uc_engine *uc, int regid, const void *value)
     else
         return -1;  // FIXME: need a proper uc_err
 
+    // recording, see uc_record_enable(): mid-run writes come from hook
+    // callbacks and are nondeterministic input. The API does not know the
+    // register's size, so the effective value is read back through a
+    // zeroed buffer and logged with trailing zeroes stripped.
+    if (uc->rr_recording && uc->current_cpu) {
+        uint8_t buf[UC_RR_REG_BUF];
+        uint32_t len = sizeof(buf);
+
+        memset(buf, 0, sizeof(buf));
+        uc->reg_read(uc, regid, buf);
+        while (len > 0 && buf[len - 1] == 0) {
+            len--;
+        }
+        rr_capture(uc, UC_RR_REG, regid, 0, buf, len);
+    }
+
+    return UC_ERR_OK;
+}
+
+
+UNICORN_EXPORT
+uc_err uc_reg_read_batch(uc_engine *uc, int *regs, void **vals, int count)
+{
+    int i;
+
+    if (uc->reg_read == NULL)
+        return -1;  // FIXME: need a proper uc_err
+
+    // one library call for the whole set; the per-arch dispatch still runs
+    // per register, but the API boundary is only crossed once
+    for (i = 0; i < count; i++)
+        uc->reg_read(uc, regs[i], vals[i]);
+
     return UC_ERR_OK;
 }
 
+UNICORN_EXPORT
+uc_err uc_reg_write_batch(uc_engine *uc, int *regs, void *const *vals, int count)
+{
+    int i;
+
+    if (uc->reg_write == NULL)
+        return -1;  // FIXME: need a proper uc_err
+
+    for (i = 0; i < count; i++)
+        uc->reg_write(uc, regs[i], vals[i]);
+
+    return UC_ERR_OK;
+}
 
 // check if a memory area is mapped
 // this is complicated because an area can overlap adjacent blocks
@@ -374,137 +834,419 @@ static bool check_mem_area(uc_engine *uc, uint64_t address, size_t size)
     return (count == size);
 }
 
+// find the run of regions covering [address, address+size)
+// the mapped_blocks array is sorted by start address and regions do not
+// overlap, so after one binary search the rest is a contiguity check on the
+// following entries; @address must have been redirected already
+// returns the index of the first spanned region, or -1 when part of the area
+// is unmapped
+static int memory_mapping_span(uc_engine *uc, uint64_t address, size_t size)
+{
+    size_t count = 0;
+    uint32_t i, first;
 
-UNICORN_EXPORT
-uc_err uc_mem_read(uc_engine *uc, uint64_t address, void *_bytes, size_t size)
+    if (size == 0)  // nothing to cover
+        return 0;
+
+    if (uc->mapped_block_count == 0)
+        return -1;
+
+    first = memory_region_upper_bound(uc, address);
+    if (first == 0)
+        return -1;
+    first--;
+
+    if (address > uc->mapped_blocks[first]->end - 1)
+        return -1;
+
+    for (i = first; count < size; i++) {
+        MemoryRegion *mr;
+        if (i == uc->mapped_block_count)
+            return -1;
+        mr = uc->mapped_blocks[i];
+        if (mr->addr > address)  // gap before this region
+            return -1;
+        count += MIN(size - count, mr->end - address);
+        address = mr->end;
+    }
+
+    return (int)first;
+}
+
+static uc_err mem_read_area(uc_engine *uc, uint64_t address, void *_bytes, size_t size)
 {
     size_t count = 0, len;
     uint8_t *bytes = _bytes;
+    int i;
 
-    if (uc->mem_redirect) {
-        address = uc->mem_redirect(address);
-    }
+    address = uc_mem_redirect(uc, address);
 
-    if (!check_mem_area(uc, address, size))
+    // validate the whole area with a single pass over the region array, then
+    // copy region-by-region without looking each one up again
+    i = memory_mapping_span(uc, address, size);
+    if (i < 0)
         return UC_ERR_READ_UNMAPPED;
 
     // memory area can overlap adjacent memory blocks
     while(count < size) {
-        MemoryRegion *mr = memory_mapping(uc, address);
-        if (mr) {
-            len = MIN(size - count, mr->end - address);
-            if (uc->read_mem(&uc->as, address, bytes, len) == false)
-                break;
-            count += len;
-            address += len;
-            bytes += len;
-        } else  // this address is not mapped in yet
-            break;
+        MemoryRegion *mr = uc->mapped_blocks[i++];
+
+        len = MIN(size - count, mr->end - address);
+        if (uc->read_mem(&uc->as, address, bytes, len) == false)
+            return UC_ERR_READ_UNMAPPED;
+        count += len;
+        address += len;
+        bytes += len;
     }
 
-    if (count == size)
-        return UC_ERR_OK;
-    else
-        return UC_ERR_READ_UNMAPPED;
+    uc->mem_api_bytes += size;
+
+    return UC_ERR_OK;
 }
 
 UNICORN_EXPORT
-uc_err uc_mem_write(uc_engine *uc, uint64_t address, const void *_bytes, size_t size)
+uc_err uc_mem_read(uc_engine *uc, uint64_t address, void *bytes, size_t size)
+{
+    return mem_read_area(uc, address, bytes, size);
+}
+
+static uc_err mem_write_area(uc_engine *uc, uint64_t address, const void *_bytes, size_t size)
 {
     size_t count = 0, len;
     const uint8_t *bytes = _bytes;
+    int i;
 
-    if (uc->mem_redirect) {
-        address = uc->mem_redirect(address);
-    }
+    address = uc_mem_redirect(uc, address);
 
-    if (!check_mem_area(uc, address, size))
+    // validate the whole area before touching guest memory, so a failed call
+    // never leaves a partial write behind
+    i = memory_mapping_span(uc, address, size);
+    if (i < 0)
         return UC_ERR_WRITE_UNMAPPED;
 
     // memory area can overlap adjacent memory blocks
     while(count < size) {
-        MemoryRegion *mr = memory_mapping(uc, address);
-        if (mr) {
-            uint32_t operms = mr->perms;
-            if (!(operms & UC_PROT_WRITE)) // write protected
-                // but this is not the program accessing memory, so temporarily mark writable
-                uc->readonly_mem(mr, false);
+        MemoryRegion *mr = uc->mapped_blocks[i++];
+        uint32_t operms = mr->perms;
 
-            len = MIN(size - count, mr->end - address);
-            if (uc->write_mem(&uc->as, address, bytes, len) == false)
-                break;
+        if (!(operms & UC_PROT_WRITE)) // write protected
+            // but this is not the program accessing memory, so temporarily mark writable
+            uc->readonly_mem(mr, false);
 
-            if (!(operms & UC_PROT_WRITE)) // write protected
-                // now write protect it again
+        len = MIN(size - count, mr->end - address);
+        if (uc->write_mem(&uc->as, address, bytes, len) == false) {
+            if (!(operms & UC_PROT_WRITE))
                 uc->readonly_mem(mr, true);
+            return UC_ERR_WRITE_UNMAPPED;
+        }
 
-            count += len;
-            address += len;
-            bytes += len;
-        } else  // this address is not mapped in yet
-            break;
+        if (!(operms & UC_PROT_WRITE)) // write protected
+            // now write protect it again
+            uc->readonly_mem(mr, true);
+
+        count += len;
+        address += len;
+        bytes += len;
     }
 
-    if (count == size)
-        return UC_ERR_OK;
-    else
-        return UC_ERR_WRITE_UNMAPPED;
+    uc->mem_api_bytes += size;
+
+    return UC_ERR_OK;
 }
 
-#define TIMEOUT_STEP 2    // microseconds
-static void *_timeout_fn(void *arg)
+UNICORN_EXPORT
+uc_err uc_mem_write(uc_engine *uc, uint64_t address, const void *bytes, size_t size)
 {
-    struct uc_struct *uc = arg;
-    int64_t current_time = get_clock();
+    uc_err err = mem_write_area(uc, address, bytes, size);
 
-    do {
-        usleep(TIMEOUT_STEP);
-        // perhaps emulation is even done before timeout?
-        if (uc->emulation_done)
-            break;
-    } while(get_clock() - current_time < uc->timeout);
+    // recording, see uc_record_enable(): mid-run writes come from hook
+    // callbacks and are nondeterministic input
+    if (err == UC_ERR_OK && uc->rr_recording && uc->current_cpu) {
+        rr_capture(uc, UC_RR_MEM, 0, address, bytes, (uint32_t)size);
+    }
 
-    // timeout before emulation is done?
-    if (!uc->emulation_done) {
-        // force emulation to stop
-        uc_emu_stop(uc);
+    return err;
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_read_v(uc_engine *uc, uc_mem_vec *vecs, size_t count)
+{
+    size_t i;
+    uc_err err;
+
+    for (i = 0; i < count; i++) {
+        err = mem_read_area(uc, vecs[i].address, vecs[i].bytes, vecs[i].size);
+        if (err != UC_ERR_OK)
+            return err;
     }
 
-    return NULL;
+    return UC_ERR_OK;
 }
 
-static void enable_emu_timer(uc_engine *uc, uint64_t timeout)
+UNICORN_EXPORT
+uc_err uc_mem_write_v(uc_engine *uc, const uc_mem_vec *vecs, size_t count)
 {
-    uc->timeout = timeout;
-    qemu_thread_create(uc, &uc->timer, "timeout", _timeout_fn,
-            uc, QEMU_THREAD_JOINABLE);
+    size_t i;
+    uc_err err;
+
+    for (i = 0; i < count; i++) {
+        err = mem_write_area(uc, vecs[i].address, vecs[i].bytes, vecs[i].size);
+        if (err != UC_ERR_OK)
+            return err;
+    }
+
+    return UC_ERR_OK;
 }
 
-static void hook_count_cb(struct uc_struct *uc, uint64_t address, uint32_t size, void *user_data)
+UNICORN_EXPORT
+uc_err uc_mem_ptr(uc_engine *uc, uint64_t address, void **ptr, size_t *avail)
 {
-    // count this instruction. ah ah ah.
-    uc->emu_counter++;
+    MemoryRegion *mr;
+    RAMBlock *block;
 
-    if (uc->emu_counter > uc->emu_count)
-        uc_emu_stop(uc);
+    address = uc_mem_redirect(uc, address);
+
+    mr = memory_mapping(uc, address);
+    if (mr == NULL)
+        return UC_ERR_READ_UNMAPPED;
+
+    QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+        if (block->mr == mr) {
+            *ptr = block->host + (address - mr->addr);
+            if (avail)
+                *avail = (size_t)(mr->end - address);
+            return UC_ERR_OK;
+        }
+    }
+
+    // region exists but is not backed by guest RAM
+    return UC_ERR_ARG;
 }
 
 UNICORN_EXPORT
-uc_err uc_emu_start(uc_engine* uc, uint64_t begin, uint64_t until, uint64_t timeout, size_t count)
+uc_err uc_mem_xlat(uc_engine *uc, uc_xlat_table *table)
 {
-    // reset the counter
-    uc->emu_counter = 0;
-    uc->invalid_error = UC_ERR_OK;
-    uc->block_full = false;
-    uc->emulation_done = false;
+    uint64_t pgsz = uc->target_page_size;
+
+    // (re)build the cached table when the mapping topology moved on
+    if (!uc->xlat_valid || uc->xlat_generation != uc->mem_generation) {
+        ufree(uc, uc->xlat_pages);
+        uc->xlat_pages = NULL;
+        uc->xlat_base = 0;
+        uc->xlat_count = 0;
+        uc->xlat_valid = false;
+
+        if (uc->mapped_block_count > 0) {
+            // one entry per page from the lowest to the highest mapping;
+            // mapped_blocks is sorted by start address
+            uint64_t base = uc->mapped_blocks[0]->addr;
+            uint64_t end = uc->mapped_blocks[uc->mapped_block_count - 1]->end;
+            uint64_t npages = (end - base) / pgsz;
+            uint32_t i;
+
+            if (npages > MEM_XLAT_MAX_PAGES) {
+                return UC_ERR_NOMEM;
+            }
+            uc->xlat_pages = uzalloc(uc, (size_t)npages * sizeof(void *));
+            if (uc->xlat_pages == NULL) {
+                return UC_ERR_NOMEM;
+            }
 
-    switch(uc->arch) {
-        default:
-            break;
+            for (i = 0; i < uc->mapped_block_count; i++) {
+                MemoryRegion *mr = uc->mapped_blocks[i];
+                uint8_t *host = NULL;
+                RAMBlock *block;
+                uint64_t a;
 
-        case UC_ARCH_M68K:
-            uc_reg_write(uc, UC_M68K_REG_PC, &begin);
-            break;
+                QTAILQ_FOREACH(block, &uc->ram_list.blocks, next) {
+                    if (block->mr == mr) {
+                        host = block->host;
+                        break;
+                    }
+                }
+                if (host == NULL) {
+                    // MMIO region: leave its pages NULL
+                    continue;
+                }
+                for (a = mr->addr; a < mr->end; a += pgsz) {
+                    uc->xlat_pages[(a - base) / pgsz] = host + (a - mr->addr);
+                }
+            }
+
+            uc->xlat_base = base;
+            uc->xlat_count = npages;
+        }
+
+        uc->xlat_generation = uc->mem_generation;
+        uc->xlat_valid = true;
+    }
+
+    table->base = uc->xlat_base;
+    table->page_size = pgsz;
+    table->page_count = uc->xlat_count;
+    table->generation = uc->xlat_generation;
+    table->pages = uc->xlat_pages;
+
+    return UC_ERR_OK;
+}
+
+// shared tail of uc_emu_start()/uc_emu_continue(): run the vCPU loop until
+// it stops, arming the deadline timer when uc->deadline is set
+static uc_err emu_run(uc_engine *uc)
+{
+    bool timed = (uc->deadline != 0);
+
+    uc->invalid_error = UC_ERR_OK;
+    uc->block_full = false;
+    uc->emulation_done = false;
+    uc->stop_request = false;
+
+    // the deadline is enforced by the timer thread (see timer_worker()), not
+    // by per-block checks in cpu_exec(), so timeout runs keep TB chaining
+    if (timed) {
+        if (!uc->timer_started) {
+            uc_err err = timer_start(uc);
+            if (err != UC_ERR_OK) {
+                return err;
+            }
+        }
+        qemu_sem_post(&uc->timer_arm);
+    }
+
+    if (uc->vm_start(uc)) {
+        // disarm the timer; emulation_done keeps a concurrent firing from
+        // raising a stale stop request
+        uc->emulation_done = true;
+        if (timed) {
+            qemu_sem_post(&uc->timer_cancel);
+            qemu_sem_wait(&uc->timer_idle);
+        }
+        return UC_ERR_RESOURCE;
+    }
+
+    uc->pause_all_vcpus(uc);
+    // emulation is done
+    uc->emulation_done = true;
+
+    // disarm the timer and wait until it is quiescent, so the next run can
+    // never race against this run's deadline
+    if (timed) {
+        qemu_sem_post(&uc->timer_cancel);
+        qemu_sem_wait(&uc->timer_idle);
+    }
+
+    // wait until all asynchronous hook events of this run are delivered
+    if (uc->async_queue) {
+        qemu_mutex_lock(&uc->async_mutex);
+        while (uc->async_tail != uc->async_head) {
+            qemu_cond_wait(&uc->async_space, &uc->async_mutex);
+        }
+        qemu_mutex_unlock(&uc->async_mutex);
+    }
+
+    return uc->invalid_error;
+}
+
+// per-run engine state saved across a nested uc_emu_start() call, so that a
+// hook callback can run a sub-emulation and the suspended run picks up
+// exactly where it left off once the callback returns
+struct emu_frame {
+    size_t emu_count;
+    size_t emu_count_left;
+    uint64_t addr_end;
+    int64_t deadline;
+    uint64_t block_addr;
+    bool block_full;
+    bool stop_request;
+    bool quit_request;
+    bool emulation_done;
+    uint64_t invalid_addr;
+    int invalid_error;
+    CPUState *current_cpu;
+    CPUState *next_cpu;
+    sig_atomic_t exit_request;
+    // per-vCPU state of the suspended run; nesting is limited to a single
+    // vCPU, so one slot is enough
+    struct TranslationBlock *current_tb;
+    uint16_t icount_low;
+    int64_t icount_extra;
+    bool cpu_stop;
+    bool cpu_stopped;
+};
+
+UNICORN_EXPORT
+uc_err uc_emu_start(uc_engine* uc, uint64_t begin, uint64_t until, uint64_t timeout, size_t count)
+{
+    // a non-NULL current_cpu means this call was made from a hook callback
+    // of a run already executing on this thread: suspend that run on the
+    // stack and resume it when the sub-emulation is done
+    CPUState *cpu = uc->current_cpu;
+    bool nested = (cpu != NULL);
+    struct emu_frame frame;
+    uc_err err;
+
+    uc->emu_start_count++;
+    UC_PROBE2(emu_start, begin, until);
+
+    if (nested) {
+        if (uc->nest_depth >= UC_NEST_MAX) {
+            return UC_ERR_RESOURCE;
+        }
+        // the timer thread holds a single deadline per engine and it is
+        // the suspended run's; deterministic icount timeouts fold into the
+        // budget below and stay usable
+        if (timeout != 0 && !uc->timeout_icount) {
+            return UC_ERR_ARG;
+        }
+        // with more vCPUs the round-robin in tcg_exec_all() would advance
+        // all of them mid-callback
+        if (uc->vcpu_count > 1) {
+            return UC_ERR_ARG;
+        }
+
+        frame.emu_count = uc->emu_count;
+        frame.emu_count_left = uc->emu_count_left;
+        frame.addr_end = uc->addr_end;
+        frame.deadline = uc->deadline;
+        frame.block_addr = uc->block_addr;
+        frame.block_full = uc->block_full;
+        frame.stop_request = uc->stop_request;
+        frame.quit_request = uc->quit_request;
+        frame.emulation_done = uc->emulation_done;
+        frame.invalid_addr = uc->invalid_addr;
+        frame.invalid_error = uc->invalid_error;
+        frame.current_cpu = uc->current_cpu;
+        frame.next_cpu = uc->next_cpu;
+        frame.exit_request = uc->exit_request;
+        frame.current_tb = cpu->current_tb;
+        frame.icount_low = cpu->icount_decr.u16.low;
+        frame.icount_extra = cpu->icount_extra;
+        frame.cpu_stop = cpu->stop;
+        frame.cpu_stopped = cpu->stopped;
+
+        // the suspended run resumes into generated code that is live on
+        // the host stack right now; pin its segment so the sub-emulation
+        // cannot evict it (see tb_seg_rotate())
+        uc->nest_ra[uc->nest_depth++] = uc->hook_ra;
+    } else if (uc->hook_dirty) {
+        // no callbacks are in flight here, so hooks deleted since the last
+        // run can be reclaimed and the tables compacted (never done while
+        // nested: the suspended run is iterating these tables)
+        hook_sweep(uc);
+    }
+
+    // The PC write must go through the per-arch reg_write switch, not the
+    // cheaper uc->set_pc store: reg_write carries extra semantics (ARM
+    // interworking derives the Thumb state from bit 0, SPARC keeps npc in
+    // step). Callers resuming where the last run stopped can skip all of
+    // this with uc_emu_continue().
+    switch(uc->arch) {
+        default:
+            break;
+
+        case UC_ARCH_M68K:
+            uc_reg_write(uc, UC_M68K_REG_PC, &begin);
+            break;
 
         case UC_ARCH_X86:
             switch(uc->mode) {
@@ -541,41 +1283,139 @@ uc_err uc_emu_start(uc_engine* uc, uint64_t begin, uint64_t until, uint64_t time
             break;
     }
 
-    uc->stop_request = false;
-
+    // the instruction count budget is emitted inline in the translated
+    // code (see gen_tb_start) and seeded in resume_all_vcpus()
     uc->emu_count = count;
-    // remove count hook if counting isn't necessary
-    if (count <= 0 && uc->count_hook != 0) {
-        uc_hook_del(uc, uc->count_hook);
-        uc->count_hook = 0;
-    }
-    // set up count hook to count instructions.
-    if (count > 0 && uc->count_hook == 0) {
-        uc_err err = uc_hook_add(uc, &uc->count_hook, UC_HOOK_CODE, hook_count_cb, NULL, 1, 0);
-        if (err != UC_ERR_OK) {
-            return err;
+
+    uc->addr_end = until;
+
+    // deterministic timeouts (see uc_icount_timeout()): fold the timeout
+    // into the instruction count budget instead of arming the timer, so a
+    // "timed out" run stops at the same guest instruction on every host
+    if (timeout && uc->timeout_icount) {
+        if (count == 0 || timeout < count) {
+            uc->emu_count = timeout;
         }
+        timeout = 0;
     }
 
-    uc->addr_end = until;
+    if (timeout) {
+        uc->deadline = get_clock() + timeout * 1000;    // microseconds -> nanoseconds
+    } else {
+        uc->deadline = 0;
+    }
 
-    if (uc->vm_start(uc)) {
-        return UC_ERR_RESOURCE;
+    err = emu_run(uc);
+
+    if (nested) {
+        // the sub-emulation consumed the per-run state and parked the vCPU
+        // (pause_all_vcpus()); put everything back so the suspended run
+        // never notices it ran
+        uc->emu_count = frame.emu_count;
+        uc->emu_count_left = frame.emu_count_left;
+        uc->addr_end = frame.addr_end;
+        uc->deadline = frame.deadline;
+        uc->block_addr = frame.block_addr;
+        uc->block_full = frame.block_full;
+        uc->stop_request = frame.stop_request;
+        uc->quit_request = frame.quit_request;
+        uc->emulation_done = frame.emulation_done;
+        uc->invalid_addr = frame.invalid_addr;
+        uc->invalid_error = frame.invalid_error;
+        uc->current_cpu = frame.current_cpu;
+        uc->next_cpu = frame.next_cpu;
+        uc->exit_request = frame.exit_request;
+        cpu->current_tb = frame.current_tb;
+        cpu->icount_decr.u16.low = frame.icount_low;
+        cpu->icount_extra = frame.icount_extra;
+        cpu->stop = frame.cpu_stop;
+        cpu->stopped = frame.cpu_stopped;
+        uc->nest_depth--;
+
+        // a deadline of the suspended run that fired while the
+        // sub-emulation ran was swallowed by it (the timer thread stopped
+        // whatever was executing); re-raise the stop so the timeout still
+        // takes effect
+        if (uc->deadline != 0 && get_clock() >= uc->deadline) {
+            uc_emu_stop(uc);
+        }
     }
 
-    if (timeout)
-        enable_emu_timer(uc, timeout * 1000);   // microseconds -> nanoseconds
+    return err;
+}
 
-    uc->pause_all_vcpus(uc);
-    // emulation is done
-    uc->emulation_done = true;
+UNICORN_EXPORT
+uc_err uc_emu_continue(uc_engine *uc)
+{
+    CPUState *cpu = first_cpu;
 
-    if (timeout) {
-        // wait for the timer to finish
-        qemu_thread_join(&uc->timer);
+    // there must be an earlier, not currently running, uc_emu_start() call:
+    // it initializes the PC, the end address and the budgets carried over here
+    if (cpu == NULL || !cpu->created || uc->current_cpu) {
+        return UC_ERR_ARG;
     }
 
-    return uc->invalid_error;
+    // no callbacks are in flight here, so hooks deleted since the last
+    // run can be reclaimed and the tables compacted
+    if (uc->hook_dirty) {
+        hook_sweep(uc);
+    }
+
+    // resume with whatever was left of the instruction budget when the last
+    // run stopped; resume_all_vcpus() seeds it back into the per-cpu
+    // decrementer. A deadline from the last run stays armed unchanged, so a
+    // continued run never outlives the timeout given to uc_emu_start().
+    if (uc->emu_count > 0) {
+        uc->emu_count = cpu->icount_decr.u16.low + cpu->icount_extra;
+    }
+
+    return emu_run(uc);
+}
+
+UNICORN_EXPORT
+uc_err uc_emu_start_async(uc_engine *uc, uint64_t begin, uint64_t until,
+        uint64_t timeout, size_t count, uc_cb_emu_done_t done,
+        void *user_data)
+{
+    // one run at a time per engine, synchronous or not
+    if (uc->current_cpu || uc->emu_async_active) {
+        return UC_ERR_ARG;
+    }
+
+    if (!uc->emu_worker_started) {
+        uc_err err = emu_worker_start(uc);
+        if (err != UC_ERR_OK) {
+            return err;
+        }
+    }
+
+    uc->emu_async_begin = begin;
+    uc->emu_async_until = until;
+    uc->emu_async_timeout = timeout;
+    uc->emu_async_count = count;
+    uc->emu_async_done = done;
+    uc->emu_async_done_data = user_data;
+    uc->emu_async_err = UC_ERR_OK;
+    uc->emu_async_active = true;
+    qemu_sem_post(&uc->emu_worker_go);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_emu_wait(uc_engine *uc)
+{
+    if (!uc->emu_worker_started) {
+        return UC_ERR_OK;
+    }
+
+    // each run posts the idle semaphore exactly once; consuming a post
+    // from an earlier, already collected run just re-checks the flag
+    while (uc->emu_async_active) {
+        qemu_sem_wait(&uc->emu_worker_idle);
+    }
+
+    return uc->emu_async_err;
 }
 
 
@@ -585,7 +1425,28 @@ uc_err uc_emu_stop(uc_engine *uc)
     if (uc->emulation_done)
         return UC_ERR_OK;
 
+    UC_PROBE0(emu_stop);
+
+    // recording, see uc_record_enable(): a stop raised mid-run (callback
+    // or deadline timer) ends the run at a nondeterministic point; log it
+    // so the replay ends at the same instruction
+    if (uc->rr_recording && uc->current_cpu) {
+        rr_capture(uc, UC_RR_STOP, 0, 0, NULL, 0);
+    }
+
     uc->stop_request = true;
+
+    // Raise the engine-wide exit request as well. cpu_exec() only publishes
+    // uc->current_cpu after it has started running, so a stop issued from
+    // another thread in that window would miss cpu_exit() below. cpu_exec()
+    // samples uc->exit_request right after publishing current_cpu (behind an
+    // smp_mb() that pairs with this one), so one of the two paths is always
+    // taken and stop latency stays bounded by a single translated block:
+    // every TB begins with a tcg_exit_req check (see gen_tb_start), and
+    // chained TBs jump to tc_ptr which includes that prologue.
+    uc->exit_request = 1;
+    smp_mb();
+
     if (uc->current_cpu) {
         // exit the current TB
         cpu_exit(uc->current_cpu);
@@ -594,25 +1455,82 @@ uc_err uc_emu_stop(uc_engine *uc)
     return UC_ERR_OK;
 }
 
+UNICORN_EXPORT
+uc_err uc_vcpu_create(uc_engine *uc, int *vcpu_id)
+{
+    if (uc->current_cpu) {
+        // never while emulation is running
+        return UC_ERR_ARG;
+    }
+    if (uc->vcpu_add == NULL) {
+        return UC_ERR_ARCH;
+    }
+    if (uc->vcpu_add(uc)) {
+        return UC_ERR_RESOURCE;
+    }
+    uc->vcpu_count++;
+    if (vcpu_id) {
+        // cpu_exec_init() numbers vCPUs by creation order
+        *vcpu_id = uc->vcpu_count - 1;
+    }
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_vcpu_select(uc_engine *uc, int vcpu_id)
+{
+    CPUState *cpu;
+
+    CPU_FOREACH(cpu) {
+        if (cpu->cpu_index == vcpu_id) {
+            uc->cpu_sel = cpu;
+            return UC_ERR_OK;
+        }
+    }
+    return UC_ERR_ARG;
+}
+
+UNICORN_EXPORT
+uc_err uc_vcpu_quantum(uc_engine *uc, uint32_t insns)
+{
+    // the slice lives in the 16-bit icount decrementer (see gen_tb_start)
+    if (insns == 0 || insns > 0xffff) {
+        return UC_ERR_ARG;
+    }
+    uc->vcpu_quantum = insns;
+    return UC_ERR_OK;
+}
+
+// find the index of the first region whose start address is > @address, i.e.
+// the insertion point that keeps uc->mapped_blocks sorted by start address
+static uint32_t memory_region_upper_bound(struct uc_struct *uc, uint64_t address)
+{
+    uint32_t lo = 0, hi = uc->mapped_block_count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (uc->mapped_blocks[mid]->addr <= address)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
 // find if a memory range overlaps with existing mapped regions
 static bool memory_overlap(struct uc_struct *uc, uint64_t begin, size_t size)
 {
-    unsigned int i;
     uint64_t end = begin + size - 1;
+    uint32_t i = memory_region_upper_bound(uc, begin);
 
-    for(i = 0; i < uc->mapped_block_count; i++) {
-        // begin address falls inside this region?
-        if (begin >= uc->mapped_blocks[i]->addr && begin <= uc->mapped_blocks[i]->end - 1)
-            return true;
-
-        // end address falls inside this region?
-        if (end >= uc->mapped_blocks[i]->addr && end <= uc->mapped_blocks[i]->end - 1)
-            return true;
+    // does the closest region below us span past begin?
+    if (i > 0 && begin <= uc->mapped_blocks[i - 1]->end - 1)
+        return true;
 
-        // this region falls totally inside this range?
-        if (begin < uc->mapped_blocks[i]->addr && end > uc->mapped_blocks[i]->end - 1)
-            return true;
-    }
+    // does the next region start within the range?
+    if (i < uc->mapped_block_count && uc->mapped_blocks[i]->addr <= end)
+        return true;
 
     // not found
     return false;
@@ -622,21 +1540,32 @@ static bool memory_overlap(struct uc_struct *uc, uint64_t begin, size_t size)
 static uc_err mem_map(uc_engine *uc, uint64_t address, size_t size, uint32_t perms, MemoryRegion *block)
 {
     MemoryRegion **regions;
+    uint32_t i;
 
     if (block == NULL)
         return UC_ERR_NOMEM;
 
-    if ((uc->mapped_block_count & (MEM_BLOCK_INCR - 1)) == 0) {  //time to grow
-        regions = (MemoryRegion**)realloc(uc->mapped_blocks,
-                sizeof(MemoryRegion*) * (uc->mapped_block_count + MEM_BLOCK_INCR));
+    if (uc->mapped_block_count == uc->mapped_block_capacity) {  //time to grow
+        uint32_t capacity = uc->mapped_block_capacity?
+            uc->mapped_block_capacity * 2 : MEM_BLOCK_INCR;
+        regions = (MemoryRegion**)urealloc(uc, uc->mapped_blocks,
+                sizeof(MemoryRegion*) * uc->mapped_block_capacity,
+                sizeof(MemoryRegion*) * capacity);
         if (regions == NULL) {
             return UC_ERR_NOMEM;
         }
         uc->mapped_blocks = regions;
+        uc->mapped_block_capacity = capacity;
     }
 
-    uc->mapped_blocks[uc->mapped_block_count] = block;
+    // insert in place, keeping the array sorted by start address
+    // so memory_mapping() can binary search it
+    i = memory_region_upper_bound(uc, block->addr);
+    memmove(&uc->mapped_blocks[i + 1], &uc->mapped_blocks[i],
+            sizeof(MemoryRegion*) * (uc->mapped_block_count - i));
+    uc->mapped_blocks[i] = block;
     uc->mapped_block_count++;
+    uc->mem_generation++;   // invalidates e.g. the uc_mem_xlat() table
 
     return UC_ERR_OK;
 }
@@ -676,15 +1605,18 @@ uc_err uc_mem_map(uc_engine *uc, uint64_t address, size_t size, uint32_t perms)
 {
     uc_err res;
 
-    if (uc->mem_redirect) {
-        address = uc->mem_redirect(address);
-    }
+    address = uc_mem_redirect(uc, address);
 
-    res = mem_map_check(uc, address, size, perms);
+    // backing hints are not permissions - strip them for the permission
+    // check and let memory_map() consume them
+    res = mem_map_check(uc, address, size,
+            perms & ~(UC_MEM_HUGEPAGE | UC_MEM_MERGEABLE));
     if (res)
         return res;
 
-    return mem_map(uc, address, size, perms, uc->memory_map(uc, address, size, perms));
+    UC_PROBE3(mem_map, address, size, perms);
+    return mem_map(uc, address, size, perms & UC_PROT_ALL,
+            uc->memory_map(uc, address, size, perms));
 }
 
 UNICORN_EXPORT
@@ -695,9 +1627,7 @@ uc_err uc_mem_map_ptr(uc_engine *uc, uint64_t address, size_t size, uint32_t per
     if (ptr == NULL)
         return UC_ERR_ARG;
 
-    if (uc->mem_redirect) {
-        address = uc->mem_redirect(address);
-    }
+    address = uc_mem_redirect(uc, address);
 
     res = mem_map_check(uc, address, size, perms);
     if (res)
@@ -706,27 +1636,346 @@ uc_err uc_mem_map_ptr(uc_engine *uc, uint64_t address, size_t size, uint32_t per
     return mem_map(uc, address, size, UC_PROT_ALL, uc->memory_map_ptr(uc, address, size, perms, ptr));
 }
 
-// Create a backup copy of the indicated MemoryRegion.
-// Generally used in prepartion for splitting a MemoryRegion.
-static uint8_t *copy_region(struct uc_struct *uc, MemoryRegion *mr)
+UNICORN_EXPORT
+uc_err uc_mem_map_file(uc_engine *uc, uint64_t address, const char *path,
+        uint64_t offset, size_t size, uint32_t perms)
 {
-    uint8_t *block = (uint8_t *)malloc(int128_get64(mr->size));
-    if (block != NULL) {
-        uc_err err = uc_mem_read(uc, mr->addr, block, int128_get64(mr->size));
-        if (err != UC_ERR_OK) {
-            free(block);
-            block = NULL;
+#ifndef _WIN32
+    uc_err res;
+    MemoryRegion *mr;
+    void *ptr;
+    int fd;
+
+    if (path == NULL)
+        return UC_ERR_ARG;
+
+    // the file offset must be page aligned for mmap()
+    if ((offset & uc->target_page_align) != 0)
+        return UC_ERR_ARG;
+
+    address = uc_mem_redirect(uc, address);
+
+    res = mem_map_check(uc, address, size, perms);
+    if (res)
+        return res;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return UC_ERR_RESOURCE;
+
+    // map privately so guest writes stay copy-on-write in this instance
+    // while clean pages remain shared through the page cache; mapping the
+    // file lazily also means untouched pages are never read at all
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t)offset);
+    close(fd);
+    if (ptr == MAP_FAILED)
+        return UC_ERR_NOMEM;
+
+    mr = uc->memory_map_ptr(uc, address, size, perms, ptr);
+    if (mr == NULL) {
+        munmap(ptr, size);
+        return UC_ERR_NOMEM;
+    }
+
+    // the engine owns this mapping: qemu_ram_free() must munmap it when the
+    // region goes away
+    uc->ram_set_owned(uc, mr);
+
+    return mem_map(uc, address, size, UC_PROT_ALL, mr);
+#else
+    // no mmap() on Windows
+    return UC_ERR_RESOURCE;
+#endif
+}
+
+// uc_save_file()/uc_restore_file() image layout: header, region table and
+// CPU context up front, then one aligned payload of guest RAM per region.
+// The payloads are laid out so a restoring worker maps them straight out
+// of the page cache instead of parsing and copying them.
+#define UC_IMAGE_MAGIC   0x0030474d49434e55ULL  // "UNCIMG0"
+#define UC_IMAGE_VERSION 1
+// payload alignment: generous enough that the file still mmap()s on
+// hosts whose pages are larger than the 4KB target page
+#define UC_IMAGE_ALIGN   65536
+
+struct uc_image_header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t arch;
+    uint32_t mode;
+    uint32_t region_count;
+    uint64_t context_size;  // CPU context blob, right after the table
+};
+
+struct uc_image_region {
+    uint64_t address;
+    uint64_t size;
+    uint64_t offset;    // payload position in the file, UC_IMAGE_ALIGN aligned
+    uint32_t perms;
+    uint32_t pad;
+};
+
+UNICORN_EXPORT
+uc_err uc_save_file(uc_engine *uc, const char *path)
+{
+#ifndef _WIN32
+    struct uc_image_header hdr;
+    struct uc_image_region *tab;
+    FILE *f;
+    uint8_t *chunk;
+    uint64_t off;
+    uint32_t i;
+    size_t n;
+
+    if (path == NULL)
+        return UC_ERR_ARG;
+
+    // the image captures a quiescent engine; refuse mid-emulation
+    if (uc->current_cpu)
+        return UC_ERR_ARG;
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = UC_IMAGE_MAGIC;
+    hdr.version = UC_IMAGE_VERSION;
+    hdr.arch = uc->arch;
+    hdr.mode = uc->mode;
+    hdr.region_count = uc->mapped_block_count;
+    hdr.context_size = uc->cpu_context_size;
+
+    tab = calloc(uc->mapped_block_count ? uc->mapped_block_count : 1,
+            sizeof(*tab));
+    chunk = malloc(UC_IMAGE_ALIGN);
+    if (tab == NULL || chunk == NULL) {
+        free(tab);
+        free(chunk);
+        return UC_ERR_NOMEM;
+    }
+
+    off = sizeof(hdr) + (uint64_t)uc->mapped_block_count * sizeof(*tab) +
+            hdr.context_size;
+    for (i = 0; i < uc->mapped_block_count; i++) {
+        MemoryRegion *mr = uc->mapped_blocks[i];
+
+        off = (off + UC_IMAGE_ALIGN - 1) & ~(uint64_t)(UC_IMAGE_ALIGN - 1);
+        tab[i].address = mr->addr;
+        tab[i].size = mr->end - mr->addr;
+        tab[i].offset = off;
+        tab[i].perms = mr->perms;
+        off += tab[i].size;
+    }
+
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        free(tab);
+        free(chunk);
+        return UC_ERR_RESOURCE;
+    }
+
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+        (uc->mapped_block_count != 0 &&
+         fwrite(tab, sizeof(*tab), uc->mapped_block_count, f) !=
+                uc->mapped_block_count) ||
+        fwrite(first_cpu->env_ptr, 1, hdr.context_size, f) !=
+                hdr.context_size) {
+        goto fail;
+    }
+
+    for (i = 0; i < uc->mapped_block_count; i++) {
+        uint64_t addr = tab[i].address, left = tab[i].size;
+
+        if (fseeko(f, (off_t)tab[i].offset, SEEK_SET) != 0)
+            goto fail;
+        while (left > 0) {
+            n = (size_t)MIN(left, (uint64_t)UC_IMAGE_ALIGN);
+            if (uc_mem_read(uc, addr, chunk, n) != UC_ERR_OK ||
+                    fwrite(chunk, 1, n, f) != n)
+                goto fail;
+            addr += n;
+            left -= n;
+        }
+    }
+
+    free(tab);
+    free(chunk);
+    if (fclose(f) != 0)
+        return UC_ERR_RESOURCE;
+    return UC_ERR_OK;
+
+fail:
+    fclose(f);
+    free(tab);
+    free(chunk);
+    return UC_ERR_RESOURCE;
+#else
+    // no mmap() on the restore side on Windows
+    return UC_ERR_RESOURCE;
+#endif
+}
+
+UNICORN_EXPORT
+uc_err uc_restore_file(uc_engine *uc, const char *path)
+{
+#ifndef _WIN32
+    struct uc_image_header hdr;
+    struct uc_image_region *tab = NULL;
+    uint8_t *ctx = NULL;
+    struct stat st;
+    MemoryRegion *mr;
+    FILE *f;
+    void *ptr;
+    uint64_t end;
+    uint32_t i, mapped = 0;
+    uc_err err = UC_ERR_RESOURCE;
+
+    if (path == NULL)
+        return UC_ERR_ARG;
+    if (uc->current_cpu)
+        return UC_ERR_ARG;
+
+    f = fopen(path, "rb");
+    if (f == NULL)
+        return UC_ERR_RESOURCE;
+
+    if (fstat(fileno(f), &st) != 0 ||
+            fread(&hdr, sizeof(hdr), 1, f) != 1)
+        goto out;
+    err = UC_ERR_ARG;
+    if (hdr.magic != UC_IMAGE_MAGIC || hdr.version != UC_IMAGE_VERSION ||
+        hdr.arch != (uint32_t)uc->arch || hdr.mode != (uint32_t)uc->mode ||
+        hdr.context_size != uc->cpu_context_size ||
+        hdr.region_count > (uint64_t)st.st_size / sizeof(*tab))
+        goto out;
+
+    tab = calloc(hdr.region_count ? hdr.region_count : 1, sizeof(*tab));
+    ctx = malloc(hdr.context_size);
+    if (tab == NULL || ctx == NULL) {
+        err = UC_ERR_NOMEM;
+        goto out;
+    }
+    err = UC_ERR_RESOURCE;
+    if ((hdr.region_count != 0 &&
+         fread(tab, sizeof(*tab), hdr.region_count, f) != hdr.region_count) ||
+        fread(ctx, 1, hdr.context_size, f) != hdr.context_size)
+        goto out;
+
+    for (i = 0; i < hdr.region_count; i++) {
+        err = UC_ERR_ARG;
+        end = tab[i].offset + tab[i].size;
+        if ((tab[i].offset & (UC_IMAGE_ALIGN - 1)) != 0 ||
+                end < tab[i].offset || end > (uint64_t)st.st_size)
+            goto unmap;
+        err = mem_map_check(uc, tab[i].address, (size_t)tab[i].size,
+                tab[i].perms);
+        if (err != UC_ERR_OK)
+            goto unmap;
+
+        // map the payload straight from the file: private, so guest
+        // writes stay copy-on-write in this instance, and lazy, so pages
+        // the workload never touches are never read at all
+        ptr = mmap(NULL, (size_t)tab[i].size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE, fileno(f), (off_t)tab[i].offset);
+        if (ptr == MAP_FAILED) {
+            err = UC_ERR_NOMEM;
+            goto unmap;
+        }
+        mr = uc->memory_map_ptr(uc, tab[i].address, (size_t)tab[i].size,
+                tab[i].perms, ptr);
+        if (mr == NULL) {
+            munmap(ptr, (size_t)tab[i].size);
+            err = UC_ERR_NOMEM;
+            goto unmap;
         }
+        // the engine owns this mapping: qemu_ram_free() must munmap it
+        // when the region goes away
+        uc->ram_set_owned(uc, mr);
+        err = mem_map(uc, tab[i].address, (size_t)tab[i].size, UC_PROT_ALL,
+                mr);
+        if (err != UC_ERR_OK)
+            goto unmap;
+        mapped = i + 1;
+    }
+
+    // same boundary as uc_context_restore()
+    memcpy(first_cpu->env_ptr, ctx, hdr.context_size);
+    err = UC_ERR_OK;
+    goto out;
+
+unmap:
+    // put the engine back the way it was
+    for (i = 0; i < mapped; i++) {
+        uc_mem_unmap(uc, tab[i].address, (size_t)tab[i].size);
     }
+out:
+    // the established mappings keep the file referenced on their own
+    fclose(f);
+    free(tab);
+    free(ctx);
+    return err;
+#else
+    // no mmap() on Windows
+    return UC_ERR_RESOURCE;
+#endif
+}
+
+UNICORN_EXPORT
+uc_err uc_mmio_map(uc_engine *uc, uint64_t address, size_t size,
+        uc_cb_mmio_read_t read_cb, void *user_data_read,
+        uc_cb_mmio_write_t write_cb, void *user_data_write)
+{
+    uc_err res;
+
+    address = uc_mem_redirect(uc, address);
+
+    res = mem_map_check(uc, address, size, UC_PROT_ALL);
+    if (res)
+        return res;
+
+    // the region's effective permissions follow from the callbacks given;
+    // accesses dispatch through the native IO path, not through RAM
+    return mem_map(uc, address, size, UC_PROT_ALL,
+            uc->memory_map_io(uc, address, size, read_cb, write_cb,
+                user_data_read, user_data_write));
+}
+
+// Remap one kept piece of a split region and restore its contents and, when
+// the original region had one, its slice of the per-page permission table.
+// @page_perms points at the entries for this piece, or is NULL.
+static bool remap_piece(struct uc_struct *uc, uint64_t begin, size_t size,
+        uint32_t perms, const uint8_t *data, const uint8_t *page_perms,
+        uint64_t page_size)
+{
+    MemoryRegion *mr;
+    uint64_t npages, i;
+    uint32_t uperms;
+
+    if (uc_mem_map(uc, begin, size, perms) != UC_ERR_OK)
+        return false;
+    if (uc_mem_write(uc, begin, data, size) != UC_ERR_OK)
+        return false;
 
-    return block;
+    if (page_perms == NULL)
+        return true;
+
+    // carry the per-page overrides from uc_mem_protect() over
+    mr = memory_mapping(uc, begin);
+    npages = size / page_size;
+    mr->page_perms = g_malloc(npages);
+    memcpy(mr->page_perms, page_perms, npages);
+    uperms = 0;
+    for (i = 0; i < npages; i++)
+        uperms |= mr->page_perms[i];
+    mr->perms = uperms;
+    uc->readonly_mem(mr, (uperms & UC_PROT_WRITE) == 0);
+
+    return true;
 }
 
 /*
    Split the given MemoryRegion at the indicated address for the indicated size
    this may result in the create of up to 3 spanning sections. If the delete
    parameter is true, the no new section will be created to replace the indicate
-   range. This functions exists to support uc_mem_protect and uc_mem_unmap.
+   range. This functions exists to support uc_mem_unmap. (uc_mem_protect
+   changes permissions in place via a per-page table and never splits.)
 
    This is a static function and callers have already done some preliminary
    parameter validation.
@@ -740,10 +1989,10 @@ static uint8_t *copy_region(struct uc_struct *uc, MemoryRegion *mr)
 static bool split_region(struct uc_struct *uc, MemoryRegion *mr, uint64_t address,
         size_t size, bool do_delete)
 {
-    uint8_t *backup;
+    uint8_t *backup = NULL, *old_pp = NULL;
     uint32_t perms;
-    uint64_t begin, end, chunk_end;
-    size_t l_size, m_size, r_size;
+    uint64_t begin, end, chunk_end, ps;
+    size_t l_size, m_size, r_size, keep;
 
     chunk_end = address + size;
 
@@ -760,18 +2009,16 @@ static bool split_region(struct uc_struct *uc, MemoryRegion *mr, uint64_t addres
         // impossible case
         return false;
 
-    backup = copy_region(uc, mr);
-    if (backup == NULL)
+    if (!mr->ram)
+        // MMIO regions have no contents to carve up; they can only be
+        // unmapped as a whole (handled by the early-out above)
         return false;
 
     // save the essential information required for the split before mr gets deleted
     perms = mr->perms;
     begin = mr->addr;
     end = mr->end;
-
-    // unmap this region first, then do split it later
-    if (uc_mem_unmap(uc, mr->addr, int128_get64(mr->size)) != UC_ERR_OK)
-        goto error;
+    ps = uc->target_page_size;
 
     /* overlapping cases
      *               |------mr------|
@@ -791,35 +2038,57 @@ static bool split_region(struct uc_struct *uc, MemoryRegion *mr, uint64_t addres
     r_size = (size_t)(end - chunk_end);
     m_size = (size_t)(chunk_end - address);
 
-    // If there are error in any of the below operations, things are too far gone
-    // at that point to recover. Could try to remap orignal region, but these smaller
-    // allocation just failed so no guarantee that we can recover the original
-    // allocation at this point
-    if (l_size > 0) {
-        if (uc_mem_map(uc, begin, l_size, perms) != UC_ERR_OK)
-            goto error;
-        if (uc_mem_write(uc, begin, backup, l_size) != UC_ERR_OK)
-            goto error;
-    }
+    // back up only the pieces that get remapped below: when deleting, the
+    // middle is never copied, so carving a hole out of a large, sparsely
+    // touched region does not fault the whole region in
+    keep = l_size + r_size + (do_delete? 0 : m_size);
+    backup = malloc(keep);
+    if (backup == NULL)
+        return false;
 
-    if (m_size > 0 && !do_delete) {
-        if (uc_mem_map(uc, address, m_size, perms) != UC_ERR_OK)
-            goto error;
-        if (uc_mem_write(uc, address, backup + l_size, m_size) != UC_ERR_OK)
-            goto error;
-    }
+    if (l_size > 0 && uc_mem_read(uc, begin, backup, l_size) != UC_ERR_OK)
+        goto error;
+    if (m_size > 0 && !do_delete
+            && uc_mem_read(uc, address, backup + l_size, m_size) != UC_ERR_OK)
+        goto error;
+    if (r_size > 0
+            && uc_mem_read(uc, chunk_end, backup + keep - r_size, r_size) != UC_ERR_OK)
+        goto error;
 
-    if (r_size > 0) {
-        if (uc_mem_map(uc, chunk_end, r_size, perms) != UC_ERR_OK)
-            goto error;
-        if (uc_mem_write(uc, chunk_end, backup + l_size + m_size, r_size) != UC_ERR_OK)
-            goto error;
+    // also preserve any per-page permission overrides (uc_mem_protect)
+    if (mr->page_perms != NULL) {
+        old_pp = g_malloc((size_t)((end - begin) / ps));
+        memcpy(old_pp, mr->page_perms, (size_t)((end - begin) / ps));
     }
 
+    // unmap this region first, then do split it later
+    if (uc_mem_unmap(uc, begin, (size_t)(end - begin)) != UC_ERR_OK)
+        goto error;
+
+    // If there are error in any of the below operations, things are too far gone
+    // at that point to recover. Could try to remap orignal region, but these smaller
+    // allocation just failed so no guarantee that we can recover the original
+    // allocation at this point
+    if (l_size > 0 && !remap_piece(uc, begin, l_size, perms,
+            backup, old_pp, ps))
+        goto error;
+
+    if (m_size > 0 && !do_delete && !remap_piece(uc, address, m_size, perms,
+            backup + l_size, old_pp? old_pp + l_size / ps : NULL, ps))
+        goto error;
+
+    if (r_size > 0 && !remap_piece(uc, chunk_end, r_size, perms,
+            backup + keep - r_size,
+            old_pp? old_pp + (size_t)((chunk_end - begin) / ps) : NULL, ps))
+        goto error;
+
+    free(backup);
+    g_free(old_pp);
     return true;
 
 error:
     free(backup);
+    g_free(old_pp);
     return false;
 }
 
@@ -847,40 +2116,84 @@ uc_err uc_mem_protect(struct uc_struct *uc, uint64_t address, size_t size, uint3
     if ((perms & ~UC_PROT_ALL) != 0)
         return UC_ERR_ARG;
 
-    if (uc->mem_redirect) {
-        address = uc->mem_redirect(address);
-    }
+    address = uc_mem_redirect(uc, address);
 
     // check that user's entire requested block is mapped
     if (!check_mem_area(uc, address, size))
         return UC_ERR_NOMEM;
 
-    // Now we know entire region is mapped, so change permissions
-    // We may need to split regions if this area spans adjacent regions
+    UC_PROBE3(mem_protect, address, size, perms);
+
+    // Now we know entire region is mapped, so change permissions.
+    // Regions are never split (or copied) for this: partial changes go into
+    // a per-page permission table on the region, which the softmmu helpers
+    // and tlb_set_page() consult, so protecting one page of a large region
+    // costs O(pages of that region), not a copy of its contents.
     addr = address;
     count = 0;
     while(count < size) {
+        uint64_t npages, first, pages, i;
+
         mr = memory_mapping(uc, addr);
         len = MIN(size - count, mr->end - addr);
-        if (!split_region(uc, mr, addr, len, false))
-            return UC_ERR_NOMEM;
 
-        mr = memory_mapping(uc, addr);
-        // will this remove EXEC permission?
-        if (((mr->perms & UC_PROT_EXEC) != 0) && ((perms & UC_PROT_EXEC) == 0))
-            remove_exec = true;
-        mr->perms = perms;
-        uc->readonly_mem(mr, (perms & UC_PROT_WRITE) == 0);
+        if (!mr->ram)
+            // MMIO permissions are fixed by the callbacks given at map time
+            return UC_ERR_ARG;
+
+        if (addr == mr->addr && len == int128_get64(mr->size)) {
+            // whole region changed: drop any per-page table and go back to
+            // the uniform representation
+            if (mr->page_perms != NULL) {
+                g_free(mr->page_perms);
+                mr->page_perms = NULL;
+            }
+            // will this remove EXEC permission?
+            if (((mr->perms & UC_PROT_EXEC) != 0) && ((perms & UC_PROT_EXEC) == 0))
+                remove_exec = true;
+            mr->perms = perms;
+            uc->readonly_mem(mr, (perms & UC_PROT_WRITE) == 0);
+        } else {
+            uint32_t uperms;
+
+            npages = int128_get64(mr->size) / uc->target_page_size;
+            if (mr->page_perms == NULL) {
+                mr->page_perms = g_malloc(npages);
+                memset(mr->page_perms, mr->perms, npages);
+            }
+
+            first = (addr - mr->addr) / uc->target_page_size;
+            pages = len / uc->target_page_size;
+            for (i = first; i < first + pages; i++) {
+                // will this remove EXEC permission?
+                if (((mr->page_perms[i] & UC_PROT_EXEC) != 0) && ((perms & UC_PROT_EXEC) == 0))
+                    remove_exec = true;
+                mr->page_perms[i] = (uint8_t)perms;
+            }
+
+            // the region-wide perms become the union of the page perms, and
+            // the readonly fast path only stays on while no page is
+            // writable; per-page enforcement happens on the slow path
+            uperms = 0;
+            for (i = 0; i < npages; i++)
+                uperms |= mr->page_perms[i];
+            mr->perms = uperms;
+            uc->readonly_mem(mr, (uperms & UC_PROT_WRITE) == 0);
+        }
 
         count += len;
         addr += len;
     }
 
-    // if EXEC permission is removed, then quit TB and continue at the same place
-    if (remove_exec) {
-        uc->quit_request = true;
-        uc_emu_stop(uc);
-    }
+    // drop only the cached TLB entries of the affected pages so the new
+    // permissions take effect; warm entries elsewhere survive
+    uc->tlb_flush_range(uc, address, address + size);
+
+    // if EXEC permission is removed, drop only the TBs translated from the
+    // affected pages; emulation continues in place, and the next fetch from
+    // these pages goes through the NX check in the softmmu helper
+    if (remove_exec)
+        uc->tb_invalidate_range(uc, address, address + size);
 
     return UC_ERR_OK;
 }
@@ -904,14 +2217,14 @@ uc_err uc_mem_unmap(struct uc_struct *uc, uint64_t address, size_t size)
     if ((size & uc->target_page_align) != 0)
         return UC_ERR_MAP;
 
-    if (uc->mem_redirect) {
-        address = uc->mem_redirect(address);
-    }
+    address = uc_mem_redirect(uc, address);
 
     // check that user's entire requested block is mapped
     if (!check_mem_area(uc, address, size))
         return UC_ERR_NOMEM;
 
+    UC_PROBE2(mem_unmap, address, size);
+
     // Now we know entire region is mapped, so do the unmap
     // We may need to split regions if this area spans adjacent regions
     addr = address;
@@ -919,6 +2232,11 @@ uc_err uc_mem_unmap(struct uc_struct *uc, uint64_t address, size_t size)
     while(count < size) {
         mr = memory_mapping(uc, addr);
         len = MIN(size - count, mr->end - addr);
+
+        // drop the TBs of the whole region being touched: its ram offsets
+        // die with the region and may be recycled by the next mapping
+        uc->tb_invalidate_range(uc, mr->addr, mr->end);
+
         if (!split_region(uc, mr, addr, len, true))
             return UC_ERR_NOMEM;
 
@@ -931,47 +2249,406 @@ uc_err uc_mem_unmap(struct uc_struct *uc, uint64_t address, size_t size)
         addr += len;
     }
 
+    // the descriptors of the invalidated pages are empty now; give the
+    // unused parts of the page tree back to the allocator
+    uc->page_tree_reclaim(uc);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_decommit(uc_engine *uc, uint64_t address, size_t size)
+{
+    size_t count = 0, len;
+    MemoryRegion *mr;
+    int i;
+
+    if (size == 0)
+        // trivial case
+        return UC_ERR_OK;
+
+    // address must be aligned to uc->target_page_size
+    if ((address & uc->target_page_align) != 0)
+        return UC_ERR_ARG;
+
+    // size must be multiple of uc->target_page_size
+    if ((size & uc->target_page_align) != 0)
+        return UC_ERR_ARG;
+
+    address = uc_mem_redirect(uc, address);
+
+    i = memory_mapping_span(uc, address, size);
+    if (i < 0)
+        return UC_ERR_NOMEM;
+
+    // dropped pages may hold code that has been translated already
+    uc->tb_invalidate_range(uc, address, address + size);
+
+    while (count < size) {
+        mr = uc->mapped_blocks[i++];
+        len = MIN(size - count, mr->end - address);
+        uc->memory_decommit(uc, mr, address, len);
+        count += len;
+        address += len;
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_dirty(uc_engine *uc, uint64_t address, size_t size, uint8_t *bitmap)
+{
+    size_t count = 0, len;
+    MemoryRegion *mr;
+    int i;
+
+    if (size == 0)
+        // trivial case
+        return UC_ERR_OK;
+
+    if (bitmap == NULL)
+        return UC_ERR_ARG;
+
+    // address must be aligned to uc->target_page_size
+    if ((address & uc->target_page_align) != 0)
+        return UC_ERR_ARG;
+
+    // size must be multiple of uc->target_page_size
+    if ((size & uc->target_page_align) != 0)
+        return UC_ERR_ARG;
+
+    address = uc_mem_redirect(uc, address);
+
+    i = memory_mapping_span(uc, address, size);
+    if (i < 0)
+        return UC_ERR_NOMEM;
+
+    memset(bitmap, 0, (size / uc->target_page_size + 7) / 8);
+
+    while (count < size) {
+        mr = uc->mapped_blocks[i++];
+        len = MIN(size - count, mr->end - address);
+        uc->memory_dirty_query(uc, mr, address, len,
+                bitmap, count / uc->target_page_size);
+        count += len;
+        address += len;
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_dirty_reset(uc_engine *uc, uint64_t address, size_t size)
+{
+    size_t count = 0, len;
+    MemoryRegion *mr;
+    int i;
+
+    if (size == 0)
+        // trivial case
+        return UC_ERR_OK;
+
+    // address must be aligned to uc->target_page_size
+    if ((address & uc->target_page_align) != 0)
+        return UC_ERR_ARG;
+
+    // size must be multiple of uc->target_page_size
+    if ((size & uc->target_page_align) != 0)
+        return UC_ERR_ARG;
+
+    address = uc_mem_redirect(uc, address);
+
+    i = memory_mapping_span(uc, address, size);
+    if (i < 0)
+        return UC_ERR_NOMEM;
+
+    while (count < size) {
+        mr = uc->mapped_blocks[i++];
+        len = MIN(size - count, mr->end - address);
+        uc->memory_dirty_reset(uc, mr, address, len);
+        count += len;
+        address += len;
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_batch_begin(uc_engine *uc)
+{
+    uc->memory_batch_begin(uc);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_batch_commit(uc_engine *uc)
+{
+    // committing without an open batch would trip the assert in
+    // memory_region_transaction_commit()
+    if (uc->memory_region_transaction_depth == 0)
+        return UC_ERR_ARG;
+
+    uc->memory_batch_commit(uc);
+
     return UC_ERR_OK;
 }
 
 // find the memory region of this address
 MemoryRegion *memory_mapping(struct uc_struct* uc, uint64_t address)
 {
-    unsigned int i;
+    uint32_t i;
 
     if (uc->mapped_block_count == 0)
         return NULL;
 
-    if (uc->mem_redirect) {
-        address = uc->mem_redirect(address);
+    address = uc_mem_redirect(uc, address);
+
+    // the array is sorted by start address, so binary search for the
+    // closest region at or below address
+    i = memory_region_upper_bound(uc, address);
+    if (i == 0)
+        return NULL;
+
+    if (address <= uc->mapped_blocks[i - 1]->end - 1)
+        return uc->mapped_blocks[i - 1];
+
+    // not found
+    return NULL;
+}
+
+// append a hook to one of the per-type tables, growing it when full
+static struct hook *hook_append(struct uc_struct *uc, struct hook_list *l,
+        struct hook *hook)
+{
+    if (l->count == l->capacity) {  //time to grow
+        uint32_t capacity = l->capacity? l->capacity * 2 : 8;
+        struct hook **items = (struct hook **)urealloc(uc, l->items,
+                sizeof(struct hook*) * l->capacity,
+                sizeof(struct hook*) * capacity);
+        if (items == NULL) {
+            return NULL;
+        }
+        l->items = items;
+        l->capacity = capacity;
+    }
+
+    // widen the address envelope used for fast rejection
+    if (hook->begin > hook->end) {
+        // catch-all hook
+        l->begin = 0;
+        l->end = ~(uint64_t)0;
+    } else if (l->count == 0) {
+        l->begin = hook->begin;
+        l->end = hook->end;
+    } else {
+        l->begin = MIN(l->begin, hook->begin);
+        l->end = MAX(l->end, hook->end);
     }
 
-    // try with the cache index first
-    i = uc->mapped_block_cache_index;
+    l->items[l->count++] = hook;
+
+    return hook;
+}
+
+// compact one hook table, reclaiming hooks marked by uc_hook_del()
+static void hook_list_sweep(struct uc_struct *uc, struct hook_list *l)
+{
+    uint32_t i, j;
 
-    if (i < uc->mapped_block_count && address >= uc->mapped_blocks[i]->addr && address < uc->mapped_blocks[i]->end)
-        return uc->mapped_blocks[i];
+    for (i = 0, j = 0; i < l->count; i++) {
+        struct hook *hook = l->items[i];
+        if (hook->deleted) {
+            if (--hook->refs == 0) {
+                ufree(uc, hook);
+            }
+        } else {
+            l->items[j++] = hook;
+        }
+    }
 
-    for(i = 0; i < uc->mapped_block_count; i++) {
-        if (address >= uc->mapped_blocks[i]->addr && address <= uc->mapped_blocks[i]->end - 1) {
-            // cache this index for the next query
-            uc->mapped_block_cache_index = i;
-            return uc->mapped_blocks[i];
+    if (j == l->count) {
+        return;
+    }
+    l->count = j;
+
+    // recompute the envelope from the remaining hooks
+    l->begin = ~(uint64_t)0;
+    l->end = 0;
+    for (i = 0; i < l->count; i++) {
+        if (l->items[i]->begin > l->items[i]->end) {
+            l->begin = 0;
+            l->end = ~(uint64_t)0;
+            break;
         }
+        l->begin = MIN(l->begin, l->items[i]->begin);
+        l->end = MAX(l->end, l->items[i]->end);
     }
+}
+
+// compact all hook tables. Only called from safe points (start of
+// uc_emu_start()) where no hook iteration is in flight.
+static void hook_sweep(struct uc_struct *uc)
+{
+    uint32_t i;
+    int idx;
+
+    for (idx = 0; idx < UC_HOOK_MAX; idx++) {
+        hook_list_sweep(uc, &uc->hook[idx]);
+    }
+    for (i = 0; i < uc->insn_hooks_size; i++) {
+        hook_list_sweep(uc, &uc->insn_hooks[i]);
+    }
+
+    uc->hook_dirty = false;
+}
+
+// hook types that can be delivered asynchronously (UC_HOOK_ASYNC): only
+// void callbacks that cannot alter the course of the emulation
+#define UC_HOOK_ASYNC_TYPES \
+    (UC_HOOK_CODE | UC_HOOK_BLOCK | UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)
+
+// number of entries of the bounded event queue; when it is full the
+// emulation thread stalls until the dispatch thread catches up
+#define UC_ASYNC_QUEUE_SIZE 2048
+
+// dispatch thread: drains the event queue and runs the queued callbacks
+// outside the lock, so the emulation thread is never blocked on one
+static void *async_worker(void *opaque)
+{
+    uc_engine *uc = opaque;
+    struct uc_async_event ev;
+
+    qemu_mutex_lock(&uc->async_mutex);
+    for (;;) {
+        while (uc->async_tail == uc->async_head && uc->async_running) {
+            qemu_cond_wait(&uc->async_avail, &uc->async_mutex);
+        }
+        if (uc->async_tail == uc->async_head) {
+            break;  // queue drained and uc_close() requested shutdown
+        }
+
+        ev = uc->async_queue[uc->async_tail % uc->async_capacity];
+        uc->async_tail++;
+        qemu_cond_signal(&uc->async_space);
+        qemu_mutex_unlock(&uc->async_mutex);
+
+        switch (ev.type) {
+            default:
+                break;
+            case UC_HOOK_CODE:
+            case UC_HOOK_BLOCK:
+                ((uc_cb_hookcode_t)ev.callback)(uc, ev.address, ev.size, ev.user_data);
+                break;
+            case UC_HOOK_MEM_READ:
+                ((uc_cb_hookmem_t)ev.callback)(uc, UC_MEM_READ, ev.address, ev.size, 0, ev.user_data);
+                break;
+            case UC_HOOK_MEM_WRITE:
+                ((uc_cb_hookmem_t)ev.callback)(uc, UC_MEM_WRITE, ev.address, ev.size, ev.value, ev.user_data);
+                break;
+        }
+
+        qemu_mutex_lock(&uc->async_mutex);
+    }
+    qemu_mutex_unlock(&uc->async_mutex);
 
-    // not found
     return NULL;
 }
 
+// start the dispatch thread when the first asynchronous hook is added
+static uc_err async_start(uc_engine *uc)
+{
+    uc->async_queue = uzalloc(uc,
+            UC_ASYNC_QUEUE_SIZE * sizeof(struct uc_async_event));
+    if (uc->async_queue == NULL) {
+        return UC_ERR_NOMEM;
+    }
+    uc->async_capacity = UC_ASYNC_QUEUE_SIZE;
+    uc->async_head = 0;
+    uc->async_tail = 0;
+    uc->async_running = true;
+
+    qemu_mutex_init(&uc->async_mutex);
+    qemu_cond_init(&uc->async_avail);
+    qemu_cond_init(&uc->async_space);
+
+    if (qemu_thread_create(&uc->async_thread, "async-hooks",
+                async_worker, uc, QEMU_THREAD_JOINABLE)) {
+        qemu_mutex_destroy(&uc->async_mutex);
+        qemu_cond_destroy(&uc->async_avail);
+        qemu_cond_destroy(&uc->async_space);
+        ufree(uc, uc->async_queue);
+        uc->async_queue = NULL;
+        return UC_ERR_RESOURCE;
+    }
+
+    return UC_ERR_OK;
+}
+
+void uc_async_publish(struct uc_struct *uc, struct hook *hook, int type,
+        uint64_t address, int size, int64_t value)
+{
+    struct uc_async_event *ev;
+
+    qemu_mutex_lock(&uc->async_mutex);
+    while (uc->async_head - uc->async_tail == uc->async_capacity) {
+        // queue full: stall emulation until the consumer catches up
+        qemu_cond_wait(&uc->async_space, &uc->async_mutex);
+    }
+
+    ev = &uc->async_queue[uc->async_head % uc->async_capacity];
+    ev->callback = hook->callback;
+    ev->user_data = hook->user_data;
+    ev->type = type;
+    ev->address = address;
+    ev->size = size;
+    ev->value = value;
+    uc->async_head++;
+
+    qemu_cond_signal(&uc->async_avail);
+    qemu_mutex_unlock(&uc->async_mutex);
+}
+
+// true when a change to a hook over [begin, end] can be retranslated
+// surgically (dropping only the intersecting TBs) instead of flushing the
+// whole translation cache:
+//  - the range must be bounded (begin > end means hook-everything);
+//  - memory hooks are out, because the translators gate the load/store
+//    helper emission on mere hook existence, not on the hooked range;
+//  - superblock mode is out, because a jump-following block reaches guest
+//    pcs that its [pc, pc+size) span does not cover.
+static bool hook_prunable(struct uc_struct *uc, int type, uint64_t begin,
+        uint64_t end)
+{
+    // insn hooks are never pruned surgically: their bounds are matched
+    // against eip while TB pruning is keyed on pc (eip + segment base)
+    return (type & (UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE | UC_HOOK_INSN)) == 0 &&
+            begin <= end && uc->sb_threshold == 0;
+}
+
 UNICORN_EXPORT
 uc_err uc_hook_add(uc_engine *uc, uc_hook *hh, int type, void *callback,
         void *user_data, uint64_t begin, uint64_t end, ...)
 {
     int ret = UC_ERR_OK;
     int i = 0;
+    bool async = (type & UC_HOOK_ASYNC) != 0;
+    struct hook *hook;
+
+    type &= ~UC_HOOK_ASYNC;
+    if (async && (type == 0 || (type & ~UC_HOOK_ASYNC_TYPES) != 0)) {
+        return UC_ERR_ARG;
+    }
+
+    // the dispatch thread is started when the first async hook arrives
+    if (async && uc->async_queue == NULL) {
+        ret = async_start(uc);
+        if (ret != UC_ERR_OK) {
+            return ret;
+        }
+    }
 
-    struct hook *hook = calloc(1, sizeof(struct hook));
+    hook = uzalloc(uc, sizeof(struct hook));
     if (hook == NULL) {
         return UC_ERR_NOMEM;
     }
@@ -979,6 +2656,7 @@ uc_err uc_hook_add(uc_engine *uc, uc_hook *hh, int type, void *callback,
     hook->begin = begin;
     hook->end = end;
     hook->type = type;
+    hook->async = async;
     hook->callback = callback;
     hook->user_data = user_data;
     hook->refs = 0;
@@ -992,22 +2670,55 @@ uc_err uc_hook_add(uc_engine *uc, uc_hook *hh, int type, void *callback,
         hook->insn = va_arg(valist, int);
         va_end(valist);
 
-        if (list_append(&uc->hook[UC_HOOK_INSN_IDX], hook) == NULL) {
-            free(hook);
+        if (hook->insn < 0) {
+            ufree(uc, hook);
+            return UC_ERR_ARG;
+        }
+
+        if (hook_append(uc, &uc->hook[UC_HOOK_INSN_IDX], hook) == NULL) {
+            ufree(uc, hook);
             return UC_ERR_NOMEM;
         }
+        hook->refs++;
+
+        // also index the hook by instruction ID, so dispatch for one
+        // hooked instruction class never walks hooks of another
+        if ((uint32_t)hook->insn >= uc->insn_hooks_size) {
+            uint32_t size = (uint32_t)hook->insn + 1;
+            struct hook_list *tables = (struct hook_list *)urealloc(uc,
+                    uc->insn_hooks,
+                    sizeof(struct hook_list) * uc->insn_hooks_size,
+                    sizeof(struct hook_list) * size);
+            if (tables == NULL) {
+                goto insn_nomem;
+            }
+            memset(tables + uc->insn_hooks_size, 0,
+                    sizeof(struct hook_list) * (size - uc->insn_hooks_size));
+            uc->insn_hooks = tables;
+            uc->insn_hooks_size = size;
+        }
 
+        if (hook_append(uc, &uc->insn_hooks[hook->insn], hook) == NULL) {
+            goto insn_nomem;
+        }
         hook->refs++;
+
         return UC_ERR_OK;
+
+insn_nomem:
+        // already referenced by the shared table; let hook_sweep() reclaim it
+        hook->deleted = true;
+        uc->hook_dirty = true;
+        return UC_ERR_NOMEM;
     }
 
     while ((type >> i) > 0) {
         if ((type >> i) & 1) {
             // TODO: invalid hook error?
             if (i < UC_HOOK_MAX) {
-                if (list_append(&uc->hook[i], hook) == NULL) {
+                if (hook_append(uc, &uc->hook[i], hook) == NULL) {
                     if (hook->refs == 0) {
-                        free(hook);
+                        ufree(uc, hook);
                     }
                     return UC_ERR_NOMEM;
                 }
@@ -1020,7 +2731,33 @@ uc_err uc_hook_add(uc_engine *uc, uc_hook *hh, int type, void *callback,
     // we didn't use the hook
     // TODO: return an error?
     if (hook->refs == 0) {
-        free(hook);
+        ufree(uc, hook);
+        return ret;
+    }
+
+    // Memory hook ranges are cached as a per-page flag in the softmmu TLB
+    // (TLB_UCHOOK), so stale entries must be dropped when they change.
+    if (type & (UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)) {
+        uc->tlb_flush(uc);
+    }
+
+    // The translators consult the hook tables when generating code and only
+    // emit trace helper calls for instructions inside a hooked range. If code
+    // hooks change while emulation is running (e.g. from a callback), quit
+    // the current TB so the code gets retranslated against the new table.
+    // A bounded code/block hook only changes the translation of blocks
+    // intersecting its range: drop just those and keep the rest of the warm
+    // cache (tb_pruned skips the flush on the way out of cpu_exec()).
+    // Insn hooks count too: a single one gets its callback compiled into
+    // the TB as a direct call (see HOOK_INSN_SINGLE).
+    if ((type & (UC_HOOK_CODE | UC_HOOK_BLOCK | UC_HOOK_INSN
+                    | UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE))
+            && uc->current_cpu) {
+        uc->tb_pruned = hook_prunable(uc, type, begin, end);
+        if (uc->tb_pruned)
+            uc->tb_invalidate_pc_range(uc, begin, end);
+        uc->quit_request = true;
+        uc_emu_stop(uc);
     }
 
     return ret;
@@ -1029,64 +2766,2129 @@ uc_err uc_hook_add(uc_engine *uc, uc_hook *hh, int type, void *callback,
 UNICORN_EXPORT
 uc_err uc_hook_del(uc_engine *uc, uc_hook hh)
 {
-    int i;
-    struct hook *hook;
-    for (i = 0; i < UC_HOOK_MAX; i++) {
-        if (list_remove(&uc->hook[i], (void *)hh)) {
-            hook = (struct hook *)hh;
-            if (--hook->refs == 0) {
-                free(hook);
-            }
-        }
+    struct hook *hook = (struct hook *)hh;
+
+    // already marked; the entry is reclaimed at the next hook_sweep()
+    if (hook->deleted) {
+        return UC_ERR_OK;
     }
-    return UC_ERR_OK;
-}
 
-// TCG helper
-void helper_uc_tracecode(int32_t size, uc_hook_type type, void *handle, int64_t address);
-void helper_uc_tracecode(int32_t size, uc_hook_type type, void *handle, int64_t address)
-{
+    // O(1): just mark it. Iterators skip deleted entries, so this is safe
+    // even when called from a hook callback in the middle of dispatch.
+    hook->deleted = true;
+    uc->hook_dirty = true;
+
+    // see uc_hook_add(): drop cached TLB_UCHOOK flags for memory hooks
+    if (hook->type & (UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)) {
+        uc->tlb_flush(uc);
+    }
+
+    // see uc_hook_add(): drop stale translations that still call into
+    // the deleted hook's range - surgically when the range is bounded.
+    // A deleted insn hook may be baked into TBs as a direct call, so it
+    // quits and flushes too.
+    if ((hook->type & (UC_HOOK_CODE | UC_HOOK_BLOCK | UC_HOOK_INSN))
+            && uc->current_cpu) {
+        uc->tb_pruned = hook_prunable(uc, hook->type, hook->begin, hook->end);
+        if (uc->tb_pruned)
+            uc->tb_invalidate_pc_range(uc, hook->begin, hook->end);
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_hook_set_filter(uc_engine *uc, uc_hook hh, const uc_hook_filter *filter)
+{
+    struct hook *hook = (struct hook *)hh;
+    uint64_t old_begin = hook->begin;
+    uint64_t old_end = hook->end;
+    int i;
+
+    if (hook->deleted) {
+        return UC_ERR_HANDLE;
+    }
+
+    if (filter == NULL) {
+        // keep the address range, accept all sizes and values again
+        hook->size_mask = 0;
+        hook->value_mask = 0;
+        hook->value_match = 0;
+        return UC_ERR_OK;
+    }
+
+    hook->begin = filter->begin;
+    hook->end = filter->end;
+    hook->size_mask = filter->size_mask;
+    hook->value_mask = filter->value_mask;
+    hook->value_match = filter->value;
+
+    // the new range may exceed the envelopes computed when the hook was
+    // appended, so widen them like hook_append() does
+    for (i = 0; i < UC_HOOK_MAX; i++) {
+        if ((hook->type >> i) & 1) {
+            struct hook_list *l = &uc->hook[i];
+            if (hook->begin > hook->end) {
+                l->begin = 0;
+                l->end = ~(uint64_t)0;
+            } else {
+                l->begin = MIN(l->begin, hook->begin);
+                l->end = MAX(l->end, hook->end);
+            }
+        }
+    }
+
+    // see uc_hook_add(): changed ranges invalidate cached TLB_UCHOOK flags
+    // and translations gated on the old hook range
+    if (hook->type & (UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)) {
+        uc->tlb_flush(uc);
+    }
+    if ((hook->type & (UC_HOOK_CODE | UC_HOOK_BLOCK | UC_HOOK_INSN
+                    | UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE))
+            && uc->current_cpu) {
+        // blocks under the old range and under the new one both translate
+        // differently now; prune surgically only when both are bounded
+        uc->tb_pruned =
+                hook_prunable(uc, hook->type, old_begin, old_end) &&
+                hook_prunable(uc, hook->type, hook->begin, hook->end);
+        if (uc->tb_pruned) {
+            uc->tb_invalidate_pc_range(uc, old_begin, old_end);
+            uc->tb_invalidate_pc_range(uc, hook->begin, hook->end);
+        }
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_watch_add(uc_engine *uc, uc_hook *wh, int type,
+        uc_cb_hookmem_t callback, void *user_data, uint64_t address,
+        size_t len)
+{
+    struct uc_watch *w = NULL;
+    uint32_t i;
+
+    if (wh == NULL || callback == NULL || len == 0)
+        return UC_ERR_ARG;
+    if (type == 0 || (type & ~(UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)) != 0)
+        return UC_ERR_ARG;
+    if (address + len - 1 < address)    // range wraps the address space
+        return UC_ERR_ARG;
+
+    // reuse a slot freed by uc_watch_del() before growing the array
+    for (i = 0; i < uc->watch_count; i++) {
+        if (!uc->watch[i].used) {
+            w = &uc->watch[i];
+            break;
+        }
+    }
+    if (w == NULL) {
+        struct uc_watch *tmp = (struct uc_watch *)urealloc(uc, uc->watch,
+                sizeof(struct uc_watch) * uc->watch_count,
+                sizeof(struct uc_watch) * (uc->watch_count + 1));
+        if (tmp == NULL) {
+            return UC_ERR_NOMEM;
+        }
+        uc->watch = tmp;
+        i = uc->watch_count++;
+        w = &uc->watch[i];
+    }
+
+    w->begin = address;
+    w->end = address + len - 1;
+    w->type = type;
+    w->callback = callback;
+    w->user_data = user_data;
+    w->used = true;
+
+    // the array may be reallocated, so handles are indexes, not pointers;
+    // biased by one so a zeroed uc_hook is never a valid handle
+    *wh = (uc_hook)(i + 1);
+
+    // see uc_hook_add(): the watched pages are cached as TLB_UCHOOK flags,
+    // and translations inline the fast path for unflagged pages
+    uc->tlb_flush(uc);
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_watch_del(uc_engine *uc, uc_hook wh)
+{
+    struct uc_watch *w;
+
+    if (wh == 0 || wh > uc->watch_count)
+        return UC_ERR_HANDLE;
+
+    w = &uc->watch[wh - 1];
+    if (!w->used)
+        return UC_ERR_HANDLE;
+    w->used = false;
+
+    // see uc_watch_add(): drop the cached TLB_UCHOOK flags so the pages
+    // return to the fast path
+    uc->tlb_flush(uc);
+
+    return UC_ERR_OK;
+}
+
+// hook types that uc_trace_enable() can capture
+#define UC_TRACE_TYPES \
+    (UC_HOOK_CODE | UC_HOOK_BLOCK | UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)
+
+UNICORN_EXPORT
+uc_err uc_trace_enable(uc_engine *uc, int type, uc_trace_record *records,
+        size_t capacity)
+{
+    if (records == NULL || capacity == 0)
+        return UC_ERR_ARG;
+
+    if (type == 0 || (type & ~UC_TRACE_TYPES) != 0)
+        return UC_ERR_ARG;
+
+    // streaming mode owns the ring; disable it first
+    if (uc->trace_stream)
+        return UC_ERR_ARG;
+
+    uc->trace_type = type;
+    uc->trace_capacity = capacity;
+    uc->trace_head = 0;
+    uc->trace_records = records;
+
+    // traced pages take the instrumented slow path via TLB_UCHOOK
+    if (type & (UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)) {
+        uc->tlb_flush(uc);
+    }
+
+    // drop translations generated without trace instrumentation
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_trace_disable(uc_engine *uc)
+{
+    int type = uc->trace_type;
+
+    // streaming mode: flush everything to the descriptor and stop the
+    // writer thread before dropping the ring
+    trace_stream_stop(uc);
+
+    uc->trace_records = NULL;
+    uc->trace_type = 0;
+
+    // drop cached TLB_UCHOOK flags for traced memory accesses
+    if (type & (UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)) {
+        uc->tlb_flush(uc);
+    }
+
+    // retranslate with plain callback dispatch
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_trace_count(uc_engine *uc, size_t *count)
+{
+    *count = uc->trace_head;
+
+    return UC_ERR_OK;
+}
+
+// internal buffer of uc_trace_stream() when the caller does not size it
+#define UC_TRACE_STREAM_CAPACITY (1 << 16)
+
+// worst-case compressed size of @len input bytes: all literals, one length
+// extension byte per 255, plus slack for the final token
+#define TRACE_LZ_BOUND(len) ((len) + (len) / 255 + 16)
+
+// Greedy LZ compressor for trace frames (see uc_trace_compress()). The
+// output is a series of sequences, each: a token byte whose high nibble is
+// the literal run length and low nibble the match length minus 4 (value 15
+// means continuation bytes follow, each adding up to 255, terminated by a
+// byte < 255); the literals; then a 16-bit little-endian backwards offset.
+// The final sequence is literals only (no offset). Matches are found
+// through a small hash table of recent 4-byte sequences; collisions are
+// verified, so a missed match only costs ratio, never correctness.
+static size_t trace_lz_compress(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    uint32_t table[4096];   // position + 1 of a recent 4-byte run, 0 = empty
+    size_t in = 0, out = 0, anchor = 0, lit;
+    uint8_t *token;
+
+    memset(table, 0, sizeof(table));
+
+    while (in + 4 <= len) {
+        uint32_t key, h;
+        size_t cand;
+
+        memcpy(&key, src + in, 4);
+        h = (key * 2654435761u) >> 20;  // top 12 bits index the table
+        cand = table[h];
+        table[h] = (uint32_t)in + 1;
+
+        if (cand != 0 && in - (cand - 1) <= 0xffff &&
+                memcmp(src + (cand - 1), src + in, 4) == 0) {
+            size_t match = cand - 1;
+            size_t offset = in - match;
+            size_t mlen = 4, rest;
+
+            while (in + mlen < len && src[match + mlen] == src[in + mlen]) {
+                mlen++;
+            }
+
+            lit = in - anchor;
+            token = &dst[out++];
+            if (lit >= 15) {
+                *token = 15 << 4;
+                for (rest = lit - 15; rest >= 255; rest -= 255) {
+                    dst[out++] = 255;
+                }
+                dst[out++] = (uint8_t)rest;
+            } else {
+                *token = (uint8_t)(lit << 4);
+            }
+            memcpy(&dst[out], src + anchor, lit);
+            out += lit;
+
+            dst[out++] = (uint8_t)(offset & 0xff);
+            dst[out++] = (uint8_t)(offset >> 8);
+
+            if (mlen - 4 >= 15) {
+                *token |= 15;
+                for (rest = mlen - 4 - 15; rest >= 255; rest -= 255) {
+                    dst[out++] = 255;
+                }
+                dst[out++] = (uint8_t)rest;
+            } else {
+                *token |= (uint8_t)(mlen - 4);
+            }
+
+            in += mlen;
+            anchor = in;
+        } else {
+            in++;
+        }
+    }
+
+    // trailing literals-only sequence (possibly empty)
+    lit = len - anchor;
+    token = &dst[out++];
+    if (lit >= 15) {
+        size_t rest;
+
+        *token = 15 << 4;
+        for (rest = lit - 15; rest >= 255; rest -= 255) {
+            dst[out++] = 255;
+        }
+        dst[out++] = (uint8_t)rest;
+    } else {
+        *token = (uint8_t)(lit << 4);
+    }
+    memcpy(&dst[out], src + anchor, lit);
+    out += lit;
+
+    return out;
+}
+
+UNICORN_EXPORT
+uc_err uc_trace_decompress(const void *src_buf, size_t src_len, void *dst_buf,
+        size_t dst_len)
+{
+    const uint8_t *src = src_buf;
+    uint8_t *dst = dst_buf;
+    size_t in = 0, out = 0;
+
+    while (in < src_len) {
+        uint8_t token = src[in++], b;
+        size_t lit = token >> 4;
+        size_t mlen = token & 15;
+        size_t offset, k;
+
+        if (lit == 15) {
+            do {
+                if (in >= src_len) {
+                    return UC_ERR_ARG;
+                }
+                b = src[in++];
+                lit += b;
+            } while (b == 255);
+        }
+        if (in + lit > src_len || out + lit > dst_len) {
+            return UC_ERR_ARG;
+        }
+        memcpy(dst + out, src + in, lit);
+        in += lit;
+        out += lit;
+
+        if (in == src_len) {
+            // final literals-only sequence
+            break;
+        }
+
+        if (in + 2 > src_len) {
+            return UC_ERR_ARG;
+        }
+        offset = src[in] | ((size_t)src[in + 1] << 8);
+        in += 2;
+        if (mlen == 15) {
+            do {
+                if (in >= src_len) {
+                    return UC_ERR_ARG;
+                }
+                b = src[in++];
+                mlen += b;
+            } while (b == 255);
+        }
+        mlen += 4;
+
+        if (offset == 0 || offset > out || out + mlen > dst_len) {
+            return UC_ERR_ARG;
+        }
+        // byte-wise so overlapping matches replicate correctly
+        for (k = 0; k < mlen; k++) {
+            dst[out + k] = dst[out - offset + k];
+        }
+        out += mlen;
+    }
+
+    return out == dst_len ? UC_ERR_OK : UC_ERR_ARG;
+}
+
+UNICORN_EXPORT
+uc_err uc_trace_compress(uc_engine *uc, bool enable)
+{
+    // takes effect on the next uc_trace_stream(); flipping it mid-stream
+    // would corrupt the output format
+    if (uc->trace_stream) {
+        return UC_ERR_ARG;
+    }
+    uc->trace_compress = enable;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_tb_meta(uc_engine *uc, uint64_t address, uc_tb_insn *insns,
+        uint32_t *count)
+{
+    if (count == NULL || uc->tb_meta_get == NULL || uc->cpu == NULL)
+        return UC_ERR_ARG;
+
+    address = uc_mem_redirect(uc, address);
+
+    // the metadata lives on the translation itself, so this only answers
+    // while the block is live - typically from inside a hook callback
+    if (uc->tb_meta_get(uc, address, insns, count) != 0)
+        return UC_ERR_ARG;
+
+    return UC_ERR_OK;
+}
+
+#ifndef _WIN32
+// write() the whole buffer, riding out short writes and EINTR. A failing
+// descriptor silently truncates the trace; the per-record sequence numbers
+// let a reader detect that
+static void trace_write_all(int fd, const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+    ssize_t r;
+
+    while (len > 0) {
+        r = write(fd, p, len);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        p += r;
+        len -= (size_t)r;
+    }
+}
+
+// writer thread of uc_trace_stream(): drains the trace ring to the file
+// descriptor in large batches, attaching the per-record sequence numbers
+static void *trace_writer(void *opaque)
+{
+    struct uc_struct *uc = opaque;
+    uc_trace_stream_record batch[1024];
+    size_t head, n;
+    bool was_full;
+
+    for (;;) {
+        head = uc->trace_head;
+        if (uc->trace_tail == head) {
+            if (!uc->trace_stream_running) {
+                break;
+            }
+            // nothing queued: nap until more is produced
+            qemu_sem_timedwait(&uc->trace_avail, 10);
+            continue;
+        }
+        // the records behind the head read above are fully written
+        smp_rmb();
+
+        was_full = (head - uc->trace_tail >= uc->trace_capacity);
+        n = 0;
+        while (uc->trace_tail + n != head && n < ARR_SIZE(batch)) {
+            uc_trace_record *rec = &uc->trace_records[
+                    (uc->trace_tail + n) % uc->trace_capacity];
+
+            batch[n].seq = uc->trace_tail + n;
+            batch[n].address = rec->address;
+            batch[n].type = rec->type;
+            batch[n].size = rec->size;
+            n++;
+        }
+        // the drained slots may only be reused after the copy above
+        smp_mb();
+        uc->trace_tail += n;
+        if (was_full) {
+            // a producer may be stalled on the full ring
+            qemu_sem_post(&uc->trace_space);
+        }
+
+        if (uc->trace_compress) {
+            uint8_t comp[TRACE_LZ_BOUND(sizeof(batch))];
+            uc_trace_frame frame;
+            size_t raw = n * sizeof(batch[0]);
+            size_t csize = trace_lz_compress((const uint8_t *)batch, raw,
+                    comp);
+
+            frame.magic = UC_TRACE_FRAME_MAGIC;
+            frame.raw_size = (uint32_t)raw;
+            frame.record_count = (uint32_t)n;
+            frame.first_seq = batch[0].seq;
+            if (csize >= raw) {
+                // incompressible: store the records as-is
+                frame.compressed_size = (uint32_t)raw;
+                trace_write_all(uc->trace_fd, &frame, sizeof(frame));
+                trace_write_all(uc->trace_fd, batch, raw);
+            } else {
+                frame.compressed_size = (uint32_t)csize;
+                trace_write_all(uc->trace_fd, &frame, sizeof(frame));
+                trace_write_all(uc->trace_fd, comp, csize);
+            }
+        } else {
+            trace_write_all(uc->trace_fd, batch, n * sizeof(batch[0]));
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+UNICORN_EXPORT
+uc_err uc_trace_stream(uc_engine *uc, int type, int fd, size_t capacity)
+{
+#ifndef _WIN32
+    uc_trace_file_header hdr;
+
+    if (fd < 0 || type == 0 || (type & ~UC_TRACE_TYPES) != 0) {
+        return UC_ERR_ARG;
+    }
+    // one trace mode at a time
+    if (uc->trace_records != NULL) {
+        return UC_ERR_ARG;
+    }
+    if (capacity == 0) {
+        capacity = UC_TRACE_STREAM_CAPACITY;
+    }
+
+    uc->trace_records = uzalloc(uc, capacity * sizeof(uc_trace_record));
+    if (uc->trace_records == NULL) {
+        return UC_ERR_NOMEM;
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, "UCTR", 4);
+    hdr.version = 1;
+    hdr.record_size = sizeof(uc_trace_stream_record);
+    hdr.arch = uc->arch;
+    hdr.mode = uc->mode;
+    hdr.flags = uc->trace_compress ? UC_TRACE_COMPRESSED : 0;
+    trace_write_all(fd, &hdr, sizeof(hdr));
+
+    uc->trace_capacity = capacity;
+    uc->trace_head = 0;
+    uc->trace_tail = 0;
+    uc->trace_fd = fd;
+    uc->trace_stream_running = true;
+
+    qemu_sem_init(&uc->trace_avail, 0);
+    qemu_sem_init(&uc->trace_space, 0);
+
+    if (qemu_thread_create(&uc->trace_thread, "trace-writer",
+                trace_writer, uc, QEMU_THREAD_JOINABLE)) {
+        qemu_sem_destroy(&uc->trace_avail);
+        qemu_sem_destroy(&uc->trace_space);
+        ufree(uc, uc->trace_records);
+        uc->trace_records = NULL;
+        uc->trace_stream_running = false;
+        return UC_ERR_RESOURCE;
+    }
+
+    uc->trace_stream = true;
+    uc->trace_type = type;
+
+    // as in uc_trace_enable(): traced pages take the instrumented slow
+    // path, and live translations must be regenerated with trace probes
+    if (type & (UC_HOOK_MEM_READ | UC_HOOK_MEM_WRITE)) {
+        uc->tlb_flush(uc);
+    }
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+#else
+    // no streaming writer on Windows
+    return UC_ERR_ARG;
+#endif
+}
+
+// end streaming trace mode: let the writer drain what remains, stop it
+// and release the engine-owned ring (uc_trace_disable() and uc_close())
+static void trace_stream_stop(struct uc_struct *uc)
+{
+    if (!uc->trace_stream) {
+        return;
+    }
+
+    uc->trace_stream_running = false;
+    qemu_sem_post(&uc->trace_avail);
+    qemu_thread_join(&uc->trace_thread);
+    qemu_sem_destroy(&uc->trace_avail);
+    qemu_sem_destroy(&uc->trace_space);
+
+    ufree(uc, uc->trace_records);
+    uc->trace_records = NULL;
+    uc->trace_stream = false;
+    uc->trace_fd = -1;
+}
+
+UNICORN_EXPORT
+uc_err uc_coverage_enable(uc_engine *uc, uint8_t *bitmap, size_t size)
+{
+    // the bitmap is indexed with (cur ^ prev) & (size - 1), so the size
+    // must be a power of two
+    if (bitmap == NULL || size == 0 || (size & (size - 1)) != 0)
+        return UC_ERR_ARG;
+
+    uc->cov_mask = size - 1;
+    uc->cov_prev_loc = 0;
+    uc->cov_bitmap = bitmap;
+
+    // drop translations generated without the bitmap update
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_coverage_disable(uc_engine *uc)
+{
+    uc->cov_bitmap = NULL;
+
+    // retranslate without the bitmap update
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_profile_enable(uc_engine *uc)
+{
+    uc->tb_profile = true;
+
+    // drop translations generated without execution counters
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_profile_disable(uc_engine *uc)
+{
+    uc->tb_profile = false;
+
+    free(uc->profile_table);
+    uc->profile_table = NULL;
+    uc->profile_used = 0;
+    uc->profile_size = 0;
+
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+static int profile_entry_cmp(const void *a, const void *b)
+{
+    const struct tb_profile_entry *ea = a, *eb = b;
+
+    if (ea->exec_count != eb->exec_count)
+        return ea->exec_count < eb->exec_count ? 1 : -1;
+
+    // stable order for blocks with equal counts
+    if (ea->pc != eb->pc)
+        return ea->pc < eb->pc ? -1 : 1;
+
+    return 0;
+}
+
+UNICORN_EXPORT
+uc_err uc_profile_top(uc_engine *uc, uc_block_stats *stats, uint32_t *count)
+{
+    struct tb_profile_entry *entries;
+    uint32_t i, used;
+
+    if (stats == NULL || count == NULL)
+        return UC_ERR_ARG;
+
+    if (!uc->tb_profile)
+        return UC_ERR_ARG;
+
+    // fold the counters of the still-live TBs into the profile table
+    uc->profile_flush(uc);
+
+    if (uc->profile_used == 0) {
+        *count = 0;
+        return UC_ERR_OK;
+    }
+
+    // sort a compacted copy of the table by descending execution count
+    entries = malloc(uc->profile_used * sizeof(*entries));
+    if (entries == NULL)
+        return UC_ERR_NOMEM;
+
+    used = 0;
+    for (i = 0; i < uc->profile_size; i++) {
+        if (uc->profile_table[i].exec_count != 0)
+            entries[used++] = uc->profile_table[i];
+    }
+    qsort(entries, used, sizeof(*entries), profile_entry_cmp);
+
+    if (*count > used)
+        *count = used;
+    for (i = 0; i < *count; i++) {
+        stats[i].address = entries[i].pc;
+        stats[i].insn_count = entries[i].icount;
+        stats[i].exec_count = entries[i].exec_count;
+    }
+
+    free(entries);
+    return UC_ERR_OK;
+}
+
+// buckets of the guest-PC sample histogram; at 16 bytes each this is 1MB
+// holding ~48k distinct block addresses (the fill is capped at 3/4),
+// plenty for one guest module and preallocated so the dispatch loop in
+// qemu/cpu-exec.c never allocates
+#define UC_SAMPLE_TABLE_SIZE (1 << 16)
+
+UNICORN_EXPORT
+uc_err uc_sample_enable(uc_engine *uc, uint32_t interval)
+{
+    struct pc_sample_entry *table;
+
+    if (interval == 0)
+        return UC_ERR_ARG;
+
+    if (uc->sample_table == NULL) {
+        table = calloc(UC_SAMPLE_TABLE_SIZE, sizeof(*table));
+        if (table == NULL)
+            return UC_ERR_NOMEM;
+        uc->sample_size = UC_SAMPLE_TABLE_SIZE;
+        uc->sample_used = 0;
+        uc->sample_dropped = 0;
+        // the dispatch loop tests sample_table alone: publish it last
+        uc->sample_table = table;
+    }
+    uc->sample_interval = interval;
+    uc->sample_countdown = interval;
+
+    // takes effect at the next block dispatch; nothing is retranslated
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_sample_disable(uc_engine *uc)
+{
+    struct pc_sample_entry *table = uc->sample_table;
+
+    uc->sample_table = NULL;
+    free(table);
+    uc->sample_size = 0;
+    uc->sample_used = 0;
+
+    return UC_ERR_OK;
+}
+
+static int sample_entry_cmp(const void *a, const void *b)
+{
+    const struct pc_sample_entry *ea = a, *eb = b;
+
+    if (ea->count != eb->count)
+        return ea->count < eb->count ? 1 : -1;
+
+    // stable order for addresses with equal counts
+    if (ea->pc != eb->pc)
+        return ea->pc < eb->pc ? -1 : 1;
+
+    return 0;
+}
+
+UNICORN_EXPORT
+uc_err uc_sample_top(uc_engine *uc, uc_sample_entry *entries, uint32_t *count)
+{
+    struct pc_sample_entry *sorted;
+    uint32_t i, used;
+
+    if (entries == NULL || count == NULL)
+        return UC_ERR_ARG;
+
+    if (uc->sample_table == NULL)
+        return UC_ERR_ARG;
+
+    if (uc->sample_used == 0) {
+        *count = 0;
+        return UC_ERR_OK;
+    }
+
+    // sort a compacted copy of the histogram by descending sample count
+    sorted = malloc(uc->sample_used * sizeof(*sorted));
+    if (sorted == NULL)
+        return UC_ERR_NOMEM;
+
+    used = 0;
+    for (i = 0; i < uc->sample_size; i++) {
+        if (uc->sample_table[i].count != 0)
+            sorted[used++] = uc->sample_table[i];
+    }
+    qsort(sorted, used, sizeof(*sorted), sample_entry_cmp);
+
+    if (*count > used)
+        *count = used;
+    for (i = 0; i < *count; i++) {
+        entries[i].address = sorted[i].pc;
+        entries[i].count = sorted[i].count;
+    }
+
+    free(sorted);
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_superblock_enable(uc_engine *uc, uint32_t threshold)
+{
+    uc->sb_threshold = threshold;
+
+    // drop translations generated with the old threshold (or without the
+    // counter when enabling, with it when disabling)
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_perfmap_enable(uc_engine *uc)
+{
+    char path[64];
+
+    if (uc->perfmap) {
+        // already enabled
+        return UC_ERR_OK;
+    }
+
+#ifdef _WIN32
+    snprintf(path, sizeof(path), "/tmp/perf-%u.map", (unsigned)_getpid());
+#else
+    snprintf(path, sizeof(path), "/tmp/perf-%u.map", (unsigned)getpid());
+#endif
+    uc->perfmap = fopen(path, "w");
+    if (uc->perfmap == NULL)
+        return UC_ERR_ARG;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_perfmap_disable(uc_engine *uc)
+{
+    if (uc->perfmap) {
+        fclose(uc->perfmap);
+        uc->perfmap = NULL;
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_tb_insn_limit(uc_engine *uc, uint32_t insns)
+{
+    uc->tb_max_insns = insns;
+
+    // drop translations generated under the old limit
+    if (uc->current_cpu) {
+        uc->quit_request = true;
+        uc_emu_stop(uc);
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_icount_timeout(uc_engine *uc, bool enable)
+{
+    // only consulted by uc_emu_start(), so this safely takes effect on
+    // the next run even when emulation is in progress
+    uc->timeout_icount = enable;
+
+    return UC_ERR_OK;
+}
+
+// magic + version of the uc_record_save() file format
+#define UC_RR_MAGIC   0x52524355    // "UCRR"
+#define UC_RR_VERSION 1
+
+// bump and return the execution count of pc in an open-addressed table;
+// grows at 3/4 load. Returns 0 only on allocation failure.
+static uint64_t rr_hits_bump(struct uc_struct *uc, struct uc_rr_slot **table,
+        uint32_t *size, uint32_t *used, uint64_t pc)
+{
+    struct uc_rr_slot *slots = *table;
+    uint32_t mask, i;
+
+    if (*used * 4 >= *size * 3) {
+        uint32_t nsize = *size ? *size * 2 : 64;
+        struct uc_rr_slot *nslots =
+            uzalloc(uc, (size_t)nsize * sizeof(*nslots));
+
+        if (nslots == NULL) {
+            return 0;
+        }
+        for (i = 0; i < *size; i++) {
+            if (slots[i].hits != 0) {
+                uint32_t j = (uint32_t)(slots[i].pc * 0x9e3779b97f4a7c15ull
+                        >> 32) & (nsize - 1);
+                while (nslots[j].hits != 0) {
+                    j = (j + 1) & (nsize - 1);
+                }
+                nslots[j] = slots[i];
+            }
+        }
+        ufree(uc, slots);
+        *table = slots = nslots;
+        *size = nsize;
+    }
+
+    mask = *size - 1;
+    i = (uint32_t)(pc * 0x9e3779b97f4a7c15ull >> 32) & mask;
+    while (slots[i].hits != 0 && slots[i].pc != pc) {
+        i = (i + 1) & mask;
+    }
+    if (slots[i].hits == 0) {
+        slots[i].pc = pc;
+        (*used)++;
+    }
+
+    return ++slots[i].hits;
+}
+
+// append one event to the recording, anchored to the latest dispatch
+static void rr_capture(struct uc_struct *uc, uint8_t kind, int32_t reg,
+        uint64_t addr, const void *data, uint32_t len)
+{
+    struct uc_rr_event *ev;
+
+    if (!uc->rr_have_site) {
+        // nothing to anchor to: no code hook covered the callback's site.
+        // The log is unusable; uc_record_save() refuses to write it.
+        uc->rr_lost = true;
+        return;
+    }
+
+    if (uc->rr_count == uc->rr_capacity) {
+        uint32_t ncap = uc->rr_capacity ? uc->rr_capacity * 2 : 64;
+        struct uc_rr_event *nev = urealloc(uc, uc->rr_events,
+                uc->rr_capacity * sizeof(*nev), ncap * sizeof(*nev));
+
+        if (nev == NULL) {
+            uc->rr_lost = true;
+            return;
+        }
+        uc->rr_events = nev;
+        uc->rr_capacity = ncap;
+    }
+
+    ev = &uc->rr_events[uc->rr_count];
+    ev->site = uc->rr_site;
+    ev->hit = uc->rr_site_hit;
+    ev->kind = kind;
+    ev->reg = reg;
+    ev->addr = addr;
+    ev->len = len;
+    ev->data = NULL;
+    if (len != 0) {
+        ev->data = ualloc(uc, len);
+        if (ev->data == NULL) {
+            uc->rr_lost = true;
+            return;
+        }
+        memcpy(ev->data, data, len);
+    }
+    uc->rr_count++;
+}
+
+static void rr_record_free(struct uc_struct *uc)
+{
+    uint32_t i;
+
+    for (i = 0; i < uc->rr_count; i++) {
+        ufree(uc, uc->rr_events[i].data);
+    }
+    ufree(uc, uc->rr_events);
+    uc->rr_events = NULL;
+    uc->rr_count = uc->rr_capacity = 0;
+    ufree(uc, uc->rr_hits);
+    uc->rr_hits = NULL;
+    uc->rr_hits_size = uc->rr_hits_used = 0;
+    uc->rr_recording = false;
+    uc->rr_lost = false;
+    uc->rr_have_site = false;
+}
+
+UNICORN_EXPORT
+uc_err uc_record_enable(uc_engine *uc)
+{
+    // never mid-run: positions count from the start of a run
+    if (uc->current_cpu) {
+        return UC_ERR_ARG;
+    }
+
+    rr_record_free(uc);
+    uc->rr_recording = true;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_record_save(uc_engine *uc, const char *path)
+{
+    FILE *f;
+    uint32_t header[5];
+    uint32_t i;
+
+    if (path == NULL || !uc->rr_recording) {
+        return UC_ERR_ARG;
+    }
+    if (uc->rr_lost) {
+        // an event could not be anchored (or memory ran out); a partial
+        // log would replay into a diverging state
+        return UC_ERR_ARG;
+    }
+
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        return UC_ERR_RESOURCE;
+    }
+
+    header[0] = UC_RR_MAGIC;
+    header[1] = UC_RR_VERSION;
+    header[2] = (uint32_t)uc->arch;
+    header[3] = (uint32_t)uc->mode;
+    header[4] = uc->rr_count;
+    if (fwrite(header, sizeof(header), 1, f) != 1) {
+        goto fail;
+    }
+    for (i = 0; i < uc->rr_count; i++) {
+        struct uc_rr_event *ev = &uc->rr_events[i];
+
+        if (fwrite(ev, offsetof(struct uc_rr_event, data), 1, f) != 1) {
+            goto fail;
+        }
+        if (ev->len != 0 && fwrite(ev->data, ev->len, 1, f) != 1) {
+            goto fail;
+        }
+    }
+    if (fclose(f) != 0) {
+        return UC_ERR_RESOURCE;
+    }
+
+    return UC_ERR_OK;
+
+fail:
+    fclose(f);
+    return UC_ERR_RESOURCE;
+}
+
+UNICORN_EXPORT
+uc_err uc_record_disable(uc_engine *uc)
+{
+    rr_record_free(uc);
+
+    return UC_ERR_OK;
+}
+
+static void rr_replay_free(struct uc_struct *uc)
+{
+    uint32_t i;
+
+    for (i = 0; i < uc->rp_hook_count; i++) {
+        uc_hook_del(uc, uc->rp_hooks[i]);
+    }
+    ufree(uc, uc->rp_hooks);
+    uc->rp_hooks = NULL;
+    uc->rp_hook_count = 0;
+    for (i = 0; i < uc->rp_count; i++) {
+        ufree(uc, uc->rp_events[i].data);
+    }
+    ufree(uc, uc->rp_events);
+    uc->rp_events = NULL;
+    uc->rp_count = uc->rp_next = 0;
+    ufree(uc, uc->rp_hits);
+    uc->rp_hits = NULL;
+    uc->rp_hits_size = uc->rp_hits_used = 0;
+}
+
+// internal UC_HOOK_CODE callback on every distinct event site: re-applies
+// the events recorded for the nth execution of this site
+static void rr_replay_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    uint64_t hit = rr_hits_bump(uc, &uc->rp_hits, &uc->rp_hits_size,
+            &uc->rp_hits_used, address);
+
+    while (uc->rp_next < uc->rp_count) {
+        struct uc_rr_event *ev = &uc->rp_events[uc->rp_next];
+
+        if (ev->site != address || ev->hit != hit) {
+            break;
+        }
+        uc->rp_next++;
+
+        switch (ev->kind) {
+        case UC_RR_REG: {
+            // values were captured zero-padded, see uc_reg_write()
+            uint8_t buf[UC_RR_REG_BUF];
+
+            memset(buf, 0, sizeof(buf));
+            memcpy(buf, ev->data, ev->len);
+            uc_reg_write(uc, ev->reg, buf);
+            break;
+        }
+        case UC_RR_MEM:
+            uc_mem_write(uc, ev->addr, ev->data, ev->len);
+            break;
+        case UC_RR_STOP:
+            uc_emu_stop(uc);
+            return;
+        }
+    }
+
+    // log exhausted: drop the instrumentation, the rest of the run needs
+    // no events and executes at plain JIT speed
+    if (uc->rp_next == uc->rp_count) {
+        uint32_t i;
+
+        for (i = 0; i < uc->rp_hook_count; i++) {
+            uc_hook_del(uc, uc->rp_hooks[i]);
+        }
+        uc->rp_hook_count = 0;
+    }
+}
+
+UNICORN_EXPORT
+uc_err uc_replay_load(uc_engine *uc, const char *path)
+{
+    FILE *f;
+    uint32_t header[5];
+    uint32_t i, nsites = 0;
+    uint64_t *sites = NULL;
+    uc_err err = UC_ERR_RESOURCE;
+
+    if (path == NULL || uc->current_cpu) {
+        return UC_ERR_ARG;
+    }
+    rr_replay_free(uc);
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        return UC_ERR_RESOURCE;
+    }
+    if (fread(header, sizeof(header), 1, f) != 1
+            || header[0] != UC_RR_MAGIC || header[1] != UC_RR_VERSION
+            || header[2] != (uint32_t)uc->arch
+            || header[3] != (uint32_t)uc->mode) {
+        goto fail;
+    }
+
+    uc->rp_count = header[4];
+    if (uc->rp_count == 0) {
+        fclose(f);
+        return UC_ERR_OK;
+    }
+    uc->rp_events = uzalloc(uc, uc->rp_count * sizeof(*uc->rp_events));
+    sites = ualloc(uc, uc->rp_count * sizeof(*sites));
+    if (uc->rp_events == NULL || sites == NULL) {
+        err = UC_ERR_NOMEM;
+        goto fail;
+    }
+
+    for (i = 0; i < uc->rp_count; i++) {
+        struct uc_rr_event *ev = &uc->rp_events[i];
+        uint32_t j;
+
+        if (fread(ev, offsetof(struct uc_rr_event, data), 1, f) != 1) {
+            goto fail;
+        }
+        ev->data = NULL;
+        if (ev->len != 0) {
+            if (ev->len > UC_RR_REG_BUF && ev->kind == UC_RR_REG) {
+                goto fail;
+            }
+            ev->data = ualloc(uc, ev->len);
+            if (ev->data == NULL) {
+                err = UC_ERR_NOMEM;
+                goto fail;
+            }
+            if (fread(ev->data, ev->len, 1, f) != 1) {
+                goto fail;
+            }
+        }
+
+        for (j = 0; j < nsites; j++) {
+            if (sites[j] == ev->site) {
+                break;
+            }
+        }
+        if (j == nsites) {
+            sites[nsites++] = ev->site;
+        }
+    }
+    fclose(f);
+    f = NULL;
+
+    // one bounded internal hook per distinct site: only the blocks
+    // containing event sites get instrumented, everything else runs at
+    // plain JIT speed (see HOOK_EXISTS_BOUNDED in the translators)
+    uc->rp_hooks = uzalloc(uc, nsites * sizeof(*uc->rp_hooks));
+    if (uc->rp_hooks == NULL) {
+        err = UC_ERR_NOMEM;
+        goto fail;
+    }
+    for (i = 0; i < nsites; i++) {
+        err = uc_hook_add(uc, &uc->rp_hooks[i], UC_HOOK_CODE,
+                rr_replay_hook, NULL, sites[i], sites[i]);
+        if (err != UC_ERR_OK) {
+            goto fail;
+        }
+        uc->rp_hook_count++;
+    }
+    ufree(uc, sites);
+
+    return UC_ERR_OK;
+
+fail:
+    if (f != NULL) {
+        fclose(f);
+    }
+    ufree(uc, sites);
+    rr_replay_free(uc);
+    return err;
+}
+
+UNICORN_EXPORT
+uc_err uc_replay_stop(uc_engine *uc)
+{
+    bool done = uc->rp_events == NULL || uc->rp_next == uc->rp_count;
+
+    rr_replay_free(uc);
+
+    // tell a caller when the log was not fully consumed: the replayed
+    // run diverged from the recorded one (or was cut short)
+    return done ? UC_ERR_OK : UC_ERR_ARG;
+}
+
+// TCG helper
+void helper_uc_tracecode(int32_t size, uc_hook_type type, void *handle, int64_t address);
+void helper_uc_tracecode(int32_t size, uc_hook_type type, void *handle, int64_t address)
+{
     struct uc_struct *uc = handle;
-    struct list_item *cur = uc->hook[type].head;
+    struct hook_list *l = &uc->hook[type];
     struct hook *hook;
+    uint32_t i;
+
+#ifdef __GNUC__
+    // where the generated code resumes when this helper returns; a nested
+    // uc_emu_start() from a callback below pins that code against eviction
+    uc->hook_ra = (uintptr_t)__builtin_return_address(0);
+#endif
+
+    // sync PC in CPUArchState with address
+    if (uc->set_pc) {
+        uc->set_pc(uc, address);
+    }
+
+    // recording, see uc_record_enable(): code-hook dispatches are the
+    // positions mutations get anchored to
+    if (uc->rr_recording && type == UC_HOOK_CODE_IDX) {
+        uc->rr_site = address;
+        uc->rr_site_hit = rr_hits_bump(uc, &uc->rr_hits, &uc->rr_hits_size,
+                &uc->rr_hits_used, address);
+        uc->rr_have_site = uc->rr_site_hit != 0;
+    }
+
+    UC_PROBE3(hook_dispatch, type, address, size);
+
+    // binary trace mode records the event instead of running callbacks
+    if (HOOK_TRACED(uc, 1u << type)) {
+        uc->hook_event_count++;
+        uc_trace_append(uc, 1u << type, address, size > 0 ? size : 0);
+        return;
+    }
+
+    // fast rejection: nothing in this table covers address
+    if (l->count == 0 || address < l->begin || address > l->end)
+        return;
+
+    for (i = 0; i < l->count && !uc->stop_request; i++) {
+        hook = l->items[i];
+        if (hook->deleted)
+            continue;
+        if (HOOK_BOUND_CHECK(hook, address) && HOOK_FILTER_SIZE(hook, size)) {
+            uc->hook_event_count++;
+            if (hook->async) {
+                uc_async_publish(uc, hook, 1u << type, address, size, 0);
+            } else {
+                ((uc_cb_hookcode_t)hook->callback)(uc, address, size, hook->user_data);
+            }
+        }
+    }
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_regions_fill(uc_engine *uc, uc_mem_region *regions,
+        uint32_t capacity, uint32_t *count)
+{
+    uint32_t i, n;
+
+    *count = uc->mapped_block_count;
+
+    // copy what fits; the caller can tell from *count whether the buffer
+    // was large enough and retry with a bigger one
+    n = MIN(*count, capacity);
+    for (i = 0; i < n; i++) {
+        regions[i].begin = uc->mapped_blocks[i]->addr;
+        regions[i].end = uc->mapped_blocks[i]->end - 1;
+        regions[i].perms = uc->mapped_blocks[i]->perms;
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uint32_t uc_mem_regions(uc_engine *uc, uc_mem_region **regions, uint32_t *count)
+{
+    uc_mem_region *r = NULL;
+
+    if (uc->mapped_block_count) {
+        r = malloc(uc->mapped_block_count * sizeof(uc_mem_region));
+        if (r == NULL) {
+            // out of memory
+            return UC_ERR_NOMEM;
+        }
+    }
+
+    *regions = r;
+
+    return uc_mem_regions_fill(uc, r, uc->mapped_block_count, count);
+}
+
+UNICORN_EXPORT
+uc_err uc_context_alloc(uc_engine *uc, uc_context **context)
+{
+    struct uc_context **_context = context;
+    size_t size = uc_context_size(uc);
+
+    *_context = malloc(size);
+    if (*_context) {
+        (*_context)->size = uc->cpu_context_size;
+        return UC_ERR_OK;
+    } else {
+        return UC_ERR_NOMEM;
+    }
+}
+
+UNICORN_EXPORT
+size_t uc_context_size(uc_engine *uc)
+{
+    // size needed to store the context + metadata
+    return sizeof(uc_context) + uc->cpu_context_size;
+}
+
+UNICORN_EXPORT
+uc_err uc_context_save(uc_engine *uc, uc_context *context)
+{
+    memcpy(context->data, first_cpu->env_ptr, context->size);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_context_restore(uc_engine *uc, uc_context *context)
+{
+    memcpy(first_cpu->env_ptr, context->data, context->size);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_context_free(uc_context *context)
+{
+    free(context);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_mem_share(uc_engine *uc, uc_engine *src, uint64_t address, uint32_t perms)
+{
+#ifdef _WIN32
+    // sharing relies on POSIX shared mappings
+    return UC_ERR_RESOURCE;
+#else
+    MemoryRegion *mr;
+    size_t size;
+    void *ptr;
+    uc_err err;
+    int fd;
+
+    // find the source region; its whole extent gets shared
+    mr = memory_mapping(src, address);
+    if (mr == NULL)
+        return UC_ERR_NOMEM;
+
+    size = (size_t)int128_get64(mr->size);
+
+    fd = src->ram_make_shareable(src, mr);
+    if (fd < 0)
+        return UC_ERR_NOMEM;
+
+    // a private mapping shares clean pages with the source through the page
+    // cache; pages only get copied if this instance writes to them, so a
+    // region mapped without UC_PROT_WRITE stays fully shared
+    ptr = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED)
+        return UC_ERR_NOMEM;
+
+    err = uc_mem_map_ptr(uc, mr->addr, size, perms, ptr);
+    if (err != UC_ERR_OK) {
+        munmap(ptr, size);
+        return err;
+    }
+
+    // let this instance munmap its private mapping when the region dies
+    uc->ram_set_owned(uc, memory_mapping(uc, mr->addr));
+
+    return UC_ERR_OK;
+#endif
+}
+
+UNICORN_EXPORT
+uc_err uc_clone(uc_engine *uc, uc_engine **result)
+{
+#ifdef _WIN32
+    // copy-on-write clones rely on POSIX shared mappings
+    return UC_ERR_RESOURCE;
+#else
+    uc_engine *child;
+    CPUState *parent_cpu, *child_cpu;
+    uc_err err;
+    uint32_t i;
+
+    err = uc_open(uc->arch, uc->mode, &child);
+    if (err != UC_ERR_OK) {
+        return err;
+    }
+
+    // copy CPU state, same boundary as uc_context_save()
+    parent_cpu = QTAILQ_FIRST(&uc->cpus);
+    child_cpu = QTAILQ_FIRST(&child->cpus);
+    memcpy(child_cpu->env_ptr, parent_cpu->env_ptr, uc->cpu_context_size);
+
+    // map every parent region into the child copy-on-write
+    for (i = 0; i < uc->mapped_block_count; i++) {
+        MemoryRegion *mr = uc->mapped_blocks[i];
+
+        err = uc_mem_share(child, uc, mr->addr, mr->perms);
+        if (err != UC_ERR_OK) {
+            goto error;
+        }
+    }
+
+    *result = child;
+
+    return UC_ERR_OK;
+
+error:
+    uc_close(child);
+    return UC_ERR_NOMEM;
+#endif
+}
+
+UNICORN_EXPORT
+uc_err uc_snapshot(uc_engine *uc, struct uc_snapshot **snapshot)
+{
+    struct uc_snapshot *s;
+    uc_err err;
+
+    s = uzalloc(uc, sizeof(*s));
+    if (s == NULL) {
+        return UC_ERR_NOMEM;
+    }
+
+    err = uc_context_alloc(uc, &s->context);
+    if (err != UC_ERR_OK) {
+        ufree(uc, s);
+        return err;
+    }
+
+    uc_context_save(uc, s->context);
+
+    if (uc->memory_snapshot(uc, s)) {
+        uc_context_free(s->context);
+        ufree(uc, s);
+        return UC_ERR_NOMEM;
+    }
+
+    *snapshot = s;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_restore(uc_engine *uc, struct uc_snapshot *snapshot)
+{
+    uc_context_restore(uc, snapshot->context);
+
+    if (uc->memory_restore(uc, snapshot)) {
+        // the mapping layout changed since the snapshot was taken
+        return UC_ERR_MAP;
+    }
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_snapshot_free(uc_engine *uc, struct uc_snapshot *snapshot)
+{
+    uc->memory_snapshot_free(uc, snapshot);
+    uc_context_free(snapshot->context);
+    ufree(uc, snapshot);
+
+    return UC_ERR_OK;
+}
+
+// bounded checkpoint ring for uc_checkpoint_enable()/uc_rewind(): an
+// internal block hook snapshots the engine every ckpt_interval executed
+// blocks, and each slot also records which pages were dirtied since the
+// previous slot so that rewinding several checkpoints stays O(delta)
+
+static void ckpt_slot_free(uc_engine *uc, struct uc_checkpoint *c)
+{
+    if (c->snap != NULL) {
+        uc_snapshot_free(uc, c->snap);
+        c->snap = NULL;
+    }
+    if (c->delta != NULL) {
+        uc->memory_ckpt_delta_free(uc, c->delta);
+        ufree(uc, c->delta);
+        c->delta = NULL;
+    }
+}
+
+// take one checkpoint: capture the dirty delta since the previous one
+// (before uc_snapshot() resets the migration bitmap), then snapshot.
+// On failure the ring and the dirty bitmap are left untouched, so the
+// older checkpoints stay valid and the next interval retries.
+static uc_err ckpt_take(uc_engine *uc)
+{
+    struct uc_checkpoint c = { 0 };
+    struct uc_checkpoint *slot;
+    uc_err err;
+
+    c.delta = uzalloc(uc, sizeof(*c.delta));
+    if (c.delta == NULL) {
+        return UC_ERR_NOMEM;
+    }
+
+    if (uc->memory_ckpt_delta(uc, c.delta)) {
+        ufree(uc, c.delta);
+        return UC_ERR_NOMEM;
+    }
+
+    err = uc_snapshot(uc, &c.snap);
+    if (err != UC_ERR_OK) {
+        uc->memory_ckpt_delta_free(uc, c.delta);
+        ufree(uc, c.delta);
+        return err;
+    }
+
+    slot = &uc->ckpt_ring[uc->ckpt_head];
+    if (uc->ckpt_count == uc->ckpt_depth) {
+        // evict the oldest checkpoint; rewinding past the ring is not
+        // possible, so its delta is no longer needed either
+        ckpt_slot_free(uc, slot);
+    } else {
+        uc->ckpt_count++;
+    }
+    *slot = c;
+    uc->ckpt_head = (uc->ckpt_head + 1) % uc->ckpt_depth;
+
+    return UC_ERR_OK;
+}
+
+// internal UC_HOOK_BLOCK callback counting down to the next checkpoint
+static void ckpt_block_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    if (++uc->ckpt_blocks < uc->ckpt_interval) {
+        return;
+    }
+
+    uc->ckpt_blocks = 0;
+    ckpt_take(uc);
+}
+
+static void ckpt_ring_free(uc_engine *uc)
+{
+    uint32_t i;
+
+    if (uc->ckpt_ring == NULL) {
+        return;
+    }
+
+    for (i = 0; i < uc->ckpt_count; i++) {
+        ckpt_slot_free(uc, &uc->ckpt_ring[
+                (uc->ckpt_head + uc->ckpt_depth - 1 - i) % uc->ckpt_depth]);
+    }
+    ufree(uc, uc->ckpt_ring);
+    uc->ckpt_ring = NULL;
+    uc->ckpt_depth = 0;
+    uc->ckpt_head = 0;
+    uc->ckpt_count = 0;
+    uc->ckpt_interval = 0;
+    uc->ckpt_blocks = 0;
+}
+
+UNICORN_EXPORT
+uc_err uc_checkpoint_enable(uc_engine *uc, uint64_t interval, uint32_t depth)
+{
+    uc_err err;
+
+    if (interval == 0 || depth == 0 || uc->ckpt_ring != NULL
+            || uc->current_cpu) {
+        return UC_ERR_ARG;
+    }
+
+    uc->ckpt_ring = uzalloc(uc, depth * sizeof(*uc->ckpt_ring));
+    if (uc->ckpt_ring == NULL) {
+        return UC_ERR_NOMEM;
+    }
+    uc->ckpt_depth = depth;
+    uc->ckpt_interval = interval;
+
+    err = uc_hook_add(uc, &uc->ckpt_hook, UC_HOOK_BLOCK,
+            ckpt_block_hook, NULL, 1, 0);
+    if (err != UC_ERR_OK) {
+        goto error;
+    }
+
+    // anchor checkpoint: the state at enable time is the farthest point
+    // uc_rewind() can reach
+    err = ckpt_take(uc);
+    if (err != UC_ERR_OK) {
+        uc_hook_del(uc, uc->ckpt_hook);
+        goto error;
+    }
+
+    return UC_ERR_OK;
+
+error:
+    ufree(uc, uc->ckpt_ring);
+    uc->ckpt_ring = NULL;
+    uc->ckpt_depth = 0;
+    uc->ckpt_interval = 0;
+    return err;
+}
+
+UNICORN_EXPORT
+uc_err uc_rewind(uc_engine *uc, uint32_t steps)
+{
+    struct uc_checkpoint *c, *prev;
+    uint32_t k;
+    uc_err err;
+
+    if (uc->ckpt_ring == NULL || steps == 0 || steps > uc->ckpt_count
+            || uc->current_cpu) {
+        return UC_ERR_ARG;
+    }
+
+    // roll back to the newest checkpoint first: this copies only the
+    // pages dirtied since it was taken
+    c = &uc->ckpt_ring[(uc->ckpt_head + uc->ckpt_depth - 1) % uc->ckpt_depth];
+    err = uc_restore(uc, c->snap);
+    if (err != UC_ERR_OK) {
+        return err;
+    }
+
+    // step further back one checkpoint at a time: each slot's delta
+    // names the pages dirtied since its predecessor, and the
+    // predecessor's snapshot holds their older contents
+    for (k = 1; k < steps; k++) {
+        prev = &uc->ckpt_ring[
+                (uc->ckpt_head + uc->ckpt_depth - 1 - k) % uc->ckpt_depth];
+        if (uc->memory_ckpt_apply(uc, prev->snap, c->delta)) {
+            // the mapping layout changed since the checkpoint was taken
+            return UC_ERR_MAP;
+        }
+        c = prev;
+    }
+    uc_context_restore(uc, c->snap->context);
+
+    // the undone checkpoints are now in the future - drop them; the
+    // target becomes the newest slot, so rewinding further (or running
+    // forward again, which resumes taking checkpoints) works from there
+    while (steps-- > 1) {
+        uc->ckpt_head = (uc->ckpt_head + uc->ckpt_depth - 1) % uc->ckpt_depth;
+        ckpt_slot_free(uc, &uc->ckpt_ring[uc->ckpt_head]);
+        uc->ckpt_count--;
+    }
+    uc->ckpt_blocks = 0;
 
-    // sync PC in CPUArchState with address
-    if (uc->set_pc) {
-        uc->set_pc(uc, address);
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_checkpoint_disable(uc_engine *uc)
+{
+    if (uc->ckpt_ring == NULL) {
+        return UC_ERR_ARG;
+    }
+
+    uc_hook_del(uc, uc->ckpt_hook);
+    ckpt_ring_free(uc);
+
+    return UC_ERR_OK;
+}
+
+// internal UC_HOOK_CODE callback placed on every exit address given to
+// uc_fuzz_loop(): reaching one ends the iteration
+static void fuzz_exit_hook(uc_engine *uc, uint64_t address, uint32_t size,
+        void *user_data)
+{
+    uc_emu_stop(uc);
+}
+
+UNICORN_EXPORT
+uc_err uc_fuzz_loop(uc_engine *uc, uint64_t entry, const uint64_t *exits,
+        size_t exit_count, uint64_t iterations,
+        uc_cb_place_input_t place_input, void *user_data)
+{
+    struct uc_snapshot *snapshot;
+    uc_hook *hooks;
+    uint64_t iter;
+    size_t i, registered = 0;
+    uc_err err = UC_ERR_OK;
+
+    if (place_input == NULL || exits == NULL || exit_count == 0) {
+        return UC_ERR_ARG;
+    }
+    // never from a hook callback: iterations roll guest memory back under
+    // the suspended run
+    if (uc->current_cpu) {
+        return UC_ERR_ARG;
+    }
+
+    hooks = ualloc(uc, exit_count * sizeof(*hooks));
+    if (hooks == NULL) {
+        return UC_ERR_NOMEM;
+    }
+    for (i = 0; i < exit_count; i++) {
+        err = uc_hook_add(uc, &hooks[i], UC_HOOK_CODE, fuzz_exit_hook,
+                NULL, exits[i], exits[i]);
+        if (err != UC_ERR_OK) {
+            goto out_hooks;
+        }
+        registered++;
+    }
+
+    // the baseline every iteration rolls back to; rolling back is
+    // incremental (dirtied pages only), which is what keeps the loop cheap
+    err = uc_snapshot(uc, &snapshot);
+    if (err != UC_ERR_OK) {
+        goto out_hooks;
+    }
+
+    for (iter = 0; iterations == 0 || iter < iterations; iter++) {
+        if (!place_input(uc, iter, user_data)) {
+            // input source exhausted
+            break;
+        }
+
+        err = uc_emu_start(uc, entry, 0, 0, 0);
+        if (err != UC_ERR_OK) {
+            // leave the faulting CPU and memory state in place for triage
+            break;
+        }
+
+        err = uc_restore(uc, snapshot);
+        if (err != UC_ERR_OK) {
+            // the iteration changed the memory mapping layout
+            break;
+        }
+    }
+
+    uc_snapshot_free(uc, snapshot);
+
+out_hooks:
+    for (i = 0; i < registered; i++) {
+        uc_hook_del(uc, hooks[i]);
     }
+    ufree(uc, hooks);
+
+    return err;
+}
+
+// number of entries of the shared job queue; uc_pool_submit() blocks when
+// it is full, which also bounds the completion ring (see pool_worker())
+#define UC_POOL_QUEUE_SIZE 256
+
+struct uc_pool_worker {
+    struct uc_pool *pool;
+    uc_engine *uc;                  // uc_clone() of the model
+    struct uc_snapshot *snapshot;   // baseline every job rolls back to
+    QemuThread thread;
+};
+
+struct uc_pool {
+    uc_engine *model;               // allocations go through its allocator
+    struct uc_pool_worker *workers;
+    uint32_t nworkers;
+
+    // one shared bounded job queue feeding all workers, plus the ring of
+    // completed jobs drained by uc_pool_collect(); head/tail free-run and
+    // are reduced modulo the capacity, like the async hook event queue
+    uc_pool_job *pending;
+    uint32_t pending_capacity;
+    uint32_t pending_head, pending_tail;
+    uc_pool_result *done;
+    uint32_t done_capacity;
+    uint32_t done_head, done_tail;
+    uint64_t submitted, collected;  // lets uc_pool_collect() detect "drained"
+
+    bool exiting;
+    QemuMutex mutex;
+    QemuCond job_avail;             // signaled per queued job
+    QemuCond job_space;             // signaled per dequeued job
+    QemuCond done_avail;            // signaled per completed job
+    QemuCond done_space;            // signaled per collected result
+};
+
+static void *pool_worker(void *opaque)
+{
+    struct uc_pool_worker *w = opaque;
+    struct uc_pool *pool = w->pool;
+    uc_pool_job job;
+    uc_err err, rerr;
+
+    qemu_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->exiting
+                && pool->pending_head == pool->pending_tail) {
+            qemu_cond_wait(&pool->job_avail, &pool->mutex);
+        }
+        if (pool->exiting) {
+            // jobs still queued are discarded, see uc_pool_free()
+            break;
+        }
+
+        job = pool->pending[pool->pending_tail % pool->pending_capacity];
+        pool->pending_tail++;
+        qemu_cond_signal(&pool->job_space);
+        qemu_mutex_unlock(&pool->mutex);
+
+        if (job.setup != NULL && !job.setup(w->uc, job.job_data)) {
+            err = UC_ERR_ARG;
+        } else {
+            err = uc_emu_start(w->uc, job.entry, job.until, job.timeout,
+                    job.count);
+        }
+
+        // deliver outputs before the rollback wipes them
+        if (job.done != NULL) {
+            job.done(w->uc, err, job.job_data);
+        }
+
+        // back to the baseline for the next job; a failed rollback means
+        // the job changed the mapping layout, which poisons this worker
+        // for good, so it beats any error of the run itself
+        rerr = uc_restore(w->uc, w->snapshot);
+        if (rerr != UC_ERR_OK) {
+            err = rerr;
+        }
 
-    while (cur != NULL && !uc->stop_request) {
-        hook = (struct hook *)cur->data;
-        if (HOOK_BOUND_CHECK(hook, address)) {
-            ((uc_cb_hookcode_t)hook->callback)(uc, address, size, hook->user_data);
+        qemu_mutex_lock(&pool->mutex);
+        while (!pool->exiting
+                && pool->done_head - pool->done_tail == pool->done_capacity) {
+            qemu_cond_wait(&pool->done_space, &pool->mutex);
+        }
+        if (!pool->exiting) {
+            uc_pool_result *res =
+                &pool->done[pool->done_head % pool->done_capacity];
+            res->job_data = job.job_data;
+            res->err = err;
+            pool->done_head++;
+            qemu_cond_signal(&pool->done_avail);
         }
-        cur = cur->next;
     }
+    qemu_mutex_unlock(&pool->mutex);
+
+    return NULL;
 }
 
 UNICORN_EXPORT
-uint32_t uc_mem_regions(uc_engine *uc, uc_mem_region **regions, uint32_t *count)
+uc_err uc_pool_create(uc_engine *model, uint32_t nworkers, uc_pool **result)
 {
-    uint32_t i;
-    uc_mem_region *r = NULL;
+    struct uc_pool *pool;
+    uint32_t i, threads = 0, engines = 0;
+    uc_err err = UC_ERR_OK;
 
-    *count = uc->mapped_block_count;
+    if (model == NULL || nworkers == 0 || result == NULL) {
+        return UC_ERR_ARG;
+    }
+    if (model->current_cpu) {
+        return UC_ERR_ARG;
+    }
 
-    if (*count) {
-        r = malloc(*count * sizeof(uc_mem_region));
-        if (r == NULL) {
-            // out of memory
-            return UC_ERR_NOMEM;
+    pool = uzalloc(model, sizeof(*pool));
+    if (pool == NULL) {
+        return UC_ERR_NOMEM;
+    }
+    pool->model = model;
+    pool->nworkers = nworkers;
+    pool->pending_capacity = UC_POOL_QUEUE_SIZE;
+    // submit blocks on a full job queue and a worker holds at most one
+    // job, so this ring can never fill up past queue + workers
+    pool->done_capacity = UC_POOL_QUEUE_SIZE + nworkers;
+
+    pool->workers = uzalloc(model, nworkers * sizeof(*pool->workers));
+    pool->pending = uzalloc(model,
+            pool->pending_capacity * sizeof(*pool->pending));
+    pool->done = uzalloc(model, pool->done_capacity * sizeof(*pool->done));
+    if (pool->workers == NULL || pool->pending == NULL
+            || pool->done == NULL) {
+        err = UC_ERR_NOMEM;
+        goto fail_alloc;
+    }
+
+    qemu_mutex_init(&pool->mutex);
+    qemu_cond_init(&pool->job_avail);
+    qemu_cond_init(&pool->job_space);
+    qemu_cond_init(&pool->done_avail);
+    qemu_cond_init(&pool->done_space);
+
+    for (i = 0; i < nworkers; i++) {
+        struct uc_pool_worker *w = &pool->workers[i];
+
+        w->pool = pool;
+        err = uc_clone(model, &w->uc);
+        if (err != UC_ERR_OK) {
+            goto fail_workers;
+        }
+        engines++;
+        err = uc_snapshot(w->uc, &w->snapshot);
+        if (err != UC_ERR_OK) {
+            goto fail_workers;
+        }
+        if (qemu_thread_create(&w->thread, "pool-worker", pool_worker, w,
+                    QEMU_THREAD_JOINABLE)) {
+            err = UC_ERR_RESOURCE;
+            goto fail_workers;
         }
+        threads++;
     }
 
-    for (i = 0; i < *count; i++) {
-        r[i].begin = uc->mapped_blocks[i]->addr;
-        r[i].end = uc->mapped_blocks[i]->end - 1;
-        r[i].perms = uc->mapped_blocks[i]->perms;
+    *result = pool;
+
+    return UC_ERR_OK;
+
+fail_workers:
+    qemu_mutex_lock(&pool->mutex);
+    pool->exiting = true;
+    qemu_cond_broadcast(&pool->job_avail);
+    qemu_mutex_unlock(&pool->mutex);
+    for (i = 0; i < threads; i++) {
+        qemu_thread_join(&pool->workers[i].thread);
     }
+    for (i = 0; i < engines; i++) {
+        if (pool->workers[i].snapshot) {
+            uc_snapshot_free(pool->workers[i].uc, pool->workers[i].snapshot);
+        }
+        uc_close(pool->workers[i].uc);
+    }
+    qemu_mutex_destroy(&pool->mutex);
+    qemu_cond_destroy(&pool->job_avail);
+    qemu_cond_destroy(&pool->job_space);
+    qemu_cond_destroy(&pool->done_avail);
+    qemu_cond_destroy(&pool->done_space);
+fail_alloc:
+    ufree(model, pool->done);
+    ufree(model, pool->pending);
+    ufree(model, pool->workers);
+    ufree(model, pool);
+
+    return err;
+}
 
-    *regions = r;
+UNICORN_EXPORT
+uc_err uc_pool_submit(uc_pool *pool, const uc_pool_job *job)
+{
+    if (pool == NULL || job == NULL) {
+        return UC_ERR_ARG;
+    }
+
+    qemu_mutex_lock(&pool->mutex);
+    while (!pool->exiting
+            && pool->pending_head - pool->pending_tail
+                == pool->pending_capacity) {
+        qemu_cond_wait(&pool->job_space, &pool->mutex);
+    }
+    if (pool->exiting) {
+        qemu_mutex_unlock(&pool->mutex);
+        return UC_ERR_ARG;
+    }
+
+    pool->pending[pool->pending_head % pool->pending_capacity] = *job;
+    pool->pending_head++;
+    pool->submitted++;
+
+    qemu_cond_signal(&pool->job_avail);
+    qemu_mutex_unlock(&pool->mutex);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_pool_collect(uc_pool *pool, uc_pool_result *result)
+{
+    if (pool == NULL || result == NULL) {
+        return UC_ERR_ARG;
+    }
+
+    qemu_mutex_lock(&pool->mutex);
+    if (pool->collected == pool->submitted) {
+        // every submitted job was already collected; let drain loops end
+        qemu_mutex_unlock(&pool->mutex);
+        return UC_ERR_ARG;
+    }
+    while (pool->done_head == pool->done_tail) {
+        qemu_cond_wait(&pool->done_avail, &pool->mutex);
+    }
+
+    *result = pool->done[pool->done_tail % pool->done_capacity];
+    pool->done_tail++;
+    pool->collected++;
+
+    qemu_cond_signal(&pool->done_space);
+    qemu_mutex_unlock(&pool->mutex);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_pool_free(uc_pool *pool)
+{
+    uc_engine *model;
+    uint32_t i;
+
+    if (pool == NULL) {
+        return UC_ERR_ARG;
+    }
+    model = pool->model;
+
+    qemu_mutex_lock(&pool->mutex);
+    pool->exiting = true;
+    qemu_cond_broadcast(&pool->job_avail);
+    qemu_cond_broadcast(&pool->job_space);
+    qemu_cond_broadcast(&pool->done_space);
+    qemu_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->nworkers; i++) {
+        qemu_thread_join(&pool->workers[i].thread);
+    }
+    for (i = 0; i < pool->nworkers; i++) {
+        uc_snapshot_free(pool->workers[i].uc, pool->workers[i].snapshot);
+        uc_close(pool->workers[i].uc);
+    }
+
+    qemu_mutex_destroy(&pool->mutex);
+    qemu_cond_destroy(&pool->job_avail);
+    qemu_cond_destroy(&pool->job_space);
+    qemu_cond_destroy(&pool->done_avail);
+    qemu_cond_destroy(&pool->done_space);
+
+    ufree(model, pool->done);
+    ufree(model, pool->pending);
+    ufree(model, pool->workers);
+    ufree(model, pool);
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_arch_state_ptr(uc_engine *uc, uc_arch_state *state)
+{
+    if (uc->arch_state == NULL)
+        return UC_ERR_ARCH;
+
+    memset(state, 0, sizeof(*state));
+    state->version = UC_ARCH_STATE_VERSION;
+    uc->arch_state(uc, state);
 
     return UC_ERR_OK;
 }
@@ -1098,7 +4900,127 @@ uc_err uc_query(uc_engine *uc, uc_query_type type, size_t *result)
         *result = uc->target_page_size;
         return UC_ERR_OK;
     }
-    
+
+    if (type == UC_QUERY_TLB_SIZE) {
+        *result = uc->tlb_entries;
+        return UC_ERR_OK;
+    }
+
+    if (type == UC_QUERY_TCG_BUFFER_SIZE) {
+        *result = uc->tcg_buffer_size;
+        return UC_ERR_OK;
+    }
+
+    if (type == UC_QUERY_JMP_CACHE_SIZE) {
+        *result = (size_t)1 << uc->jmp_cache_bits;
+        return UC_ERR_OK;
+    }
+
+    if (type >= UC_QUERY_TB_COUNT && type <= UC_QUERY_TB_EVICT_COUNT) {
+        struct uc_tb_stats stats;
+
+        if (uc->tb_stats == NULL)
+            return UC_ERR_ARG;
+        uc->tb_stats(uc, &stats);
+        switch(type) {
+            default: break;
+            case UC_QUERY_TB_COUNT: *result = stats.nb_tbs; break;
+            case UC_QUERY_TB_BUFFER_USED: *result = stats.buffer_used; break;
+            case UC_QUERY_TB_FLUSH_COUNT: *result = stats.flush_count; break;
+            case UC_QUERY_TB_INVALIDATE_COUNT:
+                *result = stats.invalidate_count;
+                break;
+            case UC_QUERY_TB_EVICT_COUNT: *result = stats.evict_count; break;
+        }
+        return UC_ERR_OK;
+    }
+
+    if (type == UC_QUERY_TB_LOOKUP_COUNT) {
+        *result = uc->tb_lookup_count;
+        return UC_ERR_OK;
+    }
+
+    if (type == UC_QUERY_TB_SLOW_LOOKUP_COUNT) {
+        *result = uc->tb_slow_lookup_count;
+        return UC_ERR_OK;
+    }
+
+    if (type >= UC_QUERY_EXEC_BLOCK_COUNT && type <= UC_QUERY_JIT_TIME_NS) {
+        switch(type) {
+            default: break;
+            case UC_QUERY_EXEC_BLOCK_COUNT:
+                *result = uc->exec_block_count;
+                break;
+            case UC_QUERY_EXEC_INSN_COUNT:
+                *result = uc->exec_insn_count;
+                break;
+            case UC_QUERY_TLB_FILL_COUNT:
+                *result = uc->tlb_fill_count;
+                break;
+            case UC_QUERY_HOOK_EVENT_COUNT:
+                *result = uc->hook_event_count;
+                break;
+            case UC_QUERY_MEM_API_BYTES:
+                *result = uc->mem_api_bytes;
+                break;
+            case UC_QUERY_EMU_START_COUNT:
+                *result = uc->emu_start_count;
+                break;
+            case UC_QUERY_JIT_TIME_NS:
+                *result = uc->jit_time_ns;
+                break;
+        }
+        return UC_ERR_OK;
+    }
+
+    if (type >= UC_QUERY_MEM_CODE_BUFFER && type <= UC_QUERY_MEM_DIRTY_BITMAPS) {
+        struct uc_mem_stats mstats;
+
+        if (uc->mem_stats == NULL)
+            return UC_ERR_ARG;
+        uc->mem_stats(uc, &mstats);
+        switch(type) {
+            default: break;
+            case UC_QUERY_MEM_CODE_BUFFER: *result = mstats.code_buffer; break;
+            case UC_QUERY_MEM_TB_METADATA: *result = mstats.tb_metadata; break;
+            case UC_QUERY_MEM_PAGE_TABLES: *result = mstats.page_tables; break;
+            case UC_QUERY_MEM_TLB: *result = mstats.tlb; break;
+            case UC_QUERY_MEM_GUEST_RAM: *result = mstats.guest_ram; break;
+            case UC_QUERY_MEM_DIRTY_BITMAPS:
+                *result = mstats.dirty_bitmaps;
+                break;
+        }
+        return UC_ERR_OK;
+    }
+
+    if (type == UC_QUERY_MEM_HOOKS) {
+        size_t bytes = 0;
+        uint32_t i, n;
+
+        for (i = 0; i < UC_HOOK_MAX; i++) {
+            bytes += uc->hook[i].capacity * sizeof(struct hook *);
+            for (n = 0; n < uc->hook[i].count; n++) {
+                // a registration covering several hook types sits in each
+                // of those lists with refs counting them: charge an equal
+                // share per list so the struct is counted once overall
+                bytes += sizeof(struct hook) / uc->hook[i].items[n]->refs;
+            }
+        }
+        for (i = 0; i < uc->insn_hooks_size; i++) {
+            bytes += uc->insn_hooks[i].capacity * sizeof(struct hook *);
+            for (n = 0; n < uc->insn_hooks[i].count; n++) {
+                bytes += sizeof(struct hook) /
+                        uc->insn_hooks[i].items[n]->refs;
+            }
+        }
+        bytes += sizeof(struct hook_list) * uc->insn_hooks_size;
+        bytes += uc->watch_count * sizeof(struct uc_watch);
+        if (uc->async_queue)
+            bytes += uc->async_capacity * sizeof(struct uc_async_event);
+        *result = bytes;
+        return UC_ERR_OK;
+    }
+
     switch(uc->arch) {
         case UC_ARCH_ARM:
             return uc->query(uc, type, result);
@@ -1108,3 +5030,97 @@ uc_err uc_query(uc_engine *uc, uc_query_type type, size_t *result)
 
     return UC_ERR_OK;
 }
+
+UNICORN_EXPORT
+uc_err uc_tlb_resize(uc_engine *uc, uint32_t entries)
+{
+    // resizing drops all cached translations; refuse mid-emulation
+    if (uc->current_cpu)
+        return UC_ERR_ARG;
+
+    if (uc->tlb_resize == NULL || !uc->tlb_resize(uc, entries))
+        return UC_ERR_ARG;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_jmp_cache_resize(uc_engine *uc, uint32_t entries)
+{
+    // no translations are dropped, only cached lookups: safe at any time
+    if (uc->jmp_cache_resize == NULL || !uc->jmp_cache_resize(uc, entries))
+        return UC_ERR_ARG;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_tcg_buffer_resize(uc_engine *uc, size_t size)
+{
+    // replacing the cache drops all translations; refuse mid-emulation
+    if (uc->current_cpu)
+        return UC_ERR_ARG;
+
+    if (uc->tcg_buffer_resize == NULL || !uc->tcg_buffer_resize(uc, size))
+        return UC_ERR_ARG;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_tb_cache_save(uc_engine *uc, const char *path)
+{
+    if (path == NULL)
+        return UC_ERR_ARG;
+
+    if (uc->tb_cache_save == NULL || !uc->tb_cache_save(uc, path))
+        return UC_ERR_RESOURCE;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_tb_cache_load(uc_engine *uc, const char *path)
+{
+    if (path == NULL)
+        return UC_ERR_ARG;
+
+    // restoring rewrites the code buffer; refuse mid-emulation
+    if (uc->current_cpu)
+        return UC_ERR_ARG;
+
+    if (uc->tb_cache_load == NULL || !uc->tb_cache_load(uc, path))
+        return UC_ERR_RESOURCE;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_translate(uc_engine *uc, uint64_t address, size_t size)
+{
+    if (size == 0)
+        return UC_ERR_OK;
+
+    // translation shares the cpu state; refuse mid-emulation
+    if (uc->current_cpu)
+        return UC_ERR_ARG;
+
+    address = uc_mem_redirect(uc, address);
+
+    if (uc->tb_prewarm == NULL || uc->tb_prewarm(uc, address, size) == 0)
+        return UC_ERR_FETCH_UNMAPPED;
+
+    return UC_ERR_OK;
+}
+
+UNICORN_EXPORT
+uc_err uc_translate_readahead(uc_engine *uc, uint32_t blocks)
+{
+    // translation read-ahead runs on the miss path inside the emulation
+    // loop; keep it short enough that the timeout check cannot starve
+    if (blocks > UC_TRANSLATE_READAHEAD_MAX)
+        return UC_ERR_ARG;
+
+    uc->tb_readahead = blocks;
+    return UC_ERR_OK;
+}